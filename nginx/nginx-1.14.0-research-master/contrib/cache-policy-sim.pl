@@ -0,0 +1,280 @@
+#!/usr/bin/perl -w
+
+# Replays an access log against the proxy_cache_path eviction policies
+# ("lru", "slru", "tinylfu") and prints the hit ratios of each one.
+#
+# usage: cache-policy-sim.pl [--max-size=1g] [--max-keys=N] [--bsize=4096]
+#                            [--policy=lru,slru,tinylfu] [access.log ...]
+#
+# The input is an access log in the "combined" or "main" format: the key
+# is the request URI of "GET" requests answered with 200, and the size is
+# $body_bytes_sent.  Lines of the form "key size" are accepted as well.
+#
+# The simulation follows src/http/ngx_http_file_cache.c: sizes are rounded
+# up to bsize, a node hit on the probation queue is promoted to the
+# protected queue holding at most 80% of nodes, and with "tinylfu" a new
+# key is stored only if its count-min sketch estimate exceeds the one of
+# the eviction victim once the cache is above 15/16 of its limits.  Unlike
+# the cache manager, eviction runs right after each insertion.
+
+
+use warnings;
+use strict;
+
+use Digest::MD5 qw(md5);
+use Getopt::Long;
+
+
+my $max_size = '1g';
+my $max_keys = 0;
+my $bsize = 4096;
+my $policies = 'lru,slru,tinylfu';
+
+GetOptions(
+	'max-size=s' => \$max_size,
+	'max-keys=i' => \$max_keys,
+	'bsize=i' => \$bsize,
+	'policy=s' => \$policies,
+) or die "usage: $0 [--max-size=1g] [--max-keys=N] [--bsize=4096] "
+	. "[--policy=lru,slru,tinylfu] [access.log ...]\n";
+
+my %units = (k => 1024, m => 1024 ** 2, g => 1024 ** 3);
+
+$max_size =~ /^(\d+)([kmg]?)$/i or die "invalid --max-size \"$max_size\"\n";
+my $max_blocks = int($1 * ($2 ? $units{lc $2} : 1) / $bsize);
+
+my @caches;
+
+for my $policy (split /,/, $policies) {
+	die "unknown policy \"$policy\"\n" if $policy !~ /^(lru|slru|tinylfu)$/;
+	push @caches, cache_new($policy);
+}
+
+while (<>) {
+	my ($key, $size);
+
+	if (/"GET (\S+)[^"]*" 200 (\d+)/) {
+		($key, $size) = ($1, $2);
+
+	} elsif (/^(\S+)\s+(\d+)\s*$/) {
+		($key, $size) = ($1, $2);
+
+	} else {
+		next;
+	}
+
+	my $md5 = md5($key);
+	my $blocks = int(($size + $bsize - 1) / $bsize) || 1;
+
+	cache_request($_, $md5, $size, $blocks) for @caches;
+}
+
+printf "%-8s %10s %10s %7s %7s %10s %10s\n",
+	'policy', 'requests', 'hits', 'ratio', 'bytes', 'rejected', 'evicted';
+
+for my $c (@caches) {
+	printf "%-8s %10d %10d %7.4f %7.4f %10d %10d\n",
+		$c->{policy}, $c->{requests}, $c->{hits},
+		$c->{requests} ? $c->{hits} / $c->{requests} : 0,
+		$c->{bytes} ? $c->{hit_bytes} / $c->{bytes} : 0,
+		$c->{rejected}, $c->{evicted};
+}
+
+
+sub cache_new {
+	my ($policy) = @_;
+
+	my $c = {
+		policy => $policy,
+		nodes => {},
+		queue => queue_new(),
+		promoted => queue_new(),
+		promoted_count => 0,
+		count => 0,
+		size => 0,
+		requests => 0, hits => 0, bytes => 0, hit_bytes => 0,
+		rejected => 0, evicted => 0,
+	};
+
+	if ($policy eq 'tinylfu') {
+		my $n = $max_keys || $max_blocks;
+		my $width = 16;
+		$width <<= 1 while $width < $n;
+
+		$c->{mask} = $width - 1;
+		$c->{period} = 10 * $width;
+		$c->{additions} = 0;
+		$c->{aging} = 0;
+		$c->{sketch} = [ (0) x (4 * $width) ];
+	}
+
+	return $c;
+}
+
+sub cache_request {
+	my ($c, $key, $size, $blocks) = @_;
+
+	my $frequency = 0;
+
+	$frequency = frequency($c, $key, 1) if $c->{sketch};
+
+	$c->{requests}++;
+	$c->{bytes} += $size;
+
+	my $node = $c->{nodes}{$key};
+
+	if ($node) {
+		$c->{hits}++;
+		$c->{hit_bytes} += $size;
+
+		queue_remove($node);
+		enqueue($c, $node, 1);
+		return;
+	}
+
+	if ($c->{sketch} && !admit($c, $frequency)) {
+		$c->{rejected}++;
+		return;
+	}
+
+	$node = { key => $key, blocks => $blocks, promoted => 0 };
+
+	$c->{nodes}{$key} = $node;
+	$c->{count}++;
+	$c->{size} += $blocks;
+
+	enqueue($c, $node, 0);
+
+	while ($c->{size} >= $max_blocks
+	       || ($max_keys && $c->{count} > $max_keys))
+	{
+		my $victim = victim($c) or last;
+		delete_node($c, $victim);
+		$c->{evicted}++;
+	}
+}
+
+sub enqueue {
+	my ($c, $node, $hit) = @_;
+
+	if (!$node->{promoted}) {
+		if (!$hit || $c->{policy} eq 'lru') {
+			queue_insert_head($c->{queue}, $node);
+			return;
+		}
+
+		$node->{promoted} = 1;
+		$c->{promoted_count}++;
+	}
+
+	queue_insert_head($c->{promoted}, $node);
+
+	demote($c);
+}
+
+sub demote {
+	my ($c) = @_;
+
+	while ($c->{promoted_count} > $c->{count} - int($c->{count} / 5)) {
+		my $last = queue_last($c->{promoted});
+		queue_remove($last);
+
+		$last->{promoted} = 0;
+		$c->{promoted_count}--;
+
+		queue_insert_head($c->{queue}, $last);
+	}
+}
+
+sub victim {
+	my ($c) = @_;
+
+	return queue_last($c->{queue}) || queue_last($c->{promoted});
+}
+
+sub delete_node {
+	my ($c, $node) = @_;
+
+	queue_remove($node);
+	$c->{promoted_count}-- if $node->{promoted};
+
+	delete $c->{nodes}{$node->{key}};
+	$c->{count}--;
+	$c->{size} -= $node->{blocks};
+
+	demote($c);
+}
+
+sub admit {
+	my ($c, $frequency) = @_;
+
+	return 1 if $c->{size} < $max_blocks - int($max_blocks / 16)
+		    && (!$max_keys || $c->{count} < $max_keys - int($max_keys / 16));
+
+	my $victim = victim($c) or return 1;
+
+	return $frequency > frequency($c, $victim->{key}, 0);
+}
+
+sub frequency {
+	my ($c, $key, $add) = @_;
+
+	my $sketch = $c->{sketch};
+	my $width = $c->{mask} + 1;
+	my $min = 15;
+	my $i = 0;
+
+	for my $hash (unpack 'V4', $key) {
+		my $n = $i++ * $width + ($hash & $c->{mask});
+
+		$sketch->[$n]++ if $add && $sketch->[$n] < 15;
+		$min = $sketch->[$n] if $sketch->[$n] < $min;
+	}
+
+	return $min if !$add;
+
+	# the counters are halved in chunks of 64 on the following additions
+
+	if ($c->{aging}) {
+		my $n = $c->{aging} < 64 ? $c->{aging} : 64;
+		$c->{aging} -= $n;
+		$_ >>= 1 for @$sketch[$c->{aging} .. $c->{aging} + $n - 1];
+	}
+
+	if (++$c->{additions} >= $c->{period}) {
+		$c->{additions} = int($c->{additions} / 2);
+		$c->{aging} = 4 * $width;
+	}
+
+	return $min;
+}
+
+sub queue_new {
+	my $q = {};
+	$q->{prev} = $q->{next} = $q;
+	return $q;
+}
+
+sub queue_insert_head {
+	my ($q, $node) = @_;
+
+	$node->{next} = $q->{next};
+	$node->{prev} = $q;
+	$q->{next}{prev} = $node;
+	$q->{next} = $node;
+}
+
+sub queue_remove {
+	my ($node) = @_;
+
+	$node->{prev}{next} = $node->{next};
+	$node->{next}{prev} = $node->{prev};
+	delete $node->{prev};
+	delete $node->{next};
+}
+
+sub queue_last {
+	my ($q) = @_;
+
+	return $q->{prev} == $q ? undef : $q->{prev};
+}
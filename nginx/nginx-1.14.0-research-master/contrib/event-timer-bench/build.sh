@@ -0,0 +1,21 @@
+#!/bin/sh
+
+# Builds event-timer-bench with src/event/ngx_event_timer.c.
+#
+# usage: contrib/event-timer-bench/build.sh [objs]
+#
+# Run it from the nginx source directory after ./configure, which
+# creates objs/ngx_auto_config.h.  Extra include paths, such as the
+# one of pcre.h, can be passed in CFLAGS.
+
+OBJS=${1:-objs}
+BENCH=contrib/event-timer-bench
+CC=${CC:-cc}
+CFLAGS=${CFLAGS:--O2}
+
+INCS="-I src/core -I src/event -I src/event/modules -I src/os/unix -I $OBJS"
+
+$CC $CFLAGS $INCS -o $OBJS/event-timer-bench \
+    $BENCH/event-timer-bench.c src/event/ngx_event_timer.c \
+    src/core/ngx_rbtree.c \
+    && echo "$OBJS/event-timer-bench"
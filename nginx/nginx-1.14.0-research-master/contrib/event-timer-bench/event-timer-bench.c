@@ -0,0 +1,221 @@
+
+/*
+ * The microbenchmark of the event timers: the rbtree and the timer
+ * wheel ("timer_wheel on") backends of src/event/ngx_event_timer.c.
+ *
+ * usage: event-timer-bench [-n timers] [-o operations] [-w]
+ *
+ * The benchmark runs in three phases on a simulated clock:
+ *
+ *   add    "timers" events get timers of 60-75 s, as idle keepalive
+ *          connections do;
+ *   churn  "operations" random events re-arm their timers to 5, 15, 60
+ *          or 75 s, or delete them; the clock advances by 1 ms and the
+ *          expired timers run every 1000 operations;
+ *   drain  the clock jumps to the next timer returned by
+ *          ngx_event_find_timer(), as the event loop does, until no
+ *          timers are left.
+ *
+ * With "-w", the timer wheel is used.  Each timer is checked to fire
+ * exactly at its key; timers fired early or late are reported.
+ */
+
+
+#include <ngx_config.h>
+#include <ngx_core.h>
+#include <ngx_event.h>
+
+
+static void bench_handler(ngx_event_t *ev);
+static uint64_t bench_random(void);
+static double bench_now(void);
+
+
+/* the timers only need these symbols from the core */
+
+volatile ngx_msec_t  ngx_current_msec;
+
+static ngx_event_t  *bench_events;
+static ngx_msec_t   *bench_keys;
+static ngx_uint_t    bench_fired, bench_early, bench_late;
+static uint64_t      bench_seed = 88172645463325252ULL;
+
+
+void
+ngx_log_error_core(ngx_uint_t level, ngx_log_t *log, ngx_err_t err,
+    const char *fmt, ...)
+{
+}
+
+
+int
+main(int argc, char *const *argv)
+{
+    int                i;
+    double             t0, t1, t2, t3;
+    ngx_log_t          log;
+    ngx_msec_t         timer;
+    ngx_uint_t         n, k, ops, fired, steps, left;
+    ngx_event_t       *ev, *evs;
+    ngx_connection_t   c;
+    static ngx_msec_t  timeouts[] = { 5000, 15000, 60000, 75000 };
+
+    n = 500000;
+    ops = 5000000;
+
+    for (i = 1; i < argc; i++) {
+
+        if (ngx_strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            n = atoi(argv[++i]);
+
+        } else if (ngx_strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            ops = atoi(argv[++i]);
+
+        } else if (ngx_strcmp(argv[i], "-w") == 0) {
+            ngx_use_timer_wheel = 1;
+
+        } else {
+            fprintf(stderr, "usage: %s [-n timers] [-o operations] [-w]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    if (n == 0) {
+        return 1;
+    }
+
+    ngx_memzero(&log, sizeof(ngx_log_t));
+    ngx_memzero(&c, sizeof(ngx_connection_t));
+
+    ngx_current_msec = 1000000;
+
+    if (ngx_event_timer_init(&log) != NGX_OK) {
+        return 1;
+    }
+
+    evs = calloc(n, sizeof(ngx_event_t));
+    bench_keys = calloc(n, sizeof(ngx_msec_t));
+
+    if (evs == NULL || bench_keys == NULL) {
+        return 1;
+    }
+
+    bench_events = evs;
+
+    for (k = 0; k < n; k++) {
+        evs[k].log = &log;
+        evs[k].data = &c;
+        evs[k].handler = bench_handler;
+    }
+
+    t0 = bench_now();
+
+    for (k = 0; k < n; k++) {
+        ngx_add_timer(&evs[k], 60000 + bench_random() % 15000);
+        bench_keys[k] = evs[k].timer.key;
+    }
+
+    t1 = bench_now();
+
+    for (k = 0; k < ops; k++) {
+        ev = &evs[bench_random() % n];
+
+        if (ev->timer_set && (bench_random() & 3) == 0) {
+            ngx_del_timer(ev);
+
+        } else {
+            ngx_add_timer(ev, timeouts[bench_random() & 3]);
+            bench_keys[ev - evs] = ev->timer.key;
+        }
+
+        if (k % 1000 == 999) {
+            ngx_current_msec++;
+            ngx_event_expire_timers();
+        }
+    }
+
+    t2 = bench_now();
+
+    fired = bench_fired;
+    steps = 0;
+
+    for ( ;; ) {
+        timer = ngx_event_find_timer();
+
+        if (timer == NGX_TIMER_INFINITE) {
+            break;
+        }
+
+        ngx_current_msec += timer ? timer : 1;
+        ngx_event_expire_timers();
+        steps++;
+    }
+
+    t3 = bench_now();
+
+    fired = bench_fired - fired;
+    left = 0;
+
+    for (k = 0; k < n; k++) {
+        left += evs[k].timer_set;
+    }
+
+    printf("%s n=%lu: add %.1f ns, churn %.1f ns/op, "
+           "drain %.1f ns/timer (%lu timers, %lu steps), "
+           "early %lu, late %lu, left %lu\n",
+           ngx_use_timer_wheel ? "wheel " : "rbtree", (unsigned long) n,
+           (t1 - t0) / n, ops ? (t2 - t1) / ops : 0.0,
+           fired ? (t3 - t2) / fired : 0.0,
+           (unsigned long) fired, (unsigned long) steps,
+           (unsigned long) bench_early, (unsigned long) bench_late,
+           (unsigned long) left);
+
+    return (bench_early || bench_late || left) ? 1 : 0;
+}
+
+
+static void
+bench_handler(ngx_event_t *ev)
+{
+    ngx_msec_t      key;
+    ngx_msec_int_t  diff;
+
+    bench_fired++;
+
+    /* ngx_rbtree_delete() clears the key of the node */
+
+    key = bench_keys[ev - bench_events];
+    diff = (ngx_msec_int_t) (ngx_current_msec - key);
+
+    if (diff < 0) {
+        bench_early++;
+
+    } else if (diff > 0) {
+        bench_late++;
+    }
+}
+
+
+static uint64_t
+bench_random(void)
+{
+    /* xorshift64 */
+
+    bench_seed ^= bench_seed << 13;
+    bench_seed ^= bench_seed >> 7;
+    bench_seed ^= bench_seed << 17;
+
+    return bench_seed;
+}
+
+
+static double
+bench_now(void)
+{
+    struct timespec  ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
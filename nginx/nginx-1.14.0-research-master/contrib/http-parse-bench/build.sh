@@ -0,0 +1,46 @@
+#!/bin/sh
+
+# Builds http-parse-bench with the scalar, SSE2 and SSE4.2 variants
+# of src/http/ngx_http_parse.c; a variant the compiler or the target
+# does not support is skipped.
+#
+# usage: contrib/http-parse-bench/build.sh [objs]
+#
+# Run it from the nginx source directory after ./configure, which
+# creates objs/ngx_auto_config.h.  Extra include paths, such as the
+# one of pcre.h, can be passed in CFLAGS.
+
+OBJS=${1:-objs}
+BENCH=contrib/http-parse-bench
+CC=${CC:-cc}
+CFLAGS=${CFLAGS:--O2}
+
+INCS="-I src/core -I src/event -I src/event/modules -I src/os/unix \
+      -I src/http -I src/http/modules -I $OBJS"
+
+for v in scalar sse2 sse42; do
+
+    case $v in
+        scalar)
+            DEFS="-DNGX_HAVE_SSE2=0 -DNGX_HAVE_SSE42=0"
+            ;;
+
+        sse2)
+            DEFS="-msse2 -DNGX_HAVE_SSE2=1 -DNGX_HAVE_SSE42=0"
+            ;;
+
+        sse42)
+            DEFS="-msse4.2 -DNGX_HAVE_SSE2=1 -DNGX_HAVE_SSE42=1"
+            ;;
+    esac
+
+    if $CC $CFLAGS $DEFS $INCS -o $OBJS/http-parse-bench-$v \
+           $BENCH/http-parse-bench.c src/http/ngx_http_parse.c \
+           src/core/ngx_string.c src/core/ngx_crc32.c
+    then
+        echo "$OBJS/http-parse-bench-$v"
+
+    else
+        echo "$OBJS/http-parse-bench-$v: skipped"
+    fi
+done
@@ -0,0 +1,295 @@
+
+/*
+ * The microbenchmark of the request line and header parser.
+ *
+ * The requests of the corpus are parsed by ngx_http_parse_request_line()
+ * and ngx_http_parse_header_line() in a loop.  On the first pass
+ * the parser results (states, pointers, flags, hashes and lowercased
+ * header names) are folded into a CRC32 digest, so the scalar, SSE2
+ * and SSE4.2 builds of the parser can be compared on the same corpus.
+ *
+ * usage: http-parse-bench [-n iterations] [-s split] [-u] [-v] file ...
+ *
+ * With "-s", each request is passed to the parser in two reads, the
+ * first one ending after "split" bytes, to exercise the resumption
+ * of the parser.  With "-u", underscores are allowed in header names
+ * as with "underscores_in_headers on".  With "-v", the parsed headers
+ * are printed.
+ */
+
+
+#include <ngx_config.h>
+#include <ngx_core.h>
+#include <ngx_http.h>
+
+
+typedef struct {
+    u_char    *data;
+    size_t     len;
+} bench_request_t;
+
+
+static ngx_int_t bench_read(char *name, bench_request_t *req);
+static void bench_parse(bench_request_t *req, ngx_http_request_t *r,
+    size_t split, ngx_uint_t underscores, ngx_uint_t digest,
+    ngx_uint_t verbose);
+static double bench_now(void);
+
+
+/* the parser and ngx_string.c only need these symbols from the core */
+
+volatile ngx_cycle_t  *ngx_cycle;
+ngx_uint_t             ngx_cacheline_size = NGX_CPU_CACHE_LINE;
+
+static uint32_t        bench_digest;
+
+
+void
+ngx_log_error_core(ngx_uint_t level, ngx_log_t *log, ngx_err_t err,
+    const char *fmt, ...)
+{
+}
+
+
+void *
+ngx_alloc(size_t size, ngx_log_t *log)
+{
+    return malloc(size);
+}
+
+
+void *
+ngx_pnalloc(ngx_pool_t *pool, size_t size)
+{
+    return malloc(size);
+}
+
+
+int
+main(int argc, char *const *argv)
+{
+    int                  i;
+    size_t               bytes, split;
+    double               start, elapsed;
+    ngx_uint_t           n, k, iterations, underscores, verbose;
+    bench_request_t     *reqs;
+    ngx_http_request_t   r;
+
+    iterations = 1000000;
+    split = 0;
+    underscores = 0;
+    verbose = 0;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++) {
+
+        if (ngx_strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+
+        } else if (ngx_strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            split = atoi(argv[++i]);
+
+        } else if (ngx_strcmp(argv[i], "-u") == 0) {
+            underscores = 1;
+
+        } else if (ngx_strcmp(argv[i], "-v") == 0) {
+            verbose = 1;
+
+        } else {
+            break;
+        }
+    }
+
+    if (i == argc || iterations == 0) {
+        fprintf(stderr,
+                "usage: %s [-n iterations] [-s split] [-u] [-v] file ...\n",
+                argv[0]);
+        return 1;
+    }
+
+    n = argc - i;
+
+    reqs = malloc(n * sizeof(bench_request_t));
+    if (reqs == NULL) {
+        return 1;
+    }
+
+    bytes = 0;
+
+    for (k = 0; k < n; k++) {
+        if (bench_read(argv[i + k], &reqs[k]) != NGX_OK) {
+            return 1;
+        }
+
+        bytes += reqs[k].len;
+    }
+
+    ngx_crc32_table_init();
+    ngx_memzero(&r, sizeof(ngx_http_request_t));
+
+    ngx_crc32_init(bench_digest);
+
+    for (k = 0; k < n; k++) {
+        bench_parse(&reqs[k], &r, split, underscores, 1, verbose);
+    }
+
+    ngx_crc32_final(bench_digest);
+
+    start = bench_now();
+
+    for (i = 0; i < (int) iterations; i++) {
+        for (k = 0; k < n; k++) {
+            bench_parse(&reqs[k], &r, split, underscores, 0, 0);
+        }
+    }
+
+    elapsed = bench_now() - start;
+
+    printf("digest %08x  %.1f ns/request  %.2f GB/s\n", bench_digest,
+           elapsed / (iterations * n), bytes * iterations / elapsed);
+
+    return 0;
+}
+
+
+static ngx_int_t
+bench_read(char *name, bench_request_t *req)
+{
+    long   size;
+    FILE  *f;
+
+    f = fopen(name, "rb");
+    if (f == NULL) {
+        perror(name);
+        return NGX_ERROR;
+    }
+
+    if (fseek(f, 0, SEEK_END) == -1 || (size = ftell(f)) == -1) {
+        perror(name);
+        fclose(f);
+        return NGX_ERROR;
+    }
+
+    rewind(f);
+
+    req->len = size;
+    req->data = malloc(req->len);
+
+    if (req->data == NULL
+        || fread(req->data, 1, req->len, f) != req->len)
+    {
+        fprintf(stderr, "%s: cannot read\n", name);
+        fclose(f);
+        return NGX_ERROR;
+    }
+
+    fclose(f);
+
+    return NGX_OK;
+}
+
+
+static void
+bench_parse(bench_request_t *req, ngx_http_request_t *r, size_t split,
+    ngx_uint_t underscores, ngx_uint_t digest, ngx_uint_t verbose)
+{
+    u_char      *base, *last;
+    u_char       res[7];
+    ngx_int_t    rc;
+    ngx_buf_t    b;
+
+    base = req->data;
+    last = base + req->len;
+
+    r->state = 0;
+    r->header_hash = 0;
+    r->lowcase_index = 0;
+    r->uri_ext = NULL;
+    r->args_start = NULL;
+    r->complex_uri = 0;
+    r->quoted_uri = 0;
+    r->plus_in_uri = 0;
+
+    b.pos = base;
+    b.last = (split && split < req->len) ? base + split : last;
+
+    for ( ;; ) {
+        rc = ngx_http_parse_request_line(r, &b);
+
+        if (rc == NGX_AGAIN && b.last != last) {
+            b.last = last;
+            continue;
+        }
+
+        break;
+    }
+
+    if (digest) {
+        res[0] = (u_char) (r->uri_end - base);
+        res[1] = (u_char) (r->args_start ? r->args_start - base : 0);
+        res[2] = (u_char) (r->uri_ext ? r->uri_ext - base : 0);
+        res[3] = (u_char) r->complex_uri;
+        res[4] = (u_char) r->quoted_uri;
+        res[5] = (u_char) r->plus_in_uri;
+        res[6] = (u_char) (b.pos - base);
+
+        ngx_crc32_update(&bench_digest, (u_char *) &rc, sizeof(ngx_int_t));
+        ngx_crc32_update(&bench_digest, res, 7);
+    }
+
+    if (rc != NGX_OK) {
+        return;
+    }
+
+    for ( ;; ) {
+        rc = ngx_http_parse_header_line(r, &b, underscores);
+
+        if (rc == NGX_AGAIN && b.last != last) {
+            b.last = last;
+            continue;
+        }
+
+        if (digest) {
+            ngx_crc32_update(&bench_digest, (u_char *) &rc,
+                             sizeof(ngx_int_t));
+        }
+
+        if (rc != NGX_OK) {
+            return;
+        }
+
+        if (digest) {
+            res[0] = (u_char) (r->header_name_start - base);
+            res[1] = (u_char) (r->header_name_end - base);
+            res[2] = (u_char) (r->header_start - base);
+            res[3] = (u_char) (r->header_end - base);
+            res[4] = (u_char) r->invalid_header;
+            res[5] = (u_char) r->lowcase_index;
+
+            ngx_crc32_update(&bench_digest, res, 6);
+            ngx_crc32_update(&bench_digest, (u_char *) &r->header_hash,
+                             sizeof(ngx_uint_t));
+            ngx_crc32_update(&bench_digest, r->lowcase_header,
+                             r->lowcase_index);
+        }
+
+        if (verbose) {
+            printf("%.*s: \"%.*s\" hash:%lu lowcase:\"%.*s\"\n",
+                   (int) (r->header_name_end - r->header_name_start),
+                   r->header_name_start,
+                   (int) (r->header_end - r->header_start), r->header_start,
+                   (unsigned long) r->header_hash,
+                   (int) r->lowcase_index, r->lowcase_header);
+        }
+    }
+}
+
+
+static double
+bench_now(void)
+{
+    struct timespec  ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
@@ -37,6 +37,8 @@ static ngx_int_t ngx_file_info_wrapper(ngx_str_t *name,
     ngx_open_file_info_t *of, ngx_file_info_t *fi, ngx_log_t *log);
 static ngx_int_t ngx_open_and_stat_file(ngx_str_t *name,
     ngx_open_file_info_t *of, ngx_log_t *log);
+static ngx_int_t ngx_open_and_stat_cached_file(ngx_open_file_cache_t *cache,
+    ngx_str_t *name, uint32_t hash, ngx_open_file_info_t *of, ngx_log_t *log);
 static void ngx_open_file_add_event(ngx_open_file_cache_t *cache,
     ngx_cached_open_file_t *file, ngx_open_file_info_t *of, ngx_log_t *log);
 static void ngx_open_file_cleanup(void *data);
@@ -52,6 +54,45 @@ static ngx_cached_open_file_t *
     uint32_t hash);
 static void ngx_open_file_cache_remove(ngx_event_t *ev);
 
+#if (NGX_HAVE_INOTIFY)
+static void ngx_open_file_add_watch(ngx_open_file_cache_t *cache,
+    ngx_cached_open_file_t *file, ngx_open_file_info_t *of, ngx_log_t *log);
+static void ngx_open_file_del_watch(ngx_open_file_cache_event_t *fev);
+static ngx_connection_t *ngx_open_file_inotify_init(ngx_log_t *log);
+static void ngx_open_file_inotify_handler(ngx_event_t *ev);
+static void ngx_open_file_inotify_remove(ngx_rbtree_key_t wd,
+    ngx_uint_t ignored);
+static ngx_open_file_cache_event_t *ngx_open_file_watch_lookup(
+    ngx_rbtree_key_t wd);
+#endif
+
+static ngx_int_t ngx_open_file_shared_lookup(ngx_open_file_cache_t *cache,
+    ngx_str_t *name, uint32_t hash, ngx_open_file_info_t *of,
+    time_t *created);
+static void ngx_open_file_shared_update(ngx_open_file_cache_t *cache,
+    ngx_str_t *name, uint32_t hash, ngx_open_file_info_t *of);
+static void ngx_open_file_shared_delete(ngx_open_file_cache_t *cache,
+    ngx_cached_open_file_t *file);
+static void ngx_open_file_shared_expire(ngx_open_file_shared_cache_t *sh,
+    ngx_slab_pool_t *shpool);
+
+
+#if (NGX_HAVE_INOTIFY)
+
+#define NGX_OPEN_FILE_INOTIFY_MASK                                           \
+    (IN_MODIFY|IN_ATTRIB|IN_MOVE_SELF|IN_DELETE_SELF)
+
+#define ngx_open_file_watch_data(n)                                          \
+    ((ngx_open_file_cache_event_t *)                                         \
+         ((u_char *) (n) - offsetof(ngx_open_file_cache_event_t, node)))
+
+static ngx_connection_t   *ngx_open_file_inotify;
+static ngx_uint_t          ngx_open_file_inotify_disabled;
+static ngx_rbtree_t        ngx_open_file_watches;
+static ngx_rbtree_node_t   ngx_open_file_watch_sentinel;
+
+#endif
+
 
 ngx_open_file_cache_t *
 ngx_open_file_cache_init(ngx_pool_t *pool, ngx_uint_t max, time_t inactive)
@@ -72,6 +113,7 @@ ngx_open_file_cache_init(ngx_pool_t *pool, ngx_uint_t max, time_t inactive)
     cache->current = 0;
     cache->max = max;
     cache->inactive = inactive;
+    cache->shm_zone = NULL;
 
     cln = ngx_pool_cleanup_add(pool, 0);
     if (cln == NULL) {
@@ -144,7 +186,7 @@ ngx_int_t
 ngx_open_cached_file(ngx_open_file_cache_t *cache, ngx_str_t *name,
     ngx_open_file_info_t *of, ngx_pool_t *pool)
 {
-    time_t                          now;
+    time_t                          now, created;
     uint32_t                        hash;
     ngx_int_t                       rc;
     ngx_file_info_t                 fi;
@@ -203,6 +245,7 @@ ngx_open_cached_file(ngx_open_file_cache_t *cache, ngx_str_t *name,
     }
 
     now = ngx_time();
+    created = now;
 
     hash = ngx_crc32_long(name->data, name->len);
 
@@ -218,7 +261,8 @@ ngx_open_cached_file(ngx_open_file_cache_t *cache, ngx_str_t *name,
 
             /* file was not used often enough to keep open */
 
-            rc = ngx_open_and_stat_file(name, of, pool->log);
+            rc = ngx_open_and_stat_cached_file(cache, name, hash, of,
+                                               pool->log);
 
             if (rc != NGX_OK && (of->err == 0 || !of->errors)) {
                 goto failed;
@@ -272,6 +316,32 @@ ngx_open_cached_file(ngx_open_file_cache_t *cache, ngx_str_t *name,
                        "retest open file: %s, fd:%d, c:%d, e:%d",
                        file->name, file->fd, file->count, file->err);
 
+        /*
+         * another worker may have already retested the file: if it
+         * is still the same file or directory, our descriptor is valid
+         * until the shared stat() info expires; files with events are
+         * retested once to start relying upon event notifications
+         */
+
+        if (cache->shm_zone
+            && file->event == NULL
+            && file->err == 0
+            && ngx_open_file_shared_lookup(cache, name, hash, of, &created)
+               == NGX_OK)
+        {
+            if (file->is_dir && of->is_dir) {
+                goto update;
+            }
+
+            if (!file->is_dir && !of->is_dir && of->uniq == file->uniq) {
+                of->fd = file->fd;
+                of->is_directio = file->is_directio;
+                goto update;
+            }
+
+            created = now;
+        }
+
         if (file->is_dir) {
 
             /*
@@ -286,7 +356,7 @@ ngx_open_cached_file(ngx_open_file_cache_t *cache, ngx_str_t *name,
         of->fd = file->fd;
         of->uniq = file->uniq;
 
-        rc = ngx_open_and_stat_file(name, of, pool->log);
+        rc = ngx_open_and_stat_cached_file(cache, name, hash, of, pool->log);
 
         if (rc != NGX_OK && (of->err == 0 || !of->errors)) {
             goto failed;
@@ -351,7 +421,18 @@ ngx_open_cached_file(ngx_open_file_cache_t *cache, ngx_str_t *name,
 
     /* not found */
 
-    rc = ngx_open_and_stat_file(name, of, pool->log);
+    if (cache->shm_zone
+        && ngx_open_file_shared_lookup(cache, name, hash, of, &created)
+           == NGX_OK)
+    {
+        if (of->is_dir) {
+            goto create;
+        }
+
+        created = now;
+    }
+
+    rc = ngx_open_and_stat_cached_file(cache, name, hash, of, pool->log);
 
     if (rc != NGX_OK && (of->err == 0 || !of->errors)) {
         goto failed;
@@ -421,7 +502,7 @@ update:
         }
     }
 
-    file->created = now;
+    file->created = created;
 
 found:
 
@@ -945,6 +1026,22 @@ done:
 }
 
 
+static ngx_int_t
+ngx_open_and_stat_cached_file(ngx_open_file_cache_t *cache, ngx_str_t *name,
+    uint32_t hash, ngx_open_file_info_t *of, ngx_log_t *log)
+{
+    ngx_int_t  rc;
+
+    rc = ngx_open_and_stat_file(name, of, log);
+
+    if (cache->shm_zone && (rc == NGX_OK || of->err)) {
+        ngx_open_file_shared_update(cache, name, hash, of);
+    }
+
+    return rc;
+}
+
+
 /*
  * we ignore any possible event setting error and
  * fallback to usual periodic file retests
@@ -956,8 +1053,7 @@ ngx_open_file_add_event(ngx_open_file_cache_t *cache,
 {
     ngx_open_file_cache_event_t  *fev;
 
-    if (!(ngx_event_flags & NGX_USE_VNODE_EVENT)
-        || !of->events
+    if (!of->events
         || file->event
         || of->fd == NGX_INVALID_FILE
         || file->uses < of->min_uses)
@@ -965,6 +1061,13 @@ ngx_open_file_add_event(ngx_open_file_cache_t *cache,
         return;
     }
 
+    if (!(ngx_event_flags & NGX_USE_VNODE_EVENT)) {
+#if (NGX_HAVE_INOTIFY)
+        ngx_open_file_add_watch(cache, file, of, log);
+#endif
+        return;
+    }
+
     file->use_event = 0;
 
     file->event = ngx_calloc(sizeof(ngx_event_t), log);
@@ -1081,8 +1184,18 @@ ngx_open_file_del_event(ngx_cached_open_file_t *file)
         return;
     }
 
+#if (NGX_HAVE_INOTIFY)
+    if (!(ngx_event_flags & NGX_USE_VNODE_EVENT)) {
+        ngx_open_file_del_watch(file->event->data);
+
+    } else {
+        (void) ngx_del_event(file->event, NGX_VNODE_EVENT,
+                             file->count ? NGX_FLUSH_EVENT : NGX_CLOSE_EVENT);
+    }
+#else
     (void) ngx_del_event(file->event, NGX_VNODE_EVENT,
                          file->count ? NGX_FLUSH_EVENT : NGX_CLOSE_EVENT);
+#endif
 
     ngx_free(file->event->data);
     ngx_free(file->event);
@@ -1238,6 +1351,10 @@ ngx_open_file_cache_remove(ngx_event_t *ev)
 
     fev->cache->current--;
 
+    if (fev->cache->shm_zone) {
+        ngx_open_file_shared_delete(fev->cache, file);
+    }
+
     /* NGX_ONESHOT_EVENT was already deleted */
     file->event = NULL;
     file->use_event = 0;
@@ -1251,3 +1368,572 @@ ngx_open_file_cache_remove(ngx_event_t *ev)
     ngx_free(ev->data);
     ngx_free(ev);
 }
+
+
+#if (NGX_HAVE_INOTIFY)
+
+/*
+ * inotify replaces vnode events on Linux: each worker has a single
+ * inotify descriptor, and watches are added to file names of open files,
+ * so modification, attributes change (including unlink), rename, or
+ * deletion of a file removes it from the cache
+ */
+
+static void
+ngx_open_file_add_watch(ngx_open_file_cache_t *cache,
+    ngx_cached_open_file_t *file, ngx_open_file_info_t *of, ngx_log_t *log)
+{
+    int                           wd;
+    ngx_connection_t             *c;
+    ngx_open_file_cache_event_t  *fev;
+
+    c = ngx_open_file_inotify;
+
+    if (c == NULL) {
+
+        if (ngx_open_file_inotify_disabled
+            || ngx_exiting
+            || (ngx_process != NGX_PROCESS_WORKER
+                && ngx_process != NGX_PROCESS_SINGLE))
+        {
+            return;
+        }
+
+        c = ngx_open_file_inotify_init(log);
+        if (c == NULL) {
+            return;
+        }
+    }
+
+    file->use_event = 0;
+
+    file->event = ngx_calloc(sizeof(ngx_event_t), log);
+    if (file->event == NULL) {
+        return;
+    }
+
+    fev = ngx_alloc(sizeof(ngx_open_file_cache_event_t), log);
+    if (fev == NULL) {
+        ngx_free(file->event);
+        file->event = NULL;
+        return;
+    }
+
+    wd = inotify_add_watch(c->fd, (char *) file->name,
+                           NGX_OPEN_FILE_INOTIFY_MASK);
+
+    if (wd == -1) {
+        ngx_log_debug2(NGX_LOG_DEBUG_CORE, log, ngx_errno,
+                       "inotify_add_watch(\"%s\") failed, fd:%d",
+                       file->name, of->fd);
+        ngx_free(fev);
+        ngx_free(file->event);
+        file->event = NULL;
+        return;
+    }
+
+    ngx_log_debug2(NGX_LOG_DEBUG_CORE, log, 0,
+                   "inotify watch %d: %s", wd, file->name);
+
+    fev->fd = of->fd;
+    fev->file = file;
+    fev->cache = cache;
+    fev->node.key = wd;
+
+    ngx_rbtree_insert(&ngx_open_file_watches, &fev->node);
+
+    file->event->handler = ngx_open_file_cache_remove;
+    file->event->data = fev;
+    file->event->log = ngx_cycle->log;
+
+    /*
+     * as with vnode events, file->use_event is set only
+     * after the next file revalidation
+     */
+}
+
+
+static void
+ngx_open_file_del_watch(ngx_open_file_cache_event_t *fev)
+{
+    ngx_rbtree_key_t  wd;
+
+    wd = fev->node.key;
+
+    ngx_rbtree_delete(&ngx_open_file_watches, &fev->node);
+
+    if (ngx_open_file_inotify == NULL || ngx_open_file_watch_lookup(wd)) {
+        return;
+    }
+
+    ngx_log_debug1(NGX_LOG_DEBUG_CORE, ngx_cycle->log, 0,
+                   "inotify remove watch %d", (int) wd);
+
+    /* the watch may be already removed by the kernel */
+
+    (void) inotify_rm_watch(ngx_open_file_inotify->fd, (int) wd);
+}
+
+
+static ngx_connection_t *
+ngx_open_file_inotify_init(ngx_log_t *log)
+{
+    int                fd;
+    ngx_connection_t  *c;
+
+    fd = inotify_init1(IN_NONBLOCK|IN_CLOEXEC);
+
+    if (fd == -1) {
+        ngx_log_error(NGX_LOG_ALERT, log, ngx_errno,
+                      "inotify_init1() failed, "
+                      "open file cache events are disabled");
+        ngx_open_file_inotify_disabled = 1;
+        return NULL;
+    }
+
+    c = ngx_get_connection(fd, ngx_cycle->log);
+    if (c == NULL) {
+        if (close(fd) == -1) {
+            ngx_log_error(NGX_LOG_ALERT, log, ngx_errno,
+                          "inotify close() failed");
+        }
+
+        return NULL;
+    }
+
+    /* the descriptor is closed by ngx_close_idle_connections() on exit */
+
+    c->idle = 1;
+
+    c->log = ngx_cycle->log;
+    c->read->log = c->log;
+    c->write->log = c->log;
+
+    c->read->handler = ngx_open_file_inotify_handler;
+
+    if (ngx_handle_read_event(c->read, 0) != NGX_OK) {
+        ngx_close_connection(c);
+        return NULL;
+    }
+
+    ngx_rbtree_init(&ngx_open_file_watches, &ngx_open_file_watch_sentinel,
+                    ngx_rbtree_insert_value);
+
+    ngx_open_file_inotify = c;
+
+    return c;
+}
+
+
+static void
+ngx_open_file_inotify_handler(ngx_event_t *ev)
+{
+    u_char                       *p;
+    ssize_t                       n;
+    ngx_err_t                     err;
+    ngx_rbtree_node_t            *root;
+    ngx_connection_t             *c;
+    ngx_cached_open_file_t       *file;
+    struct inotify_event         *ie, buf[256];
+    ngx_open_file_cache_event_t  *fev;
+
+    c = ev->data;
+
+    if (c->close) {
+
+        ngx_log_debug0(NGX_LOG_DEBUG_CORE, ev->log, 0, "inotify close");
+
+        /* cached files fallback to usual periodic retests */
+
+        for ( ;; ) {
+            root = ngx_open_file_watches.root;
+
+            if (root == ngx_open_file_watches.sentinel) {
+                break;
+            }
+
+            fev = ngx_open_file_watch_data(root);
+            file = fev->file;
+
+            ngx_rbtree_delete(&ngx_open_file_watches, &fev->node);
+
+            ngx_free(fev);
+            ngx_free(file->event);
+            file->event = NULL;
+            file->use_event = 0;
+        }
+
+        ngx_open_file_inotify = NULL;
+        ngx_close_connection(c);
+
+        return;
+    }
+
+    for ( ;; ) {
+
+        n = read(c->fd, buf, sizeof(buf));
+
+        if (n == -1) {
+            err = ngx_errno;
+
+            if (err == NGX_EINTR) {
+                continue;
+            }
+
+            if (err != NGX_EAGAIN) {
+                ngx_log_error(NGX_LOG_ALERT, ev->log, err,
+                              "inotify read() failed");
+            }
+
+            break;
+        }
+
+        if (n == 0) {
+            break;
+        }
+
+        for (p = (u_char *) buf;
+             p < (u_char *) buf + n;
+             p += sizeof(struct inotify_event) + ie->len)
+        {
+            ie = (struct inotify_event *) p;
+
+            ngx_log_debug2(NGX_LOG_DEBUG_CORE, ev->log, 0,
+                           "inotify event: %d, mask:%uxD", ie->wd, ie->mask);
+
+            if (ie->mask & IN_Q_OVERFLOW) {
+
+                /* events were lost, so all watched files are removed */
+
+                ngx_open_file_inotify_remove(0, 0);
+                continue;
+            }
+
+            ngx_open_file_inotify_remove(ie->wd, ie->mask & IN_IGNORED);
+        }
+    }
+
+    if (ngx_handle_read_event(ev, 0) != NGX_OK) {
+        ngx_log_error(NGX_LOG_ALERT, ev->log, 0,
+                      "inotify events are lost");
+    }
+}
+
+
+/*
+ * wd == 0 removes all watched files, "ignored" means that
+ * the kernel has already removed the watch
+ */
+
+static void
+ngx_open_file_inotify_remove(ngx_rbtree_key_t wd, ngx_uint_t ignored)
+{
+    ngx_rbtree_node_t            *root;
+    ngx_open_file_cache_event_t  *fev;
+
+    for ( ;; ) {
+
+        if (wd) {
+            fev = ngx_open_file_watch_lookup(wd);
+
+        } else {
+            root = ngx_open_file_watches.root;
+
+            fev = (root == ngx_open_file_watches.sentinel)
+                  ? NULL
+                  : ngx_open_file_watch_data(root);
+        }
+
+        if (fev == NULL) {
+            break;
+        }
+
+        ngx_rbtree_delete(&ngx_open_file_watches, &fev->node);
+
+        if (!ignored && ngx_open_file_inotify
+            && ngx_open_file_watch_lookup(fev->node.key) == NULL)
+        {
+            (void) inotify_rm_watch(ngx_open_file_inotify->fd,
+                                    (int) fev->node.key);
+        }
+
+        ngx_open_file_cache_remove(fev->file->event);
+    }
+}
+
+
+static ngx_open_file_cache_event_t *
+ngx_open_file_watch_lookup(ngx_rbtree_key_t wd)
+{
+    ngx_rbtree_node_t  *node, *sentinel;
+
+    node = ngx_open_file_watches.root;
+    sentinel = ngx_open_file_watches.sentinel;
+
+    while (node != sentinel) {
+
+        if (wd == node->key) {
+            return ngx_open_file_watch_data(node);
+        }
+
+        node = (wd < node->key) ? node->left : node->right;
+    }
+
+    return NULL;
+}
+
+#endif
+
+
+ngx_int_t
+ngx_open_file_cache_init_zone(ngx_shm_zone_t *shm_zone, void *data)
+{
+    size_t                         len;
+    ngx_slab_pool_t               *shpool;
+    ngx_open_file_shared_cache_t  *sh;
+
+    if (data) {
+        shm_zone->data = data;
+        return NGX_OK;
+    }
+
+    shpool = (ngx_slab_pool_t *) shm_zone->shm.addr;
+
+    if (shm_zone->shm.exists) {
+        shm_zone->data = shpool->data;
+        return NGX_OK;
+    }
+
+    sh = ngx_slab_alloc(shpool, sizeof(ngx_open_file_shared_cache_t));
+    if (sh == NULL) {
+        return NGX_ERROR;
+    }
+
+    shpool->data = sh;
+    shm_zone->data = sh;
+
+    ngx_rbtree_init(&sh->rbtree, &sh->sentinel,
+                    ngx_str_rbtree_insert_value);
+
+    ngx_queue_init(&sh->queue);
+
+    len = sizeof(" in open file cache zone \"\"") + shm_zone->shm.name.len;
+
+    shpool->log_ctx = ngx_slab_alloc(shpool, len);
+    if (shpool->log_ctx == NULL) {
+        return NGX_ERROR;
+    }
+
+    ngx_sprintf(shpool->log_ctx, " in open file cache zone \"%V\"%Z",
+                &shm_zone->shm.name);
+
+    shpool->log_nomem = 0;
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_open_file_shared_lookup(ngx_open_file_cache_t *cache, ngx_str_t *name,
+    uint32_t hash, ngx_open_file_info_t *of, time_t *created)
+{
+    ngx_int_t                      rc;
+    ngx_str_node_t                *sn;
+    ngx_slab_pool_t               *shpool;
+    ngx_open_file_shared_node_t   *node;
+    ngx_open_file_shared_cache_t  *sh;
+
+    sh = cache->shm_zone->data;
+    shpool = (ngx_slab_pool_t *) cache->shm_zone->shm.addr;
+
+    rc = NGX_DECLINED;
+
+    ngx_shmtx_lock(&shpool->mutex);
+
+    sn = ngx_str_rbtree_lookup(&sh->rbtree, name, hash);
+
+    if (sn == NULL) {
+        goto done;
+    }
+
+    node = (ngx_open_file_shared_node_t *) sn;
+
+    if (ngx_time() - node->created >= of->valid
+#if (NGX_HAVE_OPENAT)
+        || of->disable_symlinks != node->disable_symlinks
+        || of->disable_symlinks_from != node->disable_symlinks_from
+#endif
+       )
+    {
+        goto done;
+    }
+
+    ngx_queue_remove(&node->queue);
+    ngx_queue_insert_head(&sh->queue, &node->queue);
+
+    of->uniq = node->uniq;
+    of->mtime = node->mtime;
+    of->size = node->size;
+    of->fs_size = node->fs_size;
+
+    of->is_dir = node->is_dir;
+    of->is_file = node->is_file;
+    of->is_link = node->is_link;
+    of->is_exec = node->is_exec;
+
+    *created = node->created;
+
+    rc = NGX_OK;
+
+done:
+
+    ngx_shmtx_unlock(&shpool->mutex);
+
+    ngx_log_debug2(NGX_LOG_DEBUG_CORE, ngx_cycle->log, 0,
+                   "shared open file: \"%V\" %i", name, rc);
+
+    return rc;
+}
+
+
+static void
+ngx_open_file_shared_update(ngx_open_file_cache_t *cache, ngx_str_t *name,
+    uint32_t hash, ngx_open_file_info_t *of)
+{
+    size_t                         size;
+    ngx_str_node_t                *sn;
+    ngx_slab_pool_t               *shpool;
+    ngx_open_file_shared_node_t   *node;
+    ngx_open_file_shared_cache_t  *sh;
+
+    sh = cache->shm_zone->data;
+    shpool = (ngx_slab_pool_t *) cache->shm_zone->shm.addr;
+
+    ngx_shmtx_lock(&shpool->mutex);
+
+    sn = ngx_str_rbtree_lookup(&sh->rbtree, name, hash);
+
+    if (sn) {
+        node = (ngx_open_file_shared_node_t *) sn;
+
+        ngx_queue_remove(&node->queue);
+
+        if (of->err) {
+
+            /* errors are cached by each worker */
+
+            ngx_rbtree_delete(&sh->rbtree, &node->sn.node);
+            ngx_slab_free_locked(shpool, node);
+
+            goto done;
+        }
+
+    } else {
+
+        if (of->err) {
+            goto done;
+        }
+
+        size = offsetof(ngx_open_file_shared_node_t, name) + name->len;
+
+        node = ngx_slab_alloc_locked(shpool, size);
+
+        if (node == NULL) {
+            ngx_open_file_shared_expire(sh, shpool);
+
+            node = ngx_slab_alloc_locked(shpool, size);
+            if (node == NULL) {
+                goto done;
+            }
+        }
+
+        ngx_memcpy(node->name, name->data, name->len);
+
+        node->sn.node.key = hash;
+        node->sn.str.len = name->len;
+        node->sn.str.data = node->name;
+
+        ngx_rbtree_insert(&sh->rbtree, &node->sn.node);
+    }
+
+    node->uniq = of->uniq;
+    node->created = ngx_time();
+    node->mtime = of->mtime;
+    node->size = of->size;
+    node->fs_size = of->fs_size;
+
+#if (NGX_HAVE_OPENAT)
+    node->disable_symlinks = of->disable_symlinks;
+    node->disable_symlinks_from = of->disable_symlinks_from;
+#endif
+
+    node->is_dir = of->is_dir;
+    node->is_file = of->is_file;
+    node->is_link = of->is_link;
+    node->is_exec = of->is_exec;
+
+    ngx_queue_insert_head(&sh->queue, &node->queue);
+
+done:
+
+    ngx_shmtx_unlock(&shpool->mutex);
+}
+
+
+static void
+ngx_open_file_shared_delete(ngx_open_file_cache_t *cache,
+    ngx_cached_open_file_t *file)
+{
+    ngx_str_t                      name;
+    ngx_str_node_t                *sn;
+    ngx_slab_pool_t               *shpool;
+    ngx_open_file_shared_node_t   *node;
+    ngx_open_file_shared_cache_t  *sh;
+
+    sh = cache->shm_zone->data;
+    shpool = (ngx_slab_pool_t *) cache->shm_zone->shm.addr;
+
+    name.len = ngx_strlen(file->name);
+    name.data = file->name;
+
+    ngx_shmtx_lock(&shpool->mutex);
+
+    sn = ngx_str_rbtree_lookup(&sh->rbtree, &name, file->node.key);
+
+    if (sn) {
+        node = (ngx_open_file_shared_node_t *) sn;
+
+        ngx_queue_remove(&node->queue);
+        ngx_rbtree_delete(&sh->rbtree, &node->sn.node);
+        ngx_slab_free_locked(shpool, node);
+    }
+
+    ngx_shmtx_unlock(&shpool->mutex);
+}
+
+
+static void
+ngx_open_file_shared_expire(ngx_open_file_shared_cache_t *sh,
+    ngx_slab_pool_t *shpool)
+{
+    ngx_uint_t                    n;
+    ngx_queue_t                  *q;
+    ngx_open_file_shared_node_t  *node;
+
+    /* the least recently used nodes are freed to make room for a new one */
+
+    for (n = 0; n < 2; n++) {
+
+        if (ngx_queue_empty(&sh->queue)) {
+            return;
+        }
+
+        q = ngx_queue_last(&sh->queue);
+
+        node = ngx_queue_data(q, ngx_open_file_shared_node_t, queue);
+
+        ngx_queue_remove(q);
+        ngx_rbtree_delete(&sh->rbtree, &node->sn.node);
+        ngx_slab_free_locked(shpool, node);
+    }
+}
@@ -96,9 +96,47 @@ typedef struct {
     ngx_uint_t               current;
     ngx_uint_t               max;
     time_t                   inactive;
+
+    ngx_shm_zone_t          *shm_zone;
 } ngx_open_file_cache_t;
 
 
+/*
+ * the shared zone keeps stat() info of files and directories,
+ * so a worker may revalidate its own descriptor without syscalls
+ */
+
+typedef struct {
+    ngx_str_node_t           sn;
+    ngx_queue_t              queue;
+
+    ngx_file_uniq_t          uniq;
+    time_t                   created;
+    time_t                   mtime;
+    off_t                    size;
+    off_t                    fs_size;
+
+#if (NGX_HAVE_OPENAT)
+    size_t                   disable_symlinks_from;
+    unsigned                 disable_symlinks:2;
+#endif
+
+    unsigned                 is_dir:1;
+    unsigned                 is_file:1;
+    unsigned                 is_link:1;
+    unsigned                 is_exec:1;
+
+    u_char                   name[1];
+} ngx_open_file_shared_node_t;
+
+
+typedef struct {
+    ngx_rbtree_t             rbtree;
+    ngx_rbtree_node_t        sentinel;
+    ngx_queue_t              queue;
+} ngx_open_file_shared_cache_t;
+
+
 typedef struct {
     ngx_open_file_cache_t   *cache;
     ngx_cached_open_file_t  *file;
@@ -117,11 +155,16 @@ typedef struct {
 
     ngx_cached_open_file_t  *file;
     ngx_open_file_cache_t   *cache;
+
+#if (NGX_HAVE_INOTIFY)
+    ngx_rbtree_node_t        node;
+#endif
 } ngx_open_file_cache_event_t;
 
 
 ngx_open_file_cache_t *ngx_open_file_cache_init(ngx_pool_t *pool,
     ngx_uint_t max, time_t inactive);
+ngx_int_t ngx_open_file_cache_init_zone(ngx_shm_zone_t *shm_zone, void *data);
 ngx_int_t ngx_open_cached_file(ngx_open_file_cache_t *cache, ngx_str_t *name,
     ngx_open_file_info_t *of, ngx_pool_t *pool);
 
@@ -13,15 +13,68 @@ static ngx_inline void *ngx_palloc_small(ngx_pool_t *pool, size_t size,
     ngx_uint_t align);
 static void *ngx_palloc_block(ngx_pool_t *pool, size_t size);
 static void *ngx_palloc_large(ngx_pool_t *pool, size_t size);
+static void *ngx_pool_link_large(ngx_pool_t *pool, ngx_pool_large_t *large);
+static void ngx_pool_free_large(ngx_pool_large_t *large);
+static ngx_uint_t ngx_pool_class(size_t size);
+static void *ngx_pool_get_block(size_t size, ngx_log_t *log);
+static void ngx_pool_free_block(void *p, size_t size);
+static void *ngx_pool_cache_get(void **cache, ngx_uint_t n, size_t size);
+static ngx_int_t ngx_pool_cache_put(void **cache, ngx_uint_t n, void *p,
+    size_t size);
+#if (NGX_STAT_STUB)
+static void ngx_pool_stat(ngx_pool_t *pool);
+#endif
+
+
+/*
+ * block sizes up to ngx_pagesize are rounded to powers of two starting from
+ * 128 bytes, larger ones to a number of pages up to NGX_POOL_CACHE_PAGES;
+ * the last class collects all other sizes
+ */
+
+#define NGX_POOL_MIN_CLASS_SHIFT  7
+#define NGX_POOL_CACHE_PAGES      16
+
+#define NGX_POOL_COOKIE           0x5bd1e995
+
+#define ngx_pool_large_cookie(pool, p)                                        \
+    ((uintptr_t) (p) ^ (uintptr_t) (pool) ^ NGX_POOL_COOKIE)
+
+
+/*
+ * the cache of free pool blocks and large allocations is per process and
+ * is not locked, so it is enabled by ngx_pool_cache_init() in worker
+ * processes only, where pools are never destroyed by other threads
+ */
+
+static void       *ngx_pool_cache_blocks[NGX_POOL_CLASSES];
+static void       *ngx_pool_cache_large[NGX_POOL_CLASSES];
+static size_t      ngx_pool_cache_class_size[NGX_POOL_CLASSES];
+static size_t      ngx_pool_cache_size;
+static size_t      ngx_pool_cache_max;
+
+
+#if (NGX_STAT_STUB)
+ngx_pool_stat_t   *ngx_pool_stats;
+#endif
 
 
 ngx_pool_t *
 ngx_create_pool(size_t size, ngx_log_t *log)
 {
+    ngx_uint_t   n;
     ngx_pool_t  *p;
 
+    if (ngx_pool_cache_max) {
+        n = ngx_pool_class(size);
+
+        if (n < NGX_POOL_CLASSES - 1) {
+            size = ngx_pool_class_size(n);
+        }
+    }
+
     //使用malloc开辟一个size大小的空间
-    p = ngx_memalign(NGX_POOL_ALIGNMENT, size, log);
+    p = ngx_pool_get_block(size, log);
     if (p == NULL) {
         return NULL;
     }
@@ -50,7 +103,7 @@ void
 ngx_destroy_pool(ngx_pool_t *pool)
 {
     ngx_pool_t          *p, *n;
-    ngx_pool_large_t    *l;
+    ngx_pool_large_t    *l, *next;
     ngx_pool_cleanup_t  *c;
 
     //清理cleanup链表
@@ -84,16 +137,21 @@ ngx_destroy_pool(ngx_pool_t *pool)
 
 #endif
 
-    //释放大内存(在这里只是把alloc指向的使用malloc开辟的空间释放了，而并没有释放ngx_pool_large_s
-    //因为ngx_pool_large_s是在小内存块中获取的空间，因此只需要把小内存块给释放就可以了)
-    for (l = pool->large; l; l = l->next) {
-        if (l->alloc) {
-            ngx_free(l->alloc);
-        }
+    //释放大内存，ngx_pool_large_s位于大块内存的头部，与之一起释放
+    for (l = pool->large; l; l = next) {
+        next = l->next;
+        ngx_pool_free_large(l);
+    }
+
+#if (NGX_STAT_STUB)
+    if (ngx_pool_stats) {
+        ngx_pool_stat(pool);
     }
+#endif
+
     //释放普通内存
     for (p = pool, n = pool->d.next; /* void */; p = n, n = n->d.next) {
-        ngx_free(p);
+        ngx_pool_free_block(p, p->d.end - (u_char *) p);
 
         if (n == NULL) {
             break;
@@ -106,12 +164,11 @@ void
 ngx_reset_pool(ngx_pool_t *pool)
 {
     ngx_pool_t        *p;
-    ngx_pool_large_t  *l;
+    ngx_pool_large_t  *l, *next;
 
-    for (l = pool->large; l; l = l->next) {
-        if (l->alloc) {
-            ngx_free(l->alloc); //释放大块内存
-        }
+    for (l = pool->large; l; l = next) {
+        next = l->next;
+        ngx_pool_free_large(l); //释放大块内存
     }
 
     for (p = pool; p; p = p->d.next) {
@@ -202,7 +259,7 @@ ngx_palloc_block(ngx_pool_t *pool, size_t size)
 
     psize = (size_t) (pool->d.end - (u_char *) pool);
     /*申请新的块*/
-    m = ngx_memalign(NGX_POOL_ALIGNMENT, psize, pool->log);
+    m = ngx_pool_get_block(psize, pool->log);
     if (m == NULL) {
         return NULL;
     }
@@ -233,87 +290,142 @@ ngx_palloc_block(ngx_pool_t *pool, size_t size)
 static void *
 ngx_palloc_large(ngx_pool_t *pool, size_t size)
 {
-    void              *p;
+    u_char            *m;
     ngx_uint_t         n;
     ngx_pool_large_t  *large;
 
-    //分配一块新的大内存块
-    p = ngx_alloc(size, pool->log);
-    if (p == NULL) {
-        return NULL;
+    n = ngx_pool_class(size);
+
+    m = NULL;
+
+    if (ngx_pool_cache_max && n < NGX_POOL_CLASSES - 1) {
+        size = ngx_pool_class_size(n);
+        m = ngx_pool_cache_get(ngx_pool_cache_large, n, size);
     }
 
-    n = 0;
+#if (NGX_STAT_STUB)
+    if (ngx_pool_stats) {
+        (void) ngx_atomic_fetch_add(&ngx_pool_stats[n].large, 1);
 
-    /* 去pool->large链表上查询是否有NULL的，只在链表上往下查询3次，主要判断大数据块是否有被释放的，如果没有则只能跳出*/
-    for (large = pool->large; large; large = large->next) {
-        if (large->alloc == NULL) {
-            large->alloc = p;
-            return p;
+        if (m) {
+            (void) ngx_atomic_fetch_add(&ngx_pool_stats[n].large_cached, 1);
         }
+    }
+#endif
 
-        if (n++ > 3) {
-            break;
+    if (m == NULL) {
+        m = ngx_alloc(sizeof(ngx_pool_large_t) + size, pool->log);
+        if (m == NULL) {
+            return NULL;
         }
     }
-    //申请ngx_pool_large_t内存对象
-    large = ngx_palloc_small(pool, sizeof(ngx_pool_large_t), 1);
-    if (large == NULL) {
-        ngx_free(p);
-        return NULL;
-    }
 
-    //环形链表
-    large->alloc = p;
-    large->next = pool->large;
-    pool->large = large;
+    large = (ngx_pool_large_t *) m;
 
-    return p;
+    large->mem = m;
+    large->size = size;
+
+    return ngx_pool_link_large(pool, large);
 }
 
 //在分配size大小的内存，并按照alignment对齐，然后挂到large字段下
 void *
 ngx_pmemalign(ngx_pool_t *pool, size_t size, size_t alignment)
 {
-    void              *p;
+    u_char            *m;
+    size_t             offset;
     ngx_pool_large_t  *large;
 
-    p = ngx_memalign(alignment, size, pool->log);
-    if (p == NULL) {
-        return NULL;
-    }
+    /* the header is put at the end of the alignment padding */
 
-    large = ngx_palloc_small(pool, sizeof(ngx_pool_large_t), 1);
-    if (large == NULL) {
-        ngx_free(p);
+    offset = ngx_align(sizeof(ngx_pool_large_t), alignment);
+
+    m = ngx_memalign(alignment, offset + size, pool->log);
+    if (m == NULL) {
         return NULL;
     }
 
-    large->alloc = p;
+    large = (ngx_pool_large_t *) (m + offset - sizeof(ngx_pool_large_t));
+
+    large->mem = m;
+    large->size = 0;
+
+    return ngx_pool_link_large(pool, large);
+}
+
+
+static void *
+ngx_pool_link_large(ngx_pool_t *pool, ngx_pool_large_t *large)
+{
+    large->alloc = (u_char *) large + sizeof(ngx_pool_large_t);
+    large->cookie = ngx_pool_large_cookie(pool, large->alloc);
+
     large->next = pool->large;
+    large->prev = &pool->large;
+
+    if (pool->large) {
+        pool->large->prev = &large->next;
+    }
+
     pool->large = large;
 
-    return p;
+    return large->alloc;
 }
 
-//控制大块内存的释放。注意，这个函数只会释放大内存，不会释放其对应的头部结构，遗留下来的头部结构会做下一次申请大内存之用
+//控制大块内存的释放，头部结构紧挨在大块内存之前，不需要遍历pool->large链表
 ngx_int_t
 ngx_pfree(ngx_pool_t *pool, void *p)
 {
     ngx_pool_large_t  *l;
 
-    for (l = pool->large; l; l = l->next) {
-        if (p == l->alloc) {
-            ngx_log_debug1(NGX_LOG_DEBUG_ALLOC, pool->log, 0,
-                           "free: %p", l->alloc);
-            ngx_free(l->alloc);
-            l->alloc = NULL;
+    if (p == NULL) {
+        return NGX_DECLINED;
+    }
+
+    /*
+     * the cookie is the last field of the header, so for memory allocated
+     * from the pool blocks only a word inside the block is read
+     */
+
+    l = (ngx_pool_large_t *) ((u_char *) p - sizeof(ngx_pool_large_t));
+
+    if (l->cookie != ngx_pool_large_cookie(pool, p) || l->alloc != p) {
+        return NGX_DECLINED;
+    }
+
+    ngx_log_debug1(NGX_LOG_DEBUG_ALLOC, pool->log, 0, "free: %p", p);
+
+    *l->prev = l->next;
+
+    if (l->next) {
+        l->next->prev = l->prev;
+    }
+
+    ngx_pool_free_large(l);
+
+    return NGX_OK;
+}
+
+
+static void
+ngx_pool_free_large(ngx_pool_large_t *large)
+{
+    ngx_uint_t  n;
+
+    large->cookie = 0;
+
+    if (large->size) {
+        n = ngx_pool_class(large->size);
 
-            return NGX_OK;
+        if (ngx_pool_cache_put(ngx_pool_cache_large, n, large->mem,
+                               large->size)
+            == NGX_OK)
+        {
+            return;
         }
     }
 
-    return NGX_DECLINED;
+    ngx_free(large->mem);
 }
 
 //pcalloc直接调用palloc分配好内存，然后进行一次0初始化操作
@@ -424,30 +536,202 @@ ngx_pool_delete_file(void *data)
 }
 
 
-#if 0
+void
+ngx_pool_cache_init(size_t size)
+{
+    ngx_uint_t  n;
+
+    if (ngx_pagesize_shift + NGX_POOL_CACHE_PAGES
+        >= NGX_POOL_CLASSES + NGX_POOL_MIN_CLASS_SHIFT)
+    {
+        /* the page size is too large for the classes */
+        return;
+    }
+
+    for (n = 0; n < NGX_POOL_CLASSES - 1; n++) {
+        ngx_pool_cache_class_size[n] = ngx_pool_class_size(n);
+    }
+
+    ngx_pool_cache_max = size;
+}
+
+
+size_t
+ngx_pool_class_size(ngx_uint_t n)
+{
+    ngx_uint_t  pow2;
+
+    /* the number of power of two classes up to and including a page */
+
+    pow2 = ngx_pagesize_shift - NGX_POOL_MIN_CLASS_SHIFT + 1;
+
+    if (n < pow2) {
+        return (size_t) 1 << (NGX_POOL_MIN_CLASS_SHIFT + n);
+    }
+
+    return (n - pow2 + 2) << ngx_pagesize_shift;
+}
+
+
+static ngx_uint_t
+ngx_pool_class(size_t size)
+{
+    size_t      s;
+    ngx_uint_t  n;
+
+    if (ngx_pagesize == 0) {
+        /* ngx_os_init() has not been called yet */
+        return NGX_POOL_CLASSES - 1;
+    }
+
+    if (size <= ngx_pagesize) {
+        for (n = 0, s = 1 << NGX_POOL_MIN_CLASS_SHIFT; s < size; s <<= 1) {
+            n++;
+        }
+
+        return n;
+    }
+
+    n = (size + ngx_pagesize - 1) >> ngx_pagesize_shift;
+
+    if (n > NGX_POOL_CACHE_PAGES) {
+        return NGX_POOL_CLASSES - 1;
+    }
+
+    n += ngx_pagesize_shift - NGX_POOL_MIN_CLASS_SHIFT - 1;
+
+    return ngx_min(n, NGX_POOL_CLASSES - 1);
+}
+
 
 static void *
-ngx_get_cached_block(size_t size)
+ngx_pool_get_block(size_t size, ngx_log_t *log)
 {
-    void                     *p;
-    ngx_cached_block_slot_t  *slot;
+    void        *p;
+    ngx_uint_t   n;
+
+    if (ngx_pool_cache_max) {
+        n = ngx_pool_class(size);
+
+        p = ngx_pool_cache_get(ngx_pool_cache_blocks, n, size);
+
+        if (p) {
+
+#if (NGX_STAT_STUB)
+            if (ngx_pool_stats) {
+                (void) ngx_atomic_fetch_add(&ngx_pool_stats[n].cached, 1);
+            }
+#endif
 
-    if (ngx_cycle->cache == NULL) {
+            return p;
+        }
+    }
+
+    return ngx_memalign(NGX_POOL_ALIGNMENT, size, log);
+}
+
+
+static void
+ngx_pool_free_block(void *p, size_t size)
+{
+    if (ngx_pool_cache_put(ngx_pool_cache_blocks, ngx_pool_class(size), p,
+                           size)
+        == NGX_OK)
+    {
+        return;
+    }
+
+    ngx_free(p);
+}
+
+
+static void *
+ngx_pool_cache_get(void **cache, ngx_uint_t n, size_t size)
+{
+    void  *p;
+
+    if (n >= NGX_POOL_CLASSES - 1
+        || ngx_pool_cache_class_size[n] != size
+        || cache[n] == NULL)
+    {
         return NULL;
     }
 
-    slot = &ngx_cycle->cache[(size + ngx_pagesize - 1) / ngx_pagesize];
+    p = cache[n];
+    cache[n] = *(void **) p;
+
+    ngx_pool_cache_size -= size;
+
+    return p;
+}
+
 
-    slot->tries++;
+/*
+ * a block is cached only if its size is exactly the class size, so blocks
+ * allocated before the cache was enabled are just freed
+ */
 
-    if (slot->number) {
-        p = slot->block;
-        slot->block = slot->block->next;
-        slot->number--;
-        return p;
+static ngx_int_t
+ngx_pool_cache_put(void **cache, ngx_uint_t n, void *p, size_t size)
+{
+    if (n >= NGX_POOL_CLASSES - 1
+        || ngx_pool_cache_class_size[n] != size
+        || ngx_pool_cache_size + size > ngx_pool_cache_max)
+    {
+        return NGX_DECLINED;
     }
 
-    return NULL;
+    *(void **) p = cache[n];
+    cache[n] = p;
+
+    ngx_pool_cache_size += size;
+
+    return NGX_OK;
+}
+
+
+#if (NGX_STAT_STUB)
+
+static void
+ngx_pool_stat(ngx_pool_t *pool)
+{
+    u_char           *start;
+    size_t            used, wasted;
+    ngx_uint_t        blocks, n, failed[NGX_POOL_FAILED_BINS];
+    ngx_pool_t       *p;
+    ngx_pool_stat_t  *st;
+
+    blocks = 0;
+    used = 0;
+    wasted = 0;
+
+    ngx_memzero(failed, sizeof(failed));
+
+    start = (u_char *) pool + sizeof(ngx_pool_t);
+
+    for (p = pool; p; p = p->d.next) {
+        blocks++;
+        used += p->d.last - start;
+        wasted += p->d.end - p->d.last;
+
+        n = ngx_min(p->d.failed, NGX_POOL_FAILED_BINS - 1);
+        failed[n]++;
+
+        start = (u_char *) p->d.next + sizeof(ngx_pool_data_t);
+    }
+
+    st = &ngx_pool_stats[ngx_pool_class(pool->d.end - (u_char *) pool)];
+
+    (void) ngx_atomic_fetch_add(&st->pools, 1);
+    (void) ngx_atomic_fetch_add(&st->blocks, blocks);
+    (void) ngx_atomic_fetch_add(&st->used, used);
+    (void) ngx_atomic_fetch_add(&st->wasted, wasted);
+
+    for (n = 0; n < NGX_POOL_FAILED_BINS; n++) {
+        if (failed[n]) {
+            (void) ngx_atomic_fetch_add(&st->failed[n], failed[n]);
+        }
+    }
 }
 
 #endif
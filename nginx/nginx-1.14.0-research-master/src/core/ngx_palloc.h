@@ -40,10 +40,20 @@ struct ngx_pool_cleanup_s {
 
 typedef struct ngx_pool_large_s  ngx_pool_large_t;
 
+/*
+ * the large allocation header is placed right before the memory returned
+ * to a caller, so ngx_pfree() finds it without walking the pool->large list;
+ * the cookie is the last field and validates that the pointer is ours
+ */
+
 //大内存结构
 struct ngx_pool_large_s {
     ngx_pool_large_t     *next;     //下一个大块内存
     void                 *alloc;    //nginx分配的大块内存空间
+    ngx_pool_large_t    **prev;
+    void                 *mem;
+    size_t                size;
+    uintptr_t             cookie;
 };
 
 
@@ -69,6 +79,24 @@ struct ngx_pool_s {
     ngx_log_t            *log;
 };
 
+/* the size classes of pool blocks and large allocations, see ngx_palloc.c */
+#define NGX_POOL_CLASSES         32
+
+#define NGX_POOL_FAILED_BINS     6
+
+
+typedef struct {
+    ngx_atomic_t          pools;
+    ngx_atomic_t          blocks;
+    ngx_atomic_t          cached;
+    ngx_atomic_t          used;
+    ngx_atomic_t          wasted;
+    ngx_atomic_t          failed[NGX_POOL_FAILED_BINS];
+    ngx_atomic_t          large;
+    ngx_atomic_t          large_cached;
+} ngx_pool_stat_t;
+
+
 /*ngx_pool_cleanup_t中的*data成员通常指向ngx_pool_cleanup_file_t结构体*/
 typedef struct {
     ngx_fd_t              fd;
@@ -87,6 +115,9 @@ void *ngx_pcalloc(ngx_pool_t *pool, size_t size);   //pcalloc直接调用palloc
 void *ngx_pmemalign(ngx_pool_t *pool, size_t size, size_t alignment);   //在分配size大小的内存，并按照alignment对齐，然后挂到large字段下
 ngx_int_t ngx_pfree(ngx_pool_t *pool, void *p);     //释放large内存
 
+void ngx_pool_cache_init(size_t size);
+size_t ngx_pool_class_size(ngx_uint_t n);
+
 
 ngx_pool_cleanup_t *ngx_pool_cleanup_add(ngx_pool_t *p, size_t size);   //注册cleanup
 void ngx_pool_run_cleanup_file(ngx_pool_t *p, ngx_fd_t fd); //清除 p->cleanup链表上的内存块（主要是文件描述符）
@@ -94,4 +125,9 @@ void ngx_pool_cleanup_file(void *data); //关闭文件回调函数
 void ngx_pool_delete_file(void *data);  //删除文件回调函数
 
 
+#if (NGX_STAT_STUB)
+extern ngx_pool_stat_t  *ngx_pool_stats;
+#endif
+
+
 #endif /* _NGX_PALLOC_H_INCLUDED_ */
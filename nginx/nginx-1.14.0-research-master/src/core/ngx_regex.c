@@ -229,6 +229,175 @@ ngx_regex_exec_array(ngx_array_t *a, ngx_str_t *s, ngx_log_t *log)
 }
 
 
+/*
+ * copies to "prefix" the literal string every subject matched by
+ * an anchored pattern starts with, e.g. "/api/v" for "^/api/v\d+/";
+ * the result is a necessary condition only, so anything the simple
+ * scanner below cannot prove yields an empty prefix
+ */
+
+size_t
+ngx_regex_literal_prefix(ngx_str_t *pattern, ngx_int_t options,
+    u_char *prefix)
+{
+    u_char      c, *p, *last;
+    size_t      len;
+    ngx_int_t   depth;
+    ngx_uint_t  class;
+
+    p = pattern->data;
+    last = p + pattern->len;
+
+    if (p == last || *p != '^') {
+        return 0;
+    }
+
+    /*
+     * an alternative on the top level is not anchored by the leading "^";
+     * \Q...\E quoting, comments, conditionals and option settings may hide
+     * the group structure and are not analyzed at all
+     */
+
+    depth = 0;
+    class = 0;
+
+    while (p < last) {
+        c = *p++;
+
+        if (c == '\\') {
+
+            if (p < last && (*p == 'Q' || *p == 'c')) {
+
+                if (*p == 'Q') {
+                    return 0;
+                }
+
+                /* a control character, "\c(" is not a group */
+                p++;
+            }
+
+            p++;
+            continue;
+        }
+
+        if (class) {
+
+            if (c == '[' && p < last && (*p == ':' || *p == '.' || *p == '='))
+            {
+                /* "[:alpha:]" and alike */
+
+                c = *p++;
+
+                while (p + 1 < last && !(*p == c && p[1] == ']')) {
+                    p++;
+                }
+
+                p += 2;
+                continue;
+            }
+
+            if (c == ']') {
+                class = 0;
+            }
+
+            continue;
+        }
+
+        switch (c) {
+
+        case '[':
+            class = 1;
+
+            if (p < last && *p == '^') {
+                p++;
+            }
+
+            /* a leading "]" is literal */
+
+            if (p < last && *p == ']') {
+                p++;
+            }
+
+            break;
+
+        case '(':
+
+            if (p < last && *p == '?') {
+
+                if (p + 1 == last || p[1] == '\0'
+                    || ngx_strchr(":=!<>P'|", p[1]) == NULL)
+                {
+                    return 0;
+                }
+            }
+
+            depth++;
+            break;
+
+        case ')':
+            depth--;
+            break;
+
+        case '|':
+
+            if (depth == 0) {
+                return 0;
+            }
+
+            break;
+        }
+    }
+
+    if (depth != 0 || class) {
+        return 0;
+    }
+
+    len = 0;
+
+    for (p = pattern->data + 1; p < last; p++) {
+        c = *p;
+
+        if (c == '\\') {
+
+            if (p + 1 == last) {
+                break;
+            }
+
+            c = p[1];
+
+            if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z')
+                || (c >= 'A' && c <= 'Z'))
+            {
+                /* "\d", "\x2f" and so on */
+                break;
+            }
+
+            p++;
+
+        } else if (c == '\0' || ngx_strchr("^$.[|()?*+{", c) != NULL) {
+            break;
+        }
+
+        if ((options & NGX_REGEX_CASELESS)
+            && ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c >= 0x80))
+        {
+            break;
+        }
+
+        if (p + 1 < last
+            && (p[1] == '?' || p[1] == '*' || p[1] == '+' || p[1] == '{'))
+        {
+            /* a quantified character may be absent or repeated */
+            break;
+        }
+
+        prefix[len++] = c;
+    }
+
+    return len;
+}
+
+
 static void * ngx_libc_cdecl
 ngx_regex_malloc(size_t size)
 {
@@ -55,6 +55,8 @@ ngx_int_t ngx_regex_compile(ngx_regex_compile_t *rc);
 #define ngx_regex_exec_n      "pcre_exec()"
 
 ngx_int_t ngx_regex_exec_array(ngx_array_t *a, ngx_str_t *s, ngx_log_t *log);
+size_t ngx_regex_literal_prefix(ngx_str_t *pattern, ngx_int_t options,
+    u_char *prefix);
 
 
 #endif /* _NGX_REGEX_H_INCLUDED_ */
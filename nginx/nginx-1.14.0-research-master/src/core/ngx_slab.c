@@ -165,6 +165,67 @@ ngx_slab_init(ngx_slab_pool_t *pool)
 }
 
 
+/*
+ * splits free pages of a zone into n slab pools, each with its own mutex,
+ * so that a module may distribute its data between them by a key hash;
+ * the shards inherit log_ctx and log_nomem of the zone pool
+ */
+
+ngx_int_t
+ngx_slab_init_shards(ngx_slab_pool_t *pool, ngx_slab_pool_t **shards,
+    ngx_uint_t n)
+{
+    u_char           *p;
+    size_t            size;
+    ngx_uint_t        i;
+    ngx_slab_pool_t  *sp;
+
+    /* a page is left in the zone pool for the allocations of a module */
+
+    size = (pool->pfree - 1) / n * ngx_pagesize;
+
+    if (size < NGX_SLAB_MIN_SHARD_PAGES * ngx_pagesize) {
+        return NGX_DECLINED;
+    }
+
+    for (i = 0; i < n; i++) {
+        p = ngx_slab_alloc(pool, size);
+        if (p == NULL) {
+            return NGX_ERROR;
+        }
+
+        sp = (ngx_slab_pool_t *) p;
+
+        sp->end = p + size;
+        sp->min_shift = pool->min_shift;
+        sp->addr = p;
+
+#if (NGX_HAVE_ATOMIC_OPS)
+
+        if (ngx_shmtx_create(&sp->mutex, &sp->lock, NULL) != NGX_OK) {
+            return NGX_ERROR;
+        }
+
+#else
+
+        /* the file lock of the zone is shared by all shards */
+
+        sp->mutex = pool->mutex;
+
+#endif
+
+        ngx_slab_init(sp);
+
+        sp->log_ctx = pool->log_ctx;
+        sp->log_nomem = pool->log_nomem;
+
+        shards[i] = sp;
+    }
+
+    return NGX_OK;
+}
+
+
 void *
 ngx_slab_alloc(ngx_slab_pool_t *pool, size_t size)
 {
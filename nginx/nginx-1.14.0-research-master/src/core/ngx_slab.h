@@ -13,6 +13,9 @@
 #include <ngx_core.h>
 
 
+#define NGX_SLAB_MIN_SHARD_PAGES  8
+
+
 typedef struct ngx_slab_page_s  ngx_slab_page_t;
 
 struct ngx_slab_page_s {
@@ -61,6 +64,8 @@ typedef struct {
 
 void ngx_slab_sizes_init(void);
 void ngx_slab_init(ngx_slab_pool_t *pool);
+ngx_int_t ngx_slab_init_shards(ngx_slab_pool_t *pool, ngx_slab_pool_t **shards,
+    ngx_uint_t n);
 void *ngx_slab_alloc(ngx_slab_pool_t *pool, size_t size);
 void *ngx_slab_alloc_locked(ngx_slab_pool_t *pool, size_t size);
 void *ngx_slab_calloc(ngx_slab_pool_t *pool, size_t size);
@@ -16,20 +16,54 @@ typedef struct {
 } ngx_thread_pool_conf_t;
 
 
+/*
+ * each thread of a pool has its own ring of posted tasks; the tasks are
+ * posted only by the event loop thread, so "tail" is written by it alone,
+ * while the thread itself and idle threads stealing work claim tasks
+ * by moving "head" with ngx_atomic_cmp_set()
+ */
+
 typedef struct {
-    ngx_thread_task_t        *first;
-    ngx_thread_task_t       **last;
-} ngx_thread_pool_queue_t;
+    ngx_atomic_t              head;
+    u_char                    pad1[NGX_CPU_CACHE_LINE
+                                   - sizeof(ngx_atomic_t)];
+    ngx_atomic_t              tail;
+    u_char                    pad2[NGX_CPU_CACHE_LINE
+                                   - sizeof(ngx_atomic_t)];
+
+    ngx_thread_task_t       **tasks;
+    ngx_uint_t                mask;
 
-#define ngx_thread_pool_queue_init(q)                                         \
-    (q)->first = NULL;                                                        \
-    (q)->last = &(q)->first
+    ngx_thread_pool_t        *tp;
+    ngx_uint_t                index;
+} ngx_thread_pool_ring_t;
+
+
+#if (NGX_STAT_STUB)
+
+#define NGX_THREAD_POOL_MAX_STATS  64
+
+typedef struct {
+    ngx_atomic_t              name;
+    ngx_atomic_t              queued;
+    ngx_atomic_t              tasks;
+    ngx_atomic_t              stolen;
+    ngx_atomic_t              overflows;
+    ngx_atomic_t              wait_time;
+    ngx_atomic_t              run_time;
+} ngx_thread_pool_stat_t;
+
+#endif
 
 
 struct ngx_thread_pool_s {
+    ngx_thread_pool_ring_t   *rings;
+    ngx_uint_t                next;
+
+    /* the number of threads waiting on the condition variable */
+    ngx_atomic_t              sleeping;
+
     ngx_thread_mutex_t        mtx;
-    ngx_thread_pool_queue_t   queue;
-    ngx_int_t                 waiting;
     ngx_thread_cond_t         cond;
 
     ngx_log_t                *log;
@@ -38,6 +72,10 @@ struct ngx_thread_pool_s {
     ngx_uint_t                threads;
     ngx_int_t                 max_queue;
 
+#if (NGX_STAT_STUB)
+    ngx_thread_pool_stat_t   *stat;
+#endif
+
     u_char                   *file;
     ngx_uint_t                line;
 };
@@ -49,6 +87,9 @@ static void ngx_thread_pool_destroy(ngx_thread_pool_t *tp);
 static void ngx_thread_pool_exit_handler(void *data, ngx_log_t *log);
 
 static void *ngx_thread_pool_cycle(void *data);
+static ngx_thread_task_t *ngx_thread_pool_take(ngx_thread_pool_ring_t *ring);
+static ngx_thread_task_t *ngx_thread_pool_steal(ngx_thread_pool_ring_t *ring);
+static ngx_uint_t ngx_thread_pool_queued(ngx_thread_pool_t *tp);
 static void ngx_thread_pool_handler(ngx_event_t *ev);
 
 static char *ngx_thread_pool(ngx_conf_t *cf, ngx_command_t *cmd, void *conf);
@@ -57,6 +98,12 @@ static void *ngx_thread_pool_create_conf(ngx_cycle_t *cycle);
 static char *ngx_thread_pool_init_conf(ngx_cycle_t *cycle, void *conf);
 
 static ngx_int_t ngx_thread_pool_init_worker(ngx_cycle_t *cycle);
+#if (NGX_STAT_STUB)
+static ngx_int_t ngx_thread_pool_init_module(ngx_cycle_t *cycle);
+static ngx_uint_t ngx_thread_pool_usec(void);
+#else
+#define ngx_thread_pool_init_module  NULL
+#endif
 static void ngx_thread_pool_exit_worker(ngx_cycle_t *cycle);
 
 
@@ -86,7 +133,7 @@ ngx_module_t  ngx_thread_pool_module = {
     ngx_thread_pool_commands,              /* module directives */
     NGX_CORE_MODULE,                       /* module type */
     NULL,                                  /* init master */
-    NULL,                                  /* init module */
+    ngx_thread_pool_init_module,           /* init module */
     ngx_thread_pool_init_worker,           /* init process */
     NULL,                                  /* init thread */
     NULL,                                  /* exit thread */
@@ -99,17 +146,23 @@ ngx_module_t  ngx_thread_pool_module = {
 static ngx_str_t  ngx_thread_pool_default = ngx_string("default");
 
 static ngx_uint_t               ngx_thread_pool_task_id;
-static ngx_atomic_t             ngx_thread_pool_done_lock;
-static ngx_thread_pool_queue_t  ngx_thread_pool_done;
+
+/* a lock-free stack of completed tasks, see ngx_thread_pool_handler() */
+static ngx_atomic_t             ngx_thread_pool_done;
+
+#if (NGX_STAT_STUB)
+static ngx_thread_pool_stat_t  *ngx_thread_pool_stats;
+#endif
 
 
 static ngx_int_t
 ngx_thread_pool_init(ngx_thread_pool_t *tp, ngx_log_t *log, ngx_pool_t *pool)
 {
-    int             err;
-    pthread_t       tid;
-    ngx_uint_t      n;
-    pthread_attr_t  attr;
+    int                      err;
+    pthread_t                tid;
+    ngx_uint_t               n, size;
+    pthread_attr_t           attr;
+    ngx_thread_pool_ring_t  *ring;
 
     if (ngx_notify == NULL) {
         ngx_log_error(NGX_LOG_ALERT, log, 0,
@@ -117,7 +170,38 @@ ngx_thread_pool_init(ngx_thread_pool_t *tp, ngx_log_t *log, ngx_pool_t *pool)
         return NGX_ERROR;
     }
 
-    ngx_thread_pool_queue_init(&tp->queue);
+    /* the rings together hold at least max_queue tasks */
+
+    for (size = 1; size * tp->threads < (ngx_uint_t) tp->max_queue; size <<= 1)
+    {
+        /* void */
+    }
+
+    tp->rings = ngx_pmemalign(pool,
+                              tp->threads * sizeof(ngx_thread_pool_ring_t),
+                              NGX_CPU_CACHE_LINE);
+    if (tp->rings == NULL) {
+        return NGX_ERROR;
+    }
+
+    for (n = 0; n < tp->threads; n++) {
+        ring = &tp->rings[n];
+
+        ring->head = 0;
+        ring->tail = 0;
+
+        ring->tasks = ngx_palloc(pool, size * sizeof(ngx_thread_task_t *));
+        if (ring->tasks == NULL) {
+            return NGX_ERROR;
+        }
+
+        ring->mask = size - 1;
+        ring->tp = tp;
+        ring->index = n;
+    }
+
+    tp->next = 0;
+    tp->sleeping = 0;
 
     if (ngx_thread_mutex_create(&tp->mtx, log) != NGX_OK) {
         return NGX_ERROR;
@@ -154,7 +238,8 @@ ngx_thread_pool_init(ngx_thread_pool_t *tp, ngx_log_t *log, ngx_pool_t *pool)
 #endif
 
     for (n = 0; n < tp->threads; n++) {
-        err = pthread_create(&tid, &attr, ngx_thread_pool_cycle, tp);
+        err = pthread_create(&tid, &attr, ngx_thread_pool_cycle,
+                             &tp->rings[n]);
         if (err) {
             ngx_log_error(NGX_LOG_ALERT, log, err,
                           "pthread_create() failed");
@@ -230,41 +315,94 @@ ngx_thread_task_alloc(ngx_pool_t *pool, size_t size)
 ngx_int_t
 ngx_thread_task_post(ngx_thread_pool_t *tp, ngx_thread_task_t *task)
 {
+    ngx_uint_t               n, i;
+    ngx_atomic_uint_t        tail;
+    ngx_thread_pool_ring_t  *ring;
+
     if (task->event.active) {
         ngx_log_error(NGX_LOG_ALERT, tp->log, 0,
                       "task #%ui already active", task->id);
         return NGX_ERROR;
     }
 
-    if (ngx_thread_mutex_lock(&tp->mtx, tp->log) != NGX_OK) {
-        return NGX_ERROR;
+    task->id = ngx_thread_pool_task_id++;
+    task->next = NULL;
+
+#if (NGX_STAT_STUB)
+    if (tp->stat) {
+        task->posted = ngx_thread_pool_usec();
     }
+#endif
 
-    if (tp->waiting >= tp->max_queue) {
-        (void) ngx_thread_mutex_unlock(&tp->mtx, tp->log);
+    /* round robin over the rings, skipping full ones */
 
-        ngx_log_error(NGX_LOG_ERR, tp->log, 0,
-                      "thread pool \"%V\" queue overflow: %i tasks waiting",
-                      &tp->name, tp->waiting);
-        return NGX_ERROR;
+    i = tp->next;
+
+    for (n = 0; n < tp->threads; n++) {
+        ring = &tp->rings[i];
+
+        if (++i == tp->threads) {
+            i = 0;
+        }
+
+        tail = ring->tail;
+
+        if (tail - ring->head > ring->mask) {
+            continue;
+        }
+
+        ring->tasks[tail & ring->mask] = task;
+
+        ngx_memory_barrier();
+
+        ring->tail = tail + 1;
+
+        goto posted;
     }
 
-    task->event.active = 1;
+#if (NGX_STAT_STUB)
+    if (tp->stat) {
+        (void) ngx_atomic_fetch_add(&tp->stat->overflows, 1);
+    }
+#endif
 
-    task->id = ngx_thread_pool_task_id++;
-    task->next = NULL;
+    ngx_log_error(NGX_LOG_ERR, tp->log, 0,
+                  "thread pool \"%V\" queue overflow: %ui tasks waiting",
+                  &tp->name, ngx_thread_pool_queued(tp));
+    return NGX_ERROR;
 
-    if (ngx_thread_cond_signal(&tp->cond, tp->log) != NGX_OK) {
-        (void) ngx_thread_mutex_unlock(&tp->mtx, tp->log);
-        return NGX_ERROR;
+posted:
+
+    tp->next = i;
+
+    task->event.active = 1;
+
+#if (NGX_STAT_STUB)
+    if (tp->stat) {
+        (void) ngx_atomic_fetch_add(&tp->stat->queued, 1);
     }
+#endif
 
-    *tp->queue.last = task;
-    tp->queue.last = &task->next;
+    /*
+     * the barrier orders the ring update before the check of sleeping
+     * threads, a thread going to sleep increments the counter before
+     * it checks the rings for the last time
+     */
 
-    tp->waiting++;
+    ngx_memory_barrier();
+
+    if (tp->sleeping) {
+        if (ngx_thread_mutex_lock(&tp->mtx, tp->log) != NGX_OK) {
+            return NGX_ERROR;
+        }
+
+        if (ngx_thread_cond_signal(&tp->cond, tp->log) != NGX_OK) {
+            (void) ngx_thread_mutex_unlock(&tp->mtx, tp->log);
+            return NGX_ERROR;
+        }
 
-    (void) ngx_thread_mutex_unlock(&tp->mtx, tp->log);
+        (void) ngx_thread_mutex_unlock(&tp->mtx, tp->log);
+    }
 
     ngx_log_debug2(NGX_LOG_DEBUG_CORE, tp->log, 0,
                    "task #%ui added to thread pool \"%V\"",
@@ -277,11 +415,18 @@ ngx_thread_task_post(ngx_thread_pool_t *tp, ngx_thread_task_t *task)
 static void *
 ngx_thread_pool_cycle(void *data)
 {
-    ngx_thread_pool_t *tp = data;
+    ngx_thread_pool_ring_t *ring = data;
 
     int                 err;
     sigset_t            set;
+    ngx_atomic_uint_t   next;
+    ngx_thread_pool_t  *tp;
     ngx_thread_task_t  *task;
+#if (NGX_STAT_STUB)
+    ngx_uint_t          start;
+#endif
+
+    tp = ring->tp;
 
 #if 0
     ngx_time_update();
@@ -304,37 +449,63 @@ ngx_thread_pool_cycle(void *data)
     }
 
     for ( ;; ) {
-        if (ngx_thread_mutex_lock(&tp->mtx, tp->log) != NGX_OK) {
-            return NULL;
+
+        task = ngx_thread_pool_take(ring);
+
+        if (task == NULL) {
+            task = ngx_thread_pool_steal(ring);
         }
 
-        /* the number may become negative */
-        tp->waiting--;
+        if (task == NULL) {
 
-        while (tp->queue.first == NULL) {
-            if (ngx_thread_cond_wait(&tp->cond, &tp->mtx, tp->log)
-                != NGX_OK)
-            {
-                (void) ngx_thread_mutex_unlock(&tp->mtx, tp->log);
+            if (ngx_thread_mutex_lock(&tp->mtx, tp->log) != NGX_OK) {
                 return NULL;
             }
-        }
 
-        task = tp->queue.first;
-        tp->queue.first = task->next;
+            (void) ngx_atomic_fetch_add(&tp->sleeping, 1);
 
-        if (tp->queue.first == NULL) {
-            tp->queue.last = &tp->queue.first;
-        }
+            for ( ;; ) {
+                task = ngx_thread_pool_take(ring);
 
-        if (ngx_thread_mutex_unlock(&tp->mtx, tp->log) != NGX_OK) {
-            return NULL;
+                if (task == NULL) {
+                    task = ngx_thread_pool_steal(ring);
+                }
+
+                if (task) {
+                    break;
+                }
+
+                if (ngx_thread_cond_wait(&tp->cond, &tp->mtx, tp->log)
+                    != NGX_OK)
+                {
+                    (void) ngx_thread_mutex_unlock(&tp->mtx, tp->log);
+                    return NULL;
+                }
+            }
+
+            (void) ngx_atomic_fetch_add(&tp->sleeping, -1);
+
+            if (ngx_thread_mutex_unlock(&tp->mtx, tp->log) != NGX_OK) {
+                return NULL;
+            }
         }
 
 #if 0
         ngx_time_update();
 #endif
 
+#if (NGX_STAT_STUB)
+        start = 0;
+
+        if (tp->stat) {
+            start = ngx_thread_pool_usec();
+
+            (void) ngx_atomic_fetch_add(&tp->stat->queued, -1);
+            (void) ngx_atomic_fetch_add(&tp->stat->wait_time,
+                                        start - task->posted);
+        }
+#endif
+
         ngx_log_debug2(NGX_LOG_DEBUG_CORE, tp->log, 0,
                        "run task #%ui in thread pool \"%V\"",
                        task->id, &tp->name);
@@ -345,39 +516,135 @@ ngx_thread_pool_cycle(void *data)
                        "complete task #%ui in thread pool \"%V\"",
                        task->id, &tp->name);
 
-        task->next = NULL;
+#if (NGX_STAT_STUB)
+        if (tp->stat) {
+            (void) ngx_atomic_fetch_add(&tp->stat->tasks, 1);
+            (void) ngx_atomic_fetch_add(&tp->stat->run_time,
+                                        ngx_thread_pool_usec() - start);
+        }
+#endif
+
+        /*
+         * only the thread which pushes a task onto the empty stack
+         * notifies the event loop, which then takes all completed tasks
+         */
 
-        ngx_spinlock(&ngx_thread_pool_done_lock, 1, 2048);
+        do {
+            next = ngx_thread_pool_done;
+            task->next = (ngx_thread_task_t *) next;
 
-        *ngx_thread_pool_done.last = task;
-        ngx_thread_pool_done.last = &task->next;
+        } while (!ngx_atomic_cmp_set(&ngx_thread_pool_done, next,
+                                     (ngx_atomic_uint_t) task));
+
+        if (next == 0) {
+            (void) ngx_notify(ngx_thread_pool_handler);
+        }
+    }
+}
+
+
+static ngx_thread_task_t *
+ngx_thread_pool_take(ngx_thread_pool_ring_t *ring)
+{
+    ngx_atomic_uint_t   head;
+    ngx_thread_task_t  *task;
+
+    for ( ;; ) {
+        head = ring->head;
 
         ngx_memory_barrier();
 
-        ngx_unlock(&ngx_thread_pool_done_lock);
+        if (head == ring->tail) {
+            return NULL;
+        }
+
+        ngx_memory_barrier();
 
-        (void) ngx_notify(ngx_thread_pool_handler);
+        task = ring->tasks[head & ring->mask];
+
+        if (ngx_atomic_cmp_set(&ring->head, head, head + 1)) {
+            return task;
+        }
     }
 }
 
 
+static ngx_thread_task_t *
+ngx_thread_pool_steal(ngx_thread_pool_ring_t *ring)
+{
+    ngx_uint_t          n, i;
+    ngx_thread_pool_t  *tp;
+    ngx_thread_task_t  *task;
+
+    tp = ring->tp;
+    i = ring->index;
+
+    for (n = 1; n < tp->threads; n++) {
+
+        if (++i == tp->threads) {
+            i = 0;
+        }
+
+        task = ngx_thread_pool_take(&tp->rings[i]);
+
+        if (task) {
+
+#if (NGX_STAT_STUB)
+            if (tp->stat) {
+                (void) ngx_atomic_fetch_add(&tp->stat->stolen, 1);
+            }
+#endif
+
+            return task;
+        }
+    }
+
+    return NULL;
+}
+
+
+static ngx_uint_t
+ngx_thread_pool_queued(ngx_thread_pool_t *tp)
+{
+    ngx_uint_t               n, queued;
+    ngx_thread_pool_ring_t  *ring;
+
+    queued = 0;
+
+    for (n = 0; n < tp->threads; n++) {
+        ring = &tp->rings[n];
+        queued += ring->tail - ring->head;
+    }
+
+    return queued;
+}
+
+
 static void
 ngx_thread_pool_handler(ngx_event_t *ev)
 {
     ngx_event_t        *event;
-    ngx_thread_task_t  *task;
+    ngx_atomic_uint_t   done;
+    ngx_thread_task_t  *task, *next, *first;
 
     ngx_log_debug0(NGX_LOG_DEBUG_CORE, ev->log, 0, "thread pool handler");
 
-    ngx_spinlock(&ngx_thread_pool_done_lock, 1, 2048);
+    do {
+        done = ngx_thread_pool_done;
 
-    task = ngx_thread_pool_done.first;
-    ngx_thread_pool_done.first = NULL;
-    ngx_thread_pool_done.last = &ngx_thread_pool_done.first;
+    } while (done && !ngx_atomic_cmp_set(&ngx_thread_pool_done, done, 0));
 
-    ngx_memory_barrier();
+    /* the stack holds the tasks in reverse order of completion */
 
-    ngx_unlock(&ngx_thread_pool_done_lock);
+    first = NULL;
+
+    for (task = (ngx_thread_task_t *) done; task; task = next) {
+        next = task->next;
+        task->next = first;
+        first = task;
+    }
+
+    task = first;
 
     while (task) {
         ngx_log_debug1(NGX_LOG_DEBUG_CORE, ev->log, 0,
@@ -599,7 +866,7 @@ ngx_thread_pool_init_worker(ngx_cycle_t *cycle)
         return NGX_OK;
     }
 
-    ngx_thread_pool_queue_init(&ngx_thread_pool_done);
+    ngx_thread_pool_done = 0;
 
     tpp = tcf->pools.elts;
 
@@ -639,3 +906,142 @@ ngx_thread_pool_exit_worker(ngx_cycle_t *cycle)
         ngx_thread_pool_destroy(tpp[i]);
     }
 }
+
+
+#if (NGX_STAT_STUB)
+
+static ngx_int_t
+ngx_thread_pool_init_module(ngx_cycle_t *cycle)
+{
+    uint32_t                  name;
+    ngx_shm_t                 shm;
+    ngx_uint_t                i;
+    ngx_thread_pool_t       **tpp;
+    ngx_thread_pool_stat_t   *st;
+    ngx_thread_pool_conf_t   *tcf;
+
+    tcf = (ngx_thread_pool_conf_t *) ngx_get_conf(cycle->conf_ctx,
+                                                  ngx_thread_pool_module);
+
+    if (tcf == NULL || tcf->pools.nelts == 0) {
+        return NGX_OK;
+    }
+
+    if (ngx_thread_pool_stats == NULL) {
+        shm.size = NGX_THREAD_POOL_MAX_STATS * sizeof(ngx_thread_pool_stat_t);
+        ngx_str_set(&shm.name, "nginx_thread_pool_zone");
+        shm.log = cycle->log;
+
+        if (ngx_shm_alloc(&shm) != NGX_OK) {
+            return NGX_ERROR;
+        }
+
+        ngx_thread_pool_stats = (ngx_thread_pool_stat_t *) shm.addr;
+    }
+
+    /*
+     * the counters are kept across reconfiguration by the pool position,
+     * and are reset if a pool with another name takes the position
+     */
+
+    tpp = tcf->pools.elts;
+
+    for (i = 0; i < tcf->pools.nelts; i++) {
+
+        if (i >= NGX_THREAD_POOL_MAX_STATS) {
+            tpp[i]->stat = NULL;
+            continue;
+        }
+
+        st = &ngx_thread_pool_stats[i];
+
+        name = ngx_crc32_short(tpp[i]->name.data, tpp[i]->name.len);
+
+        if (st->name != name) {
+            ngx_memzero(st, sizeof(ngx_thread_pool_stat_t));
+            st->name = name;
+        }
+
+        tpp[i]->stat = st;
+    }
+
+    return NGX_OK;
+}
+
+
+static ngx_uint_t
+ngx_thread_pool_usec(void)
+{
+#if (NGX_HAVE_CLOCK_MONOTONIC)
+    struct timespec  ts;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (ngx_uint_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#else
+    struct timeval   tv;
+
+    ngx_gettimeofday(&tv);
+
+    return (ngx_uint_t) tv.tv_sec * 1000000 + tv.tv_usec;
+#endif
+}
+
+
+size_t
+ngx_thread_pool_status_size(ngx_cycle_t *cycle)
+{
+    size_t                    size;
+    ngx_uint_t                i;
+    ngx_thread_pool_t       **tpp;
+    ngx_thread_pool_conf_t   *tcf;
+
+    tcf = (ngx_thread_pool_conf_t *) ngx_get_conf(cycle->conf_ctx,
+                                                  ngx_thread_pool_module);
+
+    size = 0;
+
+    tpp = tcf->pools.elts;
+
+    for (i = 0; i < tcf->pools.nelts; i++) {
+        size += sizeof("Thread pool \"\": threads  queued  tasks  stolen  "
+                       "overflows  wait_us  run_us \n") - 1
+                + tpp[i]->name.len + NGX_INT_T_LEN + 6 * NGX_ATOMIC_T_LEN;
+    }
+
+    return size;
+}
+
+
+u_char *
+ngx_thread_pool_status(ngx_cycle_t *cycle, u_char *p)
+{
+    ngx_uint_t                i;
+    ngx_thread_pool_t       **tpp;
+    ngx_thread_pool_stat_t   *st;
+    ngx_thread_pool_conf_t   *tcf;
+
+    tcf = (ngx_thread_pool_conf_t *) ngx_get_conf(cycle->conf_ctx,
+                                                  ngx_thread_pool_module);
+
+    tpp = tcf->pools.elts;
+
+    for (i = 0; i < tcf->pools.nelts; i++) {
+        st = tpp[i]->stat;
+
+        if (st == NULL) {
+            continue;
+        }
+
+        p = ngx_sprintf(p, "Thread pool \"%V\": threads %ui queued %uA "
+                        "tasks %uA stolen %uA overflows %uA "
+                        "wait_us %uA run_us %uA \n",
+                        &tpp[i]->name, tpp[i]->threads, st->queued,
+                        st->tasks, st->stolen, st->overflows,
+                        st->wait_time, st->run_time);
+    }
+
+    return p;
+}
+
+#endif
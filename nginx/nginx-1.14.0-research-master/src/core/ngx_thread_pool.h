@@ -20,6 +20,9 @@ struct ngx_thread_task_s {
     void                *ctx;
     void               (*handler)(void *data, ngx_log_t *log);
     ngx_event_t          event;
+#if (NGX_STAT_STUB)
+    ngx_uint_t           posted;
+#endif
 };
 
 
@@ -32,5 +35,10 @@ ngx_thread_pool_t *ngx_thread_pool_get(ngx_cycle_t *cycle, ngx_str_t *name);
 ngx_thread_task_t *ngx_thread_task_alloc(ngx_pool_t *pool, size_t size);
 ngx_int_t ngx_thread_task_post(ngx_thread_pool_t *tp, ngx_thread_task_t *task);
 
+#if (NGX_STAT_STUB)
+size_t ngx_thread_pool_status_size(ngx_cycle_t *cycle);
+u_char *ngx_thread_pool_status(ngx_cycle_t *cycle, u_char *p);
+#endif
+
 
 #endif /* _NGX_THREAD_POOL_H_INCLUDED_ */
@@ -0,0 +1,1172 @@
+
+/*
+ * Copyright (C) Igor Sysoev
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+#include <ngx_config.h>
+#include <ngx_core.h>
+#include <ngx_event.h>
+
+#include <linux/io_uring.h>
+
+
+/*
+ * The module keeps the readiness model of epoll: every connection has
+ * at most one poll request in the ring, its mask is changed by cancelling
+ * the request and queueing a new one.  Edge-triggered events use multishot
+ * poll requests, level-triggered ones (the listening sockets) use oneshot
+ * requests that are queued again after each completion: a oneshot request
+ * completes at once if the socket is still ready.  Requests are only queued
+ * in the submission ring, all of them are submitted by the single
+ * io_uring_enter() which also waits for completions, so adding and deleting
+ * events costs no syscalls.  File AIO reads are queued in the same ring.
+ *
+ * user_data of a poll request is the connection index in the upper 32 bits
+ * and a generation in bits 8-31; the generation of the live request is kept
+ * in c->read->index, so completions of cancelled or replaced requests
+ * are recognized as stale.  The generation counter is global, it wraps
+ * after 16M requests.
+ */
+
+#define NGX_IO_URING_POLL        0
+#define NGX_IO_URING_AIO         1
+#define NGX_IO_URING_IGNORE      2
+#define NGX_IO_URING_TYPE_MASK   3
+
+#define NGX_IO_URING_GEN_MASK    0xffffff
+#define NGX_IO_URING_NOTIFY      0xffffffff
+
+#define ngx_io_uring_key(idx, gen)                                          \
+    (((uint64_t) (idx) << 32) | ((uint64_t) (gen) << 8) | NGX_IO_URING_POLL)
+
+
+typedef struct {
+    ngx_uint_t  entries;
+} ngx_io_uring_conf_t;
+
+
+typedef struct {
+    unsigned                 *head;
+    unsigned                 *tail;
+    unsigned                  mask;
+    unsigned                  entries;
+    unsigned                  local_tail;
+    struct io_uring_sqe      *sqes;
+} ngx_io_uring_sq_t;
+
+
+typedef struct {
+    unsigned                 *head;
+    unsigned                 *tail;
+    unsigned                  mask;
+    struct io_uring_cqe      *cqes;
+} ngx_io_uring_cq_t;
+
+
+static ngx_int_t ngx_io_uring_init(ngx_cycle_t *cycle, ngx_msec_t timer);
+static ngx_int_t ngx_io_uring_setup(ngx_cycle_t *cycle,
+    ngx_io_uring_conf_t *iucf);
+#if (NGX_HAVE_EVENTFD)
+static ngx_int_t ngx_io_uring_notify_init(ngx_log_t *log);
+static void ngx_io_uring_notify_handler(ngx_event_t *ev);
+#endif
+static void ngx_io_uring_done(ngx_cycle_t *cycle);
+static ngx_int_t ngx_io_uring_add_event(ngx_event_t *ev, ngx_int_t event,
+    ngx_uint_t flags);
+static ngx_int_t ngx_io_uring_del_event(ngx_event_t *ev, ngx_int_t event,
+    ngx_uint_t flags);
+static ngx_int_t ngx_io_uring_add_connection(ngx_connection_t *c);
+static ngx_int_t ngx_io_uring_del_connection(ngx_connection_t *c,
+    ngx_uint_t flags);
+#if (NGX_HAVE_EVENTFD)
+static ngx_int_t ngx_io_uring_notify(ngx_event_handler_pt handler);
+#endif
+static ngx_int_t ngx_io_uring_process_events(ngx_cycle_t *cycle,
+    ngx_msec_t timer, ngx_uint_t flags);
+
+static struct io_uring_sqe *ngx_io_uring_get_sqe(ngx_log_t *log);
+static ngx_int_t ngx_io_uring_submit(ngx_log_t *log);
+static int ngx_io_uring_enter(unsigned to_submit, unsigned min_complete,
+    unsigned flags, struct io_uring_getevents_arg *arg);
+static ngx_int_t ngx_io_uring_poll(ngx_connection_t *c, uint32_t events,
+    ngx_log_t *log);
+static ngx_int_t ngx_io_uring_cancel(ngx_connection_t *c, ngx_log_t *log);
+static void ngx_io_uring_poll_event(ngx_cycle_t *cycle,
+    struct io_uring_cqe *cqe, ngx_uint_t flags);
+
+static void *ngx_io_uring_create_conf(ngx_cycle_t *cycle);
+static char *ngx_io_uring_init_conf(ngx_cycle_t *cycle, void *conf);
+
+static int                  ring_fd = -1;
+static int                  ring_enter_fd = -1;
+static unsigned             ring_enter_flags;
+static void                *ring_sq_ptr;
+static size_t               ring_sq_size;
+static void                *ring_cq_ptr;
+static size_t               ring_cq_size;
+static size_t               ring_sqes_size;
+static ngx_io_uring_sq_t    sq;
+static ngx_io_uring_cq_t    cq;
+static uint32_t             generation;
+
+#if (NGX_HAVE_EVENTFD)
+static int                  notify_fd = -1;
+static ngx_event_t          notify_event;
+static ngx_event_t          notify_wevent;
+static ngx_connection_t     notify_conn;
+static ngx_uint_t           notify_count;
+#endif
+
+#if (NGX_HAVE_FILE_AIO)
+ngx_uint_t                  ngx_io_uring_file_aio;
+#endif
+
+static ngx_str_t      io_uring_name = ngx_string("io_uring");
+
+static ngx_command_t  ngx_io_uring_commands[] = {
+
+    { ngx_string("io_uring_entries"),
+      NGX_EVENT_CONF|NGX_CONF_TAKE1,
+      ngx_conf_set_num_slot,
+      0,
+      offsetof(ngx_io_uring_conf_t, entries),
+      NULL },
+
+      ngx_null_command
+};
+
+
+static ngx_event_module_t  ngx_io_uring_module_ctx = {
+    &io_uring_name,
+    ngx_io_uring_create_conf,            /* create configuration */
+    ngx_io_uring_init_conf,              /* init configuration */
+
+    {
+        ngx_io_uring_add_event,          /* add an event */
+        ngx_io_uring_del_event,          /* delete an event */
+        ngx_io_uring_add_event,          /* enable an event */
+        ngx_io_uring_del_event,          /* disable an event */
+        ngx_io_uring_add_connection,     /* add an connection */
+        ngx_io_uring_del_connection,     /* delete an connection */
+#if (NGX_HAVE_EVENTFD)
+        ngx_io_uring_notify,             /* trigger a notify */
+#else
+        NULL,                            /* trigger a notify */
+#endif
+        ngx_io_uring_process_events,     /* process the events */
+        ngx_io_uring_init,               /* init the events */
+        ngx_io_uring_done,               /* done the events */
+    }
+};
+
+ngx_module_t  ngx_io_uring_module = {
+    NGX_MODULE_V1,
+    &ngx_io_uring_module_ctx,            /* module context */
+    ngx_io_uring_commands,               /* module directives */
+    NGX_EVENT_MODULE,                    /* module type */
+    NULL,                                /* init master */
+    NULL,                                /* init module */
+    NULL,                                /* init process */
+    NULL,                                /* init thread */
+    NULL,                                /* exit thread */
+    NULL,                                /* exit process */
+    NULL,                                /* exit master */
+    NGX_MODULE_V1_PADDING
+};
+
+
+/*
+ * We call io_uring_setup(), io_uring_enter() and io_uring_register()
+ * directly as syscalls, liburing is not required.
+ */
+
+static int
+io_uring_setup(unsigned entries, struct io_uring_params *p)
+{
+    return syscall(SYS_io_uring_setup, entries, p);
+}
+
+
+static int
+io_uring_register(unsigned opcode, void *arg, unsigned nr_args)
+{
+    return syscall(SYS_io_uring_register, ring_fd, opcode, arg, nr_args);
+}
+
+
+static ngx_int_t
+ngx_io_uring_init(ngx_cycle_t *cycle, ngx_msec_t timer)
+{
+    ngx_io_uring_conf_t  *iucf;
+
+    iucf = ngx_event_get_conf(cycle->conf_ctx, ngx_io_uring_module);
+
+    if (ring_fd == -1) {
+        if (ngx_io_uring_setup(cycle, iucf) != NGX_OK) {
+            return NGX_ERROR;
+        }
+
+#if (NGX_HAVE_EVENTFD)
+        if (ngx_io_uring_notify_init(cycle->log) != NGX_OK) {
+            ngx_io_uring_module_ctx.actions.notify = NULL;
+        }
+#endif
+
+#if (NGX_HAVE_FILE_AIO)
+        ngx_io_uring_file_aio = ngx_file_aio;
+#endif
+    }
+
+#if (NGX_HAVE_EPOLLRDHUP)
+    /* POLLRDHUP is always reported by the kernels that have io_uring */
+    ngx_use_epoll_rdhup = 1;
+#endif
+
+    ngx_io = ngx_os_io;
+
+    ngx_event_actions = ngx_io_uring_module_ctx.actions;
+
+    /*
+     * the poll requests follow the epoll semantics, so the code
+     * that depends on NGX_USE_EPOLL_EVENT works unchanged
+     */
+
+    ngx_event_flags = NGX_USE_CLEAR_EVENT
+                      |NGX_USE_GREEDY_EVENT
+                      |NGX_USE_EPOLL_EVENT;
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_io_uring_setup(ngx_cycle_t *cycle, ngx_io_uring_conf_t *iucf)
+{
+    unsigned                      i, *array;
+    struct io_uring_params        p;
+#if (NGX_HAVE_IO_URING_SINGLE_ISSUER)
+    struct io_uring_rsrc_update   reg;
+#endif
+
+    ngx_memzero(&p, sizeof(struct io_uring_params));
+
+    /* the connection events should not be lost in a full completion ring */
+
+    p.flags = IORING_SETUP_CQSIZE;
+    p.cq_entries = iucf->entries * 4;
+
+#if (NGX_HAVE_IO_URING_SINGLE_ISSUER)
+    /* only the worker thread submits, the thread pools use the notify fd */
+    p.flags |= IORING_SETUP_SUBMIT_ALL
+               |IORING_SETUP_COOP_TASKRUN
+               |IORING_SETUP_SINGLE_ISSUER;
+#endif
+
+    ring_fd = io_uring_setup(iucf->entries, &p);
+
+#if (NGX_HAVE_IO_URING_SINGLE_ISSUER)
+    if (ring_fd == -1 && ngx_errno == NGX_EINVAL) {
+        p.flags = IORING_SETUP_CQSIZE;
+        ring_fd = io_uring_setup(iucf->entries, &p);
+    }
+#endif
+
+    if (ring_fd == -1) {
+        ngx_log_error(NGX_LOG_EMERG, cycle->log, ngx_errno,
+                      "io_uring_setup(%ui) failed", iucf->entries);
+        return NGX_ERROR;
+    }
+
+    if (!(p.features & IORING_FEAT_NODROP)
+        || !(p.features & IORING_FEAT_EXT_ARG))
+    {
+        ngx_log_error(NGX_LOG_EMERG, cycle->log, 0,
+                      "io_uring features %08XD are not supported, "
+                      "Linux 5.11 or later is required", p.features);
+        goto failed;
+    }
+
+    ring_sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    ring_cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        ring_sq_size = ngx_max(ring_sq_size, ring_cq_size);
+        ring_cq_size = ring_sq_size;
+    }
+
+    ring_sq_ptr = mmap(NULL, ring_sq_size, PROT_READ|PROT_WRITE,
+                       MAP_SHARED|MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+
+    if (ring_sq_ptr == MAP_FAILED) {
+        ngx_log_error(NGX_LOG_EMERG, cycle->log, ngx_errno,
+                      "mmap(IORING_OFF_SQ_RING) failed");
+        ring_sq_ptr = NULL;
+        goto failed;
+    }
+
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        ring_cq_ptr = ring_sq_ptr;
+
+    } else {
+        ring_cq_ptr = mmap(NULL, ring_cq_size, PROT_READ|PROT_WRITE,
+                           MAP_SHARED|MAP_POPULATE, ring_fd,
+                           IORING_OFF_CQ_RING);
+
+        if (ring_cq_ptr == MAP_FAILED) {
+            ngx_log_error(NGX_LOG_EMERG, cycle->log, ngx_errno,
+                          "mmap(IORING_OFF_CQ_RING) failed");
+            ring_cq_ptr = NULL;
+            goto failed;
+        }
+    }
+
+    ring_sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+
+    sq.sqes = mmap(NULL, ring_sqes_size, PROT_READ|PROT_WRITE,
+                   MAP_SHARED|MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+
+    if (sq.sqes == MAP_FAILED) {
+        ngx_log_error(NGX_LOG_EMERG, cycle->log, ngx_errno,
+                      "mmap(IORING_OFF_SQES) failed");
+        sq.sqes = NULL;
+        goto failed;
+    }
+
+    sq.head = (unsigned *) ((u_char *) ring_sq_ptr + p.sq_off.head);
+    sq.tail = (unsigned *) ((u_char *) ring_sq_ptr + p.sq_off.tail);
+    sq.mask = *(unsigned *) ((u_char *) ring_sq_ptr + p.sq_off.ring_mask);
+    sq.entries = p.sq_entries;
+    sq.local_tail = *sq.tail;
+
+    /* the submission entries are used in order, the index array is static */
+
+    array = (unsigned *) ((u_char *) ring_sq_ptr + p.sq_off.array);
+
+    for (i = 0; i < p.sq_entries; i++) {
+        array[i] = i;
+    }
+
+    cq.head = (unsigned *) ((u_char *) ring_cq_ptr + p.cq_off.head);
+    cq.tail = (unsigned *) ((u_char *) ring_cq_ptr + p.cq_off.tail);
+    cq.mask = *(unsigned *) ((u_char *) ring_cq_ptr + p.cq_off.ring_mask);
+    cq.cqes = (struct io_uring_cqe *) ((u_char *) ring_cq_ptr
+                                       + p.cq_off.cqes);
+
+    ring_enter_fd = ring_fd;
+    ring_enter_flags = 0;
+
+#if (NGX_HAVE_IO_URING_SINGLE_ISSUER)
+
+    /* a registered ring fd saves the file lookup in every io_uring_enter() */
+
+    ngx_memzero(&reg, sizeof(struct io_uring_rsrc_update));
+    reg.offset = -1U;
+    reg.data = ring_fd;
+
+    if (io_uring_register(IORING_REGISTER_RING_FDS, &reg, 1) == 1) {
+        ring_enter_fd = reg.offset;
+        ring_enter_flags = IORING_ENTER_REGISTERED_RING;
+
+        ngx_log_debug1(NGX_LOG_DEBUG_EVENT, cycle->log, 0,
+                       "io_uring registered ring fd: %d", ring_enter_fd);
+
+    } else {
+        ngx_log_debug0(NGX_LOG_DEBUG_EVENT, cycle->log, ngx_errno,
+                       "io_uring ring fd is not registered");
+    }
+
+#endif
+
+    ngx_log_debug4(NGX_LOG_DEBUG_EVENT, cycle->log, 0,
+                   "io_uring: fd:%d sq:%ud cq:%ud features:%08XD",
+                   ring_fd, p.sq_entries, p.cq_entries, p.features);
+
+    return NGX_OK;
+
+failed:
+
+    ngx_io_uring_done(cycle);
+
+    return NGX_ERROR;
+}
+
+
+#if (NGX_HAVE_EVENTFD)
+
+static ngx_int_t
+ngx_io_uring_notify_init(ngx_log_t *log)
+{
+#if (NGX_HAVE_SYS_EVENTFD_H)
+    notify_fd = eventfd(0, 0);
+#else
+    notify_fd = syscall(SYS_eventfd, 0);
+#endif
+
+    if (notify_fd == -1) {
+        ngx_log_error(NGX_LOG_EMERG, log, ngx_errno, "eventfd() failed");
+        return NGX_ERROR;
+    }
+
+    ngx_log_debug1(NGX_LOG_DEBUG_EVENT, log, 0,
+                   "notify eventfd: %d", notify_fd);
+
+    notify_event.handler = ngx_io_uring_notify_handler;
+    notify_event.log = log;
+    notify_event.active = 1;
+    notify_wevent.log = log;
+
+    notify_conn.fd = notify_fd;
+    notify_conn.read = &notify_event;
+    notify_conn.write = &notify_wevent;
+    notify_conn.log = log;
+
+    if (ngx_io_uring_poll(&notify_conn, EPOLLIN|EPOLLET, log) != NGX_OK) {
+
+        if (close(notify_fd) == -1) {
+            ngx_log_error(NGX_LOG_ALERT, log, ngx_errno,
+                                "eventfd close() failed");
+        }
+
+        notify_fd = -1;
+
+        return NGX_ERROR;
+    }
+
+    return NGX_OK;
+}
+
+
+static void
+ngx_io_uring_notify_handler(ngx_event_t *ev)
+{
+    ssize_t               n;
+    uint64_t              count;
+    ngx_err_t             err;
+    ngx_event_handler_pt  handler;
+
+    if (++notify_count == NGX_MAX_UINT32_VALUE) {
+        notify_count = 0;
+
+        n = read(notify_fd, &count, sizeof(uint64_t));
+
+        err = ngx_errno;
+
+        ngx_log_debug3(NGX_LOG_DEBUG_EVENT, ev->log, 0,
+                       "read() eventfd %d: %z count:%uL", notify_fd, n, count);
+
+        if ((size_t) n != sizeof(uint64_t)) {
+            ngx_log_error(NGX_LOG_ALERT, ev->log, err,
+                          "read() eventfd %d failed", notify_fd);
+        }
+    }
+
+    handler = ev->data;
+    handler(ev);
+}
+
+#endif
+
+
+static void
+ngx_io_uring_done(ngx_cycle_t *cycle)
+{
+    if (sq.sqes) {
+        if (munmap(sq.sqes, ring_sqes_size) == -1) {
+            ngx_log_error(NGX_LOG_ALERT, cycle->log, ngx_errno,
+                          "munmap(IORING_OFF_SQES) failed");
+        }
+
+        sq.sqes = NULL;
+    }
+
+    if (ring_cq_ptr && ring_cq_ptr != ring_sq_ptr) {
+        if (munmap(ring_cq_ptr, ring_cq_size) == -1) {
+            ngx_log_error(NGX_LOG_ALERT, cycle->log, ngx_errno,
+                          "munmap(IORING_OFF_CQ_RING) failed");
+        }
+    }
+
+    ring_cq_ptr = NULL;
+
+    if (ring_sq_ptr) {
+        if (munmap(ring_sq_ptr, ring_sq_size) == -1) {
+            ngx_log_error(NGX_LOG_ALERT, cycle->log, ngx_errno,
+                          "munmap(IORING_OFF_SQ_RING) failed");
+        }
+
+        ring_sq_ptr = NULL;
+    }
+
+    if (ring_fd != -1 && close(ring_fd) == -1) {
+        ngx_log_error(NGX_LOG_ALERT, cycle->log, ngx_errno,
+                      "io_uring close() failed");
+    }
+
+    ring_fd = -1;
+    ring_enter_fd = -1;
+    ring_enter_flags = 0;
+
+#if (NGX_HAVE_EVENTFD)
+
+    if (notify_fd != -1 && close(notify_fd) == -1) {
+        ngx_log_error(NGX_LOG_ALERT, cycle->log, ngx_errno,
+                      "eventfd close() failed");
+    }
+
+    notify_fd = -1;
+
+#endif
+
+#if (NGX_HAVE_FILE_AIO)
+    ngx_io_uring_file_aio = 0;
+#endif
+}
+
+
+static ngx_int_t
+ngx_io_uring_add_event(ngx_event_t *ev, ngx_int_t event, ngx_uint_t flags)
+{
+    uint32_t           events, prev;
+    ngx_event_t       *e;
+    ngx_connection_t  *c;
+
+    c = ev->data;
+
+    if (event == NGX_READ_EVENT) {
+        e = c->write;
+        prev = EPOLLOUT;
+        events = EPOLLIN|EPOLLRDHUP;
+
+    } else {
+        e = c->read;
+        prev = EPOLLIN|EPOLLRDHUP;
+        events = EPOLLOUT;
+    }
+
+    if (e->active) {
+        events |= prev;
+
+        if (ngx_io_uring_cancel(c, ev->log) != NGX_OK) {
+            return NGX_ERROR;
+        }
+    }
+
+    /*
+     * exclusive wakeups are not used: a multishot poll request
+     * is not woken up exclusively
+     */
+
+    events |= (uint32_t) flags & EPOLLET;
+
+    ngx_log_debug3(NGX_LOG_DEBUG_EVENT, ev->log, 0,
+                   "io_uring add event: fd:%d mod:%d ev:%08XD",
+                   c->fd, e->active, events);
+
+    if (ngx_io_uring_poll(c, events, ev->log) != NGX_OK) {
+        return NGX_ERROR;
+    }
+
+    ev->active = 1;
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_io_uring_del_event(ngx_event_t *ev, ngx_int_t event, ngx_uint_t flags)
+{
+    uint32_t           prev;
+    ngx_event_t       *e;
+    ngx_connection_t  *c;
+
+    c = ev->data;
+
+    if (event == NGX_READ_EVENT) {
+        e = c->write;
+        prev = EPOLLOUT;
+
+    } else {
+        e = c->read;
+        prev = EPOLLIN|EPOLLRDHUP;
+    }
+
+    /*
+     * unlike epoll, a poll request keeps a reference to the file,
+     * so it is cancelled even if the descriptor is going to be closed
+     */
+
+    ngx_log_debug3(NGX_LOG_DEBUG_EVENT, ev->log, 0,
+                   "io_uring del event: fd:%d mod:%d ev:%08XD",
+                   c->fd, e->active, e->active ? prev : 0);
+
+    if (ev->active || e->active) {
+        if (ngx_io_uring_cancel(c, ev->log) != NGX_OK) {
+            return NGX_ERROR;
+        }
+    }
+
+    ev->active = 0;
+
+    if (e->active && !(flags & NGX_CLOSE_EVENT)) {
+        if (ngx_io_uring_poll(c, prev | (c->write->index & EPOLLET), ev->log)
+            != NGX_OK)
+        {
+            return NGX_ERROR;
+        }
+    }
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_io_uring_add_connection(ngx_connection_t *c)
+{
+    uint32_t  events;
+
+    events = EPOLLIN|EPOLLOUT|EPOLLET|EPOLLRDHUP;
+
+    ngx_log_debug2(NGX_LOG_DEBUG_EVENT, c->log, 0,
+                   "io_uring add connection: fd:%d ev:%08XD", c->fd, events);
+
+    if (c->read->active || c->write->active) {
+        if (ngx_io_uring_cancel(c, c->log) != NGX_OK) {
+            return NGX_ERROR;
+        }
+    }
+
+    if (ngx_io_uring_poll(c, events, c->log) != NGX_OK) {
+        return NGX_ERROR;
+    }
+
+    c->read->active = 1;
+    c->write->active = 1;
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_io_uring_del_connection(ngx_connection_t *c, ngx_uint_t flags)
+{
+    ngx_log_debug1(NGX_LOG_DEBUG_EVENT, c->log, 0,
+                   "io_uring del connection: fd:%d", c->fd);
+
+    if (c->read->active || c->write->active) {
+        if (ngx_io_uring_cancel(c, c->log) != NGX_OK) {
+            return NGX_ERROR;
+        }
+    }
+
+    c->read->active = 0;
+    c->write->active = 0;
+
+    return NGX_OK;
+}
+
+
+#if (NGX_HAVE_EVENTFD)
+
+static ngx_int_t
+ngx_io_uring_notify(ngx_event_handler_pt handler)
+{
+    static uint64_t inc = 1;
+
+    notify_event.data = handler;
+
+    if ((size_t) write(notify_fd, &inc, sizeof(uint64_t)) != sizeof(uint64_t)) {
+        ngx_log_error(NGX_LOG_ALERT, notify_event.log, ngx_errno,
+                      "write() to eventfd %d failed", notify_fd);
+        return NGX_ERROR;
+    }
+
+    return NGX_OK;
+}
+
+#endif
+
+
+static ngx_int_t
+ngx_io_uring_poll(ngx_connection_t *c, uint32_t events, ngx_log_t *log)
+{
+    uint32_t              idx;
+    struct io_uring_sqe  *sqe;
+
+    sqe = ngx_io_uring_get_sqe(log);
+    if (sqe == NULL) {
+        return NGX_ERROR;
+    }
+
+#if (NGX_HAVE_EVENTFD)
+    if (c == &notify_conn) {
+        idx = NGX_IO_URING_NOTIFY;
+
+    } else
+#endif
+    {
+        idx = (uint32_t) (c - ngx_cycle->connections);
+    }
+
+    if (++generation > NGX_IO_URING_GEN_MASK) {
+        generation = 1;
+    }
+
+    /*
+     * c->read->index and c->write->index keep the poll request state:
+     * the generation in its key and the events it waits for
+     */
+
+    c->read->index = generation;
+    c->write->index = events;
+
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = c->fd;
+    sqe->poll32_events = events & ~EPOLLET;
+    sqe->len = (events & EPOLLET) ? IORING_POLL_ADD_MULTI : 0;
+    sqe->user_data = ngx_io_uring_key(idx, generation);
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_io_uring_cancel(ngx_connection_t *c, ngx_log_t *log)
+{
+    uint32_t              idx;
+    struct io_uring_sqe  *sqe;
+
+    sqe = ngx_io_uring_get_sqe(log);
+    if (sqe == NULL) {
+        return NGX_ERROR;
+    }
+
+#if (NGX_HAVE_EVENTFD)
+    if (c == &notify_conn) {
+        idx = NGX_IO_URING_NOTIFY;
+
+    } else
+#endif
+    {
+        idx = (uint32_t) (c - ngx_cycle->connections);
+    }
+
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = ngx_io_uring_key(idx, c->read->index);
+    sqe->user_data = NGX_IO_URING_IGNORE;
+
+    /* the completions of the cancelled request are stale from now on */
+
+    c->read->index = 0;
+
+    return NGX_OK;
+}
+
+
+static struct io_uring_sqe *
+ngx_io_uring_get_sqe(ngx_log_t *log)
+{
+    unsigned              head;
+    struct io_uring_sqe  *sqe;
+
+    head = __atomic_load_n(sq.head, __ATOMIC_ACQUIRE);
+
+    if (sq.local_tail - head >= sq.entries) {
+
+        /* the submission ring is full, flush it without waiting */
+
+        if (ngx_io_uring_submit(log) != NGX_OK) {
+            return NULL;
+        }
+
+        head = __atomic_load_n(sq.head, __ATOMIC_ACQUIRE);
+
+        if (sq.local_tail - head >= sq.entries) {
+            ngx_log_error(NGX_LOG_ALERT, log, 0,
+                          "io_uring submission queue is full");
+            return NULL;
+        }
+    }
+
+    sqe = &sq.sqes[sq.local_tail & sq.mask];
+    sq.local_tail++;
+
+    ngx_memzero(sqe, sizeof(struct io_uring_sqe));
+
+    return sqe;
+}
+
+
+static ngx_int_t
+ngx_io_uring_submit(ngx_log_t *log)
+{
+    int       n;
+    unsigned  pending;
+
+    __atomic_store_n(sq.tail, sq.local_tail, __ATOMIC_RELEASE);
+
+    pending = sq.local_tail - __atomic_load_n(sq.head, __ATOMIC_ACQUIRE);
+
+    if (pending == 0) {
+        return NGX_OK;
+    }
+
+    n = ngx_io_uring_enter(pending, 0, 0, NULL);
+
+    ngx_log_debug2(NGX_LOG_DEBUG_EVENT, log, 0,
+                   "io_uring submit: %ud of %ud", n, pending);
+
+    if (n == -1 && ngx_errno != NGX_EAGAIN && ngx_errno != NGX_EBUSY
+        && ngx_errno != NGX_EINTR)
+    {
+        ngx_log_error(NGX_LOG_ALERT, log, ngx_errno,
+                      "io_uring_enter() failed");
+        return NGX_ERROR;
+    }
+
+    return NGX_OK;
+}
+
+
+static int
+ngx_io_uring_enter(unsigned to_submit, unsigned min_complete, unsigned flags,
+    struct io_uring_getevents_arg *arg)
+{
+    flags |= ring_enter_flags;
+
+    if (arg) {
+        flags |= IORING_ENTER_EXT_ARG;
+    }
+
+    return syscall(SYS_io_uring_enter, ring_enter_fd, to_submit, min_complete,
+                   flags, arg, arg ? sizeof(struct io_uring_getevents_arg) : 0);
+}
+
+
+#if (NGX_HAVE_FILE_AIO)
+
+ngx_int_t
+ngx_io_uring_read_file(ngx_event_t *ev, ngx_fd_t fd, u_char *buf,
+    size_t size, off_t offset)
+{
+    struct io_uring_sqe  *sqe;
+
+    sqe = ngx_io_uring_get_sqe(ev->log);
+    if (sqe == NULL) {
+        return NGX_ERROR;
+    }
+
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t) (uintptr_t) buf;
+    sqe->len = (uint32_t) size;
+    sqe->off = (uint64_t) offset;
+    sqe->user_data = (uint64_t) (uintptr_t) ev | NGX_IO_URING_AIO;
+
+    return NGX_OK;
+}
+
+#endif
+
+
+static ngx_int_t
+ngx_io_uring_process_events(ngx_cycle_t *cycle, ngx_msec_t timer,
+    ngx_uint_t flags)
+{
+    int                            n;
+    unsigned                       head, tail, pending, wait;
+    ngx_err_t                      err;
+    ngx_uint_t                     level;
+    struct __kernel_timespec       ts;
+    struct io_uring_cqe            cqe;
+#if (NGX_HAVE_FILE_AIO)
+    ngx_event_t                   *e;
+    ngx_event_aio_t               *aio;
+#endif
+    struct io_uring_getevents_arg  arg;
+
+    ngx_log_debug1(NGX_LOG_DEBUG_EVENT, cycle->log, 0,
+                   "io_uring timer: %M", timer);
+
+    __atomic_store_n(sq.tail, sq.local_tail, __ATOMIC_RELEASE);
+
+    pending = sq.local_tail - __atomic_load_n(sq.head, __ATOMIC_ACQUIRE);
+
+    head = *cq.head;
+    tail = __atomic_load_n(cq.tail, __ATOMIC_ACQUIRE);
+
+    /* do not wait if completions are already there */
+
+    wait = (head == tail && timer != 0) ? 1 : 0;
+
+    err = 0;
+
+    if (pending || wait) {
+
+        ngx_memzero(&arg, sizeof(struct io_uring_getevents_arg));
+
+        if (wait && timer != NGX_TIMER_INFINITE) {
+            ts.tv_sec = timer / 1000;
+            ts.tv_nsec = (timer % 1000) * 1000000;
+            arg.ts = (uint64_t) (uintptr_t) &ts;
+        }
+
+        n = ngx_io_uring_enter(pending, wait, wait ? IORING_ENTER_GETEVENTS : 0,
+                               &arg);
+
+        err = (n == -1) ? ngx_errno : 0;
+
+        ngx_log_debug2(NGX_LOG_DEBUG_EVENT, cycle->log, 0,
+                       "io_uring_enter: %d of %ud", n, pending);
+    }
+
+    if (flags & NGX_UPDATE_TIME || ngx_event_timer_alarm) {
+        ngx_time_update();
+    }
+
+    if (err) {
+        if (err == NGX_EINTR) {
+
+            if (ngx_event_timer_alarm) {
+                ngx_event_timer_alarm = 0;
+                return NGX_OK;
+            }
+
+            level = NGX_LOG_INFO;
+
+        } else if (err == ETIME || err == NGX_EAGAIN
+                   || err == NGX_EBUSY)
+        {
+            /*
+             * ETIME is the timeout, EAGAIN and EBUSY mean that
+             * the completion ring should be drained first
+             */
+
+            level = 0;
+
+        } else {
+            level = NGX_LOG_ALERT;
+        }
+
+        if (level) {
+            ngx_log_error(level, cycle->log, err, "io_uring_enter() failed");
+            return NGX_ERROR;
+        }
+    }
+
+    tail = __atomic_load_n(cq.tail, __ATOMIC_ACQUIRE);
+
+    for ( /* void */ ; head != tail; head++) {
+
+        cqe = cq.cqes[head & cq.mask];
+
+        switch (cqe.user_data & NGX_IO_URING_TYPE_MASK) {
+
+        case NGX_IO_URING_POLL:
+            ngx_io_uring_poll_event(cycle, &cqe, flags);
+            break;
+
+#if (NGX_HAVE_FILE_AIO)
+
+        case NGX_IO_URING_AIO:
+
+            e = (ngx_event_t *) (uintptr_t)
+                                 (cqe.user_data & ~NGX_IO_URING_TYPE_MASK);
+
+            ngx_log_debug2(NGX_LOG_DEBUG_EVENT, cycle->log, 0,
+                           "io_uring aio: %p res:%d", e, cqe.res);
+
+            e->complete = 1;
+            e->active = 0;
+            e->ready = 1;
+
+            aio = e->data;
+            aio->res = cqe.res;
+
+            ngx_post_event(e, &ngx_posted_events);
+            break;
+
+#endif
+
+        default: /* NGX_IO_URING_IGNORE */
+
+            if (cqe.res < 0 && cqe.res != -ENOENT && cqe.res != -EALREADY) {
+                ngx_log_error(NGX_LOG_ALERT, cycle->log, -cqe.res,
+                              "io_uring poll remove failed");
+            }
+
+            break;
+        }
+    }
+
+    __atomic_store_n(cq.head, head, __ATOMIC_RELEASE);
+
+    return NGX_OK;
+}
+
+
+static void
+ngx_io_uring_poll_event(ngx_cycle_t *cycle, struct io_uring_cqe *cqe,
+    ngx_uint_t flags)
+{
+    uint32_t           idx, gen, revents;
+    ngx_uint_t         instance;
+    ngx_event_t       *rev, *wev;
+    ngx_queue_t       *queue;
+    ngx_connection_t  *c;
+
+    idx = (uint32_t) (cqe->user_data >> 32);
+    gen = (uint32_t) (cqe->user_data >> 8) & NGX_IO_URING_GEN_MASK;
+
+#if (NGX_HAVE_EVENTFD)
+    if (idx == NGX_IO_URING_NOTIFY) {
+        c = &notify_conn;
+
+    } else
+#endif
+    {
+        c = &ngx_cycle->connections[idx];
+    }
+
+    rev = c->read;
+
+    if (c->fd == -1 || rev->index != gen) {
+
+        /*
+         * the stale event from a cancelled poll request
+         * or from a file descriptor that was closed
+         */
+
+        ngx_log_debug2(NGX_LOG_DEBUG_EVENT, cycle->log, 0,
+                       "io_uring: stale event %p res:%d", c, cqe->res);
+        return;
+    }
+
+    instance = rev->instance;
+
+    if (!(cqe->flags & IORING_CQE_F_MORE) && cqe->res >= 0) {
+
+        /*
+         * a oneshot request has completed or a multishot request
+         * was terminated by the kernel, for example, when the completion
+         * ring overflowed, so it is queued again; a failed request
+         * is reported as an error and is not queued
+         */
+
+        ngx_log_debug2(NGX_LOG_DEBUG_EVENT, cycle->log, 0,
+                       "io_uring: poll ended fd:%d res:%d", c->fd, cqe->res);
+
+        if (ngx_io_uring_poll(c, (uint32_t) c->write->index, cycle->log)
+            != NGX_OK)
+        {
+            cqe->res = -EIO;
+        }
+    }
+
+    if (cqe->res < 0) {
+        ngx_log_debug2(NGX_LOG_DEBUG_EVENT, cycle->log, -cqe->res,
+                       "io_uring poll error on fd:%d res:%d",
+                       c->fd, cqe->res);
+
+        revents = EPOLLERR;
+
+    } else {
+        revents = (uint32_t) cqe->res;
+    }
+
+    ngx_log_debug2(NGX_LOG_DEBUG_EVENT, cycle->log, 0,
+                   "io_uring: fd:%d ev:%04XD", c->fd, revents);
+
+    if (revents & (EPOLLERR|EPOLLHUP)) {
+        ngx_log_debug2(NGX_LOG_DEBUG_EVENT, cycle->log, 0,
+                       "io_uring error on fd:%d ev:%04XD", c->fd, revents);
+
+        /*
+         * if the error events were returned, add EPOLLIN and EPOLLOUT
+         * to handle the events at least in one active handler
+         */
+
+        revents |= EPOLLIN|EPOLLOUT;
+    }
+
+    if ((revents & EPOLLIN) && rev->active) {
+
+#if (NGX_HAVE_EPOLLRDHUP)
+        if (revents & EPOLLRDHUP) {
+            rev->pending_eof = 1;
+        }
+
+        rev->available = 1;
+#endif
+
+        rev->ready = 1;
+
+        if (flags & NGX_POST_EVENTS) {
+            queue = rev->accept ? &ngx_posted_accept_events
+                                : &ngx_posted_events;
+
+            ngx_post_event(rev, queue);
+
+        } else {
+            rev->handler(rev);
+        }
+    }
+
+    wev = c->write;
+
+    if ((revents & EPOLLOUT) && wev->active) {
+
+        if (c->fd == -1 || wev->instance != instance) {
+
+            /*
+             * the stale event from a file descriptor
+             * that was just closed in this iteration
+             */
+
+            ngx_log_debug1(NGX_LOG_DEBUG_EVENT, cycle->log, 0,
+                           "io_uring: stale event %p", c);
+            return;
+        }
+
+        wev->ready = 1;
+#if (NGX_THREADS)
+        wev->complete = 1;
+#endif
+
+        if (flags & NGX_POST_EVENTS) {
+            ngx_post_event(wev, &ngx_posted_events);
+
+        } else {
+            wev->handler(wev);
+        }
+    }
+}
+
+
+static void *
+ngx_io_uring_create_conf(ngx_cycle_t *cycle)
+{
+    ngx_io_uring_conf_t  *iucf;
+
+    iucf = ngx_palloc(cycle->pool, sizeof(ngx_io_uring_conf_t));
+    if (iucf == NULL) {
+        return NULL;
+    }
+
+    iucf->entries = NGX_CONF_UNSET;
+
+    return iucf;
+}
+
+
+static char *
+ngx_io_uring_init_conf(ngx_cycle_t *cycle, void *conf)
+{
+    ngx_io_uring_conf_t *iucf = conf;
+
+    ngx_conf_init_uint_value(iucf->entries, 1024);
+
+    return NGX_CONF_OK;
+}
@@ -154,6 +154,13 @@ static ngx_command_t  ngx_event_core_commands[] = {
       offsetof(ngx_event_conf_t, accept_mutex_delay),
       NULL },
 
+    { ngx_string("timer_wheel"),
+      NGX_EVENT_CONF|NGX_CONF_FLAG,
+      ngx_conf_set_flag_slot,
+      0,
+      offsetof(ngx_event_conf_t, timer_wheel),
+      NULL },
+
     { ngx_string("debug_connection"),
       NGX_EVENT_CONF|NGX_CONF_TAKE1,
       ngx_event_debug_connection,
@@ -604,6 +611,8 @@ ngx_event_module_init(ngx_cycle_t *cycle)
            + cl          /* ngx_stat_writing */
            + cl;         /* ngx_stat_waiting */
 
+    size += NGX_POOL_CLASSES * sizeof(ngx_pool_stat_t);   /* ngx_pool_stats */
+
 #endif
 
     /*开始着手创建共享内存，大小为size，命名为nginx_shared_zone*/
@@ -657,6 +666,7 @@ accept互斥体的作用是：避免惊群和实现worker进程的负载均衡
     ngx_stat_reading = (ngx_atomic_t *) (shared + 7 * cl);
     ngx_stat_writing = (ngx_atomic_t *) (shared + 8 * cl);
     ngx_stat_waiting = (ngx_atomic_t *) (shared + 9 * cl);
+    ngx_pool_stats = (ngx_pool_stat_t *) (shared + 10 * cl);
 
 #endif
 
@@ -719,6 +729,8 @@ ngx_event_process_init(ngx_cycle_t *cycle)
     ngx_queue_init(&ngx_posted_accept_events);
     ngx_queue_init(&ngx_posted_events);
     /*初始化计时器，此处将会创建起一颗红黑色，来维护计时器。*/
+    ngx_use_timer_wheel = ecf->timer_wheel;
+
     if (ngx_event_timer_init(cycle->log) == NGX_ERROR) {
         return NGX_ERROR;
     }
@@ -1337,6 +1349,7 @@ ngx_event_core_create_conf(ngx_cycle_t *cycle)
     ecf->multi_accept = NGX_CONF_UNSET;
     ecf->accept_mutex = NGX_CONF_UNSET;
     ecf->accept_mutex_delay = NGX_CONF_UNSET_MSEC;
+    ecf->timer_wheel = NGX_CONF_UNSET;
     ecf->name = (void *) NGX_CONF_UNSET;
 
 #if (NGX_DEBUG)
@@ -1436,6 +1449,7 @@ ngx_event_core_init_conf(ngx_cycle_t *cycle, void *conf)
     ngx_conf_init_value(ecf->multi_accept, 0);
     ngx_conf_init_value(ecf->accept_mutex, 0);
     ngx_conf_init_msec_value(ecf->accept_mutex_delay, 500);
+    ngx_conf_init_value(ecf->timer_wheel, 0);
 
     return NGX_CONF_OK;
 }
@@ -200,6 +200,12 @@ extern ngx_event_actions_t   ngx_event_actions;
 #if (NGX_HAVE_EPOLLRDHUP)
 extern ngx_uint_t            ngx_use_epoll_rdhup;
 #endif
+#if (NGX_HAVE_IO_URING && NGX_HAVE_FILE_AIO)
+extern ngx_uint_t            ngx_io_uring_file_aio;
+
+ngx_int_t ngx_io_uring_read_file(ngx_event_t *ev, ngx_fd_t fd, u_char *buf,
+    size_t size, off_t offset);
+#endif
 
 
 /*
@@ -448,6 +454,8 @@ typedef struct {
 
     ngx_msec_t    accept_mutex_delay;
 
+    ngx_flag_t    timer_wheel;
+
     u_char       *name;
 
 #if (NGX_DEBUG)
@@ -10,9 +10,58 @@
 #include <ngx_event.h>
 
 
+/*
+ * The hierarchical timer wheel: the level 0 has 256 slots of 1 millisecond,
+ * the levels 1-4 have 64 slots each of 256 ms, 16.4 s, 17.5 min and 18.6 h.
+ * A timer is linked to the slot of the lowest level that covers its delay,
+ * the timers of a higher level slot are cascaded to the lower levels when
+ * the level 0 wraps to the slot, so adding and deleting are O(1).
+ *
+ * The slots are lists of the timer rbtree nodes: node->left is the next
+ * node, node->right is the previous one and node->parent is the slot.
+ */
+
+#define NGX_TIMER_WHEEL_LEVELS    5
+#define NGX_TIMER_WHEEL_SLOTS     (256 + 4 * 64)
+#define NGX_TIMER_WHEEL_MAX       (ngx_msec_t) 0xffffffff
+#define NGX_TIMER_WHEEL_NONE      NGX_TIMER_WHEEL_SLOTS
+
+
+typedef struct {
+    ngx_msec_t           base;        /* the next millisecond to expire */
+    ngx_uint_t           count;
+    uint64_t             bitmap[NGX_TIMER_WHEEL_SLOTS / 64];
+    ngx_rbtree_node_t    slots[NGX_TIMER_WHEEL_SLOTS];
+} ngx_event_timer_wheel_t;
+
+
+static void ngx_event_timer_wheel_init(void);
+static void ngx_event_timer_wheel_link(ngx_rbtree_node_t *node);
+static void ngx_event_timer_wheel_cascade(ngx_msec_t base);
+static ngx_uint_t ngx_event_timer_wheel_next(ngx_uint_t level,
+    ngx_uint_t slot);
+static ngx_msec_t ngx_event_timer_wheel_find(void);
+static void ngx_event_timer_wheel_expire(void);
+static ngx_int_t ngx_event_timer_wheel_no_timers_left(void);
+
+
 ngx_rbtree_t              ngx_event_timer_rbtree;
 static ngx_rbtree_node_t  ngx_event_timer_sentinel;
 
+ngx_uint_t                ngx_use_timer_wheel;
+static ngx_event_timer_wheel_t  ngx_event_timer_wheel;
+
+
+/* the first slot, the number of slots and the shift of each level */
+
+static ngx_uint_t  ngx_event_timer_wheel_levels[NGX_TIMER_WHEEL_LEVELS][3] = {
+    { 0, 256, 0 },
+    { 256, 64, 8 },
+    { 320, 64, 14 },
+    { 384, 64, 20 },
+    { 448, 64, 26 }
+};
+
 /*
  * the event timer rbtree may contain the duplicate keys, however,
  * it should not be a problem, because we use the rbtree to find
@@ -25,6 +74,10 @@ ngx_event_timer_init(ngx_log_t *log)
     ngx_rbtree_init(&ngx_event_timer_rbtree, &ngx_event_timer_sentinel,
                     ngx_rbtree_insert_timer_value);
 
+    if (ngx_use_timer_wheel) {
+        ngx_event_timer_wheel_init();
+    }
+
     return NGX_OK;
 }
 
@@ -35,6 +88,10 @@ ngx_event_find_timer(void)
     ngx_msec_int_t      timer;
     ngx_rbtree_node_t  *node, *root, *sentinel;
 
+    if (ngx_use_timer_wheel) {
+        return ngx_event_timer_wheel_find();
+    }
+
     if (ngx_event_timer_rbtree.root == &ngx_event_timer_sentinel) {
         return NGX_TIMER_INFINITE;
     }
@@ -56,6 +113,11 @@ ngx_event_expire_timers(void)
     ngx_event_t        *ev;
     ngx_rbtree_node_t  *node, *root, *sentinel;
 
+    if (ngx_use_timer_wheel) {
+        ngx_event_timer_wheel_expire();
+        return;
+    }
+
     sentinel = ngx_event_timer_rbtree.sentinel;
 
     for ( ;; ) {
@@ -102,6 +164,10 @@ ngx_event_no_timers_left(void)
     ngx_event_t        *ev;
     ngx_rbtree_node_t  *node, *root, *sentinel;
 
+    if (ngx_use_timer_wheel) {
+        return ngx_event_timer_wheel_no_timers_left();
+    }
+
     sentinel = ngx_event_timer_rbtree.sentinel;
     root = ngx_event_timer_rbtree.root;
 
@@ -124,3 +190,356 @@ ngx_event_no_timers_left(void)
 
     return NGX_OK;
 }
+
+
+static void
+ngx_event_timer_wheel_init(void)
+{
+    ngx_uint_t               i;
+    ngx_event_timer_wheel_t  *w;
+
+    w = &ngx_event_timer_wheel;
+
+    w->base = ngx_current_msec;
+    w->count = 0;
+
+    ngx_memzero(w->bitmap, sizeof(w->bitmap));
+
+    for (i = 0; i < NGX_TIMER_WHEEL_SLOTS; i++) {
+        w->slots[i].left = &w->slots[i];
+        w->slots[i].right = &w->slots[i];
+    }
+}
+
+
+void
+ngx_event_timer_wheel_insert(ngx_rbtree_node_t *node)
+{
+    ngx_event_timer_wheel_link(node);
+    ngx_event_timer_wheel.count++;
+}
+
+
+void
+ngx_event_timer_wheel_delete(ngx_rbtree_node_t *node)
+{
+    ngx_uint_t          n;
+    ngx_rbtree_node_t  *slot;
+
+    node->right->left = node->left;
+    node->left->right = node->right;
+
+    slot = node->parent;
+
+    if (slot->left == slot) {
+        n = slot - ngx_event_timer_wheel.slots;
+        ngx_event_timer_wheel.bitmap[n / 64] &= ~((uint64_t) 1 << (n % 64));
+    }
+
+    ngx_event_timer_wheel.count--;
+}
+
+
+static void
+ngx_event_timer_wheel_link(ngx_rbtree_node_t *node)
+{
+    ngx_uint_t          n, level;
+    ngx_msec_t          key, delta;
+    ngx_rbtree_node_t  *slot;
+
+    key = node->key;
+
+    if ((ngx_msec_int_t) (key - ngx_event_timer_wheel.base) < 0) {
+
+        /* the expired timer runs on the next expiration */
+
+        key = ngx_event_timer_wheel.base;
+    }
+
+    delta = key - ngx_event_timer_wheel.base;
+
+    if (delta < 256) {
+        n = key & 255;
+
+    } else {
+        if (delta > NGX_TIMER_WHEEL_MAX) {
+            key = ngx_event_timer_wheel.base + NGX_TIMER_WHEEL_MAX;
+            level = NGX_TIMER_WHEEL_LEVELS - 1;
+
+        } else {
+            for (level = 1; level < NGX_TIMER_WHEEL_LEVELS - 1; level++) {
+                if (delta < (ngx_msec_t) 1 << (8 + 6 * level)) {
+                    break;
+                }
+            }
+        }
+
+        n = ngx_event_timer_wheel_levels[level][0]
+            + ((key >> ngx_event_timer_wheel_levels[level][2]) & 63);
+    }
+
+    slot = &ngx_event_timer_wheel.slots[n];
+
+    node->left = slot;
+    node->right = slot->right;
+    node->parent = slot;
+    slot->right->left = node;
+    slot->right = node;
+
+    ngx_event_timer_wheel.bitmap[n / 64] |= (uint64_t) 1 << (n % 64);
+}
+
+
+static void
+ngx_event_timer_wheel_cascade(ngx_msec_t base)
+{
+    ngx_uint_t          n, index, level;
+    ngx_rbtree_node_t  *node, *slot, list;
+
+    for (level = 1; level < NGX_TIMER_WHEEL_LEVELS; level++) {
+
+        index = (base >> ngx_event_timer_wheel_levels[level][2]) & 63;
+
+        n = ngx_event_timer_wheel_levels[level][0] + index;
+        slot = &ngx_event_timer_wheel.slots[n];
+
+        if (slot->left != slot) {
+
+            /* move the slot list aside and link the timers again */
+
+            list.left = slot->left;
+            list.right = slot->right;
+            list.left->right = &list;
+            list.right->left = &list;
+
+            slot->left = slot;
+            slot->right = slot;
+
+            ngx_event_timer_wheel.bitmap[n / 64] &= ~((uint64_t) 1 << (n % 64));
+
+            while (list.left != &list) {
+                node = list.left;
+                list.left = node->left;
+                node->left->right = &list;
+
+                ngx_event_timer_wheel_link(node);
+            }
+        }
+
+        if (index != 0) {
+            break;
+        }
+    }
+}
+
+
+/* the first non-empty slot of the level starting from the slot, cyclically */
+
+static ngx_uint_t
+ngx_event_timer_wheel_next(ngx_uint_t level, ngx_uint_t slot)
+{
+    uint64_t    word;
+    ngx_uint_t  i, n, first, size;
+
+    first = ngx_event_timer_wheel_levels[level][0];
+    size = ngx_event_timer_wheel_levels[level][1];
+
+    for (i = 0; i <= size; i += 64 - (n % 64)) {
+
+        n = (slot + i) & (size - 1);
+
+        word = ngx_event_timer_wheel.bitmap[(first + n) / 64] >> (n % 64);
+
+        if (word) {
+#if (NGX_HAVE_GCC_CTZ64)
+            n += __builtin_ctzll(word);
+#else
+            while (!(word & 1)) {
+                word >>= 1;
+                n++;
+            }
+#endif
+            return n;
+        }
+    }
+
+    return NGX_TIMER_WHEEL_NONE;
+}
+
+
+static ngx_msec_t
+ngx_event_timer_wheel_find(void)
+{
+    ngx_uint_t      level, n, i, shift;
+    ngx_msec_t      base, start, t, min;
+    ngx_msec_int_t  timer;
+
+    if (ngx_event_timer_wheel.count == 0) {
+        return NGX_TIMER_INFINITE;
+    }
+
+    base = ngx_event_timer_wheel.base;
+    min = base + NGX_TIMER_WHEEL_MAX;
+
+    /* the level 0 timers expire at the time of their slot */
+
+    i = base & 255;
+    n = ngx_event_timer_wheel_next(0, i);
+
+    if (n != NGX_TIMER_WHEEL_NONE) {
+        min = base + ((n - i) & 255);
+    }
+
+    /*
+     * the higher level timers do not expire before their slot
+     * is cascaded, that is, when the level 0 wraps to the slot
+     */
+
+    for (level = 1; level < NGX_TIMER_WHEEL_LEVELS; level++) {
+
+        n = ngx_event_timer_wheel_levels[level][0];
+
+        if (ngx_event_timer_wheel.bitmap[n / 64] == 0) {
+            continue;
+        }
+
+        shift = ngx_event_timer_wheel_levels[level][2];
+        start = (base + ((ngx_msec_t) 1 << shift) - 1) >> shift;
+
+        i = start & 63;
+        n = ngx_event_timer_wheel_next(level, i);
+
+        t = (start + ((n - i) & 63)) << shift;
+
+        if ((ngx_msec_int_t) (t - min) < 0) {
+            min = t;
+        }
+    }
+
+    timer = (ngx_msec_int_t) (min - ngx_current_msec);
+
+    return (ngx_msec_t) (timer > 0 ? timer : 0);
+}
+
+
+static void
+ngx_event_timer_wheel_expire(void)
+{
+    ngx_uint_t          i, n;
+    ngx_msec_t          base, next;
+    ngx_event_t        *ev;
+    ngx_rbtree_node_t  *node, *slot, list;
+
+    for ( ;; ) {
+
+        base = ngx_event_timer_wheel.base;
+
+        if ((ngx_msec_int_t) (base - ngx_current_msec) > 0) {
+            return;
+        }
+
+        if (ngx_event_timer_wheel.count == 0) {
+            ngx_event_timer_wheel.base = ngx_current_msec + 1;
+            return;
+        }
+
+        i = base & 255;
+
+        if (i == 0) {
+            ngx_event_timer_wheel_cascade(base);
+        }
+
+        n = ngx_event_timer_wheel_next(0, i);
+
+        if (n != i) {
+
+            /* skip the empty slots up to the next timer or the level wrap */
+
+            if (n == NGX_TIMER_WHEEL_NONE || n < i) {
+                next = (base | 255) + 1;
+
+            } else {
+                next = base + (n - i);
+            }
+
+            if ((ngx_msec_int_t) (next - ngx_current_msec) > 0) {
+                next = ngx_current_msec + 1;
+            }
+
+            ngx_event_timer_wheel.base = next;
+            continue;
+        }
+
+        /*
+         * the timers added by the handlers with an expired time
+         * will run on the next millisecond in the same loop
+         */
+
+        ngx_event_timer_wheel.base = base + 1;
+
+        slot = &ngx_event_timer_wheel.slots[i];
+
+        list.left = slot->left;
+        list.right = slot->right;
+        list.left->right = &list;
+        list.right->left = &list;
+
+        slot->left = slot;
+        slot->right = slot;
+
+        ngx_event_timer_wheel.bitmap[i / 64] &= ~((uint64_t) 1 << (i % 64));
+
+        /* a handler may delete the timers that are still in the list */
+
+        while (list.left != &list) {
+            node = list.left;
+            list.left = node->left;
+            node->left->right = &list;
+
+            ngx_event_timer_wheel.count--;
+
+            ev = (ngx_event_t *) ((char *) node - offsetof(ngx_event_t, timer));
+
+            ngx_log_debug2(NGX_LOG_DEBUG_EVENT, ev->log, 0,
+                           "event timer del: %d: %M",
+                           ngx_event_ident(ev->data), ev->timer.key);
+
+#if (NGX_DEBUG)
+            ev->timer.left = NULL;
+            ev->timer.right = NULL;
+            ev->timer.parent = NULL;
+#endif
+
+            ev->timer_set = 0;
+
+            ev->timedout = 1;
+
+            ev->handler(ev);
+        }
+    }
+}
+
+
+static ngx_int_t
+ngx_event_timer_wheel_no_timers_left(void)
+{
+    ngx_uint_t          i;
+    ngx_event_t        *ev;
+    ngx_rbtree_node_t  *node, *slot;
+
+    for (i = 0; i < NGX_TIMER_WHEEL_SLOTS; i++) {
+        slot = &ngx_event_timer_wheel.slots[i];
+
+        for (node = slot->left; node != slot; node = node->left) {
+            ev = (ngx_event_t *) ((char *) node - offsetof(ngx_event_t, timer));
+
+            if (!ev->cancelable) {
+                return NGX_AGAIN;
+            }
+        }
+    }
+
+    /* only cancelable timers left */
+
+    return NGX_OK;
+}
@@ -18,15 +18,32 @@ typedef struct {
 } ngx_http_limit_conn_node_t;
 
 
+#define NGX_HTTP_LIMIT_CONN_MAX_SHARDS  64
+
+
+/*
+ * with "shards=" the zone is split into independently locked slab pools,
+ * each with its own rbtree; a key is always looked up in the shard chosen
+ * by its hash
+ */
+
 typedef struct {
-    ngx_shm_zone_t            *shm_zone;
-    ngx_rbtree_node_t         *node;
+    ngx_rbtree_t              *rbtree;
+    ngx_slab_pool_t           *shpool;
+} ngx_http_limit_conn_shard_t;
+
+
+typedef struct {
+    ngx_shm_zone_t               *shm_zone;
+    ngx_http_limit_conn_shard_t  *shard;
+    ngx_rbtree_node_t            *node;
 } ngx_http_limit_conn_cleanup_t;
 
 
 typedef struct {
-    ngx_rbtree_t              *rbtree;
-    ngx_http_complex_value_t   key;
+    ngx_http_limit_conn_shard_t  *shards;
+    ngx_uint_t                    nshards;
+    ngx_http_complex_value_t      key;
 } ngx_http_limit_conn_ctx_t;
 
 
@@ -46,6 +63,8 @@ typedef struct {
 static ngx_rbtree_node_t *ngx_http_limit_conn_lookup(ngx_rbtree_t *rbtree,
     ngx_str_t *key, uint32_t hash);
 static void ngx_http_limit_conn_cleanup(void *data);
+static ngx_int_t ngx_http_limit_conn_init_shard(
+    ngx_http_limit_conn_shard_t *shard, ngx_slab_pool_t *shpool);
 static ngx_inline void ngx_http_limit_conn_cleanup_all(ngx_pool_t *pool);
 
 static void *ngx_http_limit_conn_create_conf(ngx_conf_t *cf);
@@ -75,7 +94,7 @@ static ngx_conf_num_bounds_t  ngx_http_limit_conn_status_bounds = {
 static ngx_command_t  ngx_http_limit_conn_commands[] = {
 
     { ngx_string("limit_conn_zone"),
-      NGX_HTTP_MAIN_CONF|NGX_CONF_TAKE2,
+      NGX_HTTP_MAIN_CONF|NGX_CONF_TAKE23,
       ngx_http_limit_conn_zone,
       0,
       0,
@@ -148,6 +167,7 @@ ngx_http_limit_conn_handler(ngx_http_request_t *r)
     ngx_rbtree_node_t              *node;
     ngx_pool_cleanup_t             *cln;
     ngx_http_limit_conn_ctx_t      *ctx;
+    ngx_http_limit_conn_shard_t    *shard;
     ngx_http_limit_conn_node_t     *lc;
     ngx_http_limit_conn_conf_t     *lccf;
     ngx_http_limit_conn_limit_t    *limits;
@@ -184,11 +204,12 @@ ngx_http_limit_conn_handler(ngx_http_request_t *r)
 
         hash = ngx_crc32_short(key.data, key.len);
 
-        shpool = (ngx_slab_pool_t *) limits[i].shm_zone->shm.addr;
+        shard = &ctx->shards[hash % ctx->nshards];
+        shpool = shard->shpool;
 
         ngx_shmtx_lock(&shpool->mutex);
         //根据KEY在RBTREE中查找节点
-        node = ngx_http_limit_conn_lookup(ctx->rbtree, &key, hash);
+        node = ngx_http_limit_conn_lookup(shard->rbtree, &key, hash);
         //若没有找到节点，说明该请求是这个KEY的第一个请求
         if (node == NULL) {
 
@@ -211,7 +232,7 @@ ngx_http_limit_conn_handler(ngx_http_request_t *r)
             lc->conn = 1;
             ngx_memcpy(lc->data, key.data, key.len);
             //将连接数初始化为1，添加到RBTREE中
-            ngx_rbtree_insert(ctx->rbtree, node);
+            ngx_rbtree_insert(shard->rbtree, node);
 
         } else {
 
@@ -247,6 +268,7 @@ ngx_http_limit_conn_handler(ngx_http_request_t *r)
         lccln = cln->data;
 
         lccln->shm_zone = limits[i].shm_zone;
+        lccln->shard = shard;
         lccln->node = node;
     }
 
@@ -341,11 +363,9 @@ ngx_http_limit_conn_cleanup(void *data)
 
     ngx_slab_pool_t             *shpool;
     ngx_rbtree_node_t           *node;
-    ngx_http_limit_conn_ctx_t   *ctx;
     ngx_http_limit_conn_node_t  *lc;
 
-    ctx = lccln->shm_zone->data;
-    shpool = (ngx_slab_pool_t *) lccln->shm_zone->shm.addr;
+    shpool = lccln->shard->shpool;
     node = lccln->node;
     lc = (ngx_http_limit_conn_node_t *) &node->color;
 
@@ -357,7 +377,7 @@ ngx_http_limit_conn_cleanup(void *data)
     lc->conn--;
 
     if (lc->conn == 0) {
-        ngx_rbtree_delete(ctx->rbtree, node);
+        ngx_rbtree_delete(lccln->shard->rbtree, node);
         ngx_slab_free_locked(shpool, node);
     }
 
@@ -387,8 +407,9 @@ ngx_http_limit_conn_init_zone(ngx_shm_zone_t *shm_zone, void *data)
     ngx_http_limit_conn_ctx_t  *octx = data;
 
     size_t                      len;
-    ngx_slab_pool_t            *shpool;
-    ngx_rbtree_node_t          *sentinel;
+    ngx_int_t                   rc;
+    ngx_uint_t                  i;
+    ngx_slab_pool_t            *shpool, **pools;
     ngx_http_limit_conn_ctx_t  *ctx;
 
     ctx = shm_zone->data;
@@ -407,7 +428,17 @@ ngx_http_limit_conn_init_zone(ngx_shm_zone_t *shm_zone, void *data)
             return NGX_ERROR;
         }
 
-        ctx->rbtree = octx->rbtree;
+        if (ctx->nshards != octx->nshards) {
+            ngx_log_error(NGX_LOG_EMERG, shm_zone->shm.log, 0,
+                          "limit_conn_zone \"%V\" uses %ui shards "
+                          "while previously it used %ui shards",
+                          &shm_zone->shm.name, ctx->nshards,
+                          octx->nshards);
+            return NGX_ERROR;
+        }
+
+        ngx_memcpy(ctx->shards, octx->shards,
+                   ctx->nshards * sizeof(ngx_http_limit_conn_shard_t));
 
         return NGX_OK;
     }
@@ -415,35 +446,91 @@ ngx_http_limit_conn_init_zone(ngx_shm_zone_t *shm_zone, void *data)
     shpool = (ngx_slab_pool_t *) shm_zone->shm.addr;
 
     if (shm_zone->shm.exists) {
-        ctx->rbtree = shpool->data;
+
+        if (ctx->nshards == 1) {
+            ctx->shards[0].rbtree = shpool->data;
+            ctx->shards[0].shpool = shpool;
+
+            return NGX_OK;
+        }
+
+        pools = shpool->data;
+
+        for (i = 0; i < ctx->nshards; i++) {
+            ctx->shards[i].rbtree = pools[i]->data;
+            ctx->shards[i].shpool = pools[i];
+        }
 
         return NGX_OK;
     }
 
-    ctx->rbtree = ngx_slab_alloc(shpool, sizeof(ngx_rbtree_t));
-    if (ctx->rbtree == NULL) {
+    len = sizeof(" in limit_conn_zone \"\"") + shm_zone->shm.name.len;
+
+    shpool->log_ctx = ngx_slab_alloc(shpool, len);
+    if (shpool->log_ctx == NULL) {
         return NGX_ERROR;
     }
 
-    shpool->data = ctx->rbtree;
+    ngx_sprintf(shpool->log_ctx, " in limit_conn_zone \"%V\"%Z",
+                &shm_zone->shm.name);
 
-    sentinel = ngx_slab_alloc(shpool, sizeof(ngx_rbtree_node_t));
-    if (sentinel == NULL) {
+    if (ctx->nshards == 1) {
+        return ngx_http_limit_conn_init_shard(&ctx->shards[0], shpool);
+    }
+
+    pools = ngx_slab_alloc(shpool, ctx->nshards * sizeof(ngx_slab_pool_t *));
+    if (pools == NULL) {
         return NGX_ERROR;
     }
 
-    ngx_rbtree_init(ctx->rbtree, sentinel,
-                    ngx_http_limit_conn_rbtree_insert_value);
+    shpool->data = pools;
 
-    len = sizeof(" in limit_conn_zone \"\"") + shm_zone->shm.name.len;
+    rc = ngx_slab_init_shards(shpool, pools, ctx->nshards);
 
-    shpool->log_ctx = ngx_slab_alloc(shpool, len);
-    if (shpool->log_ctx == NULL) {
+    if (rc == NGX_DECLINED) {
+        ngx_log_error(NGX_LOG_EMERG, shm_zone->shm.log, 0,
+                      "limit_conn_zone \"%V\" is too small for %ui shards",
+                      &shm_zone->shm.name, ctx->nshards);
         return NGX_ERROR;
     }
 
-    ngx_sprintf(shpool->log_ctx, " in limit_conn_zone \"%V\"%Z",
-                &shm_zone->shm.name);
+    if (rc != NGX_OK) {
+        return NGX_ERROR;
+    }
+
+    for (i = 0; i < ctx->nshards; i++) {
+        if (ngx_http_limit_conn_init_shard(&ctx->shards[i], pools[i])
+            != NGX_OK)
+        {
+            return NGX_ERROR;
+        }
+    }
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_limit_conn_init_shard(ngx_http_limit_conn_shard_t *shard,
+    ngx_slab_pool_t *shpool)
+{
+    ngx_rbtree_node_t  *sentinel;
+
+    shard->rbtree = ngx_slab_alloc(shpool, sizeof(ngx_rbtree_t));
+    if (shard->rbtree == NULL) {
+        return NGX_ERROR;
+    }
+
+    shard->shpool = shpool;
+    shpool->data = shard->rbtree;
+
+    sentinel = ngx_slab_alloc(shpool, sizeof(ngx_rbtree_node_t));
+    if (sentinel == NULL) {
+        return NGX_ERROR;
+    }
+
+    ngx_rbtree_init(shard->rbtree, sentinel,
+                    ngx_http_limit_conn_rbtree_insert_value);
 
     return NGX_OK;
 }
@@ -496,6 +583,7 @@ ngx_http_limit_conn_zone(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
     u_char                            *p;
     ssize_t                            size;
     ngx_str_t                         *value, name, s;
+    ngx_int_t                          shards;
     ngx_uint_t                         i;
     ngx_shm_zone_t                    *shm_zone;
     ngx_http_limit_conn_ctx_t         *ctx;
@@ -519,6 +607,7 @@ ngx_http_limit_conn_zone(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
     }
 
     size = 0;
+    shards = 1;
     name.len = 0;
 
     for (i = 2; i < cf->args->nelts; i++) {
@@ -557,6 +646,18 @@ ngx_http_limit_conn_zone(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
             continue;
         }
 
+        if (ngx_strncmp(value[i].data, "shards=", 7) == 0) {
+
+            shards = ngx_atoi(value[i].data + 7, value[i].len - 7);
+            if (shards <= 0 || shards > NGX_HTTP_LIMIT_CONN_MAX_SHARDS) {
+                ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                                   "invalid shards \"%V\"", &value[i]);
+                return NGX_CONF_ERROR;
+            }
+
+            continue;
+        }
+
         ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
                            "invalid parameter \"%V\"", &value[i]);
         return NGX_CONF_ERROR;
@@ -569,6 +670,13 @@ ngx_http_limit_conn_zone(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
         return NGX_CONF_ERROR;
     }
 
+    ctx->nshards = shards;
+    ctx->shards = ngx_pcalloc(cf->pool,
+                              shards * sizeof(ngx_http_limit_conn_shard_t));
+    if (ctx->shards == NULL) {
+        return NGX_CONF_ERROR;
+    }
+
     shm_zone = ngx_shared_memory_add(cf, &name, size,
                                      &ngx_http_limit_conn_module);
     if (shm_zone == NULL) {
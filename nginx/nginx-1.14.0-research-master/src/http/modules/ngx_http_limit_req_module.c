@@ -35,9 +35,27 @@ typedef struct {//所有客户端请求的限速处理，可以参考ngx_http_li
 } ngx_http_limit_req_shctx_t;
 
 
+#define NGX_HTTP_LIMIT_REQ_MAX_SHARDS  64
+
+
+/*
+ * with "shards=" the zone is split into independently locked slab pools,
+ * each with its own rbtree and LRU queue; a key is always looked up in
+ * the shard chosen by its hash
+ */
+
+typedef struct {
+    ngx_http_limit_req_shctx_t  *sh;
+    ngx_slab_pool_t             *shpool;
+} ngx_http_limit_req_shard_t;
+
+
 typedef struct {//创建空间和赋值见ngx_http_limit_req_init_zone
+    /* the shard of the last looked up key */
     ngx_http_limit_req_shctx_t  *sh;
     ngx_slab_pool_t             *shpool;//用来管理limit req zone的共享内存块
+    ngx_http_limit_req_shard_t  *shards;
+    ngx_uint_t                   nshards;
     /* integer value, 1 corresponds to 0.001 r/s */
     ngx_uint_t                   rate;//rate实际上扩大了1000倍，例如1r/s，则这里为1000
     ngx_http_complex_value_t     key;//limit_req_zone  $binary_remote_addr  zone=req_one:10m rate=3000r/s;中的$binary_remote_addr对应的客户端地址
@@ -68,6 +86,8 @@ static ngx_msec_t ngx_http_limit_req_account(ngx_http_limit_req_limit_t *limits,
     ngx_uint_t n, ngx_uint_t *ep, ngx_http_limit_req_limit_t **limit);
 static void ngx_http_limit_req_expire(ngx_http_limit_req_ctx_t *ctx,
     ngx_uint_t n);
+static ngx_int_t ngx_http_limit_req_init_shard(
+    ngx_http_limit_req_shard_t *shard, ngx_slab_pool_t *shpool);
 
 static void *ngx_http_limit_req_create_conf(ngx_conf_t *cf);
 static char *ngx_http_limit_req_merge_conf(ngx_conf_t *cf, void *parent,
@@ -99,7 +119,7 @@ ngx_http_limit_req_module模块可以通过定义的 键值来限制请求处理
 */
 static ngx_command_t  ngx_http_limit_req_commands[] = {
 /*
-语法:  limit_req_zone $variable zone=name:size rate=rate;
+语法:  limit_req_zone $variable zone=name:size rate=rate [shards=number];
 默认值:  —  
 上下文:  http
 设置一块共享内存限制域的参数，它可以用来保存键值的状态。 它特别保存了当前超出请求的数量。 键的值就是指定的变量（空值不会被计算）。 示例用法： 
@@ -110,7 +130,7 @@ limit_req_zone $binary_remote_addr zone=one:10m rate=1r/s;
 请求频率可以设置为每秒几次（r/s）。如果请求的频率不到每秒一次， 你可以设置每分钟几次(r/m)。比如每秒半次就是30r/m。
 */
     { ngx_string("limit_req_zone"),
-      NGX_HTTP_MAIN_CONF|NGX_CONF_TAKE3,
+      NGX_HTTP_MAIN_CONF|NGX_CONF_TAKE3|NGX_CONF_TAKE4,
       ngx_http_limit_req_zone,
       0,
       0,
@@ -200,6 +220,7 @@ ngx_http_limit_req_handler(ngx_http_request_t *r)
     ngx_uint_t                   n, excess;
     ngx_msec_t                   delay;
     ngx_http_limit_req_ctx_t    *ctx;
+    ngx_http_limit_req_shard_t  *shard;
     ngx_http_limit_req_conf_t   *lrcf;
     ngx_http_limit_req_limit_t  *limit, *limits;
 
@@ -242,6 +263,11 @@ ngx_http_limit_req_handler(ngx_http_request_t *r)
 
         hash = ngx_crc32_short(key.data, key.len);
 
+        shard = &ctx->shards[hash % ctx->nshards];
+
+        ctx->sh = shard->sh;
+        ctx->shpool = shard->shpool;
+
         ngx_shmtx_lock(&ctx->shpool->mutex);
         //查找客户端节点信息
         rc = ngx_http_limit_req_lookup(limit, hash, &key, &excess,
@@ -679,6 +705,9 @@ ngx_http_limit_req_init_zone(ngx_shm_zone_t *shm_zone, void *data)
     ngx_http_limit_req_ctx_t  *octx = data;
 
     size_t                     len;
+    ngx_int_t                  rc;
+    ngx_uint_t                 i;
+    ngx_slab_pool_t           *shpool, **pools;
     ngx_http_limit_req_ctx_t  *ctx;
 
     ctx = shm_zone->data;
@@ -697,43 +726,120 @@ ngx_http_limit_req_init_zone(ngx_shm_zone_t *shm_zone, void *data)
             return NGX_ERROR;
         }
 
+        if (ctx->nshards != octx->nshards) {
+            ngx_log_error(NGX_LOG_EMERG, shm_zone->shm.log, 0,
+                          "limit_req \"%V\" uses %ui shards "
+                          "while previously it used %ui shards",
+                          &shm_zone->shm.name, ctx->nshards,
+                          octx->nshards);
+            return NGX_ERROR;
+        }
+
+        ngx_memcpy(ctx->shards, octx->shards,
+                   ctx->nshards * sizeof(ngx_http_limit_req_shard_t));
+
         ctx->sh = octx->sh;
         ctx->shpool = octx->shpool;
 
         return NGX_OK;
     }
 
-    ctx->shpool = (ngx_slab_pool_t *) shm_zone->shm.addr;
+    shpool = (ngx_slab_pool_t *) shm_zone->shm.addr;
 
     if (shm_zone->shm.exists) {
-        ctx->sh = ctx->shpool->data;
+
+        if (ctx->nshards == 1) {
+            ctx->shards[0].sh = shpool->data;
+            ctx->shards[0].shpool = shpool;
+
+        } else {
+            pools = shpool->data;
+
+            for (i = 0; i < ctx->nshards; i++) {
+                ctx->shards[i].sh = pools[i]->data;
+                ctx->shards[i].shpool = pools[i];
+            }
+        }
+
+        ctx->sh = ctx->shards[0].sh;
+        ctx->shpool = ctx->shards[0].shpool;
 
         return NGX_OK;
     }
 
-    ctx->sh = ngx_slab_alloc(ctx->shpool, sizeof(ngx_http_limit_req_shctx_t));
-    if (ctx->sh == NULL) {
+    len = sizeof(" in limit_req zone \"\"") + shm_zone->shm.name.len;
+
+    shpool->log_ctx = ngx_slab_alloc(shpool, len);
+    if (shpool->log_ctx == NULL) {
         return NGX_ERROR;
     }
 
-    ctx->shpool->data = ctx->sh;
+    ngx_sprintf(shpool->log_ctx, " in limit_req zone \"%V\"%Z",
+                &shm_zone->shm.name);
 
-    ngx_rbtree_init(&ctx->sh->rbtree, &ctx->sh->sentinel,
-                    ngx_http_limit_req_rbtree_insert_value);
+    shpool->log_nomem = 0;
 
-    ngx_queue_init(&ctx->sh->queue);
+    if (ctx->nshards == 1) {
+        if (ngx_http_limit_req_init_shard(&ctx->shards[0], shpool)
+            != NGX_OK)
+        {
+            return NGX_ERROR;
+        }
 
-    len = sizeof(" in limit_req zone \"\"") + shm_zone->shm.name.len;
+    } else {
+        pools = ngx_slab_alloc(shpool,
+                               ctx->nshards * sizeof(ngx_slab_pool_t *));
+        if (pools == NULL) {
+            return NGX_ERROR;
+        }
 
-    ctx->shpool->log_ctx = ngx_slab_alloc(ctx->shpool, len);
-    if (ctx->shpool->log_ctx == NULL) {
+        shpool->data = pools;
+
+        rc = ngx_slab_init_shards(shpool, pools, ctx->nshards);
+
+        if (rc == NGX_DECLINED) {
+            ngx_log_error(NGX_LOG_EMERG, shm_zone->shm.log, 0,
+                          "limit_req zone \"%V\" is too small for %ui shards",
+                          &shm_zone->shm.name, ctx->nshards);
+            return NGX_ERROR;
+        }
+
+        if (rc != NGX_OK) {
+            return NGX_ERROR;
+        }
+
+        for (i = 0; i < ctx->nshards; i++) {
+            if (ngx_http_limit_req_init_shard(&ctx->shards[i], pools[i])
+                != NGX_OK)
+            {
+                return NGX_ERROR;
+            }
+        }
+    }
+
+    ctx->sh = ctx->shards[0].sh;
+    ctx->shpool = ctx->shards[0].shpool;
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_limit_req_init_shard(ngx_http_limit_req_shard_t *shard,
+    ngx_slab_pool_t *shpool)
+{
+    shard->sh = ngx_slab_alloc(shpool, sizeof(ngx_http_limit_req_shctx_t));
+    if (shard->sh == NULL) {
         return NGX_ERROR;
     }
 
-    ngx_sprintf(ctx->shpool->log_ctx, " in limit_req zone \"%V\"%Z",
-                &shm_zone->shm.name);
+    shard->shpool = shpool;
+    shpool->data = shard->sh;
 
-    ctx->shpool->log_nomem = 0;
+    ngx_rbtree_init(&shard->sh->rbtree, &shard->sh->sentinel,
+                    ngx_http_limit_req_rbtree_insert_value);
+
+    ngx_queue_init(&shard->sh->queue);
 
     return NGX_OK;
 }
@@ -794,7 +900,7 @@ ngx_http_limit_req_zone(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
     size_t                             len;
     ssize_t                            size;
     ngx_str_t                         *value, name, s;
-    ngx_int_t                          rate, scale;
+    ngx_int_t                          rate, scale, shards;
     ngx_uint_t                         i;
     ngx_shm_zone_t                    *shm_zone;
     ngx_http_limit_req_ctx_t          *ctx;
@@ -820,6 +926,7 @@ ngx_http_limit_req_zone(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
     size = 0;
     rate = 1;
     scale = 1;
+    shards = 1;
     name.len = 0;
 
     for (i = 2; i < cf->args->nelts; i++) {
@@ -882,6 +989,18 @@ ngx_http_limit_req_zone(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
             continue;
         }
 
+        if (ngx_strncmp(value[i].data, "shards=", 7) == 0) {
+
+            shards = ngx_atoi(value[i].data + 7, value[i].len - 7);
+            if (shards <= 0 || shards > NGX_HTTP_LIMIT_REQ_MAX_SHARDS) {
+                ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                                   "invalid shards \"%V\"", &value[i]);
+                return NGX_CONF_ERROR;
+            }
+
+            continue;
+        }
+
         ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
                            "invalid parameter \"%V\"", &value[i]);
         return NGX_CONF_ERROR;
@@ -896,6 +1015,13 @@ ngx_http_limit_req_zone(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
 
     ctx->rate = rate * 1000 / scale;
 
+    ctx->nshards = shards;
+    ctx->shards = ngx_pcalloc(cf->pool,
+                              shards * sizeof(ngx_http_limit_req_shard_t));
+    if (ctx->shards == NULL) {
+        return NGX_CONF_ERROR;
+    }
+
     shm_zone = ngx_shared_memory_add(cf, &name, size,
                                      &ngx_http_limit_req_module);
     if (shm_zone == NULL) {
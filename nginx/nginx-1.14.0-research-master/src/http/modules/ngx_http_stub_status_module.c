@@ -11,11 +11,14 @@
 
 
 static ngx_int_t ngx_http_stub_status_handler(ngx_http_request_t *r);
+static ngx_int_t ngx_http_pool_status_handler(ngx_http_request_t *r);
 static ngx_int_t ngx_http_stub_status_variable(ngx_http_request_t *r,
     ngx_http_variable_value_t *v, uintptr_t data);
 static ngx_int_t ngx_http_stub_status_add_variables(ngx_conf_t *cf);
 static char *ngx_http_set_stub_status(ngx_conf_t *cf, ngx_command_t *cmd,
     void *conf);
+static char *ngx_http_set_pool_status(ngx_conf_t *cf, ngx_command_t *cmd,
+    void *conf);
 
 
 static ngx_command_t  ngx_http_status_commands[] = {
@@ -27,6 +30,13 @@ static ngx_command_t  ngx_http_status_commands[] = {
       0,
       NULL },
 
+    { ngx_string("pool_status"),
+      NGX_HTTP_SRV_CONF|NGX_HTTP_LOC_CONF|NGX_CONF_NOARGS,
+      ngx_http_set_pool_status,
+      0,
+      0,
+      NULL },
+
       ngx_null_command
 };
 
@@ -118,6 +128,14 @@ ngx_http_stub_status_handler(ngx_http_request_t *r)
            + 6 + 3 * NGX_ATOMIC_T_LEN
            + sizeof("Reading:  Writing:  Waiting:  \n") + 3 * NGX_ATOMIC_T_LEN;
 
+#if (NGX_THREADS)
+    size += ngx_thread_pool_status_size((ngx_cycle_t *) ngx_cycle);
+#endif
+
+#if (NGX_HTTP_CACHE)
+    size += ngx_http_file_cache_status_size((ngx_cycle_t *) ngx_cycle);
+#endif
+
     b = ngx_create_temp_buf(r->pool, size);
     if (b == NULL) {
         return NGX_HTTP_INTERNAL_SERVER_ERROR;
@@ -144,6 +162,116 @@ ngx_http_stub_status_handler(ngx_http_request_t *r)
     b->last = ngx_sprintf(b->last, "Reading: %uA Writing: %uA Waiting: %uA \n",
                           rd, wr, wa);
 
+#if (NGX_THREADS)
+    b->last = ngx_thread_pool_status((ngx_cycle_t *) ngx_cycle, b->last);
+#endif
+
+#if (NGX_HTTP_CACHE)
+    b->last = ngx_http_file_cache_status((ngx_cycle_t *) ngx_cycle, b->last);
+#endif
+
+    r->headers_out.status = NGX_HTTP_OK;
+    r->headers_out.content_length_n = b->last - b->pos;
+
+    b->last_buf = (r == r->main) ? 1 : 0;
+    b->last_in_chain = 1;
+
+    rc = ngx_http_send_header(r);
+
+    if (rc == NGX_ERROR || rc > NGX_OK || r->header_only) {
+        return rc;
+    }
+
+    return ngx_http_output_filter(r, &out);
+}
+
+
+/*
+ * the pool statistics are collected when pools are destroyed, a line is
+ * printed for each size class of the initial pool block that was seen;
+ * the "failed" columns are the number of blocks by the value of their
+ * d.failed counter, 0 to 4 and 5 or more
+ */
+
+static ngx_int_t
+ngx_http_pool_status_handler(ngx_http_request_t *r)
+{
+    size_t            size;
+    ngx_int_t         rc;
+    ngx_buf_t        *b;
+    ngx_uint_t        i, n;
+    ngx_chain_t       out;
+    ngx_pool_stat_t  *st;
+
+    if (!(r->method & (NGX_HTTP_GET|NGX_HTTP_HEAD))) {
+        return NGX_HTTP_NOT_ALLOWED;
+    }
+
+    rc = ngx_http_discard_request_body(r);
+
+    if (rc != NGX_OK) {
+        return rc;
+    }
+
+    r->headers_out.content_type_len = sizeof("text/plain") - 1;
+    ngx_str_set(&r->headers_out.content_type, "text/plain");
+    r->headers_out.content_type_lowcase = NULL;
+
+    if (r->method == NGX_HTTP_HEAD) {
+        r->headers_out.status = NGX_HTTP_OK;
+
+        rc = ngx_http_send_header(r);
+
+        if (rc == NGX_ERROR || rc > NGX_OK || r->header_only) {
+            return rc;
+        }
+    }
+
+    size = sizeof("size pools blocks cached used wasted "
+                  "failed:0 1 2 3 4 5+ large cached\n") - 1
+           + NGX_POOL_CLASSES * (NGX_SIZE_T_LEN + sizeof(":\n") - 1
+                                 + (7 + NGX_POOL_FAILED_BINS)
+                                   * (1 + NGX_ATOMIC_T_LEN));
+
+    b = ngx_create_temp_buf(r->pool, size);
+    if (b == NULL) {
+        return NGX_HTTP_INTERNAL_SERVER_ERROR;
+    }
+
+    out.buf = b;
+    out.next = NULL;
+
+    b->last = ngx_cpymem(b->last, "size pools blocks cached used wasted "
+                         "failed:0 1 2 3 4 5+ large cached\n",
+                         sizeof("size pools blocks cached used wasted "
+                                "failed:0 1 2 3 4 5+ large cached\n") - 1);
+
+    for (i = 0; ngx_pool_stats && i < NGX_POOL_CLASSES; i++) {
+        st = &ngx_pool_stats[i];
+
+        if (st->pools == 0 && st->large == 0) {
+            continue;
+        }
+
+        if (i < NGX_POOL_CLASSES - 1) {
+            b->last = ngx_sprintf(b->last, "%uz:", ngx_pool_class_size(i));
+
+        } else {
+            b->last = ngx_cpymem(b->last, "other:", sizeof("other:") - 1);
+        }
+
+        b->last = ngx_sprintf(b->last, " %uA %uA %uA %uA %uA",
+                              st->pools, st->blocks, st->cached,
+                              st->used, st->wasted);
+
+        for (n = 0; n < NGX_POOL_FAILED_BINS; n++) {
+            b->last = ngx_sprintf(b->last, " %uA", st->failed[n]);
+        }
+
+        b->last = ngx_sprintf(b->last, " %uA %uA\n",
+                              st->large, st->large_cached);
+    }
+
     r->headers_out.status = NGX_HTTP_OK;
     r->headers_out.content_length_n = b->last - b->pos;
 
@@ -234,3 +362,15 @@ ngx_http_set_stub_status(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
 
     return NGX_CONF_OK;
 }
+
+
+static char *
+ngx_http_set_pool_status(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
+{
+    ngx_http_core_loc_conf_t  *clcf;
+
+    clcf = ngx_http_conf_get_module_loc_conf(cf, ngx_http_core_module);
+    clcf->handler = ngx_http_pool_status_handler;
+
+    return NGX_CONF_OK;
+}
@@ -54,11 +54,16 @@ static ngx_int_t ngx_http_cmp_locations(const ngx_queue_t *one,
     const ngx_queue_t *two);
 static ngx_int_t ngx_http_join_exact_locations(ngx_conf_t *cf,
     ngx_queue_t *locations);
-static void ngx_http_create_locations_list(ngx_queue_t *locations,
-    ngx_queue_t *q);
-static ngx_http_location_tree_node_t *
-    ngx_http_create_locations_tree(ngx_conf_t *cf, ngx_queue_t *locations,
-    size_t prefix);
+#if (NGX_PCRE)
+static ngx_int_t ngx_http_init_regex_prefixes(ngx_conf_t *cf,
+    ngx_http_core_loc_conf_t *pclcf, ngx_uint_t n);
+static ngx_int_t ngx_http_cmp_regex_prefixes(const void *one,
+    const void *two);
+#endif
+static ngx_int_t ngx_http_create_location_trie(ngx_conf_t *cf,
+    ngx_http_location_trie_t *node, ngx_http_location_trie_key_t *keys,
+    ngx_uint_t n, size_t depth, ngx_http_core_loc_conf_t **regex,
+    u_char *marks);
 
 // 类似stream模块，对已经整理好的监听端口数组排序
 // 调用ngx_create_listening添加到cycle的监听端口数组，只是添加，没有其他动作
@@ -895,6 +900,10 @@ ngx_http_init_locations(ngx_conf_t *cf, ngx_http_core_srv_conf_t *cscf,
         *clcfp = NULL;
 
         ngx_queue_split(locations, regex, &tail);
+
+        if (ngx_http_init_regex_prefixes(cf, pclcf, r) != NGX_OK) {
+            return NGX_ERROR;
+        }
     }
 
 #endif
@@ -907,9 +916,11 @@ static ngx_int_t
 ngx_http_init_static_location_trees(ngx_conf_t *cf,
     ngx_http_core_loc_conf_t *pclcf)
 {
-    ngx_queue_t                *q, *locations;
-    ngx_http_core_loc_conf_t   *clcf;
-    ngx_http_location_queue_t  *lq;
+    ngx_uint_t                     n;
+    ngx_queue_t                   *q, *locations;
+    ngx_http_core_loc_conf_t      *clcf;
+    ngx_http_location_queue_t     *lq;
+    ngx_http_location_trie_key_t  *keys;
 
     locations = pclcf->locations;
 
@@ -938,17 +949,115 @@ ngx_http_init_static_location_trees(ngx_conf_t *cf,
         return NGX_ERROR;
     }
 
-    ngx_http_create_locations_list(locations, ngx_queue_head(locations));
+    n = 0;
+
+    for (q = ngx_queue_head(locations);
+         q != ngx_queue_sentinel(locations);
+         q = ngx_queue_next(q))
+    {
+        n++;
+    }
+
+    keys = ngx_palloc(cf->temp_pool, n * sizeof(ngx_http_location_trie_key_t));
+    if (keys == NULL) {
+        return NGX_ERROR;
+    }
+
+    n = 0;
+
+    for (q = ngx_queue_head(locations);
+         q != ngx_queue_sentinel(locations);
+         q = ngx_queue_next(q))
+    {
+        lq = (ngx_http_location_queue_t *) q;
 
-    pclcf->static_locations = ngx_http_create_locations_tree(cf, locations, 0);
+        keys[n].name = lq->name;
+        keys[n].exact = lq->exact;
+        keys[n].inclusive = lq->inclusive;
+        keys[n].index = n;
+        n++;
+    }
+
+    pclcf->static_locations = ngx_palloc(cf->pool,
+                                         sizeof(ngx_http_location_trie_t));
     if (pclcf->static_locations == NULL) {
         return NGX_ERROR;
     }
 
-    return NGX_OK;
+    return ngx_http_create_location_trie(cf, pclcf->static_locations, keys, n,
+                                         0, NULL, NULL);
+}
+
+
+#if (NGX_PCRE)
+
+/*
+ * regex locations with a literal prefix, such as "^/api/", are put
+ * into a trie, so only the locations whose prefix matches the URI
+ * are tested, in the configuration order
+ */
+
+static ngx_int_t
+ngx_http_init_regex_prefixes(ngx_conf_t *cf, ngx_http_core_loc_conf_t *pclcf,
+    ngx_uint_t n)
+{
+    u_char                        *marks;
+    ngx_uint_t                     i;
+    ngx_http_location_trie_key_t  *keys;
+
+    keys = ngx_palloc(cf->temp_pool, n * sizeof(ngx_http_location_trie_key_t));
+    if (keys == NULL) {
+        return NGX_ERROR;
+    }
+
+    marks = ngx_pcalloc(cf->temp_pool, n);
+    if (marks == NULL) {
+        return NGX_ERROR;
+    }
+
+    for (i = 0; i < n; i++) {
+        keys[i].name = &pclcf->regex_locations[i]->regex_prefix;
+        keys[i].exact = pclcf->regex_locations[i];
+        keys[i].inclusive = NULL;
+        keys[i].index = i;
+    }
+
+    ngx_sort(keys, n, sizeof(ngx_http_location_trie_key_t),
+             ngx_http_cmp_regex_prefixes);
+
+    pclcf->regex_prefixes = ngx_palloc(cf->pool,
+                                       sizeof(ngx_http_location_trie_t));
+    if (pclcf->regex_prefixes == NULL) {
+        return NGX_ERROR;
+    }
+
+    return ngx_http_create_location_trie(cf, pclcf->regex_prefixes, keys, n, 0,
+                                         pclcf->regex_locations, marks);
 }
 
 
+static ngx_int_t
+ngx_http_cmp_regex_prefixes(const void *one, const void *two)
+{
+    ngx_int_t                      rc;
+    ngx_http_location_trie_key_t  *first, *second;
+
+    first = (ngx_http_location_trie_key_t *) one;
+    second = (ngx_http_location_trie_key_t *) two;
+
+    rc = ngx_filename_cmp(first->name->data, second->name->data,
+                          ngx_min(first->name->len, second->name->len));
+
+    if (rc != 0) {
+        return rc;
+    }
+
+    return (ngx_int_t) first->name->len - (ngx_int_t) second->name->len;
+}
+
+#endif
+
+
 // 把本location{}的配置信息加入到上一级的配置里
 // pclcf->locations是一个queue
 // in ngx_http.c
@@ -991,8 +1100,6 @@ ngx_http_add_location(ngx_conf_t *cf, ngx_queue_t **locations,
     lq->file_name = cf->conf_file->file.name.data;
     lq->line = cf->conf_file->line;
 
-    ngx_queue_init(&lq->list);
-
     ngx_queue_insert_tail(*locations, &lq->queue);
 
     return NGX_OK;
@@ -1113,140 +1220,164 @@ ngx_http_join_exact_locations(ngx_conf_t *cf, ngx_queue_t *locations)
 }
 
 
-static void
-ngx_http_create_locations_list(ngx_queue_t *locations, ngx_queue_t *q)
-{
-    u_char                     *name;
-    size_t                      len;
-    ngx_queue_t                *x, tail;
-    ngx_http_location_queue_t  *lq, *lx;
-
-    if (q == ngx_queue_last(locations)) {
-        return;
-    }
+/*
+ * the keys are sorted by name and share the first "depth" bytes; for regex
+ * locations "marks" flags the locations whose prefixes end at the node
+ * or above it, and the nodes where prefixes end get the list of these
+ * locations in the configuration order
+ */
 
-    lq = (ngx_http_location_queue_t *) q;
+static ngx_int_t
+ngx_http_create_location_trie(ngx_conf_t *cf, ngx_http_location_trie_t *node,
+    ngx_http_location_trie_key_t *keys, ngx_uint_t n, size_t depth,
+    ngx_http_core_loc_conf_t **regex, u_char *marks)
+{
+    u_char                     c, *first, *last;
+    size_t                     len, lcp;
+    ngx_uint_t                 i, k, m, nchildren;
+#if (NGX_PCRE)
+    ngx_uint_t                 j;
+    ngx_http_core_loc_conf_t **clcfp;
+#endif
 
-    if (lq->inclusive == NULL) {
-        ngx_http_create_locations_list(locations, ngx_queue_next(q));
-        return;
-    }
+    /* the first and the last keys share the prefix common to all keys */
 
-    len = lq->name->len;
-    name = lq->name->data;
+    first = keys[0].name->data;
+    last = keys[n - 1].name->data;
+    len = ngx_min(keys[0].name->len, keys[n - 1].name->len);
 
-    for (x = ngx_queue_next(q);
-         x != ngx_queue_sentinel(locations);
-         x = ngx_queue_next(x))
-    {
-        lx = (ngx_http_location_queue_t *) x;
-
-        if (len > lx->name->len
-            || ngx_filename_cmp(name, lx->name->data, len) != 0)
+    for (lcp = depth; lcp < len; lcp++) {
+        if (ngx_http_location_key(first[lcp])
+            != ngx_http_location_key(last[lcp]))
         {
             break;
         }
     }
 
-    q = ngx_queue_next(q);
+    node->name = first + depth;
+    node->len = (u_short) (lcp - depth);
 
-    if (q == x) {
-        ngx_http_create_locations_list(locations, x);
-        return;
-    }
+    node->exact = NULL;
+    node->inclusive = NULL;
+#if (NGX_PCRE)
+    node->regex = NULL;
+#endif
+    node->keys = NULL;
+    node->children = NULL;
+    node->nchildren = 0;
+    node->auto_redirect = 0;
 
-    ngx_queue_split(locations, q, &tail);
-    ngx_queue_add(&lq->list, &tail);
+    /* the keys ending at the node are sorted first */
 
-    if (x == ngx_queue_sentinel(locations)) {
-        ngx_http_create_locations_list(&lq->list, ngx_queue_head(&lq->list));
-        return;
-    }
+    for (i = 0; i < n && keys[i].name->len == lcp; i++) {
+
+#if (NGX_PCRE)
+        if (regex) {
+            marks[keys[i].index] = 1;
+            continue;
+        }
+#endif
 
-    ngx_queue_split(&lq->list, x, &tail);
-    ngx_queue_add(locations, &tail);
+        node->exact = keys[i].exact;
+        node->inclusive = keys[i].inclusive;
 
-    ngx_http_create_locations_list(&lq->list, ngx_queue_head(&lq->list));
+        node->auto_redirect = (u_char) ((node->exact
+                                         && node->exact->auto_redirect)
+                                        || (node->inclusive
+                                            && node->inclusive->auto_redirect));
+    }
 
-    ngx_http_create_locations_list(locations, x);
-}
+#if (NGX_PCRE)
 
+    if (regex && i) {
 
-/*
- * to keep cache locality for left leaf nodes, allocate nodes in following
- * order: node, left subtree, right subtree, inclusive subtree
- */
+        for (m = 0, j = 0; regex[j]; j++) {
+            m += marks[j];
+        }
 
-static ngx_http_location_tree_node_t *
-ngx_http_create_locations_tree(ngx_conf_t *cf, ngx_queue_t *locations,
-    size_t prefix)
-{
-    size_t                          len;
-    ngx_queue_t                    *q, tail;
-    ngx_http_location_queue_t      *lq;
-    ngx_http_location_tree_node_t  *node;
+        clcfp = ngx_palloc(cf->pool,
+                           (m + 1) * sizeof(ngx_http_core_loc_conf_t *));
+        if (clcfp == NULL) {
+            return NGX_ERROR;
+        }
 
-    q = ngx_queue_middle(locations);
+        node->regex = clcfp;
 
-    lq = (ngx_http_location_queue_t *) q;
-    len = lq->name->len - prefix;
+        for (j = 0; regex[j]; j++) {
+            if (marks[j]) {
+                *clcfp++ = regex[j];
+            }
+        }
 
-    node = ngx_palloc(cf->pool,
-                      offsetof(ngx_http_location_tree_node_t, name) + len);
-    if (node == NULL) {
-        return NULL;
+        *clcfp = NULL;
     }
 
-    node->left = NULL;
-    node->right = NULL;
-    node->tree = NULL;
-    node->exact = lq->exact;
-    node->inclusive = lq->inclusive;
+#endif
 
-    node->auto_redirect = (u_char) ((lq->exact && lq->exact->auto_redirect)
-                           || (lq->inclusive && lq->inclusive->auto_redirect));
+    nchildren = 0;
 
-    node->len = (u_char) len;
-    ngx_memcpy(node->name, &lq->name->data[prefix], len);
+    for (k = i; k < n; k = m) {
+        c = ngx_http_location_key(keys[k].name->data[lcp]);
 
-    ngx_queue_split(locations, q, &tail);
+        for (m = k + 1;
+             m < n && ngx_http_location_key(keys[m].name->data[lcp]) == c;
+             m++)
+        {
+            /* void */
+        }
 
-    if (ngx_queue_empty(locations)) {
-        /*
-         * ngx_queue_split() insures that if left part is empty,
-         * then right one is empty too
-         */
-        goto inclusive;
+        nchildren++;
     }
 
-    node->left = ngx_http_create_locations_tree(cf, locations, prefix);
-    if (node->left == NULL) {
-        return NULL;
-    }
+    if (nchildren) {
+        node->keys = ngx_pnalloc(cf->pool, nchildren);
+        if (node->keys == NULL) {
+            return NGX_ERROR;
+        }
 
-    ngx_queue_remove(q);
+        len = nchildren * sizeof(ngx_http_location_trie_t);
 
-    if (ngx_queue_empty(&tail)) {
-        goto inclusive;
-    }
+        node->children = ngx_palloc(cf->pool, len);
+        if (node->children == NULL) {
+            return NGX_ERROR;
+        }
 
-    node->right = ngx_http_create_locations_tree(cf, &tail, prefix);
-    if (node->right == NULL) {
-        return NULL;
-    }
+        for (k = i; k < n; k = m) {
+            c = ngx_http_location_key(keys[k].name->data[lcp]);
 
-inclusive:
+            for (m = k + 1;
+                 m < n && ngx_http_location_key(keys[m].name->data[lcp]) == c;
+                 m++)
+            {
+                /* void */
+            }
+
+            node->keys[node->nchildren] = c;
+
+            if (ngx_http_create_location_trie(cf,
+                                              &node->children[node->nchildren],
+                                              &keys[k], m - k, lcp, regex,
+                                              marks)
+                != NGX_OK)
+            {
+                return NGX_ERROR;
+            }
 
-    if (ngx_queue_empty(&lq->list)) {
-        return node;
+            node->nchildren++;
+        }
     }
 
-    node->tree = ngx_http_create_locations_tree(cf, &lq->list, prefix + len);
-    if (node->tree == NULL) {
-        return NULL;
+#if (NGX_PCRE)
+
+    if (regex) {
+        while (i--) {
+            marks[keys[i].index] = 0;
+        }
     }
 
-    return node;
+#endif
+
+    return NGX_OK;
 }
 
 
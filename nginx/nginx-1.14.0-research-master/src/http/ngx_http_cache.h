@@ -29,6 +29,20 @@
 
 #define NGX_HTTP_CACHE_VERSION       5
 
+#define NGX_HTTP_CACHE_SNAPSHOT_VERSION  2
+
+#define NGX_HTTP_CACHE_SNAPSHOT_PROMOTED  0x01
+
+#define NGX_HTTP_CACHE_LOADER_BATCH  64
+
+#define NGX_HTTP_CACHE_POLICY_LRU      0
+#define NGX_HTTP_CACHE_POLICY_SLRU     1
+#define NGX_HTTP_CACHE_POLICY_TINYLFU  2
+
+#define NGX_HTTP_CACHE_SKETCH_ROWS   4
+#define NGX_HTTP_CACHE_SKETCH_MAX    15
+#define NGX_HTTP_CACHE_SKETCH_AGING  64
+
 
 typedef struct {
     ngx_uint_t                       status;
@@ -51,7 +65,8 @@ typedef struct {
     unsigned                         updating:1;
     unsigned                         deleting:1;
     unsigned                         purged:1;
-                                     /* 10 unused bits */
+    unsigned                         promoted:1;
+                                     /* 9 unused bits */
 
     ngx_file_uniq_t                  uniq;
     time_t                           expire;
@@ -142,18 +157,69 @@ typedef struct {
 } ngx_http_file_cache_header_t;
 
 
+/*
+ * the count-min sketch of key frequencies: each row is indexed
+ * by its own 32-bit word of the md5 key, and all counters are halved
+ * after "period" additions to let old popularity fade; "aging" is
+ * the number of counters still to be halved
+ */
+
+typedef struct {
+    ngx_uint_t                       mask;
+    ngx_uint_t                       additions;
+    ngx_uint_t                       period;
+    ngx_uint_t                       aging;
+    u_char                           counters[1];
+} ngx_http_file_cache_sketch_t;
+
+
 typedef struct {
     ngx_rbtree_t                     rbtree;
     ngx_rbtree_node_t                sentinel;
     ngx_queue_t                      queue;
+    ngx_queue_t                      promoted;
     ngx_atomic_t                     cold;
     ngx_atomic_t                     loading;
     off_t                            size;
     ngx_uint_t                       count;
+    ngx_uint_t                       promoted_count;
     ngx_uint_t                       watermark;
+
+    ngx_http_file_cache_sketch_t    *sketch;
+
+    ngx_uint_t                       hits;
+    ngx_uint_t                       misses;
+    ngx_uint_t                       rejected;
+    ngx_uint_t                       evicted;
+    ngx_uint_t                       expired;
 } ngx_http_file_cache_sh_t;
 
 
+/*
+ * the snapshot of a keys zone is a header followed by
+ * the nodes from the least recently used one
+ */
+
+typedef struct {
+    uint32_t                         version;
+    uint32_t                         cache_version;
+    uint32_t                         levels;
+    uint32_t                         bsize;
+    uint64_t                         count;
+} ngx_http_file_cache_snapshot_t;
+
+
+typedef struct {
+    u_char                           key[NGX_HTTP_CACHE_KEY_LEN];
+    uint64_t                         uniq;
+    int64_t                          expire;
+    int64_t                          valid_sec;
+    uint64_t                         fs_size;
+    uint32_t                         body_start;
+    uint32_t                         flags;
+} ngx_http_file_cache_snapshot_node_t;
+
+
 struct ngx_http_file_cache_s {
     ngx_http_file_cache_sh_t        *sh;
     ngx_slab_pool_t                 *shpool;
@@ -172,6 +238,11 @@ struct ngx_http_file_cache_s {
     ngx_msec_t                       last;
     ngx_msec_t                       loader_sleep;
     ngx_msec_t                       loader_threshold;
+    ngx_uint_t                       loader_threads;
+
+    ngx_str_t                        snapshot;
+
+    ngx_uint_t                       policy;
 
     ngx_uint_t                       manager_files;
     ngx_msec_t                       manager_sleep;
@@ -184,6 +255,33 @@ struct ngx_http_file_cache_s {
 };
 
 
+#if (NGX_THREADS)
+
+typedef struct {
+    u_char                           key[NGX_HTTP_CACHE_KEY_LEN];
+    off_t                            fs_size;
+} ngx_http_file_cache_loader_file_t;
+
+
+typedef struct {
+    ngx_http_file_cache_t           *cache;
+    ngx_uint_t                       index;
+    ngx_int_t                        rc;
+
+    ngx_tree_ctx_t                   tree;
+
+    ngx_uint_t                       files;
+    ngx_msec_t                       last;
+
+    u_char                          *name;
+
+    ngx_uint_t                       nfiles;
+    ngx_http_file_cache_loader_file_t  batch[NGX_HTTP_CACHE_LOADER_BATCH];
+} ngx_http_file_cache_loader_t;
+
+#endif
+
+
 ngx_int_t ngx_http_file_cache_new(ngx_http_request_t *r);
 ngx_int_t ngx_http_file_cache_create(ngx_http_request_t *r);
 void ngx_http_file_cache_create_key(ngx_http_request_t *r);
@@ -195,6 +293,9 @@ ngx_int_t ngx_http_cache_send(ngx_http_request_t *);
 void ngx_http_file_cache_free(ngx_http_cache_t *c, ngx_temp_file_t *tf);
 time_t ngx_http_file_cache_valid(ngx_array_t *cache_valid, ngx_uint_t status);
 
+size_t ngx_http_file_cache_status_size(ngx_cycle_t *cycle);
+u_char *ngx_http_file_cache_status(ngx_cycle_t *cycle, u_char *p);
+
 char *ngx_http_file_cache_set_slot(ngx_conf_t *cf, ngx_command_t *cmd,
     void *conf);
 char *ngx_http_file_cache_valid_set_slot(ngx_conf_t *cf, ngx_command_t *cmd,
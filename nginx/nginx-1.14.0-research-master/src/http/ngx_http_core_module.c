@@ -23,7 +23,11 @@ typedef struct {
 
 static ngx_int_t ngx_http_core_find_location(ngx_http_request_t *r);
 static ngx_int_t ngx_http_core_find_static_location(ngx_http_request_t *r,
-    ngx_http_location_tree_node_t *node);
+    ngx_http_location_trie_t *node);
+#if (NGX_PCRE)
+static ngx_http_core_loc_conf_t **ngx_http_core_find_regex_locations(
+    ngx_http_request_t *r, ngx_http_location_trie_t *node);
+#endif
 
 static ngx_int_t ngx_http_core_preconfiguration(ngx_conf_t *cf);
 static ngx_int_t ngx_http_core_postconfiguration(ngx_conf_t *cf);
@@ -670,7 +674,7 @@ static ngx_command_t  ngx_http_core_commands[] = {
       NULL },
 
     { ngx_string("open_file_cache"),
-      NGX_HTTP_MAIN_CONF|NGX_HTTP_SRV_CONF|NGX_HTTP_LOC_CONF|NGX_CONF_TAKE12,
+      NGX_HTTP_MAIN_CONF|NGX_HTTP_SRV_CONF|NGX_HTTP_LOC_CONF|NGX_CONF_TAKE123,
       ngx_http_core_open_file_cache,
       NGX_HTTP_LOC_CONF_OFFSET,
       offsetof(ngx_http_core_loc_conf_t, open_file_cache),
@@ -1601,7 +1605,9 @@ ngx_http_core_find_location(ngx_http_request_t *r)
 
     if (noregex == 0 && pclcf->regex_locations) {
 
-        for (clcfp = pclcf->regex_locations; *clcfp; clcfp++) {
+        clcfp = ngx_http_core_find_regex_locations(r, pclcf->regex_prefixes);
+
+        for ( /* void */ ; clcfp && *clcfp; clcfp++) {
 
             ngx_log_debug1(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
                            "test location: ~ \"%V\"", &(*clcfp)->name);
@@ -1640,83 +1646,117 @@ ngx_http_core_find_location(ngx_http_request_t *r)
 
 static ngx_int_t
 ngx_http_core_find_static_location(ngx_http_request_t *r,
-    ngx_http_location_tree_node_t *node)
+    ngx_http_location_trie_t *node)
 {
-    u_char     *uri;
-    size_t      len, n;
-    ngx_int_t   rc, rv;
+    u_char     *uri, *key;
+    size_t      len;
+    ngx_int_t   rv;
 
     len = r->uri.len;
     uri = r->uri.data;
 
     rv = NGX_DECLINED;
 
-    for ( ;; ) {
-
-        if (node == NULL) {
-            return rv;
-        }
+    while (node) {
 
         ngx_log_debug2(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
                        "test location: \"%*s\"",
                        (size_t) node->len, node->name);
 
-        n = (len <= (size_t) node->len) ? len : node->len;
-
-        rc = ngx_filename_cmp(uri, node->name, n);
+        if (len < (size_t) node->len) {
 
-        if (rc != 0) {
-            node = (rc < 0) ? node->left : node->right;
+            if (len + 1 == (size_t) node->len && node->auto_redirect
+                && ngx_filename_cmp(uri, node->name, len) == 0)
+            {
+                r->loc_conf = (node->exact) ? node->exact->loc_conf:
+                                              node->inclusive->loc_conf;
+                return NGX_DONE;
+            }
 
-            continue;
+            return rv;
         }
 
-        if (len > (size_t) node->len) {
+        if (ngx_filename_cmp(uri, node->name, node->len) != 0) {
+            return rv;
+        }
 
-            if (node->inclusive) {
+        uri += node->len;
+        len -= node->len;
 
-                r->loc_conf = node->inclusive->loc_conf;
-                rv = NGX_AGAIN;
+        if (len == 0 && node->exact) {
+            r->loc_conf = node->exact->loc_conf;
+            return NGX_OK;
+        }
 
-                node = node->tree;
-                uri += n;
-                len -= n;
+        if (node->inclusive) {
+            r->loc_conf = node->inclusive->loc_conf;
+            rv = NGX_AGAIN;
 
-                continue;
+            if (len == 0) {
+                return rv;
             }
+        }
 
-            /* exact only */
+        /*
+         * if the URI ends here, the "/" child may be a location
+         * with auto redirect
+         */
 
-            node = node->right;
+        key = ngx_strlchr(node->keys, node->keys + node->nchildren,
+                          ngx_http_location_key(len ? *uri : '/'));
 
-            continue;
-        }
+        node = key ? &node->children[key - node->keys] : NULL;
+    }
 
-        if (len == (size_t) node->len) {
+    return rv;
+}
 
-            if (node->exact) {
-                r->loc_conf = node->exact->loc_conf;
-                return NGX_OK;
 
-            } else {
-                r->loc_conf = node->inclusive->loc_conf;
-                return NGX_AGAIN;
-            }
+#if (NGX_PCRE)
+
+static ngx_http_core_loc_conf_t **
+ngx_http_core_find_regex_locations(ngx_http_request_t *r,
+    ngx_http_location_trie_t *node)
+{
+    u_char                     *uri, *key;
+    size_t                      len;
+    ngx_http_core_loc_conf_t  **clcfp;
+
+    len = r->uri.len;
+    uri = r->uri.data;
+
+    clcfp = NULL;
+
+    while (node) {
+
+        if (len < (size_t) node->len
+            || ngx_filename_cmp(uri, node->name, node->len) != 0)
+        {
+            break;
         }
 
-        /* len < node->len */
+        uri += node->len;
+        len -= node->len;
 
-        if (len + 1 == (size_t) node->len && node->auto_redirect) {
+        if (node->regex) {
+            clcfp = node->regex;
+        }
 
-            r->loc_conf = (node->exact) ? node->exact->loc_conf:
-                                          node->inclusive->loc_conf;
-            rv = NGX_DONE;
+        if (len == 0) {
+            break;
         }
 
-        node = node->left;
+        key = ngx_strlchr(node->keys, node->keys + node->nchildren,
+                          ngx_http_location_key(*uri));
+
+        node = key ? &node->children[key - node->keys] : NULL;
     }
+
+    return clcfp;
 }
 
+#endif
+
 
 void *
 ngx_http_test_content_type(ngx_http_request_t *r, ngx_hash_t *types_hash)
@@ -3351,6 +3391,14 @@ ngx_http_core_regex_location(ngx_conf_t *cf, ngx_http_core_loc_conf_t *clcf,
         return NGX_ERROR;
     }
 
+    clcf->regex_prefix.data = ngx_pnalloc(cf->pool, regex->len);
+    if (clcf->regex_prefix.data == NULL) {
+        return NGX_ERROR;
+    }
+
+    clcf->regex_prefix.len = ngx_regex_literal_prefix(regex, rc.options,
+                                                      clcf->regex_prefix.data);
+
     clcf->name = *regex;
 
     return NGX_OK;
@@ -5004,10 +5052,11 @@ ngx_http_core_open_file_cache(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
 {
     ngx_http_core_loc_conf_t *clcf = conf;
 
-    time_t       inactive;
-    ngx_str_t   *value, s;
-    ngx_int_t    max;
-    ngx_uint_t   i;
+    time_t           inactive;
+    ngx_str_t       *value, s, name;
+    ngx_int_t        max, size;
+    ngx_uint_t       i;
+    ngx_shm_zone_t  *shm_zone;
 
     if (clcf->open_file_cache != NGX_CONF_UNSET_PTR) {
         return "is duplicate";
@@ -5017,6 +5066,7 @@ ngx_http_core_open_file_cache(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
 
     max = 0;
     inactive = 60;
+    shm_zone = NULL;
 
     for (i = 1; i < cf->args->nelts; i++) {
 
@@ -5043,6 +5093,45 @@ ngx_http_core_open_file_cache(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
             continue;
         }
 
+        if (ngx_strncmp(value[i].data, "shared=", 7) == 0) {
+
+            name.data = value[i].data + 7;
+
+            s.data = (u_char *) ngx_strchr(name.data, ':');
+
+            if (s.data == NULL || s.data == name.data) {
+                goto failed;
+            }
+
+            name.len = s.data - name.data;
+
+            s.data++;
+            s.len = value[i].data + value[i].len - s.data;
+
+            size = ngx_parse_size(&s);
+
+            if (size == NGX_ERROR) {
+                goto failed;
+            }
+
+            if (size < (ngx_int_t) (8 * ngx_pagesize)) {
+                ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                                   "open file cache zone \"%V\" is too small",
+                                   &value[i]);
+                return NGX_CONF_ERROR;
+            }
+
+            shm_zone = ngx_shared_memory_add(cf, &name, size,
+                                             &ngx_http_core_module);
+            if (shm_zone == NULL) {
+                return NGX_CONF_ERROR;
+            }
+
+            shm_zone->init = ngx_open_file_cache_init_zone;
+
+            continue;
+        }
+
         if (ngx_strcmp(value[i].data, "off") == 0) {
 
             clcf->open_file_cache = NULL;
@@ -5069,11 +5158,13 @@ ngx_http_core_open_file_cache(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
     }
 
     clcf->open_file_cache = ngx_open_file_cache_init(cf->pool, max, inactive);
-    if (clcf->open_file_cache) {
-        return NGX_CONF_OK;
+    if (clcf->open_file_cache == NULL) {
+        return NGX_CONF_ERROR;
     }
 
-    return NGX_CONF_ERROR;
+    clcf->open_file_cache->shm_zone = shm_zone;
+
+    return NGX_CONF_OK;
 }
 
 
@@ -60,7 +60,7 @@ typedef struct ngx_thread_pool_s  ngx_thread_pool_t;
 #define NGX_HTTP_SERVER_TOKENS_BUILD    2
 
 
-typedef struct ngx_http_location_tree_node_s  ngx_http_location_tree_node_t;
+typedef struct ngx_http_location_trie_s  ngx_http_location_trie_t;
 typedef struct ngx_http_core_loc_conf_s  ngx_http_core_loc_conf_t;
 
 
@@ -301,6 +301,7 @@ struct ngx_http_core_loc_conf_s {
 
 #if (NGX_PCRE)
     ngx_http_regex_t  *regex;
+    ngx_str_t     regex_prefix;  /* literal prefix of anchored regex */
 #endif
 
     unsigned      noname:1;   /* "if () {}" block or limit_except */
@@ -316,9 +317,10 @@ struct ngx_http_core_loc_conf_s {
     unsigned      gzip_disable_degradation:2;
 #endif
 
-    ngx_http_location_tree_node_t   *static_locations;
+    ngx_http_location_trie_t        *static_locations;
 #if (NGX_PCRE)
     ngx_http_core_loc_conf_t       **regex_locations;
+    ngx_http_location_trie_t        *regex_prefixes;
 #endif
 
     /* pointer to the modules' loc_conf */
@@ -446,24 +448,49 @@ typedef struct {
     ngx_str_t                       *name;
     u_char                          *file_name;
     ngx_uint_t                       line;
-    ngx_queue_t                      list;
 } ngx_http_location_queue_t;
 
 
-struct ngx_http_location_tree_node_s {
-    ngx_http_location_tree_node_t   *left;
-    ngx_http_location_tree_node_t   *right;
-    ngx_http_location_tree_node_t   *tree;
+typedef struct {
+    ngx_str_t                       *name;
+    ngx_http_core_loc_conf_t        *exact;
+    ngx_http_core_loc_conf_t        *inclusive;
+    ngx_uint_t                       index;
+} ngx_http_location_trie_key_t;
+
+
+/*
+ * a node of the compressed trie of location names: "name" is the part
+ * of the path after the parent node, the children are selected by
+ * the first byte of their names stored in "keys"
+ */
+
+struct ngx_http_location_trie_s {
+    u_char                          *name;
 
     ngx_http_core_loc_conf_t        *exact;
     ngx_http_core_loc_conf_t        *inclusive;
+#if (NGX_PCRE)
+    /* regex locations to test if the path ends at or below the node */
+    ngx_http_core_loc_conf_t       **regex;
+#endif
+
+    u_char                          *keys;
+    ngx_http_location_trie_t        *children;
 
+    u_short                          len;
+    u_short                          nchildren;
     u_char                           auto_redirect;
-    u_char                           len;
-    u_char                           name[1];
 };
 
 
+#if (NGX_HAVE_CASELESS_FILESYSTEM)
+#define ngx_http_location_key(c)  ngx_tolower(c)
+#else
+#define ngx_http_location_key(c)  (c)
+#endif
+
+
 void ngx_http_core_run_phases(ngx_http_request_t *r);
 ngx_int_t ngx_http_core_generic_phase(ngx_http_request_t *r,
     ngx_http_phase_handler_t *ph);
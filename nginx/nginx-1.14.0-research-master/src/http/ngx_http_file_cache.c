@@ -36,6 +36,17 @@ static ngx_http_file_cache_node_t *
     ngx_http_file_cache_lookup(ngx_http_file_cache_t *cache, u_char *key);
 static void ngx_http_file_cache_rbtree_insert_value(ngx_rbtree_node_t *temp,
     ngx_rbtree_node_t *node, ngx_rbtree_node_t *sentinel);
+static void ngx_http_file_cache_enqueue(ngx_http_file_cache_t *cache,
+    ngx_http_file_cache_node_t *fcn, ngx_uint_t hit);
+static void ngx_http_file_cache_demote(ngx_http_file_cache_t *cache);
+static ngx_queue_t *ngx_http_file_cache_victim(ngx_http_file_cache_t *cache);
+static ngx_queue_t *ngx_http_file_cache_oldest(ngx_http_file_cache_t *cache);
+static ngx_int_t ngx_http_file_cache_init_sketch(ngx_http_file_cache_t *cache,
+    size_t size);
+static ngx_uint_t ngx_http_file_cache_frequency(ngx_http_file_cache_t *cache,
+    u_char *key, ngx_uint_t add);
+static ngx_uint_t ngx_http_file_cache_admit(ngx_http_file_cache_t *cache,
+    ngx_uint_t frequency);
 static void ngx_http_file_cache_vary(ngx_http_request_t *r, u_char *vary,
     size_t len, u_char *hash);
 static void ngx_http_file_cache_vary_header(ngx_http_request_t *r,
@@ -58,8 +69,30 @@ static ngx_int_t ngx_http_file_cache_manage_directory(ngx_tree_ctx_t *ctx,
     ngx_str_t *path);
 static ngx_int_t ngx_http_file_cache_add_file(ngx_tree_ctx_t *ctx,
     ngx_str_t *path);
+static ngx_int_t ngx_http_file_cache_file_key(ngx_http_file_cache_t *cache,
+    ngx_tree_ctx_t *ctx, ngx_str_t *name, ngx_http_cache_t *c);
 static ngx_int_t ngx_http_file_cache_add(ngx_http_file_cache_t *cache,
     ngx_http_cache_t *c);
+static ngx_int_t ngx_http_file_cache_add_locked(ngx_http_file_cache_t *cache,
+    u_char *key, off_t fs_size, ngx_http_file_cache_node_t **node);
+#if (NGX_THREADS)
+static ngx_int_t ngx_http_file_cache_load_threads(ngx_http_file_cache_t *cache,
+    ngx_tree_ctx_t *tree);
+static void *ngx_http_file_cache_loader_thread(void *data);
+static ngx_uint_t ngx_http_file_cache_loader_owns(
+    ngx_http_file_cache_loader_t *ld, ngx_str_t *path, ngx_uint_t dir);
+static ngx_int_t ngx_http_file_cache_load_file(ngx_tree_ctx_t *ctx,
+    ngx_str_t *path);
+static ngx_int_t ngx_http_file_cache_load_directory(ngx_tree_ctx_t *ctx,
+    ngx_str_t *path);
+static ngx_int_t ngx_http_file_cache_load_special(ngx_tree_ctx_t *ctx,
+    ngx_str_t *path);
+static void ngx_http_file_cache_loader_flush(ngx_http_file_cache_loader_t *ld);
+#endif
+static void ngx_http_file_cache_load_snapshot(ngx_http_file_cache_t *cache);
+static void ngx_http_file_cache_restore(ngx_http_file_cache_t *cache,
+    ngx_http_file_cache_node_t *fcn, time_t expire, ngx_uint_t flags);
+static void ngx_http_file_cache_save(void *data);
 static ngx_int_t ngx_http_file_cache_delete_file(ngx_tree_ctx_t *ctx,
     ngx_str_t *path);
 static void ngx_http_file_cache_set_watermark(ngx_http_file_cache_t *cache);
@@ -79,6 +112,14 @@ ngx_str_t  ngx_http_cache_status[] = {
 static u_char  ngx_http_file_cache_key[] = { LF, 'K', 'E', 'Y', ':', ' ' };
 
 
+static ngx_str_t  ngx_http_file_cache_policies[] = {
+    ngx_string("lru"),
+    ngx_string("slru"),
+    ngx_string("tinylfu"),
+    ngx_null_string
+};
+
+
 static ngx_int_t
 ngx_http_file_cache_init(ngx_shm_zone_t *shm_zone, void *data)
 {
@@ -121,7 +162,7 @@ ngx_http_file_cache_init(ngx_shm_zone_t *shm_zone, void *data)
             cache->path->loader = NULL;
         }
 
-        return NGX_OK;
+        return ngx_http_file_cache_init_sketch(cache, shm_zone->shm.size);
     }
 
     cache->shpool = (ngx_slab_pool_t *) shm_zone->shm.addr;
@@ -131,7 +172,7 @@ ngx_http_file_cache_init(ngx_shm_zone_t *shm_zone, void *data)
         cache->bsize = ngx_fs_bsize(cache->path->name.data);
         cache->max_size /= cache->bsize;
 
-        return NGX_OK;
+        return ngx_http_file_cache_init_sketch(cache, shm_zone->shm.size);
     }
 
     cache->sh = ngx_slab_alloc(cache->shpool, sizeof(ngx_http_file_cache_sh_t));
@@ -145,13 +186,22 @@ ngx_http_file_cache_init(ngx_shm_zone_t *shm_zone, void *data)
                     ngx_http_file_cache_rbtree_insert_value);
 
     ngx_queue_init(&cache->sh->queue);
+    ngx_queue_init(&cache->sh->promoted);
 
     cache->sh->cold = 1;
     cache->sh->loading = 0;
     cache->sh->size = 0;
     cache->sh->count = 0;
+    cache->sh->promoted_count = 0;
     cache->sh->watermark = (ngx_uint_t) -1;
 
+    cache->sh->sketch = NULL;
+    cache->sh->hits = 0;
+    cache->sh->misses = 0;
+    cache->sh->rejected = 0;
+    cache->sh->evicted = 0;
+    cache->sh->expired = 0;
+
     cache->bsize = ngx_fs_bsize(cache->path->name.data);
 
     cache->max_size /= cache->bsize;
@@ -168,7 +218,7 @@ ngx_http_file_cache_init(ngx_shm_zone_t *shm_zone, void *data)
 
     cache->shpool->log_nomem = 0;
 
-    return NGX_OK;
+    return ngx_http_file_cache_init_sketch(cache, shm_zone->shm.size);
 }
 
 
@@ -820,14 +870,22 @@ static ngx_int_t
 ngx_http_file_cache_exists(ngx_http_file_cache_t *cache, ngx_http_cache_t *c)
 {
     ngx_int_t                    rc;
+    ngx_uint_t                   hit, frequency;
     ngx_http_file_cache_node_t  *fcn;
 
+    hit = 0;
+    frequency = 0;
+
     ngx_shmtx_lock(&cache->shpool->mutex);
 
     fcn = c->node;
 
     if (fcn == NULL) {
         fcn = ngx_http_file_cache_lookup(cache, c->key);
+
+        if (cache->policy == NGX_HTTP_CACHE_POLICY_TINYLFU) {
+            frequency = ngx_http_file_cache_frequency(cache, c->key, 1);
+        }
     }
 
     if (fcn) {
@@ -836,6 +894,8 @@ ngx_http_file_cache_exists(ngx_http_file_cache_t *cache, ngx_http_cache_t *c)
         if (c->node == NULL) {
             fcn->uses++;
             fcn->count++;
+
+            hit = fcn->exists;
         }
 
         if (fcn->error) {
@@ -913,9 +973,29 @@ renew:
 
 done:
 
+    if (c->node == NULL) {
+        if (hit) {
+            cache->sh->hits++;
+
+        } else {
+            cache->sh->misses++;
+        }
+
+        /* a response is stored only if it is admitted, as with min_uses */
+
+        if (rc != NGX_AGAIN
+            && !fcn->exists && !fcn->error
+            && cache->policy == NGX_HTTP_CACHE_POLICY_TINYLFU
+            && !ngx_http_file_cache_admit(cache, frequency))
+        {
+            cache->sh->rejected++;
+            rc = NGX_AGAIN;
+        }
+    }
+
     fcn->expire = ngx_time() + cache->inactive;
 
-    ngx_queue_insert_head(&cache->sh->queue, &fcn->queue);
+    ngx_http_file_cache_enqueue(cache, fcn, hit);
 
     c->uniq = fcn->uniq;
     c->error = fcn->error;
@@ -1052,6 +1132,236 @@ ngx_http_file_cache_rbtree_insert_value(ngx_rbtree_node_t *temp,
 }
 
 
+/*
+ * with the "slru" and "tinylfu" policies a node hit on the probation
+ * queue moves to the protected "promoted" queue, which holds at most
+ * 80% of nodes; the least recently used protected nodes fall back to
+ * the head of the probation queue, and eviction takes the probation
+ * tail first, so a single pass over cold keys cannot flush the hot ones
+ */
+
+static void
+ngx_http_file_cache_enqueue(ngx_http_file_cache_t *cache,
+    ngx_http_file_cache_node_t *fcn, ngx_uint_t hit)
+{
+    ngx_http_file_cache_sh_t  *sh;
+
+    sh = cache->sh;
+
+    if (!fcn->promoted) {
+
+        if (!hit || cache->policy == NGX_HTTP_CACHE_POLICY_LRU) {
+            ngx_queue_insert_head(&sh->queue, &fcn->queue);
+            return;
+        }
+
+        fcn->promoted = 1;
+        sh->promoted_count++;
+    }
+
+    ngx_queue_insert_head(&sh->promoted, &fcn->queue);
+
+    ngx_http_file_cache_demote(cache);
+}
+
+
+/*
+ * both queues are kept ordered by expire time for the inactive expiry,
+ * so a demoted node starts a new inactive period at the head of the
+ * probation queue; as only a hit promotes a node, an unused node is
+ * thus kept for at most twice the inactive time
+ */
+
+static void
+ngx_http_file_cache_demote(ngx_http_file_cache_t *cache)
+{
+    ngx_queue_t                 *q;
+    ngx_http_file_cache_sh_t    *sh;
+    ngx_http_file_cache_node_t  *last;
+
+    sh = cache->sh;
+
+    while (sh->promoted_count > sh->count - sh->count / 5) {
+        q = ngx_queue_last(&sh->promoted);
+        ngx_queue_remove(q);
+
+        last = ngx_queue_data(q, ngx_http_file_cache_node_t, queue);
+        last->promoted = 0;
+        last->expire = ngx_time() + cache->inactive;
+        sh->promoted_count--;
+
+        ngx_queue_insert_head(&sh->queue, q);
+    }
+}
+
+
+static ngx_queue_t *
+ngx_http_file_cache_victim(ngx_http_file_cache_t *cache)
+{
+    if (!ngx_queue_empty(&cache->sh->queue)) {
+        return ngx_queue_last(&cache->sh->queue);
+    }
+
+    if (!ngx_queue_empty(&cache->sh->promoted)) {
+        return ngx_queue_last(&cache->sh->promoted);
+    }
+
+    return NULL;
+}
+
+
+static ngx_queue_t *
+ngx_http_file_cache_oldest(ngx_http_file_cache_t *cache)
+{
+    ngx_queue_t                 *q, *p;
+    ngx_http_file_cache_node_t  *fcn, *pcn;
+
+    if (ngx_queue_empty(&cache->sh->promoted)) {
+        return ngx_http_file_cache_victim(cache);
+    }
+
+    p = ngx_queue_last(&cache->sh->promoted);
+
+    if (ngx_queue_empty(&cache->sh->queue)) {
+        return p;
+    }
+
+    q = ngx_queue_last(&cache->sh->queue);
+
+    fcn = ngx_queue_data(q, ngx_http_file_cache_node_t, queue);
+    pcn = ngx_queue_data(p, ngx_http_file_cache_node_t, queue);
+
+    return (pcn->expire < fcn->expire) ? p : q;
+}
+
+
+static ngx_int_t
+ngx_http_file_cache_init_sketch(ngx_http_file_cache_t *cache, size_t size)
+{
+    ngx_uint_t                     n, width;
+    ngx_http_file_cache_sketch_t  *sketch;
+
+    if (cache->policy != NGX_HTTP_CACHE_POLICY_TINYLFU || cache->sh->sketch) {
+        return NGX_OK;
+    }
+
+    /* about one counter per row for each node the zone can hold */
+
+    n = size / sizeof(ngx_http_file_cache_node_t);
+
+    for (width = 16; width < n; width <<= 1) { /* void */ }
+
+    sketch = ngx_slab_calloc(cache->shpool,
+                             sizeof(ngx_http_file_cache_sketch_t) - 1
+                             + NGX_HTTP_CACHE_SKETCH_ROWS * width);
+    if (sketch == NULL) {
+        return NGX_ERROR;
+    }
+
+    sketch->mask = width - 1;
+    sketch->period = 10 * width;
+
+    cache->sh->sketch = sketch;
+
+    return NGX_OK;
+}
+
+
+static ngx_uint_t
+ngx_http_file_cache_frequency(ngx_http_file_cache_t *cache, u_char *key,
+    ngx_uint_t add)
+{
+    u_char                        *p;
+    uint32_t                       hash;
+    ngx_uint_t                     i, n, min;
+    ngx_http_file_cache_sketch_t  *sketch;
+
+    sketch = cache->sh->sketch;
+    min = NGX_HTTP_CACHE_SKETCH_MAX;
+
+    for (i = 0; i < NGX_HTTP_CACHE_SKETCH_ROWS; i++) {
+        ngx_memcpy(&hash, &key[i * sizeof(uint32_t)], sizeof(uint32_t));
+
+        p = &sketch->counters[i * (sketch->mask + 1) + (hash & sketch->mask)];
+
+        if (add && *p < NGX_HTTP_CACHE_SKETCH_MAX) {
+            (*p)++;
+        }
+
+        if (*p < min) {
+            min = *p;
+        }
+    }
+
+    if (!add) {
+        return min;
+    }
+
+    /*
+     * the counters are halved in small chunks on the following additions
+     * not to hold the zone mutex for the whole sketch at once
+     */
+
+    if (sketch->aging) {
+        n = ngx_min(sketch->aging, NGX_HTTP_CACHE_SKETCH_AGING);
+        p = &sketch->counters[sketch->aging - n];
+
+        for (i = 0; i < n; i++) {
+            p[i] >>= 1;
+        }
+
+        sketch->aging -= n;
+    }
+
+    if (++sketch->additions >= sketch->period) {
+        sketch->additions /= 2;
+        sketch->aging = NGX_HTTP_CACHE_SKETCH_ROWS * (sketch->mask + 1);
+    }
+
+    return min;
+}
+
+
+/*
+ * when the cache is full, a new key is admitted only if it was
+ * requested more often than the key which would be evicted for it;
+ * the cache manager keeps the size just below the limits, so the cache
+ * is considered full above 15/16 of them
+ */
+
+static ngx_uint_t
+ngx_http_file_cache_admit(ngx_http_file_cache_t *cache, ngx_uint_t frequency)
+{
+    u_char                       key[NGX_HTTP_CACHE_KEY_LEN];
+    ngx_queue_t                 *q;
+    ngx_http_file_cache_sh_t    *sh;
+    ngx_http_file_cache_node_t  *fcn;
+
+    sh = cache->sh;
+
+    if (sh->cold
+        || (sh->size < cache->max_size - cache->max_size / 16
+            && sh->count < sh->watermark - sh->watermark / 16))
+    {
+        return 1;
+    }
+
+    q = ngx_http_file_cache_victim(cache);
+
+    if (q == NULL) {
+        return 1;
+    }
+
+    fcn = ngx_queue_data(q, ngx_http_file_cache_node_t, queue);
+
+    ngx_memcpy(key, &fcn->node.key, sizeof(ngx_rbtree_key_t));
+    ngx_memcpy(&key[sizeof(ngx_rbtree_key_t)], fcn->key,
+               NGX_HTTP_CACHE_KEY_LEN - sizeof(ngx_rbtree_key_t));
+
+    return frequency > ngx_http_file_cache_frequency(cache, key, 0);
+}
+
+
 static void
 ngx_http_file_cache_vary(ngx_http_request_t *r, u_char *vary, size_t len,
     u_char *hash)
@@ -1646,10 +1956,17 @@ ngx_http_file_cache_free(ngx_http_cache_t *c, ngx_temp_file_t *tf)
 
     } else if (!fcn->exists && fcn->count == 0 && c->min_uses == 1) {
         ngx_queue_remove(&fcn->queue);
+
+        if (fcn->promoted) {
+            cache->sh->promoted_count--;
+        }
+
         ngx_rbtree_delete(&cache->sh->rbtree, &fcn->node);
         ngx_slab_free_locked(cache->shpool, fcn);
         cache->sh->count--;
         c->node = NULL;
+
+        ngx_http_file_cache_demote(cache);
     }
 
     ngx_shmtx_unlock(&cache->shpool->mutex);
@@ -1730,13 +2047,9 @@ ngx_http_file_cache_forced_expire(ngx_http_file_cache_t *cache)
     ngx_shmtx_lock(&cache->shpool->mutex);
 
     for ( ;; ) {
-        if (ngx_queue_empty(&cache->sh->queue)) {
-            break;
-        }
+        q = ngx_http_file_cache_victim(cache);
 
-        q = ngx_queue_last(&cache->sh->queue);
-
-        if (q == sentinel) {
+        if (q == NULL || q == sentinel) {
             break;
         }
 
@@ -1749,6 +2062,7 @@ ngx_http_file_cache_forced_expire(ngx_http_file_cache_t *cache)
 
         if (fcn->count == 0) {
             ngx_http_file_cache_delete(cache, q, name);
+            cache->sh->evicted++;
             wait = 0;
             break;
         }
@@ -1766,7 +2080,7 @@ ngx_http_file_cache_forced_expire(ngx_http_file_cache_t *cache)
 
         ngx_queue_remove(q);
         fcn->expire = ngx_time() + cache->inactive;
-        ngx_queue_insert_head(&cache->sh->queue, &fcn->queue);
+        ngx_http_file_cache_enqueue(cache, fcn, 0);
 
         ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, 0,
                       "ignore long locked inactive cache entry %*s, count:%d",
@@ -1828,13 +2142,13 @@ ngx_http_file_cache_expire(ngx_http_file_cache_t *cache)
             break;
         }
 
-        if (ngx_queue_empty(&cache->sh->queue)) {
+        q = ngx_http_file_cache_oldest(cache);
+
+        if (q == NULL) {
             wait = 10;
             break;
         }
 
-        q = ngx_queue_last(&cache->sh->queue);
-
         fcn = ngx_queue_data(q, ngx_http_file_cache_node_t, queue);
 
         wait = fcn->expire - now;
@@ -1851,6 +2165,7 @@ ngx_http_file_cache_expire(ngx_http_file_cache_t *cache)
 
         if (fcn->count == 0) {
             ngx_http_file_cache_delete(cache, q, name);
+            cache->sh->expired++;
             goto next;
         }
 
@@ -1872,7 +2187,7 @@ ngx_http_file_cache_expire(ngx_http_file_cache_t *cache)
 
         ngx_queue_remove(q);
         fcn->expire = ngx_time() + cache->inactive;
-        ngx_queue_insert_head(&cache->sh->queue, &fcn->queue);
+        ngx_http_file_cache_enqueue(cache, fcn, 0);
 
         ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, 0,
                       "ignore long locked inactive cache entry %*s, count:%d",
@@ -1935,7 +2250,11 @@ ngx_http_file_cache_delete(ngx_http_file_cache_t *cache, ngx_queue_t *q,
         ngx_log_debug1(NGX_LOG_DEBUG_HTTP, ngx_cycle->log, 0,
                        "http file cache expire: \"%s\"", name);
 
-        if (ngx_delete_file(name) == NGX_FILE_ERROR) {
+        /* the file of a node loaded from a snapshot may be already gone */
+
+        if (ngx_delete_file(name) == NGX_FILE_ERROR
+            && ngx_errno != NGX_ENOENT)
+        {
             ngx_log_error(NGX_LOG_CRIT, ngx_cycle->log, ngx_errno,
                           ngx_delete_file_n " \"%s\" failed", name);
         }
@@ -1947,9 +2266,16 @@ ngx_http_file_cache_delete(ngx_http_file_cache_t *cache, ngx_queue_t *q,
 
     if (fcn->count == 0) {
         ngx_queue_remove(q);
+
+        if (fcn->promoted) {
+            cache->sh->promoted_count--;
+        }
+
         ngx_rbtree_delete(&cache->sh->rbtree, &fcn->node);
         ngx_slab_free_locked(cache->shpool, fcn);
         cache->sh->count--;
+
+        ngx_http_file_cache_demote(cache);
     }
 }
 
@@ -2034,6 +2360,7 @@ ngx_http_file_cache_loader(void *data)
 {
     ngx_http_file_cache_t  *cache = data;
 
+    ngx_int_t       rc;
     ngx_tree_ctx_t  tree;
 
     if (!cache->sh->cold || cache->sh->loading) {
@@ -2059,7 +2386,29 @@ ngx_http_file_cache_loader(void *data)
     cache->last = ngx_current_msec;
     cache->files = 0;
 
-    if (ngx_walk_tree(&tree, &cache->path->name) == NGX_ABORT) {
+    /*
+     * the snapshot makes the keys zone warm at once, while the cache
+     * stays cold until the walk below finds files missing in the snapshot
+     */
+
+    if (cache->snapshot.len) {
+        ngx_http_file_cache_load_snapshot(cache);
+    }
+
+#if (NGX_THREADS)
+
+    if (cache->loader_threads > 1) {
+        rc = ngx_http_file_cache_load_threads(cache, &tree);
+
+    } else {
+        rc = ngx_walk_tree(&tree, &cache->path->name);
+    }
+
+#else
+    rc = ngx_walk_tree(&tree, &cache->path->name);
+#endif
+
+    if (rc == NGX_ABORT) {
         cache->sh->loading = 0;
         return;
     }
@@ -2142,12 +2491,30 @@ ngx_http_file_cache_loader_sleep(ngx_http_file_cache_t *cache)
 static ngx_int_t
 ngx_http_file_cache_add_file(ngx_tree_ctx_t *ctx, ngx_str_t *name)
 {
-    u_char                 *p;
-    ngx_int_t               n;
-    ngx_uint_t              i;
+    ngx_int_t               rc;
     ngx_http_cache_t        c;
     ngx_http_file_cache_t  *cache;
 
+    cache = ctx->data;
+
+    rc = ngx_http_file_cache_file_key(cache, ctx, name, &c);
+
+    if (rc != NGX_OK) {
+        return (rc == NGX_DECLINED) ? NGX_OK : NGX_ERROR;
+    }
+
+    return ngx_http_file_cache_add(cache, &c);
+}
+
+
+static ngx_int_t
+ngx_http_file_cache_file_key(ngx_http_file_cache_t *cache,
+    ngx_tree_ctx_t *ctx, ngx_str_t *name, ngx_http_cache_t *c)
+{
+    u_char     *p;
+    ngx_int_t   n;
+    ngx_uint_t  i;
+
     if (name->len < 2 * NGX_HTTP_CACHE_KEY_LEN) {
         return NGX_ERROR;
     }
@@ -2160,7 +2527,7 @@ ngx_http_file_cache_add_file(ngx_tree_ctx_t *ctx, ngx_str_t *name)
     if (name->len >= 2 * NGX_HTTP_CACHE_KEY_LEN + 1 + 10
         && name->data[name->len - 10 - 1] == '.')
     {
-        return NGX_OK;
+        return NGX_DECLINED;
     }
 
     if (ctx->size < (off_t) sizeof(ngx_http_file_cache_header_t)) {
@@ -2169,11 +2536,10 @@ ngx_http_file_cache_add_file(ngx_tree_ctx_t *ctx, ngx_str_t *name)
         return NGX_ERROR;
     }
 
-    ngx_memzero(&c, sizeof(ngx_http_cache_t));
-    cache = ctx->data;
+    ngx_memzero(c, sizeof(ngx_http_cache_t));
 
-    c.length = ctx->size;
-    c.fs_size = (ctx->fs_size + cache->bsize - 1) / cache->bsize;
+    c->length = ctx->size;
+    c->fs_size = (ctx->fs_size + cache->bsize - 1) / cache->bsize;
 
     p = &name->data[name->len - 2 * NGX_HTTP_CACHE_KEY_LEN];
 
@@ -2186,97 +2552,761 @@ ngx_http_file_cache_add_file(ngx_tree_ctx_t *ctx, ngx_str_t *name)
 
         p += 2;
 
-        c.key[i] = (u_char) n;
+        c->key[i] = (u_char) n;
     }
 
-    return ngx_http_file_cache_add(cache, &c);
+    return NGX_OK;
 }
 
 
 static ngx_int_t
 ngx_http_file_cache_add(ngx_http_file_cache_t *cache, ngx_http_cache_t *c)
 {
+    ngx_int_t                    rc;
     ngx_http_file_cache_node_t  *fcn;
 
     ngx_shmtx_lock(&cache->shpool->mutex);
 
-    fcn = ngx_http_file_cache_lookup(cache, c->key);
+    rc = ngx_http_file_cache_add_locked(cache, c->key, c->fs_size, &fcn);
 
-    if (fcn == NULL) {
+    ngx_shmtx_unlock(&cache->shpool->mutex);
 
-        fcn = ngx_slab_calloc_locked(cache->shpool,
-                                     sizeof(ngx_http_file_cache_node_t));
-        if (fcn == NULL) {
-            ngx_http_file_cache_set_watermark(cache);
+    return (rc == NGX_ERROR) ? NGX_ERROR : NGX_OK;
+}
 
-            if (cache->fail_time != ngx_time()) {
-                cache->fail_time = ngx_time();
-                ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, 0,
-                           "could not allocate node%s", cache->shpool->log_ctx);
-            }
 
-            ngx_shmtx_unlock(&cache->shpool->mutex);
-            return NGX_ERROR;
+/*
+ * nodes which already exist were added by workers or by the snapshot,
+ * and they are left intact not to change the order of the queue
+ */
+
+static ngx_int_t
+ngx_http_file_cache_add_locked(ngx_http_file_cache_t *cache, u_char *key,
+    off_t fs_size, ngx_http_file_cache_node_t **node)
+{
+    ngx_http_file_cache_node_t  *fcn;
+
+    fcn = ngx_http_file_cache_lookup(cache, key);
+
+    if (fcn) {
+        return NGX_DECLINED;
+    }
+
+    fcn = ngx_slab_calloc_locked(cache->shpool,
+                                 sizeof(ngx_http_file_cache_node_t));
+    if (fcn == NULL) {
+        ngx_http_file_cache_set_watermark(cache);
+
+        if (cache->fail_time != ngx_time()) {
+            cache->fail_time = ngx_time();
+            ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, 0,
+                          "could not allocate node%s", cache->shpool->log_ctx);
         }
 
-        cache->sh->count++;
+        return NGX_ERROR;
+    }
 
-        ngx_memcpy((u_char *) &fcn->node.key, c->key, sizeof(ngx_rbtree_key_t));
+    cache->sh->count++;
 
-        ngx_memcpy(fcn->key, &c->key[sizeof(ngx_rbtree_key_t)],
-                   NGX_HTTP_CACHE_KEY_LEN - sizeof(ngx_rbtree_key_t));
+    ngx_memcpy((u_char *) &fcn->node.key, key, sizeof(ngx_rbtree_key_t));
 
-        ngx_rbtree_insert(&cache->sh->rbtree, &fcn->node);
+    ngx_memcpy(fcn->key, &key[sizeof(ngx_rbtree_key_t)],
+               NGX_HTTP_CACHE_KEY_LEN - sizeof(ngx_rbtree_key_t));
 
-        fcn->uses = 1;
-        fcn->exists = 1;
-        fcn->fs_size = c->fs_size;
+    ngx_rbtree_insert(&cache->sh->rbtree, &fcn->node);
 
-        cache->sh->size += c->fs_size;
+    fcn->uses = 1;
+    fcn->exists = 1;
+    fcn->fs_size = fs_size;
 
-    } else {
-        ngx_queue_remove(&fcn->queue);
-    }
+    cache->sh->size += fs_size;
 
     fcn->expire = ngx_time() + cache->inactive;
 
     ngx_queue_insert_head(&cache->sh->queue, &fcn->queue);
 
-    ngx_shmtx_unlock(&cache->shpool->mutex);
+    *node = fcn;
 
     return NGX_OK;
 }
 
 
+#if (NGX_THREADS)
+
 static ngx_int_t
-ngx_http_file_cache_delete_file(ngx_tree_ctx_t *ctx, ngx_str_t *path)
+ngx_http_file_cache_load_threads(ngx_http_file_cache_t *cache,
+    ngx_tree_ctx_t *tree)
 {
-    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, ctx->log, 0,
-                   "http file cache delete: \"%s\"", path->data);
+    int                            err;
+    u_char                        *p;
+    size_t                         len;
+    ngx_int_t                      rc;
+    ngx_uint_t                     i, n;
+    pthread_t                     *tids;
+    ngx_http_file_cache_loader_t  *ld;
 
-    if (ngx_delete_file(path->data) == NGX_FILE_ERROR) {
-        ngx_log_error(NGX_LOG_CRIT, ctx->log, ngx_errno,
-                      ngx_delete_file_n " \"%s\" failed", path->data);
+    n = cache->loader_threads;
+
+    len = cache->path->name.len + 1 + cache->path->len
+          + 2 * NGX_HTTP_CACHE_KEY_LEN + 1;
+
+    p = ngx_alloc(n * (sizeof(ngx_http_file_cache_loader_t)
+                       + sizeof(pthread_t) + len),
+                  ngx_cycle->log);
+    if (p == NULL) {
+        return ngx_walk_tree(tree, &cache->path->name);
     }
 
-    return NGX_OK;
-}
+    ld = (ngx_http_file_cache_loader_t *) p;
+    tids = (pthread_t *) (ld + n);
+    p = (u_char *) (tids + n);
 
+    for (i = 0; i < n; i++) {
+        ld[i].cache = cache;
+        ld[i].index = i;
+        ld[i].rc = NGX_OK;
 
-static void
-ngx_http_file_cache_set_watermark(ngx_http_file_cache_t *cache)
-{
-    cache->sh->watermark = cache->sh->count - cache->sh->count / 8;
+        ld[i].tree = *tree;
+        ld[i].tree.file_handler = ngx_http_file_cache_load_file;
+        ld[i].tree.pre_tree_handler = ngx_http_file_cache_load_directory;
+        ld[i].tree.spec_handler = ngx_http_file_cache_load_special;
+        ld[i].tree.data = &ld[i];
 
-    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, ngx_cycle->log, 0,
-                   "http file cache watermark: %ui", cache->sh->watermark);
-}
+        ld[i].files = 0;
+        ld[i].last = ngx_current_msec;
 
+        ld[i].name = p;
+        p = ngx_cpymem(p, cache->path->name.data, cache->path->name.len);
+        p += len - cache->path->name.len;
 
-time_t
-ngx_http_file_cache_valid(ngx_array_t *cache_valid, ngx_uint_t status)
-{
-    ngx_uint_t               i;
+        ld[i].nfiles = 0;
+    }
+
+    for (i = 0; i < n; i++) {
+        err = pthread_create(&tids[i], NULL,
+                             ngx_http_file_cache_loader_thread, &ld[i]);
+        if (err) {
+            ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, err,
+                          "pthread_create() failed");
+
+            /* the part of the tree is walked by the loader itself */
+
+            tids[i] = pthread_self();
+            (void) ngx_http_file_cache_loader_thread(&ld[i]);
+        }
+    }
+
+    rc = NGX_OK;
+
+    for (i = 0; i < n; i++) {
+
+        if (!pthread_equal(tids[i], pthread_self())) {
+            err = pthread_join(tids[i], NULL);
+            if (err) {
+                ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, err,
+                              "pthread_join() failed");
+            }
+        }
+
+        if (ld[i].rc == NGX_ABORT) {
+            rc = NGX_ABORT;
+        }
+    }
+
+    ngx_free(ld);
+
+    return rc;
+}
+
+
+static void *
+ngx_http_file_cache_loader_thread(void *data)
+{
+    ngx_http_file_cache_loader_t  *ld = data;
+
+    sigset_t  set;
+
+    sigfillset(&set);
+
+    sigdelset(&set, SIGILL);
+    sigdelset(&set, SIGFPE);
+    sigdelset(&set, SIGSEGV);
+    sigdelset(&set, SIGBUS);
+
+    (void) pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, ngx_cycle->log, 0,
+                   "http file cache loader thread #%ui", ld->index);
+
+    ld->rc = ngx_walk_tree(&ld->tree, &ld->cache->path->name);
+
+    ngx_http_file_cache_loader_flush(ld);
+
+    return NULL;
+}
+
+
+/*
+ * each thread walks the whole first level of the cache, and enters
+ * only the directories whose names hash to its index; the files
+ * found on the first level itself belong to the first thread
+ */
+
+static ngx_uint_t
+ngx_http_file_cache_loader_owns(ngx_http_file_cache_loader_t *ld,
+    ngx_str_t *path, ngx_uint_t dir)
+{
+    u_char  *p, *last;
+
+    p = path->data + ld->cache->path->name.len + 1;
+    last = path->data + path->len;
+
+    if (ngx_strlchr(p, last, '/') != NULL) {
+        return 1;
+    }
+
+    if (!dir) {
+        return ld->index == 0;
+    }
+
+    return ngx_hash_key(p, last - p) % ld->cache->loader_threads == ld->index;
+}
+
+
+static ngx_int_t
+ngx_http_file_cache_load_file(ngx_tree_ctx_t *ctx, ngx_str_t *path)
+{
+    ngx_int_t                           rc;
+    ngx_msec_t                          elapsed;
+    ngx_http_cache_t                    c;
+    ngx_http_file_cache_t              *cache;
+    ngx_http_file_cache_loader_t       *ld;
+    ngx_http_file_cache_loader_file_t  *f;
+
+    ld = ctx->data;
+    cache = ld->cache;
+
+    if (!ngx_http_file_cache_loader_owns(ld, path, 0)) {
+        return NGX_OK;
+    }
+
+    rc = ngx_http_file_cache_file_key(cache, ctx, path, &c);
+
+    if (rc == NGX_OK) {
+        f = &ld->batch[ld->nfiles++];
+
+        ngx_memcpy(f->key, c.key, NGX_HTTP_CACHE_KEY_LEN);
+        f->fs_size = c.fs_size;
+
+        if (ld->nfiles == NGX_HTTP_CACHE_LOADER_BATCH) {
+            ngx_http_file_cache_loader_flush(ld);
+        }
+
+    } else if (rc == NGX_ERROR) {
+        (void) ngx_http_file_cache_delete_file(ctx, path);
+    }
+
+    if (++ld->files < cache->loader_files) {
+        ngx_time_update();
+
+        elapsed = ngx_abs((ngx_msec_int_t) (ngx_current_msec - ld->last));
+
+        if (elapsed < cache->loader_threshold) {
+            goto done;
+        }
+    }
+
+    ngx_http_file_cache_loader_flush(ld);
+
+    ngx_msleep(cache->loader_sleep);
+
+    ngx_time_update();
+
+    ld->last = ngx_current_msec;
+    ld->files = 0;
+
+done:
+
+    return (ngx_quit || ngx_terminate) ? NGX_ABORT : NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_file_cache_load_directory(ngx_tree_ctx_t *ctx, ngx_str_t *path)
+{
+    if (ngx_http_file_cache_manage_directory(ctx, path) != NGX_OK) {
+        return NGX_DECLINED;
+    }
+
+    return ngx_http_file_cache_loader_owns(ctx->data, path, 1)
+           ? NGX_OK : NGX_DECLINED;
+}
+
+
+static ngx_int_t
+ngx_http_file_cache_load_special(ngx_tree_ctx_t *ctx, ngx_str_t *path)
+{
+    if (!ngx_http_file_cache_loader_owns(ctx->data, path, 0)) {
+        return NGX_OK;
+    }
+
+    return ngx_http_file_cache_delete_file(ctx, path);
+}
+
+
+static void
+ngx_http_file_cache_loader_flush(ngx_http_file_cache_loader_t *ld)
+{
+    u_char                             *p;
+    size_t                              len;
+    ngx_int_t                           rc;
+    ngx_uint_t                          i, n;
+    ngx_path_t                         *path;
+    ngx_http_file_cache_t              *cache;
+    ngx_http_file_cache_node_t         *fcn;
+    ngx_http_file_cache_loader_file_t  *f;
+
+    if (ld->nfiles == 0) {
+        return;
+    }
+
+    cache = ld->cache;
+    f = ld->batch;
+    n = 0;
+
+    ngx_shmtx_lock(&cache->shpool->mutex);
+
+    for (i = 0; i < ld->nfiles; i++) {
+        rc = ngx_http_file_cache_add_locked(cache, f[i].key, f[i].fs_size,
+                                            &fcn);
+        if (rc == NGX_ERROR) {
+            f[n++] = f[i];
+        }
+    }
+
+    ngx_shmtx_unlock(&cache->shpool->mutex);
+
+    ld->nfiles = 0;
+
+    /* files which could not be added are deleted as in the plain loader */
+
+    path = cache->path;
+    len = path->name.len + 1 + path->len + 2 * NGX_HTTP_CACHE_KEY_LEN;
+
+    for (i = 0; i < n; i++) {
+        p = ld->name + path->name.len + 1 + path->len;
+        p = ngx_hex_dump(p, f[i].key, NGX_HTTP_CACHE_KEY_LEN);
+        *p = '\0';
+
+        ngx_create_hashed_filename(path, ld->name, len);
+
+        ngx_log_debug1(NGX_LOG_DEBUG_HTTP, ngx_cycle->log, 0,
+                       "http file cache delete: \"%s\"", ld->name);
+
+        if (ngx_delete_file(ld->name) == NGX_FILE_ERROR) {
+            ngx_log_error(NGX_LOG_CRIT, ngx_cycle->log, ngx_errno,
+                          ngx_delete_file_n " \"%s\" failed", ld->name);
+        }
+    }
+}
+
+#endif
+
+
+static void
+ngx_http_file_cache_load_snapshot(ngx_http_file_cache_t *cache)
+{
+    ssize_t                               n;
+    ngx_fd_t                              fd;
+    ngx_int_t                             rc;
+    ngx_uint_t                            i, loaded;
+    ngx_path_t                           *path;
+    ngx_file_info_t                       fi;
+    ngx_http_file_cache_node_t           *fcn;
+    ngx_http_file_cache_snapshot_t        hdr;
+    ngx_http_file_cache_snapshot_node_t  *sn;
+    ngx_http_file_cache_snapshot_node_t   buf[NGX_HTTP_CACHE_LOADER_BATCH];
+
+    fd = ngx_open_file(cache->snapshot.data, NGX_FILE_RDONLY, NGX_FILE_OPEN, 0);
+
+    if (fd == NGX_INVALID_FILE) {
+        if (ngx_errno != NGX_ENOENT) {
+            ngx_log_error(NGX_LOG_CRIT, ngx_cycle->log, ngx_errno,
+                          ngx_open_file_n " \"%V\" failed", &cache->snapshot);
+        }
+
+        return;
+    }
+
+    /*
+     * the snapshot is used only once: if the cache changes after
+     * the start, the next snapshot is saved by the master process on exit;
+     * a snapshot which cannot be deleted is not loaded, as it would be
+     * loaded again after a crash
+     */
+
+    if (ngx_delete_file(cache->snapshot.data) == NGX_FILE_ERROR) {
+        ngx_log_error(NGX_LOG_CRIT, ngx_cycle->log, ngx_errno,
+                      ngx_delete_file_n " \"%V\" failed, snapshot ignored",
+                      &cache->snapshot);
+        goto done;
+    }
+
+    if (ngx_fd_info(fd, &fi) == NGX_FILE_ERROR) {
+        ngx_log_error(NGX_LOG_CRIT, ngx_cycle->log, ngx_errno,
+                      ngx_fd_info_n " \"%V\" failed", &cache->snapshot);
+        goto done;
+    }
+
+    n = ngx_read_fd(fd, &hdr, sizeof(ngx_http_file_cache_snapshot_t));
+
+    path = cache->path;
+
+    if (n != sizeof(ngx_http_file_cache_snapshot_t)
+        || hdr.version != NGX_HTTP_CACHE_SNAPSHOT_VERSION
+        || hdr.cache_version != NGX_HTTP_CACHE_VERSION
+        || hdr.levels != (path->level[0] | path->level[1] << 8
+                          | path->level[2] << 16)
+        || hdr.bsize != cache->bsize
+        || (uint64_t) ngx_file_size(&fi)
+           != sizeof(ngx_http_file_cache_snapshot_t)
+              + hdr.count * sizeof(ngx_http_file_cache_snapshot_node_t))
+    {
+        ngx_log_error(NGX_LOG_WARN, ngx_cycle->log, 0,
+                      "cache snapshot \"%V\" does not match the cache, "
+                      "ignored", &cache->snapshot);
+        goto done;
+    }
+
+    loaded = 0;
+
+    for ( ;; ) {
+
+        n = ngx_read_fd(fd, buf, sizeof(buf));
+
+        if (n == -1) {
+            ngx_log_error(NGX_LOG_CRIT, ngx_cycle->log, ngx_errno,
+                          ngx_read_fd_n " \"%V\" failed", &cache->snapshot);
+            break;
+        }
+
+        n /= sizeof(ngx_http_file_cache_snapshot_node_t);
+
+        if (n == 0) {
+            break;
+        }
+
+        rc = NGX_OK;
+
+        ngx_shmtx_lock(&cache->shpool->mutex);
+
+        for (i = 0; i < (ngx_uint_t) n; i++) {
+            sn = &buf[i];
+
+            rc = ngx_http_file_cache_add_locked(cache, sn->key,
+                                                (off_t) sn->fs_size, &fcn);
+            if (rc == NGX_ERROR) {
+                break;
+            }
+
+            if (rc == NGX_DECLINED) {
+                continue;
+            }
+
+            fcn->uniq = (ngx_file_uniq_t) sn->uniq;
+            fcn->valid_sec = (time_t) sn->valid_sec;
+            fcn->body_start = sn->body_start;
+
+            ngx_http_file_cache_restore(cache, fcn, (time_t) sn->expire,
+                                        sn->flags);
+
+            loaded++;
+        }
+
+        ngx_http_file_cache_demote(cache);
+
+        ngx_shmtx_unlock(&cache->shpool->mutex);
+
+        if (rc == NGX_ERROR || ngx_quit || ngx_terminate) {
+            break;
+        }
+    }
+
+    ngx_log_error(NGX_LOG_NOTICE, ngx_cycle->log, 0,
+                  "http file cache: %ui of %uL keys loaded from \"%V\"",
+                  loaded, hdr.count, &cache->snapshot);
+
+done:
+
+    if (ngx_close_file(fd) == NGX_FILE_ERROR) {
+        ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, ngx_errno,
+                      ngx_close_file_n " \"%V\" failed", &cache->snapshot);
+    }
+}
+
+
+/*
+ * a node goes back to the queue it was saved from; the queues are
+ * kept ordered by expire time for the inactive expiry, so a node
+ * never expires before the nodes already at the head of its queue,
+ * such as ones added by workers while the snapshot is loaded
+ */
+
+static void
+ngx_http_file_cache_restore(ngx_http_file_cache_t *cache,
+    ngx_http_file_cache_node_t *fcn, time_t expire, ngx_uint_t flags)
+{
+    ngx_queue_t                 *queue;
+    ngx_http_file_cache_node_t  *head;
+
+    queue = &cache->sh->queue;
+
+    if ((flags & NGX_HTTP_CACHE_SNAPSHOT_PROMOTED)
+        && cache->policy != NGX_HTTP_CACHE_POLICY_LRU)
+    {
+        queue = &cache->sh->promoted;
+        fcn->promoted = 1;
+        cache->sh->promoted_count++;
+    }
+
+    ngx_queue_remove(&fcn->queue);
+
+    if (!ngx_queue_empty(queue)) {
+        head = ngx_queue_data(ngx_queue_head(queue),
+                              ngx_http_file_cache_node_t, queue);
+
+        if (expire < head->expire) {
+            expire = head->expire;
+        }
+    }
+
+    fcn->expire = expire;
+
+    ngx_queue_insert_head(queue, &fcn->queue);
+}
+
+
+static void
+ngx_http_file_cache_save(void *data)
+{
+    ngx_http_file_cache_t  *cache = data;
+
+    u_char                               *name;
+    size_t                                size;
+    ngx_fd_t                              fd;
+    ngx_uint_t                            i, n;
+    ngx_path_t                           *path;
+    ngx_queue_t                          *q, *queue[2];
+    ngx_core_conf_t                      *ccf;
+    ngx_http_file_cache_node_t           *fcn;
+    ngx_http_file_cache_snapshot_t        hdr;
+    ngx_http_file_cache_snapshot_node_t  *sn;
+    ngx_http_file_cache_snapshot_node_t   buf[NGX_HTTP_CACHE_LOADER_BATCH];
+
+    if (cache->snapshot.len == 0 || cache->sh == NULL) {
+        return;
+    }
+
+    name = ngx_alloc(cache->snapshot.len + sizeof(".tmp"), ngx_cycle->log);
+    if (name == NULL) {
+        return;
+    }
+
+    ngx_sprintf(name, "%V.tmp%Z", &cache->snapshot);
+
+    /*
+     * the master process may run as root while the directory is writable
+     * by the worker user, who has to delete the snapshot on load:
+     * a stale temporary file is removed, and the new one is created
+     * exclusively, so it is never a symlink planted there, and then
+     * handed over to the worker user
+     */
+
+    if (ngx_delete_file(name) == NGX_FILE_ERROR && ngx_errno != NGX_ENOENT) {
+        ngx_log_error(NGX_LOG_CRIT, ngx_cycle->log, ngx_errno,
+                      ngx_delete_file_n " \"%s\" failed", name);
+        ngx_free(name);
+        return;
+    }
+
+    fd = ngx_open_tempfile(name, 1, NGX_FILE_OWNER_ACCESS);
+
+    if (fd == NGX_INVALID_FILE) {
+        ngx_log_error(NGX_LOG_CRIT, ngx_cycle->log, ngx_errno,
+                      ngx_open_tempfile_n " \"%s\" failed", name);
+        ngx_free(name);
+        return;
+    }
+
+    ccf = (ngx_core_conf_t *) ngx_get_conf(ngx_cycle->conf_ctx,
+                                           ngx_core_module);
+
+    if (ccf->user != (ngx_uid_t) NGX_CONF_UNSET_UINT
+        && fchown(fd, ccf->user, -1) == -1)
+    {
+        ngx_log_error(NGX_LOG_CRIT, ngx_cycle->log, ngx_errno,
+                      "fchown(\"%s\", %d) failed", name, ccf->user);
+
+        if (ngx_close_file(fd) == NGX_FILE_ERROR) {
+            ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, ngx_errno,
+                          ngx_close_file_n " \"%s\" failed", name);
+        }
+
+        goto delete;
+    }
+
+    /*
+     * all processes have exited, so the zone is not locked;
+     * the nodes are saved from the least recently used one
+     * to restore the order of the queues on load, and the protected
+     * nodes are saved last and flagged to go back to their queue
+     */
+
+    path = cache->path;
+
+    ngx_memzero(&hdr, sizeof(ngx_http_file_cache_snapshot_t));
+
+    hdr.version = NGX_HTTP_CACHE_SNAPSHOT_VERSION;
+    hdr.cache_version = NGX_HTTP_CACHE_VERSION;
+    hdr.levels = path->level[0] | path->level[1] << 8 | path->level[2] << 16;
+    hdr.bsize = cache->bsize;
+
+    queue[0] = &cache->sh->queue;
+    queue[1] = &cache->sh->promoted;
+
+    for (i = 0; i < 2; i++) {
+        for (q = ngx_queue_head(queue[i]);
+             q != ngx_queue_sentinel(queue[i]);
+             q = ngx_queue_next(q))
+        {
+            fcn = ngx_queue_data(q, ngx_http_file_cache_node_t, queue);
+
+            if (fcn->exists && !fcn->deleting) {
+                hdr.count++;
+            }
+        }
+    }
+
+    if (ngx_write_fd(fd, &hdr, sizeof(ngx_http_file_cache_snapshot_t))
+        != sizeof(ngx_http_file_cache_snapshot_t))
+    {
+        goto failed;
+    }
+
+    n = 0;
+
+    for (i = 0; i < 2; i++) {
+        for (q = ngx_queue_last(queue[i]);
+             q != ngx_queue_sentinel(queue[i]);
+             q = ngx_queue_prev(q))
+        {
+            fcn = ngx_queue_data(q, ngx_http_file_cache_node_t, queue);
+
+            if (!fcn->exists || fcn->deleting) {
+                continue;
+            }
+
+            sn = &buf[n++];
+
+            ngx_memcpy(sn->key, &fcn->node.key, sizeof(ngx_rbtree_key_t));
+            ngx_memcpy(&sn->key[sizeof(ngx_rbtree_key_t)], fcn->key,
+                       NGX_HTTP_CACHE_KEY_LEN - sizeof(ngx_rbtree_key_t));
+
+            sn->uniq = fcn->uniq;
+            sn->expire = fcn->expire;
+            sn->valid_sec = fcn->valid_sec;
+            sn->fs_size = fcn->fs_size;
+            sn->body_start = fcn->body_start;
+            sn->flags = fcn->promoted ? NGX_HTTP_CACHE_SNAPSHOT_PROMOTED : 0;
+
+            if (n == NGX_HTTP_CACHE_LOADER_BATCH) {
+                size = n * sizeof(ngx_http_file_cache_snapshot_node_t);
+
+                if (ngx_write_fd(fd, buf, size) != (ssize_t) size) {
+                    goto failed;
+                }
+
+                n = 0;
+            }
+        }
+    }
+
+    size = n * sizeof(ngx_http_file_cache_snapshot_node_t);
+
+    if (n && ngx_write_fd(fd, buf, size) != (ssize_t) size) {
+        goto failed;
+    }
+
+    if (ngx_close_file(fd) == NGX_FILE_ERROR) {
+        ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, ngx_errno,
+                      ngx_close_file_n " \"%s\" failed", name);
+    }
+
+    if (ngx_rename_file(name, cache->snapshot.data) == NGX_FILE_ERROR) {
+        ngx_log_error(NGX_LOG_CRIT, ngx_cycle->log, ngx_errno,
+                      ngx_rename_file_n " \"%s\" to \"%V\" failed",
+                      name, &cache->snapshot);
+        goto delete;
+    }
+
+    ngx_log_error(NGX_LOG_NOTICE, ngx_cycle->log, 0,
+                  "http file cache: %uL keys saved to \"%V\"",
+                  hdr.count, &cache->snapshot);
+
+    ngx_free(name);
+
+    return;
+
+failed:
+
+    ngx_log_error(NGX_LOG_CRIT, ngx_cycle->log, ngx_errno,
+                  ngx_write_fd_n " to \"%s\" failed", name);
+
+    if (ngx_close_file(fd) == NGX_FILE_ERROR) {
+        ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, ngx_errno,
+                      ngx_close_file_n " \"%s\" failed", name);
+    }
+
+delete:
+
+    if (ngx_delete_file(name) == NGX_FILE_ERROR) {
+        ngx_log_error(NGX_LOG_CRIT, ngx_cycle->log, ngx_errno,
+                      ngx_delete_file_n " \"%s\" failed", name);
+    }
+
+    ngx_free(name);
+}
+
+
+static ngx_int_t
+ngx_http_file_cache_delete_file(ngx_tree_ctx_t *ctx, ngx_str_t *path)
+{
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, ctx->log, 0,
+                   "http file cache delete: \"%s\"", path->data);
+
+    if (ngx_delete_file(path->data) == NGX_FILE_ERROR) {
+        ngx_log_error(NGX_LOG_CRIT, ctx->log, ngx_errno,
+                      ngx_delete_file_n " \"%s\" failed", path->data);
+    }
+
+    return NGX_OK;
+}
+
+
+static void
+ngx_http_file_cache_set_watermark(ngx_http_file_cache_t *cache)
+{
+    cache->sh->watermark = cache->sh->count - cache->sh->count / 8;
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, ngx_cycle->log, 0,
+                   "http file cache watermark: %ui", cache->sh->watermark);
+}
+
+
+time_t
+ngx_http_file_cache_valid(ngx_array_t *cache_valid, ngx_uint_t status)
+{
+    ngx_uint_t               i;
     ngx_http_cache_valid_t  *valid;
 
     if (cache_valid == NULL) {
@@ -2299,6 +3329,67 @@ ngx_http_file_cache_valid(ngx_array_t *cache_valid, ngx_uint_t status)
 }
 
 
+size_t
+ngx_http_file_cache_status_size(ngx_cycle_t *cycle)
+{
+    size_t                  size;
+    ngx_uint_t              i;
+    ngx_path_t            **path;
+    ngx_http_file_cache_t  *cache;
+
+    size = 0;
+
+    path = cycle->paths.elts;
+
+    for (i = 0; i < cycle->paths.nelts; i++) {
+
+        if (path[i]->manager != ngx_http_file_cache_manager) {
+            continue;
+        }
+
+        cache = path[i]->data;
+
+        size += sizeof("Cache \"\": policy  hits  misses  rejected  "
+                       "evicted  expired \n") - 1
+                + cache->shm_zone->shm.name.len + sizeof("tinylfu") - 1
+                + 5 * NGX_INT_T_LEN;
+    }
+
+    return size;
+}
+
+
+u_char *
+ngx_http_file_cache_status(ngx_cycle_t *cycle, u_char *p)
+{
+    ngx_uint_t                 i;
+    ngx_path_t               **path;
+    ngx_http_file_cache_t     *cache;
+    ngx_http_file_cache_sh_t  *sh;
+
+    path = cycle->paths.elts;
+
+    for (i = 0; i < cycle->paths.nelts; i++) {
+
+        if (path[i]->manager != ngx_http_file_cache_manager) {
+            continue;
+        }
+
+        cache = path[i]->data;
+        sh = cache->sh;
+
+        p = ngx_sprintf(p, "Cache \"%V\": policy %V hits %ui misses %ui "
+                        "rejected %ui evicted %ui expired %ui \n",
+                        &cache->shm_zone->shm.name,
+                        &ngx_http_file_cache_policies[cache->policy],
+                        sh->hits, sh->misses, sh->rejected,
+                        sh->evicted, sh->expired);
+    }
+
+    return p;
+}
+
+
 char *
 ngx_http_file_cache_set_slot(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
 {
@@ -2308,11 +3399,11 @@ ngx_http_file_cache_set_slot(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
     u_char                 *last, *p;
     time_t                  inactive;
     ssize_t                 size;
-    ngx_str_t               s, name, *value;
-    ngx_int_t               loader_files, manager_files;
+    ngx_str_t               s, name, snapshot, *value;
+    ngx_int_t               loader_files, loader_threads, manager_files;
     ngx_msec_t              loader_sleep, manager_sleep, loader_threshold,
                             manager_threshold;
-    ngx_uint_t              i, n, use_temp_path;
+    ngx_uint_t              i, n, use_temp_path, policy;
     ngx_array_t            *caches;
     ngx_http_file_cache_t  *cache, **ce;
 
@@ -2327,12 +3418,14 @@ ngx_http_file_cache_set_slot(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
     }
 
     use_temp_path = 1;
+    policy = NGX_HTTP_CACHE_POLICY_LRU;
 
     inactive = 600;
 
     loader_files = 100;
     loader_sleep = 50;
     loader_threshold = 200;
+    loader_threads = 1;
 
     manager_files = 100;
     manager_sleep = 50;
@@ -2342,6 +3435,8 @@ ngx_http_file_cache_set_slot(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
     size = 0;
     max_size = NGX_MAX_OFF_T_VALUE;
 
+    ngx_str_null(&snapshot);
+
     value = cf->args->elts;
 
     cache->path->name = value[1];
@@ -2467,6 +3562,31 @@ ngx_http_file_cache_set_slot(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
             continue;
         }
 
+        if (ngx_strncmp(value[i].data, "policy=", 7) == 0) {
+
+            for (n = 0; ngx_http_file_cache_policies[n].len; n++) {
+                if (ngx_strcmp(value[i].data + 7,
+                               ngx_http_file_cache_policies[n].data)
+                    == 0)
+                {
+                    break;
+                }
+            }
+
+            if (ngx_http_file_cache_policies[n].len == 0) {
+                ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                                   "invalid policy value \"%V\", "
+                                   "it must be \"lru\", \"slru\", "
+                                   "or \"tinylfu\"",
+                                   &value[i]);
+                return NGX_CONF_ERROR;
+            }
+
+            policy = n;
+
+            continue;
+        }
+
         if (ngx_strncmp(value[i].data, "loader_files=", 13) == 0) {
 
             loader_files = ngx_atoi(value[i].data + 13, value[i].len - 13);
@@ -2509,6 +3629,51 @@ ngx_http_file_cache_set_slot(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
             continue;
         }
 
+        if (ngx_strncmp(value[i].data, "loader_threads=", 15) == 0) {
+
+            loader_threads = ngx_atoi(value[i].data + 15, value[i].len - 15);
+            if (loader_threads == NGX_ERROR || loader_threads == 0) {
+                ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                           "invalid loader_threads value \"%V\"", &value[i]);
+                return NGX_CONF_ERROR;
+            }
+
+#if !(NGX_THREADS)
+
+            if (loader_threads > 1) {
+                ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                                   "\"loader_threads\" is unsupported "
+                                   "on this platform");
+                return NGX_CONF_ERROR;
+            }
+
+#endif
+
+            continue;
+        }
+
+        /*
+         * the directory of the snapshot must be writable by the worker
+         * user: the cache loader deletes the snapshot before using it
+         */
+
+        if (ngx_strncmp(value[i].data, "snapshot=", 9) == 0) {
+
+            snapshot.len = value[i].len - 9;
+            snapshot.data = value[i].data + 9;
+
+            if (snapshot.len == 0
+                || ngx_conf_full_name(cf->cycle, &snapshot, 0) != NGX_OK)
+            {
+                ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                                   "invalid snapshot value \"%V\"",
+                                   &value[i]);
+                return NGX_CONF_ERROR;
+            }
+
+            continue;
+        }
+
         if (ngx_strncmp(value[i].data, "manager_files=", 14) == 0) {
 
             manager_files = ngx_atoi(value[i].data + 14, value[i].len - 14);
@@ -2565,12 +3730,15 @@ ngx_http_file_cache_set_slot(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
 
     cache->path->manager = ngx_http_file_cache_manager;
     cache->path->loader = ngx_http_file_cache_loader;
+    cache->path->saver = ngx_http_file_cache_save;
     cache->path->data = cache;
     cache->path->conf_file = cf->conf_file->file.name.data;
     cache->path->line = cf->conf_file->line;
     cache->loader_files = loader_files;
     cache->loader_sleep = loader_sleep;
     cache->loader_threshold = loader_threshold;
+    cache->loader_threads = loader_threads;
+    cache->snapshot = snapshot;
     cache->manager_files = manager_files;
     cache->manager_sleep = manager_sleep;
     cache->manager_threshold = manager_threshold;
@@ -2595,6 +3763,7 @@ ngx_http_file_cache_set_slot(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
     cache->shm_zone->data = cache;
 
     cache->use_temp_path = use_temp_path;
+    cache->policy = policy;
 
     cache->inactive = inactive;
     cache->max_size = max_size;
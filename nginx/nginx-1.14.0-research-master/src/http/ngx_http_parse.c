@@ -10,6 +10,22 @@
 #include <ngx_core.h>
 #include <ngx_http.h>
 
+#if (NGX_HAVE_SSE42)
+#include <nmmintrin.h>
+#elif (NGX_HAVE_SSE2)
+#include <emmintrin.h>
+#endif
+
+
+#if (NGX_HAVE_SSE2)
+
+static ngx_inline u_char *ngx_http_parse_skip(u_char *p, u_char *last,
+    const u_char *set, int n);
+static ngx_inline u_char *ngx_http_parse_header_name(ngx_http_request_t *r,
+    u_char *p, u_char *last, ngx_uint_t *hash, ngx_uint_t *i);
+
+#endif
+
 
 static uint32_t  usual[] = {
     0xffffdbfe, /* 1111 1111 1111 1111  1101 1011 1111 1110 */
@@ -101,6 +117,33 @@ static uint32_t  usual[] = {
 #endif
 
 
+#if (NGX_HAVE_SSE2)
+
+/*
+ * the bytes which are not "usual" in URI, and the bytes which end
+ * the arguments and a header value line, padded for 16-byte loads
+ */
+
+#if (NGX_WIN32)
+#define NGX_HTTP_URI_SPECIAL  11
+#else
+#define NGX_HTTP_URI_SPECIAL  10
+#endif
+
+static const u_char  ngx_http_uri_special[16] = {
+    '\0', CR, LF, ' ', '#', '%', '+', '.', '/', '?',
+#if (NGX_WIN32)
+    '\\'
+#endif
+};
+
+static const u_char  ngx_http_args_special[16] = { '\0', CR, LF, ' ', '#' };
+
+static const u_char  ngx_http_value_special[16] = { '\0', CR, LF };
+
+#endif
+
+
 /* gcc, icc, msvc and others compile these switches as an jump table */
 
 ngx_int_t
@@ -565,6 +608,10 @@ ngx_http_parse_request_line(ngx_http_request_t *r, ngx_buf_t *b)
         case sw_check_uri:
 
             if (usual[ch >> 5] & (1U << (ch & 0x1f))) {
+#if (NGX_HAVE_SSE2)
+                p = ngx_http_parse_skip(p + 1, b->last, ngx_http_uri_special,
+                                        NGX_HTTP_URI_SPECIAL) - 1;
+#endif
                 break;
             }
 
@@ -651,6 +698,10 @@ ngx_http_parse_request_line(ngx_http_request_t *r, ngx_buf_t *b)
         case sw_uri:
 
             if (usual[ch >> 5] & (1U << (ch & 0x1f))) {
+#if (NGX_HAVE_SSE2)
+                p = ngx_http_parse_skip(p + 1, b->last, ngx_http_args_special,
+                                        5) - 1;
+#endif
                 break;
             }
 
@@ -869,6 +920,9 @@ ngx_http_parse_header_line(ngx_http_request_t *r, ngx_buf_t *b,
 {
     u_char      c, ch, *p;
     ngx_uint_t  hash, i;
+#if (NGX_HAVE_SSE2)
+    u_char     *q;
+#endif
     enum {
         sw_start = 0,
         sw_name,
@@ -958,6 +1012,10 @@ ngx_http_parse_header_line(ngx_http_request_t *r, ngx_buf_t *b,
                 hash = ngx_hash(hash, c);
                 r->lowcase_header[i++] = c;
                 i &= (NGX_HTTP_LC_HEADER_LEN - 1);
+#if (NGX_HAVE_SSE2)
+                p = ngx_http_parse_header_name(r, p + 1, b->last, &hash, &i)
+                    - 1;
+#endif
                 break;
             }
 
@@ -1052,6 +1110,27 @@ ngx_http_parse_header_line(ngx_http_request_t *r, ngx_buf_t *b,
                 goto done;
             case '\0':
                 return NGX_HTTP_PARSE_INVALID_HEADER;
+#if (NGX_HAVE_SSE2)
+            default:
+
+                /*
+                 * skip the value up to the end of the line, trailing
+                 * spaces are handled as in sw_space_after_value
+                 */
+
+                q = ngx_http_parse_skip(p + 1, b->last, ngx_http_value_special,
+                                        3);
+
+                for (p = q; *(p - 1) == ' '; p--) { /* void */ }
+
+                if (p != q) {
+                    r->header_end = p;
+                    state = sw_space_after_value;
+                }
+
+                p = q - 1;
+                break;
+#endif
             }
             break;
 
@@ -2412,3 +2491,116 @@ invalid:
 
     return NGX_ERROR;
 }
+
+
+#if (NGX_HAVE_SSE2)
+
+/*
+ * returns the first byte of the set, or the position where less than
+ * 16 bytes are left; the rest is handled by the byte-at-a-time code
+ */
+
+static ngx_inline u_char *
+ngx_http_parse_skip(u_char *p, u_char *last, const u_char *set, int n)
+{
+#if (NGX_HAVE_SSE42)
+    int      k;
+    __m128i  s;
+
+    s = _mm_loadu_si128((const __m128i *) set);
+
+    while (last - p >= 16) {
+        k = _mm_cmpestri(s, n, _mm_loadu_si128((const __m128i *) p), 16,
+                         _SIDD_UBYTE_OPS|_SIDD_CMP_EQUAL_ANY
+                         |_SIDD_LEAST_SIGNIFICANT);
+        if (k != 16) {
+            return p + k;
+        }
+
+        p += 16;
+    }
+
+#else
+    int      k, m;
+    __m128i  v, eq;
+
+    while (last - p >= 16) {
+        v = _mm_loadu_si128((const __m128i *) p);
+
+        eq = _mm_cmpeq_epi8(v, _mm_set1_epi8((char) set[0]));
+
+        for (k = 1; k < n; k++) {
+            eq = _mm_or_si128(eq, _mm_cmpeq_epi8(v,
+                                                 _mm_set1_epi8((char) set[k])));
+        }
+
+        m = _mm_movemask_epi8(eq);
+
+        if (m) {
+            return p + __builtin_ctz(m);
+        }
+
+        p += 16;
+    }
+
+#endif
+
+    return p;
+}
+
+
+/*
+ * lowercases and hashes 16 bytes of a header name at a time while they
+ * are letters, digits or "-", and the lowcase_header buffer does not wrap
+ */
+
+static ngx_inline u_char *
+ngx_http_parse_header_name(ngx_http_request_t *r, u_char *p, u_char *last,
+    ngx_uint_t *hash, ngx_uint_t *i)
+{
+    u_char      *lc;
+    ngx_uint_t   h, k, n;
+    __m128i      v, lower, alpha, digit, valid;
+
+    h = *hash;
+    n = 16;
+
+    while (n == 16 && last - p >= 16 && *i + 16 <= NGX_HTTP_LC_HEADER_LEN) {
+
+        v = _mm_loadu_si128((const __m128i *) p);
+
+        /* bytes above 0x7f are negative and fail the signed comparisons */
+
+        lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+
+        alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                              _mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+
+        digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)),
+                              _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+
+        valid = _mm_or_si128(_mm_or_si128(alpha, digit),
+                             _mm_cmpeq_epi8(v, _mm_set1_epi8('-')));
+
+        n = __builtin_ctz(~_mm_movemask_epi8(valid));
+
+        lc = &r->lowcase_header[*i];
+
+        _mm_storeu_si128((__m128i *) lc,
+                         _mm_or_si128(v, _mm_and_si128(alpha,
+                                                       _mm_set1_epi8(0x20))));
+
+        for (k = 0; k < n; k++) {
+            h = ngx_hash(h, lc[k]);
+        }
+
+        *i = (*i + n) & (NGX_HTTP_LC_HEADER_LEN - 1);
+        p += n;
+    }
+
+    *hash = h;
+
+    return p;
+}
+
+#endif
@@ -93,6 +93,32 @@ ngx_file_aio_read(ngx_file_t *file, u_char *buf, size_t size, off_t offset,
         return NGX_ERROR;
     }
 
+    ev->handler = ngx_file_aio_event_handler;
+
+#if (NGX_HAVE_IO_URING)
+
+    if (ngx_io_uring_file_aio) {
+
+        /*
+         * the read is queued in the io_uring submission ring and
+         * is submitted together with the next io_uring_enter()
+         */
+
+        if (ngx_io_uring_read_file(ev, file->fd, buf, size, offset)
+            != NGX_OK)
+        {
+            return ngx_read_file(file, buf, size, offset);
+        }
+
+        ev->active = 1;
+        ev->ready = 0;
+        ev->complete = 0;
+
+        return NGX_AGAIN;
+    }
+
+#endif
+
     ngx_memzero(&aio->aiocb, sizeof(struct iocb));
 
     aio->aiocb.aio_data = (uint64_t) (uintptr_t) ev;
@@ -104,8 +130,6 @@ ngx_file_aio_read(ngx_file_t *file, u_char *buf, size_t size, off_t offset,
     aio->aiocb.aio_flags = IOCB_FLAG_RESFD;
     aio->aiocb.aio_resfd = ngx_eventfd;
 
-    ev->handler = ngx_file_aio_event_handler;
-
     piocb[0] = &aio->aiocb;
 
     if (io_submit(ngx_aio_ctx, 1, piocb) == 1) {
@@ -726,7 +726,8 @@ ngx_reap_children(ngx_cycle_t *cycle)
 static void
 ngx_master_process_exit(ngx_cycle_t *cycle)
 {
-    ngx_uint_t  i;
+    ngx_uint_t    i;
+    ngx_path_t  **path;
 
     ngx_delete_pidfile(cycle);
 
@@ -738,6 +739,16 @@ ngx_master_process_exit(ngx_cycle_t *cycle)
         }
     }
 
+    /* all processes have exited, so paths may save their state */
+
+    path = cycle->paths.elts;
+    for (i = 0; i < cycle->paths.nelts; i++) {
+
+        if (path[i]->saver) {
+            path[i]->saver(path[i]->data);
+        }
+    }
+
     ngx_close_listening_sockets(cycle);
 
     /*
@@ -885,6 +896,8 @@ ngx_worker_process_init(ngx_cycle_t *cycle, ngx_int_t worker)
         }
     }
 
+    ngx_pool_cache_init(ccf->pool_cache);
+
     // 设置unix运行的group/user
     if (geteuid() == 0) {
         if (setgid(ccf->group) == -1) {
@@ -45,6 +45,9 @@ namespace TinySTL{
 		static char *chunk_alloc(size_t size, size_t& nobjs);
 
 	public:
+		//ÿallocateʱֽãProfilerͳƷĬΪ
+		static void(*allocate_hook)(size_t bytes);
+
 		static void *allocate(size_t bytes);
 		static void deallocate(void *ptr, size_t bytes);
 		static void *reallocate(void *ptr, size_t old_sz, size_t new_sz);
@@ -6,6 +6,8 @@
 
 #include <cassert>
 #include <new>
+#include <type_traits>
+#include <utility>
 
 namespace TinySTL{
 
@@ -22,18 +24,41 @@ namespace TinySTL{
 		typedef const T&	const_reference;
 		typedef size_t		size_type;
 		typedef ptrdiff_t	difference_type;
+		template<class U>
+		struct rebind{ typedef allocator<U> other; };
 	public:
+		//û״̬еʵֻΪ˺״̬ķ(polymorphic_allocator)ʹͬд
+		allocator(){}
+		template<class U>
+		allocator(const allocator<U>&){}
+		allocator select_on_container_copy_construction()const{ return *this; }
+
 		static T *allocate();
 		static T *allocate(size_t n);
 		static void deallocate(T *ptr);
 		static void deallocate(T *ptr, size_t n);
+		//nԪشСڴΪnewNԭݰֽڱֻڿ԰ֽڰᶯԪ
+		static T *reallocate(T *ptr, size_t n, size_t newN);
 
 		static void construct(T *ptr);
 		static void construct(T *ptr, const T& value);
+		template<class... Args>
+		static void construct(T *ptr, Args&&... args);
 		static void destroy(T *ptr);
 		static void destroy(T *first, T *last);
 	};
 
+	//ǷṩreallocatevectorʱԽԭչڴذᶯԪ
+	template<class Alloc>
+	struct can_reallocate : std::false_type{};
+	template<class T>
+	struct can_reallocate<allocator<T>> : std::true_type{};
+
+	template<class T1, class T2>
+	bool operator ==(const allocator<T1>&, const allocator<T2>&){ return true; }
+	template<class T1, class T2>
+	bool operator !=(const allocator<T1>&, const allocator<T2>&){ return false; }
+
 	template<class T>
 	T *allocator<T>::allocate(){
 		return static_cast<T *>(alloc::allocate(sizeof(T)));
@@ -52,6 +77,16 @@ namespace TinySTL{
 		if (n == 0) return;
 		alloc::deallocate(static_cast<void *>(ptr), sizeof(T)* n);
 	}
+	template<class T>
+	T *allocator<T>::reallocate(T *ptr, size_t n, size_t newN){
+		if (n == 0)
+			return allocate(newN);
+		if (newN == 0){
+			deallocate(ptr, n);
+			return 0;
+		}
+		return static_cast<T *>(alloc::reallocate(static_cast<void *>(ptr), sizeof(T) * n, sizeof(T) * newN));
+	}
 
 	template<class T>
 	void allocator<T>::construct(T *ptr){
@@ -62,6 +97,11 @@ namespace TinySTL{
 		new(ptr)T(value);
 	}
 	template<class T>
+	template<class... Args>
+	void allocator<T>::construct(T *ptr, Args&&... args){
+		new(ptr)T(std::forward<Args>(args)...);
+	}
+	template<class T>
 	void allocator<T>::destroy(T *ptr){
 		ptr->~T();
 	}
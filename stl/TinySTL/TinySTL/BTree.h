@@ -0,0 +1,297 @@
+#ifndef _BTREE_H_
+#define _BTREE_H_
+
+#include "Allocator.h"
+#include "Functional.h"
+#include "Iterator.h"
+#include "Utility.h"
+#include "Vector.h"
+
+#include <cassert>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace TinySTL{
+	namespace Detail{
+		//ÿڵռ4cache lineһβÿֻкٵļcache miss
+		enum { btree_node_bytes = 256 };
+
+		template<size_t Bytes, size_t Header, size_t PerSlot>
+		struct btree_slots{
+			enum { value = (Bytes - Header) / PerSlot < 4 ? 4 : (Bytes - Header) / PerSlot };
+		};
+
+		template<class T>
+		struct btree_identity{
+			const T& operator ()(const T& x)const{ return x; }
+		};
+		template<class Pair>
+		struct btree_select1st{
+			const typename Pair::first_type& operator ()(const Pair& x)const{ return x.first; }
+		};
+
+		//B+ֵֻҶҶ֮˫
+		//ڲڵֻŷָkeychildren_[i]еkey >= keys[i - 1]  < keys[i]
+		struct btree_node{
+			bool leaf_;
+			unsigned short count_;
+		};
+		template<class Value>
+		struct btree_leaf : public btree_node{
+			enum { capacity = btree_slots<btree_node_bytes, 3 * sizeof(void *), sizeof(Value)>::value };
+
+			btree_leaf *prev_;
+			btree_leaf *next_;
+			typename std::aligned_storage<sizeof(Value), std::alignment_of<Value>::value>::type values_[capacity];
+
+			Value *value(size_t i){ return reinterpret_cast<Value *>(values_ + i); }
+		};
+		template<class Key>
+		struct btree_inner : public btree_node{
+			enum { capacity = btree_slots<btree_node_bytes, 2 * sizeof(void *), sizeof(Key)+sizeof(void *)>::value };
+
+			typename std::aligned_storage<sizeof(Key), std::alignment_of<Key>::value>::type keys_[capacity];
+			btree_node *children_[capacity + 1];
+
+			Key *key(size_t i){ return reinterpret_cast<Key *>(keys_ + i); }
+		};
+
+		//the iterator of btree
+		//(Ҷ, ±)end()(Ҷ, count_)
+		//ɾƶԪأʹеʧЧ
+		template<class Value, class Ref, class Ptr>
+		class btree_iterator : public iterator<bidirectional_iterator_tag, Value>{
+		public:
+			typedef btree_leaf<Value> leaf_type;
+			typedef btree_iterator<Value, Value&, Value*> plain_iterator;
+
+			leaf_type *leaf_;
+			size_t pos_;
+		public:
+			btree_iterator() :leaf_(0), pos_(0){}
+			btree_iterator(leaf_type *leaf, size_t pos) :leaf_(leaf), pos_(pos){}
+			btree_iterator(const plain_iterator& it) :leaf_(it.leaf_), pos_(it.pos_){}
+
+			Ref operator *()const{ return *leaf_->value(pos_); }
+			Ptr operator ->()const{ return &(operator*()); }
+
+			btree_iterator& operator ++(){
+				if (++pos_ == leaf_->count_ && leaf_->next_){
+					leaf_ = leaf_->next_;
+					pos_ = 0;
+				}
+				return *this;
+			}
+			btree_iterator operator ++(int){
+				btree_iterator temp = *this;
+				++*this;
+				return temp;
+			}
+			btree_iterator& operator --(){
+				if (pos_ == 0){
+					leaf_ = leaf_->prev_;
+					pos_ = leaf_->count_;
+				}
+				--pos_;
+				return *this;
+			}
+			btree_iterator operator --(int){
+				btree_iterator temp = *this;
+				--*this;
+				return temp;
+			}
+			bool operator ==(const btree_iterator& it)const{ return leaf_ == it.leaf_ && pos_ == it.pos_; }
+			bool operator !=(const btree_iterator& it)const{ return !(*this == it); }
+		};
+
+		//btree_setbtree_mapõʵ֣keyΨһ
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		class btree{
+		public:
+			typedef Key			key_type;
+			typedef Value		value_type;
+			typedef size_t		size_type;
+			typedef btree_iterator<Value, Value&, Value*> iterator;
+			typedef btree_iterator<Value, const Value&, const Value*> const_iterator;
+		private:
+			typedef btree_leaf<Value> leaf;
+			typedef btree_inner<Key> inner;
+			typedef allocator<leaf> leafAllocator;
+			typedef allocator<inner> innerAllocator;
+
+			enum { leaf_min = leaf::capacity / 2, inner_min = inner::capacity / 2 };
+			enum { max_height = 64 };
+
+			btree_node *root_;
+			leaf *leftmost_;
+			leaf *rightmost_;
+			size_type size_;
+			mutable Compare comp_;
+		public:
+			explicit btree(const Compare& comp = Compare());
+			btree(const btree& bt);
+			btree(btree&& bt);
+			btree& operator = (const btree& bt);
+			btree& operator = (btree&& bt);
+			~btree(){ clear(); }
+
+			iterator begin(){ return iterator(leftmost_, 0); }
+			iterator end(){ return iterator(rightmost_, rightmost_ ? rightmost_->count_ : 0); }
+			const_iterator begin()const{ return const_iterator(leftmost_, 0); }
+			const_iterator end()const{ return const_iterator(rightmost_, rightmost_ ? rightmost_->count_ : 0); }
+
+			size_type size()const{ return size_; }
+			bool empty()const{ return size_ == 0; }
+			size_type height()const;
+			size_type memory_usage()const;//нڵռõֽ
+
+			iterator find(const Key& k);
+			iterator lower_bound(const Key& k);
+			iterator upper_bound(const Key& k);
+
+			pair<iterator, bool> insert_unique(const Value& val);
+			size_type erase_unique(const Key& k);
+			void clear();
+			void swap(btree& bt);
+
+			//ظ[first, last)ԵϹÿڵ㶼
+			template<class ForwardIterator>
+			void bulk_load(ForwardIterator first, ForwardIterator last);
+		private:
+			static const Key& key_of(const Value& val){ return KeyOfValue()(val); }
+			static const Key& min_key(btree_node *n);
+			leaf *descend(const Key& k, inner **path, size_t *slot, size_t& depth)const;
+			size_t leaf_lower(leaf *l, const Key& k)const;
+			size_t leaf_upper(leaf *l, const Key& k)const;
+			size_t inner_upper(inner *n, const Key& k)const;
+			iterator normalize(leaf *l, size_t pos);
+
+			leaf *create_leaf();
+			inner *create_inner();
+			void destroy_node(btree_node *n);
+			void unlink_leaf(leaf *l);
+
+			void leaf_insert(leaf *l, size_t pos, const Value& val);
+			void leaf_erase(leaf *l, size_t pos);
+			void leaf_move(leaf *from, size_t first, size_t last, leaf *to);
+			void inner_insert(inner *n, size_t i, const Key& k, btree_node *child);
+			void inner_erase(inner *n, size_t i);
+			void insert_into_parent(inner **path, size_t *slot, size_t depth, Key sep, btree_node *right);
+			void rebalance_leaf(leaf *l, inner *parent, size_t i);
+			void rebalance_inner(inner *n, inner *parent, size_t i);
+			size_type count_nodes(btree_node *n, size_type& leaves)const;
+		};
+	}//end of Detail namespace
+
+	//the class of btree_set
+	template<class Key, class Compare = less<Key>>
+	class btree_set{
+	private:
+		typedef Detail::btree<Key, Key, Detail::btree_identity<Key>, Compare> tree_type;
+		tree_type tree_;
+	public:
+		typedef Key			key_type;
+		typedef Key			value_type;
+		typedef Compare		key_compare;
+		typedef size_t		size_type;
+		typedef typename tree_type::const_iterator iterator;
+		typedef typename tree_type::const_iterator const_iterator;
+	public:
+		explicit btree_set(const Compare& comp = Compare()) :tree_(comp){}
+		template<class InputIterator>
+		btree_set(InputIterator first, InputIterator last){ insert(first, last); }
+
+		iterator begin()const{ return tree_.begin(); }
+		iterator end()const{ return tree_.end(); }
+		size_type size()const{ return tree_.size(); }
+		bool empty()const{ return tree_.empty(); }
+		size_type height()const{ return tree_.height(); }
+		size_type memory_usage()const{ return tree_.memory_usage(); }
+
+		iterator find(const Key& k)const{ return const_cast<tree_type&>(tree_).find(k); }
+		size_type count(const Key& k)const{ return find(k) == end() ? 0 : 1; }
+		iterator lower_bound(const Key& k)const{ return const_cast<tree_type&>(tree_).lower_bound(k); }
+		iterator upper_bound(const Key& k)const{ return const_cast<tree_type&>(tree_).upper_bound(k); }
+
+		pair<iterator, bool> insert(const Key& k){
+			pair<typename tree_type::iterator, bool> res = tree_.insert_unique(k);
+			return pair<iterator, bool>(res.first, res.second);
+		}
+		template<class InputIterator>
+		void insert(InputIterator first, InputIterator last){
+			for (; first != last; ++first)
+				tree_.insert_unique(*first);
+		}
+		size_type erase(const Key& k){ return tree_.erase_unique(k); }
+		void erase(iterator it){ tree_.erase_unique(*it); }
+		void clear(){ tree_.clear(); }
+		void swap(btree_set& bs){ tree_.swap(bs.tree_); }
+		template<class ForwardIterator>
+		void bulk_load(ForwardIterator first, ForwardIterator last){ tree_.bulk_load(first, last); }
+	};//end of btree_set
+
+	//the class of btree_map
+	template<class Key, class T, class Compare = less<Key>>
+	class btree_map{
+	public:
+		typedef Key					key_type;
+		typedef T					mapped_type;
+		typedef pair<const Key, T>	value_type;
+		typedef Compare				key_compare;
+		typedef size_t				size_type;
+	private:
+		typedef Detail::btree<Key, value_type, Detail::btree_select1st<value_type>, Compare> tree_type;
+		tree_type tree_;
+	public:
+		typedef typename tree_type::iterator iterator;
+		typedef typename tree_type::const_iterator const_iterator;
+	public:
+		explicit btree_map(const Compare& comp = Compare()) :tree_(comp){}
+		template<class InputIterator>
+		btree_map(InputIterator first, InputIterator last){ insert(first, last); }
+
+		iterator begin(){ return tree_.begin(); }
+		iterator end(){ return tree_.end(); }
+		const_iterator begin()const{ return tree_.begin(); }
+		const_iterator end()const{ return tree_.end(); }
+		size_type size()const{ return tree_.size(); }
+		bool empty()const{ return tree_.empty(); }
+		size_type height()const{ return tree_.height(); }
+		size_type memory_usage()const{ return tree_.memory_usage(); }
+
+		iterator find(const Key& k){ return tree_.find(k); }
+		size_type count(const Key& k){ return find(k) == end() ? 0 : 1; }
+		iterator lower_bound(const Key& k){ return tree_.lower_bound(k); }
+		iterator upper_bound(const Key& k){ return tree_.upper_bound(k); }
+
+		T& operator [](const Key& k){
+			iterator it = find(k);
+			if (it == end())
+				it = tree_.insert_unique(value_type(k, T())).first;
+			return it->second;
+		}
+		T& at(const Key& k){
+			iterator it = find(k);
+			if (it == end())
+				throw std::out_of_range("btree_map::at");
+			return it->second;
+		}
+
+		pair<iterator, bool> insert(const value_type& val){ return tree_.insert_unique(val); }
+		template<class InputIterator>
+		void insert(InputIterator first, InputIterator last){
+			for (; first != last; ++first)
+				tree_.insert_unique(*first);
+		}
+		size_type erase(const Key& k){ return tree_.erase_unique(k); }
+		void erase(iterator it){ tree_.erase_unique(it->first); }
+		void clear(){ tree_.clear(); }
+		void swap(btree_map& bm){ tree_.swap(bm.tree_); }
+		template<class ForwardIterator>
+		void bulk_load(ForwardIterator first, ForwardIterator last){ tree_.bulk_load(first, last); }
+	};//end of btree_map
+}
+
+#include "Detail\BTree.impl.h"
+#endif
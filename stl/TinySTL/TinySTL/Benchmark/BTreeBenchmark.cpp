@@ -0,0 +1,152 @@
+#include "BTreeBenchmark.h"
+
+#include <cstdlib>
+
+namespace TinySTL{
+	namespace BTreeBenchmark{
+		using namespace TinySTL::Profiler;
+
+		size_t allocated::bytes = 0;
+
+		namespace{
+			const int count = 1000000;
+			const int lookups = 2000000;
+			const int scans = 10000, scanLength = 1000;
+
+			void dump(const char *name){
+				std::cout << "  " << name << ": " << ProfilerInstance::millisecond() << " ms" << std::endl;
+			}
+			std::vector<int> randomKeys(int n, unsigned seed){
+				std::vector<int> keys(n);
+				srand(seed);
+				for (int i = 0; i != n; ++i)
+					keys[i] = (rand() << 15) ^ rand();
+				return keys;
+			}
+			template<class Map>
+			void fill(Map& m, const std::vector<int>& keys){
+				for (size_t i = 0; i != keys.size(); ++i)
+					m[keys[i]] = (int)i;
+			}
+		}
+
+		void benchCase1(){
+			std::cout << "random insert, " << count << " keys" << std::endl;
+			std::vector<int> keys = randomKeys(count, 1);
+			{
+				rbMap m;
+				ProfilerInstance::start();
+				fill(m, keys);
+				ProfilerInstance::finish();
+				dump("std::map");
+			}
+			{
+				btMap m;
+				ProfilerInstance::start();
+				fill(m, keys);
+				ProfilerInstance::finish();
+				dump("TinySTL::btree_map");
+			}
+		}
+		void benchCase2(){
+			std::cout << "random lookup, " << lookups << " finds over " << count << " keys" << std::endl;
+			std::vector<int> keys = randomKeys(count, 1);
+			std::vector<int> probes = randomKeys(lookups, 2);
+			for (int i = 0; i < lookups; i += 2)
+				probes[i] = keys[i % count];//һ
+			rbMap m1;
+			btMap m2;
+			fill(m1, keys);
+			fill(m2, keys);
+
+			size_t hit = 0;
+			ProfilerInstance::start();
+			for (int i = 0; i != lookups; ++i)
+				hit += m1.find(probes[i]) != m1.end();
+			ProfilerInstance::finish();
+			dump("std::map");
+
+			ProfilerInstance::start();
+			for (int i = 0; i != lookups; ++i)
+				hit += m2.find(probes[i]) != m2.end();
+			ProfilerInstance::finish();
+			dump("TinySTL::btree_map");
+			std::cout << "  (" << hit << ")" << std::endl;
+		}
+		void benchCase3(){
+			std::cout << "range scan, " << scans << " x " << scanLength << " keys from lower_bound" << std::endl;
+			std::vector<int> keys = randomKeys(count, 1);
+			std::vector<int> starts = randomKeys(scans, 3);
+			rbMap m1;
+			btMap m2;
+			fill(m1, keys);
+			fill(m2, keys);
+
+			long long sum = 0;
+			ProfilerInstance::start();
+			for (int i = 0; i != scans; ++i){
+				auto it = m1.lower_bound(starts[i]);
+				for (int j = 0; j != scanLength && it != m1.end(); ++j, ++it)
+					sum += it->second;
+			}
+			ProfilerInstance::finish();
+			dump("std::map");
+
+			ProfilerInstance::start();
+			for (int i = 0; i != scans; ++i){
+				auto it = m2.lower_bound(starts[i]);
+				for (int j = 0; j != scanLength && it != m2.end(); ++j, ++it)
+					sum += it->second;
+			}
+			ProfilerInstance::finish();
+			dump("TinySTL::btree_map");
+			std::cout << "  (" << sum << ")" << std::endl;
+		}
+		void benchCase4(){
+			std::cout << "sorted input, " << count << " keys" << std::endl;
+			std::vector<TinySTL::pair<const int, int>> sorted;
+			for (int i = 0; i != count; ++i)
+				sorted.push_back(TinySTL::pair<const int, int>(i * 2, i));
+			{
+				size_t before = allocated::bytes;
+				rbMap m;
+				ProfilerInstance::start();
+				for (int i = 0; i != count; ++i)
+					m.insert(m.end(), std::make_pair(i * 2, i));
+				ProfilerInstance::finish();
+				dump("std::map hinted insert");
+				std::cout << "    memory: " << (allocated::bytes - before) / 1024 << " KB" << std::endl;
+			}
+			{
+				btMap m;
+				ProfilerInstance::start();
+				for (int i = 0; i != count; ++i)
+					m.insert(sorted[i]);
+				ProfilerInstance::finish();
+				dump("TinySTL::btree_map insert");
+				std::cout << "    memory: " << m.memory_usage() / 1024 << " KB, height " << m.height() << std::endl;
+			}
+			{
+				btMap m;
+				ProfilerInstance::start();
+				m.bulk_load(sorted.begin(), sorted.end());
+				ProfilerInstance::finish();
+				dump("TinySTL::btree_map bulk_load");
+				std::cout << "    memory: " << m.memory_usage() / 1024 << " KB, height " << m.height() << std::endl;
+			}
+			{
+				std::vector<int> keys = randomKeys(count, 1);
+				btMap m;
+				fill(m, keys);
+				std::cout << "  random-order btree_map memory: " << m.memory_usage() / 1024 << " KB" << std::endl;
+			}
+		}
+
+		void benchAllCases(){
+			benchCase1();
+			benchCase2();
+			benchCase3();
+			benchCase4();
+		}
+	}
+}
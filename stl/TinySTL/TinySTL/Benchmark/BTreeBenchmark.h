@@ -0,0 +1,50 @@
+#ifndef _BTREE_BENCHMARK_H_
+#define _BTREE_BENCHMARK_H_
+
+#include "../Profiler/Profiler.h"
+#include "../BTree.h"
+
+#include <iostream>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace TinySTL{
+	namespace BTreeBenchmark{
+		//ͳstd::mapֽ
+		struct allocated{
+			static size_t bytes;
+		};
+		template<class T>
+		struct counting_allocator : public std::allocator<T>{
+			template<class U>
+			struct rebind{ typedef counting_allocator<U> other; };
+
+			counting_allocator(){}
+			template<class U>
+			counting_allocator(const counting_allocator<U>&){}
+
+			T *allocate(size_t n){
+				allocated::bytes += n * sizeof(T);
+				return std::allocator<T>::allocate(n);
+			}
+			void deallocate(T *p, size_t n){
+				allocated::bytes -= n * sizeof(T);
+				std::allocator<T>::deallocate(p, n);
+			}
+		};
+
+		//std::map(_Rb_tree)
+		typedef std::map<int, int, std::less<int>, counting_allocator<std::pair<const int, int>>> rbMap;
+		typedef TinySTL::btree_map<int, int> btMap;
+
+		void benchCase1();//
+		void benchCase2();//
+		void benchCase3();//ɨ
+		void benchCase4();//룺 vs bulk_loadԼڴռ
+
+		void benchAllCases();
+	}
+}
+
+#endif
@@ -0,0 +1,187 @@
+#include "BitmapBenchmark.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+
+namespace TinySTL{
+	namespace BitmapBenchmark{
+		using namespace TinySTL::Profiler;
+
+		namespace{
+			const int rounds = 1000;
+			//ÿλһ1
+			const size_t densities[] = { 1000, 64, 2 };
+			const uint32_t universe = 1 << 24;
+
+			void dump(const char *name){
+				std::cout << "    " << name << ": " << ProfilerInstance::millisecond() << " ms" << std::endl;
+			}
+			void dump(const char *name, size_t bytes){
+				std::cout << "    " << name << ": " << ProfilerInstance::millisecond() << " ms, "
+					<< bytes << " bytes" << std::endl;
+			}
+			void title(const char *name, size_t density){
+				std::cout << name << ", 1 in " << density << " bits set" << std::endl;
+			}
+			uint32_t randomIndex(){
+				return (uint32_t(rand()) << 15) ^ uint32_t(rand());
+			}
+			//ͬʱmapͬλ
+			void fill(stdBitset& sb, tsBitmap& tb, tsDBitmap& db, size_t density, unsigned seed){
+				srand(seed);
+				for (size_t i = 0; i != bits / density; ++i){
+					size_t pos = randomIndex() % bits;
+					sb.set(pos);
+					tb.set(pos);
+					db.set(pos);
+				}
+			}
+		}
+
+		void benchCase1(){
+			std::unique_ptr<stdBitset> sb(new stdBitset);
+			tsBitmap tb;
+			tsDBitmap db(bits);
+			fill(*sb, tb, db, 2, 1);
+			size_t sum = 0;
+			title("count/any/flip", 2);
+			ProfilerInstance::start();
+			for (int i = 0; i != rounds; ++i){
+				sum += sb->count() + sb->any();
+				sb->flip();
+			}
+			ProfilerInstance::finish();
+			dump("std::bitset");
+			ProfilerInstance::start();
+			for (int i = 0; i != rounds; ++i){
+				sum += tb.count() + tb.any();
+				tb.flip();
+			}
+			ProfilerInstance::finish();
+			dump("TinySTL::bitmap");
+			ProfilerInstance::start();
+			for (int i = 0; i != rounds; ++i){
+				sum += db.count() + db.any();
+				db.flip();
+			}
+			ProfilerInstance::finish();
+			dump("TinySTL::dynamic_bitmap");
+			std::cout << "    (" << sum << ")" << std::endl;
+		}
+		void benchCase2(){
+			std::unique_ptr<stdBitset> sb1(new stdBitset), sb2(new stdBitset);
+			tsBitmap tb1, tb2;
+			tsDBitmap db1(bits), db2(bits);
+			fill(*sb1, tb1, db1, 2, 2);
+			fill(*sb2, tb2, db2, 2, 3);
+			title("and/or/xor/andnot", 2);
+			ProfilerInstance::start();
+			for (int i = 0; i != rounds; ++i){
+				*sb1 &= *sb2; *sb1 |= *sb2; *sb1 ^= *sb2; *sb1 &= ~*sb2;
+			}
+			ProfilerInstance::finish();
+			dump("std::bitset");
+			ProfilerInstance::start();
+			for (int i = 0; i != rounds; ++i){
+				tb1 &= tb2; tb1 |= tb2; tb1 ^= tb2; tb1.and_not(tb2);
+			}
+			ProfilerInstance::finish();
+			dump("TinySTL::bitmap");
+			ProfilerInstance::start();
+			for (int i = 0; i != rounds; ++i){
+				db1 &= db2; db1 |= db2; db1 ^= db2; db1.and_not(db2);
+			}
+			ProfilerInstance::finish();
+			dump("TinySTL::dynamic_bitmap");
+			std::cout << "    (" << sb1->count() + tb1.count() + db1.count() << ")" << std::endl;
+		}
+		void benchCase3(){
+			for (size_t d = 0; d != sizeof(densities) / sizeof(densities[0]); ++d){
+				std::unique_ptr<stdBitset> sb(new stdBitset);
+				tsBitmap tb;
+				tsDBitmap db(bits);
+				fill(*sb, tb, db, densities[d], 4);
+				title("iterate set bits", densities[d]);
+				size_t sum = 0;
+				ProfilerInstance::start();
+				for (int r = 0; r != rounds / 10; ++r){
+					for (size_t i = 0; i != bits; ++i)
+						if (sb->test(i)) sum += i;
+				}
+				ProfilerInstance::finish();
+				dump("std::bitset test");
+				ProfilerInstance::start();
+				for (int r = 0; r != rounds / 10; ++r){
+					for (size_t i = tb.find_first(); i != tb.size(); i = tb.find_next(i))
+						sum += i;
+				}
+				ProfilerInstance::finish();
+				dump("TinySTL::bitmap find_next");
+				ProfilerInstance::start();
+				for (int r = 0; r != rounds / 10; ++r){
+					for (size_t i = db.find_first(); i != db.size(); i = db.find_next(i))
+						sum += i;
+				}
+				ProfilerInstance::finish();
+				dump("TinySTL::dynamic_bitmap find_next");
+				std::cout << "    (" << sum << ")" << std::endl;
+			}
+		}
+		void benchCase4(){
+			for (size_t d = 0; d != sizeof(densities) / sizeof(densities[0]); ++d){
+				title("sets in [0, 2^24)", densities[d]);
+				std::vector<uint32_t> v1, v2;
+				srand(5);
+				for (uint32_t i = 0; i != universe / densities[d]; ++i){
+					v1.push_back(randomIndex() % universe);
+					v2.push_back(randomIndex() % universe);
+				}
+				std::sort(v1.begin(), v1.end());
+				v1.erase(std::unique(v1.begin(), v1.end()), v1.end());
+				std::sort(v2.begin(), v2.end());
+				v2.erase(std::unique(v2.begin(), v2.end()), v2.end());
+
+				size_t sum = 0;
+				{
+					std::vector<uint32_t> out;
+					ProfilerInstance::start();
+					std::set_intersection(v1.begin(), v1.end(), v2.begin(), v2.end(), std::back_inserter(out));
+					ProfilerInstance::finish();
+					dump("sorted std::vector intersection", (v1.size() + v2.size()) * sizeof(uint32_t));
+					sum += out.size();
+				}
+				{
+					tsDBitmap b1(universe), b2(universe);
+					for (size_t i = 0; i != v1.size(); ++i) b1.set(v1[i]);
+					for (size_t i = 0; i != v2.size(); ++i) b2.set(v2[i]);
+					ProfilerInstance::start();
+					b1 &= b2;
+					sum += b1.count();
+					ProfilerInstance::finish();
+					dump("TinySTL::dynamic_bitmap &= and count", universe / 8 * 2);
+				}
+				{
+					ProfilerInstance::start();
+					tsRoaring r1(v1.begin(), v1.end()), r2(v2.begin(), v2.end());
+					ProfilerInstance::finish();
+					dump("TinySTL::roaring_bitmap build");
+					ProfilerInstance::start();
+					r1 &= r2;
+					sum += r1.size();
+					ProfilerInstance::finish();
+					dump("TinySTL::roaring_bitmap &=", tsRoaring(v1.begin(), v1.end()).bytes() + r2.bytes());
+				}
+				std::cout << "    (" << sum << ")" << std::endl;
+			}
+		}
+
+		void benchAllCases(){
+			benchCase1();
+			benchCase2();
+			benchCase3();
+			benchCase4();
+		}
+	}
+}
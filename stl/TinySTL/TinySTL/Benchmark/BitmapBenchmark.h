@@ -0,0 +1,28 @@
+#ifndef _BITMAP_BENCHMARK_H_
+#define _BITMAP_BENCHMARK_H_
+
+#include "../Profiler/Profiler.h"
+#include "../Bitmap.h"
+
+#include <bitset>
+#include <iostream>
+#include <vector>
+
+namespace TinySTL{
+	namespace BitmapBenchmark{
+		enum { bits = 1 << 20 };
+		typedef std::bitset<bits> stdBitset;
+		typedef TinySTL::bitmap<bits> tsBitmap;
+		typedef TinySTL::dynamic_bitmap tsDBitmap;
+		typedef TinySTL::roaring_bitmap tsRoaring;
+
+		void benchCase1();//2^20λϵcountanyflip
+		void benchCase2();//2^20λmap֮롢
+		void benchCase3();//ͬܶ±Ϊ1λ
+		void benchCase4();//2^24Χڵļϣռֽ󽻣Ƚ
+
+		void benchAllCases();
+	}
+}
+
+#endif
@@ -0,0 +1,206 @@
+#include "ConcurrentCircularBufferBenchmark.h"
+
+namespace TinySTL{
+	namespace ConcurrentCircularBufferBenchmark{
+		using namespace TinySTL::Profiler;
+
+		namespace{
+			const int messages = 10000000;
+			const int roundTrips = 1000000;
+
+			void pinTo(int cpu){
+				if (cpu < 0)
+					return;
+				unsigned ncpu = std::thread::hardware_concurrency();
+				if (ncpu != 0 && (unsigned)cpu >= ncpu)
+					cpu %= ncpu;
+			#ifdef WIN32
+				SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu);
+			#else
+				cpu_set_t set;
+				CPU_ZERO(&set);
+				CPU_SET(cpu, &set);
+				pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+			#endif
+			}
+			std::vector<placement> placements(){
+				int far = (int)std::thread::hardware_concurrency() / 2;
+				std::vector<placement> res;
+				placement none = { "unpinned", -1, -1 };
+				placement same = { "same cpu", 0, 0 };
+				placement near = { "cpu 0/1", 0, 1 };
+				placement distant = { "cpu 0/n/2", 0, far };
+				res.push_back(none);
+				res.push_back(same);
+				res.push_back(near);
+				if (far > 1)
+					res.push_back(distant);
+				return res;
+			}
+			void dump(const char *name, int count){
+				double ms = ProfilerInstance::millisecond();
+				std::cout << "    " << name << ": " << ms << " ms, "
+					<< count / ms / 1000 << " M msg/s" << std::endl;
+			}
+
+			//mutex + std::dequeĻ׼ʵ
+			class locked_queue{
+			private:
+				std::mutex mtx_;
+				std::deque<int> data_;
+			public:
+				bool try_push(int val){
+					std::lock_guard<std::mutex> lock(mtx_);
+					if (data_.size() == 1024)
+						return false;
+					data_.push_back(val);
+					return true;
+				}
+				bool try_pop(int& val){
+					std::lock_guard<std::mutex> lock(mtx_);
+					if (data_.empty())
+						return false;
+					val = data_.front();
+					data_.pop_front();
+					return true;
+				}
+			};
+
+			template<class Queue>
+			long long runSingle(Queue& q, const placement& p){
+				long long sum = 0;
+				std::thread producer([&]{
+					pinTo(p.producerCpu);
+					for (int i = 0; i != messages; ++i){
+						while (!q.try_push(i))
+							std::this_thread::yield();
+					}
+				});
+				pinTo(p.consumerCpu);
+				for (int i = 0; i != messages; ++i){
+					int val;
+					while (!q.try_pop(val))
+						std::this_thread::yield();
+					sum += val;
+				}
+				producer.join();
+				return sum;
+			}
+			template<class Queue>
+			long long runBatch(Queue& q, const placement& p){
+				const int batch = 64;
+				long long sum = 0;
+				std::thread producer([&]{
+					pinTo(p.producerCpu);
+					int buf[batch];
+					for (int i = 0; i != messages; i += batch){
+						for (int j = 0; j != batch; ++j)
+							buf[j] = i + j;
+						q.push_n(buf, batch);
+					}
+				});
+				pinTo(p.consumerCpu);
+				int buf[batch];
+				for (int got = 0; got < messages;){
+					size_t n = q.try_pop_n(buf, batch);
+					if (n == 0)
+						std::this_thread::yield();
+					for (size_t j = 0; j != n; ++j)
+						sum += buf[j];
+					got += (int)n;
+				}
+				producer.join();
+				return sum;
+			}
+		}
+
+		void benchCase1(){
+			std::cout << "spsc throughput, " << messages << " ints" << std::endl;
+			std::vector<placement> ps = placements();
+			long long total = 0;
+			for (auto& p : ps){
+				std::cout << "  " << p.name << std::endl;
+				{
+					locked_queue q;
+					ProfilerInstance::start();
+					total += runSingle(q, p);
+					ProfilerInstance::finish();
+					dump("mutex + std::deque", messages);
+				}
+				{
+					spsc_circular_buffer<int, 1024> q;
+					ProfilerInstance::start();
+					total += runSingle(q, p);
+					ProfilerInstance::finish();
+					dump("spsc try_push/try_pop", messages);
+				}
+				{
+					spsc_circular_buffer<int, 1024> q;
+					ProfilerInstance::start();
+					total += runBatch(q, p);
+					ProfilerInstance::finish();
+					dump("spsc push_n/try_pop_n(64)", messages);
+				}
+				pinTo(-1);
+			}
+			std::cout << "  (" << total << ")" << std::endl;
+		}
+		void benchCase2(){
+			std::cout << "spsc round trip latency, " << roundTrips << " ping-pongs" << std::endl;
+			std::vector<placement> ps = placements();
+			for (auto& p : ps){
+				spsc_circular_buffer<int, 64> ping, pong;
+				std::thread echo([&]{
+					pinTo(p.consumerCpu);
+					for (int i = 0; i != roundTrips; ++i){
+						int val;
+						ping.pop(val);
+						pong.push(val);
+					}
+				});
+				pinTo(p.producerCpu);
+				ProfilerInstance::start();
+				for (int i = 0; i != roundTrips; ++i){
+					int val;
+					ping.push(i);
+					pong.pop(val);
+				}
+				ProfilerInstance::finish();
+				echo.join();
+				std::cout << "    " << p.name << ": "
+					<< ProfilerInstance::millisecond() * 1000000 / roundTrips << " ns per round trip" << std::endl;
+			}
+		}
+		void benchCase3(){
+			std::cout << "mpmc throughput, " << messages << " ints" << std::endl;
+			for (int threads = 1; threads <= 4; threads *= 2){
+				mpmc_circular_buffer<int, 1024> q;
+				std::vector<std::thread> workers;
+				const int perThread = messages / threads;
+				ProfilerInstance::start();
+				for (int t = 0; t != threads; ++t){
+					workers.push_back(std::thread([&q, perThread]{
+						for (int i = 0; i != perThread; ++i)
+							q.push(i);
+					}));
+					workers.push_back(std::thread([&q, perThread]{
+						int val;
+						for (int i = 0; i != perThread; ++i)
+							q.pop(val);
+					}));
+				}
+				for (auto& w : workers)
+					w.join();
+				ProfilerInstance::finish();
+				std::cout << "    " << threads << "P/" << threads << "C: " << ProfilerInstance::millisecond() << " ms, "
+					<< perThread * threads / ProfilerInstance::millisecond() / 1000 << " M msg/s" << std::endl;
+			}
+		}
+
+		void benchAllCases(){
+			benchCase1();
+			benchCase2();
+			benchCase3();
+		}
+	}
+}
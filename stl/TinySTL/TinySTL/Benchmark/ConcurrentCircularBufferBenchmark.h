@@ -0,0 +1,37 @@
+#ifndef _CONCURRENT_CIRCULAR_BUFFER_BENCHMARK_H_
+#define _CONCURRENT_CIRCULAR_BUFFER_BENCHMARK_H_
+
+#include "../Profiler/Profiler.h"
+#include "../ConcurrentCircularBuffer.h"
+
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef WIN32
+#include <Windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace TinySTL{
+	namespace ConcurrentCircularBufferBenchmark{
+		///߰󶨵cpu-1ʾ
+		struct placement{
+			const char *name;
+			int producerCpu;
+			int consumerCpu;
+		};
+
+		void benchCase1();//spsc vs  vs mutex+std::dequeͬĺ˰
+		void benchCase2();//spscӳ(ping-pong)ͬĺ˰
+		void benchCase3();//mpmc1~4/
+
+		void benchAllCases();
+	}
+}
+
+#endif
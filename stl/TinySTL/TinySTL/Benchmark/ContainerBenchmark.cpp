@@ -0,0 +1,220 @@
+#include "ContainerBenchmark.h"
+
+#include <cstdlib>
+
+namespace TinySTL{
+	namespace ContainerBenchmark{
+		using namespace TinySTL::Profiler;
+
+		namespace{
+			const int count = 100000;
+
+			Harness& harness(){
+				static Harness h("ContainerBenchmark");
+				return h;
+			}
+			std::vector<int> randomInts(int n, unsigned seed){
+				srand(seed);
+				std::vector<int> v;
+				for (int i = 0; i != n; ++i)
+					v.push_back(int(((unsigned(rand()) << 15) ^ unsigned(rand())) & 0x7fffffff));
+				return v;
+			}
+			//ֻиƹ캯stringvectorʱֻƣ൱ǰ
+			struct CopiedStr{
+				tsStr str;
+				explicit CopiedStr(const char *s) :str(s){}
+				CopiedStr(const CopiedStr& other) :str(other.str){}
+			};
+			const char *title(const char *what){
+				static char buf[128];
+				sprintf(buf, "%s, %d elements", what, count);
+				return buf;
+			}
+		}
+
+		void benchCase1(){
+			Harness& h = harness();
+			std::string group = title("vector push_back");
+			h.run(group, "TinySTL::vector", []{
+				tsVec<int> v;
+				for (int i = 0; i != count; ++i) v.push_back(i);
+				doNotOptimize(v);
+			});
+			h.run(group, "std::vector", []{
+				stdVec<int> v;
+				for (int i = 0; i != count; ++i) v.push_back(i);
+				doNotOptimize(v);
+			});
+
+			tsVec<int> tv(count, 1);
+			stdVec<int> sv(count, 1);
+			group = title("vector copy");
+			h.run(group, "TinySTL::vector", [&tv]{ tsVec<int> v(tv); doNotOptimize(v); });
+			h.run(group, "std::vector", [&sv]{ stdVec<int> v(sv); doNotOptimize(v); });
+
+			auto index = randomInts(count, 1);
+			group = title("vector random read");
+			h.run(group, "TinySTL::vector", [&]{
+				long long sum = 0;
+				for (int i = 0; i != count; ++i) sum += tv[index[i] % count];
+				doNotOptimize(sum);
+			});
+			h.run(group, "std::vector", [&]{
+				long long sum = 0;
+				for (int i = 0; i != count; ++i) sum += sv[index[i] % count];
+				doNotOptimize(sum);
+			});
+		}
+		void benchCase2(){
+			Harness& h = harness();
+			std::string group = title("list push_back/push_front and traverse");
+			h.run(group, "TinySTL::list", []{
+				tsList<int> l;
+				for (int i = 0; i != count; ++i) i % 2 ? l.push_back(i) : l.push_front(i);
+				long long sum = 0;
+				for (auto it = l.begin(); it != l.end(); ++it) sum += *it;
+				doNotOptimize(sum);
+			});
+			h.run(group, "std::list", []{
+				stdList<int> l;
+				for (int i = 0; i != count; ++i) i % 2 ? l.push_back(i) : l.push_front(i);
+				long long sum = 0;
+				for (auto it = l.begin(); it != l.end(); ++it) sum += *it;
+				doNotOptimize(sum);
+			});
+
+			group = title("deque push_back/push_front and traverse");
+			h.run(group, "TinySTL::deque", []{
+				tsDeque<int> d;
+				for (int i = 0; i != count; ++i) i % 2 ? d.push_back(i) : d.push_front(i);
+				long long sum = 0;
+				for (auto it = d.begin(); it != d.end(); ++it) sum += *it;
+				doNotOptimize(sum);
+			});
+			h.run(group, "std::deque", []{
+				stdDeque<int> d;
+				for (int i = 0; i != count; ++i) i % 2 ? d.push_back(i) : d.push_front(i);
+				long long sum = 0;
+				for (auto it = d.begin(); it != d.end(); ++it) sum += *it;
+				doNotOptimize(sum);
+			});
+		}
+		void benchCase3(){
+			Harness& h = harness();
+			std::string group = title("string push_back");
+			h.run(group, "TinySTL::string", []{
+				tsStr s;
+				for (int i = 0; i != count; ++i) s.push_back('a' + i % 26);
+				doNotOptimize(s);
+			});
+			h.run(group, "std::string", []{
+				stdStr s;
+				for (int i = 0; i != count; ++i) s.push_back('a' + i % 26);
+				doNotOptimize(s);
+			});
+
+			group = title("string append 16-char pieces");
+			h.run(group, "TinySTL::string", []{
+				tsStr s;
+				for (int i = 0; i != count / 16; ++i) s.append("0123456789abcdef");
+				doNotOptimize(s);
+			});
+			h.run(group, "std::string", []{
+				stdStr s;
+				for (int i = 0; i != count / 16; ++i) s.append("0123456789abcdef");
+				doNotOptimize(s);
+			});
+		}
+		void benchCase4(){
+			Harness& h = harness();
+			auto data = randomInts(count, 2);
+			std::string group = title("sort random ints");
+			h.run(group, "TinySTL::sort", [&data]{
+				tsVec<int> v(data.data(), data.data() + data.size());
+				TinySTL::sort(v.begin(), v.end());
+				doNotOptimize(v);
+			});
+			h.run(group, "std::sort", [&data]{
+				stdVec<int> v(data.begin(), data.end());
+				std::sort(v.begin(), v.end());
+				doNotOptimize(v);
+			});
+
+			group = title("hash set insert and find");
+			h.run(group, "TinySTL::Unordered_set", [&data]{
+				TinySTL::Unordered_set<int> s(16);
+				for (int i = 0; i != count; ++i) s.insert(data[i]);
+				size_t found = 0;
+				for (int i = 0; i != count; ++i) found += s.count(data[i] + (i & 1));
+				doNotOptimize(found);
+			});
+			h.run(group, "std::unordered_set", [&data]{
+				std::unordered_set<int> s(16);
+				for (int i = 0; i != count; ++i) s.insert(data[i]);
+				size_t found = 0;
+				for (int i = 0; i != count; ++i) found += s.count(data[i] + (i & 1));
+				doNotOptimize(found);
+			});
+
+			group = title("priority_queue push and pop");
+			h.run(group, "TinySTL::priority_queue", [&data]{
+				TinySTL::priority_queue<int> q;
+				for (int i = 0; i != count; ++i) q.push(data[i]);
+				long long sum = 0;
+				while (!q.empty()){ sum += q.top(); q.pop(); }
+				doNotOptimize(sum);
+			});
+			h.run(group, "std::priority_queue", [&data]{
+				std::priority_queue<int> q;
+				for (int i = 0; i != count; ++i) q.push(data[i]);
+				long long sum = 0;
+				while (!q.empty()){ sum += q.top(); q.pop(); }
+				doNotOptimize(sum);
+			});
+		}
+
+		void benchCase5(){
+			Harness& h = harness();
+			//ַĳȣʱҪڴ
+			const char *text = "0123456789abcdefghijklmnopqrstuvwxyz";
+			std::string group = title("vector<string> push_back");
+			h.run(group, "TinySTL::vector relocate", [text]{
+				tsVec<tsStr> v;
+				for (int i = 0; i != count; ++i) v.emplace_back(text);
+				doNotOptimize(v);
+			});
+			h.run(group, "TinySTL::vector copy", [text]{
+				tsVec<CopiedStr> v;
+				for (int i = 0; i != count; ++i) v.emplace_back(text);
+				doNotOptimize(v);
+			});
+			h.run(group, "std::vector", [text]{
+				stdVec<stdStr> v;
+				for (int i = 0; i != count; ++i) v.emplace_back(text);
+				doNotOptimize(v);
+			});
+
+			group = title("deque<string> push_back");
+			h.run(group, "TinySTL::deque", [text]{
+				tsDeque<tsStr> d;
+				for (int i = 0; i != count; ++i) d.emplace_back(text);
+				doNotOptimize(d);
+			});
+			h.run(group, "std::deque", [text]{
+				stdDeque<stdStr> d;
+				for (int i = 0; i != count; ++i) d.emplace_back(text);
+				doNotOptimize(d);
+			});
+		}
+
+		void benchAllCases(){
+			benchCase1();
+			benchCase2();
+			benchCase3();
+			benchCase4();
+			benchCase5();
+			harness().saveJson("ContainerBenchmark.json");
+		}
+	}
+}
@@ -0,0 +1,49 @@
+#ifndef _CONTAINER_BENCHMARK_H_
+#define _CONTAINER_BENCHMARK_H_
+
+#include "../Profiler/Harness.h"
+#include "../Algorithm.h"
+#include "../Deque.h"
+#include "../List.h"
+#include "../Queue.h"
+#include "../String.h"
+#include "../Unordered_set.h"
+#include "../Vector.h"
+
+#include <algorithm>
+#include <deque>
+#include <list>
+#include <queue>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace TinySTL{
+	namespace ContainerBenchmark{
+		template<class T>
+		using stdVec = std::vector < T > ;
+		template<class T>
+		using tsVec = TinySTL::vector < T > ;
+		template<class T>
+		using stdList = std::list < T > ;
+		template<class T>
+		using tsList = TinySTL::list < T > ;
+		template<class T>
+		using stdDeque = std::deque < T > ;
+		template<class T>
+		using tsDeque = TinySTL::deque < T > ;
+		typedef std::string stdStr;
+		typedef TinySTL::string tsStr;
+
+		//ÿcasestd::ӦűȽϣProfiler::HarnessͳƣдContainerBenchmark.json
+		void benchCase1();//vectorpush_back
+		void benchCase2();//listdeque˲롢
+		void benchCase3();//stringַ׷ӡƴ
+		void benchCase4();//sortUnordered_setpriority_queue
+		void benchCase5();//Ԫstringvectordequepush_backȽϰֽڰᶯ
+
+		void benchAllCases();
+	}
+}
+
+#endif
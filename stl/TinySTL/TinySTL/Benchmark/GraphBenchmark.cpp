@@ -0,0 +1,168 @@
+#include "GraphBenchmark.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace TinySTL{
+	namespace GraphBenchmark{
+		using namespace TinySTL::Profiler;
+
+		namespace{
+			typedef tsCSRGraph<unsigned, unsigned> csr_type;
+
+			//2^142^20㣬ÿƽ16
+			const unsigned scales[] = { 14, 18, 20 };
+			const unsigned edgeFactor = 16;
+			//directed_graphӵҪԲңֻúСͼ
+			const unsigned smallScale = 10;
+
+			void dump(const char *name){
+				std::cout << "    " << name << ": " << ProfilerInstance::millisecond() << " ms" << std::endl;
+			}
+			void dump(const char *name, size_t edges){
+				double ms = ProfilerInstance::millisecond();
+				std::cout << "    " << name << ": " << ms << " ms, "
+					<< (ms > 0 ? edges / ms / 1000 : 0) << " MTEPS" << std::endl;
+			}
+			void title(const char *name, unsigned scale){
+				std::cout << name << ", 2^" << scale << " vertices" << std::endl;
+			}
+			//R-MAT(a = 0.57, b = c = 0.19)ɷֲ
+			std::vector<csr_type::edge_type> rmat(unsigned scale, unsigned seed){
+				srand(seed);
+				std::vector<csr_type::edge_type> edges;
+				size_t m = (size_t(1) << scale) * edgeFactor;
+				edges.reserve(m);
+				for (size_t i = 0; i != m; ++i){
+					unsigned from = 0, to = 0;
+					for (unsigned bit = 0; bit != scale; ++bit){
+						int r = rand() % 100;
+						from <<= 1, to <<= 1;
+						if (r >= 57 && r < 76)
+							to |= 1;
+						else if (r >= 76 && r < 95)
+							from |= 1;
+						else if (r >= 95)
+							from |= 1, to |= 1;
+					}
+					edges.push_back(csr_type::edge_type(from, to));
+				}
+				return edges;
+			}
+			std::vector<csr_type::node_type> makeNodes(unsigned scale){
+				std::vector<csr_type::node_type> nodes;
+				for (unsigned i = 0; i != (1u << scale); ++i)
+					nodes.push_back(csr_type::node_type(i, i));
+				return nodes;
+			}
+			void fill(tsDGraph<unsigned, unsigned>& g, const std::vector<csr_type::node_type>& nodes,
+				const std::vector<csr_type::edge_type>& edges){
+				std::vector<tsDGraph<unsigned, unsigned>::nodes_set_type> adjacency(nodes.size());
+				for (size_t i = 0; i != edges.size(); ++i)
+					adjacency[edges[i].first].push_back(nodes[edges[i].second]);
+				for (size_t i = 0; i != nodes.size(); ++i)
+					g.add_node(nodes[i], adjacency[i]);
+			}
+		}
+
+		void benchCase1(){
+			title("build", smallScale);
+			auto nodes = makeNodes(smallScale);
+			auto edges = rmat(smallScale, 1);
+			{
+				tsDGraph<unsigned, unsigned> g;
+				ProfilerInstance::start();
+				fill(g, nodes, edges);
+				ProfilerInstance::finish();
+				dump("directed_graph");
+				ProfilerInstance::start();
+				csr_type csr(g);
+				ProfilerInstance::finish();
+				dump("csr_graph from directed_graph");
+			}
+			for (size_t i = 0; i != sizeof(scales) / sizeof(scales[0]); ++i){
+				title("build", scales[i]);
+				nodes = makeNodes(scales[i]);
+				edges = rmat(scales[i], 1);
+				ProfilerInstance::start();
+				csr_type csr(nodes, edges);
+				ProfilerInstance::finish();
+				dump("csr_graph from edge list");
+			}
+		}
+		void benchCase2(){
+			size_t sum = 0;
+			auto visit = [&sum](csr_type::node_type& node){ sum += node.second; };
+			{
+				title("visitor BFS/DFS", smallScale);
+				auto nodes = makeNodes(smallScale);
+				auto edges = rmat(smallScale, 2);
+				tsDGraph<unsigned, unsigned> g;
+				fill(g, nodes, edges);
+				csr_type csr(g);
+				ProfilerInstance::start();
+				g.BFS(0, visit);
+				ProfilerInstance::finish();
+				dump("directed_graph BFS");
+				ProfilerInstance::start();
+				csr.BFS(0, visit);
+				ProfilerInstance::finish();
+				dump("csr_graph BFS");
+				ProfilerInstance::start();
+				g.DFS(0, visit);
+				ProfilerInstance::finish();
+				dump("directed_graph DFS");
+				ProfilerInstance::start();
+				csr.DFS(0, visit);
+				ProfilerInstance::finish();
+				dump("csr_graph DFS");
+			}
+			for (size_t i = 0; i != sizeof(scales) / sizeof(scales[0]); ++i){
+				title("visitor BFS/DFS", scales[i]);
+				csr_type csr(makeNodes(scales[i]), rmat(scales[i], 2));
+				ProfilerInstance::start();
+				csr.BFS(0, visit);
+				ProfilerInstance::finish();
+				dump("csr_graph BFS", csr.edge_count());
+				ProfilerInstance::start();
+				csr.DFS(0, visit);
+				ProfilerInstance::finish();
+				dump("csr_graph DFS", csr.edge_count());
+			}
+			std::cout << "    (" << sum << ")" << std::endl;
+		}
+		void benchCase3(){
+			for (size_t i = 0; i != sizeof(scales) / sizeof(scales[0]); ++i){
+				title("bfs_levels", scales[i]);
+				csr_type csr(makeNodes(scales[i]), rmat(scales[i], 3));
+				size_t reached = 0;
+				{
+					ProfilerInstance::start();
+					auto levels = csr.bfs_levels(0, false, false);
+					ProfilerInstance::finish();
+					dump("top-down", csr.edge_count());
+					reached += std::count_if(levels.begin(), levels.end(), [](unsigned l){ return l != csr_type::npos; });
+				}
+				{
+					ProfilerInstance::start();
+					auto levels = csr.bfs_levels(0, false, true);
+					ProfilerInstance::finish();
+					dump("direction-optimizing", csr.edge_count());
+				}
+				{
+					ProfilerInstance::start();
+					auto levels = csr.bfs_levels(0, true, true);
+					ProfilerInstance::finish();
+					dump("direction-optimizing, parallel", csr.edge_count());
+				}
+				std::cout << "    (reached " << reached << ")" << std::endl;
+			}
+		}
+
+		void benchAllCases(){
+			benchCase1();
+			benchCase2();
+			benchCase3();
+		}
+	}
+}
@@ -0,0 +1,25 @@
+#ifndef _GRAPH_BENCHMARK_H_
+#define _GRAPH_BENCHMARK_H_
+
+#include "../Profiler/Profiler.h"
+#include "../Graph.h"
+
+#include <iostream>
+#include <vector>
+
+namespace TinySTL{
+	namespace GraphBenchmark{
+		template<class Index, class Value>
+		using tsDGraph = TinySTL::directed_graph < Index, Value > ;
+		template<class Index, class Value>
+		using tsCSRGraph = TinySTL::csr_graph < Index, Value > ;
+
+		void benchCase1();//ͼdirected_graphֻСģϱȽ
+		void benchCase2();//ʺBFS/DFS
+		void benchCase3();//BFSԶ¡ŻŻӶ߳
+
+		void benchAllCases();
+	}
+}
+
+#endif
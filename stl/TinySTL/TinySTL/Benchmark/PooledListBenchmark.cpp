@@ -0,0 +1,164 @@
+#include "PooledListBenchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+namespace TinySTL{
+	namespace PooledListBenchmark{
+		using namespace TinySTL::Profiler;
+
+		namespace{
+			const int count = 100000;
+			const int interleaved = 8;
+
+			Harness& harness(){
+				static Harness h("PooledListBenchmark");
+				return h;
+			}
+			std::vector<int> randomInts(int n, unsigned seed){
+				srand(seed);
+				std::vector<int> v;
+				for (int i = 0; i != n; ++i)
+					v.push_back(int(((unsigned(rand()) << 15) ^ unsigned(rand())) & 0x7fffffff));
+				return v;
+			}
+			const char *title(const char *what){
+				static char buf[128];
+				sprintf(buf, "%s, %d elements", what, count);
+				return buf;
+			}
+			template<class List>
+			long long sum(const List& l){
+				long long res = 0;
+				for (auto it = l.begin(); it != l.end(); ++it)
+					res += *it;
+				return res;
+			}
+			//TinySTL::listûconstbegin/endã
+			template<class T>
+			long long sum(tsList<T>& l){
+				long long res = 0;
+				for (auto it = l.begin(); it != l.end(); ++it)
+					res += *it;
+				return res;
+			}
+			template<class List>
+			void pushAndTraverse(Harness& h, const std::string& group, const char *name){
+				h.run(group, name, []{
+					List l;
+					for (int i = 0; i != count; ++i)
+						l.push_back(i);
+					doNotOptimize(sum(l));
+				});
+			}
+			//interleavedlistpush_backͨʱڵԪزڵڴ
+			template<class List>
+			void interleavedTraverse(Harness& h, const std::string& group, const char *name){
+				std::unique_ptr<List[]> lists(new List[interleaved]);
+				for (int i = 0; i != count * interleaved; ++i)
+					lists[i % interleaved].push_back(i);
+				List& l = lists[interleaved / 2];
+				h.run(group, name, [&l]{ doNotOptimize(sum(l)); });
+			}
+			template<class List>
+			void buildAndSort(Harness& h, const std::string& group, const char *name, const std::vector<int>& v){
+				h.run(group, name, [&v]{
+					List l;
+					for (auto i : v)
+						l.push_back(i);
+					l.sort();
+					doNotOptimize(l.front());
+				});
+			}
+			template<class List>
+			void buildAndUnique(Harness& h, const std::string& group, const char *name){
+				h.run(group, name, []{
+					List l;
+					for (int i = 0; i != count; ++i)
+						l.push_back(i / 4);
+					l.unique();
+					doNotOptimize(l.front());
+				});
+			}
+			template<class List>
+			void rotate(Harness& h, const std::string& group, const char *name){
+				List l;
+				for (int i = 0; i != count; ++i)
+					l.push_back(i);
+				h.run(group, name, [&l]{
+					for (int i = 0; i != count; ++i)
+						l.splice(l.end(), l, l.begin());
+					doNotOptimize(l.front());
+				});
+			}
+			//֮ÿΰһͷڵ㣬pooled_listйһ
+			template<class List>
+			void shuttle(Harness& h, const std::string& group, const char *name, List& a, List& b){
+				for (int i = 0; i != count; ++i)
+					a.push_back(i);
+				h.run(group, name, [&a, &b]{
+					for (int i = 0; i != count; ++i)
+						b.splice(b.end(), a, a.begin());
+					for (int i = 0; i != count; ++i)
+						a.splice(a.end(), b, b.begin());
+					doNotOptimize(a.front());
+				});
+			}
+		}
+
+		void benchCase1(){
+			Harness& h = harness();
+			std::string group = title("push_back and traverse");
+			pushAndTraverse<stdList<int>>(h, group, "std::list");
+			pushAndTraverse<tsList<int>>(h, group, "TinySTL::list");
+			pushAndTraverse<tsPList<int>>(h, group, "TinySTL::pooled_list");
+
+			group = title("traverse one of 8 interleaved lists");
+			interleavedTraverse<stdList<int>>(h, group, "std::list");
+			interleavedTraverse<tsList<int>>(h, group, "TinySTL::list");
+			interleavedTraverse<tsPList<int>>(h, group, "TinySTL::pooled_list");
+		}
+		void benchCase2(){
+			Harness& h = harness();
+			auto v = randomInts(count, 1);
+			std::string group = title("build and sort random ints");
+			buildAndSort<stdList<int>>(h, group, "std::list", v);
+			buildAndSort<tsList<int>>(h, group, "TinySTL::list", v);
+			buildAndSort<tsPList<int>>(h, group, "TinySTL::pooled_list", v);
+
+			group = title("build and unique, 4 copies of each value");
+			buildAndUnique<stdList<int>>(h, group, "std::list");
+			buildAndUnique<tsList<int>>(h, group, "TinySTL::list");
+			buildAndUnique<tsPList<int>>(h, group, "TinySTL::pooled_list");
+		}
+		void benchCase3(){
+			Harness& h = harness();
+			std::string group = title("splice front to back");
+			rotate<stdList<int>>(h, group, "std::list");
+			rotate<tsList<int>>(h, group, "TinySTL::list");
+			rotate<tsPList<int>>(h, group, "TinySTL::pooled_list");
+
+			group = title("splice between two queues");
+			{
+				stdList<int> a, b;
+				shuttle(h, group, "std::list", a, b);
+			}
+			{
+				tsList<int> a, b;
+				shuttle(h, group, "TinySTL::list", a, b);
+			}
+			{
+				tsPList<int> a, b(a.get_pool());
+				shuttle(h, group, "TinySTL::pooled_list", a, b);
+			}
+		}
+
+		void benchAllCases(){
+			benchCase1();
+			benchCase2();
+			benchCase3();
+			harness().saveJson("PooledListBenchmark.json");
+		}
+	}
+}
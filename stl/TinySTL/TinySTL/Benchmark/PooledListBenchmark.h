@@ -0,0 +1,29 @@
+#ifndef _POOLED_LIST_BENCHMARK_H_
+#define _POOLED_LIST_BENCHMARK_H_
+
+#include "../Profiler/Harness.h"
+#include "../List.h"
+#include "../PooledList.h"
+
+#include <list>
+#include <vector>
+
+namespace TinySTL{
+	namespace PooledListBenchmark{
+		template<class T>
+		using stdList = std::list < T > ;
+		template<class T>
+		using tsList = TinySTL::list < T > ;
+		template<class T>
+		using tsPList = TinySTL::pooled_list < T > ;
+
+		//std::listTinySTL::listTinySTL::pooled_listűȽϣдPooledListBenchmark.json
+		void benchCase1();//push_backlist(ڵڶϽ)֮һ
+		void benchCase2();//sortظʱunique
+		void benchCase3();//spliceͷڵƵβ֮ذ
+
+		void benchAllCases();
+	}
+}
+
+#endif
@@ -0,0 +1,167 @@
+#include "RopeBenchmark.h"
+
+#include <cstdlib>
+
+namespace TinySTL{
+	namespace RopeBenchmark{
+		using namespace TinySTL::Profiler;
+
+		namespace{
+			//1MB1GBĹģҪGBڴ
+			const size_t sizes[] = { 1 << 20, 16 << 20, 256 << 20, 1 << 30 };
+			const size_t chunk = 64;
+			const int edits = 1000;
+
+			void dump(const char *name){
+				std::cout << "    " << name << ": " << ProfilerInstance::millisecond() << " ms" << std::endl;
+			}
+			void title(const char *name, size_t size){
+				std::cout << name << ", " << (size >> 20) << " MB" << std::endl;
+			}
+			stdStr randomChunk(unsigned seed){
+				srand(seed);
+				stdStr res(chunk, '\0');
+				for (size_t i = 0; i != chunk; ++i)
+					res[i] = 'a' + rand() % 26;
+				return res;
+			}
+			template<class Str>
+			void fill(Str& s, size_t size, const stdStr& piece){
+				for (size_t len = 0; len < size; len += chunk)
+					s.append(piece.data(), chunk);
+			}
+		}
+
+		void benchCase1(){
+			stdStr piece = randomChunk(1);
+			for (size_t i = 0; i != sizeof(sizes) / sizeof(sizes[0]); ++i){
+				title("append", sizes[i]);
+				{
+					stdStr s;
+					ProfilerInstance::start();
+					fill(s, sizes[i], piece);
+					ProfilerInstance::finish();
+					dump("std::string");
+				}
+				{
+					tsStr s;
+					ProfilerInstance::start();
+					fill(s, sizes[i], piece);
+					ProfilerInstance::finish();
+					dump("TinySTL::string");
+				}
+				{
+					tsRope r;
+					ProfilerInstance::start();
+					fill(r, sizes[i], piece);
+					ProfilerInstance::finish();
+					dump("TinySTL::rope");
+				}
+			}
+		}
+		void benchCase2(){
+			stdStr piece = randomChunk(2);
+			for (size_t i = 0; i != sizeof(sizes) / sizeof(sizes[0]); ++i){
+				title("random insert + erase", sizes[i]);
+				std::vector<size_t> positions(edits);
+				srand(3);
+				for (int k = 0; k != edits; ++k)
+					positions[k] = (((size_t)rand() << 15) ^ rand()) % sizes[i];
+				{
+					stdStr s;
+					fill(s, sizes[i], piece);
+					ProfilerInstance::start();
+					for (int k = 0; k != edits; ++k){
+						s.insert(positions[k], piece);
+						s.erase(positions[edits - 1 - k], chunk);
+					}
+					ProfilerInstance::finish();
+					dump("std::string");
+				}
+				{
+					tsRope r;
+					fill(r, sizes[i], piece);
+					ProfilerInstance::start();
+					for (int k = 0; k != edits; ++k){
+						r.insert(positions[k], piece.data(), chunk);
+						r.erase(positions[edits - 1 - k], chunk);
+					}
+					ProfilerInstance::finish();
+					dump("TinySTL::rope");
+				}
+			}
+		}
+		void benchCase3(){
+			stdStr piece = randomChunk(4);
+			for (size_t i = 0; i != sizeof(sizes) / sizeof(sizes[0]); ++i){
+				title("substr of half + copy", sizes[i]);
+				size_t total = 0;
+				{
+					stdStr s;
+					fill(s, sizes[i], piece);
+					ProfilerInstance::start();
+					stdStr sub = s.substr(sizes[i] / 4, sizes[i] / 2);
+					stdStr copy = s;
+					ProfilerInstance::finish();
+					total += sub.size() + copy.size();
+					dump("std::string");
+				}
+				{
+					tsRope r;
+					fill(r, sizes[i], piece);
+					ProfilerInstance::start();
+					tsRope sub = r.substr(sizes[i] / 4, sizes[i] / 2);
+					tsRope copy = r;
+					ProfilerInstance::finish();
+					total += sub.size() + copy.size();
+					dump("TinySTL::rope");
+				}
+				std::cout << "    (" << total << ")" << std::endl;
+			}
+		}
+		void benchCase4(){
+			stdStr piece = randomChunk(5);
+			const char *needle = "0123456789";
+			for (size_t i = 0; i != sizeof(sizes) / sizeof(sizes[0]); ++i){
+				title("flatten + find near the end", sizes[i]);
+				size_t found = 0;
+				{
+					stdStr s;
+					fill(s, sizes[i], piece);
+					s.append(needle);
+					stdStr flat(s.size(), '\0');
+					ProfilerInstance::start();
+					s.copy(&flat[0], s.size());
+					ProfilerInstance::finish();
+					dump("std::string copy");
+					ProfilerInstance::start();
+					found += s.find(needle);
+					ProfilerInstance::finish();
+					dump("std::string find");
+				}
+				{
+					tsRope r;
+					fill(r, sizes[i], piece);
+					r.append(needle);
+					stdStr flat(r.size(), '\0');
+					ProfilerInstance::start();
+					r.flatten(&flat[0]);
+					ProfilerInstance::finish();
+					dump("TinySTL::rope flatten");
+					ProfilerInstance::start();
+					found += r.find(needle);
+					ProfilerInstance::finish();
+					dump("TinySTL::rope find");
+				}
+				std::cout << "    (" << found << ")" << std::endl;
+			}
+		}
+
+		void benchAllCases(){
+			benchCase1();
+			benchCase2();
+			benchCase3();
+			benchCase4();
+		}
+	}
+}
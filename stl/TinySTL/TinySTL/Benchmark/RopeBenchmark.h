@@ -0,0 +1,27 @@
+#ifndef _ROPE_BENCHMARK_H_
+#define _ROPE_BENCHMARK_H_
+
+#include "../Profiler/Profiler.h"
+#include "../Rope.h"
+#include "../String.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace TinySTL{
+	namespace RopeBenchmark{
+		typedef std::string stdStr;
+		typedef TinySTL::string tsStr;
+		typedef TinySTL::rope tsRope;
+
+		void benchCase1();//64ֽΪλ׷ӵָ
+		void benchCase2();//λò/ɾ
+		void benchCase3();//ȡһsubstr忽
+		void benchCase4();//flattenԼĩβ
+
+		void benchAllCases();
+	}
+}
+
+#endif
@@ -0,0 +1,156 @@
+#include "SharedPtrBenchmark.h"
+
+namespace TinySTL{
+	namespace SharedPtrBenchmark{
+		using namespace TinySTL::Profiler;
+
+		namespace{
+			const int copies = 2000000;
+			const int loads = 2000000;
+
+			struct Payload{
+				int a, b, c, d;
+				Payload(int v) :a(v), b(v), c(v), d(v){}
+			};
+
+			//threads̸߳԰sp/copiesΣÿο+ƽns
+			template<class Ptr>
+			double copyDestroy(const Ptr& sp, int threads){
+				std::atomic<bool> go(false);
+				std::vector<std::thread> workers;
+				for (int t = 0; t != threads; ++t){
+					workers.push_back(std::thread([&sp, &go]{
+						while (!go.load(std::memory_order_acquire))
+							std::this_thread::yield();
+						for (int i = 0; i != copies; ++i){
+							Ptr copy(sp);
+							doNotOptimize(copy);
+						}
+					}));
+				}
+				ProfilerInstance::start();
+				go.store(true, std::memory_order_release);
+				for (auto& w : workers)
+					w.join();
+				ProfilerInstance::finish();
+				return ProfilerInstance::millisecond() * 1000000 / copies;
+			}
+
+			//ȽϵַʽӿͳһΪload/store
+			class tinyPublisher{
+			private:
+				atomic_shared_ptr<Payload> ptr_;
+			public:
+				explicit tinyPublisher(int v) :ptr_(make_shared<Payload>(v)){}
+				int load()const{ return ptr_.load()->a; }
+				void store(int v){ ptr_.store(make_shared<Payload>(v)); }
+			};
+			class stdAtomicPublisher{
+			private:
+				std::shared_ptr<Payload> ptr_;
+			public:
+				explicit stdAtomicPublisher(int v) :ptr_(std::make_shared<Payload>(v)){}
+				int load()const{ return std::atomic_load(&ptr_)->a; }
+				void store(int v){ std::atomic_store(&ptr_, std::make_shared<Payload>(v)); }
+			};
+			class mutexPublisher{
+			private:
+				mutable std::mutex mtx_;
+				shared_ptr<Payload> ptr_;
+			public:
+				explicit mutexPublisher(int v) :ptr_(make_shared<Payload>(v)){}
+				int load()const{
+					shared_ptr<Payload> sp;
+					{
+						std::lock_guard<std::mutex> lock(mtx_);
+						sp = ptr_;
+					}
+					return sp->a;
+				}
+				void store(int v){
+					auto sp = make_shared<Payload>(v);
+					std::lock_guard<std::mutex> lock(mtx_);
+					ptr_.swap(sp);
+				}
+			};
+
+			//readers߸load loadsΣдڶ߽ǰstoreضߵM load/sдߵstore
+			template<class Publisher>
+			void publish(const char *name, int readers){
+				Publisher pub(0);
+				std::atomic<int> running(readers);
+				std::atomic<bool> go(false);
+				std::vector<std::thread> workers;
+				long long sum = 0;
+				std::mutex sumMtx;
+				for (int t = 0; t != readers; ++t){
+					workers.push_back(std::thread([&]{
+						while (!go.load(std::memory_order_acquire))
+							std::this_thread::yield();
+						long long local = 0;
+						for (int i = 0; i != loads; ++i)
+							local += pub.load();
+						running.fetch_sub(1);
+						std::lock_guard<std::mutex> lock(sumMtx);
+						sum += local;
+					}));
+				}
+				int stores = 0;
+				ProfilerInstance::start();
+				go.store(true, std::memory_order_release);
+				while (running.load() != 0)
+					pub.store(++stores);
+				for (auto& w : workers)
+					w.join();
+				ProfilerInstance::finish();
+				double ms = ProfilerInstance::millisecond();
+				std::cout << "    " << name << ": " << ms << " ms, "
+					<< double(loads) * readers / ms / 1000 << " M load/s, "
+					<< stores << " stores (" << sum % 10 << ")" << std::endl;
+			}
+		}
+
+		void benchCase1(){
+			static Harness h("SharedPtrBenchmark");
+			std::string group = "create and destroy";
+			h.run(group, "TinySTL::shared_ptr(new T)", []{
+				shared_ptr<Payload> sp(new Payload(1));
+				doNotOptimize(sp);
+			});
+			h.run(group, "TinySTL::make_shared", []{
+				auto sp = make_shared<Payload>(1);
+				doNotOptimize(sp);
+			});
+			h.run(group, "std::make_shared", []{
+				auto sp = std::make_shared<Payload>(1);
+				doNotOptimize(sp);
+			});
+		}
+		void benchCase2(){
+			std::cout << "copy + destroy of one shared_ptr, " << copies << " per thread" << std::endl;
+			auto tsp = make_shared<Payload>(1);
+			auto ssp = std::make_shared<Payload>(1);
+			for (int threads = 1; threads <= 8; threads *= 2){
+				double ts = copyDestroy(tsp, threads);
+				double ss = copyDestroy(ssp, threads);
+				std::cout << "    " << threads << " threads: TinySTL::shared_ptr " << ts
+					<< " ns, std::shared_ptr " << ss << " ns" << std::endl;
+			}
+		}
+		void benchCase3(){
+			std::cout << "publication, " << loads << " loads per reader" << std::endl;
+			for (int readers = 1; readers <= 4; readers *= 2){
+				std::cout << "  " << readers << " readers" << std::endl;
+				publish<tinyPublisher>("TinySTL::atomic_shared_ptr", readers);
+				publish<stdAtomicPublisher>("std::atomic_load(shared_ptr)", readers);
+				publish<mutexPublisher>("mutex + TinySTL::shared_ptr", readers);
+			}
+		}
+
+		void benchAllCases(){
+			benchCase1();
+			benchCase2();
+			benchCase3();
+		}
+	}
+}
@@ -0,0 +1,24 @@
+#ifndef _SHARED_PTR_BENCHMARK_H_
+#define _SHARED_PTR_BENCHMARK_H_
+
+#include "../Profiler/Harness.h"
+#include "../Memory.h"
+
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace TinySTL{
+	namespace SharedPtrBenchmark{
+		void benchCase1();//new + Ŀƿ vs make_shared vs std::make_shared
+		void benchCase2();//1~8߳ͬʱ/ͬһshared_ptrstd::shared_ptrȽ
+		void benchCase3();//һд߲Ϸ¶󣬶߶ȡatomic_shared_ptr vs std::atomic_load vs mutex
+
+		void benchAllCases();
+	}
+}
+
+#endif
@@ -0,0 +1,113 @@
+#include "StringBenchmark.h"
+
+namespace TinySTL{
+	namespace StringBenchmark{
+		using namespace TinySTL::Profiler;
+
+		namespace{
+			const char *headerNames[] = {
+				"Host", "User-Agent", "Accept", "Accept-Language", "Accept-Encoding",
+				"Connection", "Cookie", "Cache-Control", "Content-Type", "Content-Length",
+				"Referer", "If-None-Match", "If-Modified-Since", "X-Forwarded-For", "X-Request-Id",
+				"Authorization", "Origin", "Pragma", "Upgrade-Insecure-Requests", "DNT"
+			};
+			const size_t nameCount = sizeof(headerNames) / sizeof(headerNames[0]);
+			const char *headerBlock =
+				"Host: www.example.com\r\n"
+				"User-Agent: Mozilla/5.0 (X11; Linux x86_64)\r\n"
+				"Accept: text/html,application/xhtml+xml\r\n"
+				"Accept-Language: en-US,en;q=0.5\r\n"
+				"Accept-Encoding: gzip, deflate\r\n"
+				"Connection: keep-alive\r\n"
+				"Cookie: session=0123456789abcdef\r\n"
+				"Cache-Control: max-age=0\r\n"
+				"\r\n";
+			const int loops = 1000000;
+
+			void dump(const char *name){
+				std::cout << "  " << name << ": " << ProfilerInstance::millisecond() << " ms" << std::endl;
+			}
+		}
+
+		void benchCase1(){
+			std::cout << "construct short header names, " << loops << " loops" << std::endl;
+			size_t total = 0;
+			ProfilerInstance::start();
+			for (int i = 0; i != loops; ++i){
+				stdStr s(headerNames[i % nameCount]);
+				total += s.size();
+			}
+			ProfilerInstance::finish();
+			dump("std::string");
+
+			ProfilerInstance::start();
+			for (int i = 0; i != loops; ++i){
+				tsStr s(headerNames[i % nameCount]);
+				total += s.size();
+			}
+			ProfilerInstance::finish();
+			dump("TinySTL::string");
+			std::cout << "  (" << total << ")" << std::endl;
+		}
+		void benchCase2(){
+			std::cout << "split header lines by ':', " << loops / 10 << " blocks" << std::endl;
+			tsStr block(headerBlock);
+			size_t total = 0;
+			ProfilerInstance::start();
+			for (int i = 0; i != loops / 10; ++i){
+				size_t start = 0, end;
+				while ((end = block.find("\r\n", start)) != tsStr::npos && end != start){
+					auto colon = block.find(':', start);
+					tsStr name = block.substr(start, colon - start);
+					tsStr value = block.substr(colon + 2, end - colon - 2);
+					total += name.size() + value.size();
+					start = end + 2;
+				}
+			}
+			ProfilerInstance::finish();
+			dump("TinySTL::string::substr");
+
+			ProfilerInstance::start();
+			for (int i = 0; i != loops / 10; ++i){
+				TinySTL::string_view rest = block.view();
+				size_t end;
+				while ((end = rest.find("\r\n")) != TinySTL::string_view::npos && end != 0){
+					auto colon = rest.find(':');
+					TinySTL::string_view name = rest.substr(0, colon);
+					TinySTL::string_view value = rest.substr(colon + 2, end - colon - 2);
+					total += name.size() + value.size();
+					rest.remove_prefix(end + 2);
+				}
+			}
+			ProfilerInstance::finish();
+			dump("TinySTL::string_view::substr");
+			std::cout << "  (" << total << ")" << std::endl;
+		}
+		void benchCase3(){
+			std::cout << "find_first_of(\"\\r\\n\") over header block, " << loops << " loops" << std::endl;
+			stdStr block1(headerBlock);
+			tsStr block2(headerBlock);
+			size_t total = 0;
+			ProfilerInstance::start();
+			for (int i = 0; i != loops; ++i){
+				total += block1.find_first_of("\r\n", i % 16);
+			}
+			ProfilerInstance::finish();
+			dump("std::string");
+
+			ProfilerInstance::start();
+			for (int i = 0; i != loops; ++i){
+				total += block2.find_first_of("\r\n", i % 16);
+			}
+			ProfilerInstance::finish();
+			dump("TinySTL::string");
+			std::cout << "  (" << total << ")" << std::endl;
+		}
+
+		void benchAllCases(){
+			benchCase1();
+			benchCase2();
+			benchCase3();
+		}
+	}
+}
@@ -0,0 +1,26 @@
+#ifndef _STRING_BENCHMARK_H_
+#define _STRING_BENCHMARK_H_
+
+#include "../Profiler/Profiler.h"
+#include "../String.h"
+#include "../StringView.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace TinySTL{
+	namespace StringBenchmark{
+		using stdStr = std::string;
+		using tsStr = TinySTL::string;
+
+		//keyΪĸأHTTPͷ
+		void benchCase1();///ַ(header name)
+		void benchCase2();//':'зheaderУsubstr vs string_viewƬ
+		void benchCase3();//find_first_ofн
+
+		void benchAllCases();
+	}
+}
+
+#endif
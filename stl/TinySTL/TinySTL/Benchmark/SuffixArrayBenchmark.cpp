@@ -0,0 +1,130 @@
+#include "SuffixArrayBenchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace TinySTL{
+	namespace SuffixArrayBenchmark{
+		using namespace TinySTL::Profiler;
+
+		namespace{
+			//1MB128MB128MBʱԼ1.5GB
+			const size_t sizes[] = { 1 << 20, 16 << 20, 128 << 20 };
+
+			void dump(const char *name, size_t size){
+				double ms = ProfilerInstance::millisecond();
+				std::cout << "    " << name << ": " << ms << " ms, "
+					<< (ms > 0 ? (size >> 20) * 1000.0 / ms : 0) << " MB/s" << std::endl;
+			}
+			void title(const char *name, size_t size){
+				std::cout << name << ", " << (size >> 20) << " MB" << std::endl;
+			}
+			stdStr randomText(size_t n, unsigned seed){
+				srand(seed);
+				stdStr res(n, '\0');
+				for (size_t i = 0; i != n; ++i)
+					res[i] = 'a' + rand() % 26;
+				return res;
+			}
+			//ʽ̶ֶֻα仯־Уǰ׺ܳ
+			stdStr logText(size_t n, unsigned seed){
+				static const char *levels[] = { "INFO", "WARN", "DEBUG", "ERROR" };
+				static const char *paths[] = { "/api/v1/items", "/api/v1/users", "/static/app.js", "/healthz" };
+				srand(seed);
+				stdStr res;
+				res.reserve(n + 256);
+				char line[256];
+				for (unsigned i = 0; res.size() < n; ++i){
+					sprintf(line, "2016-05-%02u 12:%02u:%02u [%s] GET %s/%u status=%u bytes=%u\n",
+						i / 86400 % 28 + 1, i / 60 % 60, i % 60, levels[rand() % 4], paths[rand() % 4],
+						rand() % 1000, rand() % 3 == 0 ? 404 : 200, rand() % 100000);
+					res += line;
+				}
+				res.resize(n);
+				return res;
+			}
+		}
+
+		void benchCase1(){
+			for (size_t i = 0; i != sizeof(sizes) / sizeof(sizes[0]); ++i){
+				title("random text", sizes[i]);
+				stdStr text = randomText(sizes[i], 1);
+				{
+					ProfilerInstance::start();
+					tsSA sa(text.data(), text.size());
+					ProfilerInstance::finish();
+					dump("suffix_array", sizes[i]);
+				}
+				{
+					ProfilerInstance::start();
+					tsSA64 sa(text.data(), text.size());
+					ProfilerInstance::finish();
+					dump("suffix_array64", sizes[i]);
+				}
+			}
+		}
+		void benchCase2(){
+			for (size_t i = 0; i != sizeof(sizes) / sizeof(sizes[0]); ++i){
+				title("log text", sizes[i]);
+				stdStr text = logText(sizes[i], 2);
+				ProfilerInstance::start();
+				tsSA sa(text.data(), text.size());
+				ProfilerInstance::finish();
+				dump("suffix_array", sizes[i]);
+			}
+		}
+		void benchCase3(){
+			for (size_t i = 0; i != sizeof(sizes) / sizeof(sizes[0]); ++i){
+				title("log text, rank + height threads", sizes[i]);
+				stdStr text = logText(sizes[i], 3);
+				{
+					ProfilerInstance::start();
+					tsSA sa(text.data(), text.size(), 256, false);
+					ProfilerInstance::finish();
+					dump("single thread", sizes[i]);
+				}
+				{
+					ProfilerInstance::start();
+					tsSA sa(text.data(), text.size(), 256, true);
+					ProfilerInstance::finish();
+					dump("parallel", sizes[i]);
+				}
+			}
+		}
+		void benchCase4(){
+			const char *path = "suffix_array_bench.idx";
+			for (size_t i = 0; i != sizeof(sizes) / sizeof(sizes[0]); ++i){
+				title("save + mmap", sizes[i]);
+				stdStr text = logText(sizes[i], 4);
+				{
+					tsSA sa(text.data(), text.size());
+					ProfilerInstance::start();
+					sa.save(path);
+					ProfilerInstance::finish();
+					dump("save", sizes[i]);
+				}
+				long long sum = 0;
+				ProfilerInstance::start();
+				{
+					TinySTL::mapped_suffix_array m(path);
+					srand(5);
+					for (int k = 0; k != 1000000; ++k){
+						size_t pos = (((size_t)rand() << 15) ^ rand()) % (m.size() - 1);
+						sum += m.suffix(pos) + m.height(pos);
+					}
+				}
+				ProfilerInstance::finish();
+				dump("mmap + 1M random reads", sizes[i]);
+				std::cout << "    (" << sum << ")" << std::endl;
+			}
+			std::remove(path);
+		}
+
+		void benchAllCases(){
+			benchCase1();
+			benchCase2();
+			benchCase3();
+			benchCase4();
+		}
+	}
+}
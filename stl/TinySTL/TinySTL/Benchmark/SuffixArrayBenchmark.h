@@ -0,0 +1,26 @@
+#ifndef _SUFFIX_ARRAY_BENCHMARK_H_
+#define _SUFFIX_ARRAY_BENCHMARK_H_
+
+#include "../Profiler/Profiler.h"
+#include "../SuffixArray.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace TinySTL{
+	namespace SuffixArrayBenchmark{
+		typedef std::string stdStr;
+		typedef TinySTL::suffix_array tsSA;
+		typedef TinySTL::suffix_array64 tsSA64;
+
+		void benchCase1();//ı32λ64λ±Ĺʱ
+		void benchCase2();//ظȺܸߵ־ı
+		void benchCase3();//̺߳Ͷ̼߳rank/height
+		void benchCase4();//浽ļӳ
+
+		void benchAllCases();
+	}
+}
+
+#endif
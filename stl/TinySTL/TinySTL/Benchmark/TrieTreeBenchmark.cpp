@@ -0,0 +1,215 @@
+#include "TrieTreeBenchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+namespace TinySTL{
+	namespace TrieTreeBenchmark{
+		using namespace TinySTL::Profiler;
+
+		namespace{
+			//128K4Mʣ4Mʱstd::settrie_treeҪMB
+			const size_t sizes[] = { 1 << 17, 1 << 20, 1 << 22 };
+			const int lookups = 1000000;
+			const int prefixes = 1000;
+
+			void dump(const char *name){
+				std::cout << "    " << name << ": " << ProfilerInstance::millisecond() << " ms" << std::endl;
+			}
+			void title(const char *name, size_t size){
+				std::cout << name << ", " << size << " keys" << std::endl;
+			}
+			size_t randomIndex(){
+				return (size_t(rand()) << 15) ^ rand();
+			}
+			//·ɱ·ǰ漸ظܶ
+			std::vector<stdStr> makeKeys(size_t n, unsigned seed){
+				static const char *services[] = { "api", "static", "admin", "internal", "v1", "v2", "v3", "media" };
+				static const char *resources[] = { "users", "items", "orders", "images", "search", "reports", "login" };
+				srand(seed);
+				stdSet set;
+				char buf[128];
+				while (set.size() < n){
+					sprintf(buf, "/%s/%s/%u/%s/%u", services[rand() % 8], resources[rand() % 7],
+						unsigned(randomIndex() % 100000), resources[rand() % 7], unsigned(randomIndex() % 1000));
+					set.insert(buf);
+				}
+				std::vector<stdStr> keys(set.begin(), set.end());
+				//˳ֻcompact_trieź
+				for (size_t i = keys.size(); i > 1; --i)
+					std::swap(keys[i - 1], keys[randomIndex() % i]);
+				return keys;
+			}
+			std::vector<stdStr> makeQueries(const std::vector<stdStr>& keys, unsigned seed){
+				srand(seed);
+				std::vector<stdStr> res;
+				for (int i = 0; i != lookups; ++i){
+					stdStr key = keys[randomIndex() % keys.size()];
+					if (i % 2)
+						key[key.size() - 1] = 'x';
+					res.push_back(key);
+				}
+				return res;
+			}
+		}
+
+		void benchCase1(){
+			for (size_t i = 0; i != sizeof(sizes) / sizeof(sizes[0]); ++i){
+				title("build", sizes[i]);
+				std::vector<stdStr> keys = makeKeys(sizes[i], 1);
+				{
+					ProfilerInstance::start();
+					stdSet set(keys.begin(), keys.end());
+					ProfilerInstance::finish();
+					dump("std::set");
+				}
+				{
+					std::vector<tsStr> words;
+					for (size_t j = 0; j != keys.size(); ++j)
+						words.push_back(tsStr(keys[j].data(), keys[j].size()));
+					ProfilerInstance::start();
+					tsTrie trie;
+					for (size_t j = 0; j != words.size(); ++j)
+						trie.insert(words[j]);
+					ProfilerInstance::finish();
+					dump("trie_tree");
+				}
+				{
+					std::sort(keys.begin(), keys.end());
+					ProfilerInstance::start();
+					tsCTrie trie(keys.begin(), keys.end());
+					ProfilerInstance::finish();
+					dump("compact_trie (sorted input)");
+				}
+			}
+		}
+		void benchCase2(){
+			for (size_t i = 0; i != sizeof(sizes) / sizeof(sizes[0]); ++i){
+				title("1M lookups", sizes[i]);
+				std::vector<stdStr> keys = makeKeys(sizes[i], 2);
+				std::vector<stdStr> queries = makeQueries(keys, 3);
+				size_t found = 0;
+				{
+					stdSet set(keys.begin(), keys.end());
+					ProfilerInstance::start();
+					for (size_t j = 0; j != queries.size(); ++j)
+						found += set.count(queries[j]);
+					ProfilerInstance::finish();
+					dump("std::set");
+				}
+				{
+					tsTrie trie;
+					for (size_t j = 0; j != keys.size(); ++j)
+						trie.insert(tsStr(keys[j].data(), keys[j].size()));
+					std::vector<tsStr> words;
+					for (size_t j = 0; j != queries.size(); ++j)
+						words.push_back(tsStr(queries[j].data(), queries[j].size()));
+					ProfilerInstance::start();
+					for (size_t j = 0; j != words.size(); ++j)
+						found += trie.is_existed(words[j]);
+					ProfilerInstance::finish();
+					dump("trie_tree");
+				}
+				{
+					std::sort(keys.begin(), keys.end());
+					tsCTrie trie(keys.begin(), keys.end());
+					ProfilerInstance::start();
+					for (size_t j = 0; j != queries.size(); ++j)
+						found += trie.is_existed(string_view(queries[j].data(), queries[j].size()));
+					ProfilerInstance::finish();
+					dump("compact_trie");
+				}
+				std::cout << "    (" << found << ")" << std::endl;
+			}
+		}
+		void benchCase3(){
+			for (size_t i = 0; i != sizeof(sizes) / sizeof(sizes[0]); ++i){
+				title("1K prefix scans", sizes[i]);
+				std::vector<stdStr> keys = makeKeys(sizes[i], 4);
+				//ȡΪֹΪǰ׺ÿǰ׺ɸ
+				std::vector<stdStr> queries;
+				srand(5);
+				for (int j = 0; j != prefixes; ++j){
+					const stdStr& key = keys[randomIndex() % keys.size()];
+					size_t pos = key.find('/', key.find('/', 1) + 1);
+					queries.push_back(key.substr(0, pos + 1));
+				}
+				size_t count = 0, chars = 0;
+				{
+					stdSet set(keys.begin(), keys.end());
+					ProfilerInstance::start();
+					for (size_t j = 0; j != queries.size(); ++j){
+						const stdStr& prefix = queries[j];
+						for (auto it = set.lower_bound(prefix); it != set.end() && it->compare(0, prefix.size(), prefix) == 0; ++it)
+							++count, chars += it->size();
+					}
+					ProfilerInstance::finish();
+					dump("std::set");
+				}
+				{
+					tsTrie trie;
+					for (size_t j = 0; j != keys.size(); ++j)
+						trie.insert(tsStr(keys[j].data(), keys[j].size()));
+					ProfilerInstance::start();
+					for (size_t j = 0; j != queries.size(); ++j){
+						trie.for_each_word_by_prefix(string_view(queries[j].data(), queries[j].size()), [&](const tsStr& word){
+							++count, chars += word.size();
+						});
+					}
+					ProfilerInstance::finish();
+					dump("trie_tree");
+				}
+				{
+					std::sort(keys.begin(), keys.end());
+					tsCTrie trie(keys.begin(), keys.end());
+					ProfilerInstance::start();
+					for (size_t j = 0; j != queries.size(); ++j){
+						tsCTrie::prefix_range range = trie.prefix(string_view(queries[j].data(), queries[j].size()));
+						for (auto it = range.begin(); it != range.end(); ++it)
+							++count, chars += (*it).size();
+					}
+					ProfilerInstance::finish();
+					dump("compact_trie");
+				}
+				std::cout << "    (" << count << ", " << chars << ")" << std::endl;
+			}
+		}
+		void benchCase4(){
+			const char *path = "trie_tree_bench.idx";
+			for (size_t i = 0; i != sizeof(sizes) / sizeof(sizes[0]); ++i){
+				title("memory", sizes[i]);
+				std::vector<stdStr> keys = makeKeys(sizes[i], 6);
+				std::sort(keys.begin(), keys.end());
+				size_t raw = 0;
+				for (size_t j = 0; j != keys.size(); ++j)
+					raw += keys[j].size();
+				tsCTrie trie(keys.begin(), keys.end());
+				std::cout << "    key bytes per key: " << double(raw) / keys.size() << std::endl;
+				std::cout << "    compact_trie bytes per key: " << double(trie.bytes()) / trie.size() << std::endl;
+				trie.save(path);
+				size_t found = 0;
+				ProfilerInstance::start();
+				{
+					tsCTrie mapped(path);
+					srand(7);
+					for (int j = 0; j != lookups; ++j){
+						const stdStr& key = keys[randomIndex() % keys.size()];
+						found += mapped.is_existed(string_view(key.data(), key.size()));
+					}
+				}
+				ProfilerInstance::finish();
+				dump("mmap open + 1M lookups");
+				std::cout << "    (" << found << ")" << std::endl;
+			}
+			std::remove(path);
+		}
+
+		void benchAllCases(){
+			benchCase1();
+			benchCase2();
+			benchCase3();
+			benchCase4();
+		}
+	}
+}
@@ -0,0 +1,30 @@
+#ifndef _TRIE_TREE_BENCHMARK_H_
+#define _TRIE_TREE_BENCHMARK_H_
+
+#include "../Profiler/Profiler.h"
+#include "../String.h"
+#include "../TrieTree.h"
+
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace TinySTL{
+	namespace TrieTreeBenchmark{
+		typedef std::string stdStr;
+		typedef std::set<std::string> stdSet;
+		typedef TinySTL::string tsStr;
+		typedef TinySTL::trie_tree tsTrie;
+		typedef TinySTL::compact_trie tsCTrie;
+
+		void benchCase1();//compact_trieźĴһν
+		void benchCase2();//ңһһ벻
+		void benchCase3();//ǰ׺
+		void benchCase4();//ÿռõֽԼsaveӳ
+
+		void benchAllCases();
+	}
+}
+
+#endif
@@ -0,0 +1,123 @@
+#include "UFSetBenchmark.h"
+
+#include <cstdlib>
+#include <memory>
+
+namespace TinySTL{
+	namespace UFSetBenchmark{
+		using namespace TinySTL::Profiler;
+
+		namespace{
+			const uint32_t elements = 10000000;
+			typedef std::pair<uint32_t, uint32_t> edge;
+
+			uint32_t random32(){
+				return (uint32_t(rand()) << 16) ^ uint32_t(rand());
+			}
+			std::vector<edge> uniformEdges(){
+				srand(1);
+				std::vector<edge> edges(2 * size_t(elements));
+				for (auto& e : edges)
+					e = edge(random32() % elements, random32() % elements);
+				return edges;
+			}
+			std::vector<edge> nearbyEdges(){
+				srand(2);
+				std::vector<edge> edges(2 * size_t(elements));
+				for (auto& e : edges){
+					uint32_t from = random32() % elements;
+					e = edge(from, (from + random32() % 64) % elements);
+				}
+				return edges;
+			}
+			void dump(const char *name, size_t ops, size_t sets){
+				double ms = ProfilerInstance::millisecond();
+				std::cout << "    " << name << ": " << ms << " ms, "
+					<< ms * 1000000 / ops << " ns/op, " << sets << " sets" << std::endl;
+			}
+			//ԭʵ֣parentΪint·ѹСϲ40MBڶ
+			typedef uf_set<elements> old_uf_set;
+
+			void benchEdges(const char *title, const std::vector<edge>& edges){
+				std::cout << "  " << title << std::endl;
+				std::vector<uint32_t> queries(elements);
+				for (auto& q : queries)
+					q = random32() % elements;
+				long long sum = 0;
+				{
+					std::unique_ptr<old_uf_set> uf(new old_uf_set);
+					ProfilerInstance::start();
+					for (auto& e : edges)
+						uf->Union(int(e.first), int(e.second));
+					ProfilerInstance::finish();
+					dump("uf_set Union", edges.size(), 0);
+					ProfilerInstance::start();
+					for (auto q : queries)
+						sum += uf->Find(int(q));
+					ProfilerInstance::finish();
+					dump("uf_set Find", queries.size(), 0);
+				}
+				{
+					dynamic_uf_set uf(elements);
+					ProfilerInstance::start();
+					for (auto& e : edges)
+						uf.Union(e.first, e.second);
+					ProfilerInstance::finish();
+					dump("dynamic_uf_set Union", edges.size(), uf.Count());
+					ProfilerInstance::start();
+					for (auto q : queries)
+						sum += uf.Find(q);
+					ProfilerInstance::finish();
+					dump("dynamic_uf_set Find", queries.size(), uf.Count());
+				}
+				{
+					dynamic_uf_set uf(elements);
+					ProfilerInstance::start();
+					uf.UnionEdges(edges.begin(), edges.end());
+					ProfilerInstance::finish();
+					dump("dynamic_uf_set UnionEdges", edges.size(), uf.Count());
+				}
+				{
+					concurrent_uf_set uf(elements);
+					ProfilerInstance::start();
+					uf.UnionEdges(edges.begin(), edges.end());
+					ProfilerInstance::finish();
+					dump("concurrent_uf_set UnionEdges", edges.size(), uf.Count());
+				}
+				std::cout << "    (" << sum % 10 << ")" << std::endl;
+			}
+		}
+
+		void benchCase1(){
+			std::cout << "union-find, " << elements << " elements, " << 2 * elements << " edges" << std::endl;
+			benchEdges("uniform edges", uniformEdges());
+			benchEdges("nearby edges", nearbyEdges());
+		}
+		void benchCase2(){
+			std::cout << "concurrent_uf_set UnionEdges, " << elements << " elements, " << 2 * elements << " uniform edges" << std::endl;
+			auto edges = uniformEdges();
+			for (int threads = 1; threads <= 4; threads *= 2){
+				concurrent_uf_set uf(elements);
+				std::vector<std::thread> workers;
+				ProfilerInstance::start();
+				for (int t = 0; t != threads; ++t){
+					workers.push_back(std::thread([&uf, &edges, t, threads]{
+						size_t begin = edges.size() * t / threads, end = edges.size() * (t + 1) / threads;
+						uf.UnionEdges(edges.begin() + begin, edges.begin() + end);
+					}));
+				}
+				for (auto& w : workers)
+					w.join();
+				ProfilerInstance::finish();
+				std::cout << "    " << threads << " threads: " << ProfilerInstance::millisecond() << " ms, "
+					<< edges.size() / ProfilerInstance::millisecond() / 1000 << " M edges/s, "
+					<< uf.Count() << " sets" << std::endl;
+			}
+		}
+
+		void benchAllCases(){
+			benchCase1();
+			benchCase2();
+		}
+	}
+}
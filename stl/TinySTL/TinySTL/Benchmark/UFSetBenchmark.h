@@ -0,0 +1,23 @@
+#ifndef _UF_SET_BENCHMARK_H_
+#define _UF_SET_BENCHMARK_H_
+
+#include "../Profiler/Profiler.h"
+#include "../UFSet.h"
+
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace TinySTL{
+	namespace UFSetBenchmark{
+		//elementsԪأ2 * elementsߣߵ˵ڸ(±64)
+		void benchCase1();//uf_set(ԭʵ) vs dynamic_uf_setUnion vs UnionEdges(Ԥȡ) vs concurrent_uf_seṭ֮߳ѯFind
+		void benchCase2();//concurrent_uf_set 1~4̷̯߳
+
+		void benchAllCases();
+	}
+}
+
+#endif
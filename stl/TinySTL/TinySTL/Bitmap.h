@@ -5,27 +5,76 @@
 #include <iostream>
 #include <stdexcept>
 //#include <string>
+#include <vector>
 
 #include "Allocator.h"
+#include "Iterator.h"
 #include "String.h"
 #include "UninitializedFunctions.h"
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 namespace TinySTL{
+	namespace Detail{
+		inline unsigned popcount64(uint64_t x){
+#if defined(__GNUC__)
+			return __builtin_popcountll(x);
+#else
+			x = x - ((x >> 1) & 0x5555555555555555ULL);
+			x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+			x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+			return (unsigned)((x * 0x0101010101010101ULL) >> 56);
+#endif
+		}
+		//xΪ0
+		inline unsigned ctz64(uint64_t x){
+#if defined(__GNUC__)
+			return __builtin_ctzll(x);
+#elif defined(_MSC_VER)
+			unsigned long i;
+			if (_BitScanForward(&i, (unsigned long)x))
+				return i;
+			_BitScanForward(&i, (unsigned long)(x >> 32));
+			return i + 32;
+#else
+			unsigned i = 0;
+			for (; !(x & 1); x >>= 1) ++i;
+			return i;
+#endif
+		}
+		//n64λֵ__AVX2__ʱÿδ256λ
+		size_t popcount_words(const uint64_t *p, size_t n);
+		void and_words(uint64_t *dst, const uint64_t *src, size_t n);
+		void or_words(uint64_t *dst, const uint64_t *src, size_t n);
+		void xor_words(uint64_t *dst, const uint64_t *src, size_t n);
+		//dst &= ~src
+		void andnot_words(uint64_t *dst, const uint64_t *src, size_t n);
+		//posλ֮һΪ1λûʱn * 64
+		size_t find_next_words(const uint64_t *p, size_t n, size_t pos);
+	}
 
 	//bitmapὫNϵ8ı
 	//bitmapʵϻbitǴڵN
+	//64λִ洢iλڵi / 64ֵĵi % 64λsize()λʼΪ0
 	template<size_t N>
 	class bitmap{
 	public:
-		typedef allocator<uint8_t> dataAllocator;
+		typedef uint64_t word_type;
+		typedef allocator<word_type> dataAllocator;
 	private:
-		uint8_t *start_;
-		uint8_t *finish_;
+		word_type *start_;
+		word_type *finish_;
 		const size_t size_;//¼bit
-		const size_t sizeOfUINT8_;//¼uint8_t
+		const size_t sizeOfWord_;//¼word_type
 		enum EAlign{ ALIGN = 8 };
+		enum EWord{ WORD_BITS = 64 };
 	public:
 		bitmap();
+		bitmap(const bitmap& bm);
+		bitmap& operator = (const bitmap& bm);
+		~bitmap();
 
 		//Returns the number of bits in the bitset that are set (i.e., that have a value of one)
 		size_t count() const;
@@ -46,6 +95,20 @@ namespace TinySTL{
 		bitmap& flip();
 		bitmap& flip(size_t pos);
 
+		bitmap& operator &= (const bitmap& bm);
+		bitmap& operator |= (const bitmap& bm);
+		bitmap& operator ^= (const bitmap& bm);
+		//*this &= ~bm
+		bitmap& and_not(const bitmap& bm);
+		bitmap operator ~() const;
+		bool operator == (const bitmap& bm) const;
+		bool operator != (const bitmap& bm) const{ return !(*this == bm); }
+
+		//һΪ1λûʱsize()
+		size_t find_first() const;
+		//pos֮һΪ1λûʱsize()
+		size_t find_next(size_t pos) const;
+
 		//std::string to_string() const;
 		string to_string() const;
 
@@ -53,18 +116,172 @@ namespace TinySTL{
 		friend std::ostream& operator <<(std::ostream& os, const bitmap<N>& bm);
 	private:
 		size_t roundUp8(size_t bytes);
-		//iĵnthΪΪnewVal
-		void setNthInInt8(uint8_t& i, size_t nth, bool newVal);
-		//ȡiĵnthλ
-		uint8_t getMask(uint8_t i, size_t nth)const{ return (i & (1 << nth)); }
-		//nλתΪڵڼuint8_t
-		size_t getNth(size_t n)const{ return (n / 8); }
-		//nλתΪڵNuint8_tеĵڼbit
-		size_t getMth(size_t n)const{ return (n % EAlign::ALIGN); }
-		void allocateAndFillN(size_t n, uint8_t val);
+		//һbitmapЩλ
+		word_type tailMask() const;
+		//nλתΪڵڼword_type
+		size_t getNth(size_t n)const{ return (n / WORD_BITS); }
+		//nλתΪڵNword_typeеĵڼbit
+		size_t getMth(size_t n)const{ return (n % WORD_BITS); }
+		void allocateAndFillN(size_t n, word_type val);
 		void THROW(size_t n)const;
 	};// end of bitmap
+
+	template<size_t N>
+	bitmap<N> operator & (const bitmap<N>& lhs, const bitmap<N>& rhs);
+	template<size_t N>
+	bitmap<N> operator | (const bitmap<N>& lhs, const bitmap<N>& rhs);
+	template<size_t N>
+	bitmap<N> operator ^ (const bitmap<N>& lhs, const bitmap<N>& rhs);
+
+	//the class of dynamic_bitmap
+	//ʱСbitmapСϵresizepush_back
+	//dynamic_bitmap֮λҪСͬ׳std::invalid_argument
+	class dynamic_bitmap{
+	public:
+		typedef uint64_t word_type;
+		typedef size_t size_type;
+	private:
+		enum EWord{ WORD_BITS = 64 };
+		std::vector<word_type> words_;
+		size_type size_;
+	public:
+		dynamic_bitmap() :size_(0){}
+		explicit dynamic_bitmap(size_type n, bool val = false);
+		dynamic_bitmap(dynamic_bitmap&& bm);
+		dynamic_bitmap& operator = (dynamic_bitmap&& bm);
+		dynamic_bitmap(const dynamic_bitmap&) = default;
+		dynamic_bitmap& operator = (const dynamic_bitmap&) = default;
+
+		size_type size()const{ return size_; }
+		bool empty()const{ return size_ == 0; }
+		size_type count()const{ return Detail::popcount_words(words_.data(), words_.size()); }
+		bool test(size_type pos)const;
+		bool any()const;
+		bool none()const{ return !any(); }
+		bool all()const{ return count() == size_; }
+
+		dynamic_bitmap& set();
+		dynamic_bitmap& set(size_type pos, bool val = true);
+		dynamic_bitmap& reset();
+		dynamic_bitmap& reset(size_type pos){ return set(pos, false); }
+		dynamic_bitmap& flip();
+		dynamic_bitmap& flip(size_type pos);
+
+		void resize(size_type n, bool val = false);
+		void push_back(bool val);
+		void clear(){ words_.clear(); size_ = 0; }
+
+		dynamic_bitmap& operator &= (const dynamic_bitmap& bm);
+		dynamic_bitmap& operator |= (const dynamic_bitmap& bm);
+		dynamic_bitmap& operator ^= (const dynamic_bitmap& bm);
+		//*this &= ~bm
+		dynamic_bitmap& and_not(const dynamic_bitmap& bm);
+		dynamic_bitmap operator ~()const;
+		bool operator == (const dynamic_bitmap& bm)const{ return size_ == bm.size_ && words_ == bm.words_; }
+		bool operator != (const dynamic_bitmap& bm)const{ return !(*this == bm); }
+
+		//һΪ1λûʱsize()
+		size_type find_first()const;
+		//pos֮һΪ1λûʱsize()
+		size_type find_next(size_type pos)const;
+
+		const word_type *data()const{ return words_.data(); }
+		string to_string()const;
+		void swap(dynamic_bitmap& bm);
+
+		friend std::ostream& operator <<(std::ostream& os, const dynamic_bitmap& bm);
+	private:
+		void clearTail();
+		void THROW(size_type n)const;
+		void checkSize(const dynamic_bitmap& bm)const;
+	};
+	dynamic_bitmap operator & (const dynamic_bitmap& lhs, const dynamic_bitmap& rhs);
+	dynamic_bitmap operator | (const dynamic_bitmap& lhs, const dynamic_bitmap& rhs);
+	dynamic_bitmap operator ^ (const dynamic_bitmap& lhs, const dynamic_bitmap& rhs);
+
+	//the class of roaring_bitmap
+	//ѹuint32_tϣ16λͰÿͰһ16λ
+	//ﲻ4096Ԫʱuint16_t飬65536λλͼʽ8KB
+	//ϡļֻռĿռ䣬ܵļϰλͼ
+	class roaring_bitmap{
+	private:
+		struct container{
+			uint16_t key;
+			uint32_t cardinality;
+			std::vector<uint16_t> array;
+			std::vector<uint64_t> bits;//ǿʱλͼ
+			explicit container(uint16_t k = 0) :key(k), cardinality(0){}
+			bool is_bitmap()const{ return !bits.empty(); }
+		};
+		enum { array_max = 4096, bitmap_words = 1024, bitmap_bits = 65536 };
+		enum op_type{ op_and, op_or, op_xor, op_andnot };
+	public:
+		typedef uint32_t value_type;
+		typedef size_t size_type;
+
+		class const_iterator : public iterator<forward_iterator_tag, uint32_t>{
+			friend class roaring_bitmap;
+		private:
+			const roaring_bitmap *bm_;
+			size_type index_;//ڼ
+			size_type pos_;//е±λͼеλ
+			const_iterator(const roaring_bitmap *bm, size_type index);
+		public:
+			const_iterator() :bm_(0), index_(0), pos_(0){}
+			uint32_t operator *()const;
+			const_iterator& operator ++();
+			const_iterator operator ++(int){ const_iterator temp = *this; ++*this; return temp; }
+			bool operator ==(const const_iterator& it)const{ return bm_ == it.bm_ && index_ == it.index_ && pos_ == it.pos_; }
+			bool operator !=(const const_iterator& it)const{ return !(*this == it); }
+		};
+		typedef const_iterator iterator;
+	private:
+		std::vector<container> containers_;//key
+		size_type size_;
+	public:
+		roaring_bitmap() :size_(0){}
+		template<class InputIterator>
+		roaring_bitmap(InputIterator first, InputIterator last);
+		roaring_bitmap(roaring_bitmap&& bm);
+		roaring_bitmap& operator = (roaring_bitmap&& bm);
+		roaring_bitmap(const roaring_bitmap&) = default;
+		roaring_bitmap& operator = (const roaring_bitmap&) = default;
+
+		size_type size()const{ return size_; }
+		bool empty()const{ return size_ == 0; }
+		//Ԫռõֽ
+		size_type bytes()const;
+		void clear(){ containers_.clear(); size_ = 0; }
+
+		bool insert(uint32_t val);
+		bool erase(uint32_t val);
+		bool contains(uint32_t val)const;
+
+		const_iterator begin()const{ return const_iterator(this, 0); }
+		const_iterator end()const{ return const_iterator(this, containers_.size()); }
+
+		roaring_bitmap& operator &= (const roaring_bitmap& bm){ apply(bm, op_and); return *this; }
+		roaring_bitmap& operator |= (const roaring_bitmap& bm){ apply(bm, op_or); return *this; }
+		roaring_bitmap& operator ^= (const roaring_bitmap& bm){ apply(bm, op_xor); return *this; }
+		//*this &= ~bm
+		roaring_bitmap& and_not(const roaring_bitmap& bm){ apply(bm, op_andnot); return *this; }
+		bool operator == (const roaring_bitmap& bm)const;
+		bool operator != (const roaring_bitmap& bm)const{ return !(*this == bm); }
+
+		void swap(roaring_bitmap& bm);
+	private:
+		size_type lower_bound(uint16_t key)const;
+		void apply(const roaring_bitmap& bm, op_type op);
+		static void combine(container& c, const container& other, op_type op);
+		static void to_bitmap(container& c);
+		static void to_array(container& c);
+		//cardinalityʽ֮ת
+		static void normalize(container& c);
+	};
+	roaring_bitmap operator & (const roaring_bitmap& lhs, const roaring_bitmap& rhs);
+	roaring_bitmap operator | (const roaring_bitmap& lhs, const roaring_bitmap& rhs);
+	roaring_bitmap operator ^ (const roaring_bitmap& lhs, const roaring_bitmap& rhs);
 }
 
 #include "Detail\Bitmap.impl.h"
-#endif
\ No newline at end of file
+#endif
@@ -36,6 +36,7 @@ namespace TinySTL{
 		explicit cow_ptr(T *p = nullptr);
 		template<class D>
 		cow_ptr(T *p, D d);
+		explicit cow_ptr(const shared_ptr<T>& sp);
 
 		cow_ptr(const cow_ptr& cp);
 		cow_ptr& operator = (const cow_ptr& cp);
@@ -49,6 +50,9 @@ namespace TinySTL{
 		const element_type *get()const;
 
 		operator bool() const;
+	private:
+		//д֮ǰȷֻԼж
+		void detach();
 	private:
 		shared_ptr<element_type> ptr_;
 	public:
@@ -70,8 +74,8 @@ namespace TinySTL{
 	};
 
 	template<class T, class... Args>
-	cow_ptr<T> make_cow(Args...args){
-		return cow_ptr<T>(new T(std::forward<Args>(args)...));
+	cow_ptr<T> make_cow(Args&&... args){
+		return cow_ptr<T>(make_shared<T>(std::forward<Args>(args)...));
 	}
 }
 
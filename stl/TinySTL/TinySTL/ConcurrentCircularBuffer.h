@@ -0,0 +1,214 @@
+#ifndef _CONCURRENT_CIRCULAR_BUFFER_H_
+#define _CONCURRENT_CIRCULAR_BUFFER_H_
+
+#include "Allocator.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#include <emmintrin.h>
+#define TINYSTL_CPU_RELAX() _mm_pause()
+#else
+#define TINYSTL_CPU_RELAX() ((void)0)
+#endif
+
+namespace TinySTL{
+	namespace Detail{
+		enum { cache_line_size = 64 };
+
+		template<size_t N>
+		struct is_power_of_two{
+			static const bool value = N != 0 && (N & (N - 1)) == 0;
+		};
+
+		///߸Զռ±꣬һcache lineα
+		//cache_ŶԷ±ıظֻп/ʱȥԷԭӱ
+		struct padded_index{
+			std::atomic<size_t> value_;
+			size_t cache_;
+			char pad_[cache_line_size - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+
+			padded_index() :value_(0), cache_(0){}
+		};
+	}
+
+	//ȴԣwait(pred)һֱȵpred()truenotify()һγɹ/֮
+	//predͻ/ӣwaitʱѾ
+	struct spin_wait{
+		template<class Pred>
+		void wait(Pred pred){
+			while (!pred())
+				TINYSTL_CPU_RELAX();
+		}
+		void notify(){}
+	};
+	struct yield_wait{
+		template<class Pred>
+		void wait(Pred pred){
+			for (unsigned i = 0; !pred(); ++i){
+				if (i < 64)
+					TINYSTL_CPU_RELAX();
+				else
+					std::this_thread::yield();
+			}
+		}
+		void notify(){}
+	};
+	//һСΣٹ
+	//waiters_ͶԷ±֮seq_cst֤ᶪʧ
+	class blocking_wait{
+	private:
+		std::mutex mtx_;
+		std::condition_variable cond_;
+		std::atomic<int> waiters_;
+	public:
+		blocking_wait() :waiters_(0){}
+
+		template<class Pred>
+		void wait(Pred pred){
+			for (int i = 0; i != 64; ++i){
+				if (pred())
+					return;
+				TINYSTL_CPU_RELAX();
+			}
+			++waiters_;
+			{
+				std::unique_lock<std::mutex> lock(mtx_);
+				cond_.wait(lock, pred);
+			}
+			--waiters_;
+		}
+		void notify(){
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (waiters_.load(std::memory_order_relaxed) != 0){
+				{ std::lock_guard<std::mutex> lock(mtx_); }
+				cond_.notify_all();
+			}
+		}
+	};
+
+	//the class of spsc_circular_buffer
+	//ߵߵζУtry_*wait-free
+	//N2ݣhead_/tail_ǵļN - 1õλ
+	template<class T, size_t N, class Alloc = allocator<T>, class Wait = yield_wait>
+	class spsc_circular_buffer{
+		static_assert(Detail::is_power_of_two<N>::value, "N must be a power of two");
+	public:
+		typedef T				value_type;
+		typedef T&				reference;
+		typedef size_t			size_type;
+	private:
+		enum { mask = N - 1 };
+		char padFront_[Detail::cache_line_size];
+		Detail::padded_index head_;//дcache_tail_
+		Detail::padded_index tail_;//дcache_head_
+		T *start_;
+		Wait waiter_;
+
+		typedef Alloc dataAllocator;
+	public:
+		spsc_circular_buffer() :start_(dataAllocator::allocate(N)){}
+		spsc_circular_buffer(const spsc_circular_buffer&) = delete;
+		spsc_circular_buffer& operator = (const spsc_circular_buffer&) = delete;
+		~spsc_circular_buffer();
+
+		//ֻ˶ֹʱǾȷ
+		size_type size()const;
+		bool empty()const{ return size() == 0; }
+		bool full()const{ return size() == N; }
+		size_type capacity()const{ return N; }
+
+		//̵ֻ߳
+		bool try_push(const T& val);
+		bool try_push(T&& val);
+		void push(const T& val);
+		void push(T&& val);
+		template<class InputIterator>
+		size_type try_push_n(InputIterator first, size_type n);//ʵӵĸ
+		template<class InputIterator>
+		void push_n(InputIterator first, size_type n);
+
+		//̵ֻ߳
+		bool try_pop(T& val);
+		void pop(T& val);
+		template<class OutputIterator>
+		size_type try_pop_n(OutputIterator out, size_type n);//ʵʳӵĸ
+	private:
+		template<class U>
+		bool push_aux(U&& val);
+		bool pop_aux(T& val);
+		template<class InputIterator>
+		size_type push_n_aux(InputIterator& first, size_type n);
+		template<class OutputIterator>
+		size_type pop_n_aux(OutputIterator& out, size_type n);
+	};//end of spsc_circular_buffer
+
+	//the class of mpmc_circular_buffer
+	//߶ߵн(Dmitry Vyukov㷨)
+	//ÿλһţseq == posʾдseq == pos + 1ʾɶ
+	template<class T, size_t N, class Wait = yield_wait>
+	class mpmc_circular_buffer{
+		static_assert(Detail::is_power_of_two<N>::value, "N must be a power of two");
+	public:
+		typedef T				value_type;
+		typedef T&				reference;
+		typedef size_t			size_type;
+	private:
+		struct cell{
+			std::atomic<size_t> seq_;
+			typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type storage_;
+
+			T *data(){ return reinterpret_cast<T *>(&storage_); }
+		};
+		enum { mask = N - 1 };
+		char padFront_[Detail::cache_line_size];
+		Detail::padded_index head_;
+		Detail::padded_index tail_;
+		cell *cells_;
+		Wait waiter_;
+
+		typedef allocator<cell> cellAllocator;
+	public:
+		mpmc_circular_buffer();
+		mpmc_circular_buffer(const mpmc_circular_buffer&) = delete;
+		mpmc_circular_buffer& operator = (const mpmc_circular_buffer&) = delete;
+		~mpmc_circular_buffer();
+
+		size_type size()const;
+		bool empty()const{ return size() == 0; }
+		bool full()const{ return size() == N; }
+		size_type capacity()const{ return N; }
+
+		bool try_push(const T& val);
+		bool try_push(T&& val);
+		void push(const T& val);
+		void push(T&& val);
+		//һCASĶλ
+		template<class InputIterator>
+		size_type try_push_n(InputIterator first, size_type n);
+		template<class InputIterator>
+		void push_n(InputIterator first, size_type n);
+
+		bool try_pop(T& val);
+		void pop(T& val);
+		template<class OutputIterator>
+		size_type try_pop_n(OutputIterator out, size_type n);
+	private:
+		template<class U>
+		bool push_aux(U&& val);
+		bool pop_aux(T& val);
+		template<class InputIterator>
+		size_type push_n_aux(InputIterator& first, size_type n);
+		template<class OutputIterator>
+		size_type pop_n_aux(OutputIterator& out, size_type n);
+	};//end of mpmc_circular_buffer
+}
+
+#include "Detail\ConcurrentCircularBuffer.impl.h"
+#endif
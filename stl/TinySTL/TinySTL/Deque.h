@@ -6,10 +6,29 @@
 #include "ReverseIterator.h"
 #include "Utility.h"
 
+#include <utility>
+
 namespace TinySTL{
 	template<class T, class Alloc = allocator<T>>
 	class deque;
 	namespace Detail{
+		//deque޹صĲֻ֣ͨmapͬdequeһֵ
+		template<class T>
+		class dq_iter;
+		template<class T>
+		class deque_base{
+		private:
+			template<class T>
+			friend class dq_iter;
+		protected:
+			enum class EBucksSize{ BUCKSIZE = 64 };
+			size_t mapSize_;
+			T **map_;//map_[mapSize_]һָ룬ԽһͰĵָ
+		protected:
+			deque_base() :mapSize_(0), map_(0){}
+		public:
+			size_t getBuckSize()const{ return (size_t)EBucksSize::BUCKSIZE; }
+		};
 		//class of deque iterator
 		template<class T>
 		class dq_iter :public iterator<bidirectional_iterator_tag, T>{
@@ -18,7 +37,7 @@ namespace TinySTL{
 			friend class ::TinySTL::deque;
 		private:
 			//typedef TinySTL::deque<T>* cntrPtr;
-			typedef const ::TinySTL::deque<T>* cntrPtr;
+			typedef const deque_base<T>* cntrPtr;
 			size_t mapIndex_;
 			T *cur_;
 			cntrPtr container_;
@@ -61,11 +80,15 @@ namespace TinySTL{
 	}// end of Detail namespace
 
 	//class of deque
+	//ͰmapAlloc(rebind)䣬ԪͨAlloc
 	template<class T, class Alloc>
-	class deque{
+	class deque :public Detail::deque_base<T>{
 	private:
 		template<class T>
 		friend class ::TinySTL::Detail::dq_iter;
+		using Detail::deque_base<T>::mapSize_;
+		using Detail::deque_base<T>::map_;
+		using Detail::deque_base<T>::getBuckSize;
 	public:
 		typedef T value_type;
 		typedef Detail::dq_iter<T> iterator;
@@ -76,24 +99,27 @@ namespace TinySTL{
 		typedef ptrdiff_t difference_type;
 		typedef Alloc allocator_type;
 	private:
-		typedef Alloc dataAllocator;
-		enum class EBucksSize{BUCKSIZE = 64};
+		typedef typename Alloc::template rebind<T*>::other mapAllocator;
 	private:
 		iterator beg_, end_;
-		size_t mapSize_;
-		T **map_;
+		Alloc alloc_;
 	public:
 		deque();
-		explicit deque(size_type n, const value_type& val = value_type());
+		explicit deque(const Alloc& alloc);
+		explicit deque(size_type n, const value_type& val = value_type(), const Alloc& alloc = Alloc());
 		template <class InputIterator>
-		deque(InputIterator first, InputIterator last);
+		deque(InputIterator first, InputIterator last, const Alloc& alloc = Alloc());
 		deque(const deque& x);
+		deque(const deque& x, const Alloc& alloc);
+		deque(deque&& x);
 
 		~deque();
 
 		deque& operator= (const deque& x);
 		deque& operator= (deque&& x);
 
+		Alloc get_allocator()const{ return alloc_; }
+
 		iterator begin();
 		iterator end();
 		iterator begin()const;
@@ -110,7 +136,13 @@ namespace TinySTL{
 		const_reference back() const;
 
 		void push_back(const value_type& val);
+		void push_back(value_type&& val);
 		void push_front(const value_type& val);
+		void push_front(value_type&& val);
+		template<class... Args>
+		void emplace_back(Args&&... args);
+		template<class... Args>
+		void emplace_front(Args&&... args);
 		void pop_back();
 		void pop_front();
 		void swap(deque& x);
@@ -118,15 +150,16 @@ namespace TinySTL{
 	private:
 		T *getANewBuck();
 		T** getANewMap(const size_t size);
+		void freeMap(T **map, const size_t size);
+		void destroyElements();
 		size_t getNewMapSize(const size_t size);
-		size_t getBuckSize()const;
 		void init();
 		bool back_full()const;
 		bool front_full()const;
 		void deque_aux(size_t n, const value_type& val, std::true_type);
 		template<class Iterator>
 		void deque_aux(Iterator first, Iterator last, std::false_type);
-		void reallocateAndCopy();
+		void reallocateMap();
 	public:
 		template <class T, class Alloc>
 		friend bool operator== (const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs);
@@ -1,10 +1,14 @@
 #include "../Alloc.h"
 
+#include <cstring>
+#include <new>
+
 namespace TinySTL{
 
 	char *alloc::start_free = 0;
 	char *alloc::end_free = 0;
 	size_t alloc::heap_size = 0;
+	void(*alloc::allocate_hook)(size_t) = 0;
 
 	alloc::obj *alloc::free_list[alloc::ENFreeLists::NFREELISTS] = {
 		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -12,6 +16,8 @@ namespace TinySTL{
 
 	void *alloc::allocate(size_t bytes)
 	{
+		if (allocate_hook)
+			allocate_hook(bytes);
 		if (bytes > EMaxBytes::MAXBYTES)
 		{
 			return malloc(bytes);
@@ -46,12 +52,25 @@ namespace TinySTL{
 			free_list[index] = node;
 		}
 	}
+	//bug fix: ǰͷ·䣬ԭȫʧ
 	void *alloc::reallocate(void *ptr, size_t old_sz, size_t new_sz)
 	{
+		if (old_sz > EMaxBytes::MAXBYTES && new_sz > EMaxBytes::MAXBYTES)
+		{
+			//鶼mallocreallocڴʱԭչ
+			if (allocate_hook)
+				allocate_hook(new_sz);
+			void *result = realloc(ptr, new_sz);
+			if (!result)
+				throw std::bad_alloc();
+			return result;
+		}
+		if (old_sz <= EMaxBytes::MAXBYTES && new_sz <= EMaxBytes::MAXBYTES && ROUND_UP(old_sz) == ROUND_UP(new_sz))
+			return ptr;//ͬһfree-listϵ
+		void *result = allocate(new_sz);
+		memcpy(result, ptr, old_sz < new_sz ? old_sz : new_sz);
 		deallocate(ptr, old_sz);
-		ptr = allocate(new_sz);
-
-		return ptr;
+		return result;
 	}
 
 	//һСΪnĶ󣬲ʱΪʵfree listӽڵ
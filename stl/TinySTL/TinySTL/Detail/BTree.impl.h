@@ -0,0 +1,542 @@
+#ifndef _BTREE_IMPL_H_
+#define _BTREE_IMPL_H_
+
+namespace TinySTL{
+	namespace Detail{
+		//**********죬ƣ*****************
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		btree<Key, Value, KeyOfValue, Compare>::btree(const Compare& comp)
+			:root_(0), leftmost_(0), rightmost_(0), size_(0), comp_(comp){}
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		btree<Key, Value, KeyOfValue, Compare>::btree(const btree& bt)
+			: root_(0), leftmost_(0), rightmost_(0), size_(0), comp_(bt.comp_){
+			bulk_load(bt.begin(), bt.end());
+		}
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		btree<Key, Value, KeyOfValue, Compare>::btree(btree&& bt)
+			: root_(bt.root_), leftmost_(bt.leftmost_), rightmost_(bt.rightmost_), size_(bt.size_), comp_(bt.comp_){
+			bt.root_ = 0;
+			bt.leftmost_ = bt.rightmost_ = 0;
+			bt.size_ = 0;
+		}
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		btree<Key, Value, KeyOfValue, Compare>& btree<Key, Value, KeyOfValue, Compare>::operator = (const btree& bt){
+			if (this != &bt){
+				comp_ = bt.comp_;
+				bulk_load(bt.begin(), bt.end());
+			}
+			return *this;
+		}
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		btree<Key, Value, KeyOfValue, Compare>& btree<Key, Value, KeyOfValue, Compare>::operator = (btree&& bt){
+			if (this != &bt){
+				clear();
+				swap(bt);
+			}
+			return *this;
+		}
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		void btree<Key, Value, KeyOfValue, Compare>::swap(btree& bt){
+			TinySTL::swap(root_, bt.root_);
+			TinySTL::swap(leftmost_, bt.leftmost_);
+			TinySTL::swap(rightmost_, bt.rightmost_);
+			TinySTL::swap(size_, bt.size_);
+			TinySTL::swap(comp_, bt.comp_);
+		}
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		void btree<Key, Value, KeyOfValue, Compare>::clear(){
+			if (root_)
+				destroy_node(root_);
+			root_ = 0;
+			leftmost_ = rightmost_ = 0;
+			size_ = 0;
+		}
+		//**********ڵķͷ*****************
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		typename btree<Key, Value, KeyOfValue, Compare>::leaf *btree<Key, Value, KeyOfValue, Compare>::create_leaf(){
+			leaf *l = leafAllocator::allocate();
+			l->leaf_ = true;
+			l->count_ = 0;
+			l->prev_ = l->next_ = 0;
+			return l;
+		}
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		typename btree<Key, Value, KeyOfValue, Compare>::inner *btree<Key, Value, KeyOfValue, Compare>::create_inner(){
+			inner *n = innerAllocator::allocate();
+			n->leaf_ = false;
+			n->count_ = 0;
+			return n;
+		}
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		void btree<Key, Value, KeyOfValue, Compare>::destroy_node(btree_node *n){
+			if (n->leaf_){
+				leaf *l = static_cast<leaf *>(n);
+				for (size_t i = 0; i != l->count_; ++i)
+					l->value(i)->~Value();
+				leafAllocator::deallocate(l);
+			}
+			else{
+				inner *in = static_cast<inner *>(n);
+				for (size_t i = 0; i != in->count_; ++i)
+					in->key(i)->~Key();
+				for (size_t i = 0; i != in->count_ + 1u; ++i)
+					destroy_node(in->children_[i]);
+				innerAllocator::deallocate(in);
+			}
+		}
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		void btree<Key, Value, KeyOfValue, Compare>::unlink_leaf(leaf *l){
+			if (l->prev_)
+				l->prev_->next_ = l->next_;
+			else
+				leftmost_ = l->next_;
+			if (l->next_)
+				l->next_->prev_ = l->prev_;
+			else
+				rightmost_ = l->prev_;
+		}
+		//**********ڵڵĲ*****************
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		size_t btree<Key, Value, KeyOfValue, Compare>::leaf_lower(leaf *l, const Key& k)const{
+			size_t lo = 0, hi = l->count_;
+			while (lo < hi){
+				size_t mid = (lo + hi) / 2;
+				if (comp_(key_of(*l->value(mid)), k))
+					lo = mid + 1;
+				else
+					hi = mid;
+			}
+			return lo;
+		}
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		size_t btree<Key, Value, KeyOfValue, Compare>::leaf_upper(leaf *l, const Key& k)const{
+			size_t lo = 0, hi = l->count_;
+			while (lo < hi){
+				size_t mid = (lo + hi) / 2;
+				if (comp_(k, key_of(*l->value(mid))))
+					hi = mid;
+				else
+					lo = mid + 1;
+			}
+			return lo;
+		}
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		size_t btree<Key, Value, KeyOfValue, Compare>::inner_upper(inner *n, const Key& k)const{
+			size_t lo = 0, hi = n->count_;
+			while (lo < hi){
+				size_t mid = (lo + hi) / 2;
+				if (comp_(k, *n->key(mid)))
+					hi = mid;
+				else
+					lo = mid + 1;
+			}
+			return lo;
+		}
+		//ӸߵkڵҶӣpath/slot¼ڲڵԼߵǵڼ
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		typename btree<Key, Value, KeyOfValue, Compare>::leaf *btree<Key, Value, KeyOfValue, Compare>::descend(
+			const Key& k, inner **path, size_t *slot, size_t& depth)const{
+			btree_node *n = root_;
+			depth = 0;
+			while (!n->leaf_){
+				inner *in = static_cast<inner *>(n);
+				size_t i = inner_upper(in, k);
+				if (path){
+					path[depth] = in;
+					slot[depth] = i;
+				}
+				++depth;
+				n = in->children_[i];
+			}
+			return static_cast<leaf *>(n);
+		}
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		typename btree<Key, Value, KeyOfValue, Compare>::iterator
+			btree<Key, Value, KeyOfValue, Compare>::normalize(leaf *l, size_t pos){
+			if (pos == l->count_ && l->next_)
+				return iterator(l->next_, 0);
+			return iterator(l, pos);
+		}
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		typename btree<Key, Value, KeyOfValue, Compare>::iterator
+			btree<Key, Value, KeyOfValue, Compare>::lower_bound(const Key& k){
+			if (!root_)
+				return end();
+			size_t depth;
+			leaf *l = descend(k, 0, 0, depth);
+			return normalize(l, leaf_lower(l, k));
+		}
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		typename btree<Key, Value, KeyOfValue, Compare>::iterator
+			btree<Key, Value, KeyOfValue, Compare>::upper_bound(const Key& k){
+			if (!root_)
+				return end();
+			size_t depth;
+			leaf *l = descend(k, 0, 0, depth);
+			return normalize(l, leaf_upper(l, k));
+		}
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		typename btree<Key, Value, KeyOfValue, Compare>::iterator
+			btree<Key, Value, KeyOfValue, Compare>::find(const Key& k){
+			if (!root_)
+				return end();
+			size_t depth;
+			leaf *l = descend(k, 0, 0, depth);
+			size_t pos = leaf_lower(l, k);
+			//kһҶ
+			if (pos == l->count_ || comp_(k, key_of(*l->value(pos))))
+				return end();
+			return iterator(l, pos);
+		}
+		//**********ڵڵƶ*****************
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		void btree<Key, Value, KeyOfValue, Compare>::leaf_insert(leaf *l, size_t pos, const Value& val){
+			for (size_t i = l->count_; i != pos; --i){
+				new(l->value(i)) Value(std::move(*l->value(i - 1)));
+				l->value(i - 1)->~Value();
+			}
+			new(l->value(pos)) Value(val);
+			++l->count_;
+		}
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		void btree<Key, Value, KeyOfValue, Compare>::leaf_erase(leaf *l, size_t pos){
+			l->value(pos)->~Value();
+			for (size_t i = pos + 1; i != l->count_; ++i){
+				new(l->value(i - 1)) Value(std::move(*l->value(i)));
+				l->value(i)->~Value();
+			}
+			--l->count_;
+		}
+		//from[first, last)׷ӵtoĩβfromlast֮Ԫǰ
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		void btree<Key, Value, KeyOfValue, Compare>::leaf_move(leaf *from, size_t first, size_t last, leaf *to){
+			for (size_t i = first; i != last; ++i){
+				new(to->value(to->count_++)) Value(std::move(*from->value(i)));
+				from->value(i)->~Value();
+			}
+			size_t n = last - first;
+			for (size_t i = last; i != from->count_; ++i){
+				new(from->value(i - n)) Value(std::move(*from->value(i)));
+				from->value(i)->~Value();
+			}
+			from->count_ -= (unsigned short)n;
+		}
+		//keys[i]kchildren[i + 1]child
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		void btree<Key, Value, KeyOfValue, Compare>::inner_insert(inner *n, size_t i, const Key& k, btree_node *child){
+			for (size_t j = n->count_; j != i; --j){
+				new(n->key(j)) Key(std::move(*n->key(j - 1)));
+				n->key(j - 1)->~Key();
+				n->children_[j + 1] = n->children_[j];
+			}
+			new(n->key(i)) Key(k);
+			n->children_[i + 1] = child;
+			++n->count_;
+		}
+		//ɾkeys[i]children[i + 1]
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		void btree<Key, Value, KeyOfValue, Compare>::inner_erase(inner *n, size_t i){
+			n->key(i)->~Key();
+			for (size_t j = i + 1; j != n->count_; ++j){
+				new(n->key(j - 1)) Key(std::move(*n->key(j)));
+				n->key(j)->~Key();
+				n->children_[j] = n->children_[j + 1];
+			}
+			--n->count_;
+		}
+		//***************************
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		pair<typename btree<Key, Value, KeyOfValue, Compare>::iterator, bool>
+			btree<Key, Value, KeyOfValue, Compare>::insert_unique(const Value& val){
+			const Key& k = key_of(val);
+			if (!root_){
+				leaf *l = create_leaf();
+				root_ = leftmost_ = rightmost_ = l;
+			}
+			inner *path[max_height];
+			size_t slot[max_height], depth;
+			leaf *l = descend(k, path, slot, depth);
+			size_t pos = leaf_lower(l, k);
+			if (pos != l->count_ && !comp_(k, key_of(*l->value(pos))))
+				return pair<iterator, bool>(iterator(l, pos), false);
+
+			++size_;
+			if (l->count_ != leaf::capacity){
+				leaf_insert(l, pos, val);
+				return pair<iterator, bool>(iterator(l, pos), true);
+			}
+			//Ҷˣѳ
+			//Ҷӵĩβʱƽ֣˳ԵõȫҶ
+			leaf *r = create_leaf();
+			size_t mid = (l == rightmost_ && pos == l->count_) ? l->count_ : leaf::capacity / 2;
+			leaf_move(l, mid, l->count_, r);
+			r->prev_ = l;
+			r->next_ = l->next_;
+			if (l->next_)
+				l->next_->prev_ = r;
+			else
+				rightmost_ = r;
+			l->next_ = r;
+
+			iterator res;
+			if (pos >= mid){
+				leaf_insert(r, pos - mid, val);
+				res = iterator(r, pos - mid);
+			}
+			else{
+				leaf_insert(l, pos, val);
+				res = iterator(l, pos);
+			}
+			insert_into_parent(path, slot, depth, key_of(*r->value(0)), r);
+			return pair<iterator, bool>(res, true);
+		}
+		//(sep, right)뵽path[depth - 1]ڵ˾ͼϷ
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		void btree<Key, Value, KeyOfValue, Compare>::insert_into_parent(
+			inner **path, size_t *slot, size_t depth, Key sep, btree_node *right){
+			while (depth != 0){
+				inner *p = path[--depth];
+				size_t i = slot[depth];
+				if (p->count_ != inner::capacity){
+					inner_insert(p, i, sep, right);
+					return;
+				}
+				//keys[mid]ƣ[0, mid)ұ(mid, count)
+				inner *q = create_inner();
+				size_t mid = p->count_ / 2;
+				for (size_t j = mid + 1; j != p->count_; ++j){
+					new(q->key(q->count_)) Key(std::move(*p->key(j)));
+					p->key(j)->~Key();
+					q->children_[q->count_++] = p->children_[j];
+				}
+				q->children_[q->count_] = p->children_[p->count_];
+				Key up(std::move(*p->key(mid)));
+				p->key(mid)->~Key();
+				p->count_ = (unsigned short)mid;
+
+				if (i <= mid)
+					inner_insert(p, i, sep, right);
+				else
+					inner_insert(q, i - mid - 1, sep, right);
+				sep = std::move(up);
+				right = q;
+			}
+			//ѣһ
+			inner *root = create_inner();
+			new(root->key(0)) Key(sep);
+			root->children_[0] = root_;
+			root->children_[1] = right;
+			root->count_ = 1;
+			root_ = root;
+		}
+		//**********ɾ*****************
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		typename btree<Key, Value, KeyOfValue, Compare>::size_type
+			btree<Key, Value, KeyOfValue, Compare>::erase_unique(const Key& k){
+			if (!root_)
+				return 0;
+			inner *path[max_height];
+			size_t slot[max_height], depth;
+			leaf *l = descend(k, path, slot, depth);
+			size_t pos = leaf_lower(l, k);
+			if (pos == l->count_ || comp_(k, key_of(*l->value(pos))))
+				return 0;
+			leaf_erase(l, pos);
+			--size_;
+
+			if (depth == 0){
+				if (l->count_ == 0)
+					clear();
+				return 1;
+			}
+			//ڵеķָkeyҪ£Ȼȷػ
+			if (l->count_ >= leaf_min)
+				return 1;
+			rebalance_leaf(l, path[depth - 1], slot[depth - 1]);
+			for (size_t level = depth - 1;; --level){
+				inner *n = path[level];
+				if (level == 0){
+					if (n->count_ == 0){//ֻʣһӣ䰫һ
+						root_ = n->children_[0];
+						innerAllocator::deallocate(n);
+					}
+					break;
+				}
+				if (n->count_ >= inner_min)
+					break;
+				rebalance_inner(n, path[level - 1], slot[level - 1]);
+			}
+			return 1;
+		}
+		//lparentĵiӣԪزʱֵܽһֵҲͺϲ
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		void btree<Key, Value, KeyOfValue, Compare>::rebalance_leaf(leaf *l, inner *parent, size_t i){
+			if (i != 0){
+				leaf *left = static_cast<leaf *>(parent->children_[i - 1]);
+				if (left->count_ > leaf_min){
+					leaf_insert(l, 0, *left->value(left->count_ - 1));
+					leaf_erase(left, left->count_ - 1);
+					*parent->key(i - 1) = key_of(*l->value(0));
+				}
+				else{
+					leaf_move(l, 0, l->count_, left);
+					unlink_leaf(l);
+					leafAllocator::deallocate(l);
+					inner_erase(parent, i - 1);
+				}
+			}
+			else{
+				leaf *right = static_cast<leaf *>(parent->children_[1]);
+				if (right->count_ > leaf_min){
+					leaf_move(right, 0, 1, l);
+					*parent->key(0) = key_of(*right->value(0));
+				}
+				else{
+					leaf_move(right, 0, right->count_, l);
+					unlink_leaf(right);
+					leafAllocator::deallocate(right);
+					inner_erase(parent, 0);
+				}
+			}
+		}
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		void btree<Key, Value, KeyOfValue, Compare>::rebalance_inner(inner *n, inner *parent, size_t i){
+			if (i != 0){
+				inner *left = static_cast<inner *>(parent->children_[i - 1]);
+				if (left->count_ > inner_min){//ڵתһkey
+					inner_insert(n, 0, *parent->key(i - 1), n->children_[0]);
+					n->children_[0] = left->children_[left->count_];
+					*parent->key(i - 1) = std::move(*left->key(left->count_ - 1));
+					left->key(left->count_ - 1)->~Key();
+					--left->count_;
+				}
+				else{//left + ָkey + n
+					new(left->key(left->count_)) Key(*parent->key(i - 1));
+					left->children_[++left->count_] = n->children_[0];
+					for (size_t j = 0; j != n->count_; ++j){
+						new(left->key(left->count_)) Key(std::move(*n->key(j)));
+						n->key(j)->~Key();
+						left->children_[++left->count_] = n->children_[j + 1];
+					}
+					innerAllocator::deallocate(n);
+					inner_erase(parent, i - 1);
+				}
+			}
+			else{
+				inner *right = static_cast<inner *>(parent->children_[1]);
+				if (right->count_ > inner_min){//ڵתһkey
+					new(n->key(n->count_)) Key(*parent->key(0));
+					n->children_[++n->count_] = right->children_[0];
+					*parent->key(0) = std::move(*right->key(0));
+					right->children_[0] = right->children_[1];
+					inner_erase(right, 0);
+				}
+				else{//n + ָkey + right
+					new(n->key(n->count_)) Key(*parent->key(0));
+					n->children_[++n->count_] = right->children_[0];
+					for (size_t j = 0; j != right->count_; ++j){
+						new(n->key(n->count_)) Key(std::move(*right->key(j)));
+						right->key(j)->~Key();
+						n->children_[++n->count_] = right->children_[j + 1];
+					}
+					innerAllocator::deallocate(right);
+					inner_erase(parent, 0);
+				}
+			}
+		}
+		//***************************
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		template<class ForwardIterator>
+		void btree<Key, Value, KeyOfValue, Compare>::bulk_load(ForwardIterator first, ForwardIterator last){
+			clear();
+			size_t n = 0;
+			for (ForwardIterator it = first; it != last; ++it)
+				++n;
+			if (n == 0)
+				return;
+
+			//Ԫƽֵceil(n / capacity)ҶÿҶٰ
+			vector<btree_node *> level;
+			size_t groups = (n + leaf::capacity - 1) / leaf::capacity;
+			leaf *prev = 0;
+			for (size_t g = 0; g != groups; ++g){
+				size_t take = n / groups + (g < n % groups ? 1 : 0);
+				leaf *l = create_leaf();
+				for (size_t j = 0; j != take; ++j, ++first){
+					new(l->value(j)) Value(*first);
+					l->count_ = (unsigned short)(j + 1);
+					assert(j == 0 || comp_(key_of(*l->value(j - 1)), key_of(*l->value(j))));
+				}
+				assert(prev == 0 || comp_(key_of(*prev->value(prev->count_ - 1)), key_of(*l->value(0))));
+				l->prev_ = prev;
+				if (prev)
+					prev->next_ = l;
+				else
+					leftmost_ = l;
+				prev = l;
+				level.push_back(l);
+			}
+			rightmost_ = prev;
+			size_ = n;
+
+			//ϣÿڲڵcapacity + 1ӣָkeyȡұСkey
+			while (level.size() != 1){
+				vector<btree_node *> upper;
+				size_t m = level.size();
+				groups = (m + inner::capacity) / (inner::capacity + 1);
+				for (size_t g = 0, c = 0; g != groups; ++g){
+					size_t take = m / groups + (g < m % groups ? 1 : 0);
+					inner *in = create_inner();
+					in->children_[0] = level[c];
+					for (size_t j = 1; j != take; ++j){
+						new(in->key(in->count_)) Key(min_key(level[c + j]));
+						in->children_[++in->count_] = level[c + j];
+					}
+					c += take;
+					upper.push_back(in);
+				}
+				level.swap(upper);
+			}
+			root_ = level[0];
+		}
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		const Key& btree<Key, Value, KeyOfValue, Compare>::min_key(btree_node *n){
+			while (!n->leaf_)
+				n = static_cast<inner *>(n)->children_[0];
+			return key_of(*static_cast<leaf *>(n)->value(0));
+		}
+		//**********ͳ*****************
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		typename btree<Key, Value, KeyOfValue, Compare>::size_type
+			btree<Key, Value, KeyOfValue, Compare>::height()const{
+			if (!root_)
+				return 0;
+			size_t depth;
+			descend(key_of(*leftmost_->value(0)), 0, 0, depth);
+			return depth + 1;
+		}
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		typename btree<Key, Value, KeyOfValue, Compare>::size_type
+			btree<Key, Value, KeyOfValue, Compare>::count_nodes(btree_node *n, size_type& leaves)const{
+			if (n->leaf_){
+				++leaves;
+				return 0;
+			}
+			inner *in = static_cast<inner *>(n);
+			size_type inners = 1;
+			for (size_t i = 0; i != in->count_ + 1u; ++i)
+				inners += count_nodes(in->children_[i], leaves);
+			return inners;
+		}
+		template<class Key, class Value, class KeyOfValue, class Compare>
+		typename btree<Key, Value, KeyOfValue, Compare>::size_type
+			btree<Key, Value, KeyOfValue, Compare>::memory_usage()const{
+			size_type leaves = 0, inners = 0;
+			if (root_)
+				inners = count_nodes(root_, leaves);
+			return leaves * sizeof(leaf) + inners * sizeof(inner);
+		}
+	}//end of Detail namespace
+}
+
+#endif
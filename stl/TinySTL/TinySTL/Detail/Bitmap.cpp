@@ -0,0 +1,544 @@
+#include "../Bitmap.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+//AVX2ÿδ4֣x64SSE2ÿδ2
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BITMAP_AVX2
+#define BITMAP_SIMD
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BITMAP_SIMD
+#endif
+
+namespace TinySTL{
+	namespace Detail{
+		namespace{
+#if defined(BITMAP_AVX2)
+			typedef __m256i vec_type;
+			enum { vec_words = 4 };
+			inline vec_type load(const uint64_t *p){ return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+			inline void store(uint64_t *p, vec_type v){ _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+			inline bool is_zero(vec_type v){ return _mm256_testz_si256(v, v) != 0; }
+			inline vec_type vec_and(vec_type a, vec_type b){ return _mm256_and_si256(a, b); }
+			inline vec_type vec_or(vec_type a, vec_type b){ return _mm256_or_si256(a, b); }
+			inline vec_type vec_xor(vec_type a, vec_type b){ return _mm256_xor_si256(a, b); }
+			inline vec_type vec_andnot(vec_type a, vec_type b){ return _mm256_andnot_si256(b, a); }
+			//ֽڲÿֽ1ĸsadӳ464λĺ
+			inline vec_type popcount256(vec_type v){
+				const vec_type lookup = _mm256_setr_epi8(
+					0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+					0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+				const vec_type low = _mm256_set1_epi8(0x0f);
+				vec_type lo = _mm256_and_si256(v, low);
+				vec_type hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low);
+				vec_type cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+				return _mm256_sad_epu8(cnt, _mm256_setzero_si256());
+			}
+#elif defined(BITMAP_SIMD)
+			typedef __m128i vec_type;
+			enum { vec_words = 2 };
+			inline vec_type load(const uint64_t *p){ return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+			inline void store(uint64_t *p, vec_type v){ _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v); }
+			inline bool is_zero(vec_type v){ return _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())) == 0xffff; }
+			inline vec_type vec_and(vec_type a, vec_type b){ return _mm_and_si128(a, b); }
+			inline vec_type vec_or(vec_type a, vec_type b){ return _mm_or_si128(a, b); }
+			inline vec_type vec_xor(vec_type a, vec_type b){ return _mm_xor_si128(a, b); }
+			inline vec_type vec_andnot(vec_type a, vec_type b){ return _mm_andnot_si128(b, a); }
+#endif
+			struct and_op{
+				uint64_t operator ()(uint64_t a, uint64_t b)const{ return a & b; }
+#ifdef BITMAP_SIMD
+				vec_type operator ()(vec_type a, vec_type b)const{ return vec_and(a, b); }
+#endif
+			};
+			struct or_op{
+				uint64_t operator ()(uint64_t a, uint64_t b)const{ return a | b; }
+#ifdef BITMAP_SIMD
+				vec_type operator ()(vec_type a, vec_type b)const{ return vec_or(a, b); }
+#endif
+			};
+			struct xor_op{
+				uint64_t operator ()(uint64_t a, uint64_t b)const{ return a ^ b; }
+#ifdef BITMAP_SIMD
+				vec_type operator ()(vec_type a, vec_type b)const{ return vec_xor(a, b); }
+#endif
+			};
+			struct andnot_op{
+				uint64_t operator ()(uint64_t a, uint64_t b)const{ return a & ~b; }
+#ifdef BITMAP_SIMD
+				vec_type operator ()(vec_type a, vec_type b)const{ return vec_andnot(a, b); }
+#endif
+			};
+			template<class Op>
+			void apply_words(uint64_t *dst, const uint64_t *src, size_t n, Op op){
+				size_t i = 0;
+#ifdef BITMAP_SIMD
+				for (; i + vec_words <= n; i += vec_words)
+					store(dst + i, op(load(dst + i), load(src + i)));
+#endif
+				for (; i != n; ++i)
+					dst[i] = op(dst[i], src[i]);
+			}
+		}
+
+		size_t popcount_words(const uint64_t *p, size_t n){
+			size_t i = 0, sum = 0;
+#ifdef BITMAP_AVX2
+			vec_type acc = _mm256_setzero_si256();
+			for (; i + vec_words <= n; i += vec_words)
+				acc = _mm256_add_epi64(acc, popcount256(load(p + i)));
+			uint64_t lanes[4];
+			store(lanes, acc);
+			sum = size_t(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+#endif
+			for (; i != n; ++i)
+				sum += popcount64(p[i]);
+			return sum;
+		}
+		void and_words(uint64_t *dst, const uint64_t *src, size_t n){
+			apply_words(dst, src, n, and_op());
+		}
+		void or_words(uint64_t *dst, const uint64_t *src, size_t n){
+			apply_words(dst, src, n, or_op());
+		}
+		void xor_words(uint64_t *dst, const uint64_t *src, size_t n){
+			apply_words(dst, src, n, xor_op());
+		}
+		void andnot_words(uint64_t *dst, const uint64_t *src, size_t n){
+			apply_words(dst, src, n, andnot_op());
+		}
+		size_t find_next_words(const uint64_t *p, size_t n, size_t pos){
+			size_t i = pos / 64;
+			if (i >= n)
+				return n * 64;
+			uint64_t w = p[i] & (~uint64_t(0) << (pos % 64));
+			if (w)
+				return i * 64 + ctz64(w);
+			++i;
+#ifdef BITMAP_SIMD
+			//Ϊ0ʱһ
+			for (; i + vec_words <= n && is_zero(load(p + i)); i += vec_words)
+				;
+#endif
+			for (; i != n; ++i){
+				if (p[i])
+					return i * 64 + ctz64(p[i]);
+			}
+			return n * 64;
+		}
+	}
+
+	//******************************dynamic_bitmap*****************************
+	dynamic_bitmap::dynamic_bitmap(size_type n, bool val)
+		:words_((n + WORD_BITS - 1) / WORD_BITS, val ? ~word_type(0) : 0), size_(n){
+		clearTail();
+	}
+	dynamic_bitmap::dynamic_bitmap(dynamic_bitmap&& bm) :words_(std::move(bm.words_)), size_(bm.size_){
+		bm.size_ = 0;
+	}
+	dynamic_bitmap& dynamic_bitmap::operator = (dynamic_bitmap&& bm){
+		if (this != &bm){
+			words_ = std::move(bm.words_);
+			size_ = bm.size_;
+			bm.words_.clear();
+			bm.size_ = 0;
+		}
+		return *this;
+	}
+	void dynamic_bitmap::clearTail(){
+		if (size_ % WORD_BITS)
+			words_.back() &= (word_type(1) << (size_ % WORD_BITS)) - 1;
+	}
+	void dynamic_bitmap::THROW(size_type n)const{
+		if (n >= size_)
+			throw std::out_of_range("Out Of Range");
+	}
+	void dynamic_bitmap::checkSize(const dynamic_bitmap& bm)const{
+		if (size_ != bm.size_)
+			throw std::invalid_argument("dynamic_bitmap: size mismatch");
+	}
+	bool dynamic_bitmap::test(size_type pos)const{
+		THROW(pos);
+		return (words_[pos / WORD_BITS] >> (pos % WORD_BITS)) & 1;
+	}
+	bool dynamic_bitmap::any()const{
+		return find_first() != size_;
+	}
+	dynamic_bitmap& dynamic_bitmap::set(){
+		std::fill(words_.begin(), words_.end(), ~word_type(0));
+		clearTail();
+		return *this;
+	}
+	dynamic_bitmap& dynamic_bitmap::set(size_type pos, bool val){
+		THROW(pos);
+		const word_type mask = word_type(1) << (pos % WORD_BITS);
+		if (val)
+			words_[pos / WORD_BITS] |= mask;
+		else
+			words_[pos / WORD_BITS] &= ~mask;
+		return *this;
+	}
+	dynamic_bitmap& dynamic_bitmap::reset(){
+		std::fill(words_.begin(), words_.end(), word_type(0));
+		return *this;
+	}
+	dynamic_bitmap& dynamic_bitmap::flip(){
+		for (size_type i = 0; i != words_.size(); ++i)
+			words_[i] = ~words_[i];
+		clearTail();
+		return *this;
+	}
+	dynamic_bitmap& dynamic_bitmap::flip(size_type pos){
+		THROW(pos);
+		words_[pos / WORD_BITS] ^= word_type(1) << (pos % WORD_BITS);
+		return *this;
+	}
+	void dynamic_bitmap::resize(size_type n, bool val){
+		if (n > size_ && val && size_ % WORD_BITS)
+			words_.back() |= ~word_type(0) << (size_ % WORD_BITS);
+		words_.resize((n + WORD_BITS - 1) / WORD_BITS, val ? ~word_type(0) : 0);
+		size_ = n;
+		clearTail();
+	}
+	void dynamic_bitmap::push_back(bool val){
+		if (size_ % WORD_BITS == 0)
+			words_.push_back(0);
+		if (val)
+			words_.back() |= word_type(1) << (size_ % WORD_BITS);
+		++size_;
+	}
+	dynamic_bitmap& dynamic_bitmap::operator &= (const dynamic_bitmap& bm){
+		checkSize(bm);
+		Detail::and_words(words_.data(), bm.words_.data(), words_.size());
+		return *this;
+	}
+	dynamic_bitmap& dynamic_bitmap::operator |= (const dynamic_bitmap& bm){
+		checkSize(bm);
+		Detail::or_words(words_.data(), bm.words_.data(), words_.size());
+		return *this;
+	}
+	dynamic_bitmap& dynamic_bitmap::operator ^= (const dynamic_bitmap& bm){
+		checkSize(bm);
+		Detail::xor_words(words_.data(), bm.words_.data(), words_.size());
+		return *this;
+	}
+	dynamic_bitmap& dynamic_bitmap::and_not(const dynamic_bitmap& bm){
+		checkSize(bm);
+		Detail::andnot_words(words_.data(), bm.words_.data(), words_.size());
+		return *this;
+	}
+	dynamic_bitmap dynamic_bitmap::operator ~()const{
+		dynamic_bitmap bm(*this);
+		bm.flip();
+		return bm;
+	}
+	dynamic_bitmap::size_type dynamic_bitmap::find_first()const{
+		return find_next(size_type(-1));
+	}
+	string dynamic_bitmap::to_string()const{
+		string str;
+		str.reserve(size_);
+		for (size_type i = 0; i != size_; ++i)
+			str.push_back(((words_[i / WORD_BITS] >> (i % WORD_BITS)) & 1) ? '1' : '0');
+		return str;
+	}
+	void dynamic_bitmap::swap(dynamic_bitmap& bm){
+		words_.swap(bm.words_);
+		std::swap(size_, bm.size_);
+	}
+	std::ostream& operator <<(std::ostream& os, const dynamic_bitmap& bm){
+		os << bm.to_string();
+		return os;
+	}
+	dynamic_bitmap operator & (const dynamic_bitmap& lhs, const dynamic_bitmap& rhs){
+		dynamic_bitmap bm(lhs);
+		bm &= rhs;
+		return bm;
+	}
+	dynamic_bitmap operator | (const dynamic_bitmap& lhs, const dynamic_bitmap& rhs){
+		dynamic_bitmap bm(lhs);
+		bm |= rhs;
+		return bm;
+	}
+	dynamic_bitmap operator ^ (const dynamic_bitmap& lhs, const dynamic_bitmap& rhs){
+		dynamic_bitmap bm(lhs);
+		bm ^= rhs;
+		return bm;
+	}
+
+	//******************************roaring_bitmap*****************************
+	roaring_bitmap::const_iterator::const_iterator(const roaring_bitmap *bm, size_type index)
+		:bm_(bm), index_(index), pos_(0){
+		if (index_ != bm_->containers_.size() && bm_->containers_[index_].is_bitmap())
+			pos_ = Detail::find_next_words(bm_->containers_[index_].bits.data(), bitmap_words, 0);
+	}
+	uint32_t roaring_bitmap::const_iterator::operator *()const{
+		const container& c = bm_->containers_[index_];
+		uint32_t low = c.is_bitmap() ? uint32_t(pos_) : c.array[pos_];
+		return (uint32_t(c.key) << 16) | low;
+	}
+	roaring_bitmap::const_iterator& roaring_bitmap::const_iterator::operator ++(){
+		const container& c = bm_->containers_[index_];
+		if (c.is_bitmap()){
+			pos_ = Detail::find_next_words(c.bits.data(), bitmap_words, pos_ + 1);
+			if (pos_ == bitmap_bits)
+				*this = const_iterator(bm_, index_ + 1);
+		}else if (++pos_ == c.array.size()){
+			*this = const_iterator(bm_, index_ + 1);
+		}
+		return *this;
+	}
+
+	roaring_bitmap::roaring_bitmap(roaring_bitmap&& bm) :containers_(std::move(bm.containers_)), size_(bm.size_){
+		bm.size_ = 0;
+	}
+	roaring_bitmap& roaring_bitmap::operator = (roaring_bitmap&& bm){
+		if (this != &bm){
+			containers_ = std::move(bm.containers_);
+			size_ = bm.size_;
+			bm.containers_.clear();
+			bm.size_ = 0;
+		}
+		return *this;
+	}
+	roaring_bitmap::size_type roaring_bitmap::bytes()const{
+		size_type sum = sizeof(*this) + containers_.capacity() * sizeof(container);
+		for (size_type i = 0; i != containers_.size(); ++i){
+			sum += containers_[i].array.capacity() * sizeof(uint16_t);
+			sum += containers_[i].bits.capacity() * sizeof(uint64_t);
+		}
+		return sum;
+	}
+	roaring_bitmap::size_type roaring_bitmap::lower_bound(uint16_t key)const{
+		size_type first = 0, last = containers_.size();
+		while (first < last){
+			size_type mid = first + (last - first) / 2;
+			if (containers_[mid].key < key)
+				first = mid + 1;
+			else
+				last = mid;
+		}
+		return first;
+	}
+	bool roaring_bitmap::insert(uint32_t val){
+		const uint16_t key = uint16_t(val >> 16), low = uint16_t(val);
+		size_type i = lower_bound(key);
+		if (i == containers_.size() || containers_[i].key != key)
+			containers_.insert(containers_.begin() + i, container(key));
+		container& c = containers_[i];
+		if (c.is_bitmap()){
+			uint64_t& w = c.bits[low / 64];
+			const uint64_t mask = uint64_t(1) << (low % 64);
+			if (w & mask)
+				return false;
+			w |= mask;
+		}else{
+			auto it = std::lower_bound(c.array.begin(), c.array.end(), low);
+			if (it != c.array.end() && *it == low)
+				return false;
+			c.array.insert(it, low);
+		}
+		++c.cardinality;
+		++size_;
+		normalize(c);
+		return true;
+	}
+	bool roaring_bitmap::erase(uint32_t val){
+		const uint16_t key = uint16_t(val >> 16), low = uint16_t(val);
+		size_type i = lower_bound(key);
+		if (i == containers_.size() || containers_[i].key != key)
+			return false;
+		container& c = containers_[i];
+		if (c.is_bitmap()){
+			uint64_t& w = c.bits[low / 64];
+			const uint64_t mask = uint64_t(1) << (low % 64);
+			if (!(w & mask))
+				return false;
+			w &= ~mask;
+		}else{
+			auto it = std::lower_bound(c.array.begin(), c.array.end(), low);
+			if (it == c.array.end() || *it != low)
+				return false;
+			c.array.erase(it);
+		}
+		--size_;
+		if (--c.cardinality == 0)
+			containers_.erase(containers_.begin() + i);
+		else
+			normalize(c);
+		return true;
+	}
+	bool roaring_bitmap::contains(uint32_t val)const{
+		const uint16_t key = uint16_t(val >> 16), low = uint16_t(val);
+		size_type i = lower_bound(key);
+		if (i == containers_.size() || containers_[i].key != key)
+			return false;
+		const container& c = containers_[i];
+		if (c.is_bitmap())
+			return (c.bits[low / 64] >> (low % 64)) & 1;
+		return std::binary_search(c.array.begin(), c.array.end(), low);
+	}
+	bool roaring_bitmap::operator == (const roaring_bitmap& bm)const{
+		if (size_ != bm.size_ || containers_.size() != bm.containers_.size())
+			return false;
+		//߶cardinalityѡʽȵʽҲͬ
+		for (size_type i = 0; i != containers_.size(); ++i){
+			const container& a = containers_[i], &b = bm.containers_[i];
+			if (a.key != b.key || a.cardinality != b.cardinality || a.array != b.array || a.bits != b.bits)
+				return false;
+		}
+		return true;
+	}
+	void roaring_bitmap::swap(roaring_bitmap& bm){
+		containers_.swap(bm.containers_);
+		std::swap(size_, bm.size_);
+	}
+	void roaring_bitmap::to_bitmap(container& c){
+		c.bits.assign(bitmap_words, 0);
+		for (size_type i = 0; i != c.array.size(); ++i)
+			c.bits[c.array[i] / 64] |= uint64_t(1) << (c.array[i] % 64);
+		std::vector<uint16_t>().swap(c.array);
+	}
+	void roaring_bitmap::to_array(container& c){
+		std::vector<uint16_t> array;
+		array.reserve(c.cardinality);
+		for (size_type i = 0; i != bitmap_words; ++i){
+			for (uint64_t w = c.bits[i]; w; w &= w - 1)
+				array.push_back(uint16_t(i * 64 + Detail::ctz64(w)));
+		}
+		c.array.swap(array);
+		std::vector<uint64_t>().swap(c.bits);
+	}
+	void roaring_bitmap::normalize(container& c){
+		if (c.is_bitmap() && c.cardinality <= array_max)
+			to_array(c);
+		else if (!c.is_bitmap() && c.cardinality > array_max)
+			to_bitmap(c);
+	}
+	void roaring_bitmap::combine(container& c, const container& other, op_type op){
+		if (!c.is_bitmap() && !other.is_bitmap()){
+			//ֱӹ鲢
+			std::vector<uint16_t> out;
+			auto first1 = c.array.begin(), last1 = c.array.end();
+			auto first2 = other.array.begin(), last2 = other.array.end();
+			switch (op){
+			case op_and: std::set_intersection(first1, last1, first2, last2, std::back_inserter(out)); break;
+			case op_or: std::set_union(first1, last1, first2, last2, std::back_inserter(out)); break;
+			case op_xor: std::set_symmetric_difference(first1, last1, first2, last2, std::back_inserter(out)); break;
+			case op_andnot: std::set_difference(first1, last1, first2, last2, std::back_inserter(out)); break;
+			}
+			c.array.swap(out);
+			c.cardinality = uint32_t(c.array.size());
+		}else if (!c.is_bitmap() && (op == op_and || op == op_andnot)){
+			//λͼ󽻻λ
+			const bool keep = op == op_and;
+			size_type n = 0;
+			for (size_type i = 0; i != c.array.size(); ++i){
+				const uint16_t v = c.array[i];
+				if ((((other.bits[v / 64] >> (v % 64)) & 1) != 0) == keep)
+					c.array[n++] = v;
+			}
+			c.array.resize(n);
+			c.cardinality = uint32_t(n);
+		}else if (!other.is_bitmap()){
+			//λͼ飬Ԫλ
+			if (op == op_and){
+				std::vector<uint16_t> out;
+				for (size_type i = 0; i != other.array.size(); ++i){
+					const uint16_t v = other.array[i];
+					if ((c.bits[v / 64] >> (v % 64)) & 1)
+						out.push_back(v);
+				}
+				std::vector<uint64_t>().swap(c.bits);
+				c.array.swap(out);
+				c.cardinality = uint32_t(c.array.size());
+				return;
+			}
+			for (size_type i = 0; i != other.array.size(); ++i){
+				const uint16_t v = other.array[i];
+				uint64_t& w = c.bits[v / 64];
+				const uint64_t mask = uint64_t(1) << (v % 64);
+				const bool had = (w & mask) != 0;
+				if (op == op_or && !had){
+					w |= mask;
+					++c.cardinality;
+				}else if (op == op_andnot && had){
+					w &= ~mask;
+					--c.cardinality;
+				}else if (op == op_xor){
+					w ^= mask;
+					had ? --c.cardinality : ++c.cardinality;
+				}
+			}
+		}else{
+			//otherλͼcҲתλͼ
+			if (!c.is_bitmap())
+				to_bitmap(c);
+			switch (op){
+			case op_and: Detail::and_words(c.bits.data(), other.bits.data(), bitmap_words); break;
+			case op_or: Detail::or_words(c.bits.data(), other.bits.data(), bitmap_words); break;
+			case op_xor: Detail::xor_words(c.bits.data(), other.bits.data(), bitmap_words); break;
+			case op_andnot: Detail::andnot_words(c.bits.data(), other.bits.data(), bitmap_words); break;
+			}
+			c.cardinality = uint32_t(Detail::popcount_words(c.bits.data(), bitmap_words));
+		}
+		normalize(c);
+	}
+	void roaring_bitmap::apply(const roaring_bitmap& bm, op_type op){
+		if (&bm == this){
+			roaring_bitmap temp(bm);
+			apply(temp, op);
+			return;
+		}
+		const bool keepThis = op != op_and;
+		const bool keepOther = op == op_or || op == op_xor;
+		std::vector<container> result;
+		result.reserve(containers_.size() + (keepOther ? bm.containers_.size() : 0));
+		size_type i = 0, j = 0;
+		while (i != containers_.size() && j != bm.containers_.size()){
+			container& a = containers_[i];
+			const container& b = bm.containers_[j];
+			if (a.key < b.key){
+				if (keepThis)
+					result.push_back(std::move(a));
+				++i;
+			}else if (b.key < a.key){
+				if (keepOther)
+					result.push_back(b);
+				++j;
+			}else{
+				combine(a, b, op);
+				if (a.cardinality != 0)
+					result.push_back(std::move(a));
+				++i, ++j;
+			}
+		}
+		for (; keepThis && i != containers_.size(); ++i)
+			result.push_back(std::move(containers_[i]));
+		for (; keepOther && j != bm.containers_.size(); ++j)
+			result.push_back(bm.containers_[j]);
+		containers_.swap(result);
+		size_ = 0;
+		for (i = 0; i != containers_.size(); ++i)
+			size_ += containers_[i].cardinality;
+	}
+	roaring_bitmap operator & (const roaring_bitmap& lhs, const roaring_bitmap& rhs){
+		roaring_bitmap bm(lhs);
+		bm &= rhs;
+		return bm;
+	}
+	roaring_bitmap operator | (const roaring_bitmap& lhs, const roaring_bitmap& rhs){
+		roaring_bitmap bm(lhs);
+		bm |= rhs;
+		return bm;
+	}
+	roaring_bitmap operator ^ (const roaring_bitmap& lhs, const roaring_bitmap& rhs){
+		roaring_bitmap bm(lhs);
+		bm ^= rhs;
+		return bm;
+	}
+}
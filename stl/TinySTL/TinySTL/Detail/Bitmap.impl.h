@@ -3,7 +3,7 @@
 
 namespace TinySTL{
 	template<size_t N>
-	void bitmap<N>::allocateAndFillN(size_t n, uint8_t val){
+	void bitmap<N>::allocateAndFillN(size_t n, word_type val){
 		start_ = dataAllocator::allocate(n);
 		finish_ = uninitialized_fill_n(start_, n, val);
 	}
@@ -13,57 +13,58 @@ namespace TinySTL{
 			throw std::out_of_range("Out Of Range");
 	}
 	template<size_t N>
-	void bitmap<N>::setNthInInt8(uint8_t& i, size_t nth, bool newVal){//nth0ʼ
-		uint8_t temp = getMask(i, nth);
-		if ((bool)temp == newVal){
-			return;
-		}
-		else{
-			if (temp){//nthλΪ1
-				temp = ~temp;
-				i = i & temp;
-			}
-			else{//nthλΪ0
-				i = i | (1 << nth);
-			}
-		}
-	}
-	template<size_t N>
 	size_t bitmap<N>::roundUp8(size_t bytes){
 		return ((bytes + EAlign::ALIGN - 1) & ~(EAlign::ALIGN - 1));
 	}
 	template<size_t N>
+	typename bitmap<N>::word_type bitmap<N>::tailMask() const{
+		const auto mth = getMth(size_);
+		return mth == 0 ? ~word_type(0) : ((word_type(1) << mth) - 1);
+	}
+	template<size_t N>
 	bitmap<N>& bitmap<N>::set(){
-		uninitialized_fill_n(start_, sizeOfUINT8_, ~0);
+		uninitialized_fill_n(start_, sizeOfWord_, ~word_type(0));
+		if (sizeOfWord_ != 0)
+			*(finish_ - 1) &= tailMask();
 		return *this;
 	}
 	template<size_t N>
 	bitmap<N>& bitmap<N>::reset(){
-		uninitialized_fill_n(start_, sizeOfUINT8_, 0);
+		uninitialized_fill_n(start_, sizeOfWord_, 0);
 		return *this;
 	}
 	template<size_t N>
 	bool bitmap<N>::test(size_t pos) const{
 		THROW(pos);
-		const auto nth = getNth(pos);
-		const auto mth = getMth(pos);
-		uint8_t *ptr = start_ + nth;
-		uint8_t temp = getMask(*ptr, mth);
-		if (temp)
-			return true;
-		return false;
+		return (start_[getNth(pos)] >> getMth(pos)) & 1;
+	}
+	template<size_t N>
+	bitmap<N>::bitmap() :size_(roundUp8(N)), sizeOfWord_((roundUp8(N) + WORD_BITS - 1) / WORD_BITS){
+		allocateAndFillN(sizeOfWord_, 0);
+	}
+	template<size_t N>
+	bitmap<N>::bitmap(const bitmap& bm) : size_(bm.size_), sizeOfWord_(bm.sizeOfWord_){
+		start_ = dataAllocator::allocate(sizeOfWord_);
+		finish_ = uninitialized_copy(bm.start_, bm.finish_, start_);
 	}
 	template<size_t N>
-	bitmap<N>::bitmap() :size_(roundUp8(N)), sizeOfUINT8_(roundUp8(N) / 8){
-		allocateAndFillN(sizeOfUINT8_, 0);
+	bitmap<N>& bitmap<N>::operator = (const bitmap& bm){
+		if (this != &bm)
+			TinySTL::copy(bm.start_, bm.finish_, start_);
+		return *this;
+	}
+	template<size_t N>
+	bitmap<N>::~bitmap(){
+		dataAllocator::deallocate(start_, sizeOfWord_);
 	}
 	template<size_t N>
 	bitmap<N>& bitmap<N>::set(size_t pos, bool val){
 		THROW(pos);
-		const auto nth = getNth(pos);
-		const auto mth = getMth(pos);
-		uint8_t *ptr = start_ + nth;//get the nth uint8_t
-		setNthInInt8(*ptr, mth, val);
+		const auto mask = word_type(1) << getMth(pos);
+		if (val)
+			start_[getNth(pos)] |= mask;
+		else
+			start_[getNth(pos)] &= ~mask;
 		return *this;
 	}
 	template<size_t N>
@@ -73,75 +74,92 @@ namespace TinySTL{
 	}
 	template<size_t N>
 	bitmap<N>& bitmap<N>::flip(){
-		uint8_t *ptr = start_;
+		word_type *ptr = start_;
 		for (; ptr != finish_; ++ptr){
-			uint8_t n = *ptr;
-			*ptr = ~n;
+			*ptr = ~*ptr;
 		}
+		if (sizeOfWord_ != 0)
+			*(finish_ - 1) &= tailMask();
 		return *this;
 	}
 	template<size_t N>
 	bitmap<N>& bitmap<N>::flip(size_t pos){
 		THROW(pos);
-		const auto nth = getNth(pos);
-		const auto mth = getMth(pos);
-		uint8_t *ptr = start_ + nth;
-		uint8_t temp = getMask(*ptr, mth);
-		if (temp)
-			setNthInInt8(*ptr, mth, false);
-		else
-			setNthInInt8(*ptr, mth, true);
+		start_[getNth(pos)] ^= word_type(1) << getMth(pos);
 		return *this;
 	}
 	template<size_t N>
 	size_t bitmap<N>::count() const{
-		uint8_t *ptr = start_;
-		size_t sum = 0;
-		for (; ptr != finish_; ++ptr){
-			for (int i = 0; i != 8; ++i){
-				uint8_t t = getMask(*ptr, i);
-				if (t){
-					++sum;
-				}
-			}
-		}
-		return sum;
+		return Detail::popcount_words(start_, sizeOfWord_);
 	}
 	template<size_t N>
 	bool bitmap<N>::any() const{
-		uint8_t *ptr = start_;
-		for (; ptr != finish_; ++ptr){
-			uint8_t n = *ptr;
-			if (n != 0)
-				return true;
-		}
-		return false;
+		return find_first() != size();
 	}
 	template<size_t N>
 	bool bitmap<N>::all() const{
-		uint8_t *ptr = start_;
-		for (; ptr != finish_; ++ptr){
-			uint8_t n = *ptr;
-			if (n != (uint8_t)~0)
+		return count() == size();
+	}
+	template<size_t N>
+	bool bitmap<N>::none() const{
+		return !any();
+	}
+	template<size_t N>
+	bitmap<N>& bitmap<N>::operator &= (const bitmap& bm){
+		Detail::and_words(start_, bm.start_, sizeOfWord_);
+		return *this;
+	}
+	template<size_t N>
+	bitmap<N>& bitmap<N>::operator |= (const bitmap& bm){
+		Detail::or_words(start_, bm.start_, sizeOfWord_);
+		return *this;
+	}
+	template<size_t N>
+	bitmap<N>& bitmap<N>::operator ^= (const bitmap& bm){
+		Detail::xor_words(start_, bm.start_, sizeOfWord_);
+		return *this;
+	}
+	template<size_t N>
+	bitmap<N>& bitmap<N>::and_not(const bitmap& bm){
+		Detail::andnot_words(start_, bm.start_, sizeOfWord_);
+		return *this;
+	}
+	template<size_t N>
+	bitmap<N> bitmap<N>::operator ~() const{
+		bitmap<N> bm(*this);
+		bm.flip();
+		return bm;
+	}
+	template<size_t N>
+	bool bitmap<N>::operator == (const bitmap& bm) const{
+		for (size_t i = 0; i != sizeOfWord_; ++i){
+			if (start_[i] != bm.start_[i])
 				return false;
 		}
 		return true;
 	}
 	template<size_t N>
-	bool bitmap<N>::none() const{
-		return !any();
+	size_t bitmap<N>::find_first() const{
+		return find_next(size_t(-1));
+	}
+	template<size_t N>
+	size_t bitmap<N>::find_next(size_t pos) const{
+		++pos;//size_t(-1)Ƶ0
+		if (pos >= size_)
+			return size_;
+		//ȿposڵ֣Ƚܼʱﷵ
+		const word_type w = start_[getNth(pos)] >> getMth(pos);
+		if (w)
+			return pos + Detail::ctz64(w);
+		auto res = Detail::find_next_words(start_, sizeOfWord_, (getNth(pos) + 1) * WORD_BITS);
+		return res < size_ ? res : size_;
 	}
 	template<size_t N>
 	string bitmap<N>::to_string() const{
 		string str;
-		uint8_t *ptr = start_;
-		for (; ptr != finish_; ++ptr){
-			uint8_t n = *ptr;
-			for (int i = 0; i != 8; ++i){
-				uint8_t t = getMask(n, i);
-				if (t) str += "1";
-				else str += "0";
-			}
+		str.reserve(size_);
+		for (size_t i = 0; i != size_; ++i){
+			str.push_back(((start_[getNth(i)] >> getMth(i)) & 1) ? '1' : '0');
 		}
 		return str;
 	}
@@ -151,6 +169,41 @@ namespace TinySTL{
 		os << bm.to_string();
 		return os;
 	}
+	template<size_t N>
+	bitmap<N> operator & (const bitmap<N>& lhs, const bitmap<N>& rhs){
+		bitmap<N> bm(lhs);
+		bm &= rhs;
+		return bm;
+	}
+	template<size_t N>
+	bitmap<N> operator | (const bitmap<N>& lhs, const bitmap<N>& rhs){
+		bitmap<N> bm(lhs);
+		bm |= rhs;
+		return bm;
+	}
+	template<size_t N>
+	bitmap<N> operator ^ (const bitmap<N>& lhs, const bitmap<N>& rhs){
+		bitmap<N> bm(lhs);
+		bm ^= rhs;
+		return bm;
+	}
+
+	inline dynamic_bitmap::size_type dynamic_bitmap::find_next(size_type pos)const{
+		++pos;//size_type(-1)Ƶ0
+		if (pos >= size_)
+			return size_;
+		const word_type w = words_[pos / WORD_BITS] >> (pos % WORD_BITS);
+		if (w)
+			return pos + Detail::ctz64(w);
+		size_type res = Detail::find_next_words(words_.data(), words_.size(), (pos / WORD_BITS + 1) * WORD_BITS);
+		return res < size_ ? res : size_;
+	}
+
+	template<class InputIterator>
+	roaring_bitmap::roaring_bitmap(InputIterator first, InputIterator last) :size_(0){
+		for (; first != last; ++first)
+			insert(*first);
+	}
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -9,8 +9,7 @@ namespace TinySTL{
 		}
 		template<class T>
 		T& proxy<T>::operator *(){
-			auto t = *(cp_->ptr_);
-			cp_->ptr_ = make_shared<T>(t);
+			cp_->detach();
 			return *(cp_->ptr_);
 		}
 		template<class T>
@@ -19,13 +18,15 @@ namespace TinySTL{
 		}
 		template<class T>
 		T *proxy<T>::operator ->(){
-			auto t = *(cp_->ptr_);
-			cp_->ptr_ = make_shared<T>(t);
+			cp_->detach();
 			return cp_->ptr_.operator->();
 		}
 		template<class T>
 		cow_ptr<T>& proxy<T>::operator = (const T& val){
-			cp_->ptr_ = make_shared<T>(val);
+			if (cp_->ptr_.unique())
+				*(cp_->ptr_) = val;
+			else
+				cp_->ptr_ = make_shared<T>(val);
 			return *cp_;
 		}
 		template<class T>
@@ -37,18 +38,20 @@ namespace TinySTL{
 	template<class D>
 	cow_ptr<T>::cow_ptr(T *p, D d) : ptr_(p, d){}
 	template<class T>
-	cow_ptr<T>::cow_ptr(const cow_ptr& cp){
-		ptr_ = cp.ptr_;
-	}
+	cow_ptr<T>::cow_ptr(const shared_ptr<T>& sp) :ptr_(sp){}
+	template<class T>
+	cow_ptr<T>::cow_ptr(const cow_ptr& cp) :ptr_(cp.ptr_){}
 	template<class T>
 	cow_ptr<T>& cow_ptr<T>::operator = (const cow_ptr& cp){
-		if (this != &cp){
-			ptr_.decrease_ref();
-			ptr_ = cp.ptr_;
-		}
+		ptr_ = cp.ptr_;
 		return *this;
 	}
 	template<class T>
+	void cow_ptr<T>::detach(){
+		if (ptr_ && !ptr_.unique())
+			ptr_ = make_shared<T>(*ptr_);
+	}
+	template<class T>
 	typename cow_ptr<T>::element_type *cow_ptr<T>::get(){
 		return ptr_.get();
 	}
@@ -0,0 +1,348 @@
+#ifndef _CONCURRENT_CIRCULAR_BUFFER_IMPL_H_
+#define _CONCURRENT_CIRCULAR_BUFFER_IMPL_H_
+
+namespace TinySTL{
+	//**********spsc_circular_buffer*****************
+	template<class T, size_t N, class Alloc, class Wait>
+	spsc_circular_buffer<T, N, Alloc, Wait>::~spsc_circular_buffer(){
+		size_t head = head_.value_.load(std::memory_order_relaxed);
+		size_t tail = tail_.value_.load(std::memory_order_relaxed);
+		for (; head != tail; ++head)
+			dataAllocator::destroy(start_ + (head & mask));
+		dataAllocator::deallocate(start_, N);
+	}
+	template<class T, size_t N, class Alloc, class Wait>
+	typename spsc_circular_buffer<T, N, Alloc, Wait>::size_type
+		spsc_circular_buffer<T, N, Alloc, Wait>::size()const{
+		//ȶhead_ٶtail_ָ֤
+		size_t head = head_.value_.load(std::memory_order_acquire);
+		size_t tail = tail_.value_.load(std::memory_order_acquire);
+		return tail - head > N ? N : tail - head;
+	}
+	template<class T, size_t N, class Alloc, class Wait>
+	template<class U>
+	bool spsc_circular_buffer<T, N, Alloc, Wait>::push_aux(U&& val){
+		size_t tail = tail_.value_.load(std::memory_order_relaxed);
+		if (tail - tail_.cache_ == N){
+			tail_.cache_ = head_.value_.load(std::memory_order_acquire);
+			if (tail - tail_.cache_ == N)
+				return false;
+		}
+		new(start_ + (tail & mask)) T(std::forward<U>(val));
+		tail_.value_.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+	template<class T, size_t N, class Alloc, class Wait>
+	bool spsc_circular_buffer<T, N, Alloc, Wait>::pop_aux(T& val){
+		size_t head = head_.value_.load(std::memory_order_relaxed);
+		if (head == head_.cache_){
+			head_.cache_ = tail_.value_.load(std::memory_order_acquire);
+			if (head == head_.cache_)
+				return false;
+		}
+		T *ptr = start_ + (head & mask);
+		val = std::move(*ptr);
+		dataAllocator::destroy(ptr);
+		head_.value_.store(head + 1, std::memory_order_release);
+		return true;
+	}
+	template<class T, size_t N, class Alloc, class Wait>
+	template<class InputIterator>
+	typename spsc_circular_buffer<T, N, Alloc, Wait>::size_type
+		spsc_circular_buffer<T, N, Alloc, Wait>::push_n_aux(InputIterator& first, size_type n){
+		size_t tail = tail_.value_.load(std::memory_order_relaxed);
+		size_t room = N - (tail - tail_.cache_);
+		if (room < n){
+			tail_.cache_ = head_.value_.load(std::memory_order_acquire);
+			room = N - (tail - tail_.cache_);
+		}
+		if (n > room)
+			n = room;
+		for (size_t i = 0; i != n; ++i, ++first)
+			new(start_ + ((tail + i) & mask)) T(*first);
+		//ֻһ
+		if (n != 0)
+			tail_.value_.store(tail + n, std::memory_order_release);
+		return n;
+	}
+	template<class T, size_t N, class Alloc, class Wait>
+	template<class OutputIterator>
+	typename spsc_circular_buffer<T, N, Alloc, Wait>::size_type
+		spsc_circular_buffer<T, N, Alloc, Wait>::pop_n_aux(OutputIterator& out, size_type n){
+		size_t head = head_.value_.load(std::memory_order_relaxed);
+		size_t ready = head_.cache_ - head;
+		if (ready < n){
+			head_.cache_ = tail_.value_.load(std::memory_order_acquire);
+			ready = head_.cache_ - head;
+		}
+		if (n > ready)
+			n = ready;
+		for (size_t i = 0; i != n; ++i, ++out){
+			T *ptr = start_ + ((head + i) & mask);
+			*out = std::move(*ptr);
+			dataAllocator::destroy(ptr);
+		}
+		if (n != 0)
+			head_.value_.store(head + n, std::memory_order_release);
+		return n;
+	}
+	template<class T, size_t N, class Alloc, class Wait>
+	bool spsc_circular_buffer<T, N, Alloc, Wait>::try_push(const T& val){
+		if (!push_aux(val))
+			return false;
+		waiter_.notify();
+		return true;
+	}
+	template<class T, size_t N, class Alloc, class Wait>
+	bool spsc_circular_buffer<T, N, Alloc, Wait>::try_push(T&& val){
+		if (!push_aux(std::move(val)))
+			return false;
+		waiter_.notify();
+		return true;
+	}
+	template<class T, size_t N, class Alloc, class Wait>
+	void spsc_circular_buffer<T, N, Alloc, Wait>::push(const T& val){
+		waiter_.wait([&]{ return push_aux(val); });
+		waiter_.notify();
+	}
+	template<class T, size_t N, class Alloc, class Wait>
+	void spsc_circular_buffer<T, N, Alloc, Wait>::push(T&& val){
+		//push_auxʧʱƶval
+		waiter_.wait([&]{ return push_aux(std::move(val)); });
+		waiter_.notify();
+	}
+	template<class T, size_t N, class Alloc, class Wait>
+	template<class InputIterator>
+	typename spsc_circular_buffer<T, N, Alloc, Wait>::size_type
+		spsc_circular_buffer<T, N, Alloc, Wait>::try_push_n(InputIterator first, size_type n){
+		n = push_n_aux(first, n);
+		if (n != 0)
+			waiter_.notify();
+		return n;
+	}
+	template<class T, size_t N, class Alloc, class Wait>
+	template<class InputIterator>
+	void spsc_circular_buffer<T, N, Alloc, Wait>::push_n(InputIterator first, size_type n){
+		while (n != 0){
+			size_type pushed = 0;
+			waiter_.wait([&]{ return (pushed = push_n_aux(first, n)) != 0; });
+			waiter_.notify();
+			n -= pushed;
+		}
+	}
+	template<class T, size_t N, class Alloc, class Wait>
+	bool spsc_circular_buffer<T, N, Alloc, Wait>::try_pop(T& val){
+		if (!pop_aux(val))
+			return false;
+		waiter_.notify();
+		return true;
+	}
+	template<class T, size_t N, class Alloc, class Wait>
+	void spsc_circular_buffer<T, N, Alloc, Wait>::pop(T& val){
+		waiter_.wait([&]{ return pop_aux(val); });
+		waiter_.notify();
+	}
+	template<class T, size_t N, class Alloc, class Wait>
+	template<class OutputIterator>
+	typename spsc_circular_buffer<T, N, Alloc, Wait>::size_type
+		spsc_circular_buffer<T, N, Alloc, Wait>::try_pop_n(OutputIterator out, size_type n){
+		n = pop_n_aux(out, n);
+		if (n != 0)
+			waiter_.notify();
+		return n;
+	}
+
+	//**********mpmc_circular_buffer*****************
+	template<class T, size_t N, class Wait>
+	mpmc_circular_buffer<T, N, Wait>::mpmc_circular_buffer() :cells_(cellAllocator::allocate(N)){
+		for (size_t i = 0; i != N; ++i)
+			new(&cells_[i].seq_) std::atomic<size_t>(i);
+	}
+	template<class T, size_t N, class Wait>
+	mpmc_circular_buffer<T, N, Wait>::~mpmc_circular_buffer(){
+		size_t head = head_.value_.load(std::memory_order_relaxed);
+		size_t tail = tail_.value_.load(std::memory_order_relaxed);
+		for (; head != tail; ++head)
+			cells_[head & mask].data()->~T();
+		cellAllocator::deallocate(cells_, N);
+	}
+	template<class T, size_t N, class Wait>
+	typename mpmc_circular_buffer<T, N, Wait>::size_type
+		mpmc_circular_buffer<T, N, Wait>::size()const{
+		size_t head = head_.value_.load(std::memory_order_acquire);
+		size_t tail = tail_.value_.load(std::memory_order_acquire);
+		if (tail < head)//head_ѾԽ˶tail_
+			return 0;
+		return tail - head > N ? N : tail - head;
+	}
+	template<class T, size_t N, class Wait>
+	template<class U>
+	bool mpmc_circular_buffer<T, N, Wait>::push_aux(U&& val){
+		size_t pos = tail_.value_.load(std::memory_order_relaxed);
+		for (;;){
+			cell *c = cells_ + (pos & mask);
+			size_t seq = c->seq_.load(std::memory_order_acquire);
+			ptrdiff_t dif = (ptrdiff_t)seq - (ptrdiff_t)pos;
+			if (dif == 0){
+				if (tail_.value_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+					new(c->data()) T(std::forward<U>(val));
+					c->seq_.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (dif < 0){//
+				return false;
+			}
+			else{//
+				pos = tail_.value_.load(std::memory_order_relaxed);
+			}
+		}
+	}
+	template<class T, size_t N, class Wait>
+	bool mpmc_circular_buffer<T, N, Wait>::pop_aux(T& val){
+		size_t pos = head_.value_.load(std::memory_order_relaxed);
+		for (;;){
+			cell *c = cells_ + (pos & mask);
+			size_t seq = c->seq_.load(std::memory_order_acquire);
+			ptrdiff_t dif = (ptrdiff_t)seq - (ptrdiff_t)(pos + 1);
+			if (dif == 0){
+				if (head_.value_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+					val = std::move(*c->data());
+					c->data()->~T();
+					c->seq_.store(pos + N, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (dif < 0){//
+				return false;
+			}
+			else{
+				pos = head_.value_.load(std::memory_order_relaxed);
+			}
+		}
+	}
+	template<class T, size_t N, class Wait>
+	template<class InputIterator>
+	typename mpmc_circular_buffer<T, N, Wait>::size_type
+		mpmc_circular_buffer<T, N, Wait>::push_n_aux(InputIterator& first, size_type n){
+		size_t pos = tail_.value_.load(std::memory_order_relaxed);
+		for (;;){
+			//posʼдĲλCASɹ֮ǰЩλᱻ˸Ķ
+			size_t count = 0;
+			for (; count != n && count != N; ++count){
+				if (cells_[(pos + count) & mask].seq_.load(std::memory_order_acquire) != pos + count)
+					break;
+			}
+			if (count == 0){
+				size_t seq = cells_[pos & mask].seq_.load(std::memory_order_acquire);
+				if ((ptrdiff_t)seq - (ptrdiff_t)pos < 0)
+					return 0;
+				pos = tail_.value_.load(std::memory_order_relaxed);
+				continue;
+			}
+			if (tail_.value_.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)){
+				for (size_t i = 0; i != count; ++i, ++first){
+					cell *c = cells_ + ((pos + i) & mask);
+					new(c->data()) T(*first);
+					c->seq_.store(pos + i + 1, std::memory_order_release);
+				}
+				return count;
+			}
+		}
+	}
+	template<class T, size_t N, class Wait>
+	template<class OutputIterator>
+	typename mpmc_circular_buffer<T, N, Wait>::size_type
+		mpmc_circular_buffer<T, N, Wait>::pop_n_aux(OutputIterator& out, size_type n){
+		size_t pos = head_.value_.load(std::memory_order_relaxed);
+		for (;;){
+			size_t count = 0;
+			for (; count != n && count != N; ++count){
+				if (cells_[(pos + count) & mask].seq_.load(std::memory_order_acquire) != pos + count + 1)
+					break;
+			}
+			if (count == 0){
+				size_t seq = cells_[pos & mask].seq_.load(std::memory_order_acquire);
+				if ((ptrdiff_t)seq - (ptrdiff_t)(pos + 1) < 0)
+					return 0;
+				pos = head_.value_.load(std::memory_order_relaxed);
+				continue;
+			}
+			if (head_.value_.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)){
+				for (size_t i = 0; i != count; ++i, ++out){
+					cell *c = cells_ + ((pos + i) & mask);
+					*out = std::move(*c->data());
+					c->data()->~T();
+					c->seq_.store(pos + i + N, std::memory_order_release);
+				}
+				return count;
+			}
+		}
+	}
+	template<class T, size_t N, class Wait>
+	bool mpmc_circular_buffer<T, N, Wait>::try_push(const T& val){
+		if (!push_aux(val))
+			return false;
+		waiter_.notify();
+		return true;
+	}
+	template<class T, size_t N, class Wait>
+	bool mpmc_circular_buffer<T, N, Wait>::try_push(T&& val){
+		if (!push_aux(std::move(val)))
+			return false;
+		waiter_.notify();
+		return true;
+	}
+	template<class T, size_t N, class Wait>
+	void mpmc_circular_buffer<T, N, Wait>::push(const T& val){
+		waiter_.wait([&]{ return push_aux(val); });
+		waiter_.notify();
+	}
+	template<class T, size_t N, class Wait>
+	void mpmc_circular_buffer<T, N, Wait>::push(T&& val){
+		waiter_.wait([&]{ return push_aux(std::move(val)); });
+		waiter_.notify();
+	}
+	template<class T, size_t N, class Wait>
+	template<class InputIterator>
+	typename mpmc_circular_buffer<T, N, Wait>::size_type
+		mpmc_circular_buffer<T, N, Wait>::try_push_n(InputIterator first, size_type n){
+		n = push_n_aux(first, n);
+		if (n != 0)
+			waiter_.notify();
+		return n;
+	}
+	template<class T, size_t N, class Wait>
+	template<class InputIterator>
+	void mpmc_circular_buffer<T, N, Wait>::push_n(InputIterator first, size_type n){
+		while (n != 0){
+			size_type pushed = 0;
+			waiter_.wait([&]{ return (pushed = push_n_aux(first, n)) != 0; });
+			waiter_.notify();
+			n -= pushed;
+		}
+	}
+	template<class T, size_t N, class Wait>
+	bool mpmc_circular_buffer<T, N, Wait>::try_pop(T& val){
+		if (!pop_aux(val))
+			return false;
+		waiter_.notify();
+		return true;
+	}
+	template<class T, size_t N, class Wait>
+	void mpmc_circular_buffer<T, N, Wait>::pop(T& val){
+		waiter_.wait([&]{ return pop_aux(val); });
+		waiter_.notify();
+	}
+	template<class T, size_t N, class Wait>
+	template<class OutputIterator>
+	typename mpmc_circular_buffer<T, N, Wait>::size_type
+		mpmc_circular_buffer<T, N, Wait>::try_pop_n(OutputIterator out, size_type n){
+		n = pop_n_aux(out, n);
+		if (n != 0)
+			waiter_.notify();
+		return n;
+	}
+}
+
+#endif
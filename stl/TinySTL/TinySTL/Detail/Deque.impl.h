@@ -157,43 +157,50 @@ namespace TinySTL{
 	}
 	template<class T, class Alloc>
 	void deque<T, Alloc>::init(){
-		mapSize_ = 2;
-		map_ = getANewMap(mapSize_);
+		if (!map_){
+			mapSize_ = 2;
+			map_ = getANewMap(mapSize_);
+		}
 		beg_.container_ = end_.container_ = this;
-		beg_.mapIndex_ = end_.mapIndex_ = mapSize_ - 1;
-		beg_.cur_ = end_.cur_ = map_[mapSize_ - 1];
+		beg_.mapIndex_ = end_.mapIndex_ = mapSize_ / 2;
+		beg_.cur_ = end_.cur_ = map_[mapSize_ / 2];
 	}
 	template<class T, class Alloc>
 	T *deque<T, Alloc>::getANewBuck(){
-		return dataAllocator::allocate(getBuckSize());
+		return alloc_.allocate(getBuckSize());
 	}
 	template<class T, class Alloc>
 	T** deque<T, Alloc>::getANewMap(const size_t size){
-		T **map = new T*[size];
-		for (int i = 0; i != size; ++i)
+		mapAllocator mapAlloc(alloc_);
+		T **map = mapAlloc.allocate(size + 1);
+		for (size_t i = 0; i != size; ++i)
 			map[i] = getANewBuck();
+		map[size] = 0;
 		return map;
 	}
 	template<class T, class Alloc>
-	size_t deque<T, Alloc>::getNewMapSize(const size_t size){
-		return (size == 0 ? 2 : size * 2);
+	void deque<T, Alloc>::freeMap(T **map, const size_t size){
+		mapAllocator mapAlloc(alloc_);
+		for (size_t i = 0; i != size; ++i)
+			alloc_.deallocate(map[i], getBuckSize());
+		mapAlloc.deallocate(map, size + 1);
 	}
 	template<class T, class Alloc>
-	size_t deque<T, Alloc>::getBuckSize()const{
-		return (size_t)EBucksSize::BUCKSIZE;
+	void deque<T, Alloc>::destroyElements(){
+		for (auto it = beg_; it != end_; ++it)
+			alloc_.destroy(it.cur_);
+	}
+	template<class T, class Alloc>
+	size_t deque<T, Alloc>::getNewMapSize(const size_t size){
+		return (size == 0 ? 2 : size * 2);
 	}
 	template<class T, class Alloc>
 	void deque<T, Alloc>::clear(){
-		/*for (int i = 0; i != mapSize_; ++i)
-		if (!map_[i])
-		dataAllocator::destroy(map_[i], map_[i] + getBuckSize());*/
-		for (auto i = 0; i != mapSize_; ++i){
-			for (auto p = map_[i] + 0; !p && p != map_[i] + getBuckSize(); ++p)
-				dataAllocator::destroy(p);
-		}
-		mapSize_ = 0;
-		beg_.mapIndex_ = end_.mapIndex_ = mapSize_ / 2;
-		beg_.cur_ = end_.cur_ = map_[mapSize_ / 2];
+		//mapͰ´pushʱм¿ʼ
+		if (!map_)
+			return;
+		destroyElements();
+		init();
 	}
 	template<class T, class Alloc>
 	typename deque<T, Alloc>::reference deque<T, Alloc>::operator[] (size_type n){
@@ -231,97 +238,153 @@ namespace TinySTL{
 	typename deque<T, Alloc>::iterator deque<T, Alloc>::end()const{ return end_; }
 	template<class T, class Alloc>
 	deque<T, Alloc>::~deque(){
-		for (int i = 0; i != mapSize_; ++i){
-			for (auto p = map_[i] + 0; !p && p != map_[i] + getBuckSize(); ++p)
-				dataAllocator::destroy(p);
-			if (!map_[i])
-				dataAllocator::deallocate(map_[i], getBuckSize());
+		//bug fix: ǰдˣԪغͰûбͷ
+		if (map_){
+			destroyElements();
+			freeMap(map_, mapSize_);
 		}
-		delete[] map_;
 	}
 	template<class T, class Alloc>
-	deque<T, Alloc>::deque()
-		:mapSize_(0), map_(0){}
+	deque<T, Alloc>::deque(){}
+	template<class T, class Alloc>
+	deque<T, Alloc>::deque(const Alloc& alloc)
+		:alloc_(alloc){}
 	template<class T, class Alloc>
-	deque<T, Alloc>::deque(size_type n, const value_type& val = value_type()){
-		deque();
+	deque<T, Alloc>::deque(size_type n, const value_type& val = value_type(), const Alloc& alloc = Alloc())
+		:alloc_(alloc){
 		deque_aux(n, val, typename std::is_integral<size_type>::type());
 	}
 	template<class T, class Alloc>
 	template <class InputIterator>
-	deque<T, Alloc>::deque(InputIterator first, InputIterator last){
-		deque();
+	deque<T, Alloc>::deque(InputIterator first, InputIterator last, const Alloc& alloc = Alloc())
+		:alloc_(alloc){
 		deque_aux(first, last, typename std::is_integral<InputIterator>::type());
 	}
 	template<class T, class Alloc>
-	deque<T, Alloc>::deque(const deque& x){
-		mapSize_ = x.mapSize_;
-		map_ = getANewMap(mapSize_);
-		for (int i = 0; i + x.beg_.mapIndex_ != x.mapSize_; ++i)
-			for (int j = 0; j != getBuckSize(); ++j)
-				map_[x.beg_.mapIndex_ + i][j] = x.map_[x.beg_.mapIndex_ + i][j];
-		beg_.mapIndex_ = x.beg_.mapIndex_;
-		end_.mapIndex_ = x.end_.mapIndex_;
-		beg_.cur_ = map_[beg_.mapIndex_] + (x.beg_.cur_ - x.map_[x.beg_.mapIndex_]);
-		end_.cur_ = map_[end_.mapIndex_] + (x.end_.cur_ - x.map_[x.end_.mapIndex_]);
-		beg_.container_ = end_.container_ = this;
+	deque<T, Alloc>::deque(const deque& x)
+		:alloc_(x.alloc_.select_on_container_copy_construction()){
+		for (auto it = x.begin(); it != x.end(); ++it)
+			push_back(*it);
 	}
 	template<class T, class Alloc>
-	void deque<T, Alloc>::reallocateAndCopy(){
+	deque<T, Alloc>::deque(const deque& x, const Alloc& alloc)
+		:alloc_(alloc){
+		for (auto it = x.begin(); it != x.end(); ++it)
+			push_back(*it);
+	}
+	template<class T, class Alloc>
+	deque<T, Alloc>::deque(deque&& x)
+		:alloc_(x.alloc_){
+		swap(x);
+	}
+	template<class T, class Alloc>
+	deque<T, Alloc>& deque<T, Alloc>::operator= (const deque& x){
+		if (this != &x){
+			deque temp(x, alloc_);
+			swap(temp);
+		}
+		return *this;
+	}
+	template<class T, class Alloc>
+	deque<T, Alloc>& deque<T, Alloc>::operator= (deque&& x){
+		if (this != &x){
+			//ͬʱֱӽӹxͰ
+			deque temp(alloc_);
+			if (alloc_ == x.alloc_)
+				temp.swap(x);
+			else
+				temp = x;
+			swap(temp);
+		}
+		return *this;
+	}
+	template<class T, class Alloc>
+	void deque<T, Alloc>::reallocateMap(){
+		//ͰֻͰָҵmapstartIndexԪزҪƶָԪصָҲʧЧ
 		auto newMapSize = getNewMapSize(mapSize_);
-		T** newMap = getANewMap(newMapSize);
+		mapAllocator mapAlloc(alloc_);
+		T **newMap = mapAlloc.allocate(newMapSize + 1);
 		size_t startIndex = newMapSize / 4;
-		for (int i = 0; i + beg_.mapIndex_ != mapSize_; ++i)
-			for (int j = 0; j != getBuckSize(); ++j)
-				newMap[startIndex + i][j] = map_[beg_.mapIndex_ + i][j];
-
-		size_t n = beg_.cur_ - map_[beg_.mapIndex_];
-		auto size = this->size();
-		auto b = beg_, e = end_;
-		clear();
+		size_t used = end_.mapIndex_ - beg_.mapIndex_ + (end_.mapIndex_ == mapSize_ ? 0 : 1);
+		for (size_t i = 0; i != used; ++i)
+			newMap[startIndex + i] = map_[beg_.mapIndex_ + i];
+		//ûԪصľͰmapĿλϣʱٷͰ
+		size_t spare = 0;
+		for (size_t i = 0; i != newMapSize; ++i){
+			if (i >= startIndex && i < startIndex + used)
+				continue;
+			while (spare != mapSize_ && spare >= beg_.mapIndex_ && spare < beg_.mapIndex_ + used)
+				++spare;
+			newMap[i] = spare != mapSize_ ? map_[spare++] : getANewBuck();
+		}
+		newMap[newMapSize] = 0;
+		size_t begIndex = startIndex, endIndex = startIndex + end_.mapIndex_ - beg_.mapIndex_;
+		size_t begOffset = beg_.cur_ - map_[beg_.mapIndex_];
+		size_t endOffset = end_.mapIndex_ == mapSize_ ? 0 : end_.cur_ - map_[end_.mapIndex_];
+		mapAlloc.deallocate(map_, mapSize_ + 1);
 		mapSize_ = newMapSize;
 		map_ = newMap;
-		beg_ = iterator(startIndex, newMap[startIndex] + n, this);
-		end_ = beg_ + size;
-
+		beg_ = iterator(begIndex, newMap[begIndex] + begOffset, this);
+		end_ = iterator(endIndex, newMap[endIndex] + endOffset, this);
 	}
 	template<class T, class Alloc>
 	void deque<T, Alloc>::push_back(const value_type& val){
+		emplace_back(val);
+	}
+	template<class T, class Alloc>
+	void deque<T, Alloc>::push_back(value_type&& val){
+		emplace_back(std::move(val));
+	}
+	template<class T, class Alloc>
+	void deque<T, Alloc>::push_front(const value_type& val){
+		emplace_front(val);
+	}
+	template<class T, class Alloc>
+	void deque<T, Alloc>::push_front(value_type&& val){
+		emplace_front(std::move(val));
+	}
+	template<class T, class Alloc>
+	template<class... Args>
+	void deque<T, Alloc>::emplace_back(Args&&... args){
 		if (empty()){
 			init();
 		}
 		else if (back_full()){
-			reallocateAndCopy();
+			reallocateMap();
 		}
 		//*end_ = val;
 		//bug fix
 		//2015.01.02
-		TinySTL::construct(end_.cur_, val);
+		alloc_.construct(end_.cur_, std::forward<Args>(args)...);
 		++end_;
 	}
 	template<class T, class Alloc>
-	void deque<T, Alloc>::push_front(const value_type& val){
+	template<class... Args>
+	void deque<T, Alloc>::emplace_front(Args&&... args){
 		if (empty()){
 			init();
 		}
 		else if (front_full()){
-			reallocateAndCopy();
+			reallocateMap();
 		}
-		--beg_;
+		//ɹƶbeg_׳쳣ʱdequeԭ
+		iterator newBeg = beg_;
+		--newBeg;
 		//*beg_ = val;
 		//bug fix
 		//2015.01.02
-		TinySTL::construct(beg_.cur_, val);
+		alloc_.construct(newBeg.cur_, std::forward<Args>(args)...);
+		beg_ = newBeg;
 	}
 	template<class T, class Alloc>
 	void deque<T, Alloc>::pop_front(){
-		dataAllocator::destroy(beg_.cur_);
+		alloc_.destroy(beg_.cur_);
 		++beg_;
 	}
 	template<class T, class Alloc>
 	void deque<T, Alloc>::pop_back(){
 		--end_;
-		dataAllocator::destroy(end_.cur_);
+		alloc_.destroy(end_.cur_);
 	}
 	template<class T, class Alloc>
 	void deque<T, Alloc>::swap(deque<T, Alloc>& x){
@@ -329,6 +392,10 @@ namespace TinySTL{
 		TinySTL::swap(map_, x.map_);
 		beg_.swap(x.beg_);
 		end_.swap(x.end_);
+		TinySTL::swap(alloc_, x.alloc_);
+		//container_ҪָµˣûmapdequeĵĬϹ
+		beg_.container_ = end_.container_ = map_ ? this : 0;
+		x.beg_.container_ = x.end_.container_ = x.map_ ? &x : 0;
 	}
 
 	template <class T, class Alloc>
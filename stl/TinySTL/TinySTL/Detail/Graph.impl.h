@@ -8,7 +8,7 @@ namespace TinySTL{
 			return node_type(index, val);
 		}
 		template<class Index, class Value, class EqualFunc>
-		typename const graph<Index, Value, EqualFunc>::node_type& 
+		const typename graph<Index, Value, EqualFunc>::node_type& 
 			graph<Index, Value, EqualFunc>::get_node(const Index& index){
 			for (auto& pair : nodes_){
 				if (equal_func(pair.first.first, index))
@@ -189,29 +189,30 @@ namespace TinySTL{
 	}//end of Detail
 
 	template<class Index, class Value, class EqualFunc>
-	directed_graph<Index, Value, EqualFunc>::directed_graph():graph(){}
+	directed_graph<Index, Value, EqualFunc>::directed_graph(const allocator_type& alloc)
+		:Detail::graph<Index, Value, EqualFunc>(alloc){}
 	template<class Index, class Value, class EqualFunc>
 	void directed_graph<Index, Value, EqualFunc>::add_node_helper(const Index& index, const nodes_set_type& nodes){
 		if (nodes.empty())
 			return;
 		//find node n's list
-		list<typename graph::node_type>* l;
-		for (auto& pair : nodes_){
-			if (equal_func(pair.first.first, index))
+		typename Detail::graph<Index, Value, EqualFunc>::adjacent_list_type *l = 0;
+		for (auto& pair : this->nodes_){
+			if (this->equal_func(pair.first.first, index))
 				l = &(pair.second);
 		}
 		for (const auto& item : nodes){
 			l->push_front(item);
-			if (!is_contained(item.first)){
-				add_node(item, empty_node_set());
+			if (!this->is_contained(item.first)){
+				add_node(item, this->empty_node_set());
 			}
 		}
 	}
 	template<class Index, class Value, class EqualFunc>
 	void directed_graph<Index, Value, EqualFunc>::add_node(const node_type& n, const nodes_set_type& nodes){
-		if (!is_contained(n.first)){
-			nodes_.push_front(make_pair(n, list<typename graph::node_type>()));
-			++size_;
+		if (!this->is_contained(n.first)){
+			this->nodes_.push_front(typename Detail::graph<Index, Value, EqualFunc>::entry_type(n, this->get_allocator()));
+			++this->size_;
 		}
 		add_node_helper(n.first, nodes);
 	}
@@ -221,13 +222,13 @@ namespace TinySTL{
 	}
 	template<class Index, class Value, class EqualFunc>
 	void directed_graph<Index, Value, EqualFunc>::delete_node(const Index& index){
-		for (auto oit = nodes_.begin(); oit != nodes_.end();){
+		for (auto oit = this->nodes_.begin(); oit != this->nodes_.end();){
 			auto& l = oit->second;
-			if (equal_func((oit->first).first, index)){
-				oit = nodes_.erase(oit);
+			if (this->equal_func((oit->first).first, index)){
+				oit = this->nodes_.erase(oit);
 			}else{
 				for (auto iit = l.begin(); iit != l.end();){
-					if (equal_func(iit->first, index))
+					if (this->equal_func(iit->first, index))
 						iit = l.erase(iit);
 					else
 						++iit;
@@ -242,10 +243,228 @@ namespace TinySTL{
 	}
 	template<class Index, class Value, class EqualFunc>
 	void directed_graph<Index, Value, EqualFunc>::make_edge(const Index& index1, const Index& index2){
-		auto node1 = get_node(index1), node2 = get_node(index2);
-		for (auto it = nodes_.begin(); it != nodes_.end(); ++it){
-			if (equal_func((it->first).first, index1))
+		auto node1 = this->get_node(index1), node2 = this->get_node(index2);
+		for (auto it = this->nodes_.begin(); it != this->nodes_.end(); ++it){
+			if (this->equal_func((it->first).first, index1))
 				(it->second).push_front(node2);
 		}
 	}
+
+	template<class Index, class Value, class EqualFunc>
+	const typename csr_graph<Index, Value, EqualFunc>::vertex_type csr_graph<Index, Value, EqualFunc>::npos;
+	template<class Index, class Value, class EqualFunc>
+	csr_graph<Index, Value, EqualFunc>::csr_graph()
+		:out_offsets_(1, 0), in_offsets_(1, 0){}
+	template<class Index, class Value, class EqualFunc>
+	csr_graph<Index, Value, EqualFunc>::csr_graph(const Detail::graph<Index, Value, EqualFunc>& g){
+		for (auto& pair : g.nodes_){
+			if (ids_.insert(std::make_pair(pair.first.first, vertex_type(nodes_.size()))).second)
+				nodes_.push_back(pair.first);
+		}
+		std::vector<edge_type> edges;
+		for (auto& pair : g.nodes_){
+			vertex_type from = vertex(pair.first.first);
+			for (auto& item : pair.second){
+				auto it = ids_.find(item.first);
+				if (it != ids_.end())
+					edges.push_back(edge_type(from, it->second));
+			}
+		}
+		build(edges);
+	}
+	template<class Index, class Value, class EqualFunc>
+	csr_graph<Index, Value, EqualFunc>::csr_graph(const std::vector<node_type>& nodes, const std::vector<edge_type>& edges)
+		:nodes_(nodes){
+		for (size_t i = 0; i != nodes_.size(); ++i){
+			if (!ids_.insert(std::make_pair(nodes_[i].first, vertex_type(i))).second)
+				throw std::invalid_argument("csr_graph: duplicated index");
+		}
+		build(edges);
+	}
+	template<class Index, class Value, class EqualFunc>
+	void csr_graph<Index, Value, EqualFunc>::build(const std::vector<edge_type>& edges){
+		//ͬһı߱ԭ˳
+		const size_t n = size();
+		if (n >= npos)
+			throw std::length_error("csr_graph: too many vertices");
+		out_offsets_.assign(n + 1, 0);
+		in_offsets_.assign(n + 1, 0);
+		for (size_t i = 0; i != edges.size(); ++i){
+			if (edges[i].first >= n || edges[i].second >= n)
+				throw std::out_of_range("csr_graph: vertex out of the range");
+			++out_offsets_[edges[i].first + 1];
+			++in_offsets_[edges[i].second + 1];
+		}
+		for (size_t v = 0; v != n; ++v){
+			out_offsets_[v + 1] += out_offsets_[v];
+			in_offsets_[v + 1] += in_offsets_[v];
+		}
+		out_edges_.resize(edges.size());
+		in_edges_.resize(edges.size());
+		std::vector<size_t> outPos(out_offsets_.begin(), out_offsets_.end() - 1);
+		std::vector<size_t> inPos(in_offsets_.begin(), in_offsets_.end() - 1);
+		for (size_t i = 0; i != edges.size(); ++i){
+			out_edges_[outPos[edges[i].first]++] = edges[i].second;
+			in_edges_[inPos[edges[i].second]++] = edges[i].first;
+		}
+	}
+	template<class Index, class Value, class EqualFunc>
+	typename csr_graph<Index, Value, EqualFunc>::vertex_type
+		csr_graph<Index, Value, EqualFunc>::vertex(const Index& index)const{
+		auto it = ids_.find(index);
+		return it == ids_.end() ? npos : it->second;
+	}
+	template<class Index, class Value, class EqualFunc>
+	void csr_graph<Index, Value, EqualFunc>::DFS(const Index& index, visiter_func_type func){
+		vertex_type start = vertex(index);
+		if (start == npos)
+			return;
+		//ʽջݹ飬ջб涥һҪĳ
+		std::vector<bool> visited(size());
+		std::vector<std::pair<vertex_type, size_t>> stack;
+		visited[start] = true;
+		func(nodes_[start]);
+		stack.push_back(std::make_pair(start, out_offsets_[start]));
+		while (!stack.empty()){
+			auto& top = stack.back();
+			if (top.second == out_offsets_[top.first + 1]){
+				stack.pop_back();
+				continue;
+			}
+			vertex_type v = out_edges_[top.second++];
+			if (!visited[v]){
+				visited[v] = true;
+				func(nodes_[v]);
+				stack.push_back(std::make_pair(v, out_offsets_[v]));
+			}
+		}
+	}
+	template<class Index, class Value, class EqualFunc>
+	void csr_graph<Index, Value, EqualFunc>::BFS(const Index& index, visiter_func_type func){
+		vertex_type start = vertex(index);
+		if (start == npos)
+			return;
+		std::vector<bool> visited(size());
+		std::vector<vertex_type> queue(1, start);
+		visited[start] = true;
+		for (size_t head = 0; head != queue.size(); ++head){
+			vertex_type u = queue[head];
+			func(nodes_[u]);
+			for (const vertex_type *it = out_begin(u), *last = out_end(u); it != last; ++it){
+				if (!visited[*it]){
+					visited[*it] = true;
+					queue.push_back(*it);
+				}
+			}
+		}
+	}
+	template<class Index, class Value, class EqualFunc>
+	std::vector<typename csr_graph<Index, Value, EqualFunc>::vertex_type>
+		csr_graph<Index, Value, EqualFunc>::bfs_levels(vertex_type source, bool parallel, bool optimize)const{
+		const size_t n = size();
+		if (source >= n)
+			throw std::out_of_range("csr_graph: vertex out of the range");
+		unsigned threads = 1;
+		if (parallel && n >= parallel_threshold)
+			threads = std::max(1u, std::thread::hardware_concurrency());
+		//BeamerеĲǰصĳ߳δʶߵ1/alphaʱΪԵϣ
+		//ǰصĶn/betaʱĻԶ
+		const size_t alpha = 14, beta = 24;
+		const size_t words = (n + 63) / 64;
+
+		std::vector<vertex_type> levels(n, npos);
+		//Զʱ̻߳ͬʱλvisitedԵʱÿֻһ߳
+		std::unique_ptr<std::atomic<unsigned long long>[]> visited(new std::atomic<unsigned long long>[words]);
+		for (size_t i = 0; i != words; ++i)
+			visited[i].store(0, std::memory_order_relaxed);
+		std::vector<unsigned long long> frontierBits, nextBits;
+		std::vector<vertex_type> frontier(1, source), next;
+		std::vector<std::vector<vertex_type>> local(threads);
+		std::vector<size_t> localCount(threads), localEdges(threads);
+
+		levels[source] = 0;
+		visited[source >> 6].fetch_or(1ULL << (source & 63), std::memory_order_relaxed);
+		size_t frontierSize = 1, frontierEdges = out_degree(source);
+		size_t unexploredEdges = edge_count() - frontierEdges;
+		bool bottomUp = false;
+		for (vertex_type depth = 0; frontierSize != 0; ++depth){
+			if (optimize && !bottomUp && frontierEdges > unexploredEdges / alpha){
+				bottomUp = true;
+				frontierBits.assign(words, 0);
+				for (size_t i = 0; i != frontier.size(); ++i)
+					frontierBits[frontier[i] >> 6] |= 1ULL << (frontier[i] & 63);
+			}else if (bottomUp && frontierSize < n / beta){
+				bottomUp = false;
+				frontier.clear();
+				for (size_t i = 0; i != words; ++i){
+					for (unsigned long long w = frontierBits[i]; w != 0; w &= w - 1){
+						size_t bit = 0;
+						while (((w >> bit) & 1) == 0)
+							++bit;
+						frontier.push_back(vertex_type(i * 64 + bit));
+					}
+				}
+			}
+			std::fill(localCount.begin(), localCount.end(), 0);
+			std::fill(localEdges.begin(), localEdges.end(), 0);
+			for (unsigned t = 0; t != threads; ++t)
+				local[t].clear();
+			if (bottomUp){
+				nextBits.assign(words, 0);
+				Detail::csr_parallel_for(n, threads, [&](unsigned t, size_t first, size_t last){
+					size_t count = 0, edges = 0;
+					for (size_t v = first; v != last; ++v){
+						if (levels[v] != npos)
+							continue;
+						for (const vertex_type *it = in_begin(vertex_type(v)), *e = in_end(vertex_type(v)); it != e; ++it){
+							if ((frontierBits[*it >> 6] >> (*it & 63)) & 1){
+								levels[v] = depth + 1;
+								nextBits[v >> 6] |= 1ULL << (v & 63);
+								visited[v >> 6].fetch_or(1ULL << (v & 63), std::memory_order_relaxed);
+								++count;
+								edges += out_degree(vertex_type(v));
+								break;
+							}
+						}
+					}
+					localCount[t] = count;
+					localEdges[t] = edges;
+				});
+				frontierBits.swap(nextBits);
+			}else{
+				//ǰغСʱֵÿ߳
+				unsigned workers = frontier.size() < 4096 ? 1 : threads;
+				Detail::csr_parallel_for(frontier.size(), workers, [&](unsigned t, size_t first, size_t last){
+					std::vector<vertex_type>& out = local[t];
+					size_t edges = 0;
+					for (size_t i = first; i != last; ++i){
+						vertex_type u = frontier[i];
+						for (const vertex_type *it = out_begin(u), *e = out_end(u); it != e; ++it){
+							vertex_type v = *it;
+							unsigned long long bit = 1ULL << (v & 63);
+							if ((visited[v >> 6].load(std::memory_order_relaxed) & bit) == 0 &&
+								(visited[v >> 6].fetch_or(bit, std::memory_order_relaxed) & bit) == 0){
+								levels[v] = depth + 1;
+								out.push_back(v);
+								edges += out_degree(v);
+							}
+						}
+					}
+					localCount[t] = out.size();
+					localEdges[t] = edges;
+				});
+				next.clear();
+				for (unsigned t = 0; t != workers; ++t)
+					next.insert(next.end(), local[t].begin(), local[t].end());
+				frontier.swap(next);
+			}
+			frontierSize = frontierEdges = 0;
+			for (unsigned t = 0; t != threads; ++t){
+				frontierSize += localCount[t];
+				frontierEdges += localEdges[t];
+			}
+			unexploredEdges -= frontierEdges;
+		}
+		return levels;
+	}
 }
\ No newline at end of file
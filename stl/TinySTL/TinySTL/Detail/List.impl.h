@@ -35,123 +35,152 @@ namespace TinySTL{
 		}
 	}//end of Detail namespace
 
-	template<class T>
-	void list<T>::insert_aux(iterator position, size_type n, const T& val, std::true_type){
+	template<class T, class Alloc>
+	void list<T, Alloc>::insert_aux(iterator position, size_type n, const T& val, std::true_type){
 		for (auto i = n; i != 0; --i){
 			position = insert(position, val);
 		}
 	}
-	template<class T>
+	template<class T, class Alloc>
 	template<class InputIterator>
-	void list<T>::insert_aux(iterator position, InputIterator first, InputIterator last, std::false_type){
+	void list<T, Alloc>::insert_aux(iterator position, InputIterator first, InputIterator last, std::false_type){
 		for (--last; first != last; --last){
 			position = insert(position, *last);
 		}
 		insert(position, *last);
 	}
-	template<class T>
-	typename list<T>::nodePtr list<T>::newNode(const T& val = T()){
-		nodePtr res = nodeAllocator::allocate();
-		nodeAllocator::construct(res, Detail::node<T>(val, nullptr, nullptr, this));
+	template<class T, class Alloc>
+	typename list<T, Alloc>::nodePtr list<T, Alloc>::newNode(){
+		//βڱڵԪҲalloc_ĬϹ죬push_backֱӸֵ
+		nodeAllocator nodeAlloc(alloc_);
+		nodePtr res = nodeAlloc.allocate(1);
+		alloc_.construct(&res->data);
+		res->prev = res->next = nullptr;
 		return res;
 	}
-	template<class T>
-	void list<T>::deleteNode(nodePtr p){
-		p->prev = p->next = nullptr;
-		nodeAllocator::destroy(p);
-		nodeAllocator::deallocate(p);
+	template<class T, class Alloc>
+	typename list<T, Alloc>::nodePtr list<T, Alloc>::newNode(const T& val){
+		//ڵ㱾ָֻҪʼԪؽalloc_
+		nodeAllocator nodeAlloc(alloc_);
+		nodePtr res = nodeAlloc.allocate(1);
+		alloc_.construct(&res->data, val);
+		res->prev = res->next = nullptr;
+		return res;
+	}
+	template<class T, class Alloc>
+	void list<T, Alloc>::deleteNode(nodePtr p){
+		nodeAllocator nodeAlloc(alloc_);
+		alloc_.destroy(&p->data);
+		nodeAlloc.deallocate(p, 1);
 	}
-	template<class T>
-	void list<T>::ctorAux(size_type n, const value_type& val, std::true_type){
+	template<class T, class Alloc>
+	void list<T, Alloc>::initDummy(){
 		head.p = newNode();//add a dummy node
 		tail.p = head.p;
+	}
+	template<class T, class Alloc>
+	void list<T, Alloc>::copyFrom(const list& l){
+		initDummy();
+		for (auto node = l.head.p; node != l.tail.p; node = node->next)
+			push_back(node->data);
+	}
+	template<class T, class Alloc>
+	void list<T, Alloc>::ctorAux(size_type n, const value_type& val, std::true_type){
+		initDummy();
 		while (n--)
 			push_back(val);
 	}
-	template<class T>
+	template<class T, class Alloc>
 	template <class InputIterator>
-	void list<T>::ctorAux(InputIterator first, InputIterator last, std::false_type){
-		head.p = newNode();//add a dummy node
-		tail.p = head.p;
+	void list<T, Alloc>::ctorAux(InputIterator first, InputIterator last, std::false_type){
+		initDummy();
 		for (; first != last; ++first)
 			push_back(*first);
 	}
-	template<class T>
-	typename list<T>::size_type list<T>::size()const{
+	template<class T, class Alloc>
+	typename list<T, Alloc>::size_type list<T, Alloc>::size()const{
 		size_type length = 0;
 		for (auto h = head; h != tail; ++h)
 			++length;
 		return length;
 	}
-	template<class T>
-	list<T>::list(){
-		head.p = newNode();//add a dummy node
-		tail.p = head.p;
+	template<class T, class Alloc>
+	list<T, Alloc>::list(){
+		initDummy();
+	}
+	template<class T, class Alloc>
+	list<T, Alloc>::list(const Alloc& alloc)
+		:alloc_(alloc){
+		initDummy();
 	}
-	template<class T>
-	list<T>::list(size_type n, const value_type& val = value_type()){
+	template<class T, class Alloc>
+	list<T, Alloc>::list(size_type n, const value_type& val = value_type(), const Alloc& alloc = Alloc())
+		:alloc_(alloc){
 		ctorAux(n, val, std::is_integral<value_type>());
 	}
-	template<class T>
+	template<class T, class Alloc>
 	template <class InputIterator>
-	list<T>::list(InputIterator first, InputIterator last){
+	list<T, Alloc>::list(InputIterator first, InputIterator last, const Alloc& alloc = Alloc())
+		:alloc_(alloc){
 		ctorAux(first, last, std::is_integral<InputIterator>());
 	}
-	template<class T>
-	list<T>::list(const list& l){
-		head.p = newNode();//add a dummy node
-		tail.p = head.p;
-		for (auto node = l.head.p; node != l.tail.p; node = node->next)
-			push_back(node->data);
+	template<class T, class Alloc>
+	list<T, Alloc>::list(const list& l)
+		:alloc_(l.alloc_.select_on_container_copy_construction()){
+		copyFrom(l);
 	}
-	template<class T>
-	list<T>& list<T>::operator = (const list& l){
+	template<class T, class Alloc>
+	list<T, Alloc>::list(const list& l, const Alloc& alloc)
+		:alloc_(alloc){
+		copyFrom(l);
+	}
+	template<class T, class Alloc>
+	list<T, Alloc>& list<T, Alloc>::operator = (const list& l){
 		if (this != &l){
-			list(l).swap(*this);
+			list(l, alloc_).swap(*this);
 		}
 		return *this;
 	}
-	template<class T>
-	list<T>::~list(){
+	template<class T, class Alloc>
+	list<T, Alloc>::~list(){
 		for (; head != tail;){
 			auto temp = head++;
 			//bug fix
-			nodeAllocator::destroy(temp.p);
-			nodeAllocator::deallocate(temp.p);
+			deleteNode(temp.p);
 		}
-		nodeAllocator::deallocate(tail.p);
+		deleteNode(tail.p);
 	}
-	template<class T>
-	void list<T>::push_front(const value_type& val){
+	template<class T, class Alloc>
+	void list<T, Alloc>::push_front(const value_type& val){
 		auto node = newNode(val);
 		head.p->prev = node;
 		node->next = head.p;
 		head.p = node;
 	}
-	template<class T>
-	void list<T>::pop_front(){
+	template<class T, class Alloc>
+	void list<T, Alloc>::pop_front(){
 		auto oldNode = head.p;
 		head.p = oldNode->next;
 		head.p->prev = nullptr;
 		deleteNode(oldNode);
 	}
-	template<class T>
-	void list<T>::push_back(const value_type& val){
+	template<class T, class Alloc>
+	void list<T, Alloc>::push_back(const value_type& val){
 		auto node = newNode();
 		(tail.p)->data = val;
 		(tail.p)->next = node;
 		node->prev = tail.p;
 		tail.p = node;
 	}
-	template<class T>
-	void list<T>::pop_back(){
+	template<class T, class Alloc>
+	void list<T, Alloc>::pop_back(){
 		auto newTail = tail.p->prev;
 		newTail->next = nullptr;
 		deleteNode(tail.p);
 		tail.p = newTail;
 	}
-	template<class T>
-	typename list<T>::iterator list<T>::insert(iterator position, const value_type& val){
+	template<class T, class Alloc>
+	typename list<T, Alloc>::iterator list<T, Alloc>::insert(iterator position, const value_type& val){
 		if (position == begin()){
 			push_front(val);
 			return begin();
@@ -168,17 +197,17 @@ namespace TinySTL{
 		position.p->prev = node;
 		return iterator(node);
 	}
-	template<class T>
-	void list<T>::insert(iterator position, size_type n, const value_type& val){
+	template<class T, class Alloc>
+	void list<T, Alloc>::insert(iterator position, size_type n, const value_type& val){
 		insert_aux(position, n, val, typename std::is_integral<InputIterator>::type());
 	}
-	template<class T>
+	template<class T, class Alloc>
 	template <class InputIterator>
-	void list<T>::insert(iterator position, InputIterator first, InputIterator last){
+	void list<T, Alloc>::insert(iterator position, InputIterator first, InputIterator last){
 		insert_aux(position, first, last, typename std::is_integral<InputIterator>::type());
 	}
-	template<class T>
-	typename list<T>::iterator list<T>::erase(iterator position){
+	template<class T, class Alloc>
+	typename list<T, Alloc>::iterator list<T, Alloc>::erase(iterator position){
 		if (position == head){
 			pop_front();
 			return head;
@@ -191,55 +220,53 @@ namespace TinySTL{
 			return iterator(prev->next);
 		}
 	}
-	template<class T>
-	typename list<T>::iterator list<T>::erase(iterator first, iterator last){
-		typename list<T>::iterator res;
+	template<class T, class Alloc>
+	typename list<T, Alloc>::iterator list<T, Alloc>::erase(iterator first, iterator last){
+		typename list<T, Alloc>::iterator res;
 		for (; first != last;){
 			auto temp = first++;
 			res = erase(temp);
 		}
 		return res;
 	}
-	template<class T>
-	void list<T>::clear(){
+	template<class T, class Alloc>
+	void list<T, Alloc>::clear(){
 		erase(begin(), end());
 	}
-	template<class T>
-	typename list<T>::iterator list<T>::begin(){
+	template<class T, class Alloc>
+	typename list<T, Alloc>::iterator list<T, Alloc>::begin(){
 		return head;
 	}
-	template<class T>
-	typename list<T>::iterator list<T>::end(){
+	template<class T, class Alloc>
+	typename list<T, Alloc>::iterator list<T, Alloc>::end(){
 		return tail;
 	}
-	template<class T>
-	typename list<T>::const_iterator list<T>::changeIteratorToConstIterator(iterator& it)const{
+	template<class T, class Alloc>
+	typename list<T, Alloc>::const_iterator list<T, Alloc>::changeIteratorToConstIterator(iterator& it)const{
+		//node<T>node<const T>ĲֱָͬԭĽڵ(ǰָһֲ)
 		using nodeP = Detail::node<const T>*;
-		auto temp = (list<const T>*const)this;
-		auto ptr = it.p;
-		Detail::node<const T> node(ptr->data, (nodeP)(ptr->prev), (nodeP)(ptr->next), temp);
-		return const_iterator(&node);
+		return const_iterator((nodeP)(it.p));
 	}
-	template<class T>
-	typename list<T>::const_iterator list<T>::begin()const{
+	template<class T, class Alloc>
+	typename list<T, Alloc>::const_iterator list<T, Alloc>::begin()const{
 		auto temp = (list*const)this;
 		return changeIteratorToConstIterator(temp->head);
 	}
-	template<class T>
-	typename list<T>::const_iterator list<T>::end()const{
+	template<class T, class Alloc>
+	typename list<T, Alloc>::const_iterator list<T, Alloc>::end()const{
 		auto temp = (list*const)this;
 		return changeIteratorToConstIterator(temp->tail);
 	}
-	template<class T>
-	typename list<T>::reverse_iterator list<T>::rbegin(){
+	template<class T, class Alloc>
+	typename list<T, Alloc>::reverse_iterator list<T, Alloc>::rbegin(){
 		return reverse_iterator(tail);
 	}
-	template<class T>
-	typename list<T>::reverse_iterator list<T>::rend(){
+	template<class T, class Alloc>
+	typename list<T, Alloc>::reverse_iterator list<T, Alloc>::rend(){
 		return reverse_iterator(head);
 	}
-	template<class T>
-	void list<T>::reverse(){//β巨
+	template<class T, class Alloc>
+	void list<T, Alloc>::reverse(){//β巨
 		if (empty() || head.p->next == tail.p) return;
 		auto curNode = head.p;
 		head.p = tail.p->prev;
@@ -253,8 +280,8 @@ namespace TinySTL{
 			curNode = nextNode;
 		} while (curNode != head.p);
 	}
-	template<class T>
-	void list<T>::remove(const value_type& val){
+	template<class T, class Alloc>
+	void list<T, Alloc>::remove(const value_type& val){
 		for (auto it = begin(); it != end();){
 			if (*it == val)
 				it = erase(it);
@@ -262,9 +289,9 @@ namespace TinySTL{
 				++it;
 		}
 	}
-	template<class T>
+	template<class T, class Alloc>
 	template <class Predicate>
-	void list<T>::remove_if(Predicate pred){
+	void list<T, Alloc>::remove_if(Predicate pred){
 		for (auto it = begin(); it != end();){
 			if (pred(*it))
 				it = erase(it);
@@ -272,17 +299,18 @@ namespace TinySTL{
 				++it;
 		}
 	}
-	template<class T>
-	void list<T>::swap(list& x){
+	template<class T, class Alloc>
+	void list<T, Alloc>::swap(list& x){
 		TinySTL::swap(head.p, x.head.p);
 		TinySTL::swap(tail.p, x.tail.p);
+		TinySTL::swap(alloc_, x.alloc_);
 	}
-	template<class T>
-	void swap(list<T>& x, list<T>& y){
+	template<class T, class Alloc>
+	void swap(list<T, Alloc>& x, list<T, Alloc>& y){
 		x.swap(y);
 	}
-	template<class T>
-	void list<T>::unique(){
+	template<class T, class Alloc>
+	void list<T, Alloc>::unique(){
 		nodePtr curNode = head.p;
 		while (curNode != tail.p){
 			nodePtr nextNode = curNode->next;
@@ -302,9 +330,9 @@ namespace TinySTL{
 			}
 		}
 	}
-	template<class T>
+	template<class T, class Alloc>
 	template <class BinaryPredicate>
-	void list<T>::unique(BinaryPredicate binary_pred){
+	void list<T, Alloc>::unique(BinaryPredicate binary_pred){
 		nodePtr curNode = head.p;
 		while (curNode != tail.p){
 			nodePtr nextNode = curNode->next;
@@ -324,13 +352,12 @@ namespace TinySTL{
 			}
 		}
 	}
-	template<class T>
-	void list<T>::splice(iterator position, list& x){
-		this->insert(position, x.begin(), x.end());
-		x.head.p = x.tail.p;
+	template<class T, class Alloc>
+	void list<T, Alloc>::splice(iterator position, list& x){
+		this->splice(position, x, x.begin(), x.end());
 	}
-	template<class T>
-	void list<T>::splice(iterator position, list& x, iterator first, iterator last){
+	template<class T, class Alloc>
+	void list<T, Alloc>::splice(iterator position, list& x, iterator first, iterator last){
 		if (first.p == last.p) return;
 		auto tailNode = last.p->prev;
 		if (x.head.p == first.p){
@@ -354,13 +381,13 @@ namespace TinySTL{
 			position.p->prev = tailNode;
 		}
 	}
-	template<class T>
-	void list<T>::splice(iterator position, list& x, iterator i){
+	template<class T, class Alloc>
+	void list<T, Alloc>::splice(iterator position, list& x, iterator i){
 		auto next = i;
 		this->splice(position, x, i, ++next);
 	}
-	template<class T>
-	void list<T>::merge(list& x){
+	template<class T, class Alloc>
+	void list<T, Alloc>::merge(list& x){
 		auto it1 = begin(), it2 = x.begin();
 		while (it1 != end() && it2 != x.end()){
 			if (*it1 <= *it2)
@@ -374,9 +401,9 @@ namespace TinySTL{
 			this->splice(it1, x, it2, x.end());
 		}
 	}
-	template<class T>
+	template<class T, class Alloc>
 	template <class Compare>
-	void list<T>::merge(list& x, Compare comp){
+	void list<T, Alloc>::merge(list& x, Compare comp){
 		auto it1 = begin(), it2 = x.begin();
 		while (it1 != end() && it2 != x.end()){
 			if (comp(*it2, *it1)){
@@ -390,8 +417,8 @@ namespace TinySTL{
 			this->splice(it1, x, it2, x.end());
 		}
 	}
-	template <class T>
-	bool operator== (const list<T>& lhs, const list<T>& rhs){
+	template <class T, class Alloc>
+	bool operator== (const list<T, Alloc>& lhs, const list<T, Alloc>& rhs){
 		auto node1 = lhs.head.p, node2 = rhs.head.p;
 		for (; node1 != lhs.tail.p && node2 != rhs.tail.p; node1 = node1->next, node2 = node2->next){
 			if (node1->data != node2->data)
@@ -401,17 +428,17 @@ namespace TinySTL{
 			return true;
 		return false;
 	}
-	template <class T>
-	bool operator!= (const list<T>& lhs, const list<T>& rhs){
+	template <class T, class Alloc>
+	bool operator!= (const list<T, Alloc>& lhs, const list<T, Alloc>& rhs){
 		return !(lhs == rhs);
 	}
-	template<class T>
-	void list<T>::sort(){
+	template<class T, class Alloc>
+	void list<T, Alloc>::sort(){
 		sort(TinySTL::less<T>());
 	}
-	template<class T>
+	template<class T, class Alloc>
 	template <class Compare>
-	void list<T>::sort(Compare comp){
+	void list<T, Alloc>::sort(Compare comp){
 		if (empty() || head.p->next == tail.p)
 			return;
 
@@ -429,10 +456,11 @@ namespace TinySTL{
 			if (i == fill)
 				++fill;
 		}
-		for (int i = 0; i != fill; ++i){
+		for (int i = 1; i != fill; ++i){
 			counter[i].merge(counter[i - 1], comp);
 		}
-		swap(counter[fill - 1]);
+		//ڵ㶼alloc_spliceŻضswap*thisȻʹԭķ
+		splice(end(), counter[fill - 1]);
 	}
 }
 
@@ -0,0 +1,74 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace TinySTL{
+	namespace Detail{
+		mapped_file::mapped_file(const char *path, const char *who)
+			:base_(0), size_(0), file_(0), mapping_(0){
+#ifdef _WIN32
+			HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+			if (file == INVALID_HANDLE_VALUE)
+				throw std::runtime_error(std::string(who) + ": cannot open the file");
+			file_ = file;
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(file, &size) || size.QuadPart == 0){
+				unmap();
+				throw std::runtime_error(std::string(who) + ": bad file");
+			}
+			size_ = static_cast<size_t>(size.QuadPart);
+			mapping_ = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+			if (mapping_)
+				base_ = static_cast<const char *>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+			if (!base_){
+				unmap();
+				throw std::runtime_error(std::string(who) + ": mmap failed");
+			}
+#else
+			int fd = open(path, O_RDONLY);
+			if (fd < 0)
+				throw std::runtime_error(std::string(who) + ": cannot open the file");
+			struct stat st;
+			if (fstat(fd, &st) != 0 || st.st_size == 0){
+				close(fd);
+				throw std::runtime_error(std::string(who) + ": bad file");
+			}
+			size_ = static_cast<size_t>(st.st_size);
+			void *p = mmap(0, size_, PROT_READ, MAP_SHARED, fd, 0);
+			close(fd);//ӳ佨֮ͲҪļ
+			if (p == MAP_FAILED)
+				throw std::runtime_error(std::string(who) + ": mmap failed");
+			base_ = static_cast<const char *>(p);
+#endif
+		}
+		mapped_file::~mapped_file(){
+			unmap();
+		}
+		void mapped_file::unmap(){
+#ifdef _WIN32
+			if (base_)
+				UnmapViewOfFile(base_);
+			if (mapping_)
+				CloseHandle(mapping_);
+			if (file_)
+				CloseHandle(file_);
+#else
+			if (base_)
+				munmap(const_cast<char *>(base_), size_);
+#endif
+			base_ = 0;
+			mapping_ = file_ = 0;
+		}
+	}
+}
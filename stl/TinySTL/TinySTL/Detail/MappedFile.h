@@ -0,0 +1,30 @@
+#ifndef _MAPPED_FILE_H_
+#define _MAPPED_FILE_H_
+
+#include <cstddef>
+
+namespace TinySTL{
+	namespace Detail{
+		//ļֻӳ䵽ڴ棬mapped_suffix_arraycompact_trie
+		//򿪻ӳʧʱ׳std::runtime_errorwhat()whoͷ
+		class mapped_file{
+		private:
+			const char *base_;
+			size_t size_;
+			void *file_;//ֻWindowsʹ
+			void *mapping_;
+		public:
+			mapped_file(const char *path, const char *who);
+			mapped_file(const mapped_file&) = delete;
+			mapped_file& operator = (const mapped_file&) = delete;
+			~mapped_file();
+
+			const char *data()const{ return base_; }
+			size_t size()const{ return size_; }
+		private:
+			void unmap();
+		};
+	}
+}
+
+#endif
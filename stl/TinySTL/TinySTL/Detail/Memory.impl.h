@@ -0,0 +1,108 @@
+#ifndef _MEMORY_IMPL_H_
+#define _MEMORY_IMPL_H_
+
+#include <cstdint>
+#include <stdexcept>
+
+namespace TinySTL{
+	template<class T>
+	atomic_shared_ptr<T>::~atomic_shared_ptr(){
+		delete get_node(word_.load(std::memory_order_relaxed));
+	}
+	template<class T>
+	typename atomic_shared_ptr<T>::word_type atomic_shared_ptr<T>::make_word(const shared_ptr<T>& sp){
+		if (!sp.ptr_ && !sp.ref_)
+			return 0;
+		node *n = new node(sp);
+		word_type raw = reinterpret_cast<uintptr_t>(n);
+		if (raw >> (64 - COUNT_BITS)){
+			delete n;
+			throw std::runtime_error("atomic_shared_ptr: address wider than 48 bits");
+		}
+		return raw << COUNT_BITS;
+	}
+	template<class T>
+	typename atomic_shared_ptr<T>::word_type atomic_shared_ptr<T>::acquire()const{
+		word_type w = word_.load(std::memory_order_relaxed);
+		while (get_node(w)){
+			//acquirestorereleaseԣ֤nodeshared_ptr
+			if (word_.compare_exchange_weak(w, w + 1, std::memory_order_acquire, std::memory_order_relaxed))
+				return w + 1;
+		}
+		return w;
+	}
+	template<class T>
+	void atomic_shared_ptr<T>::release(node *n)const{
+		word_type w = word_.load(std::memory_order_relaxed);
+		while (get_node(w) == n){
+			//release֤nodeĶȡڻ߳ɾ֮ǰ
+			if (word_.compare_exchange_weak(w, w - 1, std::memory_order_release, std::memory_order_relaxed))
+				return;
+		}
+		if (n->inner_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			delete n;
+	}
+	template<class T>
+	void atomic_shared_ptr<T>::retire(node *n, size_t count){
+		if (n->inner_.fetch_add(long(count), std::memory_order_acq_rel) + long(count) == 0)
+			delete n;
+	}
+	template<class T>
+	shared_ptr<T> atomic_shared_ptr<T>::load()const{
+		node *n = get_node(acquire());
+		if (!n)
+			return shared_ptr<T>();
+		shared_ptr<T> sp(n->value_);
+		release(n);
+		return sp;
+	}
+	template<class T>
+	shared_ptr<T> atomic_shared_ptr<T>::exchange(const shared_ptr<T>& sp){
+		word_type w = word_.exchange(make_word(sp), std::memory_order_acq_rel);
+		node *n = get_node(w);
+		if (!n)
+			return shared_ptr<T>();
+		//жڿn->value_ܰmove
+		shared_ptr<T> old(n->value_);
+		retire(n, size_t(w & ((word_type(1) << COUNT_BITS) - 1)));
+		return old;
+	}
+	template<class T>
+	bool atomic_shared_ptr<T>::compare_exchange_strong(shared_ptr<T>& expected, const shared_ptr<T>& desired){
+		word_type next = 0;
+		bool made = false;
+		for (;;){
+			word_type w = acquire();
+			node *n = get_node(w);
+			bool same = n ? (n->value_.ptr_ == expected.ptr_ && n->value_.ref_ == expected.ref_)
+				: (!expected.ptr_ && !expected.ref_);
+			if (!same){
+				expected = n ? n->value_ : shared_ptr<T>();
+				if (n)
+					release(n);
+				if (made)
+					delete get_node(next);
+				return false;
+			}
+			if (!made){
+				next = make_word(desired);
+				made = true;
+			}
+			//ⲿ߽仯ֻҪͬһnode
+			do{
+				if (word_.compare_exchange_weak(w, next, std::memory_order_acq_rel, std::memory_order_relaxed)){
+					if (n){
+						//תƵⲿԼһΣͨڲ
+						retire(n, size_t(w & ((word_type(1) << COUNT_BITS) - 1)));
+						release(n);
+					}
+					return true;
+				}
+			} while (get_node(w) == n);
+			if (n)
+				release(n);
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,231 @@
+#include "../MemoryResource.h"
+#include "../Alloc.h"
+
+namespace TinySTL{
+	namespace{
+		size_t align_up(size_t n, size_t alignment){
+			return (n + alignment - 1) & ~(alignment - 1);
+		}
+		//pҪֽڲܰalignment
+		size_t padding(const void *p, size_t alignment){
+			return align_up(reinterpret_cast<size_t>(p), alignment) - reinterpret_cast<size_t>(p);
+		}
+		//β֤alignmentʱalignmentֽڣԭʼַڷصַǰ
+		void *align_block(void *raw, size_t alignment){
+			char *p = static_cast<char *>(raw) + sizeof(void *);
+			p += padding(p, alignment);
+			reinterpret_cast<void **>(p)[-1] = raw;
+			return p;
+		}
+		void *raw_block(void *p){ return static_cast<void **>(p)[-1]; }
+
+		class new_delete_resource_imp : public memory_resource{
+		private:
+			void *do_allocate(size_t bytes, size_t alignment) override{
+				if (alignment <= max_align)
+					return ::operator new(bytes);
+				return align_block(::operator new(bytes + alignment), alignment);
+			}
+			void do_deallocate(void *p, size_t, size_t alignment) override{
+				::operator delete(alignment <= max_align ? p : raw_block(p));
+			}
+			bool do_is_equal(const memory_resource& other)const override{ return this == &other; }
+		};
+		class null_memory_resource_imp : public memory_resource{
+		private:
+			void *do_allocate(size_t, size_t) override{ throw std::bad_alloc(); }
+			void do_deallocate(void *, size_t, size_t) override{}
+			bool do_is_equal(const memory_resource& other)const override{ return this == &other; }
+		};
+		class alloc_resource_imp : public memory_resource{
+		private:
+			//allocСֻ8ֽڶ
+			enum { alloc_align = 8 };
+			void *do_allocate(size_t bytes, size_t alignment) override{
+				if (alignment <= alloc_align)
+					return alloc::allocate(bytes);
+				return align_block(alloc::allocate(bytes + alignment), alignment);
+			}
+			void do_deallocate(void *p, size_t bytes, size_t alignment) override{
+				if (alignment <= alloc_align)
+					alloc::deallocate(p, bytes);
+				else
+					alloc::deallocate(raw_block(p), bytes + alignment);
+			}
+			bool do_is_equal(const memory_resource& other)const override{ return this == &other; }
+		};
+
+		new_delete_resource_imp new_delete_instance;
+		null_memory_resource_imp null_instance;
+		alloc_resource_imp alloc_instance;
+		memory_resource *default_resource = &new_delete_instance;
+	}
+
+	memory_resource *new_delete_resource(){ return &new_delete_instance; }
+	memory_resource *null_memory_resource(){ return &null_instance; }
+	memory_resource *alloc_resource(){ return &alloc_instance; }
+	memory_resource *get_default_resource(){ return default_resource; }
+	memory_resource *set_default_resource(memory_resource *r){
+		memory_resource *old = default_resource;
+		default_resource = r ? r : &new_delete_instance;
+		return old;
+	}
+
+	//**********monotonic_buffer_resource*****************
+	monotonic_buffer_resource::monotonic_buffer_resource(memory_resource *upstream)
+		:upstream_(upstream), initialBuffer_(0), initialSize_(0), cur_(0), left_(0),
+		nextSize_(initial_size), chunks_(0){}
+	monotonic_buffer_resource::monotonic_buffer_resource(size_t initialSize, memory_resource *upstream)
+		:upstream_(upstream), initialBuffer_(0), initialSize_(0), cur_(0), left_(0),
+		nextSize_(initialSize < 64 ? 64 : initialSize), chunks_(0){}
+	monotonic_buffer_resource::monotonic_buffer_resource(void *buffer, size_t size, memory_resource *upstream)
+		:upstream_(upstream), initialBuffer_(buffer), initialSize_(size), cur_(static_cast<char *>(buffer)), left_(size),
+		nextSize_(size < size_t(initial_size) ? size_t(initial_size) : size * 2), chunks_(0){}
+	void monotonic_buffer_resource::release(){
+		while (chunks_){
+			chunk *next = chunks_->next_;
+			upstream_->deallocate(chunks_, chunks_->bytes_, max_align);
+			chunks_ = next;
+		}
+		//ṩbufferʹ
+		cur_ = static_cast<char *>(initialBuffer_);
+		left_ = initialSize_;
+	}
+	void *monotonic_buffer_resource::do_allocate(size_t bytes, size_t alignment){
+		size_t pad = padding(cur_, alignment);
+		if (cur_ == 0 || pad + bytes > left_){
+			//µһһ()ͷڿͷ
+			//䰴ʵʷصĵַ㣬Ҫµalignment - 1ֽ
+			size_t size = nextSize_;
+			while (size < sizeof(chunk) + alignment - 1 + bytes)
+				size *= 2;
+			chunk *c = static_cast<chunk *>(upstream_->allocate(size, max_align));
+			c->next_ = chunks_;
+			c->bytes_ = size;
+			chunks_ = c;
+			cur_ = reinterpret_cast<char *>(c + 1);
+			left_ = size - sizeof(chunk);
+			nextSize_ = size * 2;
+			pad = padding(cur_, alignment);
+		}
+		void *res = cur_ + pad;
+		cur_ += pad + bytes;
+		left_ -= pad + bytes;
+		return res;
+	}
+
+	//**********unsynchronized_pool_resource*****************
+	unsynchronized_pool_resource::unsynchronized_pool_resource(memory_resource *upstream)
+		:upstream_(upstream), poolCount_(0), chunks_(0), large_(0){
+		init(pool_options());
+	}
+	unsynchronized_pool_resource::unsynchronized_pool_resource(const pool_options& opts, memory_resource *upstream)
+		:upstream_(upstream), poolCount_(0), chunks_(0), large_(0){
+		init(opts);
+	}
+	void unsynchronized_pool_resource::init(const pool_options& opts){
+		options_ = opts;
+		if (options_.max_blocks_per_chunk == 0)
+			options_.max_blocks_per_chunk = default_blocks_per_chunk;
+		if (options_.largest_required_pool_block == 0)
+			options_.largest_required_pool_block = default_largest_block;
+		size_t block = min_block;
+		for (; poolCount_ != max_pools && block < options_.largest_required_pool_block; block *= 2)
+			++poolCount_;
+		if (poolCount_ != max_pools)
+			++poolCount_;
+		options_.largest_required_pool_block = size_t(min_block) << (poolCount_ - 1);
+		for (size_t i = 0; i != poolCount_; ++i){
+			pools_[i].free_ = 0;
+			pools_[i].blockSize_ = size_t(min_block) << i;
+			pools_[i].nextBlocks_ = 1;
+		}
+	}
+	void unsynchronized_pool_resource::release(){
+		while (chunks_){
+			chunk *next = chunks_->next_;
+			upstream_->deallocate(chunks_, chunks_->bytes_, max_align);
+			chunks_ = next;
+		}
+		while (large_){
+			large_block *next = large_->next_;
+			upstream_->deallocate(large_->raw_, large_->bytes_, max_align);
+			large_ = next;
+		}
+		for (size_t i = 0; i != poolCount_; ++i){
+			pools_[i].free_ = 0;
+			pools_[i].nextBlocks_ = 1;
+		}
+	}
+	size_t unsynchronized_pool_resource::pool_index(size_t bytes, size_t alignment)const{
+		if (alignment > max_align)
+			return poolCount_;
+		if (bytes < alignment)
+			bytes = alignment;
+		size_t i = 0;
+		for (size_t block = min_block; i != poolCount_ && block < bytes; block *= 2)
+			++i;
+		return i;
+	}
+	void unsynchronized_pool_resource::refill(pool& p){
+		size_t header = align_up(sizeof(chunk), max_align);
+		size_t blocks = p.nextBlocks_;
+		chunk *c = static_cast<chunk *>(upstream_->allocate(header + blocks * p.blockSize_, max_align));
+		c->next_ = chunks_;
+		c->bytes_ = header + blocks * p.blockSize_;
+		chunks_ = c;
+		//µ鴮
+		char *first = reinterpret_cast<char *>(c) + header;
+		for (size_t i = blocks; i != 0; --i){
+			char *block = first + (i - 1) * p.blockSize_;
+			*reinterpret_cast<void **>(block) = p.free_;
+			p.free_ = block;
+		}
+		if (p.nextBlocks_ * 2 <= options_.max_blocks_per_chunk)
+			p.nextBlocks_ *= 2;
+	}
+	void *unsynchronized_pool_resource::do_allocate(size_t bytes, size_t alignment){
+		size_t i = pool_index(bytes, alignment);
+		if (i != poolCount_){
+			pool& p = pools_[i];
+			if (!p.free_)
+				refill(p);
+			void *res = p.free_;
+			p.free_ = *static_cast<void **>(res);
+			return res;
+		}
+		//飺ͷڷصַǰ棬¼˫ͷʱO(1)ժ
+		//䰴ʵʷصĵַ
+		size_t align = alignment < size_t(max_align) ? size_t(max_align) : alignment;
+		size_t size = sizeof(large_block) + align - 1 + bytes;
+		char *raw = static_cast<char *>(upstream_->allocate(size, max_align));
+		char *res = raw + sizeof(large_block);
+		res += padding(res, align);
+		large_block *b = reinterpret_cast<large_block *>(res) - 1;
+		b->prev_ = 0;
+		b->next_ = large_;
+		b->raw_ = raw;
+		b->bytes_ = size;
+		if (large_)
+			large_->prev_ = b;
+		large_ = b;
+		return res;
+	}
+	void unsynchronized_pool_resource::do_deallocate(void *ptr, size_t bytes, size_t alignment){
+		size_t i = pool_index(bytes, alignment);
+		if (i != poolCount_){
+			pool& p = pools_[i];
+			*static_cast<void **>(ptr) = p.free_;
+			p.free_ = ptr;
+			return;
+		}
+		large_block *b = static_cast<large_block *>(ptr) - 1;
+		if (b->prev_)
+			b->prev_->next_ = b->next_;
+		else
+			large_ = b->next_;
+		if (b->next_)
+			b->next_->prev_ = b->prev_;
+		upstream_->deallocate(b->raw_, b->bytes_, max_align);
+	}
+}
@@ -0,0 +1,58 @@
+#include "../PooledList.h"
+
+namespace TinySTL{
+	namespace Detail{
+		slab_pool::slab_pool(size_t nodeSize)
+			:nodeSize_(nodeSize < sizeof(void *) ? sizeof(void *) : nodeSize),
+			first_(nullptr), last_(nullptr), cur_(nullptr), next_(nullptr), end_(nullptr),
+			free_(nullptr), nextNodes_(FIRST_NODES){}
+		void *slab_pool::refill(){
+			//reset֮ȰеĿһ
+			if (cur_ && cur_->next){
+				cur_ = cur_->next;
+			}else{
+				size_t bytes = HEADER + nodeSize_ * nextNodes_;
+				slab *s = static_cast<slab *>(::operator new(bytes));
+				s->next = nullptr;
+				s->bytes = bytes;
+				if (last_)
+					last_->next = s;
+				else
+					first_ = s;
+				last_ = cur_ = s;
+				if (nodeSize_ * nextNodes_ * 2 <= MAX_SLAB_BYTES)
+					nextNodes_ *= 2;
+			}
+			next_ = reinterpret_cast<char *>(cur_) + HEADER;
+			end_ = next_ + (cur_->bytes - HEADER) / nodeSize_ * nodeSize_;
+			void *p = next_;
+			next_ += nodeSize_;
+			return p;
+		}
+		void slab_pool::reset(){
+			free_ = nullptr;
+			cur_ = first_;
+			if (cur_){
+				next_ = reinterpret_cast<char *>(cur_) + HEADER;
+				end_ = next_ + (cur_->bytes - HEADER) / nodeSize_ * nodeSize_;
+			}
+		}
+		void slab_pool::release(){
+			while (first_){
+				slab *next = first_->next;
+				::operator delete(first_);
+				first_ = next;
+			}
+			last_ = cur_ = nullptr;
+			next_ = end_ = nullptr;
+			free_ = nullptr;
+			nextNodes_ = FIRST_NODES;
+		}
+		size_t slab_pool::capacity()const{
+			size_t bytes = 0;
+			for (slab *s = first_; s; s = s->next)
+				bytes += s->bytes;
+			return bytes;
+		}
+	}
+}
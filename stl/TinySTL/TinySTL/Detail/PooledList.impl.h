@@ -0,0 +1,411 @@
+#ifndef _POOLED_LIST_IMPL_H_
+#define _POOLED_LIST_IMPL_H_
+
+#include <stdexcept>
+
+namespace TinySTL{
+	template<class T>
+	void pooled_list<T>::initHead(){
+		head_.prev = head_.next = &head_;
+		size_ = 0;
+	}
+	template<class T>
+	typename pooled_list<T>::pool_type& pooled_list<T>::pool()const{
+		if (!pool_)
+			pool_ = make_shared<pool_type>(sizeof(node));
+		return *pool_;
+	}
+	template<class T>
+	shared_ptr<typename pooled_list<T>::pool_type> pooled_list<T>::get_pool()const{
+		pool();
+		return pool_;
+	}
+	template<class T>
+	bool pooled_list<T>::sharePool(const pooled_list& x){
+		if (this == &x || pool_ == x.pool_)
+			return true;
+		if (!pool_ && x.pool_){
+			pool_ = x.pool_;
+			return true;
+		}
+		return false;
+	}
+	template<class T>
+	template<class... Args>
+	typename pooled_list<T>::link *pooled_list<T>::newNode(Args&&... args){
+		pool_type& p = pool();
+		void *mem = p.allocate();
+		try{
+			return ::new (mem) node(std::forward<Args>(args)...);
+		}catch (...){
+			p.deallocate(mem);
+			throw;
+		}
+	}
+	template<class T>
+	void pooled_list<T>::deleteNode(link *p){
+		static_cast<node*>(p)->~node();
+		pool_->deallocate(p);
+	}
+	template<class T>
+	void pooled_list<T>::transfer(link *position, link *first, link *last){
+		if (first == last || position == last)
+			return;
+		link *tail = last->prev;
+		first->prev->next = last;
+		last->prev = first->prev;
+		position->prev->next = first;
+		first->prev = position->prev;
+		tail->next = position;
+		position->prev = tail;
+	}
+	template<class T>
+	void pooled_list<T>::destroyAll(){
+		if (empty())
+			return;
+		//ֻԼʱڵ㲻ȥ
+		bool owned = pool_.unique();
+		if (!owned || !std::is_trivially_destructible<T>::value){
+			for (link *p = head_.next; p != &head_;){
+				link *next = p->next;
+				Detail::prefetch(next->next);
+				static_cast<node*>(p)->~node();
+				if (!owned)
+					pool_->deallocate(p);
+				p = next;
+			}
+		}
+		if (owned)
+			pool_->reset();
+		initHead();
+	}
+	template<class T>
+	void pooled_list<T>::ctorAux(size_type n, const value_type& val, std::true_type){
+		for (; n != 0; --n)
+			emplace_back(val);
+	}
+	template<class T>
+	template<class InputIterator>
+	void pooled_list<T>::ctorAux(InputIterator first, InputIterator last, std::false_type){
+		for (; first != last; ++first)
+			emplace_back(*first);
+	}
+	template<class T>
+	pooled_list<T>::pooled_list(){
+		initHead();
+	}
+	template<class T>
+	pooled_list<T>::pooled_list(const shared_ptr<pool_type>& pool) :pool_(pool){
+		if (pool_ && pool_->node_size() != sizeof(node))
+			throw std::invalid_argument("pooled_list: pool node size mismatch");
+		initHead();
+	}
+	template<class T>
+	pooled_list<T>::pooled_list(size_type n, const value_type& val){
+		initHead();
+		ctorAux(n, val, std::true_type());
+	}
+	template<class T>
+	template<class InputIterator>
+	pooled_list<T>::pooled_list(InputIterator first, InputIterator last){
+		initHead();
+		ctorAux(first, last, typename std::is_integral<InputIterator>::type());
+	}
+	template<class T>
+	pooled_list<T>::pooled_list(const pooled_list& l){
+		initHead();
+		ctorAux(l.begin(), l.end(), std::false_type());
+	}
+	template<class T>
+	pooled_list<T>::pooled_list(pooled_list&& l){
+		initHead();
+		swap(l);
+	}
+	template<class T>
+	pooled_list<T>& pooled_list<T>::operator = (const pooled_list& l){
+		if (this != &l){
+			//еĽڵ
+			auto it = begin();
+			auto from = l.begin();
+			for (; it != end() && from != l.end(); ++it, ++from)
+				*it = *from;
+			if (from == l.end())
+				erase(it, end());
+			else
+				insert(end(), from, l.end());
+		}
+		return *this;
+	}
+	template<class T>
+	pooled_list<T>& pooled_list<T>::operator = (pooled_list&& l){
+		if (this != &l){
+			clear();
+			swap(l);
+		}
+		return *this;
+	}
+	template<class T>
+	pooled_list<T>::~pooled_list(){
+		destroyAll();
+	}
+	template<class T>
+	template<class... Args>
+	typename pooled_list<T>::iterator pooled_list<T>::emplace(const_iterator position, Args&&... args){
+		link *n = newNode(std::forward<Args>(args)...);
+		link *next = position.p;
+		n->next = next;
+		n->prev = next->prev;
+		next->prev->next = n;
+		next->prev = n;
+		++size_;
+		return iterator(n);
+	}
+	template<class T>
+	typename pooled_list<T>::iterator pooled_list<T>::insert(const_iterator position, size_type n, const value_type& val){
+		iterator res(position.p);
+		for (; n != 0; --n){
+			auto it = emplace(position, val);
+			if (res.p == position.p)
+				res = it;
+		}
+		return res;
+	}
+	template<class T>
+	template<class InputIterator>
+	typename pooled_list<T>::iterator pooled_list<T>::insert(const_iterator position, InputIterator first, InputIterator last){
+		iterator res(position.p);
+		for (; first != last; ++first){
+			auto it = emplace(position, *first);
+			if (res.p == position.p)
+				res = it;
+		}
+		return res;
+	}
+	template<class T>
+	typename pooled_list<T>::iterator pooled_list<T>::erase(const_iterator position){
+		link *p = position.p, *next = p->next;
+		p->prev->next = next;
+		next->prev = p->prev;
+		deleteNode(p);
+		--size_;
+		return iterator(next);
+	}
+	template<class T>
+	typename pooled_list<T>::iterator pooled_list<T>::erase(const_iterator first, const_iterator last){
+		while (first != last)
+			first = erase(first);
+		return iterator(last.p);
+	}
+	template<class T>
+	void pooled_list<T>::clear(){
+		destroyAll();
+	}
+	template<class T>
+	void pooled_list<T>::swap(pooled_list& x){
+		std::swap(head_, x.head_);
+		std::swap(size_, x.size_);
+		pool_.swap(x.pool_);
+		//ڱڶβڵָԵڱ
+		if (size_ == 0)
+			head_.prev = head_.next = &head_;
+		else
+			head_.next->prev = head_.prev->next = &head_;
+		if (x.size_ == 0)
+			x.head_.prev = x.head_.next = &x.head_;
+		else
+			x.head_.next->prev = x.head_.prev->next = &x.head_;
+	}
+	template<class T>
+	void pooled_list<T>::splice(const_iterator position, pooled_list& x){
+		if (this == &x || x.empty())
+			return;
+		if (sharePool(x)){
+			transfer(position.p, x.head_.next, &x.head_);
+			size_ += x.size_;
+			x.size_ = 0;
+			return;
+		}
+		pooled_list moved(get_pool());
+		for (auto it = x.begin(); it != x.end(); ++it)
+			moved.emplace_back(std::move(*it));
+		x.clear();
+		splice(position, moved);
+	}
+	template<class T>
+	void pooled_list<T>::splice(const_iterator position, pooled_list& x, const_iterator i){
+		if (sharePool(x)){
+			link *p = i.p;
+			if (position.p == p || position.p == p->next)
+				return;
+			transfer(position.p, p, p->next);
+			++size_;
+			--x.size_;
+			return;
+		}
+		emplace(position, std::move(value(i.p)));
+		x.erase(i);
+	}
+	template<class T>
+	void pooled_list<T>::splice(const_iterator position, pooled_list& x, const_iterator first, const_iterator last){
+		if (first == last)
+			return;
+		if (sharePool(x)){
+			if (this != &x){
+				size_type n = 0;
+				for (link *p = first.p; p != last.p; p = p->next)
+					++n;
+				size_ += n;
+				x.size_ -= n;
+			}
+			transfer(position.p, first.p, last.p);
+			return;
+		}
+		pooled_list moved(get_pool());
+		for (auto it = first; it != last; ++it)
+			moved.emplace_back(std::move(value(it.p)));
+		x.erase(first, last);
+		splice(position, moved);
+	}
+	template<class T>
+	void pooled_list<T>::remove(const value_type& val){
+		//valܾԪأɾĽڵͷ
+		pooled_list removed(get_pool());
+		for (link *p = head_.next; p != &head_;){
+			link *next = p->next;
+			if (value(p) == val)
+				removed.splice(removed.end(), *this, iterator(p));
+			p = next;
+		}
+	}
+	template<class T>
+	template<class Predicate>
+	void pooled_list<T>::remove_if(Predicate pred){
+		for (link *p = head_.next; p != &head_;){
+			link *next = p->next;
+			Detail::prefetch(next->next);
+			if (pred(value(p)))
+				erase(iterator(p));
+			p = next;
+		}
+	}
+	template<class T>
+	template<class BinaryPredicate>
+	void pooled_list<T>::unique(BinaryPredicate binary_pred){
+		if (size_ < 2)
+			return;
+		link *cur = head_.next;
+		for (link *next = cur->next; next != &head_; next = cur->next){
+			Detail::prefetch(next->next);
+			if (binary_pred(value(cur), value(next)))
+				erase(iterator(next));
+			else
+				cur = next;
+		}
+	}
+	template<class T>
+	template<class Compare>
+	void pooled_list<T>::merge(pooled_list& x, Compare comp){
+		if (this == &x || x.empty())
+			return;
+		if (!sharePool(x)){
+			pooled_list moved(get_pool());
+			moved.splice(moved.end(), x);
+			merge(moved, comp);
+			return;
+		}
+		link *a = head_.next, *b = x.head_.next;
+		while (a != &head_ && b != &x.head_){
+			if (comp(value(b), value(a))){
+				//xС*aһһνӹ
+				link *last = b->next;
+				while (last != &x.head_ && comp(value(last), value(a)))
+					last = last->next;
+				transfer(a, b, last);
+				b = last;
+			}else{
+				a = a->next;
+			}
+		}
+		transfer(&head_, b, &x.head_);
+		size_ += x.size_;
+		x.size_ = 0;
+	}
+	template<class T>
+	template<class Compare>
+	typename pooled_list<T>::link *pooled_list<T>::mergeRuns(link *a, link *b, Compare& comp){
+		//aеԪضb֮ǰʱȡa֤ȶ
+		link dummy;
+		link *tail = &dummy;
+		while (a && b){
+			if (comp(value(b), value(a))){
+				tail->next = b;
+				tail = b;
+				b = b->next;
+			}else{
+				tail->next = a;
+				tail = a;
+				a = a->next;
+			}
+		}
+		tail->next = a ? a : b;
+		return dummy.next;
+	}
+	template<class T>
+	template<class Compare>
+	void pooled_list<T>::sort(Compare comp){
+		if (size_ < 2)
+			return;
+		//ʱֻnextnullptrβĵruns[i]Ϊnullptr߳Ϊ2^i
+		link *runs[64] = {};
+		int fill = 0;
+		head_.prev->next = nullptr;
+		for (link *p = head_.next; p;){
+			link *carry = p;
+			p = p->next;
+			carry->next = nullptr;
+			int i = 0;
+			for (; i != fill && runs[i]; ++i){
+				carry = mergeRuns(runs[i], carry, comp);
+				runs[i] = nullptr;
+			}
+			runs[i] = carry;
+			if (i == fill)
+				++fill;
+		}
+		//СĶǺ
+		link *sorted = nullptr;
+		for (int i = 0; i != fill; ++i){
+			if (runs[i])
+				sorted = sorted ? mergeRuns(runs[i], sorted, comp) : runs[i];
+		}
+		//һ˲prev
+		link *prev = &head_;
+		for (link *p = sorted; p; p = p->next){
+			prev->next = p;
+			p->prev = prev;
+			prev = p;
+		}
+		prev->next = &head_;
+		head_.prev = prev;
+	}
+	template<class T>
+	void pooled_list<T>::reverse(){
+		link *p = &head_;
+		do{
+			std::swap(p->prev, p->next);
+			p = p->prev;
+		} while (p != &head_);
+	}
+	template<class T>
+	bool operator== (const pooled_list<T>& lhs, const pooled_list<T>& rhs){
+		if (lhs.size() != rhs.size())
+			return false;
+		for (auto it1 = lhs.begin(), it2 = rhs.begin(); it1 != lhs.end(); ++it1, ++it2){
+			if (!(*it1 == *it2))
+				return false;
+		}
+		return true;
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,21 @@
+#ifndef _PREFETCH_H_
+#define _PREFETCH_H_
+
+#if defined(_MSC_VER)
+#include <xmmintrin.h>
+#endif
+
+namespace TinySTL{
+	namespace Detail{
+		//ֻʾppַ
+		inline void prefetch(const void *p){
+#if defined(__GNUC__)
+			__builtin_prefetch(p);
+#elif defined(_MSC_VER)
+			_mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#endif
+		}
+	}
+}
+
+#endif
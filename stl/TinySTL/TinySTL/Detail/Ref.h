@@ -2,8 +2,11 @@
 #define _REF_H_
 
 #include <atomic>
-#include <functional>
+#include <cstddef>
 #include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace TinySTL{
 	namespace Detail{
@@ -12,59 +15,88 @@ namespace TinySTL{
 			void operator ()(T* ptr){ if (ptr) delete ptr; }
 		};
 
-		template<class T>
-		struct ref_t{
-			using deleter_type = std::function < void(T*) >;
-
-			std::atomic<size_t> ncount_;
-			T *data_;
-			deleter_type deleter_;
+		//shared_ptr/weak_ptrõĿƿ
+		//uses_Ϊǿweaks_Ϊ(uses_ != 0)߹ʱͷſƿ鱾
+		//ֻrelaxedǴһеõҪĲͬ
+		//release0߳acquireդ̶֤߳Զȫ޸
+		class ref_count{
+		private:
+			std::atomic<size_t> uses_;
+			std::atomic<size_t> weaks_;
+		protected:
+			ref_count() :uses_(1), weaks_(1){}
+			virtual ~ref_count(){}
+		public:
+			ref_count(const ref_count&) = delete;
+			ref_count& operator = (const ref_count&) = delete;
 
-			explicit ref_t(T *p = nullptr, deleter_type pfunc = deleter_type(_default_delete<T>()))
-				: ncount_(0), data_(p), deleter_(pfunc){
-				if (data_)
-					ncount_ = 1;
+			void add_ref(){ uses_.fetch_add(1, std::memory_order_relaxed); }
+			//weak_ptr::lockֻڶ󻹻ʱ
+			bool add_ref_lock(){
+				size_t count = uses_.load(std::memory_order_relaxed);
+				while (count != 0){
+					if (uses_.compare_exchange_weak(count, count + 1, std::memory_order_relaxed))
+						return true;
+				}
+				return false;
 			}
-			ref_t(const ref_t&) = delete;
-			ref_t& operator = (const ref_t&) = delete;
-
-			~ref_t(){
-				--ncount_;
-				if (ncount_ == 0)
-					deleter_(data_);
+			void release(){
+				if (uses_.fetch_sub(1, std::memory_order_release) == 1){
+					std::atomic_thread_fence(std::memory_order_acquire);
+					dispose();
+					weak_release();
+				}
+			}
+			void weak_add_ref(){ weaks_.fetch_add(1, std::memory_order_relaxed); }
+			void weak_release(){
+				if (weaks_.fetch_sub(1, std::memory_order_release) == 1){
+					std::atomic_thread_fence(std::memory_order_acquire);
+					destroy();
+				}
 			}
+			size_t use_count()const{ return uses_.load(std::memory_order_relaxed); }
+			size_t weak_count()const{
+				size_t weaks = weaks_.load(std::memory_order_relaxed);
+				return use_count() ? weaks - 1 : weaks;
+			}
+		private:
+			//Ķ
+			virtual void dispose() = 0;
+			//ͷſƿ鱾
+			virtual void destroy(){ delete this; }
+		};
+
+		//һĶɾֵڿƿپstd::function
+		template<class T, class D = _default_delete<T>>
+		class ref_t : public ref_count{
+		private:
+			T *data_;
+			D deleter_;
+		public:
+			explicit ref_t(T *p, D del = D()) :data_(p), deleter_(std::move(del)){}
 
-			size_t count()const{ return ncount_.load(); }
 			T *get_data()const{ return data_; }
+			D& get_deleter(){ return deleter_; }
+		private:
+			void dispose()override{ deleter_(data_); }
+		};
 
-			ref_t& operator ++(){
-				++ncount_;
-				return *this;
-			}
-			ref_t operator ++(int){
-				auto t = *this;
-				++*this;
-				return t;
-			}
-			ref_t& operator --(){
-				--ncount_;
-				return *this;
-			}
-			ref_t operator --(int){
-				auto t = *this;
-				--*this;
-				return t;
+		//make_sharedʹõĿƿ飬Ϳƿһη
+		template<class T>
+		class ref_inplace : public ref_count{
+		private:
+			typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type storage_;
+		public:
+			template<class... Args>
+			explicit ref_inplace(Args&&... args){
+				::new (static_cast<void*>(&storage_)) T(std::forward<Args>(args)...);
 			}
+
+			T *get_data(){ return reinterpret_cast<T*>(&storage_); }
+		private:
+			void dispose()override{ get_data()->~T(); }
 		};
-		template<class T>
-		bool operator ==(const ref_t<T>& lhs, const ref_t<T>& rhs){
-			return lhs.get_data() == rhs.get_data();
-		}
-		template<class T>
-		bool operator !=(const ref_t<T>& lhs, const ref_t<T>& rhs){
-			return !(lhs == rhs);
-		}
 	}
 }
 
-#endif
\ No newline at end of file
+#endif
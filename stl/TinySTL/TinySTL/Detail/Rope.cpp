@@ -0,0 +1,555 @@
+#include "../Rope.h"
+
+#include <climits>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace TinySTL{
+	const size_t rope::npos;
+
+	namespace Detail{
+		namespace{
+			//ڵֱϵͳ룬TinySTL::allocڴز̰߳ȫ
+			const size_t leaf_header = sizeof(rope_leaf) - 1;
+			const size_t page_capacity = rope::leaf_bytes - leaf_header;
+
+			rope_leaf *new_leaf(size_t capacity){
+				rope_leaf *l = static_cast<rope_leaf *>(::operator new(leaf_header + capacity));
+				new(&l->refs_) std::atomic<size_t>(1);
+				l->size_ = 0;
+				l->capacity_ = (unsigned int)capacity;
+				l->depth_ = 0;
+				l->leaf_ = true;
+				return l;
+			}
+			rope_leaf *make_leaf(const char *s, size_t n, size_t capacity){
+				rope_leaf *l = new_leaf(capacity);
+				memcpy(l->data_, s, n);
+				l->size_ = n;
+				return l;
+			}
+			rope_node *new_concat(rope_node *left, rope_node *right){
+				if (!left)
+					return right;
+				if (!right)
+					return left;
+				rope_concat *c = static_cast<rope_concat *>(::operator new(sizeof(rope_concat)));
+				new(&c->refs_) std::atomic<size_t>(1);
+				c->size_ = left->size_ + right->size_;
+				c->capacity_ = 0;
+				c->depth_ = (unsigned char)(1 + (left->depth_ > right->depth_ ? left->depth_ : right->depth_));
+				c->leaf_ = false;
+				c->left_ = left;
+				c->right_ = right;
+				return c;
+			}
+			void ref(rope_node *n){
+				if (n)
+					n->refs_.fetch_add(1, std::memory_order_relaxed);
+			}
+			void unref(rope_node *n){
+				while (n && n->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1){
+					if (n->leaf_){
+						::operator delete(n);
+						return;
+					}
+					rope_concat *c = static_cast<rope_concat *>(n);
+					rope_node *right = c->right_;
+					unref(c->left_);
+					::operator delete(c);
+					n = right;//ѭݹ
+				}
+			}
+
+			//ƴlrӹߵãСҶӺϲһҳҶ
+			rope_node *concat(rope_node *l, rope_node *r){
+				if (!l)
+					return r;
+				if (!r)
+					return l;
+				if (r->leaf_ && l->leaf_ && l->size_ + r->size_ <= page_capacity){
+					rope_leaf *ll = static_cast<rope_leaf *>(l), *rl = static_cast<rope_leaf *>(r);
+					if (l->refs_.load(std::memory_order_acquire) == 1 && l->capacity_ >= l->size_ + r->size_){
+						memcpy(ll->data_ + ll->size_, rl->data_, rl->size_);
+						ll->size_ += rl->size_;
+						unref(r);
+						return l;
+					}
+					rope_leaf *res = make_leaf(ll->data_, ll->size_, page_capacity);
+					memcpy(res->data_ + res->size_, rl->data_, rl->size_);
+					res->size_ += rl->size_;
+					unref(l);
+					unref(r);
+					return res;
+				}
+				if (r->leaf_ && !l->leaf_){
+					rope_concat *c = static_cast<rope_concat *>(l);
+					if (c->right_->leaf_ && c->right_->size_ + r->size_ <= page_capacity){
+						rope_node *left = c->left_, *right = c->right_;
+						ref(left);
+						ref(right);
+						unref(l);
+						return new_concat(left, concat(right, r));
+					}
+				}
+				return new_concat(l, r);
+			}
+			//[s, s + n)гҳҶӣԵϽȫƽ
+			rope_node *build(const char *s, size_t n){
+				if (n == 0)
+					return 0;
+				if (n <= page_capacity)
+					return make_leaf(s, n, page_capacity);
+				size_t leaves = (n + page_capacity - 1) / page_capacity;
+				size_t leftBytes = leaves / 2 * page_capacity;
+				return new_concat(build(s, leftBytes), build(s + leftBytes, n - leftBytes));
+			}
+			rope_node *build_fill(size_t n, char c){
+				if (n == 0)
+					return 0;
+				if (n <= page_capacity){
+					rope_leaf *l = new_leaf(page_capacity);
+					memset(l->data_, c, n);
+					l->size_ = n;
+					return l;
+				}
+				size_t leaves = (n + page_capacity - 1) / page_capacity;
+				size_t leftBytes = leaves / 2 * page_capacity;
+				return new_concat(build_fill(leftBytes, c), build_fill(n - leftBytes, c));
+			}
+			//[first, last)Ӧãȫǵֱӹ
+			rope_node *subrange(rope_node *n, size_t first, size_t last){
+				if (!n || first >= last)
+					return 0;
+				if (first == 0 && last == n->size_){
+					ref(n);
+					return n;
+				}
+				if (n->leaf_){
+					size_t len = last - first;
+					return make_leaf(static_cast<rope_leaf *>(n)->data_ + first, len, len);
+				}
+				rope_concat *c = static_cast<rope_concat *>(n);
+				size_t ls = c->left_->size_;
+				if (last <= ls)
+					return subrange(c->left_, first, last);
+				if (first >= ls)
+					return subrange(c->right_, first - ls, last - ls);
+				return concat(subrange(c->left_, first, ls), subrange(c->right_, 0, last - ls));
+			}
+			void copy_node(const rope_node *n, size_t first, size_t last, char *dst){
+				while (!n->leaf_){
+					const rope_concat *c = static_cast<const rope_concat *>(n);
+					size_t ls = c->left_->size_;
+					if (last <= ls){
+						n = c->left_;
+					}
+					else if (first >= ls){
+						first -= ls;
+						last -= ls;
+						n = c->right_;
+					}
+					else{
+						copy_node(c->left_, first, ls, dst);
+						dst += ls - first;
+						first = 0;
+						last -= ls;
+						n = c->right_;
+					}
+				}
+				memcpy(dst, static_cast<const rope_leaf *>(n)->data_ + first, last - first);
+			}
+			//˳[first, last)ཻҶӣvisitorfalseʱֹͣ
+			template<class Visitor>
+			bool visit_leaves(const rope_node *n, size_t offset, size_t first, size_t last, Visitor& visitor){
+				if (n->leaf_)
+					return visitor(static_cast<const rope_leaf *>(n), offset);
+				const rope_concat *c = static_cast<const rope_concat *>(n);
+				size_t mid = offset + c->left_->size_;
+				if (first < mid && !visit_leaves(c->left_, offset, first, last, visitor))
+					return false;
+				if (last > mid)
+					return visit_leaves(c->right_, mid, first, last, visitor);
+				return true;
+			}
+
+			//**********ƽ(Boehm, Atkinson, Plass)*****************
+			//ΪdΪFib(d + 2)ƽ
+			struct rope_min_len{
+				size_t len_[rope::hard_max_depth + 2];
+				rope_min_len(){
+					len_[0] = 1;
+					len_[1] = 2;
+					for (size_t i = 2; i != rope::hard_max_depth + 2; ++i){
+						size_t a = len_[i - 1], b = len_[i - 2];
+						len_[i] = a > SIZE_MAX - b ? SIZE_MAX : a + b;
+					}
+				}
+			};
+			const rope_min_len min_len;
+
+			bool is_balanced(const rope_node *n){
+				return n->leaf_ || (n->depth_ < rope::hard_max_depth + 2 && n->size_ >= min_len.len_[n->depth_]);
+			}
+			//forest[i]е[min_len[i], min_len[i + 1])֮䣬Сκϲ
+			void add_leaf_to_forest(rope_node *insertee, rope_node **forest){
+				rope_node *tooTiny = 0;
+				size_t i = 0;
+				for (; insertee->size_ >= min_len.len_[i + 1]; ++i){
+					if (forest[i]){
+						tooTiny = new_concat(forest[i], tooTiny);
+						forest[i] = 0;
+					}
+				}
+				insertee = new_concat(tooTiny, insertee);
+				for (;; ++i){
+					if (forest[i]){
+						insertee = new_concat(forest[i], insertee);
+						forest[i] = 0;
+					}
+					if (i == rope::hard_max_depth || insertee->size_ < min_len.len_[i + 1]){
+						forest[i] = insertee;
+						return;
+					}
+				}
+			}
+			//Ѿƽforestֻ𿪲ƽĲ֣ԴڲƽĽڵ
+			void add_to_forest(rope_node *n, rope_node **forest){
+				if (is_balanced(n)){
+					ref(n);
+					add_leaf_to_forest(n, forest);
+					return;
+				}
+				rope_concat *c = static_cast<rope_concat *>(n);
+				add_to_forest(c->left_, forest);
+				add_to_forest(c->right_, forest);
+			}
+			//ﲻϲҶӣҶӱֲ䣬лҶָƽ֮ȻЧ
+			rope_node *balance(rope_node *root){
+				rope_node *forest[rope::hard_max_depth + 1] = { 0 };
+				add_to_forest(root, forest);
+				rope_node *res = 0;
+				for (size_t i = 0; i != rope::hard_max_depth + 1; ++i){
+					if (forest[i])
+						res = new_concat(forest[i], res);
+				}
+				return res;
+			}
+		}
+
+		void rope_iter::locate()const{
+			const rope_leaf *l = rope_->leaf_at(pos_, leafBegin_);
+			leaf_ = l->data_;
+			leafEnd_ = leafBegin_ + l->size_;
+		}
+	}
+
+	//**********죬ƣ*****************
+	rope::rope(const char *s) :root_(Detail::build(s, strlen(s))){}
+	rope::rope(const char *s, size_t n) : root_(Detail::build(s, n)){}
+	rope::rope(size_t n, char c) : root_(Detail::build_fill(n, c)){}
+	rope::rope(const string& str) : root_(Detail::build(str.data(), str.size())){}
+	rope::rope(const rope& r) : root_(r.root_){
+		Detail::ref(root_);
+	}
+	rope::rope(rope&& r) : root_(r.root_){
+		r.root_ = 0;
+	}
+	rope& rope::operator = (const rope& r){
+		Detail::ref(r.root_);
+		Detail::unref(root_);
+		root_ = r.root_;
+		return *this;
+	}
+	rope& rope::operator = (rope&& r){
+		if (this != &r){
+			Detail::unref(root_);
+			root_ = r.root_;
+			r.root_ = 0;
+		}
+		return *this;
+	}
+	rope::~rope(){
+		Detail::unref(root_);
+	}
+	void rope::clear(){
+		Detail::unref(root_);
+		root_ = 0;
+	}
+	void rope::swap(rope& r){
+		TinySTL::swap(root_, r.root_);
+	}
+	void rope::balance(){
+		if (!root_)
+			return;
+		Detail::rope_node *res = Detail::balance(root_);
+		Detail::unref(root_);
+		root_ = res;
+	}
+	//***************************
+	const Detail::rope_leaf *rope::leaf_at(size_t pos, size_t& leafBegin)const{
+		const Detail::rope_node *n = root_;
+		leafBegin = 0;
+		while (!n->leaf_){
+			const Detail::rope_concat *c = static_cast<const Detail::rope_concat *>(n);
+			size_t ls = c->left_->size_;
+			if (pos < ls){
+				n = c->left_;
+			}
+			else{
+				pos -= ls;
+				leafBegin += ls;
+				n = c->right_;
+			}
+		}
+		return static_cast<const Detail::rope_leaf *>(n);
+	}
+	char rope::operator[] (size_t pos)const{
+		size_t leafBegin;
+		const Detail::rope_leaf *l = leaf_at(pos, leafBegin);
+		return l->data_[pos - leafBegin];
+	}
+	char rope::at(size_t pos)const{
+		if (pos >= size())
+			throw std::out_of_range("rope::at");
+		return (*this)[pos];
+	}
+	//**********޸*****************
+	rope& rope::append(const char *s, size_t n){
+		if (n == 0)
+			return *this;
+		//ұ߽ߵҶӣ;Ľڵ㶼ռʱֱдҶӵĿв
+		if (root_){
+			Detail::rope_node *spine[max_depth + 8];
+			size_t depth = 0;
+			Detail::rope_node *cur = root_;
+			for (;; cur = static_cast<Detail::rope_concat *>(cur)->right_){
+				if (cur->refs_.load(std::memory_order_acquire) != 1){
+					depth = 0;
+					break;
+				}
+				spine[depth++] = cur;
+				if (cur->leaf_)
+					break;
+			}
+			if (depth != 0){
+				Detail::rope_leaf *l = static_cast<Detail::rope_leaf *>(spine[depth - 1]);
+				size_t room = l->capacity_ - l->size_;
+				size_t k = room < n ? room : n;
+				memcpy(l->data_ + l->size_, s, k);
+				for (size_t i = 0; i != depth; ++i)
+					spine[i]->size_ += k;
+				s += k;
+				n -= k;
+			}
+		}
+		if (n != 0)
+			root_ = Detail::concat(root_, Detail::build(s, n));
+		after_write();
+		return *this;
+	}
+	rope& rope::append(const rope& r){
+		if (r.root_ && r.root_->leaf_)//СƬԭ׷
+			return append(static_cast<Detail::rope_leaf *>(r.root_)->data_, r.root_->size_);
+		Detail::ref(r.root_);
+		root_ = Detail::concat(root_, r.root_);
+		after_write();
+		return *this;
+	}
+	rope& rope::insert(size_t pos, const rope& r){
+		if (pos > size())
+			throw std::out_of_range("rope::insert");
+		Detail::ref(r.root_);
+		Detail::rope_node *left = Detail::subrange(root_, 0, pos);
+		Detail::rope_node *right = Detail::subrange(root_, pos, size());
+		Detail::rope_node *res = Detail::concat(Detail::concat(left, r.root_), right);
+		Detail::unref(root_);
+		root_ = res;
+		after_write();
+		return *this;
+	}
+	rope& rope::insert(size_t pos, const char *s, size_t n){
+		if (pos == size())
+			return append(s, n);
+		return insert(pos, rope(s, n));
+	}
+	rope& rope::erase(size_t pos, size_t len){
+		if (pos > size())
+			throw std::out_of_range("rope::erase");
+		if (len > size() - pos)
+			len = size() - pos;
+		Detail::rope_node *res = Detail::concat(Detail::subrange(root_, 0, pos),
+			Detail::subrange(root_, pos + len, size()));
+		Detail::unref(root_);
+		root_ = res;
+		after_write();
+		return *this;
+	}
+	rope rope::substr(size_t pos, size_t len)const{
+		if (pos > size())
+			throw std::out_of_range("rope::substr");
+		if (len > size() - pos)
+			len = size() - pos;
+		return rope(Detail::subrange(root_, pos, pos + len));
+	}
+	//***************************
+	size_t rope::copy(char *buf, size_t len, size_t pos)const{
+		if (pos > size())
+			throw std::out_of_range("rope::copy");
+		if (len > size() - pos)
+			len = size() - pos;
+		if (len != 0)
+			Detail::copy_node(root_, pos, pos + len, buf);
+		return len;
+	}
+	void rope::flatten(char *buf)const{
+		if (!root_)
+			return;
+		unsigned threads = std::thread::hardware_concurrency();
+		if (root_->size_ < parallel_threshold || threads < 2){
+			Detail::copy_node(root_, 0, root_->size_, buf);
+			return;
+		}
+		//չɴԼ4 * threads̴߳Ӷȡ
+		std::vector<const Detail::rope_node *> parts(1, root_);
+		std::vector<size_t> offsets(1, 0);
+		while (parts.size() < 4 * threads){
+			std::vector<const Detail::rope_node *> next;
+			std::vector<size_t> nextOffsets;
+			for (size_t i = 0; i != parts.size(); ++i){
+				if (parts[i]->leaf_){
+					next.push_back(parts[i]);
+					nextOffsets.push_back(offsets[i]);
+					continue;
+				}
+				const Detail::rope_concat *c = static_cast<const Detail::rope_concat *>(parts[i]);
+				next.push_back(c->left_);
+				nextOffsets.push_back(offsets[i]);
+				next.push_back(c->right_);
+				nextOffsets.push_back(offsets[i] + c->left_->size_);
+			}
+			if (next.size() == parts.size())
+				break;
+			parts.swap(next);
+			offsets.swap(nextOffsets);
+		}
+		std::atomic<size_t> nextPart(0);
+		std::vector<std::thread> workers;
+		for (unsigned t = 0; t != threads; ++t){
+			workers.push_back(std::thread([&]{
+				for (size_t i; (i = nextPart.fetch_add(1)) < parts.size();)
+					Detail::copy_node(parts[i], 0, parts[i]->size_, buf + offsets[i]);
+			}));
+		}
+		for (size_t i = 0; i != workers.size(); ++i)
+			workers[i].join();
+	}
+	string rope::str()const{
+		string res(size(), '\0');
+		if (!res.empty())
+			flatten(&res[0]);
+		return res;
+	}
+	//[first, last)еĵһƥ䣬Ҷڲmemchr + memcmpҶӵĸƵСٱȽ
+	size_t rope::find_in_range(const char *s, size_t n, size_t first, size_t last)const{
+		struct visitor{
+			const rope *self;
+			const char *s;
+			size_t n, first, last, res;
+			std::vector<char> buf;
+
+			bool operator ()(const Detail::rope_leaf *l, size_t offset){
+				size_t end = offset + l->size_;
+				size_t lo = first > offset ? first : offset;
+				size_t inside = l->size_ >= n ? end - n + 1 : offset;//[offset, inside)ȫҶڵ
+				size_t hi = inside < last ? inside : last;
+				if (lo < hi){
+					size_t idx = Detail::str_find(l->data_, hi - offset + n - 1, s, n, lo - offset);
+					if (idx != size_t(-1)){
+						res = offset + idx;
+						return false;
+					}
+				}
+				size_t bfirst = lo > inside ? lo : inside;
+				size_t blast = end < last ? end : last;
+				if (bfirst < blast){
+					size_t len = self->copy(&buf[0], blast - bfirst + n - 1, bfirst);
+					size_t idx = Detail::str_find(&buf[0], len, s, n, 0);
+					if (idx != size_t(-1)){
+						res = bfirst + idx;
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+		visitor v = { this, s, n, first, last, npos, std::vector<char>(2 * n) };
+		Detail::visit_leaves(root_, 0, first, last + n - 1, v);
+		return v.res;
+	}
+	size_t rope::find(const char *s, size_t pos, size_t n)const{
+		size_t total = size();
+		if (n == 0)
+			return pos <= total ? pos : npos;
+		if (pos >= total || total - pos < n)
+			return npos;
+		size_t last = total - n + 1;
+		unsigned threads = std::thread::hardware_concurrency();
+		if (last - pos < parallel_threshold || threads < 2)
+			return find_in_range(s, n, pos, last);
+
+		std::vector<size_t> results(threads, npos);
+		std::vector<std::thread> workers;
+		size_t step = (last - pos + threads - 1) / threads;
+		for (unsigned t = 0; t != threads; ++t){
+			size_t first = pos + t * step;
+			if (first >= last)
+				break;
+			size_t segLast = last - first < step ? last : first + step;
+			workers.push_back(std::thread([=, &results]{
+				results[t] = find_in_range(s, n, first, segLast);
+			}));
+		}
+		for (size_t i = 0; i != workers.size(); ++i)
+			workers[i].join();
+		for (size_t i = 0; i != results.size(); ++i){
+			if (results[i] != npos)
+				return results[i];
+		}
+		return npos;
+	}
+	int rope::compare(const rope& r)const{
+		const size_t chunk = 1024;
+		char buf1[chunk], buf2[chunk];
+		size_t n1 = size(), n2 = r.size(), n = n1 < n2 ? n1 : n2;
+		for (size_t off = 0; off < n; off += chunk){
+			size_t k = n - off < chunk ? n - off : chunk;
+			Detail::copy_node(root_, off, off + k, buf1);
+			Detail::copy_node(r.root_, off, off + k, buf2);
+			int res = memcmp(buf1, buf2, k);
+			if (res != 0)
+				return res < 0 ? -1 : 1;
+		}
+		return n1 == n2 ? 0 : (n1 < n2 ? -1 : 1);
+	}
+
+	rope operator+ (const rope& lhs, const rope& rhs){
+		rope res(lhs);
+		res.append(rhs);
+		return res;
+	}
+	std::ostream& operator <<(std::ostream& os, const rope& r){
+		struct writer{
+			std::ostream *os;
+			bool operator ()(const Detail::rope_leaf *l, size_t){
+				os->write(l->data_, l->size_);
+				return true;
+			}
+		};
+		writer w = { &os };
+		if (r.root_)
+			Detail::visit_leaves(r.root_, 0, 0, r.size(), w);
+		return os;
+	}
+}
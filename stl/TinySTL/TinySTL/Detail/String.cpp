@@ -4,50 +4,102 @@
 
 namespace TinySTL{
 	const size_t string::npos;
+	const size_t string_view::npos;
 
+	//캯setShortȷresource֮initStorageٴӶȡ
 	string::string(size_t n, char c){
+		setShort(0, 0);
 		allocateAndFillN(n, c);
 	}
 	string::string(const char* s){
+		setShort(0, 0);
+		allocateAndCopy(s, s + strlen(s));
+	}
+	string::string(const char* s, const allocator_type& alloc){
+		setShort(0, toResource(alloc));
 		allocateAndCopy(s, s + strlen(s));
 	}
 	string::string(const char* s, size_t n){
+		setShort(0, 0);
+		allocateAndCopy(s, s + n);
+	}
+	string::string(const char* s, size_t n, const allocator_type& alloc){
+		setShort(0, toResource(alloc));
 		allocateAndCopy(s, s + n);
 	}
 	string::string(const string& str){
-		allocateAndCopy(str.start_, str.finish_);
+		//һʱԭresource
+		setShort(0, 0);
+		allocateAndCopy(str.begin(), str.end());
+	}
+	string::string(const string& str, const allocator_type& alloc){
+		setShort(0, toResource(alloc));
+		allocateAndCopy(str.begin(), str.end());
 	}
 	string::string(string&& str){
 		moveData(str);
 	}
+	string::string(string&& str, const allocator_type& alloc){
+		memory_resource *res = toResource(alloc);
+		if (res == str.resource()){
+			moveData(str);
+		}
+		else{
+			setShort(0, res);
+			allocateAndCopy(str.begin(), str.end());
+		}
+	}
 	string::string(const string& str, size_t pos, size_t len){
+		setShort(0, 0);
 		len = changeVarWhenEuqalNPOS(len, str.size(), pos);
-		allocateAndCopy(str.start_ + pos, str.start_ + pos + len);
+		allocateAndCopy(str.begin() + pos, str.begin() + pos + len);
+	}
+	string::string(string_view sv){
+		setShort(0, 0);
+		allocateAndCopy(sv.begin(), sv.end());
 	}
 	string::~string(){ 
 		destroyAndDeallocate(); 
 	}
 	string& string::operator= (const string& str){
 		if (this != &str){
-			destroyAndDeallocate();
-			allocateAndCopy(str.start_, str.finish_);
+			//㹻ʱֱӸǣ·
+			if (str.size() <= capacity()){
+				memcpy(data_start(), str.data_start(), str.size());
+				setSize(str.size());
+			}
+			else{
+				destroyAndDeallocate();
+				allocateAndCopy(str.begin(), str.end());
+			}
 		}
 		return *this;
 	}
 	string& string::operator= (string&& str){
 		if (this != &str){
+			//ڴԲͬresourceʱܽӹܣֻܸ
+			if (resource() != str.resource())
+				return *this = str;
+			destroyAndDeallocate();
 			moveData(str);
 		}
 		return *this;
 	}
 	string& string::operator= (const char* s){
-		destroyAndDeallocate();
-		allocateAndCopy(s, s + strlen(s));
+		size_t n = strlen(s);
+		if (n <= capacity()){
+			memmove(data_start(), s, n);
+			setSize(n);
+		}
+		else{
+			destroyAndDeallocate();
+			allocateAndCopy(s, s + n);
+		}
 		return *this;
 	}
 	string& string::operator= (char c){
-		destroyAndDeallocate();
-		allocateAndFillN(1, c);
+		*data_start() = c;
+		setSize(1);
 		return *this;
 	}
 	void string::resize(size_t n){
@@ -55,37 +107,32 @@ namespace TinySTL{
 	}
 	void string::resize(size_t n, char c){
 		if (n < size()){
-			dataAllocator::destroy(start_ + n, finish_);
-			finish_ = start_ + n;
+			setSize(n);
 		}
-		else if (n > size() && n <= capacity()){
-			auto lengthOfInsert = n - size();
-			finish_ = TinySTL::uninitialized_fill_n(finish_, lengthOfInsert, c);
-		}
-		else if (n > capacity()){
-			auto lengthOfInsert = n - size();
-			iterator newStart = dataAllocator::allocate(getNewCapacity(lengthOfInsert));
-			iterator newFinish = TinySTL::uninitialized_copy(begin(), end(), newStart);
-			newFinish = TinySTL::uninitialized_fill_n(newFinish, lengthOfInsert, c);
-
-			destroyAndDeallocate();
-			start_ = newStart;
-			finish_ = newFinish;
-			endOfStorage_ = start_ + n;
+		else if (n > size()){
+			if (n > capacity())
+				grow(n);
+			TinySTL::uninitialized_fill_n(end(), n - size(), c);
+			setSize(n);
 		}
 	}
 	void string::reserve(size_t n){
 		if (n <= capacity())
 			return;
-		iterator newStart = dataAllocator::allocate(n);
-		iterator newFinish = TinySTL::uninitialized_copy(begin(), end(), newStart);
-		destroyAndDeallocate();
-		start_ = newStart;
-		finish_ = newFinish;
-		endOfStorage_ = start_ + n;
+		grow(n);
+	}
+	void string::shrink_to_fit(){
+		if (!isLong() || l_.size_ == capacity())
+			return;
+		char *oldStart = l_.data_;
+		size_t n = l_.size_, oldCapacity = capacity();
+		memory_resource *res = resource();
+		TinySTL::uninitialized_copy(oldStart, oldStart + n, initStorage(n));
+		deallocateData(oldStart, oldCapacity, res);
+		setSize(n);
 	}
 	string& string::insert(size_t pos, const string& str){
-		insert(start_ + pos, str.begin(), str.end());
+		insert(begin() + pos, str.begin(), str.end());
 		return *this;
 	}
 	string& string::insert(size_t pos, const string& str, size_t subpos, size_t sublen){
@@ -102,17 +149,16 @@ namespace TinySTL{
 		return *this;
 	}
 	string::iterator string::insert_aux_filln(iterator p, size_t n, value_type c){
-		auto newCapacity = getNewCapacity(n);
-		iterator newStart = dataAllocator::allocate(newCapacity);
-		iterator newFinish = TinySTL::uninitialized_copy(start_, p, newStart);
+		auto newCapacity = (getNewCapacity(n) + 1) & ~size_t(1);
+		memory_resource *mr = resource();
+		iterator newStart = allocateData(newCapacity, mr);
+		iterator newFinish = TinySTL::uninitialized_copy(begin(), p, newStart);
 		newFinish = TinySTL::uninitialized_fill_n(newFinish, n, c);
 		auto res = newFinish;
-		newFinish = TinySTL::uninitialized_copy(p, finish_, newFinish);
+		newFinish = TinySTL::uninitialized_copy(p, end(), newFinish);
 
 		destroyAndDeallocate();
-		start_ = newStart;
-		finish_ = newFinish;
-		endOfStorage_ = start_ + newCapacity;
+		setLong(newStart, newFinish - newStart, newCapacity, mr);
 		return res;
 	}
 	string& string::insert(size_t pos, size_t n, char c){
@@ -122,11 +168,9 @@ namespace TinySTL{
 	string::iterator string::insert(iterator p, size_t n, char c){
 		auto lengthOfLeft = capacity() - size();
 		if (n <= lengthOfLeft){
-			for (iterator it = finish_ - 1; it >= p; --it){
-				*(it + n) = *(it);
-			}
+			memmove(p + n, p, end() - p);
 			TinySTL::uninitialized_fill_n(p, n, c);
-			finish_ += n;
+			setSize(size() + n);
 			return (p + n);
 		}
 		else{
@@ -145,7 +189,7 @@ namespace TinySTL{
 		return *this;
 	}
 	string& string::operator+= (char c){
-		insert(end(), c);
+		push_back(c);
 		return *this;
 	}
 	string& string::append(const string& str){
@@ -170,12 +214,9 @@ namespace TinySTL{
 		return *this;
 	}
 	string::iterator string::erase(iterator first, iterator last){
-		size_t lengthOfMove = finish_ - last;
-		for (auto i = 0; i != lengthOfMove; ++i){
-			*(first + i) = *(last + i);
-		}
-		dataAllocator::destroy(first + lengthOfMove, finish_);
-		finish_ = first + lengthOfMove;
+		size_t lengthOfMove = end() - last;
+		memmove(first, last, lengthOfMove);
+		setSize((first - begin()) + lengthOfMove);
 		return first;
 
 	}
@@ -220,32 +261,15 @@ namespace TinySTL{
 	string& string::replace(size_t pos, size_t len, size_t n, char c){
 		return replace(begin() + pos, begin() + pos + len, n, c);
 	}
-	size_t string::find_aux(const_iterator cit, size_t pos, size_t lengthOfS, size_t cond)const{
-		size_t i, j;
-		for (i = pos; i != cond; ++i){
-			for (j = 0; j != lengthOfS; ++j){
-				if (*(begin() + i + j) != cit[j])
-					break;
-			}
-			if (j == lengthOfS)
-				return i;
-		}
-		return npos;
-	}
 	size_t string::find(const char* s, size_t pos, size_t n) const{
-		size_t lenghtOfS = strlen(s);
-		//if (n < lenghtOfS)
-		//	return npos;
-		//return find_aux(s, pos, lenghtOfS, pos + n);
-		//bug fix
-		//2014.12.24
-		return find_aux(s, pos, n, size());
+		//memchrλַ + memcmpȽϣԭֽڱȽϵfind_aux
+		return Detail::str_find(data_start(), size(), s, n, pos);
 	}
 	size_t string::find(const string& str, size_t pos) const{
-		size_t lengthOfS = str.size();
-		if (size() - pos < lengthOfS)
-			return npos;
-		return find_aux(str.cbegin(), pos, lengthOfS, size());
+		return Detail::str_find(data_start(), size(), str.data_start(), str.size(), pos);
+	}
+	size_t string::find(string_view sv, size_t pos) const{
+		return Detail::str_find(data_start(), size(), sv.data(), sv.size(), pos);
 	}
 	size_t string::find(const char* s, size_t pos) const{
 		//return find(s, pos, size() - pos);
@@ -254,11 +278,7 @@ namespace TinySTL{
 		return find(s, pos, strlen(s));
 	}
 	size_t string::find(char c, size_t pos) const{
-		for (auto cit = cbegin() + pos; cit != cend(); ++cit){
-			if (*cit == c)
-				return cit - cbegin();
-		}
-		return npos;
+		return Detail::str_find_char(data_start(), size(), c, pos);
 	}
 	size_t string::rfind(char c, size_t pos) const{
 		pos = changeVarWhenEuqalNPOS(pos, size(), 1);
@@ -342,21 +362,19 @@ namespace TinySTL{
 		return find_first_of(s, pos, strlen(s));
 	}
 	size_t string::find_first_of(const char* s, size_t pos, size_t n) const{
-		//for (size_t i = pos; i != pos + n; ++i){
-		//	if (isContained((*this)[i], s, s + strlen(s)))
+		//for (size_t i = pos; i != size(); ++i){
+		//	if (isContained((*this)[i], s, s + n))
 		//		return i;
 		//}
-		//bug fix
-		//2014.12.25
-		for (size_t i = pos; i != size(); ++i){
-			if (isContained((*this)[i], s, s + n))
-				return i;
-		}
-		return npos;
+		//isContainedÿַҪһsΪ256λַ
+		return Detail::str_find_first_of(data_start(), size(), s, n, pos);
 	}
 	size_t string::find_first_of(char c, size_t pos) const{
 		return find(c, pos);
 	}
+	size_t string::find_first_of(string_view sv, size_t pos) const{
+		return Detail::str_find_first_of(data_start(), size(), sv.data(), sv.size(), pos);
+	}
 	size_t string::find_first_not_of(const string& str, size_t pos) const{
 		//return find_first_not_of(str.begin(), pos, size() - pos);
 		return find_first_not_of(str.begin(), pos, str.size());
@@ -370,11 +388,7 @@ namespace TinySTL{
 		if (!isContained((*this)[i], s, s + strlen(s)))
 		return i;
 		}*/
-		for (size_t i = pos; i != size(); ++i){
-			if (!isContained((*this)[i], s, s + n))
-				return i;
-		}
-		return npos;
+		return Detail::str_find_first_not_of(data_start(), size(), s, n, pos);
 	}
 	size_t string::find_first_not_of(char c, size_t pos) const{
 		for (size_t i = pos; i != size(); ++i){
@@ -502,16 +516,7 @@ namespace TinySTL{
 		return res += rhs;
 	}
 	bool operator== (const string& lhs, const string& rhs){
-		if (lhs.size() == rhs.size()){
-			for (auto cit1 = lhs.cbegin(), cit2 = rhs.cbegin();
-				cit1 != lhs.cend() && cit2 != rhs.cend();
-				++cit1, ++cit2){
-				if (*cit1 != *cit2)
-					return false;
-			}
-			return true;
-		}
-		return false;
+		return lhs.size() == rhs.size() && memcmp(lhs.data(), rhs.data(), lhs.size()) == 0;
 	}
 	bool operator== (const char*   lhs, const string& rhs){
 		return rhs == lhs;
@@ -613,29 +618,51 @@ namespace TinySTL{
 	}
 
 	void string::moveData(string& str){
-		start_ = str.start_;
-		finish_ = str.finish_;
-		endOfStorage_ = str.endOfStorage_;
-		str.start_ = str.finish_ = str.endOfStorage_ = 0;
+		//ߵĶԭresource
+		memory_resource *res = str.resource();
+		l_ = str.l_;
+		str.setShort(0, res);
+	}
+	char *string::initStorage(size_t n){
+		memory_resource *res = resource();
+		if (n <= (res ? size_t(kShortResourceCapacity) : size_t(kShortCapacity))){
+			setShort(0, res);
+			return s_.data_;
+		}
+		n = (n + 1) & ~size_t(1);//żλģʽı
+		char *p = allocateData(n, res);
+		setLong(p, 0, n, res);
+		return p;
+	}
+	void string::grow(size_t n){
+		size_t oldSize = size(), newCapacity = getNewCapacity(n - oldSize);
+		newCapacity = (newCapacity < n ? n : newCapacity);
+		newCapacity = (newCapacity + 1) & ~size_t(1);
+		memory_resource *res = resource();
+		char *newStart = allocateData(newCapacity, res);
+		TinySTL::uninitialized_copy(begin(), end(), newStart);
+		destroyAndDeallocate();
+		setLong(newStart, oldSize, newCapacity, res);
 	}
 	string::size_type string::getNewCapacity(size_type len)const{
-		size_type oldCapacity = endOfStorage_ - start_;
+		size_type oldCapacity = capacity();
 		auto res = TinySTL::max(oldCapacity, len);
 		//size_type newCapacity = (oldCapacity != 0 ? (oldCapacity + res) : 1);
 		auto newCapacity = oldCapacity + res;
 		return newCapacity;
 	}
 	void string::allocateAndFillN(size_t n, char c){
-		start_ = dataAllocator::allocate(n);
-		finish_ = TinySTL::uninitialized_fill_n(start_, n, c);
-		endOfStorage_ = finish_;
+		TinySTL::uninitialized_fill_n(initStorage(n), n, c);
+		setSize(n);
 	}
 	void string::string_aux(size_t n, char c, std::true_type){
 		allocateAndFillN(n, c);
 	}
 	void string::destroyAndDeallocate(){
-		dataAllocator::destroy(start_, finish_);
-		dataAllocator::deallocate(start_, endOfStorage_ - start_);
+		memory_resource *res = resource();
+		if (isLong())
+			deallocateData(l_.data_, capacity(), res);
+		setShort(0, res);
 	}
 	bool string::isContained(char ch, const_iterator first, const_iterator last)const{
 		for (auto cit = first; cit != last; ++cit){
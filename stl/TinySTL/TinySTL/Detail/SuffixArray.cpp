@@ -0,0 +1,54 @@
+#include "../SuffixArray.h"
+
+#include <cstring>
+
+namespace TinySTL{
+	namespace{
+		const char sa_magic[8] = { 'T', 'S', 'S', 'U', 'F', 'A', 'R', 'R' };
+		const unsigned int sa_version = 1;
+	}
+	namespace Detail{
+		void sa_init_header(sa_file_header& header, size_t indexSize, size_t size, bool withRank){
+			memcpy(header.magic_, sa_magic, sizeof(sa_magic));
+			header.version_ = sa_version;
+			header.indexSize_ = static_cast<unsigned int>(indexSize);
+			header.size_ = size;
+			header.flags_ = withRank ? sa_file_has_rank : 0;
+		}
+	}
+
+	mapped_suffix_array::mapped_suffix_array(const char *path)
+		:file_(path, "mapped_suffix_array"), header_(0), suffix_(0), height_(0), rank_(0){
+		const size_t bytes = file_.size();
+		//ļͷͳȣԽ
+		header_ = reinterpret_cast<const Detail::sa_file_header *>(file_.data());
+		bool ok = bytes >= sizeof(Detail::sa_file_header) &&
+			memcmp(header_->magic_, sa_magic, sizeof(sa_magic)) == 0 && header_->version_ == sa_version &&
+			(header_->indexSize_ == sizeof(int) || header_->indexSize_ == sizeof(long long));
+		if (ok){
+			unsigned long long n = header_->size_, w = header_->indexSize_;
+			unsigned long long count = n + (n == 0 ? 0 : n - 1) + ((header_->flags_ & Detail::sa_file_has_rank) ? n : 0);
+			ok = n <= (bytes - sizeof(Detail::sa_file_header)) / w &&
+				count * w == bytes - sizeof(Detail::sa_file_header);
+		}
+		if (!ok)
+			throw std::runtime_error("mapped_suffix_array: not a suffix array file");
+		size_t n = size_t(header_->size_);
+		suffix_ = file_.data() + sizeof(Detail::sa_file_header);
+		height_ = suffix_ + n * index_size();
+		if (header_->flags_ & Detail::sa_file_has_rank)
+			rank_ = height_ + (n == 0 ? 0 : n - 1) * index_size();
+	}
+	long long mapped_suffix_array::rank(size_t i)const{
+		if (!rank_)
+			throw std::logic_error("mapped_suffix_array: the file has no rank array");
+		return get(rank_, i);
+	}
+	const void *mapped_suffix_array::data(const char *arr, size_t indexSize)const{
+		if (indexSize != index_size())
+			throw std::logic_error("mapped_suffix_array: index size mismatch");
+		if (!arr)
+			throw std::logic_error("mapped_suffix_array: the file has no rank array");
+		return arr;
+	}
+}
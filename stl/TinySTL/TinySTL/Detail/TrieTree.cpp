@@ -1,12 +1,42 @@
 #include "../TrieTree.h"
 
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
 namespace TinySTL{
-	trie_tree::trie_tree() :root_(new trie_node), size_(0){}
+	trie_tree::trie_tree(const allocator_type& alloc)
+		:res_(alloc.resource()), root_(new_node("", 0, false)), size_(0){}
 	trie_tree::~trie_tree(){
-		if (root_){
-			root_->map_childs.clear();
-			delete root_;
+		delete_node(root_);
+	}
+	trie_tree::trie_node *trie_tree::new_node(const char *s, size_t n, bool is){
+		void *p = res_->allocate(sizeof(trie_node), std::alignment_of<trie_node>::value);
+		try{
+			return new(p) trie_node(s, n, is, res_);
+		}
+		catch (...){
+			res_->deallocate(p, sizeof(trie_node), std::alignment_of<trie_node>::value);
+			throw;
+		}
+	}
+	void trie_tree::delete_node(trie_node *node){
+		if (node->capacity == trie_node::direct){
+			for (size_t i = 0; i != trie_node::direct; ++i){
+				if (node->childs[i])
+					delete_node(node->childs[i]);
+			}
+			res_->deallocate(node->childs, trie_node::direct * sizeof(trie_node *), sizeof(trie_node *));
+		}else if (node->capacity != 0){
+			for (size_t i = 0; i != node->count; ++i)
+				delete_node(node->childs[i]);
+			res_->deallocate(node->keys, node->capacity, 1);
+			res_->deallocate(node->childs, node->capacity * sizeof(trie_node *), sizeof(trie_node *));
 		}
+		node->~trie_node();
+		res_->deallocate(node, sizeof(trie_node), std::alignment_of<trie_node>::value);
 	}
 	bool trie_tree::empty()const{
 		return size() == 0;
@@ -14,111 +44,425 @@ namespace TinySTL{
 	trie_tree::size_type trie_tree::size()const{
 		return size_;
 	}
+	trie_tree::trie_node **trie_tree::find_child(const trie_node *up, unsigned char ch){
+		if (up->capacity == trie_node::direct)
+			return up->childs[ch] ? &up->childs[ch] : 0;
+		for (size_t i = 0; i != up->count; ++i){
+			if (up->keys[i] == ch)
+				return &up->childs[i];
+			if (up->keys[i] > ch)
+				break;
+		}
+		return 0;
+	}
+	void trie_tree::add_child(trie_node *up, trie_node *child, unsigned char ch){
+		if (up->capacity == trie_node::direct){
+			up->childs[ch] = child;
+			++up->count;
+			return;
+		}
+		if (up->count == up->capacity){
+			//ARTһ416256
+			if (up->capacity == 16){
+				trie_node **table = static_cast<trie_node **>(res_->allocate(trie_node::direct * sizeof(trie_node *), sizeof(trie_node *)));
+				std::fill(table, table + trie_node::direct, static_cast<trie_node *>(0));
+				for (size_t i = 0; i != up->count; ++i)
+					table[up->keys[i]] = up->childs[i];
+				res_->deallocate(up->keys, up->capacity, 1);
+				res_->deallocate(up->childs, up->capacity * sizeof(trie_node *), sizeof(trie_node *));
+				up->keys = 0;
+				up->childs = table;
+				up->capacity = trie_node::direct;
+				up->childs[ch] = child;
+				++up->count;
+				return;
+			}
+			unsigned short capacity = up->capacity == 0 ? 4 : 16;
+			unsigned char *keys = static_cast<unsigned char *>(res_->allocate(capacity, 1));
+			trie_node **childs;
+			try{
+				childs = static_cast<trie_node **>(res_->allocate(capacity * sizeof(trie_node *), sizeof(trie_node *)));
+			}
+			catch (...){
+				res_->deallocate(keys, capacity, 1);
+				throw;
+			}
+			std::copy(up->keys, up->keys + up->count, keys);
+			std::copy(up->childs, up->childs + up->count, childs);
+			if (up->capacity != 0){
+				res_->deallocate(up->keys, up->capacity, 1);
+				res_->deallocate(up->childs, up->capacity * sizeof(trie_node *), sizeof(trie_node *));
+			}
+			up->keys = keys;
+			up->childs = childs;
+			up->capacity = capacity;
+		}
+		size_t pos = up->count;
+		for (; pos != 0 && up->keys[pos - 1] > ch; --pos){
+			up->keys[pos] = up->keys[pos - 1];
+			up->childs[pos] = up->childs[pos - 1];
+		}
+		up->keys[pos] = ch;
+		up->childs[pos] = child;
+		++up->count;
+	}
 	bool trie_tree::is_existed(const string& word)const{
 		if (word.empty())
 			return false;
-		auto root = get_root();
-		auto res = root->map_childs.find(word[0]);
-		if (res == root->map_childs.end())//not found
-			return false;
-		else
-			return _is_existed(word, res->second);
-	}
-	bool trie_tree::_is_existed(const string& word, const node_ptr& up)const{
-		if (word.size() == 1)
-			return up->is_a_word;
-		char ch = word[1];
-		auto res = up->map_childs.find(ch);
-		if (res == up->map_childs.end())//not found
-			return false;
-		else
-			return _is_existed(word.substr(1), res->second);
-	}
-	trie_tree::node_ptr trie_tree::make_node(char ch, bool is_a_word){
-		return std::make_unique<trie_node>(ch, is_a_word);
+		const trie_node *node = get_root();
+		size_t pos = 0;
+		while (pos != word.size()){
+			trie_node **child = find_child(node, word[pos]);
+			if (!child)
+				return false;
+			node = *child;
+			const string& label = node->label;
+			if (word.size() - pos < label.size() || memcmp(label.data(), word.data() + pos, label.size()) != 0)
+				return false;
+			pos += label.size();
+		}
+		return node->is_a_word;
 	}
 	bool trie_tree::insert(const string& word){
-		if (is_existed(word))
-			return true;
 		if (word.empty())
 			return false;
-		char ch = word[0];
-		auto root = get_root();
-		auto res = root->map_childs.find(ch);
-		if (res != root->map_childs.end()){
-			return _insert(word.substr(1), res->second);
-		}else{
-			auto is_a_word = (word.size() == 1 ? true : false);
-			auto node = make_node(ch, is_a_word);
-			root->map_childs[ch] = std::move(node);
-			return _insert(word.substr(1), root->map_childs[ch]);
+		trie_node *node = get_root();
+		size_t pos = 0;
+		while (pos != word.size()){
+			trie_node **child = find_child(node, word[pos]);
+			if (!child){
+				trie_node *leaf = new_node(word.data() + pos, word.size() - pos, true);
+				try{
+					add_child(node, leaf, word[pos]);
+				}
+				catch (...){
+					delete_node(leaf);
+					throw;
+				}
+				++size_;
+				return true;
+			}
+			const string& label = (*child)->label;
+			size_t n = 1, len = std::min(label.size(), word.size() - pos);
+			while (n != len && label[n] == word[pos + n])
+				++n;
+			if (n != label.size()){
+				//ڵnַԭĽֳ
+				trie_node *mid = new_node(label.data(), n, false);
+				trie_node *old = *child;
+				try{
+					add_child(mid, old, label[n]);
+				}
+				catch (...){
+					delete_node(mid);
+					throw;
+				}
+				old->label.erase(0, n);
+				*child = mid;
+			}
+			node = *child;
+			pos += n;
 		}
-	}
-	bool trie_tree::_insert(const string& word, const node_ptr& up){
-		if (word.empty()){
+		if (!node->is_a_word){
+			node->is_a_word = true;
 			++size_;
-			up->is_a_word = true;
-			return true;
 		}
-		char ch = word[0];
-		auto res = up->map_childs.find(ch);
-		if (res != up->map_childs.end()){
-			return _insert(word.substr(1), res->second);
-		}else{
-			auto is_a_word = (word.size() == 1 ? true : false);
-			auto node = make_node(ch, is_a_word);
-			up->map_childs[ch] = std::move(node);
-			return _insert(word.substr(1), up->map_childs[ch]);
+		return true;
+	}
+	const trie_tree::trie_node *trie_tree::find_prefix(string_view prefix, string& path)const{
+		const trie_node *node = get_root();
+		size_t pos = 0;
+		while (pos < prefix.size()){
+			trie_node **child = find_child(node, prefix[pos]);
+			if (!child)
+				return 0;
+			node = *child;
+			const string& label = node->label;
+			size_t n = std::min(label.size(), prefix.size() - pos);
+			if (memcmp(label.data(), prefix.data() + pos, n) != 0)
+				return 0;
+			pos += label.size();
 		}
+		//prefixͣĳм䣬ʣµַ
+		if (!prefix.empty())
+			path.append(prefix.data(), prefix.size());
+		if (pos > prefix.size())
+			path.append(node->label, node->label.size() - (pos - prefix.size()), pos - prefix.size());
+		return node;
 	}
 	void trie_tree::print_tree(std::ostream& os)const{
-		auto root = get_root();
-		if (root == NULL)
-			os << "the trie_tree is empty!" << std::endl;
-		for (auto cit = root->map_childs.cbegin(); cit != root->map_childs.cend(); ++cit)
-			_print_tree(os, cit->second, string());
-	}
-	void trie_tree::_print_tree(std::ostream& os, const node_ptr& up, string word)const{
-		word += up->data;
-		if (up->is_a_word)
+		for_each_word_by_prefix(string_view(), [&os](const string& word){
 			os << word << std::endl;
-		for (auto cit = up->map_childs.cbegin(); cit != up->map_childs.cend(); ++cit){
-			_print_tree(os, cit->second, word);
-		}
+		});
 	}
 	vector<string> trie_tree::get_word_by_prefix(const string& prefix)const{
 		vector<string> words;
-		auto root = get_root();
-		if (root == NULL || prefix.size() == 0)
+		if (prefix.size() == 0)
 			return words;
-		char ch = prefix[0];
-		auto res = root->map_childs.find(ch);
-		if (res != root->map_childs.end())
-			_get_word_by_prefix(prefix, res->second, prefix, words);
+		for_each_word_by_prefix(prefix, [&words](const string& word){
+			words.push_back(word);
+		});
 		return words;
 	}
-	void trie_tree::_get_word_by_prefix(const string& prefix, const node_ptr& up,
-		const string& real_prefix, vector<string>& words)const{
-		if (prefix.size() == 1){
-			if (up->is_a_word)
-				words.push_back(real_prefix);
-			for (auto cit = up->map_childs.cbegin(); cit != up->map_childs.cend(); ++cit){
-				__get_word_by_prefix(cit->second, string(), real_prefix, words);
+
+	namespace{
+		const char trie_magic[8] = { 'T', 'S', 'C', 'T', 'R', 'I', 'E', '\0' };
+		const unsigned int trie_version = 1;
+
+		//nΪ0ʱmemcmpյstring_viewdata()ǿָ
+		bool same(const char *a, const char *b, size_t n){
+			return n == 0 || memcmp(a, b, n) == 0;
+		}
+		size_t common_prefix(string_view a, string_view b, size_t from){
+			size_t len = std::min(a.size(), b.size());
+			while (from < len && a[from] == b[from])
+				++from;
+			return from;
+		}
+		Detail::trie_file_node make_node(size_t depth, size_t first, size_t last){
+			Detail::trie_file_node node;
+			node.depth_ = static_cast<unsigned int>(depth);
+			node.first_ = static_cast<unsigned int>(first);
+			node.last_ = static_cast<unsigned int>(last);
+			return node;
+		}
+		template<class T>
+		char *put(char *dest, const std::vector<T>& v){
+			if (!v.empty())
+				memcpy(dest, &v[0], v.size() * sizeof(T));
+			return dest + v.size() * sizeof(T);
+		}
+	}
+
+	compact_trie::compact_trie(){
+		build(std::vector<string_view>());
+	}
+	compact_trie::compact_trie(const trie_tree& tree){
+		//trie_treeı˳ǰ޷ֽڵֵ
+		std::vector<char> chars;
+		std::vector<size_t> offsets(1, 0);
+		tree.for_each_word_by_prefix(string_view(), [&](const string& word){
+			chars.insert(chars.end(), word.begin(), word.end());
+			offsets.push_back(chars.size());
+		});
+		std::vector<string_view> keys(offsets.size() - 1);
+		for (size_t i = 0; i != keys.size(); ++i)
+			keys[i] = string_view(chars.empty() ? "" : &chars[0] + offsets[i], offsets[i + 1] - offsets[i]);
+		build(keys);
+	}
+	compact_trie::compact_trie(const char *path)
+		:file_(new Detail::mapped_file(path, "compact_trie")){
+		const char *base = file_->data();
+		const size_t bytes = file_->size();
+		bool ok = bytes >= sizeof(Detail::trie_file_header);
+		if (ok){
+			const Detail::trie_file_header *header = reinterpret_cast<const Detail::trie_file_header *>(base);
+			unsigned long long keys = header->keyCount_, nodes = header->nodeCount_;
+			unsigned long long expect = sizeof(Detail::trie_file_header) + (keys + 1) * sizeof(unsigned int) +
+				nodes * sizeof(Detail::trie_file_node) + (nodes + 1) * sizeof(unsigned int) + nodes + header->poolSize_;
+			ok = memcmp(header->magic_, trie_magic, sizeof(trie_magic)) == 0 && header->version_ == trie_version &&
+				expect == bytes && (keys == 0) == (nodes == 0);
+		}
+		if (ok){
+			//еƫƣ𻵵ļᵼԽ
+			bind(base);
+			for (size_t i = 0; ok && i != header_->keyCount_; ++i)
+				ok = offsets_[i] <= offsets_[i + 1];
+			ok = ok && offsets_[0] == 0 && offsets_[header_->keyCount_] == header_->poolSize_ &&
+				childs_[header_->nodeCount_] == header_->nodeCount_;
+			for (size_t i = 0; ok && i != header_->nodeCount_; ++i){
+				const Detail::trie_file_node& node = nodes_[i];
+				ok = node.first_ < node.last_ && node.last_ <= header_->keyCount_ &&
+					node.depth_ <= key(node.first_).size() && childs_[i] <= childs_[i + 1] && childs_[i] > i;
+				for (size_t j = childs_[i]; ok && j != childs_[i + 1]; ++j){
+					const Detail::trie_file_node& c = nodes_[j];
+					ok = c.depth_ > node.depth_ && c.first_ >= node.first_ && c.last_ <= node.last_;
+				}
 			}
-		}else{
-			char ch = prefix[1];
-			auto res = up->map_childs.find(ch);
-			if (res != up->map_childs.end()){
-				_get_word_by_prefix(prefix.substr(1), res->second, real_prefix, words);
+		}
+		if (!ok)
+			throw std::runtime_error("compact_trie: not a compact_trie file");
+	}
+	compact_trie::compact_trie(compact_trie&& t){
+		build(std::vector<string_view>());
+		swap(t);
+	}
+	compact_trie& compact_trie::operator = (compact_trie&& t){
+		if (this != &t){
+			compact_trie temp(std::move(t));
+			swap(temp);
+		}
+		return *this;
+	}
+	void compact_trie::swap(compact_trie& t){
+		//vectorunique_ptrʱƶݣָȻЧ
+		blob_.swap(t.blob_);
+		file_.swap(t.file_);
+		std::swap(header_, t.header_);
+		std::swap(offsets_, t.offsets_);
+		std::swap(nodes_, t.nodes_);
+		std::swap(childs_, t.childs_);
+		std::swap(labels_, t.labels_);
+		std::swap(pool_, t.pool_);
+	}
+	void compact_trie::bind(const char *base){
+		header_ = reinterpret_cast<const Detail::trie_file_header *>(base);
+		base += sizeof(Detail::trie_file_header);
+		offsets_ = reinterpret_cast<const unsigned int *>(base);
+		base += (header_->keyCount_ + 1) * sizeof(unsigned int);
+		nodes_ = reinterpret_cast<const Detail::trie_file_node *>(base);
+		base += header_->nodeCount_ * sizeof(Detail::trie_file_node);
+		childs_ = reinterpret_cast<const unsigned int *>(base);
+		base += (header_->nodeCount_ + 1) * sizeof(unsigned int);
+		labels_ = reinterpret_cast<const unsigned char *>(base);
+		pool_ = base + header_->nodeCount_;
+	}
+	void compact_trie::build(const std::vector<string_view>& keys){
+		size_t total = 0;
+		for (size_t i = 0; i != keys.size(); ++i){
+			if (i != 0 && Detail::str_compare(keys[i - 1].data(), keys[i - 1].size(), keys[i].data(), keys[i].size()) >= 0)
+				throw std::invalid_argument("compact_trie: keys must be sorted and unique");
+			total += keys[i].size();
+		}
+		if (keys.size() >= UINT_MAX / 2 || total >= UINT_MAX)
+			throw std::length_error("compact_trie: too many keys");
+		//򽨽㣬ÿĺӶ
+		//һĴʵĹǰ׺ǵһһĹǰ׺
+		std::vector<Detail::trie_file_node> nodes;
+		std::vector<unsigned int> childs;
+		std::vector<unsigned char> labels;
+		if (!keys.empty()){
+			nodes.push_back(make_node(0, 0, keys.size()));
+			labels.push_back(0);
+		}
+		for (size_t i = 0; i != nodes.size(); ++i){
+			size_t first = nodes[i].first_, last = nodes[i].last_;
+			size_t depth = common_prefix(keys[first], keys[last - 1], nodes[i].depth_);
+			nodes[i].depth_ = static_cast<unsigned int>(depth);
+			childs.push_back(static_cast<unsigned int>(nodes.size()));
+			size_t k = first;
+			if (keys[k].size() == depth)
+				++k;
+			while (k != last){
+				char ch = keys[k][depth];
+				size_t j = k + 1;
+				while (j != last && keys[j][depth] == ch)
+					++j;
+				nodes.push_back(make_node(depth + 1, k, j));
+				labels.push_back(static_cast<unsigned char>(ch));
+				k = j;
 			}
 		}
+		childs.push_back(static_cast<unsigned int>(nodes.size()));
+
+		std::vector<unsigned int> offsets(1, 0);
+		for (size_t i = 0; i != keys.size(); ++i)
+			offsets.push_back(offsets.back() + static_cast<unsigned int>(keys[i].size()));
+		Detail::trie_file_header header;
+		memcpy(header.magic_, trie_magic, sizeof(trie_magic));
+		header.version_ = trie_version;
+		header.keyCount_ = static_cast<unsigned int>(keys.size());
+		header.nodeCount_ = static_cast<unsigned int>(nodes.size());
+		header.poolSize_ = static_cast<unsigned int>(total);
+
+		std::vector<char> blob(sizeof(header) + offsets.size() * sizeof(unsigned int) +
+			nodes.size() * sizeof(Detail::trie_file_node) + childs.size() * sizeof(unsigned int) + labels.size() + total);
+		char *dest = &blob[0];
+		memcpy(dest, &header, sizeof(header));
+		dest = put(dest + sizeof(header), offsets);
+		dest = put(dest, nodes);
+		dest = put(dest, childs);
+		dest = put(dest, labels);
+		for (size_t i = 0; i != keys.size(); ++i){
+			if (!keys[i].empty())
+				memcpy(dest, keys[i].data(), keys[i].size());
+			dest += keys[i].size();
+		}
+		blob_.swap(blob);
+		file_.reset();
+		bind(&blob_[0]);
+	}
+	unsigned int compact_trie::child(unsigned int node, unsigned char ch)const{
+		const unsigned char *first = labels_ + childs_[node], *last = labels_ + childs_[node + 1];
+		const unsigned char *it;
+		if (last - first <= 16){
+			for (it = first; it != last && *it < ch; ++it)
+				;
+		}else{
+			it = std::lower_bound(first, last, ch);
+		}
+		if (it == last || *it != ch)
+			return UINT_MAX;
+		return static_cast<unsigned int>(it - labels_);
+	}
+	compact_trie::size_type compact_trie::find(string_view word)const{
+		if (header_->nodeCount_ == 0)
+			return npos;
+		unsigned int i = 0;
+		size_t pos = 0;
+		for (;;){
+			const Detail::trie_file_node& node = nodes_[i];
+			if (word.size() < node.depth_)
+				return npos;
+			string_view path = key(node.first_);
+			if (!same(path.data() + pos, word.data() + pos, node.depth_ - pos))
+				return npos;
+			if (word.size() == node.depth_)
+				return path.size() == node.depth_ ? node.first_ : npos;
+			i = child(i, word[node.depth_]);
+			if (i == UINT_MAX)
+				return npos;
+			pos = node.depth_ + 1;
+		}
 	}
-	void trie_tree::__get_word_by_prefix(const node_ptr& up, string& word, const string& prefix, vector<string>& words)const{
-		word += up->data;
-		if (up->is_a_word)
-			words.push_back(prefix + word);
-		for (auto cit = up->map_childs.cbegin(); cit != up->map_childs.cend(); ++cit){
-			__get_word_by_prefix(cit->second, string(word), prefix, words);
+	compact_trie::prefix_range compact_trie::prefix(string_view prefix)const{
+		if (header_->nodeCount_ == 0)
+			return prefix_range(end(), end());
+		unsigned int i = 0;
+		size_t pos = 0;
+		for (;;){
+			const Detail::trie_file_node& node = nodes_[i];
+			string_view path = key(node.first_);
+			size_t len = std::min<size_t>(node.depth_, prefix.size());
+			if (!same(path.data() + pos, prefix.data() + pos, len - pos))
+				return prefix_range(end(), end());
+			if (prefix.size() <= node.depth_)
+				return prefix_range(const_iterator(this, node.first_), const_iterator(this, node.last_));
+			i = child(i, prefix[node.depth_]);
+			if (i == UINT_MAX)
+				return prefix_range(end(), end());
+			pos = node.depth_ + 1;
 		}
 	}
-}
\ No newline at end of file
+	compact_trie::size_type compact_trie::longest_prefix(string_view word)const{
+		size_type res = npos;
+		if (header_->nodeCount_ == 0)
+			return res;
+		unsigned int i = 0;
+		size_t pos = 0;
+		for (;;){
+			const Detail::trie_file_node& node = nodes_[i];
+			string_view path = key(node.first_);
+			if (word.size() < node.depth_ || !same(path.data() + pos, word.data() + pos, node.depth_ - pos))
+				return res;
+			if (path.size() == node.depth_)
+				res = node.first_;
+			if (word.size() == node.depth_)
+				return res;
+			i = child(i, word[node.depth_]);
+			if (i == UINT_MAX)
+				return res;
+			pos = node.depth_ + 1;
+		}
+	}
+	void compact_trie::save(const char *path)const{
+		std::FILE *fp = std::fopen(path, "wb");
+		if (!fp)
+			throw std::runtime_error("compact_trie::save: cannot open the file");
+		const char *base = reinterpret_cast<const char *>(header_);
+		bool ok = std::fwrite(base, 1, bytes(), fp) == bytes();
+		ok = (std::fclose(fp) == 0) && ok;
+		if (!ok)
+			throw std::runtime_error("compact_trie::save: write failed");
+	}
+}
@@ -0,0 +1,93 @@
+#include "../UFSet.h"
+
+namespace TinySTL{
+	//******************************dynamic_uf_set*****************************
+	dynamic_uf_set::dynamic_uf_set(size_t n) :parent_(n), rank_(n, 0), sets_(n){
+		for (size_t i = 0; i != n; ++i)
+			parent_[i] = index_type(i);
+	}
+	dynamic_uf_set::index_type dynamic_uf_set::Find(index_type index){
+		index_type *parent = parent_.data();
+		while (parent[index] != index){
+			parent[index] = parent[parent[index]];
+			index = parent[index];
+		}
+		return index;
+	}
+	bool dynamic_uf_set::Union(index_type index1, index_type index2){
+		auto root1 = Find(index1), root2 = Find(index2);
+		if (root1 == root2)
+			return false;
+		if (rank_[root1] < rank_[root2]){
+			parent_[root1] = root2;
+		}else{
+			parent_[root2] = root1;
+			if (rank_[root1] == rank_[root2])
+				++rank_[root1];
+		}
+		--sets_;
+		return true;
+	}
+	void dynamic_uf_set::Clear(){
+		for (size_t i = 0; i != parent_.size(); ++i)
+			parent_[i] = index_type(i);
+		memset(rank_.data(), 0, rank_.size());
+		sets_ = parent_.size();
+	}
+
+	//******************************concurrent_uf_set*****************************
+	concurrent_uf_set::concurrent_uf_set(size_t n) :parent_(new std::atomic<index_type>[n]), size_(n){
+		Clear();
+	}
+	size_t concurrent_uf_set::Count()const{
+		size_t count = 0;
+		for (size_t i = 0; i != size_; ++i){
+			if (parent_[i].load(std::memory_order_relaxed) == i)
+				++count;
+		}
+		return count;
+	}
+	//parentֻȷƶֵ߼Զ·붼ֻrelaxed
+	concurrent_uf_set::index_type concurrent_uf_set::Find(index_type index){
+		for (;;){
+			index_type parent = parent_[index].load(std::memory_order_relaxed);
+			if (parent == index)
+				return index;
+			index_type grand = parent_[parent].load(std::memory_order_relaxed);
+			if (parent != grand)
+				parent_[index].compare_exchange_weak(parent, grand, std::memory_order_relaxed);
+			index = grand;
+		}
+	}
+	bool concurrent_uf_set::Union(index_type index1, index_type index2){
+		for (;;){
+			auto root1 = Find(index1), root2 = Find(index2);
+			if (root1 == root2)
+				return false;
+			if (priority(root1) < priority(root2))
+				std::swap(root1, root2);
+			//ȼ͵root2ҵroot1£root2ѾǸʱʧ
+			index_type expected = root2;
+			if (parent_[root2].compare_exchange_strong(expected, root1, std::memory_order_acq_rel))
+				return true;
+			index1 = root1;
+			index2 = root2;
+		}
+	}
+	bool concurrent_uf_set::Connected(index_type index1, index_type index2){
+		for (;;){
+			auto root1 = Find(index1), root2 = Find(index2);
+			if (root1 == root2)
+				return true;
+			//root1ȻǸ˵Find֮ûбϲȷʵͨ
+			if (parent_[root1].load(std::memory_order_acquire) == root1)
+				return false;
+			index1 = root1;
+			index2 = root2;
+		}
+	}
+	void concurrent_uf_set::Clear(){
+		for (size_t i = 0; i != size_; ++i)
+			parent_[i].store(index_type(i), std::memory_order_relaxed);
+	}
+}
@@ -92,7 +92,7 @@ namespace TinySTL{
 	template<class Key, class Hash, class KeyEqual, class Allocator>
 	typename Unordered_set<Key, Hash, KeyEqual, Allocator>::allocator_type 
 		Unordered_set<Key, Hash, KeyEqual, Allocator>::get_allocator()const{
-		return allocator_type();
+		return allocator_type(buckets_.get_allocator());
 	}
 	template<class Key, class Hash, class KeyEqual, class Allocator>
 	size_t Unordered_set<Key, Hash, KeyEqual, Allocator>::prime_list_[PRIME_LIST_SIZE] = {
@@ -125,8 +125,14 @@ namespace TinySTL{
 		return prime_list_[i];
 	}
 	template<class Key, class Hash, class KeyEqual, class Allocator>
-	Unordered_set<Key, Hash, KeyEqual, Allocator>::Unordered_set(const Unordered_set& ust){
-		buckets_ = ust.buckets_;
+	Unordered_set<Key, Hash, KeyEqual, Allocator>::Unordered_set(const Unordered_set& ust)
+		:buckets_(ust.buckets_){
+		size_ = ust.size_;
+		max_load_factor_ = ust.max_load_factor_;
+	}
+	template<class Key, class Hash, class KeyEqual, class Allocator>
+	Unordered_set<Key, Hash, KeyEqual, Allocator>::Unordered_set(const Unordered_set& ust, const Allocator& alloc)
+		:buckets_(ust.buckets_, bucketAllocator(alloc)){
 		size_ = ust.size_;
 		max_load_factor_ = ust.max_load_factor_;
 	}
@@ -137,21 +143,25 @@ namespace TinySTL{
 			size_ = ust.size_;
 			max_load_factor_ = ust.max_load_factor_;
 		}
+		return *this;
 	}
 	template<class Key, class Hash, class KeyEqual, class Allocator>
-	Unordered_set<Key, Hash, KeyEqual, Allocator>::Unordered_set(size_type bucket_count){
+	Unordered_set<Key, Hash, KeyEqual, Allocator>::Unordered_set(size_type bucket_count, const Allocator& alloc = Allocator())
+		:buckets_(bucketAllocator(alloc)){
+		//resizeĳֵҲalloc죬ʱĿͰĬϵķڱڵ
 		bucket_count = next_prime(bucket_count);
-		buckets_.resize(bucket_count);
+		buckets_.resize(bucket_count, bucket_type(alloc));
 		size_ = 0;
 		max_load_factor_ = 1.0;
 	}
 	template<class Key, class Hash, class KeyEqual, class Allocator>
 	template<class InputIterator>
-	Unordered_set<Key, Hash, KeyEqual, Allocator>::Unordered_set(InputIterator first, InputIterator last){
+	Unordered_set<Key, Hash, KeyEqual, Allocator>::Unordered_set(InputIterator first, InputIterator last, const Allocator& alloc = Allocator())
+		:buckets_(bucketAllocator(alloc)){
 		size_ = 0;
 		max_load_factor_ = 1.0;
 		auto len = last - first;
-		buckets_.resize(next_prime(len));
+		buckets_.resize(next_prime(len), bucket_type(alloc));
 		for (; first != last; ++first){
 			auto index = bucket_index(*first);
 			if (!has_key(*first)){
@@ -255,7 +265,7 @@ namespace TinySTL{
 	void Unordered_set<Key, Hash, KeyEqual, Allocator>::rehash(size_type n){
 		if (n <= buckets_.size())
 			return;
-		Unordered_set temp(next_prime(n));
+		Unordered_set temp(next_prime(n), get_allocator());
 		for (auto& val : *this){
 			temp.insert(val);
 		}
@@ -12,29 +12,49 @@ namespace TinySTL{
 		allocateAndFillN(n, value_type());
 	}
 	template<class T, class Alloc>
-	vector<T, Alloc>::vector(const size_type n, const value_type& value){
+	vector<T, Alloc>::vector(const size_type n, const value_type& value, const Alloc& alloc)
+		:alloc_(alloc){
 		allocateAndFillN(n, value);
 	}
 	template<class T, class Alloc>
 	template<class InputIterator>
-	vector<T, Alloc>::vector(InputIterator first, InputIterator last){
+	vector<T, Alloc>::vector(InputIterator first, InputIterator last, const Alloc& alloc)
+		:alloc_(alloc){
 		//ָּĺ
 		vector_aux(first, last, typename std::is_integral<InputIterator>::type());
 	}
 	template<class T, class Alloc>
-	vector<T, Alloc>::vector(const vector& v){
+	vector<T, Alloc>::vector(const vector& v)
+		:alloc_(v.alloc_.select_on_container_copy_construction()){
 		allocateAndCopy(v.start_, v.finish_);
 	}
 	template<class T, class Alloc>
-	vector<T, Alloc>::vector(vector&& v){
-		start_ = v.start_;
-		finish_ = v.finish_;
-		endOfStorage_ = v.endOfStorage_;
-		v.start_ = v.finish_ = v.endOfStorage_ = 0;
+	vector<T, Alloc>::vector(const vector& v, const Alloc& alloc)
+		:alloc_(alloc){
+		allocateAndCopy(v.start_, v.finish_);
+	}
+	template<class T, class Alloc>
+	vector<T, Alloc>::vector(vector&& v)
+		:alloc_(v.alloc_){
+		start_ = finish_ = endOfStorage_ = 0;
+		stealFrom(v);
+	}
+	template<class T, class Alloc>
+	vector<T, Alloc>::vector(vector&& v, const Alloc& alloc)
+		:alloc_(alloc){
+		//ͬʱܽӹܶԷڴ棬ֻ
+		if (alloc_ == v.alloc_){
+			start_ = finish_ = endOfStorage_ = 0;
+			stealFrom(v);
+		}
+		else{
+			allocateAndCopy(v.start_, v.finish_);
+		}
 	}
 	template<class T, class Alloc>
 	vector<T, Alloc>& vector<T, Alloc>::operator = (const vector& v){
 		if (this != &v){
+			destroyAndDeallocateAll();
 			allocateAndCopy(v.start_, v.finish_);
 		}
 		return *this;
@@ -43,10 +63,13 @@ namespace TinySTL{
 	vector<T, Alloc>& vector<T, Alloc>::operator = (vector&& v){
 		if (this != &v){
 			destroyAndDeallocateAll();
-			start_ = v.start_;
-			finish_ = v.finish_;
-			endOfStorage_ = v.endOfStorage_;
-			v.start_ = v.finish_ = v.endOfStorage_ = 0;
+			if (alloc_ == v.alloc_){
+				start_ = finish_ = endOfStorage_ = 0;
+				stealFrom(v);
+			}
+			else{
+				allocateAndCopy(v.start_, v.finish_);
+			}
 		}
 		return *this;
 	}
@@ -54,36 +77,24 @@ namespace TinySTL{
 	template<class T, class Alloc>
 	void vector<T, Alloc>::resize(size_type n, value_type val = value_type()){
 		if (n < size()){
-			dataAllocator::destroy(start_ + n, finish_);
+			alloc_.destroy(start_ + n, finish_);
 			finish_ = start_ + n;
 		}
 		else if (n > size() && n <= capacity()){
 			auto lengthOfInsert = n - size();
-			finish_ = TinySTL::uninitialized_fill_n(finish_, lengthOfInsert, val);
+			finish_ = TinySTL::uninitialized_fill_n_a(finish_, lengthOfInsert, val, alloc_);
 		}
 		else if (n > capacity()){
 			auto lengthOfInsert = n - size();
-			T *newStart = dataAllocator::allocate(getNewCapacity(lengthOfInsert));
-			T *newFinish = TinySTL::uninitialized_copy(begin(), end(), newStart);
-			newFinish = TinySTL::uninitialized_fill_n(newFinish, lengthOfInsert, val);
-
-			destroyAndDeallocateAll();
-			start_ = newStart;
-			finish_ = newFinish;
-			endOfStorage_ = start_ + n;
+			reallocateStorage(TinySTL::max(n, getNewCapacity(lengthOfInsert)));
+			finish_ = TinySTL::uninitialized_fill_n_a(finish_, lengthOfInsert, val, alloc_);
 		}
 	}
 	template<class T, class Alloc>
 	void vector<T, Alloc>::reserve(size_type n){
 		if (n <= capacity())
 			return;
-		T *newStart = dataAllocator::allocate(n);
-		T *newFinish = TinySTL::uninitialized_copy(begin(), end(), newStart);
-		destroyAndDeallocateAll();
-
-		start_ = newStart;
-		finish_ = newFinish;
-		endOfStorage_ = start_ + n;
+		reallocateStorage(n);
 	}
 	//***************޸ز**************************
 	template<class T, class Alloc>
@@ -92,15 +103,10 @@ namespace TinySTL{
 	}
 	template<class T, class Alloc>
 	typename vector<T, Alloc>::iterator vector<T, Alloc>::erase(iterator first, iterator last){
-		//β
-		difference_type lenOfTail = end() - last;
-		//ɾȥĶĿ
-		difference_type lenOfRemoved = last - first;
-		finish_ = finish_ - lenOfRemoved;
-		for (; lenOfTail != 0; --lenOfTail){
-			auto temp = (last - lenOfRemoved);
-			*temp = *(last++);
-		}
+		//βĶǰƣճλϵĶҪ
+		iterator newFinish = std::move(last, finish_, first);
+		alloc_.destroy(newFinish, finish_);
+		finish_ = newFinish;
 		return (first);
 	}
 	template<class T, class Alloc>
@@ -108,13 +114,23 @@ namespace TinySTL{
 	void vector<T, Alloc>::reallocateAndCopy(iterator position, InputIterator first, InputIterator last){
 		difference_type newCapacity = getNewCapacity(last - first);
 
-		T *newStart = dataAllocator::allocate(newCapacity);
+		//ȹԪأfirstlastָеԪأʱɵԪػûб
+		T *newStart = alloc_.allocate(newCapacity);
 		T *newEndOfStorage = newStart + newCapacity;
-		T *newFinish = TinySTL::uninitialized_copy(begin(), position, newStart);
-		newFinish = TinySTL::uninitialized_copy(first, last, newFinish);
-		newFinish = TinySTL::uninitialized_copy(position, end(), newFinish);
+		T *newPosition = newStart + (position - start_);
+		T *newFinish = newPosition;
+		try{
+			newFinish = TinySTL::uninitialized_copy_a(first, last, newPosition, alloc_);
+			newFinish = TinySTL::uninitialized_relocate_split_a(start_, position, finish_, newStart, newFinish, alloc_);
+		}
+		catch (...){
+			//ԪѾʱnewFinishָǵβ󣬾ɵԪػԭ
+			alloc_.destroy(newPosition, newFinish);
+			alloc_.deallocate(newStart, newCapacity);
+			throw;
+		}
 
-		destroyAndDeallocateAll();
+		deallocateAll();
 		start_ = newStart;
 		finish_ = newFinish;
 		endOfStorage_ = newEndOfStorage;
@@ -123,18 +139,55 @@ namespace TinySTL{
 	void vector<T, Alloc>::reallocateAndFillN(iterator position, const size_type& n, const value_type& val){
 		difference_type newCapacity = getNewCapacity(n);
 
-		T *newStart = dataAllocator::allocate(newCapacity);
+		//valǱеԪأٰᶯɵԪ
+		T *newStart = alloc_.allocate(newCapacity);
 		T *newEndOfStorage = newStart + newCapacity;
-		T *newFinish = TinySTL::uninitialized_copy(begin(), position, newStart);
-		newFinish = TinySTL::uninitialized_fill_n(newFinish, n, val);
-		newFinish = TinySTL::uninitialized_copy(position, end(), newFinish);
+		T *newPosition = newStart + (position - start_);
+		T *newFinish = newPosition;
+		try{
+			newFinish = TinySTL::uninitialized_fill_n_a(newPosition, n, val, alloc_);
+			newFinish = TinySTL::uninitialized_relocate_split_a(start_, position, finish_, newStart, newFinish, alloc_);
+		}
+		catch (...){
+			alloc_.destroy(newPosition, newFinish);
+			alloc_.deallocate(newStart, newCapacity);
+			throw;
+		}
 
-		destroyAndDeallocateAll();
+		deallocateAll();
 		start_ = newStart;
 		finish_ = newFinish;
 		endOfStorage_ = newEndOfStorage;
 	}
 	template<class T, class Alloc>
+	void vector<T, Alloc>::reallocateStorage(size_type newCapacity){
+		reallocateStorage_aux(newCapacity, useReallocate());
+	}
+	template<class T, class Alloc>
+	void vector<T, Alloc>::reallocateStorage_aux(size_type newCapacity, std::true_type){
+		//ڴ潻reallocпʱԭչmemcpyʡ
+		const size_type oldSize = size();
+		start_ = alloc_.reallocate(start_, capacity(), newCapacity);
+		finish_ = start_ + oldSize;
+		endOfStorage_ = start_ + newCapacity;
+	}
+	template<class T, class Alloc>
+	void vector<T, Alloc>::reallocateStorage_aux(size_type newCapacity, std::false_type){
+		T *newStart = alloc_.allocate(newCapacity);
+		T *newFinish = newStart;
+		try{
+			newFinish = TinySTL::uninitialized_relocate_a(start_, finish_, newStart, alloc_);
+		}
+		catch (...){
+			alloc_.deallocate(newStart, newCapacity);
+			throw;
+		}
+		deallocateAll();
+		start_ = newStart;
+		finish_ = newFinish;
+		endOfStorage_ = start_ + newCapacity;
+	}
+	template<class T, class Alloc>
 	template<class InputIterator>
 	void vector<T, Alloc>::insert_aux(iterator position,
 		InputIterator first,
@@ -145,13 +198,13 @@ namespace TinySTL{
 
 		if (locationLeft >= locationNeed){
 			if (finish_ - position > locationNeed){
-				TinySTL::uninitialized_copy(finish_ - locationNeed, finish_, finish_);
-				std::copy_backward(position, finish_ - locationNeed, finish_);
+				TinySTL::uninitialized_move_a(finish_ - locationNeed, finish_, finish_, alloc_);
+				std::move_backward(position, finish_ - locationNeed, finish_);
 				std::copy(first, last, position);
 			}
 			else{
-				iterator temp = TinySTL::uninitialized_copy(first + (finish_ - position), last, finish_);
-				TinySTL::uninitialized_copy(position, finish_, temp);
+				iterator temp = TinySTL::uninitialized_copy_a(first + (finish_ - position), last, finish_, alloc_);
+				TinySTL::uninitialized_move_a(position, finish_, temp, alloc_);
 				std::copy(first, first + (finish_ - position), position);
 			}
 			finish_ += locationNeed;
@@ -168,13 +221,21 @@ namespace TinySTL{
 		difference_type locationNeed = n;
 
 		if (locationLeft >= locationNeed){
-			auto tempPtr = end() - 1;
-			for (; tempPtr - position >= 0; --tempPtr){//move the [position, finish_) back
-				//*(tempPtr + locationNeed) = *tempPtr;//bug
-				construct(tempPtr + locationNeed, *tempPtr);
+			//valueǱеԪأƶ֮Ͳԭֵ
+			value_type copy(value);
+			difference_type elemsAfter = finish_ - position;
+			iterator oldFinish = finish_;
+			if (elemsAfter > locationNeed){
+				//βnԪƵδʼڴϣѹԪƶ
+				finish_ = TinySTL::uninitialized_move_a(finish_ - locationNeed, finish_, finish_, alloc_);
+				std::move_backward(position, oldFinish - locationNeed, oldFinish);
+				std::fill(position, position + locationNeed, copy);
+			}
+			else{
+				finish_ = TinySTL::uninitialized_fill_n_a(finish_, locationNeed - elemsAfter, copy, alloc_);
+				finish_ = TinySTL::uninitialized_move_a(position, oldFinish, finish_, alloc_);
+				std::fill(position, oldFinish, copy);
 			}
-			TinySTL::uninitialized_fill_n(position, n, value);
-			finish_ += locationNeed;
 		}
 		else{
 			reallocateAndFillN(position, n, value);
@@ -197,7 +258,58 @@ namespace TinySTL{
 	}
 	template<class T, class Alloc>
 	void vector<T, Alloc>::push_back(const value_type& value){
-		insert(end(), value);
+		emplace_back(value);
+	}
+	template<class T, class Alloc>
+	void vector<T, Alloc>::push_back(value_type&& value){
+		emplace_back(std::move(value));
+	}
+	template<class T, class Alloc>
+	template<class... Args>
+	void vector<T, Alloc>::emplace_back(Args&&... args){
+		if (finish_ != endOfStorage_){
+			alloc_.construct(finish_, std::forward<Args>(args)...);
+			++finish_;
+		}
+		else{
+			emplace_back_aux(useReallocate(), std::forward<Args>(args)...);
+		}
+	}
+	template<class T, class Alloc>
+	template<class... Args>
+	void vector<T, Alloc>::emplace_back_aux(std::true_type, Args&&... args){
+		//argsñеԪأrealloc֮ʧЧˣȹ
+		value_type value(std::forward<Args>(args)...);
+		reallocateStorage(getNewCapacity(1));
+		alloc_.construct(finish_, std::move(value));
+		++finish_;
+	}
+	template<class T, class Alloc>
+	template<class... Args>
+	void vector<T, Alloc>::emplace_back_aux(std::false_type, Args&&... args){
+		//ڴϹԪأٰѾɵԪذȥ
+		const size_type newCapacity = getNewCapacity(1);
+		T *newStart = alloc_.allocate(newCapacity);
+		T *newFinish = newStart + size();
+		try{
+			alloc_.construct(newFinish, std::forward<Args>(args)...);
+		}
+		catch (...){
+			alloc_.deallocate(newStart, newCapacity);
+			throw;
+		}
+		try{
+			TinySTL::uninitialized_relocate_a(start_, finish_, newStart, alloc_);
+		}
+		catch (...){
+			alloc_.destroy(newFinish);
+			alloc_.deallocate(newStart, newCapacity);
+			throw;
+		}
+		deallocateAll();
+		start_ = newStart;
+		finish_ = newFinish + 1;
+		endOfStorage_ = newStart + newCapacity;
 	}
 	//***********߼Ƚϲ*******************
 	template<class T, class Alloc>
@@ -232,15 +344,18 @@ namespace TinySTL{
 	void vector<T, Alloc>::shrink_to_fit(){
 		//dataAllocator::deallocate(finish_, endOfStorage_ - finish_);
 		//endOfStorage_ = finish_;
-		T* t = (T*)dataAllocator::allocate(size());
-		finish_ = TinySTL::uninitialized_copy(start_, finish_, t);
-		dataAllocator::deallocate(start_, capacity());
-		start_ = t;
-		endOfStorage_ = finish_;
+		if (finish_ == endOfStorage_)
+			return;
+		if (empty()){
+			deallocateAll();
+			start_ = finish_ = endOfStorage_ = 0;
+			return;
+		}
+		reallocateStorage(size());
 	}
 	template<class T, class Alloc>
 	void vector<T, Alloc>::clear(){
-		dataAllocator::destroy(start_, finish_);
+		alloc_.destroy(start_, finish_);
 		finish_ = start_;
 	}
 	template<class T, class Alloc>
@@ -249,31 +364,44 @@ namespace TinySTL{
 			TinySTL::swap(start_, v.start_);
 			TinySTL::swap(finish_, v.finish_);
 			TinySTL::swap(endOfStorage_, v.endOfStorage_);
+			TinySTL::swap(alloc_, v.alloc_);
 		}
 	}
 	template<class T, class Alloc>
 	void vector<T, Alloc>::pop_back(){
 		--finish_;
-		dataAllocator::destroy(finish_);
+		alloc_.destroy(finish_);
 	}
 	template<class T, class Alloc>
 	void vector<T, Alloc>::destroyAndDeallocateAll(){
 		if (capacity() != 0){
-			dataAllocator::destroy(start_, finish_);
-			dataAllocator::deallocate(start_, capacity());
+			alloc_.destroy(start_, finish_);
+			alloc_.deallocate(start_, capacity());
 		}
 	}
+	//ֻͷڴ棬ԪѾ߻
+	template<class T, class Alloc>
+	void vector<T, Alloc>::deallocateAll(){
+		if (capacity() != 0)
+			alloc_.deallocate(start_, capacity());
+	}
+	template<class T, class Alloc>
+	void vector<T, Alloc>::stealFrom(vector& v){
+		TinySTL::swap(start_, v.start_);
+		TinySTL::swap(finish_, v.finish_);
+		TinySTL::swap(endOfStorage_, v.endOfStorage_);
+	}
 	template<class T, class Alloc>
 	void vector<T, Alloc>::allocateAndFillN(const size_type n, const value_type& value){
-		start_ = dataAllocator::allocate(n);
-		TinySTL::uninitialized_fill_n(start_, n, value);
+		start_ = alloc_.allocate(n);
+		TinySTL::uninitialized_fill_n_a(start_, n, value, alloc_);
 		finish_ = endOfStorage_ = start_ + n;
 	}
 	template<class T, class Alloc>
 	template<class InputIterator>
 	void vector<T, Alloc>::allocateAndCopy(InputIterator first, InputIterator last){
-		start_ = dataAllocator::allocate(last - first);
-		finish_ = TinySTL::uninitialized_copy(first, last, start_);
+		start_ = alloc_.allocate(last - first);
+		finish_ = TinySTL::uninitialized_copy_a(first, last, start_, alloc_);
 		endOfStorage_ = finish_;
 	}
 	template<class T, class Alloc>
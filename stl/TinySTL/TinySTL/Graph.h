@@ -3,40 +3,70 @@
 
 #include "Iterator.h"
 #include "List.h"
+#include "MemoryResource.h"
 #include "String.h"
 #include "Unordered_set.h"
 #include "Utility.h"
 #include "Vector.h"
 
+#include <atomic>
 #include <functional>
 #include <iomanip>
+#include <memory>
 #include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace TinySTL{
+	template<class Index, class Value, class EqualFunc>
+	class csr_graph;
+
 	namespace Detail{
 		template<class Index, class Value, class EqualFunc>
 		class inner_iterator;
 		template<class Index, class Value, class EqualFunc>
 		class outter_iterator;
 
+		//ڽӱеһĳ
+		//allocator_typeʱѷߵͶͬһresource
+		template<class Node>
+		struct graph_entry{
+			typedef polymorphic_allocator<Node> allocator_type;
+			Node first;
+			list<Node, allocator_type> second;
+			explicit graph_entry(const allocator_type& alloc) :first(), second(alloc){}
+			graph_entry(const Node& n, const allocator_type& alloc) :first(n), second(alloc){}
+			graph_entry(const graph_entry& e, const allocator_type& alloc) :first(e.first), second(e.second, alloc){}
+		};
+
 		template<class Index, class Value, class EqualFunc = equal_to<Index>>
 		class graph{//base class
 		public:
 			friend class inner_iterator < Index, Value, EqualFunc >;
 			friend class outter_iterator < Index, Value, EqualFunc > ;
+			friend class TinySTL::csr_graph < Index, Value, EqualFunc > ;
 		public:
 			typedef Index index_type;
 			typedef Value value_type;
 			typedef EqualFunc equal_func_type;
 			typedef pair<Index, Value> node_type;
 			typedef vector<node_type> nodes_set_type;
+			typedef polymorphic_allocator<node_type> allocator_type;
+			typedef graph_entry<node_type> entry_type;
+			typedef list<node_type, allocator_type> adjacent_list_type;
+			typedef list<entry_type, polymorphic_allocator<entry_type>> entries_type;
 			typedef std::function<void(node_type&)> visiter_func_type;
 			typedef outter_iterator<Index, Value, EqualFunc> iterator;
 			typedef inner_iterator<Index, Value, EqualFunc> inner_iterator;
 		public:
-			graph() :size_(0){};
+			explicit graph(const allocator_type& alloc = allocator_type()) :nodes_(alloc), size_(0){};
 			virtual ~graph(){};
 
+			allocator_type get_allocator()const{ return nodes_.get_allocator(); }
+
 			//node can be not in the graph
 			virtual void add_node(const node_type& item, const nodes_set_type& nodes) = 0;
 			//node of the index must in the graph
@@ -70,7 +100,7 @@ namespace TinySTL{
 			void _DFS(node_type& node, visiter_func_type func, Unordered_set<Index, std::hash<Index>, EqualFunc>& visited);
 			void _BFS(node_type& node, visiter_func_type func, Unordered_set<Index, std::hash<Index>, EqualFunc>& visited);
 		protected:
-			list<pair<node_type, list<node_type>>> nodes_;
+			entries_type nodes_;
 			equal_func_type equal_func;
 			size_t size_;
 		};
@@ -82,7 +112,7 @@ namespace TinySTL{
 			friend class graph < Index, Value, EqualFunc > ;
 			typedef graph<Index, Value, EqualFunc>* cntrPtr;
 			typedef graph<Index, Value, EqualFunc> graph_type;
-			typedef typename list<typename graph_type::node_type>::iterator inner_it_type;
+			typedef typename graph_type::adjacent_list_type::iterator inner_it_type;
 		public:
 			explicit inner_iterator(cntrPtr c = nullptr, inner_it_type iit = inner_it_type())
 				:container_(c), inner_it_(iit){}
@@ -110,7 +140,7 @@ namespace TinySTL{
 			friend class graph < Index, Value, EqualFunc >;
 			typedef graph<Index, Value, EqualFunc>* cntrPtr;
 			typedef graph<Index, Value, EqualFunc> graph_type;
-			typedef typename list<pair<typename graph_type::node_type, list<typename graph_type::node_type>>>::iterator outter_it_type;
+			typedef typename graph_type::entries_type::iterator outter_it_type;
 		private:
 			cntrPtr container_;
 			outter_it_type outter_it_;
@@ -137,7 +167,10 @@ namespace TinySTL{
 	template<class Index, class Value, class EqualFunc = equal_to<Index>>
 	class directed_graph :public Detail::graph < Index, Value, EqualFunc > {
 	public:
-		directed_graph();
+		typedef typename Detail::graph<Index, Value, EqualFunc>::node_type node_type;
+		typedef typename Detail::graph<Index, Value, EqualFunc>::nodes_set_type nodes_set_type;
+		typedef typename Detail::graph<Index, Value, EqualFunc>::allocator_type allocator_type;
+		explicit directed_graph(const allocator_type& alloc = allocator_type());
 		~directed_graph(){}
 		//node n -> every node_type in the nodes set
 		void add_node(const node_type& n, const nodes_set_type& nodes) override final;
@@ -150,6 +183,86 @@ namespace TinySTL{
 	private:
 		void add_node_helper(const Index& index, const nodes_set_type& nodes);
 	};
+
+	namespace Detail{
+		//unordered_mapҪȱȽconstģTinySTL::equal_tooperator()
+		template<class Index, class EqualFunc>
+		struct csr_key_equal{
+			mutable EqualFunc equal_func;
+			bool operator ()(const Index& lhs, const Index& rhs)const{ return equal_func(lhs, rhs); }
+		};
+		//[0, n)64ıֳthreadsΣfn(thread, first, last)
+		//ÿεĿʼ64ı߳дλͼʱͬһ
+		template<class Fn>
+		void csr_parallel_for(size_t n, unsigned threads, Fn fn){
+			if (threads < 2){
+				fn(0u, size_t(0), n);
+				return;
+			}
+			size_t step = ((n + threads - 1) / threads + 63) & ~size_t(63);
+			std::vector<std::thread> workers;
+			unsigned t = 0;
+			for (size_t first = 0; first < n; first += step, ++t){
+				size_t last = (n - first < step ? n : first + step);
+				workers.push_back(std::thread([=]{ fn(t, first, last); }));
+			}
+			for (size_t i = 0; i != workers.size(); ++i)
+				workers[i].join();
+		}
+	}
+
+	//the class of csr_graph
+	//ѹϡ(CSR)洢ֻͼ±Ϊ[0, size())
+	//ߺ߸һ飬ʱλͼ¼ʹĶ
+	template<class Index, class Value, class EqualFunc = equal_to<Index>>
+	class csr_graph{
+	public:
+		typedef Index index_type;
+		typedef Value value_type;
+		typedef unsigned int vertex_type;
+		typedef pair<Index, Value> node_type;
+		typedef std::pair<vertex_type, vertex_type> edge_type;
+		typedef std::function<void(node_type&)> visiter_func_type;
+		static const vertex_type npos = vertex_type(-1);
+		enum { parallel_threshold = 1 << 16 };//ʱbfs_levelsʹö߳
+	private:
+		std::vector<node_type> nodes_;
+		std::vector<size_t> out_offsets_;//size() + 1vĳout_edges_[out_offsets_[v], out_offsets_[v + 1])
+		std::vector<vertex_type> out_edges_;
+		std::vector<size_t> in_offsets_;
+		std::vector<vertex_type> in_edges_;
+		std::unordered_map<Index, vertex_type, std::hash<Index>, Detail::csr_key_equal<Index, EqualFunc>> ids_;
+	public:
+		csr_graph();
+		//㰴gе˳ţÿڽӵ㱣gе˳DFS/BFSķ˳gͬ
+		explicit csr_graph(const Detail::graph<Index, Value, EqualFunc>& g);
+		//nodes[i]ǱΪiĶ㣬edgesǱţͬһĳ߱edgesе˳
+		//indexظʱ׳std::invalid_argumentԽʱ׳std::out_of_range
+		csr_graph(const std::vector<node_type>& nodes, const std::vector<edge_type>& edges);
+
+		bool empty()const{ return nodes_.empty(); }
+		size_t size()const{ return nodes_.size(); }
+		size_t edge_count()const{ return out_edges_.size(); }
+
+		//indexӦĶţͼʱnpos
+		vertex_type vertex(const Index& index)const;
+		node_type& node(vertex_type v){ return nodes_[v]; }
+		const node_type& node(vertex_type v)const{ return nodes_[v]; }
+		size_t out_degree(vertex_type v)const{ return out_offsets_[v + 1] - out_offsets_[v]; }
+		size_t in_degree(vertex_type v)const{ return in_offsets_[v + 1] - in_offsets_[v]; }
+		const vertex_type *out_begin(vertex_type v)const{ return out_edges_.data() + out_offsets_[v]; }
+		const vertex_type *out_end(vertex_type v)const{ return out_edges_.data() + out_offsets_[v + 1]; }
+		const vertex_type *in_begin(vertex_type v)const{ return in_edges_.data() + in_offsets_[v]; }
+		const vertex_type *in_end(vertex_type v)const{ return in_edges_.data() + in_offsets_[v + 1]; }
+
+		void DFS(const Index& index, visiter_func_type func);
+		void BFS(const Index& index, visiter_func_type func);
+		//sourceÿĲɴΪnpos
+		//optimizeΪtrueʱŻ(Beamer 2012)ǰغܴʱΪδʵĶ
+		std::vector<vertex_type> bfs_levels(vertex_type source, bool parallel = true, bool optimize = true)const;
+	private:
+		void build(const std::vector<edge_type>& edges);
+	};
 }
 
 #include "Detail\Graph.impl.h"
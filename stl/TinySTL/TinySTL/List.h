@@ -9,7 +9,7 @@
 #include <type_traits>
 
 namespace TinySTL{
-	template<class T>
+	template<class T, class Alloc = allocator<T>>
 	class list;
 	namespace Detail{
 		//the class of node
@@ -18,17 +18,16 @@ namespace TinySTL{
 			T data;
 			node *prev;
 			node *next;
-			list<T> *container;
-			node(const T& d, node *p, node *n, list<T> *c):
-				data(d), prev(p), next(n), container(c){}
+			node(const T& d, node *p, node *n):
+				data(d), prev(p), next(n){}
 			bool operator ==(const node& n){
-				return data == n.data && prev == n.prev && next == n.next && container == n.container;
+				return data == n.data && prev == n.prev && next == n.next;
 			}
 		};
 		//the class of list iterator
 		template<class T>
 		struct listIterator :public iterator<bidirectional_iterator_tag, T>{
-			template<class T>
+			template<class T, class Alloc>
 			friend class list;
 		public:
 			typedef node<T>* nodePtr;
@@ -52,12 +51,13 @@ namespace TinySTL{
 
 
 	//the class of list
-	template<class T>
+	//ڵAlloc rebindõķз䣬ԪͨAlloc죬״̬ķԴǶ׵
+	template<class T, class Alloc>
 	class list{
 		template<class T>
 		friend struct listIterator;
 	private:
-		typedef allocator<Detail::node<T>> nodeAllocator;
+		typedef typename Alloc::template rebind<Detail::node<T>>::other nodeAllocator;
 		typedef Detail::node<T> *nodePtr;
 	public:
 		typedef T value_type;
@@ -66,18 +66,24 @@ namespace TinySTL{
 		typedef reverse_iterator_t<iterator> reverse_iterator;
 		typedef T& reference;
 		typedef size_t size_type;
+		typedef Alloc allocator_type;
 	private:
 		iterator head;
 		iterator tail;
+		Alloc alloc_;
 	public:
 		list();
-		explicit list(size_type n, const value_type& val = value_type());
+		explicit list(const Alloc& alloc);
+		explicit list(size_type n, const value_type& val = value_type(), const Alloc& alloc = Alloc());
 		template <class InputIterator>
-		list(InputIterator first, InputIterator last);
+		list(InputIterator first, InputIterator last, const Alloc& alloc = Alloc());
 		list(const list& l);
+		list(const list& l, const Alloc& alloc);
 		list& operator = (const list& l);
 		~list();
 
+		Alloc get_allocator()const{ return alloc_; }
+
 		bool empty()const{ return head == tail; }
 		size_type size()const;
 		reference front(){ return (head.p->data); }
@@ -123,19 +129,22 @@ namespace TinySTL{
 		void ctorAux(size_type n, const value_type& val, std::true_type);
 		template <class InputIterator>
 		void ctorAux(InputIterator first, InputIterator last, std::false_type);
-		nodePtr newNode(const T& val = T());
+		nodePtr newNode();
+		nodePtr newNode(const T& val);
 		void deleteNode(nodePtr p);
+		void initDummy();
+		void copyFrom(const list& l);
 		void insert_aux(iterator position, size_type n, const T& val, std::true_type);
 		template<class InputIterator>
 		void insert_aux(iterator position, InputIterator first, InputIterator last, std::false_type);
 		const_iterator changeIteratorToConstIterator(iterator& it)const;
 	public:
-		template<class T>
-		friend void swap(list<T>& x, list<T>& y);
-		template <class T>
-		friend bool operator== (const list<T>& lhs, const list<T>& rhs);
-		template <class T>
-		friend bool operator!= (const list<T>& lhs, const list<T>& rhs);
+		template<class T, class Alloc>
+		friend void swap(list<T, Alloc>& x, list<T, Alloc>& y);
+		template <class T, class Alloc>
+		friend bool operator== (const list<T, Alloc>& lhs, const list<T, Alloc>& rhs);
+		template <class T, class Alloc>
+		friend bool operator!= (const list<T, Alloc>& lhs, const list<T, Alloc>& rhs);
 	};//end of List
 }
 
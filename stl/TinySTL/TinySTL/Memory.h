@@ -1,6 +1,8 @@
 #ifndef _MEMORY_H_
 #define _MEMORY_H_
 
+#include <atomic>
+#include <memory>
 #include <utility>
 
 #include "Detail\Ref.h"
@@ -110,60 +112,133 @@ namespace TinySTL{
 		return unique_ptr<T>(new T(std::forward<Args>(args)...));
 	};
 
+	template<class T>
+	class weak_ptr;
+	template<class T>
+	class atomic_shared_ptr;
+
+	//ptr_Ϊget()صָ룬ref_Ϊƿ飬߿Բͬ(졢ൽת)
+	//յshared_ptrƿ
 	template<class T>
 	class shared_ptr{
 	public:
 		typedef T element_type;
-	private:
-		template<class Type>
-		using ref_t = Detail::ref_t < Type >;
 	public:
-		explicit shared_ptr(T *p = nullptr) :ref_(new ref_t<T>(p)){}
-		template<class D>
-		shared_ptr(T *p, D del) : ref_(new ref_t<T>(p, del)){}
+		shared_ptr() :ptr_(nullptr), ref_(nullptr){}
+		shared_ptr(nullptr_t) :ptr_(nullptr), ref_(nullptr){}
+		template<class U>
+		explicit shared_ptr(U *p) :ptr_(p), ref_(nullptr){
+			if (p)
+				ref_ = make_ref(p, Detail::_default_delete<U>());
+		}
+		template<class U, class D>
+		shared_ptr(U *p, D del) : ptr_(p), ref_(make_ref(p, std::move(del))){}
 
-		shared_ptr(const shared_ptr& sp){
-			copy_ref(sp.ref_);
+		shared_ptr(const shared_ptr& sp) :ptr_(sp.ptr_), ref_(sp.ref_){
+			if (ref_)
+				ref_->add_ref();
+		}
+		template<class U>
+		shared_ptr(const shared_ptr<U>& sp) : ptr_(sp.ptr_), ref_(sp.ref_){
+			if (ref_)
+				ref_->add_ref();
+		}
+		//죺spȨget()p
+		template<class U>
+		shared_ptr(const shared_ptr<U>& sp, element_type *p) : ptr_(p), ref_(sp.ref_){
+			if (ref_)
+				ref_->add_ref();
+		}
+		shared_ptr(shared_ptr&& sp) :ptr_(sp.ptr_), ref_(sp.ref_){
+			sp.ptr_ = nullptr;
+			sp.ref_ = nullptr;
+		}
+		template<class U>
+		shared_ptr(shared_ptr<U>&& sp) : ptr_(sp.ptr_), ref_(sp.ref_){
+			sp.ptr_ = nullptr;
+			sp.ref_ = nullptr;
+		}
+		//wpʧЧʱ׳std::bad_weak_ptr
+		template<class U>
+		explicit shared_ptr(const weak_ptr<U>& wp) : ptr_(wp.ptr_), ref_(wp.ref_){
+			if (!ref_ || !ref_->add_ref_lock())
+				throw std::bad_weak_ptr();
 		}
 
 		shared_ptr& operator = (const shared_ptr& sp){
-			if (this != &sp){
-				decrease_ref();
-				copy_ref(sp.ref_);
-			}
+			shared_ptr(sp).swap(*this);
+			return *this;
+		}
+		template<class U>
+		shared_ptr& operator = (const shared_ptr<U>& sp){
+			shared_ptr(sp).swap(*this);
+			return *this;
+		}
+		shared_ptr& operator = (shared_ptr&& sp){
+			shared_ptr(std::move(sp)).swap(*this);
+			return *this;
+		}
+		template<class U>
+		shared_ptr& operator = (shared_ptr<U>&& sp){
+			shared_ptr(std::move(sp)).swap(*this);
 			return *this;
 		}
 
-		~shared_ptr(){ decrease_ref(); }
+		~shared_ptr(){
+			if (ref_)
+				ref_->release();
+		}
 
 		const element_type& operator *()const{ return *(get()); }
 		const element_type *operator ->()const{ return get(); }
 		element_type& operator *(){ return *(get()); }
 		element_type *operator ->(){ return get(); }
 
-		const element_type* get() const{ return ref_->get_data(); }
-		element_type* get(){ return ref_->get_data(); }
-		size_t use_count() const{ return ref_->count(); }
+		const element_type* get() const{ return ptr_; }
+		element_type* get(){ return ptr_; }
+		size_t use_count() const{ return ref_ ? ref_->use_count() : 0; }
+		bool unique() const{ return use_count() == 1; }
 
 		operator bool() const{ return get() != nullptr; }
+
+		void reset(){ shared_ptr().swap(*this); }
+		template<class U>
+		void reset(U *p){ shared_ptr(p).swap(*this); }
+		template<class U, class D>
+		void reset(U *p, D del){ shared_ptr(p, std::move(del)).swap(*this); }
+		void swap(shared_ptr& sp){
+			std::swap(ptr_, sp.ptr_);
+			std::swap(ref_, sp.ref_);
+		}
 	private:
-		void decrease_ref(){
-			if (ref_->get_data()){
-				--(*ref_);
-				if (use_count() == 0)
-					delete ref_;
+		//ӹһѾ
+		shared_ptr(Detail::ref_count *r, element_type *p) :ptr_(p), ref_(r){}
+
+		//ƿʧʱҪɾͷp
+		template<class U, class D>
+		static Detail::ref_count *make_ref(U *p, D del){
+			try{
+				return new Detail::ref_t<U, D>(p, del);
+			}catch (...){
+				del(p);
+				throw;
 			}
 		}
-		void copy_ref(ref_t<T> *r){//ȷĿref_t
-			ref_ = r;
-			++(*ref_);
-		}
 	private:
-		ref_t<T> *ref_;
+		element_type *ptr_;
+		Detail::ref_count *ref_;
 
 	public:
+		template<class U>
+		friend class shared_ptr;
+		template<class U>
+		friend class weak_ptr;
+		template<class U>
+		friend class atomic_shared_ptr;
 		template<class _T>
 		friend class cow_ptr;
+		template<class U, class... Args>
+		friend shared_ptr<U> make_shared(Args&&... args);
 	};
 	template<class T1, class T2>
 	bool operator == (const shared_ptr<T1>& lhs, const shared_ptr<T2>& rhs){
@@ -189,11 +264,147 @@ namespace TinySTL{
 	bool operator != (nullptr_t p, const shared_ptr<T>& sp){
 		return !(sp == p);
 	}
+	template<class T>
+	void swap(shared_ptr<T>& x, shared_ptr<T>& y){
+		x.swap(y);
+	}
 
+	//Ϳƿһηй
 	template<class T, class...Args>
-	shared_ptr<T> make_shared(Args... args){
-		return shared_ptr<T>(new T(std::forward<Args>(args)...));
+	shared_ptr<T> make_shared(Args&&... args){
+		auto r = new Detail::ref_inplace<T>(std::forward<Args>(args)...);
+		return shared_ptr<T>(static_cast<Detail::ref_count*>(r), r->get_data());
 	}
+
+	template<class T>
+	class weak_ptr{
+	public:
+		typedef T element_type;
+	public:
+		weak_ptr() :ptr_(nullptr), ref_(nullptr){}
+		weak_ptr(const weak_ptr& wp) :ptr_(wp.ptr_), ref_(wp.ref_){
+			if (ref_)
+				ref_->weak_add_ref();
+		}
+		template<class U>
+		weak_ptr(const weak_ptr<U>& wp) : ptr_(nullptr), ref_(nullptr){
+			//wpָĶѾlockָת
+			shared_ptr<U> sp = wp.lock();
+			ptr_ = sp.ptr_;
+			ref_ = wp.ref_;
+			if (ref_)
+				ref_->weak_add_ref();
+		}
+		template<class U>
+		weak_ptr(const shared_ptr<U>& sp) : ptr_(sp.ptr_), ref_(sp.ref_){
+			if (ref_)
+				ref_->weak_add_ref();
+		}
+		weak_ptr(weak_ptr&& wp) :ptr_(wp.ptr_), ref_(wp.ref_){
+			wp.ptr_ = nullptr;
+			wp.ref_ = nullptr;
+		}
+
+		weak_ptr& operator = (const weak_ptr& wp){
+			weak_ptr(wp).swap(*this);
+			return *this;
+		}
+		template<class U>
+		weak_ptr& operator = (const shared_ptr<U>& sp){
+			weak_ptr(sp).swap(*this);
+			return *this;
+		}
+		weak_ptr& operator = (weak_ptr&& wp){
+			weak_ptr(std::move(wp)).swap(*this);
+			return *this;
+		}
+
+		~weak_ptr(){
+			if (ref_)
+				ref_->weak_release();
+		}
+
+		size_t use_count() const{ return ref_ ? ref_->use_count() : 0; }
+		bool expired() const{ return use_count() == 0; }
+		//ʱؿյshared_ptr
+		shared_ptr<T> lock() const{
+			if (ref_ && ref_->add_ref_lock())
+				return shared_ptr<T>(ref_, ptr_);
+			return shared_ptr<T>();
+		}
+
+		void reset(){ weak_ptr().swap(*this); }
+		void swap(weak_ptr& wp){
+			std::swap(ptr_, wp.ptr_);
+			std::swap(ref_, wp.ref_);
+		}
+	private:
+		T *ptr_;
+		Detail::ref_count *ref_;
+
+	public:
+		template<class U>
+		friend class shared_ptr;
+		template<class U>
+		friend class weak_ptr;
+	};
+	template<class T>
+	void swap(weak_ptr<T>& x, weak_ptr<T>& y){
+		x.swap(y);
+	}
+
+	//ɱ߳ͬʱдshared_ptrload
+	//ڲòü(split reference count)
+	//word_ĸ48λһshared_ptrnodeĵַ16λڶȡnode߳(ⲿ)
+	//loadⲿshared_ptrٰⲿȥ
+	//ڼnodeѾstore£ⲿѾתƵnodeڲϣΪڲ
+	//Ҫûַ̬48λ(x86-64AArch64)ͬʱȡ̲߳65535
+	template<class T>
+	class atomic_shared_ptr{
+	private:
+		struct node{
+			std::atomic<long> inner_;//ʱתⲿȥѾ뿪Ķ
+			shared_ptr<T> value_;
+			explicit node(const shared_ptr<T>& sp) :inner_(0), value_(sp){}
+		};
+		typedef unsigned long long word_type;
+		enum { COUNT_BITS = 16 };
+		mutable std::atomic<word_type> word_;
+	public:
+		atomic_shared_ptr() :word_(0){}
+		atomic_shared_ptr(const shared_ptr<T>& sp) :word_(make_word(sp)){}
+		atomic_shared_ptr(const atomic_shared_ptr&) = delete;
+		atomic_shared_ptr& operator = (const atomic_shared_ptr&) = delete;
+		~atomic_shared_ptr();
+
+		bool is_lock_free()const{ return word_.is_lock_free(); }
+
+		shared_ptr<T> load()const;
+		void store(const shared_ptr<T>& sp){ exchange(sp); }
+		shared_ptr<T> exchange(const shared_ptr<T>& sp);
+		//ǰֵexpectedͬһƿget()ͬʱdesiredѵǰֵдexpected
+		bool compare_exchange_strong(shared_ptr<T>& expected, const shared_ptr<T>& desired);
+		bool compare_exchange_weak(shared_ptr<T>& expected, const shared_ptr<T>& desired){
+			return compare_exchange_strong(expected, desired);
+		}
+
+		operator shared_ptr<T>()const{ return load(); }
+		atomic_shared_ptr& operator = (const shared_ptr<T>& sp){
+			store(sp);
+			return *this;
+		}
+	private:
+		static node *get_node(word_type w){ return reinterpret_cast<node*>(w >> COUNT_BITS); }
+		static word_type make_word(const shared_ptr<T>& sp);
+		//ⲿӺword_nodeΪʱ
+		word_type acquire()const;
+		//acquireӵⲿ
+		void release(node *n)const;
+		//nѾword_ϻ£ⲿתƵڲ
+		static void retire(node *n, size_t count);
+	};
 }
 
+#include "Detail\Memory.impl.h"
+
 #endif
\ No newline at end of file
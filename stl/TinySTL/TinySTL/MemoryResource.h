@@ -0,0 +1,217 @@
+#ifndef _MEMORY_RESOURCE_H_
+#define _MEMORY_RESOURCE_H_
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace TinySTL{
+	//the class of memory_resource
+	//std::pmr::memory_resourceͬĽӿڣ״̬ڴԴͨpolymorphic_allocatorʹ
+	class memory_resource{
+	public:
+		enum { max_align = 2 * sizeof(void *) };//malloc֤Ķ
+	public:
+		virtual ~memory_resource(){}
+
+		void *allocate(size_t bytes, size_t alignment = max_align){ return do_allocate(bytes, alignment); }
+		void deallocate(void *p, size_t bytes, size_t alignment = max_align){ do_deallocate(p, bytes, alignment); }
+		bool is_equal(const memory_resource& other)const{ return do_is_equal(other); }
+	private:
+		virtual void *do_allocate(size_t bytes, size_t alignment) = 0;
+		virtual void do_deallocate(void *p, size_t bytes, size_t alignment) = 0;
+		virtual bool do_is_equal(const memory_resource& other)const = 0;
+	};
+	inline bool operator ==(const memory_resource& lhs, const memory_resource& rhs){
+		return &lhs == &rhs || lhs.is_equal(rhs);
+	}
+	inline bool operator !=(const memory_resource& lhs, const memory_resource& rhs){
+		return !(lhs == rhs);
+	}
+
+	//::operator new/delete
+	memory_resource *new_delete_resource();
+	//κη䶼׳std::bad_allocΪĻ
+	memory_resource *null_memory_resource();
+	//TinySTL::allocڴأTinySTL::stringûָresourceʱʹ
+	memory_resource *alloc_resource();
+	//polymorphic_allocatorĬϹʱʹõresourceʼΪnew_delete_resource()
+	memory_resource *get_default_resource();
+	memory_resource *set_default_resource(memory_resource *r);
+
+	//the class of monotonic_buffer_resource
+	//ֻĻƶָ룬deallocateʲô
+	//release()ʱѴڴһԹ黹nginxngx_pool_t
+	class monotonic_buffer_resource : public memory_resource{
+	private:
+		struct chunk{
+			chunk *next_;
+			size_t bytes_;
+		};
+		enum { initial_size = 1024 };
+
+		memory_resource *upstream_;
+		void *initialBuffer_;
+		size_t initialSize_;
+		char *cur_;
+		size_t left_;
+		size_t nextSize_;
+		chunk *chunks_;
+	public:
+		explicit monotonic_buffer_resource(memory_resource *upstream = get_default_resource());
+		explicit monotonic_buffer_resource(size_t initialSize, memory_resource *upstream = get_default_resource());
+		//õṩbuffer
+		monotonic_buffer_resource(void *buffer, size_t size, memory_resource *upstream = get_default_resource());
+		monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+		monotonic_buffer_resource& operator = (const monotonic_buffer_resource&) = delete;
+		~monotonic_buffer_resource(){ release(); }
+
+		void release();
+		memory_resource *upstream_resource()const{ return upstream_; }
+	private:
+		void *do_allocate(size_t bytes, size_t alignment) override;
+		void do_deallocate(void *, size_t, size_t) override{}
+		bool do_is_equal(const memory_resource& other)const override{ return this == &other; }
+	};
+
+	struct pool_options{
+		size_t max_blocks_per_chunk;//ÿһຬٸ
+		size_t largest_required_pool_block;//Сֱӽ
+		pool_options() :max_blocks_per_chunk(0), largest_required_pool_block(0){}
+	};
+
+	//the class of unsynchronized_pool_resource
+	//2ݷֳɸأÿάһͷŵԱãֻһ߳ʹ
+	//ֱӽΣҲᱻ¼release()ʱȫ黹
+	class unsynchronized_pool_resource : public memory_resource{
+	private:
+		enum { min_block = 8, max_pools = 16 };
+		enum { default_blocks_per_chunk = 1024, default_largest_block = 4096 };
+		struct pool{
+			void *free_;
+			size_t blockSize_;
+			size_t nextBlocks_;//һÿη
+		};
+		struct chunk{
+			chunk *next_;
+			size_t bytes_;
+			size_t pad_;
+		};
+		struct large_block{
+			large_block *prev_;
+			large_block *next_;
+			void *raw_;//ηصĵַ
+			size_t bytes_;//ͬͷһֽ
+		};
+
+		memory_resource *upstream_;
+		pool_options options_;
+		pool pools_[max_pools];
+		size_t poolCount_;
+		chunk *chunks_;
+		large_block *large_;
+	public:
+		explicit unsynchronized_pool_resource(memory_resource *upstream = get_default_resource());
+		explicit unsynchronized_pool_resource(const pool_options& opts, memory_resource *upstream = get_default_resource());
+		unsynchronized_pool_resource(const unsynchronized_pool_resource&) = delete;
+		unsynchronized_pool_resource& operator = (const unsynchronized_pool_resource&) = delete;
+		~unsynchronized_pool_resource(){ release(); }
+
+		void release();
+		memory_resource *upstream_resource()const{ return upstream_; }
+		pool_options options()const{ return options_; }
+	private:
+		void init(const pool_options& opts);
+		size_t pool_index(size_t bytes, size_t alignment)const;
+		void refill(pool& p);
+		void *do_allocate(size_t bytes, size_t alignment) override;
+		void do_deallocate(void *p, size_t bytes, size_t alignment) override;
+		bool do_is_equal(const memory_resource& other)const override{ return this == &other; }
+	};
+
+	template<class T>
+	class polymorphic_allocator;
+	namespace Detail{
+		template<class T>
+		struct has_allocator_type{
+			template<class U>
+			static char test(typename U::allocator_type *);
+			template<class U>
+			static long test(...);
+			enum { value = sizeof(test<T>(0)) == 1 };
+		};
+		//Tallocator_typeAllocתʱTʹ÷()
+		template<class T, class Alloc, bool = has_allocator_type<T>::value>
+		struct uses_allocator : public std::is_convertible<Alloc, typename T::allocator_type>{};
+		template<class T, class Alloc>
+		struct uses_allocator<T, Alloc, false> : public std::false_type{};
+	}
+
+	//the class of polymorphic_allocator
+	//ֻһmemory_resourceָ룬ͬһԪءڵ㶼resource
+	//ԪʱԪرҲʹ÷ͰѷΪһ(uses-allocator)
+	//ͬһresourceϣresourceһԻ
+	template<class T>
+	class polymorphic_allocator{
+	public:
+		typedef T			value_type;
+		typedef T*			pointer;
+		typedef const T*	const_pointer;
+		typedef T&			reference;
+		typedef const T&	const_reference;
+		typedef size_t		size_type;
+		typedef ptrdiff_t	difference_type;
+		template<class U>
+		struct rebind{ typedef polymorphic_allocator<U> other; };
+	private:
+		memory_resource *resource_;
+	public:
+		polymorphic_allocator() :resource_(get_default_resource()){}
+		polymorphic_allocator(memory_resource *r) :resource_(r){}
+		template<class U>
+		polymorphic_allocator(const polymorphic_allocator<U>& other) :resource_(other.resource()){}
+
+		T *allocate(size_t n = 1){
+			return static_cast<T *>(resource_->allocate(n * sizeof(T), std::alignment_of<T>::value));
+		}
+		void deallocate(T *ptr, size_t n = 1){
+			resource_->deallocate(ptr, n * sizeof(T), std::alignment_of<T>::value);
+		}
+
+		template<class U, class... Args>
+		void construct(U *ptr, Args&&... args){
+			construct_aux(ptr, typename Detail::uses_allocator<U, polymorphic_allocator>::type(), std::forward<Args>(args)...);
+		}
+		template<class U>
+		void destroy(U *ptr){ ptr->~U(); }
+		template<class U>
+		void destroy(U *first, U *last){
+			for (; first != last; ++first)
+				first->~U();
+		}
+
+		memory_resource *resource()const{ return resource_; }
+		//std::pmrһʱԭresource
+		polymorphic_allocator select_on_container_copy_construction()const{ return polymorphic_allocator(); }
+	private:
+		template<class U, class... Args>
+		void construct_aux(U *ptr, std::true_type, Args&&... args){
+			new(ptr) U(std::forward<Args>(args)..., *this);
+		}
+		template<class U, class... Args>
+		void construct_aux(U *ptr, std::false_type, Args&&... args){
+			new(ptr) U(std::forward<Args>(args)...);
+		}
+	};
+	template<class T1, class T2>
+	bool operator ==(const polymorphic_allocator<T1>& lhs, const polymorphic_allocator<T2>& rhs){
+		return *lhs.resource() == *rhs.resource();
+	}
+	template<class T1, class T2>
+	bool operator !=(const polymorphic_allocator<T1>& lhs, const polymorphic_allocator<T2>& rhs){
+		return !(lhs == rhs);
+	}
+}
+
+#endif
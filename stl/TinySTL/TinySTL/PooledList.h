@@ -0,0 +1,243 @@
+#ifndef _POOLED_LIST_H_
+#define _POOLED_LIST_H_
+
+#include "Functional.h"
+#include "Iterator.h"
+#include "Memory.h"
+#include "ReverseIterator.h"
+#include "Detail\Prefetch.h"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace TinySTL{
+	namespace Detail{
+		//ڵأڵӰ(slab)ڴгͷŵĽڵҵϸһη
+		//16ڵ㿪ʼÿη鲻64KBֻreset/releaseʱ
+		class slab_pool{
+		private:
+			struct slab{
+				slab *next;
+				size_t bytes;//ͷ
+			};
+			enum{ HEADER = 2 * sizeof(void *) };//ͷ֮ĽڵmallocͬĶ
+			enum{ FIRST_NODES = 16, MAX_SLAB_BYTES = 64 * 1024 };
+
+			size_t nodeSize_;
+			slab *first_, *last_;//˳ȫ
+			slab *cur_;//еĿ
+			char *next_, *end_;//cur_лûгĲ
+			void *free_;
+			size_t nextNodes_;//һ¿Ľڵ
+		public:
+			explicit slab_pool(size_t nodeSize);
+			~slab_pool(){ release(); }
+			slab_pool(const slab_pool&) = delete;
+			slab_pool& operator = (const slab_pool&) = delete;
+
+			void *allocate(){
+				if (free_){
+					void *p = free_;
+					free_ = *static_cast<void **>(p);
+					return p;
+				}
+				if (next_ != end_){
+					void *p = next_;
+					next_ += nodeSize_;
+					return p;
+				}
+				return refill();
+			}
+			void deallocate(void *p){
+				*static_cast<void **>(p) = free_;
+				free_ = p;
+			}
+			//Ҫнڵ㶼Ѿͷ
+			//ѾĿ飬ӵһ
+			void reset();
+			//ѿ鶼ϵͳ
+			void release();
+
+			size_t node_size()const{ return nodeSize_; }
+			//ѾĿֽ
+			size_t capacity()const;
+		private:
+			void *refill();
+		};
+
+		//ڵָǰ棬ʱֻҪڵ㿪ͷһcache line
+		struct plist_link{
+			plist_link *prev;
+			plist_link *next;
+		};
+		template<class T>
+		struct plist_node : plist_link{
+			T data;
+			template<class... Args>
+			explicit plist_node(Args&&... args) :data(std::forward<Args>(args)...){}
+		};
+
+		//ÿǰһԤȡһڵ㣬˳ʱӲԤȡһѷôڼ
+		template<class T, class Ref, class Ptr>
+		struct plist_iterator :public iterator<bidirectional_iterator_tag, T, ptrdiff_t, Ptr, Ref>{
+			plist_link *p;
+
+			explicit plist_iterator(plist_link *ptr = nullptr) :p(ptr){}
+			//iteratorתΪconst_iterator
+			plist_iterator(const plist_iterator<T, T&, T*>& it) :p(it.p){}
+
+			Ref operator *()const{ return static_cast<plist_node<T>*>(p)->data; }
+			Ptr operator ->()const{ return &(operator*()); }
+			plist_iterator& operator ++(){
+				p = p->next;
+				prefetch(p->next);
+				return *this;
+			}
+			plist_iterator operator ++(int){
+				auto res = *this;
+				++*this;
+				return res;
+			}
+			plist_iterator& operator --(){
+				p = p->prev;
+				return *this;
+			}
+			plist_iterator operator --(int){
+				auto res = *this;
+				--*this;
+				return res;
+			}
+			friend bool operator ==(const plist_iterator& lhs, const plist_iterator& rhs){ return lhs.p == rhs.p; }
+			friend bool operator !=(const plist_iterator& lhs, const plist_iterator& rhs){ return lhs.p != rhs.p; }
+		};
+	}
+
+	//the class of pooled_list
+	//ڵslab_poolз˫ѭڱڵlistsize()ΪO(1)
+	//ͨshared_ptrУʱһlistget_pool()ͿԹͬһ
+	//(ͬһlist)֮splice/mergeָֻ룻زͬʱԪƶԼĳ
+	//ֻһlistʱclearֱգͷŽڵ
+	template<class T>
+	class pooled_list{
+	public:
+		typedef T value_type;
+		typedef T& reference;
+		typedef const T& const_reference;
+		typedef size_t size_type;
+		typedef Detail::plist_iterator<T, T&, T*> iterator;
+		typedef Detail::plist_iterator<T, const T&, const T*> const_iterator;
+		typedef reverse_iterator_t<iterator> reverse_iterator;
+		typedef reverse_iterator_t<const_iterator> const_reverse_iterator;
+		typedef Detail::slab_pool pool_type;
+	private:
+		typedef Detail::plist_link link;
+		typedef Detail::plist_node<T> node;
+		static_assert(std::alignment_of<node>::value <= 2 * sizeof(void *), "over-aligned element type");
+
+		link head_;
+		size_type size_;
+		mutable shared_ptr<pool_type> pool_;//һηڵʱŴ
+	public:
+		pooled_list();
+		explicit pooled_list(const shared_ptr<pool_type>& pool);
+		explicit pooled_list(size_type n, const value_type& val = value_type());
+		template<class InputIterator>
+		pooled_list(InputIterator first, InputIterator last);
+		pooled_list(const pooled_list& l);
+		pooled_list(pooled_list&& l);
+		pooled_list& operator = (const pooled_list& l);
+		pooled_list& operator = (pooled_list&& l);
+		~pooled_list();
+
+		//ڵأûʱȴ
+		shared_ptr<pool_type> get_pool()const;
+
+		bool empty()const{ return size_ == 0; }
+		size_type size()const{ return size_; }
+		reference front(){ return *begin(); }
+		const_reference front()const{ return *begin(); }
+		reference back(){ return *(--end()); }
+		const_reference back()const{ return *(--end()); }
+
+		iterator begin(){ return iterator(head_.next); }
+		iterator end(){ return iterator(&head_); }
+		const_iterator begin()const{ return const_iterator(head_.next); }
+		const_iterator end()const{ return const_iterator(const_cast<link*>(&head_)); }
+		const_iterator cbegin()const{ return begin(); }
+		const_iterator cend()const{ return end(); }
+		reverse_iterator rbegin(){ return reverse_iterator(end()); }
+		reverse_iterator rend(){ return reverse_iterator(begin()); }
+		const_reverse_iterator rbegin()const{ return const_reverse_iterator(end()); }
+		const_reverse_iterator rend()const{ return const_reverse_iterator(begin()); }
+
+		void push_front(const value_type& val){ emplace(begin(), val); }
+		void push_front(value_type&& val){ emplace(begin(), std::move(val)); }
+		void push_back(const value_type& val){ emplace(end(), val); }
+		void push_back(value_type&& val){ emplace(end(), std::move(val)); }
+		template<class... Args>
+		void emplace_front(Args&&... args){ emplace(begin(), std::forward<Args>(args)...); }
+		template<class... Args>
+		void emplace_back(Args&&... args){ emplace(end(), std::forward<Args>(args)...); }
+		void pop_front(){ erase(begin()); }
+		void pop_back(){ erase(--end()); }
+
+		template<class... Args>
+		iterator emplace(const_iterator position, Args&&... args);
+		iterator insert(const_iterator position, const value_type& val){ return emplace(position, val); }
+		iterator insert(const_iterator position, value_type&& val){ return emplace(position, std::move(val)); }
+		iterator insert(const_iterator position, size_type n, const value_type& val);
+		template<class InputIterator>
+		iterator insert(const_iterator position, InputIterator first, InputIterator last);
+		iterator erase(const_iterator position);
+		iterator erase(const_iterator first, const_iterator last);
+		void clear();
+		void swap(pooled_list& x);
+
+		void splice(const_iterator position, pooled_list& x);
+		void splice(const_iterator position, pooled_list& x, const_iterator i);
+		void splice(const_iterator position, pooled_list& x, const_iterator first, const_iterator last);
+		void remove(const value_type& val);
+		template<class Predicate>
+		void remove_if(Predicate pred);
+		void unique(){ unique(TinySTL::equal_to<T>()); }
+		template<class BinaryPredicate>
+		void unique(BinaryPredicate binary_pred);
+		void merge(pooled_list& x){ merge(x, TinySTL::less<T>()); }
+		template<class Compare>
+		void merge(pooled_list& x, Compare comp);
+		//ԵϵĹ鲢ȶֻĽڵָ룬ڴ
+		void sort(){ sort(TinySTL::less<T>()); }
+		template<class Compare>
+		void sort(Compare comp);
+		void reverse();
+	private:
+		static T& value(link *p){ return static_cast<node*>(p)->data; }
+		pool_type& pool()const;
+		//xĽڵֱӽӵԼϣԼûгʱxĳ
+		bool sharePool(const pooled_list& x);
+		void initHead();
+		template<class... Args>
+		link *newNode(Args&&... args);
+		void deleteNode(link *p);
+		//[first, last)position֮ǰ[first, last)һlist
+		static void transfer(link *position, link *first, link *last);
+		//ͷȫڵ㣬رռʱ
+		void destroyAll();
+		void ctorAux(size_type n, const value_type& val, std::true_type);
+		template<class InputIterator>
+		void ctorAux(InputIterator first, InputIterator last, std::false_type);
+		template<class Compare>
+		static link *mergeRuns(link *a, link *b, Compare& comp);
+	};
+	template<class T>
+	void swap(pooled_list<T>& x, pooled_list<T>& y){ x.swap(y); }
+	template<class T>
+	bool operator== (const pooled_list<T>& lhs, const pooled_list<T>& rhs);
+	template<class T>
+	bool operator!= (const pooled_list<T>& lhs, const pooled_list<T>& rhs){ return !(lhs == rhs); }
+}
+
+#include "Detail\PooledList.impl.h"
+#endif
\ No newline at end of file
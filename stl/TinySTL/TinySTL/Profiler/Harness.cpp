@@ -0,0 +1,313 @@
+#include "Harness.h"
+
+#include "../Alloc.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <new>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace TinySTL{
+	namespace Profiler{
+		namespace Detail{
+			const void *volatile optimizeSink = 0;
+		}
+		namespace{
+			std::atomic<size_t> allocationCount(0);
+			std::atomic<size_t> allocationBytes(0);
+
+			void countAllocation(size_t bytes){
+				allocationCount.fetch_add(1, std::memory_order_relaxed);
+				allocationBytes.fetch_add(bytes, std::memory_order_relaxed);
+			}
+
+#if defined(__linux__)
+			int openEvent(uint64_t config){
+				perf_event_attr attr;
+				memset(&attr, 0, sizeof(attr));
+				attr.size = sizeof(attr);
+				attr.type = PERF_TYPE_HARDWARE;
+				attr.config = config;
+				attr.disabled = 1;
+				attr.exclude_kernel = 1;
+				attr.exclude_hv = 1;
+				return int(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+			}
+#endif
+			//JSONַ
+			void writeString(std::ostream& os, const std::string& s){
+				os << '"';
+				for (size_t i = 0; i != s.size(); ++i){
+					unsigned char c = s[i];
+					if (c == '"' || c == '\\'){
+						os << '\\' << c;
+					}else if (c < 0x20){
+						char buf[8];
+						sprintf(buf, "\\u%04x", c);
+						os << buf;
+					}else{
+						os << c;
+					}
+				}
+				os << '"';
+			}
+			void writeNumber(std::ostream& os, double value){
+				if (value < 0 || value != value)
+					os << "null";
+				else
+					os << value;
+			}
+			double median(std::vector<double>& values){
+				std::sort(values.begin(), values.end());
+				size_t n = values.size();
+				return n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+			}
+		}
+
+		//******************************HardwareCounters*****************************
+		HardwareCounters::HardwareCounters(){
+#if defined(__linux__)
+			const uint64_t configs[EVENT_COUNT] = {
+				PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+				PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+			};
+			for (int i = 0; i != EVENT_COUNT; ++i)
+				fds_[i] = openEvent(configs[i]);
+#else
+			for (int i = 0; i != EVENT_COUNT; ++i)
+				fds_[i] = -1;
+#endif
+		}
+		HardwareCounters::~HardwareCounters(){
+#if defined(__linux__)
+			for (int i = 0; i != EVENT_COUNT; ++i){
+				if (fds_[i] >= 0)
+					close(fds_[i]);
+			}
+#endif
+		}
+		void HardwareCounters::start(){
+#if defined(__linux__)
+			for (int i = 0; i != EVENT_COUNT; ++i){
+				if (fds_[i] >= 0){
+					ioctl(fds_[i], PERF_EVENT_IOC_RESET, 0);
+					ioctl(fds_[i], PERF_EVENT_IOC_ENABLE, 0);
+				}
+			}
+#endif
+		}
+		void HardwareCounters::finish(long long(&values)[EVENT_COUNT]){
+			for (int i = 0; i != EVENT_COUNT; ++i){
+				values[i] = -1;
+#if defined(__linux__)
+				long long value;
+				if (fds_[i] >= 0){
+					ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+					if (read(fds_[i], &value, sizeof(value)) == sizeof(value))
+						values[i] = value;
+				}
+#endif
+			}
+		}
+		const char *HardwareCounters::name(Event e){
+			static const char *names[EVENT_COUNT] = { "cycles", "instructions", "cache_misses", "branch_misses" };
+			return names[e];
+		}
+
+		//******************************AllocationCounter*****************************
+		size_t AllocationCounter::allocations(){
+			return allocationCount.load(std::memory_order_relaxed);
+		}
+		size_t AllocationCounter::bytes(){
+			return allocationBytes.load(std::memory_order_relaxed);
+		}
+
+		//******************************Harness*****************************
+		Harness::Harness(const std::string& suite, size_t warmup, size_t repetitions, double minRepMs, std::ostream *os)
+			:suite_(suite), warmup_(warmup), repetitions_(repetitions ? repetitions : 1), minRepMs_(minRepMs), os_(os),
+			oldHook_(alloc::allocate_hook), startAllocations_(0), startBytes_(0){
+			alloc::allocate_hook = &countAllocation;
+			if (os_)
+				*os_ << suite_ << std::endl;
+		}
+		Harness::~Harness(){
+			alloc::allocate_hook = oldHook_;
+		}
+		void Harness::begin(){
+			startAllocations_ = AllocationCounter::allocations();
+			startBytes_ = AllocationCounter::bytes();
+			counters_.start();
+			startTime_ = ProfilerInstance::SteadyClock::now();
+		}
+		Harness::Sample Harness::end(){
+			auto finishTime = ProfilerInstance::SteadyClock::now();
+			Sample sample;
+			counters_.finish(sample.counters);
+			sample.ns = std::chrono::duration<double, std::nano>(finishTime - startTime_).count();
+			sample.allocations = AllocationCounter::allocations() - startAllocations_;
+			sample.bytes = AllocationCounter::bytes() - startBytes_;
+			return sample;
+		}
+		const BenchResult& Harness::record(const std::string& group, const std::string& name,
+			std::vector<Sample>& samples, size_t batch){
+			BenchResult result;
+			result.group = group;
+			result.name = name;
+			result.repetitions = samples.size();
+			result.batch = batch;
+
+			std::vector<double> values;
+			double sum = 0, allocations = 0, bytes = 0;
+			for (size_t i = 0; i != samples.size(); ++i){
+				values.push_back(samples[i].ns / batch);
+				sum += values.back();
+				allocations += samples[i].allocations;
+				bytes += samples[i].bytes;
+			}
+			result.meanNs = sum / values.size();
+			double sq = 0;
+			for (size_t i = 0; i != values.size(); ++i)
+				sq += (values[i] - result.meanNs) * (values[i] - result.meanNs);
+			result.stddevNs = values.size() > 1 ? std::sqrt(sq / (values.size() - 1)) : 0;
+			result.medianNs = median(values);
+			result.minNs = values.front();
+			result.maxNs = values.back();
+			result.allocations = allocations / (double(samples.size()) * batch);
+			result.allocatedBytes = bytes / (double(samples.size()) * batch);
+
+			for (int e = 0; e != HardwareCounters::EVENT_COUNT; ++e){
+				values.clear();
+				for (size_t i = 0; i != samples.size() && samples[i].counters[e] >= 0; ++i)
+					values.push_back(double(samples[i].counters[e]) / batch);
+				result.counters[e] = values.size() == samples.size() ? median(values) : -1;
+			}
+
+			const BenchResult *baseline = 0;
+			bool newGroup = true;
+			for (size_t i = 0; i != results_.size(); ++i){
+				if (results_[i].group == group){
+					baseline = &results_[i];
+					newGroup = false;
+					break;
+				}
+			}
+			if (os_){
+				if (newGroup || results_.back().group != group)
+					*os_ << "  " << group << std::endl;
+				dumpLine(*os_, result, baseline);
+			}
+			results_.push_back(result);
+			return results_.back();
+		}
+		void Harness::dumpLine(std::ostream& os, const BenchResult& result, const BenchResult *baseline)const{
+			std::ios::fmtflags flags = os.flags();
+			std::streamsize precision = os.precision();
+			os << "    " << std::left << std::setw(32) << result.name << std::right << std::fixed
+				<< std::setprecision(1) << std::setw(14) << result.medianNs << " ns"
+				<< "  +-" << std::setw(5) << (result.meanNs > 0 ? result.stddevNs / result.meanNs * 100 : 0) << "%";
+			if (baseline && baseline->medianNs > 0)
+				os << std::setprecision(2) << std::setw(8) << result.medianNs / baseline->medianNs << "x";
+			else
+				os << std::setw(9) << "1.00x";
+			os << std::setprecision(1) << "  allocs " << result.allocations;
+			for (int e = 0; e != HardwareCounters::EVENT_COUNT; ++e){
+				if (result.counters[e] >= 0)
+					os << "  " << HardwareCounters::name(HardwareCounters::Event(e)) << " " << std::setprecision(0) << result.counters[e];
+			}
+			os << std::endl;
+			os.flags(flags);
+			os.precision(precision);
+		}
+		void Harness::dump(std::ostream& os)const{
+			os << suite_ << std::endl;
+			std::vector<bool> printed(results_.size(), false);
+			for (size_t i = 0; i != results_.size(); ++i){
+				if (printed[i])
+					continue;
+				os << "  " << results_[i].group << std::endl;
+				for (size_t j = i; j != results_.size(); ++j){
+					if (!printed[j] && results_[j].group == results_[i].group){
+						dumpLine(os, results_[j], j == i ? 0 : &results_[i]);
+						printed[j] = true;
+					}
+				}
+			}
+		}
+		void Harness::dumpJson(std::ostream& os)const{
+			std::ios::fmtflags flags = os.flags();
+			std::streamsize precision = os.precision();
+			os << std::setprecision(10);
+			os << "{\n  \"suite\": ";
+			writeString(os, suite_);
+			os << ",\n  \"warmup\": " << warmup_ << ",\n  \"results\": [";
+			for (size_t i = 0; i != results_.size(); ++i){
+				const BenchResult& r = results_[i];
+				os << (i ? ",\n" : "\n") << "    {\"group\": ";
+				writeString(os, r.group);
+				os << ", \"name\": ";
+				writeString(os, r.name);
+				os << ", \"repetitions\": " << r.repetitions << ", \"batch\": " << r.batch
+					<< ", \"min_ns\": " << r.minNs << ", \"median_ns\": " << r.medianNs
+					<< ", \"mean_ns\": " << r.meanNs << ", \"max_ns\": " << r.maxNs << ", \"stddev_ns\": " << r.stddevNs;
+				for (int e = 0; e != HardwareCounters::EVENT_COUNT; ++e){
+					os << ", \"" << HardwareCounters::name(HardwareCounters::Event(e)) << "\": ";
+					writeNumber(os, r.counters[e]);
+				}
+				os << ", \"allocations\": " << r.allocations << ", \"allocated_bytes\": " << r.allocatedBytes << "}";
+			}
+			os << "\n  ]\n}\n";
+			os.flags(flags);
+			os.precision(precision);
+		}
+		void Harness::saveJson(const char *path)const{
+			std::ofstream out(path);
+			if (!out)
+				throw std::runtime_error(std::string("Harness: cannot open ") + path);
+			dumpJson(out);
+			if (!out)
+				throw std::runtime_error(std::string("Harness: cannot write ") + path);
+		}
+	}
+}
+
+#if defined(TINYSTL_COUNT_ALLOCATIONS)
+//滻ȫֵoperator new/deleteͳstd::ķ
+void *operator new(size_t bytes){
+	TinySTL::Profiler::countAllocation(bytes);
+	void *ptr = malloc(bytes ? bytes : 1);
+	if (!ptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+void *operator new[](size_t bytes){
+	return ::operator new(bytes);
+}
+void operator delete(void *ptr){
+	free(ptr);
+}
+void operator delete[](void *ptr){
+	free(ptr);
+}
+#if defined(__cpp_sized_deallocation)
+void operator delete(void *ptr, size_t){
+	free(ptr);
+}
+void operator delete[](void *ptr, size_t){
+	free(ptr);
+}
+#endif
+#endif
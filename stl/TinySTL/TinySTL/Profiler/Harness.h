@@ -0,0 +1,147 @@
+#ifndef _HARNESS_H_
+#define _HARNESS_H_
+
+#include "Profiler.h"
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace TinySTL{
+	namespace Profiler{
+		//ӲLinuxperf_event_open򿪣ƽ̨ûȨʱ
+		class HardwareCounters{
+		public:
+			enum Event{ CYCLES, INSTRUCTIONS, CACHE_MISSES, BRANCH_MISSES, EVENT_COUNT };
+		private:
+			int fds_[EVENT_COUNT];
+		public:
+			HardwareCounters();
+			~HardwareCounters();
+			HardwareCounters(const HardwareCounters&) = delete;
+			HardwareCounters& operator = (const HardwareCounters&) = delete;
+
+			bool available(Event e)const{ return fds_[e] >= 0; }
+			void start();
+			//startļõΪ-1
+			void finish(long long(&values)[EVENT_COUNT]);
+			static const char *name(Event e);
+		};
+
+		//TinySTL::alloc::allocateļֻHarnessʱ
+		//TINYSTL_COUNT_ALLOCATIONSʱHarness.cpp滻ȫֵoperator new/deletestd::ķҲ룬
+		//ӰֻӦbenchmarkĹﶨ
+		class AllocationCounter{
+		public:
+			static size_t allocations();
+			static size_t bytes();
+		};
+
+		namespace Detail{
+			extern const void *volatile optimizeSink;
+		}
+		//ñΪvalueõ˲ڴܱдֹĴ뱻Żᵽѭ
+		template<class T>
+		inline void doNotOptimize(const T& value){
+#if defined(__GNUC__)
+			asm volatile("" : : "r"(&value) : "memory");
+#else
+			Detail::optimizeSink = &value;
+			_ReadWriteBarrier();
+#endif
+		}
+
+		//һrunͳƣrepetitionsbatchƽ̯ÿεfnϵֵ
+		struct BenchResult{
+			std::string group;//ͬһĽűȽϣһΪ׼
+			std::string name;
+			size_t repetitions;
+			size_t batch;//ÿظfnĴ
+			double minNs, medianNs, meanNs, maxNs, stddevNs;
+			double counters[HardwareCounters::EVENT_COUNT];//λʱΪ-1
+			double allocations;
+			double allocatedBytes;
+		};
+
+		//׼ԵȵfnֱһظminRepMs룬Դ˾batchԤwarmupΣ
+		//ȻrepetitionsΣÿμ¼ʱ䡢Ӳͷ
+		//ÿʱӡһУͬİһΪJSON
+		class Harness{
+		private:
+			struct Sample{
+				double ns;
+				long long counters[HardwareCounters::EVENT_COUNT];
+				size_t allocations;
+				size_t bytes;
+			};
+			std::string suite_;
+			size_t warmup_;
+			size_t repetitions_;
+			double minRepMs_;
+			std::ostream *os_;
+			HardwareCounters counters_;
+			std::vector<BenchResult> results_;
+			void(*oldHook_)(size_t);
+			ProfilerInstance::TimePoint startTime_;
+			size_t startAllocations_, startBytes_;
+		public:
+			explicit Harness(const std::string& suite, size_t warmup = 2, size_t repetitions = 15,
+				double minRepMs = 1.0, std::ostream *os = &std::cout);
+			~Harness();
+			Harness(const Harness&) = delete;
+			Harness& operator = (const Harness&) = delete;
+
+			template<class Func>
+			const BenchResult& run(const std::string& group, const std::string& name, Func fn);
+
+			const std::string& suite()const{ return suite_; }
+			const std::vector<BenchResult>& results()const{ return results_; }
+			//´ӡȫ
+			void dump(std::ostream& os = std::cout)const;
+			void dumpJson(std::ostream& os)const;
+			//дļʱ׳std::runtime_error
+			void saveJson(const char *path)const;
+		private:
+			void begin();
+			Sample end();
+			const BenchResult& record(const std::string& group, const std::string& name,
+				std::vector<Sample>& samples, size_t batch);
+			void dumpLine(std::ostream& os, const BenchResult& result, const BenchResult *baseline)const;
+		};
+
+		template<class Func>
+		const BenchResult& Harness::run(const std::string& group, const std::string& name, Func fn){
+			size_t batch = 1;
+			for (;;){
+				begin();
+				for (size_t i = 0; i != batch; ++i)
+					fn();
+				double ms = end().ns / 1e6;
+				if (ms >= minRepMs_ || batch >= (size_t(1) << 24))
+					break;
+				//һηŴ16һεƫʱbatchù
+				size_t next = ms > 0 ? size_t(batch * minRepMs_ / ms) + 1 : batch * 16;
+				batch = next < batch * 16 ? next : batch * 16;
+			}
+			for (size_t r = 0; r != warmup_; ++r){
+				for (size_t i = 0; i != batch; ++i)
+					fn();
+			}
+			std::vector<Sample> samples;
+			for (size_t r = 0; r != repetitions_; ++r){
+				begin();
+				for (size_t i = 0; i != batch; ++i)
+					fn();
+				samples.push_back(end());
+			}
+			return record(group, name, samples, batch);
+		}
+	}
+}
+
+#endif
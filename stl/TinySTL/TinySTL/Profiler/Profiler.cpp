@@ -1,5 +1,8 @@
 #include "Profiler.h"
 
+#include <cstdio>
+#include <stdexcept>
+
 namespace TinySTL{
 	namespace Profiler{
 
@@ -29,28 +32,41 @@ namespace TinySTL{
 		}
 
 		size_t ProfilerInstance::memory(MemoryUnit mu){
-			size_t memory = 0;
+			size_t memory = 0;//ֽڼ
 		#ifdef WIN32
 			PROCESS_MEMORY_COUNTERS pmc;
 			HANDLE hProcess = GetCurrentProcess();
 			if (!GetProcessMemoryInfo(hProcess, &pmc, sizeof(pmc)))
 				throw std::runtime_error("GetProcessMemoryInfo failed");
 			CloseHandle(hProcess);
+			memory = pmc.WorkingSetSize;
 		#else
-			struct rusage usage;
-			if(getrusage(RUSAGE_SELF, &usage) == -1)
-				throw std::runtime_error("getrusage failed");
-			memory = usage.ru_maxrss / 1024;//ĳЩlinuxƽ̨ȫ֧getrusageru_maxrssǷ0
+			//ȶ/proc/self/statmﵱǰĳפҳʱ˻getrusageķֵ
+			long pages = 0, resident = 0;
+			FILE *fp = fopen("/proc/self/statm", "r");
+			if (fp){
+				if (fscanf(fp, "%ld %ld", &pages, &resident) != 2)
+					resident = 0;
+				fclose(fp);
+			}
+			if (resident > 0){
+				memory = size_t(resident) * size_t(sysconf(_SC_PAGESIZE));
+			}else{
+				struct rusage usage;
+				if (getrusage(RUSAGE_SELF, &usage) == -1)
+					throw std::runtime_error("getrusage failed");
+				memory = size_t(usage.ru_maxrss) * 1024;//ru_maxrssKBΪλĳЩlinuxƽ̨Ƿ0
+			}
 		#endif
 			switch (mu){
 			case MemoryUnit::KB_:
-				memory = pmc.WorkingSetSize KB;
+				memory = memory KB;
 				break;
 			case MemoryUnit::MB_:
-				memory = pmc.WorkingSetSize MB;
+				memory = memory MB;
 				break;
 			case MemoryUnit::GB_:
-				memory = pmc.WorkingSetSize GB;
+				memory = memory GB;
 				break;
 			}
 			return memory;
@@ -14,8 +14,9 @@
 #include <Psapi.h>
 #pragma comment(lib, "psapi.lib")
 #else
-#include <sys/resource>
+#include <sys/resource.h>
 #include <sys/time.h>
+#include <unistd.h>
 #endif
 
 namespace TinySTL{
@@ -0,0 +1,168 @@
+#ifndef _ROPE_H_
+#define _ROPE_H_
+
+#include "Iterator.h"
+#include "String.h"
+
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace TinySTL{
+	namespace Detail{
+		//ropeĽڵһͲ޸ģüԭӵģ̳ͬ߳еropeԹ
+		struct rope_node{
+			std::atomic<size_t> refs_;
+			size_t size_;
+			unsigned int capacity_;//ֻҶЧ
+			unsigned char depth_;//ҶΪ0
+			bool leaf_;
+		};
+		struct rope_leaf : public rope_node{
+			char data_[1];//ʵʳΪcapacity_
+		};
+		struct rope_concat : public rope_node{
+			rope_node *left_;
+			rope_node *right_;
+		};
+	}
+	class rope;
+	namespace Detail{
+		//the iterator of rope
+		//浱ǰڵҶӣ߳Ҷʱ´Ӹ
+		class rope_iter : public iterator<random_access_iterator_tag, char>{
+		private:
+			const rope *rope_;
+			size_t pos_;
+			mutable const char *leaf_;
+			mutable size_t leafBegin_;
+			mutable size_t leafEnd_;
+		public:
+			rope_iter() :rope_(0), pos_(0), leaf_(0), leafBegin_(0), leafEnd_(0){}
+			rope_iter(const rope *r, size_t pos) :rope_(r), pos_(pos), leaf_(0), leafBegin_(0), leafEnd_(0){}
+
+			char operator *()const{
+				if (pos_ < leafBegin_ || pos_ >= leafEnd_)
+					locate();
+				return leaf_[pos_ - leafBegin_];
+			}
+			char operator [](ptrdiff_t n)const{ return *(*this + n); }
+			size_t index()const{ return pos_; }
+
+			rope_iter& operator ++(){ ++pos_; return *this; }
+			rope_iter operator ++(int){ rope_iter temp = *this; ++pos_; return temp; }
+			rope_iter& operator --(){ --pos_; return *this; }
+			rope_iter operator --(int){ rope_iter temp = *this; --pos_; return temp; }
+			rope_iter& operator +=(ptrdiff_t n){ pos_ += n; return *this; }
+			rope_iter& operator -=(ptrdiff_t n){ pos_ -= n; return *this; }
+			rope_iter operator +(ptrdiff_t n)const{ rope_iter temp = *this; return temp += n; }
+			rope_iter operator -(ptrdiff_t n)const{ rope_iter temp = *this; return temp -= n; }
+			ptrdiff_t operator -(const rope_iter& it)const{ return ptrdiff_t(pos_ - it.pos_); }
+
+			bool operator ==(const rope_iter& it)const{ return rope_ == it.rope_ && pos_ == it.pos_; }
+			bool operator !=(const rope_iter& it)const{ return !(*this == it); }
+			bool operator <(const rope_iter& it)const{ return pos_ < it.pos_; }
+		private:
+			void locate()const;
+		};
+	}
+
+	//the class of rope
+	//ʺϴı༭ַO(1)insert/erase/substrO(log n)
+	//ҶͬͷǡռһڴҳռҶӿԭ׷
+	//дȳmax_depthʱFibonacciƽ(balance)
+	//޸ropeԶ߳̿ͬʱͬһrope
+	//Ҫͬʱ޸ʱÿ̳߳һݿ֮乲нڵ
+	class rope{
+		friend class Detail::rope_iter;
+	public:
+		typedef char				value_type;
+		typedef Detail::rope_iter	iterator;
+		typedef Detail::rope_iter	const_iterator;
+		typedef char				reference;
+		typedef char				const_reference;
+		typedef size_t				size_type;
+		typedef ptrdiff_t			difference_type;
+
+		static const size_t npos = -1;
+		enum { leaf_bytes = 4096 };
+		enum { max_depth = 45 };//д󳬹Ⱦƽ
+		enum { hard_max_depth = 90 };//ƽõFibonacciĴСmax_depth
+		enum { parallel_threshold = 1 << 20 };//1MBflatten/findʹö߳
+	private:
+		Detail::rope_node *root_;
+	public:
+		rope() :root_(0){}
+		rope(const char *s);
+		rope(const char *s, size_t n);
+		rope(size_t n, char c);
+		explicit rope(const string& str);
+		rope(const rope& r);
+		rope(rope&& r);
+		rope& operator = (const rope& r);
+		rope& operator = (rope&& r);
+		~rope();
+
+		size_t size()const{ return root_ ? root_->size_ : 0; }
+		size_t length()const{ return size(); }
+		bool empty()const{ return size() == 0; }
+		size_t depth()const{ return root_ ? root_->depth_ : 0; }
+
+		const_iterator begin()const{ return const_iterator(this, 0); }
+		const_iterator end()const{ return const_iterator(this, size()); }
+
+		char operator[] (size_t pos)const;
+		char at(size_t pos)const;
+		char front()const{ return (*this)[0]; }
+		char back()const{ return (*this)[size() - 1]; }
+
+		void push_back(char c){ append(&c, 1); }
+		void pop_back(){ erase(size() - 1, 1); }
+		rope& append(const char *s, size_t n);
+		rope& append(const char *s){ return append(s, strlen(s)); }
+		rope& append(const rope& r);
+		rope& operator+= (const rope& r){ return append(r); }
+		rope& operator+= (const char *s){ return append(s); }
+		rope& operator+= (char c){ push_back(c); return *this; }
+
+		rope& insert(size_t pos, const rope& r);
+		rope& insert(size_t pos, const char *s, size_t n);
+		rope& insert(size_t pos, const char *s){ return insert(pos, s, strlen(s)); }
+		rope& erase(size_t pos = 0, size_t len = npos);
+		rope substr(size_t pos = 0, size_t len = npos)const;
+
+		void clear();
+		void swap(rope& r);
+		void balance();
+
+		//[pos, pos + len)ƵbufظƵĸ
+		size_t copy(char *buf, size_t len, size_t pos = 0)const;
+		//ropeƵbuf(size()ֽ)ropeָ߳
+		void flatten(char *buf)const;
+		string str()const;
+
+		//ropeָ̲߳ңǰλ
+		size_t find(const char *s, size_t pos, size_t n)const;
+		size_t find(const char *s, size_t pos = 0)const{ return find(s, pos, strlen(s)); }
+		size_t find(const string& str, size_t pos = 0)const{ return find(str.data(), pos, str.size()); }
+		size_t find(char c, size_t pos = 0)const{ return find(&c, pos, 1); }
+
+		int compare(const rope& r)const;
+	private:
+		explicit rope(Detail::rope_node *root) :root_(root){ after_write(); }
+		void after_write(){
+			if (root_ && root_->depth_ > max_depth)
+				balance();
+		}
+		const Detail::rope_leaf *leaf_at(size_t pos, size_t& leafBegin)const;
+		size_t find_in_range(const char *s, size_t n, size_t first, size_t last)const;
+	public:
+		friend rope operator+ (const rope& lhs, const rope& rhs);
+		friend bool operator== (const rope& lhs, const rope& rhs){ return lhs.compare(rhs) == 0; }
+		friend bool operator!= (const rope& lhs, const rope& rhs){ return lhs.compare(rhs) != 0; }
+		friend bool operator< (const rope& lhs, const rope& rhs){ return lhs.compare(rhs) < 0; }
+		friend std::ostream& operator <<(std::ostream& os, const rope& r);
+	};// end of rope
+}
+#endif
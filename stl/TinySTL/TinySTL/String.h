@@ -2,7 +2,9 @@
 #define _STRING_H_
 
 #include "Allocator.h"
+#include "MemoryResource.h"
 #include "ReverseIterator.h"
+#include "StringView.h"
 #include "UninitializedFunctions.h"
 #include "Utility.h"
 
@@ -23,24 +25,52 @@ namespace TinySTL{
 		typedef const char&		const_reference;
 		typedef size_t			size_type;
 		typedef ptrdiff_t		difference_type;
+		typedef polymorphic_allocator<char> allocator_type;
 		//npos is a static member constant value with the greatest possible value for an element of type size_t.
 		static const size_t npos = -1;
 	private:
-		char *start_;
-		char *finish_;
-		char *endOfStorage_;
+		//ַŻ(SSO)ȲkShortCapacityֱַӴڶڲڴ
+		//СȻ3ָ(24ֽ)ֱʾͬһڴ棺
+		//ģʽһֽڴsize << 1(λΪ0)23ֽڴַ
+		//ģʽcap_λΪ1(С¼һֽڵλ)ģʽ
+		//ʹmemory_resourceʱռռ䣺ģʽresourceָڶ8ֽڣ
+		//ֻʣ15ַĻ壬һֽڵλΪǣģʽڶڴͷ
+		//cap_λĬϵTinySTL::alloc¼ָ
+		enum { kShortCapacity = 3 * sizeof(char *) - 1 };
+		enum { kShortResourceCapacity = kShortCapacity - sizeof(memory_resource *) };
+		enum { kShortResourceFlag = 0x80 };
+		static const size_t kLongResourceFlag = ~(~size_t(0) >> 1);
+		struct long_rep{
+			size_t cap_;
+			size_t size_;
+			char *data_;
+		};
+		struct short_rep{
+			unsigned char size_;
+			char data_[kShortCapacity];
+		};
+		union{
+			long_rep l_;
+			short_rep s_;
+		};
 
 		typedef TinySTL::allocator<char> dataAllocator;
 	public:
-		string() :start_(0), finish_(0), endOfStorage_(0){}
+		string(){ setShort(0, 0); }
+		explicit string(const allocator_type& alloc){ setShort(0, toResource(alloc)); }
 		string(const string& str);
+		string(const string& str, const allocator_type& alloc);
 		string(string&& str);
+		string(string&& str, const allocator_type& alloc);
 		string(const string& str, size_t pos, size_t len = npos);
 		string(const char* s);
+		string(const char* s, const allocator_type& alloc);
 		string(const char* s, size_t n);
+		string(const char* s, size_t n, const allocator_type& alloc);
 		string(size_t n, char c);
 		template <class InputIterator>
 		string(InputIterator first, InputIterator last);
+		explicit string(string_view sv);
 
 		string& operator= (const string& str);
 		string& operator= (string&& str);
@@ -49,42 +79,54 @@ namespace TinySTL{
 
 		~string();
 
-		iterator begin(){ return start_; }
-		const_iterator begin() const{ return start_; }
-		iterator end(){ return finish_; }
-		const_iterator end() const{ return finish_; }
-		reverse_iterator rbegin(){ return reverse_iterator(finish_); }
-		const_reverse_iterator rbegin() const{ return const_reverse_iterator(finish_); }
-		reverse_iterator rend(){ return reverse_iterator(start_); }
-		const_reverse_iterator rend() const{ return const_reverse_iterator(start_); }
-		const_iterator cbegin() const{ return start_; }
-		const_iterator cend() const{ return finish_; }
-		const_reverse_iterator crbegin() const{ return const_reverse_iterator(finish_); }
-		const_reverse_iterator crend() const{ return const_reverse_iterator(start_); }
-		size_t size() const{ return finish_ - start_; }
+		allocator_type get_allocator() const{ memory_resource *res = resource(); return allocator_type(res ? res : alloc_resource()); }
+
+		iterator begin(){ return data_start(); }
+		const_iterator begin() const{ return data_start(); }
+		iterator end(){ return data_start() + size(); }
+		const_iterator end() const{ return data_start() + size(); }
+		reverse_iterator rbegin(){ return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const{ return const_reverse_iterator(end()); }
+		reverse_iterator rend(){ return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const{ return const_reverse_iterator(begin()); }
+		const_iterator cbegin() const{ return begin(); }
+		const_iterator cend() const{ return end(); }
+		const_reverse_iterator crbegin() const{ return const_reverse_iterator(end()); }
+		const_reverse_iterator crend() const{ return const_reverse_iterator(begin()); }
+		size_t size() const{ return isLong() ? l_.size_ : ((s_.size_ & ~kShortResourceFlag) >> 1); }
 		size_t length() const{ return size(); }
-		size_t capacity() const{ return endOfStorage_ - start_; }
-		void clear(){
-			dataAllocator::destroy(start_, finish_);
-			start_ = finish_;
+		size_t capacity() const{
+			if (isLong())
+				return l_.cap_ & ~(kLongResourceFlag | 1);
+			return (s_.size_ & kShortResourceFlag) ? size_t(kShortResourceCapacity) : size_t(kShortCapacity);
 		}
-		bool empty() const{ return begin() == end(); }
+		void clear(){ setSize(0); }
+		bool empty() const{ return size() == 0; }
 		void resize(size_t n);
 		void resize(size_t n, char c);
 		void reserve(size_t n = 0);
-		void shrink_to_fit(){ 
-			dataAllocator::deallocate(finish_, endOfStorage_ - finish_); 
-			endOfStorage_ = finish_;
+		void shrink_to_fit();
+
+		const char *data() const{ return data_start(); }
+		operator string_view() const{ return string_view(data_start(), size()); }
+		string_view view(size_t pos = 0, size_t len = npos) const{
+			return string_view(*this).substr(pos, len);
 		}
 
-		char& operator[] (size_t pos){ return *(start_ + pos); }
-		const char& operator[] (size_t pos) const{ return *(start_ + pos); }
-		char& back(){ return *(finish_ - 1); }
-		const char& back() const{ return *(finish_ - 1); }
-		char& front(){ return *(start_); }
-		const char& front() const{ return *(start_); }
+		char& operator[] (size_t pos){ return *(data_start() + pos); }
+		const char& operator[] (size_t pos) const{ return *(data_start() + pos); }
+		char& back(){ return *(end() - 1); }
+		const char& back() const{ return *(end() - 1); }
+		char& front(){ return *(begin()); }
+		const char& front() const{ return *(begin()); }
 
-		void push_back(char c){ insert(end(), c); }
+		void push_back(char c){
+			size_t n = size();
+			if (n == capacity())
+				grow(n + 1);
+			data_start()[n] = c;
+			setSize(n + 1);
+		}
 		string& insert(size_t pos, const string& str);
 		string& insert(size_t pos, const string& str, size_t subpos, size_t sublen = npos);
 		string& insert(size_t pos, const char* s);
@@ -105,7 +147,7 @@ namespace TinySTL{
 		string& operator+= (const char* s);
 		string& operator+= (char c);
 
-		void pop_back(){ erase(end() - 1, end()); }
+		void pop_back(){ setSize(size() - 1); }
 		string& erase(size_t pos = 0, size_t len = npos);
 		iterator erase(iterator p);
 		iterator erase(iterator first, iterator last);
@@ -123,9 +165,10 @@ namespace TinySTL{
 		string& replace(iterator i1, iterator i2, InputIterator first, InputIterator last);
 
 		void swap(string& str){
-			TinySTL::swap(start_, str.start_);
-			TinySTL::swap(finish_, str.finish_);
-			TinySTL::swap(endOfStorage_, str.endOfStorage_);
+			//ֱʾָָ룬ֱӰֽڽɣresourceһ𽻻
+			long_rep temp = l_;
+			l_ = str.l_;
+			str.l_ = temp;
 		}
 		size_t copy(char* s, size_t len, size_t pos = 0) const{
 			auto ptr = TinySTL::uninitialized_copy(begin() + pos, begin() + pos + len, s);
@@ -136,6 +179,7 @@ namespace TinySTL{
 		size_t find(const char* s, size_t pos = 0) const;
 		size_t find(const char* s, size_t pos, size_t n) const;
 		size_t find(char c, size_t pos = 0) const;
+		size_t find(string_view sv, size_t pos = 0) const;
 		size_t rfind(const string& str, size_t pos = npos) const;
 		size_t rfind(const char* s, size_t pos = npos) const;
 		size_t rfind(const char* s, size_t pos, size_t n) const;
@@ -144,6 +188,7 @@ namespace TinySTL{
 		size_t find_first_of(const char* s, size_t pos = 0) const;
 		size_t find_first_of(const char* s, size_t pos, size_t n) const;
 		size_t find_first_of(char c, size_t pos = 0) const;
+		size_t find_first_of(string_view sv, size_t pos = 0) const;
 		size_t find_last_of(const string& str, size_t pos = npos) const;
 		size_t find_last_of(const char* s, size_t pos = npos) const;
 		size_t find_last_of(const char* s, size_t pos, size_t n) const;
@@ -170,6 +215,63 @@ namespace TinySTL{
 		int compare(size_t pos, size_t len, const char* s) const;
 		int compare(size_t pos, size_t len, const char* s, size_t n) const;
 	private:
+		bool isLong() const{ return (s_.size_ & 1) != 0; }
+		char *data_start(){ return isLong() ? l_.data_ : s_.data_; }
+		const char *data_start() const{ return isLong() ? l_.data_ : s_.data_; }
+		void setSize(size_t n){
+			if (isLong())
+				l_.size_ = n;
+			else
+				setShortSize(n);
+		}
+		//ֻڶģʽʹãresourceı
+		void setShortSize(size_t n){
+			s_.size_ = static_cast<unsigned char>((s_.size_ & kShortResourceFlag) | (n << 1));
+		}
+		void setShort(size_t n, memory_resource *res){
+			s_.size_ = static_cast<unsigned char>(n << 1);
+			if (res){
+				s_.size_ |= kShortResourceFlag;
+				memcpy(s_.data_ + kShortResourceCapacity, &res, sizeof(res));
+			}
+		}
+		void setLong(char *data, size_t n, size_t cap, memory_resource *res){
+			l_.data_ = data;
+			l_.size_ = n;
+			l_.cap_ = cap | 1 | (res ? kLongResourceFlag : 0);
+		}
+		//Ϊ0ʾʹTinySTL::alloc
+		memory_resource *resource() const{
+			memory_resource *res = 0;
+			if (isLong()){
+				if (l_.cap_ & kLongResourceFlag)
+					memcpy(&res, l_.data_ - sizeof(res), sizeof(res));
+			}
+			else if (s_.size_ & kShortResourceFlag){
+				memcpy(&res, s_.data_ + kShortResourceCapacity, sizeof(res));
+			}
+			return res;
+		}
+		static memory_resource *toResource(const allocator_type& alloc){
+			return alloc.resource() == alloc_resource() ? 0 : alloc.resource();
+		}
+		char *allocateData(size_t n, memory_resource *res){
+			if (!res)
+				return dataAllocator::allocate(n);
+			char *p = static_cast<char *>(res->allocate(n + sizeof(res), sizeof(res)));
+			memcpy(p, &res, sizeof(res));
+			return p + sizeof(res);
+		}
+		void deallocateData(char *p, size_t n, memory_resource *res){
+			if (res)
+				res->deallocate(p - sizeof(res), n + sizeof(res), sizeof(res));
+			else
+				dataAllocator::deallocate(p, n);
+		}
+		//һnַĿռ䣬ֱַʹڲ
+		char *initStorage(size_t n);
+		//䵽nԭ
+		void grow(size_t n);
 		void moveData(string& str);
 		//ʱռ䲻
 		template<class InputIterator>
@@ -185,7 +287,6 @@ namespace TinySTL{
 		void string_aux(InputIterator first, InputIterator last, std::false_type);
 		void destroyAndDeallocate();
 		size_t rfind_aux(const_iterator cit, size_t pos, size_t lengthOfS, int cond)const;
-		size_t find_aux(const_iterator cit, size_t pos, size_t lengthOfS, size_t cond)const;
 		int compare_aux(size_t pos, size_t len, const_iterator cit, size_t subpos, size_t sublen)const;
 		bool isContained(char ch, const_iterator first, const_iterator last)const;
 		size_t changeVarWhenEuqalNPOS(size_t var, size_t minuend, size_t minue)const;
@@ -220,25 +321,29 @@ namespace TinySTL{
 		friend std::istream& getline(std::istream& is, string& str);
 	};// end of string
 
+	//ַַڶڲõʱ򰴵ǰַ㣬ַָֻڴָ룬԰ֽڰᶯ
+	template<>
+	struct is_trivially_relocatable<string> : std::true_type{};
+
 	template<class InputIterator>
 	string::string(InputIterator first, InputIterator last){
+		setShort(0, 0);
 		//ָּĺ
 		string_aux(first, last, typename std::is_integral<InputIterator>::type());
 	}
 	template <class InputIterator>
 	string::iterator string::insert_aux_copy(iterator p, InputIterator first, InputIterator last){
 		size_t lengthOfInsert = last - first;
-		auto newCapacity = getNewCapacity(lengthOfInsert);
-		iterator newStart = dataAllocator::allocate(newCapacity);
-		iterator newFinish = TinySTL::uninitialized_copy(start_, p, newStart);
+		auto newCapacity = (getNewCapacity(lengthOfInsert) + 1) & ~size_t(1);
+		memory_resource *mr = resource();
+		iterator newStart = allocateData(newCapacity, mr);
+		iterator newFinish = TinySTL::uninitialized_copy(begin(), p, newStart);
 		newFinish = TinySTL::uninitialized_copy(first, last, newFinish);
 		auto res = newFinish;
-		newFinish = TinySTL::uninitialized_copy(p, finish_, newFinish);
+		newFinish = TinySTL::uninitialized_copy(p, end(), newFinish);
 
 		destroyAndDeallocate();
-		start_ = newStart;
-		finish_ = newFinish;
-		endOfStorage_ = start_ + newCapacity;
+		setLong(newStart, newFinish - newStart, newCapacity, mr);
 		return res;
 	}
 	template <class InputIterator>
@@ -246,11 +351,9 @@ namespace TinySTL{
 		auto lengthOfLeft = capacity() - size();
 		size_t lengthOfInsert = distance(first, last);
 		if (lengthOfInsert <= lengthOfLeft){
-			for (iterator it = finish_ - 1; it >= p; --it){
-				*(it + lengthOfInsert) = *(it);
-			}
+			memmove(p + lengthOfInsert, p, end() - p);
 			TinySTL::uninitialized_copy(first, last, p);
-			finish_ += lengthOfInsert;
+			setSize(size() + lengthOfInsert);
 			return (p + lengthOfInsert);
 		}
 		else{
@@ -271,9 +374,9 @@ namespace TinySTL{
 	}
 	template<class InputIterator>
 	void string::allocateAndCopy(InputIterator first, InputIterator last){
-		start_ = dataAllocator::allocate(last - first);
-		finish_ = TinySTL::uninitialized_copy(first, last, start_);
-		endOfStorage_ = finish_;
+		size_t n = last - first;
+		TinySTL::uninitialized_copy(first, last, initStorage(n));
+		setSize(n);
 	}
 	template<class InputIterator>
 	void string::string_aux(InputIterator first, InputIterator last, std::false_type){
@@ -0,0 +1,178 @@
+#ifndef _STRING_VIEW_H_
+#define _STRING_VIEW_H_
+
+#include "ReverseIterator.h"
+#include "Utility.h"
+
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace TinySTL{
+	namespace Detail{
+		//صĹ㷨stringstring_view
+		//Ƕ[s, s + size)ַңҲsize_t(-1)
+		inline size_t str_find_char(const char *s, size_t size, char c, size_t pos){
+			if (pos >= size)
+				return size_t(-1);
+			const void *res = memchr(s + pos, c, size - pos);
+			return res ? static_cast<const char *>(res) - s : size_t(-1);
+		}
+		inline size_t str_find(const char *s, size_t size, const char *p, size_t n, size_t pos){
+			if (n == 0)
+				return pos <= size ? pos : size_t(-1);
+			if (pos >= size || size - pos < n)
+				return size_t(-1);
+			//memchrλַmemcmpȽʣಿ
+			const char *cur = s + pos, *last = s + size - n + 1;
+			const char first = p[0];
+			while (cur != last){
+				cur = static_cast<const char *>(memchr(cur, first, last - cur));
+				if (cur == 0)
+					return size_t(-1);
+				if (memcmp(cur + 1, p + 1, n - 1) == 0)
+					return cur - s;
+				++cur;
+			}
+			return size_t(-1);
+		}
+		//256λַϣfind_first_of/find_first_not_ofÿַһ鼯
+		struct char_set{
+			unsigned long long bits[4];
+			char_set(const char *p, size_t n){
+				bits[0] = bits[1] = bits[2] = bits[3] = 0;
+				for (size_t i = 0; i != n; ++i){
+					unsigned char ch = static_cast<unsigned char>(p[i]);
+					bits[ch >> 6] |= 1ULL << (ch & 63);
+				}
+			}
+			bool test(char c)const{
+				unsigned char ch = static_cast<unsigned char>(c);
+				return (bits[ch >> 6] >> (ch & 63)) & 1;
+			}
+		};
+		inline size_t str_find_first_of(const char *s, size_t size, const char *p, size_t n, size_t pos){
+			if (n == 0 || pos >= size)
+				return size_t(-1);
+			if (n == 1)
+				return str_find_char(s, size, p[0], pos);
+			char_set set(p, n);
+			for (size_t i = pos; i != size; ++i){
+				if (set.test(s[i]))
+					return i;
+			}
+			return size_t(-1);
+		}
+		inline size_t str_find_first_not_of(const char *s, size_t size, const char *p, size_t n, size_t pos){
+			char_set set(p, n);
+			for (size_t i = pos; i < size; ++i){
+				if (!set.test(s[i]))
+					return i;
+			}
+			return size_t(-1);
+		}
+		inline int str_compare(const char *s1, size_t n1, const char *s2, size_t n2){
+			size_t len = n1 < n2 ? n1 : n2;
+			int res = len ? memcmp(s1, s2, len) : 0;
+			if (res != 0)
+				return res < 0 ? -1 : 1;
+			return n1 == n2 ? 0 : (n1 < n2 ? -1 : 1);
+		}
+	}
+
+	//the class of string_view
+	//ӵڴַֻƬΣsubstr/findڴ
+	//Ҫ֤õַstring_viewЧ
+	class string_view{
+	public:
+		typedef char			value_type;
+		typedef const char *	iterator;
+		typedef const char *	const_iterator;
+		typedef reverse_iterator_t<const char*> reverse_iterator;
+		typedef reverse_iterator_t<const char*> const_reverse_iterator;
+		typedef const char&		reference;
+		typedef const char&		const_reference;
+		typedef size_t			size_type;
+		typedef ptrdiff_t		difference_type;
+		static const size_t npos = -1;
+	private:
+		const char *data_;
+		size_t size_;
+	public:
+		string_view() :data_(0), size_(0){}
+		string_view(const char *s) :data_(s), size_(strlen(s)){}
+		string_view(const char *s, size_t n) :data_(s), size_(n){}
+
+		const_iterator begin() const{ return data_; }
+		const_iterator end() const{ return data_ + size_; }
+		const_iterator cbegin() const{ return data_; }
+		const_iterator cend() const{ return data_ + size_; }
+		const_reverse_iterator rbegin() const{ return const_reverse_iterator(end()); }
+		const_reverse_iterator rend() const{ return const_reverse_iterator(begin()); }
+
+		size_t size() const{ return size_; }
+		size_t length() const{ return size_; }
+		bool empty() const{ return size_ == 0; }
+		const char *data() const{ return data_; }
+
+		const char& operator[] (size_t pos) const{ return data_[pos]; }
+		const char& front() const{ return data_[0]; }
+		const char& back() const{ return data_[size_ - 1]; }
+
+		void remove_prefix(size_t n){ data_ += n; size_ -= n; }
+		void remove_suffix(size_t n){ size_ -= n; }
+		void swap(string_view& sv){
+			TinySTL::swap(data_, sv.data_);
+			TinySTL::swap(size_, sv.size_);
+		}
+
+		string_view substr(size_t pos = 0, size_t len = npos) const{
+			if (pos > size_)
+				throw std::out_of_range("string_view::substr");
+			if (len > size_ - pos)
+				len = size_ - pos;
+			return string_view(data_ + pos, len);
+		}
+
+		size_t find(string_view sv, size_t pos = 0) const{
+			return Detail::str_find(data_, size_, sv.data_, sv.size_, pos);
+		}
+		size_t find(char c, size_t pos = 0) const{
+			return Detail::str_find_char(data_, size_, c, pos);
+		}
+		size_t find(const char *s, size_t pos, size_t n) const{
+			return Detail::str_find(data_, size_, s, n, pos);
+		}
+		size_t find_first_of(string_view sv, size_t pos = 0) const{
+			return Detail::str_find_first_of(data_, size_, sv.data_, sv.size_, pos);
+		}
+		size_t find_first_of(char c, size_t pos = 0) const{
+			return find(c, pos);
+		}
+		size_t find_first_not_of(string_view sv, size_t pos = 0) const{
+			return Detail::str_find_first_not_of(data_, size_, sv.data_, sv.size_, pos);
+		}
+
+		int compare(string_view sv) const{
+			return Detail::str_compare(data_, size_, sv.data_, sv.size_);
+		}
+		bool starts_with(string_view sv) const{
+			return size_ >= sv.size_ && memcmp(data_, sv.data_, sv.size_) == 0;
+		}
+	public:
+		friend bool operator== (string_view lhs, string_view rhs){
+			return lhs.size_ == rhs.size_ && lhs.compare(rhs) == 0;
+		}
+		friend bool operator!= (string_view lhs, string_view rhs){ return !(lhs == rhs); }
+		friend bool operator<  (string_view lhs, string_view rhs){ return lhs.compare(rhs) < 0; }
+		friend bool operator<= (string_view lhs, string_view rhs){ return lhs.compare(rhs) <= 0; }
+		friend bool operator>  (string_view lhs, string_view rhs){ return lhs.compare(rhs) > 0; }
+		friend bool operator>= (string_view lhs, string_view rhs){ return lhs.compare(rhs) >= 0; }
+		friend std::ostream& operator <<(std::ostream& os, string_view sv){
+			os.write(sv.data_, sv.size_);
+			return os;
+		}
+	};// end of string_view
+}
+
+#endif
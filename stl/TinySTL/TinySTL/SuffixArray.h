@@ -1,13 +1,193 @@
 #ifndef _SUFFIX_ARRAY_H_
 #define _SUFFIX_ARRAY_H_
 
+#include "Detail\MappedFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
 namespace TinySTL{
+	namespace Detail{
+		enum { sa_parallel_threshold = 1 << 20 };//1MԪʱrankheightʹö߳
+
+		//ַҪת޷charд127ַɸ
+		inline size_t sa_symbol(char c){ return static_cast<unsigned char>(c); }
+		inline size_t sa_symbol(signed char c){ return static_cast<unsigned char>(c); }
+		inline size_t sa_symbol(unsigned char c){ return c; }
+		template<class T>
+		size_t sa_symbol(const T& c){ return static_cast<size_t>(c); }
+
+		//0ıԭеÿַ1ĩβزһ0ΪڱҪԭ
+		template<class InputIterator, class Index>
+		struct sa_text{
+			InputIterator arr_;
+			Index len_;
+			sa_text(InputIterator arr, Index len) :arr_(arr), len_(len){}
+			Index operator [](Index i)const{ return i == len_ ? 0 : Index(sa_symbol(arr_[i])) + 1; }
+		};
+		//ݹĸıʹSAĺ벿
+		template<class Index>
+		struct sa_reduced_text{
+			const Index *s_;
+			explicit sa_reduced_text(const Index *s) :s_(s){}
+			Index operator [](Index i)const{ return s_[i]; }
+		};
+
+		//endΪtrueʱbkt[c]ͰcβλãͰcĿʼλ
+		template<class Index, class Text>
+		void sa_buckets(const Text& s, Index n, std::vector<Index>& bkt, bool end){
+			std::fill(bkt.begin(), bkt.end(), Index(0));
+			for (Index i = 0; i != n; ++i)
+				++bkt[s[i]];
+			Index sum = 0;
+			for (size_t i = 0; i != bkt.size(); ++i){
+				sum += bkt[i];
+				bkt[i] = end ? sum : sum - bkt[i];
+			}
+		}
+		//ѾźõLMS׺յLͺ׺()յSͺ׺()
+		template<class Index, class Text>
+		void sa_induce(const Text& s, Index *SA, Index n, const std::vector<bool>& t, std::vector<Index>& bkt){
+			sa_buckets(s, n, bkt, false);
+			for (Index i = 0; i != n; ++i){
+				Index j = SA[i] - 1;
+				if (j >= 0 && !t[j])
+					SA[bkt[s[j]]++] = j;
+			}
+			sa_buckets(s, n, bkt, true);
+			for (Index i = n; i-- != 0;){
+				Index j = SA[i] - 1;
+				if (j >= 0 && t[j])
+					SA[--bkt[s[j]]] = j;
+			}
+		}
+		//SA-IS(Nong, Zhang & Chan 2009)ʱ临ӶO(n)
+		//s[n - 1]ΨһСַַȡֵΧ[0, K]
+		//ֱӷSASA[0, n1)һSASA[n - n1, n)һı
+		template<class Index, class Text>
+		void sais(const Text& s, Index *SA, Index n, Index K){
+			std::vector<bool> t(n);//trueΪSͣfalseΪL
+			t[n - 1] = true;
+			if (n >= 2)
+				t[n - 2] = false;
+			for (Index i = n - 3; i >= 0; --i)
+				t[i] = s[i] < s[i + 1] || (s[i] == s[i + 1] && t[i + 1]);
+			auto isLMS = [&t](Index i){ return i > 0 && t[i] && !t[i - 1]; };
+
+			//һLMSӴ
+			std::vector<Index> bkt(K + 1);
+			sa_buckets(s, n, bkt, true);
+			std::fill(SA, SA + n, Index(-1));
+			for (Index i = 1; i < n; ++i){
+				if (isLMS(i))
+					SA[--bkt[s[i]]] = i;
+			}
+			sa_induce(s, SA, n, t, bkt);
+
+			//źõLMSӴƵSAǰn1λãٸ
+			Index n1 = 0;
+			for (Index i = 0; i < n; ++i){
+				if (isLMS(SA[i]))
+					SA[n1++] = SA[i];
+			}
+			std::fill(SA + n1, SA + n, Index(-1));
+			Index name = 0, prev = -1;
+			for (Index i = 0; i < n1; ++i){
+				Index pos = SA[i];
+				bool diff = false;
+				for (Index d = 0; d < n; ++d){
+					if (prev == -1 || s[pos + d] != s[prev + d] || t[pos + d] != t[prev + d]){
+						diff = true;
+						break;
+					}
+					else if (d > 0 && (isLMS(pos + d) || isLMS(prev + d))){
+						break;
+					}
+				}
+				if (diff){
+					++name;
+					prev = pos;
+				}
+				SA[n1 + pos / 2] = name - 1;//LMSľΪ2pos / 2ͻ
+			}
+			for (Index i = n - 1, j = n - 1; i >= n1; --i){
+				if (SA[i] >= 0)
+					SA[j--] = SA[i];
+			}
+
+			//ڶظʱݹ⣬ݹǰͷͰ
+			Index *SA1 = SA, *s1 = SA + n - n1;
+			std::vector<Index>().swap(bkt);
+			if (name < n1){
+				sais(sa_reduced_text<Index>(s1), SA1, n1, name - 1);
+			}
+			else{
+				for (Index i = 0; i < n1; ++i)
+					SA1[s1[i]] = i;
+			}
+
+			//LMS׺˳յSA
+			bkt.resize(K + 1);
+			sa_buckets(s, n, bkt, true);
+			for (Index i = 1, j = 0; i < n; ++i){
+				if (isLMS(i))
+					s1[j++] = i;
+			}
+			for (Index i = 0; i < n1; ++i)
+				SA1[i] = s1[SA1[i]];
+			std::fill(SA + n1, SA + n, Index(-1));
+			for (Index i = n1 - 1; i >= 0; --i){
+				Index j = SA[i];
+				SA[i] = -1;
+				SA[--bkt[s[j]]] = j;
+			}
+			sa_induce(s, SA, n, t, bkt);
+		}
+
+		//[0, n)гɶν̣߳fn(first, last)һ
+		template<class Fn>
+		void sa_parallel_for(size_t n, bool parallel, Fn fn){
+			unsigned threads = std::thread::hardware_concurrency();
+			if (!parallel || n < sa_parallel_threshold || threads < 2){
+				fn(size_t(0), n);
+				return;
+			}
+			size_t step = (n + threads - 1) / threads;
+			std::vector<std::thread> workers;
+			for (size_t first = 0; first < n; first += step){
+				size_t last = (n - first < step ? n : first + step);
+				workers.push_back(std::thread([=]{ fn(first, last); }));
+			}
+			for (size_t i = 0; i != workers.size(); ++i)
+				workers[i].join();
+		}
+
+		//̸ʽļͷ֮suffix array(size_)height array(size_ - 1)rank array(ѡsize_)
+		//ÿԪضindexSize_ֽڵıֽ
+		struct sa_file_header{
+			char magic_[8];
+			unsigned int version_;
+			unsigned int indexSize_;
+			unsigned long long size_;
+			unsigned long long flags_;
+		};
+		enum { sa_file_has_rank = 1 };
+		void sa_init_header(sa_file_header& header, size_t indexSize, size_t size, bool withRank);
+	}
 
-	class suffix_array{
+	//the class of basic_suffix_array
+	//IndexзintԴС2Gııʹlong long
+	template<class Index>
+	class basic_suffix_array{
+		static_assert(std::is_signed<Index>::value, "the index type of suffix_array must be signed");
 	public:
-		using array_type = std::vector < int > ;
+		using array_type = std::vector < Index > ;
+		enum { parallel_threshold = Detail::sa_parallel_threshold };
 	private:
 		array_type _suffix_array;
 		array_type _height_array;
@@ -16,86 +196,140 @@ namespace TinySTL{
 		template<class InputIterator>
 		//arr - Դ
 		//len - Դ鳤
-		//max_len - max_lenַarrַȡֵΧǻһԭжĸԿֱȡ256
-		suffix_array(const InputIterator arr, size_t len, size_t max_len = 256){
-			if (max_len > 256)
-				throw std::exception("out of the range");
+		//max_len - ַȡֵΧ[0, max_len)ĸֱȡ256ҲǸĸ
+		//parallel - ıʱö̼߳rank arrayheight array
+		basic_suffix_array(const InputIterator arr, size_t len, size_t max_len = 256, bool parallel = true){
+			if (len >= size_t((std::numeric_limits<Index>::max)()) || max_len >= size_t((std::numeric_limits<Index>::max)()))
+				throw std::length_error("suffix_array: the text is too long for the index type");
+			for (size_t i = 0; i != len; ++i){
+				if (Detail::sa_symbol(arr[i]) >= max_len)
+					throw std::out_of_range("suffix_array: symbol out of the range");
+			}
 			calSuffix(arr, len, max_len);
-			calRank();
-			calHeight(arr, len);
+			calRank(parallel);
+			calHeight(arr, len, parallel);
 		}
 
-		array_type suffixArray()const{ return _suffix_array; }
-		array_type heightArray()const{ return _height_array; }
-		array_type rankArray()const{ return _rank_array; }
+		const array_type& suffixArray()const{ return _suffix_array; }
+		//heightArray()[i]ǵi͵i + 1Сĺ׺ǰ׺
+		const array_type& heightArray()const{ return _height_array; }
+		const array_type& rankArray()const{ return _rank_array; }
+
+		//mapped_suffix_arrayֱӳļʧʱ׳std::runtime_error
+		void save(const char *path, bool withRank = false)const;
 	private:
-		template<class InputIteraotr>
-		bool cmp(const InputIteraotr arr, size_t a, size_t b, size_t l);
-		void calRank(){
-			_rank_array.resize(_suffix_array.size());
-			for (auto i = 0; i != _suffix_array.size(); ++i){
-				_rank_array[_suffix_array[i]] = i;
-			}
-		}
 		template<class InputIterator>
 		void calSuffix(const InputIterator arr, size_t len, size_t max_len);
-		template<class InputIteraotr>
-		void calHeight(const InputIteraotr arr, size_t len);
+		void calRank(bool parallel);
+		template<class InputIterator>
+		void calHeight(const InputIterator arr, size_t len, bool parallel);
+		static bool writeArray(std::FILE *fp, const array_type& arr){
+			return arr.empty() || std::fwrite(&arr[0], sizeof(Index), arr.size(), fp) == arr.size();
+		}
 	};
+	typedef basic_suffix_array<int> suffix_array;
+	typedef basic_suffix_array<long long> suffix_array64;
 
-	template<class InputIteraotr>
-	bool suffix_array::cmp(const InputIteraotr arr, size_t a, size_t b, size_t l){
-		return arr[a] == arr[b] && arr[a + l] == arr[b + l];
+	template<class Index>
+	template<class InputIterator>
+	void basic_suffix_array<Index>::calSuffix(const InputIterator arr, size_t len, size_t max_len){
+		//ǰеı㷨ֻܴ256ַڵıSA-IS
+		//һλڱСĺ׺ȥ
+		if (len == 0)
+			return;
+		_suffix_array.assign(len + 1, 0);
+		Detail::sais(Detail::sa_text<InputIterator, Index>(arr, Index(len)), &_suffix_array[0], Index(len + 1), Index(max_len));
+		_suffix_array.erase(_suffix_array.begin());
 	}
-	template<class InputIteraotr>
-	void suffix_array::calHeight(const InputIteraotr arr, size_t len){
-		_height_array.resize(_suffix_array.size() - 1);
-		for (auto i = 0; i != _suffix_array.size() - 1; ++i){
-			auto n = 0;
-			for (auto j = _suffix_array[i], k = _suffix_array[i + 1];
-				arr[j] == arr[k] && (arr + j) != (arr + len) && (arr + k) != (arr + len);
-				++j, ++k)
-				++n;
-			_height_array[i] = n;
-		}
+	template<class Index>
+	void basic_suffix_array<Index>::calRank(bool parallel){
+		_rank_array.resize(_suffix_array.size());
+		Index *rank = _rank_array.empty() ? 0 : &_rank_array[0];
+		const Index *sa = _suffix_array.empty() ? 0 : &_suffix_array[0];
+		Detail::sa_parallel_for(_suffix_array.size(), parallel, [rank, sa](size_t first, size_t last){
+			for (size_t i = first; i != last; ++i)
+				rank[sa[i]] = Index(i);
+		});
 	}
+	template<class Index>
 	template<class InputIterator>
-	void suffix_array::calSuffix(const InputIterator arr, size_t len, size_t max_len){
-		//ʵֵı㷨
-		//㷨ʱ临Ӷ = O(nlg(n))
-		_suffix_array.resize(len);
-		int wa[256], wb[256], wv[256], ws[256];
-		int i, j, p, *x = wa, *y = wb, *t;
-
-		//дǰѸַҲΪ1ַл
-		for (i = 0; i < max_len; i++) ws[i] = 0;
-		//x[]汾Ǳ׺rankֵģﲢûȥ洢rankֵΪֻ漰x[]ıȽϹһԲô洢ʵrankֵܹӳԵĴСɡ
-		for (i = 0; i < len; i++) ws[x[i] = arr[i]]++;
-		for (i = 1; i < max_len; i++) ws[i] += ws[i - 1];
-		//i֮Դlen-1ʼѭΪ˱֤ڵַȵַʱĬϿǰַСһЩ
-		for (i = len - 1; i >= 0; i--) _suffix_array[--ws[x[i]]] = i;
-
-		//ѭprankֵõַpﵽlenôַĴСϵѾˡ
-		//jǰϲַĳȣÿνΪjַϲһΪ2*jַȻַĩβֵӦۣ˼һġ
-		//max_lenͬԪصȡֵΧ
-		for (j = 1, p = 1; p < len; j *= 2, max_len = p){
-			//дʵ˶Եڶؼֵ
-			for (p = 0, i = len - j; i < len; i++) y[p++] = i;
-			for (i = 0; i < len; i++) if (_suffix_array[i] >= j) y[p++] = _suffix_array[i] - j;
-			//ڶؼֻɺy[]ŵǰڶؼַ±
-			//൱ȡÿַĵһؼ֣ǰ˵x[]ǱrankֵģҲַĵһؼ֣ŵwv[]Ƿʹ
-			//дǰһؼֽеĻ
-			for (i = 0; i < len; i++) wv[i] = x[y[i]];
-			for (i = 0; i < max_len; i++) ws[i] = 0;
-			for (i = 0; i < len; i++) ws[wv[i]]++;
-			for (i = 1; i < max_len; i++) ws[i] += ws[i - 1];
-			for (i = len - 1; i >= 0; i--) _suffix_array[--ws[wv[i]]] = y[i];
-			//оǼϲ֮rankֵˣϲ֮rankֵӦôx[]棬ǼʱֱõһrankֵҲx[]ŵĶҼҪx[]ãҪx[]ţô죿
-			//ȻȰx[]Ķŵһ棬ʡˡýָķʽЧʵ˽x[]Ķơy[]С
-			for (t = x, x = y, y = t, p = 1, x[_suffix_array[0]] = 0, i = 1; i < len; i++)
-				x[_suffix_array[i]] = cmp(y, _suffix_array[i - 1], _suffix_array[i], j) ? p - 1 : p++;
-		}
+	void basic_suffix_array<Index>::calHeight(const InputIterator arr, size_t len, bool parallel){
+		//Kasai㷨ԭĵ˳㣬׺iĽǺ׺i - 1Ľ1O(n)
+		//߳ʱÿ̸߳ԭĵһΣÿδ0ʼֻڶεı߽紦ʧһ
+		if (len == 0)
+			return;
+		_height_array.resize(len - 1);
+		Index *height = _height_array.empty() ? 0 : &_height_array[0];
+		const Index *sa = &_suffix_array[0], *rank = &_rank_array[0];
+		Detail::sa_parallel_for(len, parallel, [=](size_t first, size_t last){
+			size_t h = 0;
+			for (size_t i = first; i != last; ++i){
+				size_t r = rank[i];
+				if (r + 1 == len){
+					h = 0;
+					continue;
+				}
+				size_t j = sa[r + 1];
+				while (i + h != len && j + h != len && arr[i + h] == arr[j + h])
+					++h;
+				height[r] = Index(h);
+				if (h != 0)
+					--h;
+			}
+		});
+	}
+	template<class Index>
+	void basic_suffix_array<Index>::save(const char *path, bool withRank)const{
+		std::FILE *fp = std::fopen(path, "wb");
+		if (!fp)
+			throw std::runtime_error("suffix_array::save: cannot open the file");
+		Detail::sa_file_header header;
+		Detail::sa_init_header(header, sizeof(Index), _suffix_array.size(), withRank);
+		bool ok = std::fwrite(&header, sizeof(header), 1, fp) == 1 &&
+			writeArray(fp, _suffix_array) && writeArray(fp, _height_array) &&
+			(!withRank || writeArray(fp, _rank_array));
+		ok = (std::fclose(fp) == 0) && ok;
+		if (!ok)
+			throw std::runtime_error("suffix_array::save: write failed");
 	}
+
+	//the class of mapped_suffix_array
+	//basic_suffix_array::saveļӳ䵽ڴֻʣҪļ
+	class mapped_suffix_array{
+	private:
+		Detail::mapped_file file_;
+		const Detail::sa_file_header *header_;
+		const char *suffix_;
+		const char *height_;
+		const char *rank_;
+	public:
+		explicit mapped_suffix_array(const char *path);
+		mapped_suffix_array(const mapped_suffix_array&) = delete;
+		mapped_suffix_array& operator = (const mapped_suffix_array&) = delete;
+
+		size_t size()const{ return size_t(header_->size_); }
+		size_t index_size()const{ return header_->indexSize_; }
+		bool has_rank()const{ return rank_ != 0; }
+
+		long long suffix(size_t i)const{ return get(suffix_, i); }
+		long long height(size_t i)const{ return get(height_, i); }
+		long long rank(size_t i)const;
+
+		//ֱȡ飬IndexĴСļеһ
+		template<class Index>
+		const Index *suffix_data()const{ return static_cast<const Index *>(data(suffix_, sizeof(Index))); }
+		template<class Index>
+		const Index *height_data()const{ return static_cast<const Index *>(data(height_, sizeof(Index))); }
+		template<class Index>
+		const Index *rank_data()const{ return static_cast<const Index *>(data(rank_, sizeof(Index))); }
+	private:
+		long long get(const char *arr, size_t i)const{
+			if (header_->indexSize_ == sizeof(int))
+				return reinterpret_cast<const int *>(arr)[i];
+			return reinterpret_cast<const long long *>(arr)[i];
+		}
+		const void *data(const char *arr, size_t indexSize)const;
+	};
 }
 
-#endif
\ No newline at end of file
+#endif
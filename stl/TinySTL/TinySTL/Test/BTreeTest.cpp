@@ -0,0 +1,149 @@
+#include "BTreeTest.h"
+
+namespace TinySTL{
+	namespace BTreeTest{
+		void testCase1(){
+			stdSet<int> s1;
+			tsSet<int> s2;
+			assert(s2.empty() && s2.begin() == s2.end());
+			srand(1);
+			for (int i = 0; i != 20000; ++i){
+				int val = rand() % 10000;
+				assert(s1.insert(val).second == s2.insert(val).second);
+			}
+			assert(s1.size() == s2.size());
+			assert(TinySTL::Test::container_equal(s1, s2));
+			for (int i = -10; i != 10010; ++i)
+				assert(s1.count(i) == s2.count(i));
+		}
+		void testCase2(){
+			tsMap<std::string, int> m;
+			m["one"] = 1;
+			m["two"] = 2;
+			m["three"] = 3;
+			++m["one"];
+			assert(m.size() == 3);
+			assert(m.at("one") == 2 && m["two"] == 2 && m.find("three")->second == 3);
+			assert(m.find("four") == m.end());
+
+			bool thrown = false;
+			try{
+				m.at("four");
+			}
+			catch (std::out_of_range&){
+				thrown = true;
+			}
+			assert(thrown);
+
+			auto res = m.insert(TinySTL::pair<const std::string, int>("two", 22));
+			assert(!res.second && res.first->second == 2);
+		}
+		void testCase3(){
+			stdSet<int> s1;
+			tsSet<int> s2;
+			for (int i = 0; i != 50000; ++i){
+				s1.insert(i * 7 % 50000);
+				s2.insert(i * 7 % 50000);
+			}
+			srand(2);
+			for (int i = 0; i != 60000; ++i){
+				int val = rand() % 50000;
+				assert(s1.erase(val) == s2.erase(val));
+				if (i % 5000 == 0)
+					assert(TinySTL::Test::container_equal(s1, s2));
+			}
+			assert(TinySTL::Test::container_equal(s1, s2));
+
+			for (int i = 0; i != 50000; ++i)
+				s2.erase(i);
+			assert(s2.empty() && s2.begin() == s2.end() && s2.height() == 0);
+			s2.insert(42);
+			assert(*s2.begin() == 42 && s2.size() == 1);
+		}
+		void testCase4(){
+			stdSet<int> s1;
+			tsSet<int> s2;
+			for (int i = 0; i != 3000; ++i){
+				s1.insert(i * 3);
+				s2.insert(i * 3);
+			}
+			for (int i = -5; i != 9010; ++i){
+				auto it1 = s1.lower_bound(i);
+				auto it2 = s2.lower_bound(i);
+				assert((it1 == s1.end()) == (it2 == s2.end()));
+				if (it1 != s1.end())
+					assert(*it1 == *it2);
+				auto it3 = s1.upper_bound(i);
+				auto it4 = s2.upper_bound(i);
+				assert((it3 == s1.end()) == (it4 == s2.end()));
+				if (it3 != s1.end())
+					assert(*it3 == *it4);
+			}
+			//
+			auto it1 = s1.end();
+			auto it2 = s2.end();
+			while (it1 != s1.begin()){
+				--it1, --it2;
+				assert(*it1 == *it2);
+			}
+			assert(it2 == s2.begin());
+		}
+		void testCase5(){
+			std::vector<int> v;
+			for (int i = 0; i != 100000; ++i)
+				v.push_back(i * 2);
+			tsSet<int> s;
+			s.bulk_load(v.begin(), v.end());
+			assert(s.size() == v.size());
+			assert(TinySTL::Test::container_equal(s, v));
+			assert(s.height() <= 4);
+
+			//֮ճɾ
+			for (int i = 0; i != 100000; ++i)
+				s.insert(i * 2 + 1);
+			for (int i = 0; i < 200000; i += 3)
+				s.erase(i);
+			stdSet<int> std_s;
+			for (int i = 0; i != 200000; ++i){
+				if (i % 3 != 0)
+					std_s.insert(i);
+			}
+			assert(TinySTL::Test::container_equal(s, std_s));
+
+			std::vector<int> one(1, 7);
+			s.bulk_load(one.begin(), one.end());
+			assert(s.size() == 1 && *s.begin() == 7);
+		}
+		void testCase6(){
+			stdMap<std::string, std::string> m1;
+			tsMap<std::string, std::string> m2;
+			for (int i = 0; i != 5000; ++i){
+				std::string key = "key" + std::to_string(i * 37 % 5000);
+				m1[key] = key + "-value";
+				m2[key] = key + "-value";
+			}
+			auto m3 = m2;
+			auto m4(std::move(m2));
+			assert(m2.empty());
+			for (int i = 0; i != 5000; i += 2)
+				m3.erase("key" + std::to_string(i));
+			assert(m3.size() == 2500 && m4.size() == 5000);
+
+			auto it1 = m1.begin();
+			auto it2 = m4.begin();
+			for (; it1 != m1.end(); ++it1, ++it2)
+				assert(it1->first == it2->first && it1->second == it2->second);
+			assert(it2 == m4.end());
+		}
+
+
+		void testAllCases(){
+			testCase1();
+			testCase2();
+			testCase3();
+			testCase4();
+			testCase5();
+			testCase6();
+		}
+	}
+}
@@ -0,0 +1,37 @@
+#ifndef _BTREE_TEST_H_
+#define _BTREE_TEST_H_
+
+#include "TestUtil.h"
+
+#include "../BTree.h"
+
+#include <cassert>
+#include <cstdlib>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace TinySTL{
+	namespace BTreeTest{
+		template<class T>
+		using stdSet = std::set < T > ;
+		template<class T>
+		using tsSet = TinySTL::btree_set < T > ;
+		template<class K, class V>
+		using stdMap = std::map < K, V > ;
+		template<class K, class V>
+		using tsMap = TinySTL::btree_map < K, V > ;
+
+		void testCase1();
+		void testCase2();
+		void testCase3();
+		void testCase4();
+		void testCase5();
+		void testCase6();
+
+		void testAllCases();
+	}
+}
+
+#endif
@@ -76,6 +76,182 @@ namespace TinySTL{
 			bt.set(0); bt.set(2); bt.set(4); bt.set(6);
 			assert(bt.to_string() == TinySTL::string("10101010"));
 		}
+		void testCase8(){
+			bitmap<1000> bt;
+			assert(bt.size() == 1000);
+			assert(bt.find_first() == bt.size());
+
+			bt.flip();
+			assert(bt.count() == 1000);
+			assert(bt.all());
+			bt.reset(999);
+			assert(!bt.all());
+			assert(bt.count() == 999);
+
+			bt.reset();
+			bt.set(3); bt.set(64); bt.set(700); bt.set(999);
+			std::vector<size_t> pos;
+			for (size_t i = bt.find_first(); i != bt.size(); i = bt.find_next(i))
+				pos.push_back(i);
+			std::vector<size_t> expected = { 3, 64, 700, 999 };
+			assert(pos == expected);
+			assert(bt.find_next(999) == bt.size());
+
+			bitmap<1000> copy(bt);
+			assert(copy == bt);
+			copy.flip(64);
+			assert(copy != bt);
+			copy = bt;
+			assert(copy == bt);
+		}
+		void testCase9(){
+			bitmap<300> bt1, bt2;
+			for (size_t i = 0; i < 300; i += 2) bt1.set(i);
+			for (size_t i = 0; i < 300; i += 3) bt2.set(i);
+
+			auto a = bt1 & bt2, o = bt1 | bt2, x = bt1 ^ bt2;
+			bitmap<300> d(bt1);
+			d.and_not(bt2);
+			for (size_t i = 0; i != 300; ++i){
+				bool b1 = i % 2 == 0, b2 = i % 3 == 0;
+				assert(a.test(i) == (b1 && b2));
+				assert(o.test(i) == (b1 || b2));
+				assert(x.test(i) == (b1 != b2));
+				assert(d.test(i) == (b1 && !b2));
+			}
+			assert(a.count() == 50);
+			assert((~bt1).count() == bt1.size() - 150);
+			assert((bt1 ^ bt1).none());
+		}
+		void testCase10(){
+			dynamic_bitmap bm;
+			assert(bm.empty());
+			for (size_t i = 0; i != 130; ++i)
+				bm.push_back(i % 5 == 0);
+			assert(bm.size() == 130);
+			assert(bm.count() == 26);
+			assert(bm.test(125) && !bm.test(126));
+			assert(bm.find_first() == 0 && bm.find_next(0) == 5 && bm.find_next(125) == bm.size());
+
+			bm.resize(200, true);
+			assert(bm.count() == 26 + 70);
+			assert(bm.test(130) && bm.test(199));
+			bm.resize(64);
+			assert(bm.count() == 13);
+			bm.flip();
+			assert(bm.count() == 51);
+			bm.set();
+			assert(bm.all() && bm.count() == 64);
+			assert(bm.to_string() == TinySTL::string(64, '1'));
+
+			dynamic_bitmap bm2(10, true);
+			assert(bm2.count() == 10);
+			bm2.reset(0).flip(9);
+			assert(bm2.to_string() == TinySTL::string("0111111110"));
+
+			bool thrown = false;
+			try{ bm2.test(10); }
+			catch (std::out_of_range&){ thrown = true; }
+			assert(thrown);
+		}
+		void testCase11(){
+			dynamic_bitmap bm1(1000), bm2(1000);
+			for (size_t i = 0; i < 1000; i += 7) bm1.set(i);
+			for (size_t i = 0; i < 1000; i += 11) bm2.set(i);
+
+			auto a = bm1 & bm2, o = bm1 | bm2, x = bm1 ^ bm2;
+			dynamic_bitmap d(bm1);
+			d.and_not(bm2);
+			for (size_t i = 0; i != 1000; ++i){
+				bool b1 = i % 7 == 0, b2 = i % 11 == 0;
+				assert(a.test(i) == (b1 && b2));
+				assert(o.test(i) == (b1 || b2));
+				assert(x.test(i) == (b1 != b2));
+				assert(d.test(i) == (b1 && !b2));
+			}
+			assert((~bm1).count() == 1000 - bm1.count());
+
+			dynamic_bitmap moved(std::move(bm1));
+			assert(bm1.empty() && moved.size() == 1000);
+
+			bool thrown = false;
+			try{ moved &= dynamic_bitmap(999); }
+			catch (std::invalid_argument&){ thrown = true; }
+			assert(thrown);
+		}
+		void testCase12(){
+			roaring_bitmap rb;
+			assert(rb.empty() && rb.begin() == rb.end());
+			assert(rb.insert(8));
+			assert(!rb.insert(8));
+			assert(rb.insert(0xffffffff));
+			assert(rb.insert(70000));
+			assert(rb.contains(70000) && !rb.contains(70001));
+			std::vector<uint32_t> expected = { 8, 70000, 0xffffffff };
+			assert(TinySTL::Test::container_equal(rb, expected));
+
+			//4096Ԫغתλͼɾ4096ʱת
+			assert(rb.bytes() < 1024);
+			for (uint32_t i = 0; i != 5000; ++i)
+				rb.insert(i * 2);
+			assert(rb.size() == 5000 + 2);
+			assert(rb.bytes() >= 8192);
+			for (uint32_t i = 0; i != 5000; ++i)
+				assert(rb.contains(i * 2) && !rb.contains(i * 2 + 1));
+			for (uint32_t i = 4096; i != 5000; ++i)
+				assert(rb.erase(i * 2));
+			assert(!rb.erase(1));
+			assert(rb.size() == 4096 + 2);
+			std::set<uint32_t> ref(rb.begin(), rb.end());
+			assert(ref.size() == rb.size());
+			assert(TinySTL::Test::container_equal(rb, ref));
+
+			assert(rb.erase(0xffffffff));
+			assert(!rb.contains(0xffffffff));
+			rb.clear();
+			assert(rb.empty() && rb.size() == 0);
+		}
+		void testCase13(){
+			//ÿͰܶȲͬ顢λͼ֮ĸ
+			std::set<uint32_t> s1, s2;
+			srand(13);
+			for (uint32_t bucket = 0; bucket != 6; ++bucket){
+				int mod1 = bucket % 2 ? 2 : 50, mod2 = bucket % 3 ? 3 : 40;
+				for (uint32_t low = 0; low != 65536; ++low){
+					uint32_t v = (bucket << 16) | low;
+					if (rand() % mod1 == 0) s1.insert(v);
+					if (bucket != 5 && rand() % mod2 == 0) s2.insert(v);
+				}
+			}
+			roaring_bitmap r1(s1.begin(), s1.end()), r2(s2.begin(), s2.end());
+			assert(r1.size() == s1.size() && r2.size() == s2.size());
+
+			std::vector<uint32_t> expected;
+			std::set_intersection(s1.begin(), s1.end(), s2.begin(), s2.end(), std::back_inserter(expected));
+			auto a = r1 & r2;
+			assert(a.size() == expected.size() && TinySTL::Test::container_equal(a, expected));
+
+			expected.clear();
+			std::set_union(s1.begin(), s1.end(), s2.begin(), s2.end(), std::back_inserter(expected));
+			auto o = r1 | r2;
+			assert(o.size() == expected.size() && TinySTL::Test::container_equal(o, expected));
+
+			expected.clear();
+			std::set_symmetric_difference(s1.begin(), s1.end(), s2.begin(), s2.end(), std::back_inserter(expected));
+			auto x = r1 ^ r2;
+			assert(x.size() == expected.size() && TinySTL::Test::container_equal(x, expected));
+
+			expected.clear();
+			std::set_difference(s1.begin(), s1.end(), s2.begin(), s2.end(), std::back_inserter(expected));
+			roaring_bitmap d(r1);
+			d.and_not(r2);
+			assert(d.size() == expected.size() && TinySTL::Test::container_equal(d, expected));
+
+			assert((r1 ^ r1).empty());
+			assert((r1 & r1) == r1);
+			assert((a | x) == o);
+			assert(o != r1);
+		}
 
 
 		void testAllCases(){
@@ -86,6 +262,12 @@ namespace TinySTL{
 			testCase5();
 			testCase6();
 			testCase7();
+			testCase8();
+			testCase9();
+			testCase10();
+			testCase11();
+			testCase12();
+			testCase13();
 		}
 	}
 }
\ No newline at end of file
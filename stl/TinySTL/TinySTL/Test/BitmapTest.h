@@ -5,8 +5,13 @@
 
 #include "../Bitmap.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
 #include <iostream>
+#include <iterator>
+#include <set>
+#include <vector>
 
 namespace TinySTL{
 	namespace BitmapTest{
@@ -20,6 +25,12 @@ namespace TinySTL{
 		void testCase5();
 		void testCase6();
 		void testCase7();
+		void testCase8();
+		void testCase9();
+		void testCase10();
+		void testCase11();
+		void testCase12();
+		void testCase13();
 
 		void testAllCases();
 	}
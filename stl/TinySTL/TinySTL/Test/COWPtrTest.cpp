@@ -44,9 +44,25 @@ namespace TinySTL{
 			assert(*cp2 == "C++");
 		}
 
+		void testCase3(){
+			cow_ptr<string> cp1 = make_cow<string>("hello");
+			const string *p = cp1.get();
+			//ֻһʱд
+			cp1->append(" world");
+			*cp1 = "hi";
+			assert(cp1.get() == p && *cp1 == "hi");
+
+			auto cp2 = cp1;
+			cp2 = cp1;
+			cp2->append("!");
+			assert(*cp1 == "hi" && *cp2 == "hi!");
+			assert(cp1.get() == p && cp2.get() != p);
+		}
+
 		void testAllCases(){
 			testCase1();
 			testCase2();
+			testCase3();
 		}
 	}
 }
\ No newline at end of file
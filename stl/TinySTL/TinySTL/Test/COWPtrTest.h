@@ -8,6 +8,8 @@
 namespace TinySTL{
 	namespace COWPtrTest{
 		void testCase1();
+		void testCase2();
+		void testCase3();
 
 		void testAllCases();
 	}
@@ -0,0 +1,163 @@
+#include "ConcurrentCircularBufferTest.h"
+
+namespace TinySTL{
+	namespace ConcurrentCircularBufferTest{
+		void testCase1(){
+			tsSPSC<int, 8> q;
+			assert(q.empty() && q.capacity() == 8);
+			for (int i = 0; i != 8; ++i)
+				assert(q.try_push(i));
+			assert(q.full() && q.size() == 8);
+			assert(!q.try_push(8));
+
+			int val;
+			for (int i = 0; i != 8; ++i){
+				assert(q.try_pop(val));
+				assert(val == i);
+			}
+			assert(q.empty());
+			assert(!q.try_pop(val));
+		}
+		void testCase2(){
+			tsSPSC<std::string, 4> q;
+			std::string arr[] = { "zero", "one", "two", "three", "four", "five" };
+			std::vector<std::string> out;
+
+			assert(q.try_push_n(arr, 3) == 3);
+			assert(q.try_pop_n(std::back_inserter(out), 2) == 2);
+			//ƹĩβֻٷŽ3
+			assert(q.try_push_n(arr + 3, 3) == 3);
+			assert(q.try_push_n(arr, 1) == 0);
+			assert(q.try_pop_n(std::back_inserter(out), 10) == 4);
+			assert(TinySTL::Test::container_equal(out, std::vector<std::string>(arr, arr + 6)));
+
+			q.push(std::string("left in buffer"));//
+		}
+		void testCase3(){
+			const int count = 1000000;
+			tsSPSC<int, 1024, TinySTL::blocking_wait> q;
+			std::thread producer([&]{
+				for (int i = 0; i != count; ++i)
+					q.push(i);
+			});
+			for (int i = 0; i != count; ++i){
+				int val;
+				q.pop(val);
+				assert(val == i);
+			}
+			producer.join();
+			assert(q.empty());
+		}
+		void testCase4(){
+			const int count = 1000000, batch = 100;
+			tsSPSC<int, 256, TinySTL::spin_wait> q;
+			std::thread producer([&]{
+				std::vector<int> v(batch);
+				for (int i = 0; i != count; i += batch){
+					for (int j = 0; j != batch; ++j)
+						v[j] = i + j;
+					q.push_n(v.begin(), batch);
+				}
+			});
+			int expect = 0, buf[64];
+			while (expect != count){
+				size_t n = q.try_pop_n(buf, 64);
+				for (size_t j = 0; j != n; ++j)
+					assert(buf[j] == expect++);
+			}
+			producer.join();
+		}
+		void testCase5(){
+			tsMPMC<std::string, 4> q;
+			assert(q.try_push("a") && q.try_push("b"));
+			std::string arr[] = { "c", "d", "e" };
+			assert(q.try_push_n(arr, 3) == 2);
+			assert(q.full() && !q.try_push("f"));
+
+			std::string val;
+			assert(q.try_pop(val) && val == "a");
+			std::vector<std::string> out;
+			assert(q.try_pop_n(std::back_inserter(out), 2) == 2);
+			assert(out[0] == "b" && out[1] == "c");
+			assert(q.size() == 1);
+		}
+		void testCase6(){
+			const int producers = 4, consumers = 4, perProducer = 200000;
+			tsMPMC<int, 1024> q;
+			std::vector<std::vector<int>> seen(consumers);
+			std::vector<std::thread> threads;
+			for (int p = 0; p != producers; ++p){
+				threads.push_back(std::thread([&q, p]{
+					for (int i = 0; i != perProducer; ++i)
+						q.push(p * perProducer + i);
+				}));
+			}
+			for (int c = 0; c != consumers; ++c){
+				threads.push_back(std::thread([&q, &seen, c]{
+					for (int i = 0; i != producers * perProducer / consumers; ++i){
+						int val;
+						q.pop(val);
+						seen[c].push_back(val);
+					}
+				}));
+			}
+			for (auto& t : threads)
+				t.join();
+
+			//ÿֵǡóһΣͬһߵֵͬһб˳
+			std::vector<char> mark(producers * perProducer, 0);
+			for (auto& v : seen){
+				std::vector<int> last(producers, -1);
+				for (auto val : v){
+					assert(mark[val] == 0);
+					mark[val] = 1;
+					assert(val > last[val / perProducer]);
+					last[val / perProducer] = val;
+				}
+			}
+			assert(q.empty());
+		}
+		void testCase7(){
+			const int producers = 3, perProducer = 100000, batch = 16;
+			tsMPMC<int, 64, TinySTL::blocking_wait> q;
+			std::vector<std::thread> threads;
+			for (int p = 0; p != producers; ++p){
+				threads.push_back(std::thread([&q, p]{
+					int v[batch];
+					for (int i = 0; i != perProducer; i += batch){
+						for (int j = 0; j != batch; ++j)
+							v[j] = p * perProducer + i + j;
+						q.push_n(v, batch);
+					}
+				}));
+			}
+			long long sum = 0;
+			int got = 0, buf[batch];
+			while (got != producers * perProducer){
+				size_t n = q.try_pop_n(buf, batch);
+				if (n == 0){
+					q.pop(buf[0]);
+					n = 1;
+				}
+				for (size_t j = 0; j != n; ++j)
+					sum += buf[j];
+				got += (int)n;
+			}
+			for (auto& t : threads)
+				t.join();
+			long long total = (long long)producers * perProducer;
+			assert(sum == total * (total - 1) / 2);
+		}
+
+
+		void testAllCases(){
+			testCase1();
+			testCase2();
+			testCase3();
+			testCase4();
+			testCase5();
+			testCase6();
+			testCase7();
+		}
+	}
+}
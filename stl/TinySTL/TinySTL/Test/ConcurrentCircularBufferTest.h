@@ -0,0 +1,32 @@
+#ifndef _CONCURRENT_CIRCULAR_BUFFER_TEST_H_
+#define _CONCURRENT_CIRCULAR_BUFFER_TEST_H_
+
+#include "TestUtil.h"
+
+#include "../ConcurrentCircularBuffer.h"
+
+#include <cassert>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace TinySTL{
+	namespace ConcurrentCircularBufferTest{
+		template<class T, size_t N, class Wait = TinySTL::yield_wait>
+		using tsSPSC = TinySTL::spsc_circular_buffer<T, N, TinySTL::allocator<T>, Wait>;
+		template<class T, size_t N, class Wait = TinySTL::yield_wait>
+		using tsMPMC = TinySTL::mpmc_circular_buffer<T, N, Wait>;
+
+		void testCase1();
+		void testCase2();
+		void testCase3();
+		void testCase4();
+		void testCase5();
+		void testCase6();
+		void testCase7();
+
+		void testAllCases();
+	}
+}
+
+#endif
@@ -89,6 +89,34 @@ namespace TinySTL{
 			auto foo2 = bar;
 			assert(foo2 == bar);
 		}
+		void testCase7(){
+			//mapʱͰָԪصָȻЧ
+			tsDQ<std::string> dq1;
+			stdDQ<std::string> dq2;
+			dq1.push_back("first");
+			dq2.push_back("first");
+			const std::string *first = &dq1.front();
+			for (int i = 0; i != 1000; ++i){
+				std::string s(i % 30, char('a' + i % 26));
+				if (i % 2){
+					dq1.emplace_back(s);
+					dq2.emplace_back(s);
+				}
+				else{
+					dq1.push_front(std::move(s));
+					dq2.push_front(std::string(i % 30, char('a' + i % 26)));
+				}
+			}
+			assert(first == &dq1[500]);
+			assert(TinySTL::Test::container_equal(dq1, dq2));
+
+			tsDQ<std::unique_ptr<int>> dq3;
+			for (int i = 0; i != 300; ++i){
+				dq3.emplace_back(new int(i));
+				dq3.emplace_front(new int(-i));
+			}
+			assert(dq3.size() == 600 && *dq3.front() == -299 && *dq3.back() == 299);
+		}
 
 
 		void testAllCases(){
@@ -98,6 +126,7 @@ namespace TinySTL{
 			testCase4();
 			testCase5();
 			testCase6();
+			testCase7();
 		}
 	}
 }
\ No newline at end of file
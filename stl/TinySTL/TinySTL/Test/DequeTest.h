@@ -7,6 +7,7 @@
 #include <deque>
 
 #include <cassert>
+#include <memory>
 #include <string>
 
 namespace TinySTL{
@@ -22,6 +23,7 @@ namespace TinySTL{
 		void testCase4();
 		void testCase5();
 		void testCase6();
+		void testCase7();
 
 		void testAllCases();
 	}
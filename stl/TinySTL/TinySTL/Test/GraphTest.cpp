@@ -137,11 +137,124 @@ namespace TinySTL{
 			}
 		}
 
+		void testCase5(){
+			dGraph<int, int> g;
+			dGraph<int, int>::nodes_set_type set1, set2, set3;
+			set1.push_back(g.make_node(1, 11));
+			set1.push_back(g.make_node(2, 22));
+			set1.push_back(g.make_node(3, 33));
+			g.add_node(g.make_node(0, 0), set1);
+			set2.push_back(g.make_node(5, 55));
+			set2.push_back(g.make_node(6, 66));
+			set2.push_back(g.make_node(7, 77));
+			g.add_node(g.make_node(1, 11), set2);
+			set3.push_back(g.make_node(12, 1212));
+			set3.push_back(g.make_node(13, 1313));
+			set3.push_back(g.make_node(14, 1414));
+			g.add_node(7, set3);
+			g.make_edge(12, 2);
+			g.make_edge(12, 3);
+			g.make_edge(12, 0);
+
+			csrGraph<int, int> csr(g);
+			assert(csr.size() == g.size() && csr.edge_count() == 12);
+			assert((csr.vertex(100) == csrGraph<int, int>::npos));
+			auto v12 = csr.vertex(12);
+			assert(csr.node(v12).second == 1212 && csr.out_degree(v12) == 3 && csr.in_degree(v12) == 1);
+
+			//˳directed_graphͬ
+			std::ostringstream os1, os2, os3, os4;
+			auto print = [](std::ostringstream& os){
+				return [&os](const dGraph<int, int>::node_type& node){
+					os << "[" << node.first << "," << node.second << "]";
+				};
+			};
+			g.DFS(1, print(os1));
+			csr.DFS(1, print(os2));
+			assert(os1.str() == os2.str());
+			g.BFS(1, print(os3));
+			csr.BFS(1, print(os4));
+			assert(os3.str() == os4.str());
+
+			auto levels = csr.bfs_levels(csr.vertex(1));
+			assert(levels[csr.vertex(1)] == 0 && levels[csr.vertex(7)] == 1 && levels[csr.vertex(12)] == 2);
+			assert(levels[csr.vertex(0)] == 3 && levels[csr.vertex(3)] == 3);
+
+			csrGraph<int, int> empty;
+			assert(empty.empty() && empty.edge_count() == 0);
+			bool thrown = false;
+			try{
+				empty.bfs_levels(0);
+			}
+			catch (std::out_of_range&){
+				thrown = true;
+			}
+			assert(thrown);
+		}
+		void testCase6(){
+			//ɷֲͼֵַʽĲͨBFSͬ
+			typedef csrGraph<unsigned, unsigned> graph_type;
+			const unsigned n = graph_type::parallel_threshold * 2;
+			std::vector<graph_type::node_type> nodes;
+			for (unsigned i = 0; i != n; ++i)
+				nodes.push_back(graph_type::node_type(i, i));
+			std::vector<graph_type::edge_type> edges;
+			srand(1);
+			for (unsigned i = 0; i != n * 8; ++i){
+				//ȡƽСŵĶܴ
+				unsigned r = unsigned(rand() % 1000) * unsigned(rand() % 1000);
+				unsigned from = unsigned((double(r) / 1e6) * (double(r) / 1e6) * n) % n;
+				unsigned to = ((unsigned(rand()) << 15) ^ unsigned(rand())) % n;
+				if (to % 100 != 7)//ŸλΪ7Ķֻܲɴ
+					edges.push_back(graph_type::edge_type(from, to));
+			}
+			graph_type g(nodes, edges);
+
+			std::vector<unsigned> expect(n, graph_type::npos), queue(1, 0);
+			expect[0] = 0;
+			for (size_t head = 0; head != queue.size(); ++head){
+				unsigned u = queue[head];
+				for (auto it = g.out_begin(u); it != g.out_end(u); ++it){
+					if (expect[*it] == graph_type::npos){
+						expect[*it] = expect[u] + 1;
+						queue.push_back(*it);
+					}
+				}
+			}
+			assert(queue.size() < n);
+			assert(g.bfs_levels(0, false, false) == expect);
+			assert(g.bfs_levels(0, false, true) == expect);
+			assert(g.bfs_levels(0, true, false) == expect);
+			assert(g.bfs_levels(0, true, true) == expect);
+
+			bool thrown = false;
+			edges.push_back(graph_type::edge_type(0, n));
+			try{
+				graph_type bad(nodes, edges);
+			}
+			catch (std::out_of_range&){
+				thrown = true;
+			}
+			assert(thrown);
+			thrown = false;
+			edges.pop_back();
+			nodes.push_back(graph_type::node_type(0, 0));
+			try{
+				graph_type bad(nodes, edges);
+			}
+			catch (std::invalid_argument&){
+				thrown = true;
+			}
+			assert(thrown);
+		}
+
 		void testAllCases(){
 			testCase1();
 			testCase2();
 			testCase3();
 			testCase4();
+			testCase5();
+			testCase6();
 		}
 	}
 }
\ No newline at end of file
@@ -6,16 +6,23 @@
 #include "../Graph.h"
 
 #include <cassert>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
 
 namespace TinySTL{
 	namespace GraphTest{
 		template<class Index, class Value>
 		using dGraph = TinySTL::directed_graph < Index, Value > ;
+		template<class Index, class Value>
+		using csrGraph = TinySTL::csr_graph < Index, Value > ;
 
 		void testCase1();
 		void testCase2();
 		void testCase3();
 		void testCase4();
+		void testCase5();
+		void testCase6();
 
 		void testAllCases();
 	}
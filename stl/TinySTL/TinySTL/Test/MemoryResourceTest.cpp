@@ -0,0 +1,336 @@
+#include "MemoryResourceTest.h"
+
+namespace TinySTL{
+	namespace MemoryResourceTest{
+		namespace{
+			//¼Ĵδ黹ֽ
+			class counting_resource : public memory_resource{
+			public:
+				size_t allocations_;
+				size_t outstanding_;
+				counting_resource() :allocations_(0), outstanding_(0){}
+			private:
+				void *do_allocate(size_t bytes, size_t alignment) override{
+					++allocations_;
+					outstanding_ += bytes;
+					return new_delete_resource()->allocate(bytes, alignment);
+				}
+				void do_deallocate(void *p, size_t bytes, size_t alignment) override{
+					outstanding_ -= bytes;
+					new_delete_resource()->deallocate(p, bytes, alignment);
+				}
+				bool do_is_equal(const memory_resource& other)const override{ return this == &other; }
+			};
+			//ֻ֤max_alignصĵַⲻ32ֽڶ룬ԭʼַڷصַǰ
+			class skewed_resource : public memory_resource{
+			private:
+				void *do_allocate(size_t bytes, size_t) override{
+					char *raw = static_cast<char *>(::operator new(bytes + 2 * max_align));
+					char *p = raw + max_align;
+					if (reinterpret_cast<size_t>(p) % 32 == 0)
+						p += max_align;
+					reinterpret_cast<void **>(p)[-1] = raw;
+					return p;
+				}
+				void do_deallocate(void *p, size_t, size_t) override{ ::operator delete(static_cast<void **>(p)[-1]); }
+				bool do_is_equal(const memory_resource& other)const override{ return this == &other; }
+			};
+			bool is_aligned(const void *p, size_t alignment){
+				return reinterpret_cast<size_t>(p) % alignment == 0;
+			}
+			bool in_buffer(const void *p, const char *buf, size_t size){
+				return static_cast<const char *>(p) >= buf && static_cast<const char *>(p) < buf + size;
+			}
+		}
+
+		void testCase1(){
+			char buf[1024];
+			monotonic_buffer_resource mr(buf, sizeof(buf), null_memory_resource());
+			void *p1 = mr.allocate(10, 1);
+			assert(p1 == buf);
+			void *p2 = mr.allocate(16, 16);
+			assert(in_buffer(p2, buf, sizeof(buf)));
+			assert(reinterpret_cast<size_t>(p2) % 16 == 0);
+			assert(static_cast<char *>(p2) >= static_cast<char *>(p1) + 10);
+
+			bool thrown = false;
+			try{
+				for (;;)
+					mr.allocate(100);
+			}
+			catch (std::bad_alloc&){
+				thrown = true;
+			}
+			assert(thrown);
+
+			mr.release();
+			assert(mr.allocate(10, 1) == buf);
+		}
+		void testCase2(){
+			counting_resource upstream;
+			{
+				monotonic_buffer_resource mr(&upstream);
+				for (int i = 0; i != 1000; ++i)
+					mr.allocate(100);
+				//100KBֻҪټη
+				assert(upstream.allocations_ != 0 && upstream.allocations_ < 10);
+				assert(upstream.outstanding_ >= 100 * 1000);
+				mr.release();
+				assert(upstream.outstanding_ == 0);
+				mr.allocate(1);
+				assert(upstream.outstanding_ != 0);
+			}
+			assert(upstream.outstanding_ == 0);
+		}
+		void testCase3(){
+			counting_resource upstream;
+			pool_options opts;
+			opts.max_blocks_per_chunk = 64;
+			opts.largest_required_pool_block = 512;
+			{
+				unsynchronized_pool_resource pool(opts, &upstream);
+				assert(pool.options().largest_required_pool_block >= 512);
+
+				void *p1 = pool.allocate(24);
+				pool.deallocate(p1, 24);
+				void *p2 = pool.allocate(24);
+				assert(p1 == p2);//е鱻
+				void *p3 = pool.allocate(24);
+				assert(p3 != p2);
+
+				size_t before = upstream.allocations_;
+				void *big = pool.allocate(10000);
+				assert(upstream.allocations_ == before + 1);
+				size_t outstanding = upstream.outstanding_;
+				pool.deallocate(big, 10000);
+				assert(upstream.outstanding_ < outstanding);
+				pool.allocate(20000);//ͷţrelease黹
+
+				for (int i = 0; i != 1000; ++i)
+					pool.allocate(i % 500 + 1);
+				pool.release();
+				assert(upstream.outstanding_ == 0);
+				pool.allocate(8);
+			}
+			assert(upstream.outstanding_ == 0);
+		}
+		void testCase4(){
+			counting_resource res;
+			{
+				pmrVec<int> v(&res);
+				std::vector<int> sv;
+				for (int i = 0; i != 1000; ++i){
+					v.push_back(i);
+					sv.push_back(i);
+				}
+				v.insert(v.begin() + 10, 5, -1);
+				sv.insert(sv.begin() + 10, 5, -1);
+				assert(TinySTL::Test::container_equal(v, sv));
+				assert(v.get_allocator().resource() == &res);
+				assert(res.allocations_ != 0);
+
+				pmrL<int> l(&res);
+				std::list<int> sl;
+				for (int i = 0; i != 100; ++i){
+					l.push_back(i);
+					l.push_front(-i);
+					sl.push_back(i);
+					sl.push_front(-i);
+				}
+				l.sort();
+				sl.sort();
+				assert(TinySTL::Test::container_equal(l, sl));
+				assert(l.get_allocator().resource() == &res);
+
+				pmrDQ<int> dq(&res);
+				std::deque<int> sdq;
+				for (int i = 0; i != 1000; ++i){
+					dq.push_back(i);
+					dq.push_front(-i);
+					sdq.push_back(i);
+					sdq.push_front(-i);
+				}
+				assert(TinySTL::Test::container_equal(dq, sdq));
+				assert(dq.get_allocator().resource() == &res);
+
+				//ʱʹĬϵresourceָʱʹָ
+				pmrVec<int> v2(v);
+				assert(v2.get_allocator().resource() == get_default_resource());
+				pmrVec<int> v3(v, &res);
+				assert(v3.get_allocator().resource() == &res);
+				assert(TinySTL::Test::container_equal(v2, v3));
+			}
+			assert(res.outstanding_ == 0);
+		}
+		void testCase5(){
+			counting_resource res;
+			{
+				pmrUst<int> ust(10, &res);
+				for (int i = 0; i != 1000; ++i)
+					ust.insert(i);
+				assert(ust.size() == 1000);
+				assert(ust.get_allocator().resource() == &res);
+				for (int i = 0; i != 1000; i += 2)
+					ust.erase(i);
+				assert(ust.size() == 500);
+				assert(ust.count(1) == 1 && ust.count(2) == 0);
+				assert(res.allocations_ != 0);
+			}
+			assert(res.outstanding_ == 0);
+		}
+		void testCase6(){
+			counting_resource res, res2;
+			{
+				const char *text = "a string which is too long for the small buffer";
+				tsStr s1(text, &res);
+				assert(s1 == text);
+				assert(s1.get_allocator().resource() == &res);
+				assert(res.allocations_ == 1);
+				tsStr s2("short", &res);
+				assert(res.allocations_ == 1);//ַ
+				assert(s2.get_allocator().resource() == &res);//resource¼ڶڲ
+				s2 += " string goes long here";
+				assert(s2 == "short string goes long here" && res.allocations_ == 2);
+				s2.resize(5);
+				s2.shrink_to_fit();
+				assert(s2 == "short" && s2.get_allocator().resource() == &res);
+
+				tsStr s3(s1);
+				assert(s3 == s1 && s3.get_allocator().resource() == alloc_resource());
+				tsStr s4(std::move(s1));
+				assert(s4 == text && s4.get_allocator().resource() == &res);
+				assert(s1.empty() && s1.get_allocator().resource() == &res);
+				assert(res.allocations_ == 2);//ͬһresource֮ƶҪ
+
+				tsStr s5(&res2);
+				s5 = std::move(s4);
+				assert(s5 == text && s5.get_allocator().resource() == &res2);
+				assert(res2.allocations_ == 1);
+				s5.append(s5);
+				s5.shrink_to_fit();
+				assert(s5.size() == 2 * strlen(text));
+				assert(res.outstanding_ != 0 && res2.outstanding_ != 0);
+			}
+			assert(res.outstanding_ == 0 && res2.outstanding_ == 0);
+		}
+		void testCase7(){
+			//Ƕ׵ͬһ黺ϣĬϵresourceΪnullʱκ©ķ䶼׳쳣
+			static char buf[1 << 18];
+			monotonic_buffer_resource mr(buf, sizeof(buf), null_memory_resource());
+			memory_resource *old = set_default_resource(null_memory_resource());
+			{
+				const char *text = "strings inside containers use the arena too";
+				pmrVec<pmrVec<int>> vv(&mr);
+				for (int i = 0; i != 50; ++i){
+					vv.push_back(pmrVec<int>());
+					for (int j = 0; j != i; ++j)
+						vv.back().push_back(j);
+				}
+				for (int i = 0; i != 50; ++i){
+					assert(vv[i].size() == i);
+					assert(vv[i].get_allocator().resource() == &mr);
+					assert(i == 0 || in_buffer(&vv[i][0], buf, sizeof(buf)));
+				}
+
+				pmrVec<tsStr> vs(&mr);
+				pmrL<tsStr> ls(&mr);
+				pmrDQ<tsStr> ds(&mr);
+				for (int i = 0; i != 100; ++i){
+					vs.push_back(tsStr(text));
+					ls.push_back(tsStr(text));
+					ds.push_front(tsStr(text));
+				}
+				assert(in_buffer(vs[99].data(), buf, sizeof(buf)));
+				assert(in_buffer(ls.back().data(), buf, sizeof(buf)));
+				assert(in_buffer(ds.front().data(), buf, sizeof(buf)));
+				assert(ds.back() == text);
+
+				pmrL<pmrVec<int>> lv(&mr);
+				lv.push_back(pmrVec<int>(10, 1, &mr));
+				assert(in_buffer(&lv.back()[0], buf, sizeof(buf)));
+			}
+			set_default_resource(old);
+		}
+		void testCase8(){
+			//trie_treegraphĽ㡢顢ڽӱӸresource䣬ȫ黹
+			counting_resource res;
+			memory_resource *old = set_default_resource(null_memory_resource());
+			{
+				TinySTL::trie_tree t(&res);
+				assert(t.get_allocator().resource() == &res);
+				for (char ch = 'a'; ch <= 'z'; ++ch){
+					//ĺӳ16ֱ
+					t.insert(tsStr(1, ch) + "-a rather long word which does not fit inline");
+					t.insert(tsStr(1, ch) + "-a rather long word");
+				}
+				assert(t.size() == 52);
+				assert(t.is_existed("q-a rather long word"));
+				assert(!t.is_existed("q-a rather"));
+				assert(t.get_word_by_prefix("q-a").size() == 2);
+				assert(res.allocations_ != 0);
+
+				TinySTL::directed_graph<int, int> g(&res);
+				assert(g.get_allocator().resource() == &res);
+				for (int i = 0; i != 100; ++i){
+					TinySTL::vector<TinySTL::pair<int, int>> adj;
+					if (i != 0)
+						adj.push_back(g.make_node(i - 1, i - 1));
+					g.add_node(g.make_node(i, i), adj);
+				}
+				g.make_edge(0, 99);
+				g.delete_node(50);
+				assert(g.is_contained(49) && !g.is_contained(50));
+				assert(g.adjacent_nodes(0).size() == 1 && g.adjacent_nodes(51).empty());
+			}
+			set_default_resource(old);
+			assert(res.outstanding_ == 0);
+		}
+		void testCase9(){
+			//max_alignĶҪβ֤ʱʵʵַ
+			skewed_resource skewed;
+			for (size_t alignment = 32; alignment <= 128; alignment *= 2){
+				memory_resource *upstreams[] = { new_delete_resource(), alloc_resource(), &skewed };
+				for (auto up : upstreams){
+					for (size_t bytes = 1; bytes <= 8192; bytes *= 4){
+						if (up != &skewed){
+							void *p = up->allocate(bytes, alignment);
+							assert(is_aligned(p, alignment));
+							up->deallocate(p, bytes, alignment);
+						}
+
+						monotonic_buffer_resource mono(up);
+						unsynchronized_pool_resource pool(up);
+						void *mp[4], *pp[4];
+						for (int i = 0; i != 4; ++i){
+							mp[i] = mono.allocate(bytes, alignment);
+							assert(is_aligned(mp[i], alignment));
+							pp[i] = pool.allocate(bytes, alignment);
+							assert(is_aligned(pp[i], alignment));
+							memset(mp[i], i, bytes);
+							memset(pp[i], i, bytes);
+						}
+						pool.deallocate(pp[1], bytes, alignment);
+						pool.deallocate(pp[3], bytes, alignment);
+					}
+				}
+				//ṩbufferʱҲһ
+				char buf[1024];
+				monotonic_buffer_resource mono(buf + 1, sizeof(buf) - 1, &skewed);
+				for (int i = 0; i != 20; ++i)
+					assert(is_aligned(mono.allocate(40, alignment), alignment));
+			}
+		}
+
+		void testAllCases(){
+			testCase1();
+			testCase2();
+			testCase3();
+			testCase4();
+			testCase5();
+			testCase6();
+			testCase7();
+			testCase8();
+			testCase9();
+		}
+	}
+}
@@ -0,0 +1,49 @@
+#ifndef _MEMORY_RESOURCE_TEST_H_
+#define _MEMORY_RESOURCE_TEST_H_
+
+#include "TestUtil.h"
+
+#include "../MemoryResource.h"
+#include "../Deque.h"
+#include "../Graph.h"
+#include "../List.h"
+#include "../String.h"
+#include "../TrieTree.h"
+#include "../Unordered_set.h"
+#include "../Vector.h"
+
+#include <cassert>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace TinySTL{
+	namespace MemoryResourceTest{
+		template<class T>
+		using pmrVec = TinySTL::vector<T, TinySTL::polymorphic_allocator<T>>;
+		template<class T>
+		using pmrL = TinySTL::list<T, TinySTL::polymorphic_allocator<T>>;
+		template<class T>
+		using pmrDQ = TinySTL::deque<T, TinySTL::polymorphic_allocator<T>>;
+		template<class T>
+		using pmrUst = TinySTL::Unordered_set<T, std::hash<T>, TinySTL::equal_to<T>, TinySTL::polymorphic_allocator<T>>;
+		using tsStr = TinySTL::string;
+
+		void testCase1();
+		void testCase2();
+		void testCase3();
+		void testCase4();
+		void testCase5();
+		void testCase6();
+		void testCase7();
+		void testCase8();
+		void testCase9();
+
+		void testAllCases();
+	}
+}
+
+#endif
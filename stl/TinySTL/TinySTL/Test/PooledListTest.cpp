@@ -0,0 +1,231 @@
+#include "PooledListTest.h"
+
+#include <utility>
+
+namespace TinySTL{
+	namespace PooledListTest{
+		void testCase1(){
+			stdL<int> l1(10, 0);
+			tsPL<int> l2(10, 0);
+			assert(TinySTL::Test::container_equal(l1, l2));
+
+			int arr[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+			stdL<int> l3(std::begin(arr), std::end(arr));
+			tsPL<int> l4(std::begin(arr), std::end(arr));
+			assert(TinySTL::Test::container_equal(l3, l4));
+			assert(l4.size() == 9 && l4.front() == 1 && l4.back() == 9);
+
+			tsPL<int> l5(l4);
+			assert(l5 == l4);
+			l5 = l2;
+			assert(l5 == l2 && l5 != l4);
+			l5 = l4;
+			assert(l5 == l4);
+
+			for (auto i = 0; i != 100; ++i){
+				l3.push_front(i);
+				l4.push_front(i);
+				l3.push_back(-i);
+				l4.push_back(-i);
+			}
+			assert(TinySTL::Test::container_equal(l3, l4));
+			for (auto i = 0; i != 50; ++i){
+				l3.pop_front();
+				l4.pop_front();
+				l3.pop_back();
+				l4.pop_back();
+			}
+			assert(TinySTL::Test::container_equal(l3, l4));
+			assert(l3.size() == l4.size());
+			auto rit = l4.rbegin();
+			for (auto it = l3.rbegin(); it != l3.rend(); ++it, ++rit)
+				assert(*it == *rit);
+		}
+		void testCase2(){
+			std::mt19937 rng(1);
+			stdL<int> l1;
+			tsPL<int> l2;
+			for (int round = 0; round != 3; ++round){
+				for (int i = 0; i != 5000; ++i){
+					size_t pos = l1.empty() ? 0 : rng() % (l1.size() + 1);
+					auto it1 = l1.begin();
+					auto it2 = l2.begin();
+					std::advance(it1, pos);
+					for (size_t j = 0; j != pos; ++j)
+						++it2;
+					if (rng() % 3 || it1 == l1.end()){
+						int val = int(rng());
+						assert(*l1.insert(it1, val) == *l2.insert(it2, val));
+					}else{
+						it1 = l1.erase(it1);
+						auto res = l2.erase(it2);
+						assert((it1 == l1.end()) == (res == l2.end()));
+					}
+				}
+				assert(TinySTL::Test::container_equal(l1, l2));
+				assert(l1.size() == l2.size());
+				//clear֮ڳٴβ벻
+				size_t capacity = l2.get_pool()->capacity();
+				l1.clear();
+				l2.clear();
+				assert(l2.empty() && l2.begin() == l2.end());
+				for (size_t i = 0; i != 1000; ++i){
+					l1.push_back(int(i));
+					l2.push_back(int(i));
+				}
+				assert(l2.get_pool()->capacity() == capacity);
+				assert(TinySTL::Test::container_equal(l1, l2));
+			}
+		}
+		void testCase3(){
+			std::mt19937 rng(2);
+			//keyvalue¼ԭ˳ȶ
+			stdL<std::pair<int, int>> l1;
+			tsPL<std::pair<int, int>> l2;
+			for (int i = 0; i != 10000; ++i){
+				auto val = std::make_pair(int(rng() % 100), i);
+				l1.push_back(val);
+				l2.push_back(val);
+			}
+			auto byKey = [](const std::pair<int, int>& a, const std::pair<int, int>& b){ return a.first < b.first; };
+			l1.sort(byKey);
+			l2.sort(byKey);
+			assert(TinySTL::Test::container_equal(l1, l2));
+			auto rit = l2.rbegin();
+			for (auto it = l1.rbegin(); it != l1.rend(); ++it, ++rit)
+				assert(*it == *rit);
+
+			int arr1[] = { 5, 0, 9, 1, 3 }, arr2[] = { 8, 2, 6, 7, 4, 4 };
+			stdL<int> a1(std::begin(arr1), std::end(arr1)), b1(std::begin(arr2), std::end(arr2));
+			tsPL<int> a2(std::begin(arr1), std::end(arr1)), b2(std::begin(arr2), std::end(arr2));
+			a1.sort(); b1.sort();
+			a2.sort(); b2.sort();
+			a1.merge(b1);
+			a2.merge(b2);
+			assert(TinySTL::Test::container_equal(a1, a2));
+			assert(b2.empty() && a2.size() == 11);
+
+			a1.unique();
+			a2.unique();
+			assert(TinySTL::Test::container_equal(a1, a2));
+			a1.remove(a1.front());
+			a2.remove(a2.front());//valԪ
+			assert(TinySTL::Test::container_equal(a1, a2));
+			auto odd = [](int n){ return n % 2 != 0; };
+			a1.remove_if(odd);
+			a2.remove_if(odd);
+			assert(TinySTL::Test::container_equal(a1, a2));
+			a1.reverse();
+			a2.reverse();
+			assert(TinySTL::Test::container_equal(a1, a2));
+			assert(a2.size() == a1.size());
+
+			tsPL<int> one(1, 7);
+			one.sort();
+			one.reverse();
+			assert(one.size() == 1 && one.front() == 7);
+		}
+		void testCase4(){
+			stdL<int> l1(10, 0), l3(10, 1);
+			tsPL<int> l2(10, 0), l4(10, 1);
+			//زͬԪرƶ
+			l1.splice(l1.begin(), l3);
+			l2.splice(l2.begin(), l4);
+			assert(TinySTL::Test::container_equal(l1, l2));
+			assert(l4.empty() && l2.size() == 20);
+
+			//أָֻ
+			tsPL<int> l6(l2.get_pool());
+			assert(l6.get_pool() == l2.get_pool());
+			for (int i = 0; i != 10; ++i)
+				l6.push_back(i + 100);
+			stdL<int> l5;
+			for (auto it = l6.begin(); it != l6.end(); ++it)
+				l5.push_back(*it);
+			auto moved = &*l6.begin();
+			l1.splice(l1.end(), l5, l5.begin());
+			l2.splice(l2.end(), l6, l6.begin());
+			assert(&l2.back() == moved);
+			assert(TinySTL::Test::container_equal(l1, l2));
+			assert(l6.size() == 9 && l2.size() == 21);
+
+			auto it1 = l1.begin();
+			auto it2 = l2.begin();
+			for (auto i = 0; i != 7; ++i){
+				++it1;
+				++it2;
+			}
+			auto last5 = l5.begin();
+			auto last6 = l6.begin();
+			for (auto i = 0; i != 4; ++i){
+				++last5;
+				++last6;
+			}
+			l1.splice(it1, l5, l5.begin(), last5);
+			l2.splice(it2, l6, l6.begin(), last6);
+			assert(TinySTL::Test::container_equal(l1, l2));
+			assert(TinySTL::Test::container_equal(l5, l6));
+			assert(l2.size() == 25 && l6.size() == 5);
+			//ͬһlistƶһ
+			l1.splice(l1.begin(), l1, it1, l1.end());
+			l2.splice(l2.begin(), l2, it2, l2.end());
+			assert(TinySTL::Test::container_equal(l1, l2));
+			assert(l2.size() == 25);
+
+			//ûгصlistöԷĳ
+			tsPL<int> l7;
+			l7.splice(l7.end(), l6);
+			assert(l7.get_pool() == l2.get_pool() && l7.size() == 5);
+			tsPL<int> l8;
+			l8.push_back(1);
+			l8.merge(l7);
+			assert(l7.empty() && l8.size() == 6 && l8.get_pool() != l2.get_pool());
+
+			tsPL<int> l9(std::move(l2));
+			assert(l2.empty() && l9.size() == 25);
+			assert(TinySTL::Test::container_equal(l1, l9));
+			l2.push_back(1);
+			l2.swap(l9);
+			assert(l9.size() == 1 && TinySTL::Test::container_equal(l1, l2));
+			l9 = std::move(l2);
+			assert(l2.empty() && TinySTL::Test::container_equal(l1, l9));
+			TinySTL::swap(l2, l9);
+			assert(l9.empty() && TinySTL::Test::container_equal(l1, l2));
+		}
+		void testCase5(){
+			stdL<std::string> l1;
+			{
+				tsPL<std::string> l2;
+				tsPL<std::string> l3(l2.get_pool());
+				for (int i = 0; i != 1000; ++i){
+					std::string s(40, char('a' + i % 26));
+					l1.push_back(s);
+					if (i % 2)
+						l2.push_back(s);
+					else
+						l3.emplace_front(std::move(s));
+				}
+				l3.sort();
+				l2.sort();
+				l2.merge(l3);
+				l1.sort();
+				assert(TinySTL::Test::container_equal(l1, l2));
+				l2.unique();
+				l1.unique();
+				assert(TinySTL::Test::container_equal(l1, l2));
+				tsPL<std::string> l4(l2);
+				l4.clear();
+				l4.push_back("after clear");
+				assert(l4.front() == "after clear");
+			}
+		}
+
+		void testAllCases(){
+			testCase1();
+			testCase2();
+			testCase3();
+			testCase4();
+			testCase5();
+		}
+	}
+}
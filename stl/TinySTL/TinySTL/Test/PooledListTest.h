@@ -0,0 +1,30 @@
+#ifndef _POOLED_LIST_TEST_H_
+#define _POOLED_LIST_TEST_H_
+
+#include "TestUtil.h"
+
+#include "../PooledList.h"
+#include <list>
+
+#include <cassert>
+#include <random>
+#include <string>
+
+namespace TinySTL{
+	namespace PooledListTest{
+		template<class T>
+		using stdL = std::list < T > ;
+		template<class T>
+		using tsPL = TinySTL::pooled_list < T > ;
+
+		void testCase1();//졢ֵ˲ɾ
+		void testCase2();//λinsert/eraseclear֮ó
+		void testCase3();//sortĽȶԣmergeuniqueremovereverse
+		void testCase4();//غͲ֮ͬsplice/mergeswapmove
+		void testCase5();//ԪstringڵԪضȷ
+
+		void testAllCases();
+	}
+}
+
+#endif
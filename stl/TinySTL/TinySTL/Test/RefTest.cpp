@@ -1,26 +1,66 @@
 #include "RefTest.h"
 
+namespace {
+	int deleted = 0;
+	struct CountingDelete{
+		void operator()(int *p){
+			++deleted;
+			delete p;
+		}
+	};
+	int alive = 0;
+	struct Tracked{
+		int val;
+		explicit Tracked(int v) :val(v){ ++alive; }
+		~Tracked(){ --alive; }
+	};
+}
+
 namespace TinySTL{
 	namespace RefTest{
 		void testCaseRef(){
-			ref_t<int> r1;
-			assert(r1.count() == 0);
-			assert(r1.get_data() == nullptr);
-
 			int *p = new int(0);
-			ref_t<int> r2(p);
-			assert(r2.count() == 1);
-			assert(r2.get_data() != nullptr);
+			auto r = new ref_t<int>(p);
+			assert(r->use_count() == 1);
+			assert(r->get_data() == p);
 
-			++r2;
-			assert(r2.count() == 2);
+			r->add_ref();
+			assert(r->use_count() == 2);
 
-			--r2;
-			assert(r2.count() == 1);
+			r->release();
+			assert(r->use_count() == 1);
+			r->release();//ɾpͿƿ
+		}
+		void testCaseWeak(){
+			deleted = 0;
+			auto r = new ref_t<int, CountingDelete>(new int(1));
+			r->weak_add_ref();
+			assert(r->use_count() == 1 && r->weak_count() == 1);
+
+			assert(r->add_ref_lock());
+			assert(r->use_count() == 2);
+			r->release();
+			r->release();
+			assert(deleted == 1);
+			assert(r->use_count() == 0 && r->weak_count() == 1);
+			assert(!r->add_ref_lock());
+			r->weak_release();//ͷſƿ
+			assert(deleted == 1);
+		}
+		void testCaseInplace(){
+			alive = 0;
+			auto r = new ref_inplace<Tracked>(42);
+			assert(alive == 1);
+			assert(r->get_data()->val == 42);
+			assert(r->use_count() == 1);
+			r->release();
+			assert(alive == 0);
 		}
 
 		void testAllCases(){
 			testCaseRef();
+			testCaseWeak();
+			testCaseInplace();
 		}
 	}
-}
\ No newline at end of file
+}
@@ -7,12 +7,16 @@
 
 namespace TinySTL{
 	namespace RefTest{
+		template<class T, class D = TinySTL::Detail::_default_delete<T>>
+		using ref_t = TinySTL::Detail::ref_t < T, D > ;
 		template<class T>
-		using ref_t = TinySTL::Detail::ref_t < T > ;
+		using ref_inplace = TinySTL::Detail::ref_inplace < T > ;
 
 		void testCaseRef();
+		void testCaseWeak();
+		void testCaseInplace();
 		void testAllCases();
 	}
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,242 @@
+#include "RopeTest.h"
+
+namespace TinySTL{
+	namespace RopeTest{
+		namespace{
+			bool equal(const tsRope& r, const stdStr& s){
+				if (r.size() != s.size())
+					return false;
+				stdStr flat(r.size(), '\0');
+				if (!flat.empty())
+					r.flatten(&flat[0]);
+				return flat == s;
+			}
+			stdStr random_text(size_t n, unsigned seed){
+				srand(seed);
+				stdStr res(n, '\0');
+				for (size_t i = 0; i != n; ++i)
+					res[i] = 'a' + rand() % 4;
+				return res;
+			}
+		}
+
+		void testCase1(){
+			tsRope r1;
+			assert(r1.empty() && r1.size() == 0 && r1.begin() == r1.end());
+			tsRope r2("hello");
+			tsRope r3("hello world", 5);
+			tsRope r4(3, 'x');
+			assert(r2.size() == 5 && r2 == r3);
+			assert(equal(r4, "xxx"));
+			assert(r2.front() == 'h' && r2.back() == 'o' && r2.at(1) == 'e');
+
+			bool thrown = false;
+			try{
+				r2.at(5);
+			}
+			catch (std::out_of_range&){
+				thrown = true;
+			}
+			assert(thrown);
+
+			tsRope r5 = r2 + tsRope(", ") + tsRope("world");
+			assert(equal(r5, "hello, world"));
+			assert(r2 < r5 && r5 != r2);
+			assert(tsRope(TinySTL::string("abc")).str() == TinySTL::string("abc"));
+		}
+		void testCase2(){
+			//ַ׷ԭ׷ӣҶдŷµҶ
+			stdStr s;
+			tsRope r;
+			for (int i = 0; i != 100000; ++i){
+				char c = 'a' + i % 26;
+				s.push_back(c);
+				r.push_back(c);
+			}
+			assert(r[0] == s[0]);
+			assert(r.depth() <= tsRope::max_depth);
+			assert(equal(r, s));
+			for (size_t i = 0; i < s.size(); i += 997)
+				assert(r[i] == s[i]);
+
+			stdStr chunk = random_text(10000, 1);
+			for (int i = 0; i != 50; ++i){
+				s.append(chunk, 0, i * 137);
+				r.append(chunk.data(), i * 137);
+			}
+			assert(equal(r, s));
+			r.pop_back();
+			s.pop_back();
+			assert(equal(r, s));
+		}
+		void testCase3(){
+			stdStr s = random_text(200000, 2);
+			tsRope r(s.data(), s.size());
+			srand(3);
+			for (int i = 0; i != 2000; ++i){
+				size_t pos = rand() % (s.size() + 1);
+				switch (rand() % 3){
+				case 0:{
+					stdStr piece = random_text(rand() % 50, i);
+					s.insert(pos, piece);
+					r.insert(pos, piece.c_str());
+					break;
+				}
+				case 1:{
+					size_t len = rand() % 100;
+					s.erase(pos, len);
+					r.erase(pos, len);
+					break;
+				}
+				default:{
+					size_t len = rand() % 5000;
+					tsRope sub = r.substr(pos, len);
+					assert(equal(sub, s.substr(pos, len)));
+					r.insert(pos / 2, sub);
+					s.insert(pos / 2, s.substr(pos, len));
+				}
+				}
+				if (i % 200 == 0)
+					assert(equal(r, s));
+			}
+			assert(equal(r, s));
+			assert(r.depth() <= tsRope::max_depth);
+			r.erase(0, 10);
+			s.erase(0, 10);
+			assert(equal(r, s));
+			r.erase();
+			assert(r.empty());
+		}
+		void testCase4(){
+			//ڵ㣬޸ĿӰԭrope
+			stdStr s = random_text(100000, 4);
+			tsRope r1(s.data(), s.size());
+			tsRope r2 = r1;
+			r2.append("tail");
+			r2.insert(10, "head");
+			r2.erase(500, 1000);
+			assert(equal(r1, s));
+			stdStr s2 = s + "tail";
+			s2.insert(10, "head");
+			s2.erase(500, 1000);
+			assert(equal(r2, s2));
+
+			//ÿ̳߳ԼĿ֮乲üԭӵ
+			std::vector<std::thread> threads;
+			std::vector<int> ok(4, 0);
+			for (int t = 0; t != 4; ++t){
+				tsRope copy = r1;
+				threads.push_back(std::thread([t, copy, &s, &ok]() mutable{
+					stdStr expect = s;
+					for (int i = 0; i != 200; ++i){
+						size_t pos = (i * 7919 + t * 13) % copy.size();
+						tsRope sub = copy.substr(pos, 300);
+						copy.insert(pos / 3, sub);
+						expect.insert(pos / 3, expect.substr(pos, 300));
+						copy.erase(pos, 10);
+						expect.erase(pos, 10);
+					}
+					ok[t] = equal(copy, expect) ? 1 : 0;
+				}));
+			}
+			for (size_t i = 0; i != threads.size(); ++i)
+				threads[i].join();
+			for (int t = 0; t != 4; ++t)
+				assert(ok[t] == 1);
+			assert(equal(r1, s));
+		}
+		void testCase5(){
+			//ͷʹдƽ⣬޸rope
+			tsRope r;
+			stdStr s;
+			for (int i = 0; i != 3000; ++i){
+				char buf[8] = { 0 };
+				buf[0] = 'a' + i % 26;
+				buf[1] = 'A' + i % 26;
+				r.insert(0, buf);
+				s.insert(0, buf);
+			}
+			assert(r.depth() <= tsRope::max_depth);
+			size_t depth = r.depth();
+			assert(r[1234] == s[1234]);
+			assert(r.find(s.substr(2000, 20).c_str()) == s.find(s.substr(2000, 20)));
+			assert(r.substr(100, 10).str() == s.substr(100, 10).c_str());
+			assert(r.depth() == depth);
+			assert(equal(r, s));
+
+			//߳ͬʱͬһrope
+			const tsRope& cr = r;
+			std::vector<std::thread> threads;
+			std::vector<int> ok(4, 0);
+			for (int t = 0; t != 4; ++t){
+				threads.push_back(std::thread([t, &cr, &s, &ok]{
+					int good = 1;
+					for (size_t i = t; i < s.size(); i += 97){
+						good &= cr[i] == s[i];
+						good &= cr.substr(i, 5).str() == s.substr(i, 5).c_str();
+					}
+					good &= cr.find(s.substr(t * 500, 30).c_str()) == s.find(s.substr(t * 500, 30));
+					ok[t] = good;
+				}));
+			}
+			for (size_t i = 0; i != threads.size(); ++i)
+				threads[i].join();
+			for (int t = 0; t != 4; ++t)
+				assert(ok[t] == 1);
+			assert(r.depth() == depth);
+
+			r.balance();
+			assert(r.depth() <= depth);
+			assert(equal(r, s));
+			tsRope::const_iterator it = r.begin();
+			size_t i = 0;
+			for (; it != r.end(); ++it, ++i)
+				assert(*it == s[i]);
+			assert(i == s.size());
+			it = r.end();
+			assert(it - r.begin() == (ptrdiff_t)s.size());
+			assert(*(it - 1) == s.back() && r.begin()[100] == s[100]);
+		}
+		void testCase6(){
+			//parallel_thresholdropeʹö߳flatten/find
+			stdStr s = random_text(3 * tsRope::parallel_threshold, 6);
+			tsRope r;
+			for (size_t pos = 0; pos < s.size(); pos += 70000)
+				r.append(s.data() + pos, pos + 70000 < s.size() ? 70000 : s.size() - pos);
+			assert(equal(r, s));
+			assert(r.str().size() == s.size());
+
+			const char *needles[] = { "abcdab", "dddddddd", "a", "cabbacdbacadbcda", "zz" };
+			for (size_t i = 0; i != sizeof(needles) / sizeof(needles[0]); ++i){
+				size_t pos = 0;
+				for (int k = 0; k != 5; ++k){
+					size_t expect = s.find(needles[i], pos);
+					assert(r.find(needles[i], pos) == expect);
+					if (expect == stdStr::npos)
+						break;
+					pos = expect + 1;
+				}
+			}
+			//ԽҶӱ߽ƥ
+			stdStr needle = s.substr(tsRope::leaf_bytes - 40, 100);
+			assert(r.find(needle.c_str()) == s.find(needle));
+			needle = s.substr(s.size() - 30);
+			assert(r.find(needle.c_str(), 1) == s.find(needle, 1));
+			assert(r.find('d', s.size() - 1) == s.find('d', s.size() - 1));
+
+			char buf[64];
+			assert(r.copy(buf, sizeof(buf), 1000000) == sizeof(buf));
+			assert(stdStr(buf, sizeof(buf)) == s.substr(1000000, sizeof(buf)));
+			assert(r.copy(buf, sizeof(buf), s.size() - 10) == 10);
+		}
+
+		void testAllCases(){
+			testCase1();
+			testCase2();
+			testCase3();
+			testCase4();
+			testCase5();
+			testCase6();
+		}
+	}
+}
@@ -0,0 +1,30 @@
+#ifndef _ROPE_TEST_H_
+#define _ROPE_TEST_H_
+
+#include "TestUtil.h"
+
+#include "../Rope.h"
+
+#include <cassert>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace TinySTL{
+	namespace RopeTest{
+		using stdStr = std::string;
+		using tsRope = TinySTL::rope;
+
+		void testCase1();
+		void testCase2();
+		void testCase3();
+		void testCase4();
+		void testCase5();
+		void testCase6();
+
+		void testAllCases();
+	}
+}
+
+#endif
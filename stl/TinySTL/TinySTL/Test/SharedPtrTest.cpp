@@ -2,6 +2,27 @@
 
 #include "../String.h"
 
+#include <atomic>
+
+namespace {
+	std::atomic<int> alive(0);
+	struct Base{
+		int base;
+		Base() :base(1){ ++alive; }
+		virtual ~Base(){ --alive; }
+	};
+	struct Derived : Base{
+		int derived;
+		explicit Derived(int d) :derived(d){}
+	};
+	struct Pair{
+		int first;
+		int second;
+		Pair(int f, int s) :first(f), second(s){ ++alive; }
+		~Pair(){ --alive; }
+	};
+}
+
 namespace TinySTL{
 	namespace SharedPtrTest{
 		void testCase1(){
@@ -35,8 +56,138 @@ namespace TinySTL{
 			assert(!(spp != nullptr));
 		}
 
+		void testCase2(){
+			alive = 0;
+			{
+				auto sp1 = make_shared<Pair>(1, 2);
+				assert(alive == 1 && sp1.use_count() == 1);
+				assert(sp1->first == 1 && sp1->second == 2);
+
+				//sp1ȨָеĳԱ
+				shared_ptr<int> sp2(sp1, &sp1->second);
+				assert(*sp2 == 2 && sp1.use_count() == 2);
+				sp1.reset();
+				assert(sp1 == nullptr && alive == 1);
+				assert(sp2.use_count() == 1 && *sp2 == 2);
+			}
+			assert(alive == 0);
+			{
+				shared_ptr<Base> sp1(new Derived(5));
+				shared_ptr<Base> sp2 = make_shared<Derived>(6);
+				assert(alive == 2);
+				auto sp3 = std::move(sp1);
+				assert(sp1 == nullptr && sp1.use_count() == 0 && sp3.use_count() == 1);
+				sp2 = sp3;
+				assert(alive == 1 && sp2.use_count() == 2);
+				sp3.reset(new Derived(7));
+				assert(alive == 2 && sp2.unique() && sp3->base == 1);
+			}
+			assert(alive == 0);
+
+			shared_ptr<int> sp4(nullptr);
+			assert(sp4.use_count() == 0);
+			sp4 = make_shared<int>(3);
+			swap(sp4, sp4);
+			assert(*sp4 == 3 && sp4.unique());
+		}
+		void testCase3(){
+			alive = 0;
+			weak_ptr<Pair> wp1;
+			assert(wp1.expired() && wp1.lock() == nullptr);
+			{
+				auto sp1 = make_shared<Pair>(3, 4);
+				wp1 = sp1;
+				assert(!wp1.expired() && wp1.use_count() == 1);
+
+				auto sp2 = wp1.lock();
+				assert(sp2 == sp1 && sp1.use_count() == 2);
+				shared_ptr<Pair> sp3(wp1);
+				assert(sp3->second == 4 && sp1.use_count() == 3);
+			}
+			assert(alive == 0);
+			assert(wp1.expired() && wp1.lock() == nullptr);
+			bool thrown = false;
+			try{
+				shared_ptr<Pair> sp4(wp1);
+			}catch (std::bad_weak_ptr&){
+				thrown = true;
+			}
+			assert(thrown);
+
+			shared_ptr<Derived> sp5(new Derived(8));
+			weak_ptr<Base> wp2 = sp5;
+			weak_ptr<Base> wp3(wp2);
+			assert(wp3.lock()->base == 1);
+			assert(wp2.use_count() == 1);
+			sp5.reset();
+			assert(wp2.expired() && wp3.expired() && alive == 0);
+		}
+		void testCase4(){
+			alive = 0;
+			{
+				auto sp = make_shared<Pair>(5, 6);
+				std::vector<std::thread> threads;
+				for (int t = 0; t != 4; ++t){
+					threads.push_back(std::thread([sp]{
+						for (int i = 0; i != 100000; ++i){
+							shared_ptr<Pair> copy(sp);
+							weak_ptr<Pair> weak(copy);
+							assert(weak.lock()->first == 5);
+						}
+					}));
+				}
+				for (auto& t : threads)
+					t.join();
+				assert(sp.unique() && alive == 1);
+			}
+			assert(alive == 0);
+		}
+		void testCase5(){
+			alive = 0;
+			{
+				atomic_shared_ptr<Pair> asp;
+				assert(asp.load() == nullptr);
+				asp.store(make_shared<Pair>(0, 0));
+
+				const int writes = 20000;
+				std::vector<std::thread> threads;
+				for (int t = 0; t != 3; ++t){
+					threads.push_back(std::thread([&asp]{
+						int last = 0;
+						while (last != writes){
+							auto sp = asp.load();
+							//ֵԱһ
+							assert(sp->first == sp->second && sp->first >= last);
+							last = sp->first;
+						}
+					}));
+				}
+				for (int i = 1; i <= writes; ++i){
+					if (i % 2)
+						asp.store(make_shared<Pair>(i, i));
+					else{
+						auto expected = asp.load();
+						assert(asp.compare_exchange_strong(expected, make_shared<Pair>(i, i)));
+					}
+				}
+				for (auto& t : threads)
+					t.join();
+
+				auto stale = make_shared<Pair>(-1, -1);
+				assert(!asp.compare_exchange_strong(stale, make_shared<Pair>(-2, -2)));
+				assert(stale->first == writes);
+				auto old = asp.exchange(shared_ptr<Pair>());
+				assert(old->first == writes && asp.load() == nullptr);
+			}
+			assert(alive == 0);
+		}
+
 		void testAllCases(){
 			testCase1();
+			testCase2();
+			testCase3();
+			testCase4();
+			testCase5();
 		}
 	}
 }
\ No newline at end of file
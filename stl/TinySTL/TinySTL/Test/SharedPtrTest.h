@@ -4,10 +4,16 @@
 #include "../Memory.h"
 
 #include <cassert>
+#include <thread>
+#include <vector>
 
 namespace TinySTL{
 	namespace SharedPtrTest{
 		void testCase1();
+		void testCase2();//make_shared졢ൽࡢreset/move
+		void testCase3();//weak_ptr
+		void testCase4();//߳̿/
+		void testCase5();//atomic_shared_ptr
 
 		void testAllCases();
 	}
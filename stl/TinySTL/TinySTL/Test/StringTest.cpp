@@ -110,7 +110,9 @@ namespace TinySTL{
 		void testCase7(){
 			tsStr s;
 			s.reserve(10);
-			assert(s.capacity() == 10);
+			assert(s.capacity() >= 10);
+			s.reserve(100);
+			assert(s.capacity() >= 100);
 		}
 		void testCase8(){
 			tsStr s;
@@ -446,6 +448,76 @@ namespace TinySTL{
 				in.close();
 			}
 		}
+		void testCase30(){
+			assert(sizeof(tsStr) == 3 * sizeof(char *));
+
+			tsStr s1("short");
+			assert(s1.capacity() >= s1.size());
+			tsStr s2(s1);
+			s2 += " string goes long here";
+			assert(TinySTL::Test::container_equal(s1, stdStr("short")));
+			assert(TinySTL::Test::container_equal(s2, stdStr("short string goes long here")));
+
+			TinySTL::swap(s1, s2);
+			assert(TinySTL::Test::container_equal(s2, stdStr("short")));
+			assert(TinySTL::Test::container_equal(s1, stdStr("short string goes long here")));
+
+			tsStr s3(std::move(s1));
+			assert(s1.empty());
+			assert(TinySTL::Test::container_equal(s3, stdStr("short string goes long here")));
+			s3.resize(5);
+			s3.shrink_to_fit();
+			assert(s3 == "short");
+
+			stdStr std1;
+			tsStr ts1;
+			for (int i = 0; i != 100; ++i){
+				std1.push_back('a' + i % 26);
+				ts1.push_back('a' + i % 26);
+				assert(TinySTL::Test::container_equal(std1, ts1));
+			}
+			while (!std1.empty()){
+				std1.pop_back();
+				ts1.pop_back();
+				assert(TinySTL::Test::container_equal(std1, ts1));
+			}
+		}
+		void testCase31(){
+			stdStr str1("content-type: text/html; charset=utf-8\r\naccept: */*\r\n");
+			tsStr str2("content-type: text/html; charset=utf-8\r\naccept: */*\r\n");
+			const char *keys[] = { "", "c", ":", "\r\n", "accept", "utf-8\r", "*/*\r\n", "nothing", "t" };
+
+			for (auto key : keys){
+				for (size_t pos = 0; pos <= str1.size() + 1; ++pos){
+					assert(str1.find(key, pos) == str2.find(key, pos));
+					assert(str1.find_first_of(key, pos) == str2.find_first_of(key, pos));
+					assert(str1.find_first_not_of(key, pos) == str2.find_first_not_of(key, pos));
+				}
+			}
+			for (size_t pos = 0; pos <= str1.size() + 1; ++pos){
+				assert(str1.find(':', pos) == str2.find(':', pos));
+				assert(str1.find('\0', pos) == str2.find('\0', pos));
+			}
+		}
+		void testCase32(){
+			tsStr str("Host: www.example.com");
+			TinySTL::string_view sv = str.view();
+			assert(sv.size() == str.size());
+
+			auto colon = sv.find(':');
+			assert(colon == 4);
+			TinySTL::string_view name = sv.substr(0, colon);
+			TinySTL::string_view value = sv.substr(colon + 2);
+			assert(name == "Host");
+			assert(value == "www.example.com");
+			assert(value.data() == str.data() + colon + 2);
+			assert(value.find("example") == 4);
+			assert(value.find_first_of(".") == 3);
+			assert(str.find(TinySTL::string_view("example")) == 10);
+
+			assert(tsStr(name) == "Host");
+			assert(name < value);
+		}
 
 		void testAllCases(){
 			testCase1();
@@ -477,6 +549,9 @@ namespace TinySTL{
 			testCase27();
 			testCase28();
 			testCase29();
+			testCase30();
+			testCase31();
+			testCase32();
 		}
 	}
 }
\ No newline at end of file
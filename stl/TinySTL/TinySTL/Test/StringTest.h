@@ -43,6 +43,9 @@ namespace TinySTL{
 		void testCase27();
 		void testCase28();
 		void testCase29();
+		void testCase30();
+		void testCase31();
+		void testCase32();
 
 		void testAllCases();
 	}
@@ -2,7 +2,48 @@
 
 namespace TinySTL{
 	namespace SuffixArrayTest{
-		void testCase(){
+		namespace{
+			//ֱк׺õĽ飬ַ޷Ƚ
+			template<class Seq>
+			std::vector<long long> naive_suffix(const Seq& s){
+				typedef typename Seq::value_type value_type;
+				std::vector<long long> res(s.size());
+				for (size_t i = 0; i != res.size(); ++i)
+					res[i] = i;
+				std::sort(res.begin(), res.end(), [&s](long long a, long long b){
+					return std::lexicographical_compare(s.begin() + a, s.end(), s.begin() + b, s.end(),
+						[](const value_type& x, const value_type& y){ return Detail::sa_symbol(x) < Detail::sa_symbol(y); });
+				});
+				return res;
+			}
+			template<class Seq>
+			size_t lcp(const Seq& s, size_t a, size_t b){
+				size_t n = 0;
+				while (a + n != s.size() && b + n != s.size() && s[a + n] == s[b + n])
+					++n;
+				return n;
+			}
+			template<class Seq, class SA>
+			void check(const Seq& s, const SA& sa){
+				auto expect = naive_suffix(s);
+				assert(TinySTL::Test::container_equal(sa.suffixArray(), expect));
+				assert(sa.rankArray().size() == s.size());
+				for (size_t i = 0; i != s.size(); ++i)
+					assert(size_t(sa.rankArray()[sa.suffixArray()[i]]) == i);
+				assert(sa.heightArray().size() == (s.empty() ? 0 : s.size() - 1));
+				for (size_t i = 0; i + 1 < s.size(); ++i)
+					assert(size_t(sa.heightArray()[i]) == lcp(s, expect[i], expect[i + 1]));
+			}
+			std::string random_text(size_t n, int alphabet, unsigned seed){
+				srand(seed);
+				std::string res(n, '\0');
+				for (size_t i = 0; i != n; ++i)
+					res[i] = 'a' + rand() % alphabet;
+				return res;
+			}
+		}
+
+		void testCase1(){
 			//char arr[] = { 'a', 'a', 'b', 'a', 'a', 'a', 'a', 'b' };
 			std::string str("aabaaaab");
 
@@ -20,10 +61,122 @@ namespace TinySTL{
 			auto ha2 = TinySTL::suffix_array::array_type{ 3, 2, 3, 1, 2, 0, 1 };
 			assert(TinySTL::Test::container_equal(ha1, ha2));
 		}
+		void testCase2(){
+			const char *texts[] = { "a", "ab", "ba", "aaaaaaaaaaaaaaaa", "abababababababab", "mississippi",
+				"banana", "abracadabra", "cabbagecabbagecabbage", "zyxwvutsrqponmlkjihgfedcba" };
+			for (size_t i = 0; i != sizeof(texts) / sizeof(texts[0]); ++i){
+				std::string s(texts[i]);
+				check(s, TinySTL::suffix_array(s.data(), s.size()));
+				check(s, TinySTL::suffix_array64(s.data(), s.size()));
+			}
+			for (unsigned seed = 0; seed != 200; ++seed){
+				std::string s = random_text(1 + seed * 7 % 300, 1 + seed % 4, seed);
+				check(s, TinySTL::suffix_array(s.data(), s.size()));
+			}
+			//ظĳSA-ISݹü
+			std::string block = random_text(50, 3, 7), s;
+			for (int i = 0; i != 40; ++i)
+				s += block + (i % 3 == 0 ? "x" : "");
+			check(s, TinySTL::suffix_array(s.data(), s.size()));
+			check(s, TinySTL::suffix_array64(s.data(), s.size()));
+		}
+		void testCase3(){
+			TinySTL::suffix_array empty("", 0);
+			assert(empty.suffixArray().empty() && empty.heightArray().empty() && empty.rankArray().empty());
+
+			//127ַ
+			std::string high("\xff\x01\xff\x80\x7f\xff\x01");
+			check(high, TinySTL::suffix_array(high.data(), high.size()));
+
+			//256ַĸ
+			std::vector<int> ints(2000);
+			srand(11);
+			for (size_t i = 0; i != ints.size(); ++i)
+				ints[i] = rand() % 5000;
+			for (size_t i = 1000; i != 1500; ++i)
+				ints[i] = ints[i - 1000];
+			check(ints, TinySTL::suffix_array(ints.begin(), ints.size(), 5000));
+
+			bool thrown = false;
+			try{
+				TinySTL::suffix_array bad(ints.begin(), ints.size(), 100);
+			}
+			catch (std::out_of_range&){
+				thrown = true;
+			}
+			assert(thrown);
+		}
+		void testCase4(){
+			//̵ֵ߳Ľ͵̵߳ͬ
+			std::string s = random_text(TinySTL::suffix_array::parallel_threshold * 2, 4, 5);
+			for (size_t i = 100000; i != 200000; ++i)
+				s[i + 500000] = s[i];
+			TinySTL::suffix_array sa1(s.data(), s.size(), 256, true);
+			TinySTL::suffix_array sa2(s.data(), s.size(), 256, false);
+			assert(sa1.suffixArray() == sa2.suffixArray());
+			assert(sa1.rankArray() == sa2.rankArray());
+			assert(sa1.heightArray() == sa2.heightArray());
+			//ڵĺ׺ڹǰ׺ַ֮ǵ
+			const auto& sa = sa1.suffixArray();
+			const auto& height = sa1.heightArray();
+			for (size_t i = 0; i + 1 < s.size(); ++i){
+				size_t a = sa[i], b = sa[i + 1], h = height[i];
+				assert(lcp(s, a, b) == h);
+				assert(a + h == s.size() || (b + h != s.size() && (unsigned char)s[a + h] < (unsigned char)s[b + h]));
+			}
+		}
+		void testCase5(){
+			std::string s = random_text(10000, 3, 9);
+			TinySTL::suffix_array sa(s.data(), s.size());
+			TinySTL::suffix_array64 sa64(s.data(), s.size());
+			const char *path = "suffix_array_test.idx";
+			sa.save(path);
+			{
+				TinySTL::mapped_suffix_array m(path);
+				assert(m.size() == s.size() && m.index_size() == sizeof(int) && !m.has_rank());
+				for (size_t i = 0; i != s.size(); ++i)
+					assert(m.suffix(i) == sa.suffixArray()[i]);
+				for (size_t i = 0; i + 1 != s.size(); ++i)
+					assert(m.height(i) == sa.heightArray()[i]);
+				assert(std::equal(sa.suffixArray().begin(), sa.suffixArray().end(), m.suffix_data<int>()));
+				bool thrown = false;
+				try{
+					m.suffix_data<long long>();
+				}
+				catch (std::logic_error&){
+					thrown = true;
+				}
+				assert(thrown);
+			}
+			sa64.save(path, true);
+			{
+				TinySTL::mapped_suffix_array m(path);
+				assert(m.index_size() == sizeof(long long) && m.has_rank());
+				assert(std::equal(sa64.suffixArray().begin(), sa64.suffixArray().end(), m.suffix_data<long long>()));
+				assert(std::equal(sa64.rankArray().begin(), sa64.rankArray().end(), m.rank_data<long long>()));
+				assert(m.rank(5) == sa.rankArray()[5]);
+			}
+			//suffix arrayļ
+			std::FILE *fp = std::fopen(path, "wb");
+			std::fputs("not a suffix array", fp);
+			std::fclose(fp);
+			bool thrown = false;
+			try{
+				TinySTL::mapped_suffix_array m(path);
+			}
+			catch (std::runtime_error&){
+				thrown = true;
+			}
+			assert(thrown);
+			std::remove(path);
+		}
 
-		
 		void testAllCases(){
-			testCase();
+			testCase1();
+			testCase2();
+			testCase3();
+			testCase4();
+			testCase5();
 		}
 	}
-}
\ No newline at end of file
+}
@@ -5,15 +5,24 @@
 
 #include "../SuffixArray.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace TinySTL{
 	namespace SuffixArrayTest{
-		void testCase();
+		void testCase1();
+		void testCase2();
+		void testCase3();
+		void testCase4();
+		void testCase5();
 
 		void testAllCases();
 	}
 }
 
-#endif
\ No newline at end of file
+#endif
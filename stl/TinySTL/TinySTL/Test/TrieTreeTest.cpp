@@ -2,6 +2,35 @@
 
 namespace TinySTL{
 	namespace TrieTreeTest{
+		namespace{
+			std::vector<std::string> random_words(size_t n, unsigned seed){
+				srand(seed);
+				std::vector<std::string> res;
+				for (size_t i = 0; i != n; ++i){
+					std::string word(1 + rand() % 12, '\0');
+					//ֲַܹ㣬õֱĽ㣻ַڼĸϣǰ׺ܳ
+					word[0] = static_cast<char>(1 + rand() % 255);
+					for (size_t j = 1; j != word.size(); ++j)
+						word[j] = 'a' + rand() % 3;
+					res.push_back(word);
+				}
+				return res;
+			}
+			std::vector<std::string> with_prefix(const std::set<std::string>& words, const std::string& prefix){
+				std::vector<std::string> res;
+				for (auto it = words.lower_bound(prefix); it != words.end() && it->compare(0, prefix.size(), prefix) == 0; ++it)
+					res.push_back(*it);
+				return res;
+			}
+			template<class Range>
+			std::vector<std::string> to_strings(const Range& range){
+				std::vector<std::string> res;
+				for (auto it = range.begin(); it != range.end(); ++it)
+					res.push_back(std::string((*it).data(), (*it).size()));
+				return res;
+			}
+		}
+
 		void testCase1(){
 			trie_tree t;
 			t.insert("abc");
@@ -35,10 +64,147 @@ namespace TinySTL{
 			assert(t.size() == 4);
 		}
 
+		void testCase4(){
+			auto words = random_words(5000, 1);
+			std::set<std::string> expect(words.begin(), words.end());
+			trie_tree t;
+			for (const auto& word : words)
+				assert(t.insert(string(word.data(), word.size())));
+			assert(t.size() == expect.size());
+			for (const auto& word : expect)
+				assert(t.is_existed(string(word.data(), word.size())));
+			const char *missing[] = { "\x01z", "\xff\x61\x61\x61\x61\x61\x61\x61\x61\x61\x61\x61\x61", "b" };
+			for (auto word : missing)
+				assert(t.is_existed(word) == (expect.count(word) != 0));
+
+			std::vector<std::string> prefixes = { "\x41", "\x41a", "\x41ab", "\xc8b", "\x80aaa", "\x10c" };
+			for (auto& prefix : prefixes){
+				std::vector<std::string> res;
+				t.for_each_word_by_prefix(string_view(prefix.data(), prefix.size()), [&res](const string& word){
+					res.push_back(std::string(word.data(), word.size()));
+				});
+				assert(res == with_prefix(expect, prefix));
+				assert(t.get_word_by_prefix(string(prefix.data(), prefix.size())).size() == res.size());
+			}
+			std::vector<std::string> all;
+			t.for_each_word_by_prefix(string_view(), [&all](const string& word){
+				all.push_back(std::string(word.data(), word.size()));
+			});
+			assert(all == std::vector<std::string>(expect.begin(), expect.end()));
+		}
+		void testCase5(){
+			auto words = random_words(5000, 2);
+			std::set<std::string> expect(words.begin(), words.end());
+			std::vector<std::string> sorted(expect.begin(), expect.end());
+			compact_trie ct(sorted.begin(), sorted.end());
+			assert(ct.size() == sorted.size());
+			assert(to_strings(ct) == sorted);
+			for (size_t i = 0; i != sorted.size(); ++i){
+				assert(ct.find(string_view(sorted[i].data(), sorted[i].size())) == i);
+				std::string longer = sorted[i] + "\x01";
+				if (!expect.count(longer))
+					assert(ct.find(string_view(longer.data(), longer.size())) == compact_trie::npos);
+				assert(ct.longest_prefix(string_view(longer.data(), longer.size())) == i);
+			}
+			std::vector<std::string> prefixes = { "\x41", "\x41a", "\x41ab", "\xc8b", "\x80aaa", "\x10c", "\x41abcd" };
+			for (auto& prefix : prefixes)
+				assert(to_strings(ct.prefix(string_view(prefix.data(), prefix.size()))) == with_prefix(expect, prefix));
+			assert(ct.prefix(string_view()).size() == ct.size());
+
+			//·ʽǰ׺ƥ
+			const char *routes[] = { "/", "/api", "/api/v1", "/api/v1/items", "/static" };
+			compact_trie rt(routes, routes + 5);
+			assert(rt.longest_prefix("/api/v1/items/42") == 3);
+			assert(rt.longest_prefix("/api/v2") == 1);
+			assert(rt.longest_prefix("/favicon.ico") == 0);
+			assert(rt.longest_prefix("api") == compact_trie::npos);
+			assert(rt.find("/api/v") == compact_trie::npos);
+			assert(to_strings(rt.prefix("/api/")) == std::vector<std::string>({ "/api/v1", "/api/v1/items" }));
+
+			//trie_treeõĽһ
+			trie_tree t;
+			for (const auto& word : words)
+				t.insert(string(word.data(), word.size()));
+			compact_trie ct2(t);
+			assert(to_strings(ct2) == sorted);
+			assert(ct2.bytes() == ct.bytes());
+
+			const char *unsorted[] = { "b", "a" };
+			const char *duplicated[] = { "a", "a" };
+			int thrown = 0;
+			try{ compact_trie bad(unsorted, unsorted + 2); }
+			catch (std::invalid_argument&){ ++thrown; }
+			try{ compact_trie bad(duplicated, duplicated + 2); }
+			catch (std::invalid_argument&){ ++thrown; }
+			assert(thrown == 2);
+		}
+		void testCase6(){
+			auto words = random_words(3000, 3);
+			std::set<std::string> expect(words.begin(), words.end());
+			std::vector<std::string> sorted(expect.begin(), expect.end());
+			compact_trie ct(sorted.begin(), sorted.end());
+			const char *path = "compact_trie_test.idx";
+			ct.save(path);
+			{
+				compact_trie mapped(path);
+				assert(mapped.size() == ct.size() && mapped.bytes() == ct.bytes());
+				assert(to_strings(mapped) == sorted);
+				for (size_t i = 0; i < sorted.size(); i += 7)
+					assert(mapped.find(string_view(sorted[i].data(), sorted[i].size())) == i);
+				//ӳҲƶ
+				compact_trie moved(std::move(mapped));
+				assert(mapped.empty() && moved.size() == ct.size());
+				assert(to_strings(moved.prefix("\x41a")) == with_prefix(expect, "\x41a"));
+			}
+			std::FILE *fp = std::fopen(path, "wb");
+			std::fputs("not a compact trie file", fp);
+			std::fclose(fp);
+			bool thrown = false;
+			try{
+				compact_trie bad(path);
+			}
+			catch (std::runtime_error&){
+				thrown = true;
+			}
+			assert(thrown);
+			std::remove(path);
+		}
+		void testCase7(){
+			compact_trie empty;
+			assert(empty.empty() && empty.begin() == empty.end());
+			assert(empty.find("a") == compact_trie::npos && empty.prefix("").empty());
+			assert(empty.longest_prefix("abc") == compact_trie::npos);
+
+			//մҲΪ
+			const char *words[] = { "", "a", "ab" };
+			compact_trie ct(words, words + 3);
+			assert(ct.find("") == 0 && ct.find("ab") == 2 && ct.find("b") == compact_trie::npos);
+			assert(ct.longest_prefix("b") == 0 && ct.longest_prefix("abc") == 2);
+			assert(ct.prefix("a").size() == 2);
+
+			compact_trie other;
+			other = std::move(ct);
+			assert(other.size() == 3 && ct.empty());
+
+			trie_tree t;
+			assert(!t.insert("") && !t.is_existed(""));
+			t.insert("abcdef");
+			t.insert("abc");
+			t.insert("abd");
+			assert(t.size() == 3 && !t.is_existed("ab") && t.is_existed("abc"));
+			//ǰ׺ͣѹм
+			auto v = t.get_word_by_prefix("abcd");
+			assert(v.size() == 1 && v[0] == "abcdef");
+		}
+
 		void testAllCases(){
 			testCase1();
 			testCase2();
 			testCase3();
+			testCase4();
+			testCase5();
+			testCase6();
+			testCase7();
 		}
 	}
 }
\ No newline at end of file
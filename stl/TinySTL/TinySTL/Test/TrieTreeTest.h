@@ -5,13 +5,24 @@
 
 #include "../TrieTree.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace TinySTL{
 	namespace TrieTreeTest{
 		void testCase1();
 		void testCase2();
 		void testCase3();
+		void testCase4();
+		void testCase5();
+		void testCase6();
+		void testCase7();
 
 		void testAllCases();
 	}
@@ -2,16 +2,108 @@
 
 namespace TinySTL{
 	namespace UFSetTest{
+		namespace{
+			typedef std::pair<uint32_t, uint32_t> edge;
+			std::vector<edge> randomEdges(uint32_t n, size_t m, unsigned seed){
+				srand(seed);
+				std::vector<edge> edges;
+				for (size_t i = 0; i != m; ++i)
+					edges.push_back(edge(uint32_t(rand()) % n, uint32_t(rand()) % n));
+				return edges;
+			}
+		}
+
 		void testCase1(){
 			uf_set<10> uf;
 			uf.Union(0, 1);
 			uf.Union(2, 3);
 			uf.Union(3, 1);
 			assert(uf.Find(0) == uf.Find(2));
+
+			uf.Union(0, 2);//ͬһ
+			assert(uf.Find(1) == uf.Find(3));
+			assert(uf.Find(4) != uf.Find(0));
+		}
+		void testCase2(){
+			const uint32_t n = 2000;
+			dynamic_uf_set uf(n);
+			assert(uf.Size() == n && uf.Count() == n);
+			assert(!uf.Connected(0, 1));
+
+			//ϲʱһϵıȫĳһ
+			std::vector<uint32_t> label(n);
+			for (uint32_t i = 0; i != n; ++i)
+				label[i] = i;
+			auto edges = randomEdges(n, 1500, 1);
+			size_t merged = 0;
+			for (size_t i = 0; i != edges.size(); ++i){
+				uint32_t from = label[edges[i].first], to = label[edges[i].second];
+				if (from == to)
+					continue;
+				++merged;
+				for (uint32_t j = 0; j != n; ++j){
+					if (label[j] == from)
+						label[j] = to;
+				}
+			}
+			assert(uf.UnionEdges(edges.begin(), edges.end()) == merged);
+			assert(uf.Count() == n - merged);
+			for (uint32_t i = 0; i < n; i += 7){
+				for (uint32_t j = 0; j < n; j += 11)
+					assert(uf.Connected(i, j) == (label[i] == label[j]));
+			}
+
+			assert(!uf.Union(edges[0].first, edges[0].second));
+			uf.Clear();
+			assert(uf.Count() == n && !uf.Connected(edges[0].first, edges[0].second) == (edges[0].first != edges[0].second));
+
+			//UnionUnionEdgesȼۣԤȡڵıҲҪ
+			dynamic_uf_set uf2(n);
+			assert(uf2.UnionEdges(edges.begin(), edges.begin() + 3) == 3);
+			for (size_t i = 3; i != edges.size(); ++i)
+				uf2.Union(edges[i].first, edges[i].second);
+			assert(uf2.Count() == n - merged);
+		}
+		void testCase3(){
+			const uint32_t n = 100000;
+			auto edges = randomEdges(n, 90000, 2);
+			dynamic_uf_set expected(n);
+			expected.UnionEdges(edges.begin(), edges.end());
+
+			concurrent_uf_set uf(n);
+			const int threads = 4;
+			std::vector<std::thread> workers;
+			std::vector<size_t> merged(threads);
+			for (int t = 0; t != threads; ++t){
+				workers.push_back(std::thread([&, t]{
+					size_t begin = edges.size() * t / threads, end = edges.size() * (t + 1) / threads;
+					if (t % 2)
+						merged[t] = uf.UnionEdges(edges.begin() + begin, edges.begin() + end);
+					else{
+						for (size_t i = begin; i != end; ++i)
+							merged[t] += uf.Union(edges[i].first, edges[i].second);
+					}
+					//޸ڼѯѾϲıһͨ
+					for (size_t i = begin; i < end; i += 97)
+						assert(uf.Connected(edges[i].first, edges[i].second));
+				}));
+			}
+			for (auto& w : workers)
+				w.join();
+
+			size_t total = 0;
+			for (int t = 0; t != threads; ++t)
+				total += merged[t];
+			assert(total == n - expected.Count());
+			assert(uf.Count() == expected.Count());
+			for (uint32_t i = 0; i < n; i += 13)
+				assert(uf.Connected(i, (i * 7919) % n) == expected.Connected(i, (i * 7919) % n));
 		}
 
 		void testAllCases(){
 			testCase1();
+			testCase2();
+			testCase3();
 		}
 	}
-}
\ No newline at end of file
+}
@@ -3,13 +3,19 @@
 
 #include "../UFSet.h"
 #include <cassert>
+#include <cstdlib>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace TinySTL{
 	namespace UFSetTest{
 		void testCase1();
+		void testCase2();//dynamic_uf_set±ŵȽ
+		void testCase3();//̵߳concurrent_uf_setdynamic_uf_setһ
 
 		void testAllCases();
 	}
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -230,6 +230,139 @@ namespace TinySTL{
 
 		}
 
+		void testCase16(){
+			//string԰ֽڰᶯݡ롢ɾݲ
+			tsVec<TinySTL::string> v1;
+			stdVec<std::string> v2;
+			for (int i = 0; i != 1000; ++i){
+				//ַ
+				std::string s(i % 40, char('a' + i % 26));
+				s += std::to_string(i);
+				v1.push_back(TinySTL::string(s.c_str()));
+				v2.push_back(s);
+			}
+			assert(v1.size() == 1000);
+			for (int i = 0; i != 1000; ++i)
+				assert(std::string(v1[i].data(), v1[i].size()) == v2[i]);
+
+			v1.insert(v1.begin() + 10, 3, TinySTL::string("inserted"));
+			v2.insert(v2.begin() + 10, 3, std::string("inserted"));
+			v1.erase(v1.begin(), v1.begin() + 5);
+			v2.erase(v2.begin(), v2.begin() + 5);
+			v1.reserve(v1.capacity() * 2);
+			v1.shrink_to_fit();
+			assert(v1.size() == v1.capacity());
+			assert(v1.size() == v2.size());
+			for (size_t i = 0; i != v2.size(); ++i)
+				assert(std::string(v1[i].data(), v1[i].size()) == v2[i]);
+
+			//еԪ
+			v1.push_back(v1[0]);
+			v1.emplace_back(v1[1]);
+			assert(v1[v1.size() - 2] == v1[0] && v1.back() == v1[1]);
+			v1.insert(v1.begin(), v1.back());
+			assert(v1[0] == v1[2]);
+		}
+		void testCase17(){
+			//ֻƶ
+			tsVec<std::unique_ptr<int>> v;
+			for (int i = 0; i != 100; ++i){
+				if (i % 2)
+					v.push_back(std::unique_ptr<int>(new int(i)));
+				else
+					v.emplace_back(new int(i));
+			}
+			for (int i = 0; i != 100; ++i)
+				assert(*v[i] == i);
+			v.erase(v.begin(), v.begin() + 50);
+			assert(v.size() == 50 && *v.front() == 50 && *v.back() == 99);
+		}
+
+		//ƶ캯׳쳣ʱӦø
+		class CopyCounter{
+		public:
+			CopyCounter(int v) :value(v){}
+			CopyCounter(const CopyCounter& other) :value(other.value){ ++copies; }
+			CopyCounter(CopyCounter&& other) :value(other.value){ ++moves; }
+			CopyCounter& operator = (const CopyCounter& other){ value = other.value; ++copies; return *this; }
+
+			int value;
+			static int copies;
+			static int moves;
+		};
+		int CopyCounter::copies = 0;
+		int CopyCounter::moves = 0;
+
+		void testCase18(){
+			tsVec<CopyCounter> v;
+			v.reserve(4);
+			for (int i = 0; i != 4; ++i)
+				v.emplace_back(i);
+			assert(CopyCounter::copies == 0 && CopyCounter::moves == 0);
+			v.emplace_back(4);
+			assert(CopyCounter::copies == 4 && CopyCounter::moves == 0);
+			v.push_back(CopyCounter(5));
+			assert(CopyCounter::moves == 1);
+			for (int i = 0; i != 6; ++i)
+				assert(v[i].value == i);
+		}
+
+		//countdownθʱ׳쳣live¼Ķ
+		class ThrowingCopy{
+		public:
+			ThrowingCopy(int v) :value(v){ ++live; }
+			ThrowingCopy(const ThrowingCopy& other) :value(other.value){
+				if (countdown > 0 && --countdown == 0)
+					throw std::runtime_error("copy");
+				++live;
+			}
+			ThrowingCopy& operator = (const ThrowingCopy& other){ value = other.value; return *this; }
+			~ThrowingCopy(){ --live; }
+
+			int value;
+			static int live;
+			static int countdown;
+		};
+		int ThrowingCopy::live = 0;
+		int ThrowingCopy::countdown = 0;
+
+		void testCase19(){
+			//ݲʱκһθʧܣԭûжй©ظ
+			for (int k = 1; k != 20; ++k){
+				for (int fill = 0; fill != 2; ++fill){
+					{
+						tsVec<ThrowingCopy> v;
+						v.reserve(8);
+						for (int i = 0; i != 8; ++i)
+							v.emplace_back(i);
+						ThrowingCopy extra[3] = { 100, 101, 102 };
+						ThrowingCopy::countdown = k;
+						bool thrown = false;
+						try{
+							if (fill)
+								v.insert(v.begin() + 3, 3, extra[0]);
+							else
+								v.insert(v.begin() + 3, extra, extra + 3);
+						}
+						catch (std::runtime_error&){
+							thrown = true;
+						}
+						ThrowingCopy::countdown = 0;
+						if (thrown){
+							assert(v.size() == 8);
+							for (int i = 0; i != 8; ++i)
+								assert(v[i].value == i);
+						}
+						else{
+							assert(v.size() == 11 && v[3].value == 100 && v[10].value == 7);
+						}
+						assert(ThrowingCopy::live == int(v.size()) + 3);
+					}
+					assert(ThrowingCopy::live == 0);
+				}
+			}
+		}
+
 		void testAllCases(){
 			testCase1();
 			testCase2();
@@ -246,6 +379,10 @@ namespace TinySTL{
 			testCase13();
 			testCase14();
 			testCase15();
+			testCase16();
+			testCase17();
+			testCase18();
+			testCase19();
 		}
 	}
 }
\ No newline at end of file
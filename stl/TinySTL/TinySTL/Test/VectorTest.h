@@ -1,6 +1,7 @@
 #ifndef _VECTOR_TEST_H_
 #define _VECTOR_TEST_H_
 
+#include "../String.h"
 #include "../Vector.h"
 #include "TestUtil.h"
 
@@ -10,6 +11,8 @@
 #include <cassert>
 #include<iostream>
 #include <iterator>
+#include <memory>
+#include <stdexcept>
 #include <string>
 
 namespace TinySTL{
@@ -34,6 +37,11 @@ namespace TinySTL{
 		void testCase12();
 		void testCase13();
 		void testCase14();
+		void testCase15();
+		void testCase16();
+		void testCase17();
+		void testCase18();
+		void testCase19();
 
 		void testAllCases();
 	}
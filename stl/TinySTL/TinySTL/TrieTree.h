@@ -1,53 +1,219 @@
 #ifndef _TRIE_TREE_H_
 #define _TRIE_TREE_H_
 
+#include "Detail\MappedFile.h"
+#include "Iterator.h"
+#include "MemoryResource.h"
 #include "String.h"
+#include "StringView.h"
 #include "Vector.h"
 
 #include <utility>
 #include <memory>
-#include <map>
 #include <iostream>
+#include <vector>
 
 namespace TinySTL{
+	//the class of trie_tree
+	//·ѹĻһ㱣Ӹ㵽ַ
+	//Ӱַ޷ţ򣬲16ʱСʱ256ֱ
+	//㡢ͽϵַӹʱmemory_resource
 	class trie_tree{
 	private:
 		struct trie_node{
-			char data;
+			enum { direct = 256 };//capacityΪdirectʱchildsǰֱַı
+			string label;
 			bool is_a_word;
-			std::map<char, std::unique_ptr<trie_node>> map_childs;
-			trie_node() :data('\0'), is_a_word(false){}
-			trie_node(char ch, bool is) :data(ch), is_a_word(is){}
+			unsigned short count;
+			unsigned short capacity;
+			unsigned char *keys;//ĺֱַʱΪ
+			trie_node **childs;
+			trie_node(const char *s, size_t n, bool is, memory_resource *res)
+				:label(s, n, res), is_a_word(is), count(0), capacity(0), keys(0), childs(0){}
+			trie_node(const trie_node&) = delete;
+			trie_node& operator = (const trie_node&) = delete;
 		};
-		typedef std::unique_ptr<trie_node> node_ptr;
 	public:
 		typedef string value_type;
 		typedef size_t size_type;
+		typedef polymorphic_allocator<char> allocator_type;
 	private:
+		memory_resource *res_;
 		trie_node *root_;
 		size_type size_;
 	public:
-		trie_tree();
+		explicit trie_tree(const allocator_type& alloc = allocator_type());
 		~trie_tree();
 		trie_tree(const trie_tree&) = delete;
 		trie_tree& operator = (const trie_tree&) = delete;
 
 		bool empty()const;
 		size_type size()const;
+		allocator_type get_allocator()const{ return allocator_type(res_); }
 
 		vector<string> get_word_by_prefix(const string& prefix)const;
 		void print_tree(std::ostream& os = std::cout)const;
 		bool insert(const string& word);
 		bool is_existed(const string& word)const;
+		//ֵÿprefixͷĴʵfn(const string&)յprefixʾеĴ
+		//fnͬһڼֻ䳤ʱڴ
+		template<class Func>
+		void for_each_word_by_prefix(string_view prefix, Func fn)const;
 	private:
-		node_ptr make_node(char ch, bool is_a_word);
 		inline trie_node* get_root()const{ return root_; }
-		void _get_word_by_prefix(const string& prefix, const node_ptr& up, const string& real_prefix, vector<string>& words)const;
-		void __get_word_by_prefix(const node_ptr& up, string& word, const string& prefix, vector<string>& words)const;
-		void _print_tree(std::ostream& os, const node_ptr& up, string word)const;
-		bool _insert(const string& word, const node_ptr& up);
-		bool _is_existed(const string& word, const node_ptr& up)const;
+		trie_node *new_node(const char *s, size_t n, bool is);
+		void delete_node(trie_node *node);
+		static trie_node **find_child(const trie_node *up, unsigned char ch);
+		//chchildַѽʱchildlabelûнض
+		void add_child(trie_node *up, trie_node *child, unsigned char ch);
+		const trie_node *find_prefix(string_view prefix, string& path)const;
+		template<class Func>
+		static void visit(const trie_node *up, string& word, Func& fn);
 	};// end of trie_tree
+
+	template<class Func>
+	void trie_tree::for_each_word_by_prefix(string_view prefix, Func fn)const{
+		string word;
+		const trie_node *node = find_prefix(prefix, word);
+		if (node)
+			visit(node, word, fn);
+	}
+	template<class Func>
+	void trie_tree::visit(const trie_node *up, string& word, Func& fn){
+		if (up->is_a_word)
+			fn(static_cast<const string&>(word));
+		size_t len = word.size();
+		if (up->capacity == trie_node::direct){
+			for (size_t i = 0; i != trie_node::direct; ++i){
+				if (up->childs[i]){
+					word.append(up->childs[i]->label);
+					visit(up->childs[i], word, fn);
+					word.resize(len);
+				}
+			}
+		}else{
+			for (size_t i = 0; i != up->count; ++i){
+				word.append(up->childs[i]->label);
+				visit(up->childs[i], word, fn);
+				word.resize(len);
+			}
+		}
+	}
+
+	namespace Detail{
+		struct trie_file_header{
+			char magic_[8];
+			unsigned int version_;
+			unsigned int keyCount_;
+			unsigned int nodeCount_;
+			unsigned int poolSize_;
+		};
+		//·ǵfirst_ʵǰdepth_ַеĴ[first_, last_)
+		struct trie_file_node{
+			unsigned int depth_;
+			unsigned int first_;
+			unsigned int last_;
+		};
+		inline string_view trie_key(const char *s){ return string_view(s); }
+		template<class Str>
+		string_view trie_key(const Str& s){ return string_view(s.data(), s.size()); }
+	}
+
+	//the class of compact_trie
+	//ֻĻĴһԽɣݷһڴsaveֱӳʹ
+	//㰴ţֵܽڣʰֵţκǰ׺ӦĴʶһΣ
+	//ǰ׺ѯֻҵ㣬ʱڴ棬õstring_viewָڲַ
+	class compact_trie{
+	public:
+		typedef string_view value_type;
+		typedef size_t size_type;
+		static const size_type npos = -1;
+
+		class const_iterator : public iterator<random_access_iterator_tag, string_view>{
+			friend class compact_trie;
+		private:
+			const compact_trie *trie_;
+			size_type index_;
+			const_iterator(const compact_trie *t, size_type i) :trie_(t), index_(i){}
+		public:
+			const_iterator() :trie_(0), index_(0){}
+			string_view operator *()const{ return trie_->key(index_); }
+			size_type index()const{ return index_; }
+			const_iterator& operator ++(){ ++index_; return *this; }
+			const_iterator operator ++(int){ const_iterator temp = *this; ++index_; return temp; }
+			const_iterator& operator --(){ --index_; return *this; }
+			const_iterator operator --(int){ const_iterator temp = *this; --index_; return temp; }
+			const_iterator operator +(ptrdiff_t n)const{ return const_iterator(trie_, index_ + n); }
+			ptrdiff_t operator -(const const_iterator& it)const{ return ptrdiff_t(index_ - it.index_); }
+			bool operator ==(const const_iterator& it)const{ return index_ == it.index_ && trie_ == it.trie_; }
+			bool operator !=(const const_iterator& it)const{ return !(*this == it); }
+		};
+		typedef const_iterator iterator;
+		class prefix_range{
+		private:
+			const_iterator first_, last_;
+		public:
+			prefix_range(const_iterator first, const_iterator last) :first_(first), last_(last){}
+			const_iterator begin()const{ return first_; }
+			const_iterator end()const{ return last_; }
+			size_type size()const{ return last_ - first_; }
+			bool empty()const{ return first_ == last_; }
+		};
+	private:
+		std::vector<char> blob_;
+		std::unique_ptr<Detail::mapped_file> file_;
+		const Detail::trie_file_header *header_;
+		const unsigned int *offsets_;//keyCount_ + 1ipool_[offsets_[i], offsets_[i + 1])
+		const Detail::trie_file_node *nodes_;
+		const unsigned int *childs_;//nodeCount_ + 1iĺ[childs_[i], childs_[i + 1])
+		const unsigned char *labels_;//ÿ·ϽӸǸֵַܼ
+		const char *pool_;
+	public:
+		compact_trie();
+		//[first, last)ϸ޷ֽڱȽϣ׳std::invalid_argument
+		//Ԫؿconst char *κdata()size()ַڼ뱣Ч
+		template<class InputIterator>
+		compact_trie(InputIterator first, InputIterator last);
+		explicit compact_trie(const trie_tree& tree);
+		//ӳcompact_trie::saveļļʱ׳std::runtime_error
+		explicit compact_trie(const char *path);
+		compact_trie(const compact_trie&) = delete;
+		compact_trie& operator = (const compact_trie&) = delete;
+		compact_trie(compact_trie&& t);
+		compact_trie& operator = (compact_trie&& t);
+
+		size_type size()const{ return header_->keyCount_; }
+		bool empty()const{ return size() == 0; }
+		//ռõȫֽsaveдļһ
+		size_type bytes()const{ return file_ ? file_->size() : blob_.size(); }
+		string_view key(size_type i)const{ return string_view(pool_ + offsets_[i], offsets_[i + 1] - offsets_[i]); }
+
+		const_iterator begin()const{ return const_iterator(this, 0); }
+		const_iterator end()const{ return const_iterator(this, size()); }
+
+		bool is_existed(string_view word)const{ return find(word) != npos; }
+		//ʵţʱnpos
+		size_type find(string_view word)const;
+		//prefixͷĴʣֵ
+		prefix_range prefix(string_view prefix)const;
+		//wordǰ׺Ĵʵţ·ƥ䣬ûʱnpos
+		size_type longest_prefix(string_view word)const;
+
+		void save(const char *path)const;
+		void swap(compact_trie& t);
+	private:
+		void build(const std::vector<string_view>& keys);
+		void bind(const char *base);
+		unsigned int child(unsigned int node, unsigned char ch)const;
+	};
+
+	template<class InputIterator>
+	compact_trie::compact_trie(InputIterator first, InputIterator last){
+		std::vector<string_view> keys;
+		for (; first != last; ++first)
+			keys.push_back(Detail::trie_key(*first));
+		build(keys);
+	}
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -1,6 +1,8 @@
 #ifndef _TYPE_TRAITS_H_
 #define _TYPE_TRAITS_H_
 
+#include <type_traits>
+
 namespace TinySTL{
 
 	namespace{
@@ -250,5 +252,13 @@ namespace TinySTL{
 		typedef _true_type		is_POD_type;
 	};
 
+	/*
+	** ֱܷmemcpyѶᵽµַҲٶԾɵַϵĶ
+	** ĬֻпƽƵָֻͣڴָ롢ָָ(string)ػ
+	** vectorʱݴ˾ֽڰᶯƶ/Ԫ
+	*/
+	template<class T>
+	struct is_trivially_relocatable : std::integral_constant<bool, std::is_trivially_copyable<T>::value>{};
+
 }
 #endif
\ No newline at end of file
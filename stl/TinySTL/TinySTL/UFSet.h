@@ -1,9 +1,20 @@
 #ifndef _UF_SET_H_
 #define _UF_SET_H_
 
+#include "Detail\Prefetch.h"
+
+#include <atomic>
+#include <cstdint>
 #include <cstring>
+#include <memory>
+#include <vector>
 
 namespace TinySTL{
+	namespace Detail{
+		//UnionEdgesǰôԤȡ˵parentԪغܶʱparentԶcache
+		enum{ UF_PREFETCH_WINDOW = 16 };
+	}
+
 	template <size_t N>
 	class uf_set{
 	public:
@@ -35,6 +46,8 @@ namespace TinySTL{
 	template<size_t N>
 	void uf_set<N>::Union(int index1, int index2){
 		auto root1 = Find(index1), root2 = Find(index2);
+		if (root1 == root2)
+			return;
 		auto total_nodes = parent[root1] + parent[root2];//total nodes
 		if (parent[root1] > parent[root2]){//Ȩϲ
 			parent[root1] = root2;
@@ -48,6 +61,99 @@ namespace TinySTL{
 	void uf_set<N>::Clear(){
 		memset(parent, -1, sizeof(int) * N);
 	}
+
+	//ԪظʱȷĲ鼯ʺǧԪ
+	//parent_uint32_t洢ڵparentΪȲ32һֽڴ洢
+	//ȺϲFind·(ÿһѽڵָ游)ֻһˣҪס·
+	class dynamic_uf_set{
+	public:
+		typedef uint32_t index_type;
+	private:
+		std::vector<index_type> parent_;
+		std::vector<uint8_t> rank_;
+		size_t sets_;
+	public:
+		explicit dynamic_uf_set(size_t n = 0);
+
+		size_t Size()const{ return parent_.size(); }
+		//ǰϵĸ
+		size_t Count()const{ return sets_; }
+
+		index_type Find(index_type index);
+		//Ѿͬһʱfalse
+		bool Union(index_type index1, index_type index2);
+		bool Connected(index_type index1, index_type index2){ return Find(index1) == Find(index2); }
+		//ϲ*firstfirst/secondΪߵ˵㣬ʵʺϲĴ
+		template<class InputIterator>
+		size_t UnionEdges(InputIterator first, InputIterator last);
+
+		void Clear();
+	};
+
+	//Ա߳ͬʱUnion/FindĲ鼯
+	//ϲʱCASһҵһ£CASʧ˵ѾˣFind
+	//αȼϲ(±һuint32_tϵ˫)O(log n)Ҫ
+	//FindCAS·룬CASʧ˵߳ѾĹֱ
+	class concurrent_uf_set{
+	public:
+		typedef uint32_t index_type;
+	private:
+		std::unique_ptr<std::atomic<index_type>[]> parent_;
+		size_t size_;
+	public:
+		explicit concurrent_uf_set(size_t n);
+
+		size_t Size()const{ return size_; }
+		//ϵĸҪû̲߳޸ʱ
+		size_t Count()const;
+
+		index_type Find(index_type index);
+		bool Union(index_type index1, index_type index2);
+		bool Connected(index_type index1, index_type index2);
+		template<class InputIterator>
+		size_t UnionEdges(InputIterator first, InputIterator last);
+
+		//Ҫû̲߳ʱ
+		void Clear();
+	private:
+		static index_type priority(index_type index){ return index * 0x9E3779B1u; }
+	};
+
+	namespace Detail{
+		//ȷŽһСĻλ壬ʱԤȡ˵parentUF_PREFETCH_WINDOW֮ٺϲ
+		template<class UFSet, class InputIterator>
+		size_t union_edges(UFSet& uf, const typename UFSet::index_type *parent,
+			InputIterator first, InputIterator last){
+			typedef typename UFSet::index_type index_type;
+			index_type buf[UF_PREFETCH_WINDOW][2];
+			size_t merged = 0, n = 0;
+			for (; first != last; ++first, ++n){
+				auto& slot = buf[n % UF_PREFETCH_WINDOW];
+				if (n >= UF_PREFETCH_WINDOW)
+					merged += uf.Union(slot[0], slot[1]);
+				slot[0] = index_type(first->first);
+				slot[1] = index_type(first->second);
+				prefetch(parent + slot[0]);
+				prefetch(parent + slot[1]);
+			}
+			for (size_t i = n > UF_PREFETCH_WINDOW ? n - UF_PREFETCH_WINDOW : 0; i != n; ++i){
+				auto& slot = buf[i % UF_PREFETCH_WINDOW];
+				merged += uf.Union(slot[0], slot[1]);
+			}
+			return merged;
+		}
+	}
+
+	template<class InputIterator>
+	size_t dynamic_uf_set::UnionEdges(InputIterator first, InputIterator last){
+		return Detail::union_edges(*this, parent_.data(), first, last);
+	}
+	template<class InputIterator>
+	size_t concurrent_uf_set::UnionEdges(InputIterator first, InputIterator last){
+		//std::atomic<uint32_t>uint32_tСֻͬԤȡĵַ
+		static_assert(sizeof(std::atomic<index_type>) == sizeof(index_type), "unexpected atomic layout");
+		return Detail::union_edges(*this, reinterpret_cast<const index_type*>(parent_.get()), first, last);
+	}
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -6,6 +6,10 @@
 #include "Iterator.h"
 #include "TypeTraits.h"
 
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
 namespace TinySTL{
 
 	/***************************************************************************/
@@ -31,8 +35,16 @@ namespace TinySTL{
 	ForwardIterator _uninitialized_copy_aux(InputIterator first, InputIterator last,
 		ForwardIterator result, _false_type){
 		int i = 0;
-		for (; first != last; ++first, ++i){
-			construct((result + i), *first);
+		try{
+			for (; first != last; ++first, ++i){
+				construct((result + i), *first);
+			}
+		}
+		catch (...){
+			//;ʧʱѾԪأresultʼڴָΪδʼ
+			while (i--)
+				destroy(&*(result + i));
+			throw;
 		}
 		return (result + i);
 	}
@@ -86,11 +98,138 @@ namespace TinySTL{
 	ForwardIterator _uninitialized_fill_n_aux(ForwardIterator first,
 		Size n, const T& x, _false_type){
 		int i = 0;
-		for (; i != n; ++i){
-			construct((T*)(first + i), x);
+		try{
+			for (; i != n; ++i){
+				construct((T*)(first + i), x);
+			}
+		}
+		catch (...){
+			while (i--)
+				destroy((T*)(first + i));
+			throw;
 		}
 		return (first + i);
 	}
+
+	/***************************************************************************/
+	//ͨķԪأallocator<T>û״ֱ̬İ汾
+	//(polymorphic_allocator)constructʹǶ׵Ҳͬһз
+	//İ汾һʧʱѾԪػᱻ
+	template<class InputIterator, class ForwardIterator, class T>
+	inline ForwardIterator uninitialized_copy_a(InputIterator first, InputIterator last,
+		ForwardIterator result, allocator<T>&){
+		return TinySTL::uninitialized_copy(first, last, result);
+	}
+	template<class InputIterator, class ForwardIterator, class Alloc>
+	ForwardIterator uninitialized_copy_a(InputIterator first, InputIterator last,
+		ForwardIterator result, Alloc& alloc){
+		ForwardIterator cur = result;
+		try{
+			for (; first != last; ++first, ++cur)
+				alloc.construct(&*cur, *first);
+		}
+		catch (...){
+			for (; result != cur; ++result)
+				alloc.destroy(&*result);
+			throw;
+		}
+		return cur;
+	}
+	template<class ForwardIterator, class Size, class T, class U>
+	inline ForwardIterator uninitialized_fill_n_a(ForwardIterator first,
+		Size n, const T& x, allocator<U>&){
+		return TinySTL::uninitialized_fill_n(first, n, x);
+	}
+	template<class ForwardIterator, class Size, class T, class Alloc>
+	ForwardIterator uninitialized_fill_n_a(ForwardIterator first,
+		Size n, const T& x, Alloc& alloc){
+		ForwardIterator cur = first;
+		try{
+			for (; n > 0; --n, ++cur)
+				alloc.construct(&*cur, x);
+		}
+		catch (...){
+			for (; first != cur; ++first)
+				alloc.destroy(&*first);
+			throw;
+		}
+		return cur;
+	}
+
+	/***************************************************************************/
+	//[first, last)еԪƶ쵽resultʼδʼڴ棬ԭĶ(ڱߵ״̬)
+	template<class T, class Alloc>
+	T *uninitialized_move_a(T *first, T *last, T *result, Alloc& alloc){
+		for (; first != last; ++first, ++result)
+			alloc.construct(result, std::move(*first));
+		return result;
+	}
+
+	//ƶ׳쳣ʱΪƣ;ʧʱԭԪػģ
+	//ʧʱѾԪغ׳
+	template<class T, class Alloc>
+	T *uninitialized_move_if_noexcept_a(T *first, T *last, T *result, Alloc& alloc){
+		T *cur = result;
+		try{
+			for (; first != last; ++first, ++cur)
+				alloc.construct(cur, std::move_if_noexcept(*first));
+		}
+		catch (...){
+			alloc.destroy(result, cur);
+			throw;
+		}
+		return cur;
+	}
+
+	//[first, last)еԪذᵽresultʼδʼڴ(ڴ治ص)ԭλΪδʼ
+	//԰ֽڰᶯֱmemcpyκι
+	template<class T, class Alloc>
+	inline T *_uninitialized_relocate_aux(T *first, T *last, T *result, Alloc&, std::true_type){
+		if (first != last)
+			memcpy(static_cast<void *>(result), static_cast<const void *>(first), (last - first) * sizeof(T));
+		return result + (last - first);
+	}
+	template<class T, class Alloc>
+	T *_uninitialized_relocate_aux(T *first, T *last, T *result, Alloc& alloc, std::false_type){
+		T *res = TinySTL::uninitialized_move_if_noexcept_a(first, last, result, alloc);
+		alloc.destroy(first, last);
+		return res;
+	}
+	template<class T, class Alloc>
+	inline T *uninitialized_relocate_a(T *first, T *last, T *result, Alloc& alloc){
+		return _uninitialized_relocate_aux(first, last, result, alloc,
+			typename std::integral_constant<bool, is_trivially_relocatable<T>::value>::type());
+	}
+
+	//[first, middle)ᵽresult1[middle, last)ᵽresult2мԪʱݣصڶεβλ
+	//ζɺԭԪأʧʱѾĲֱ٣ԭԪرֲ
+	template<class T, class Alloc>
+	inline T *_uninitialized_relocate_split_aux(T *first, T *middle, T *last,
+		T *result1, T *result2, Alloc& alloc, std::true_type){
+		_uninitialized_relocate_aux(first, middle, result1, alloc, std::true_type());
+		return _uninitialized_relocate_aux(middle, last, result2, alloc, std::true_type());
+	}
+	template<class T, class Alloc>
+	T *_uninitialized_relocate_split_aux(T *first, T *middle, T *last,
+		T *result1, T *result2, Alloc& alloc, std::false_type){
+		T *end1 = TinySTL::uninitialized_move_if_noexcept_a(first, middle, result1, alloc);
+		T *end2;
+		try{
+			end2 = TinySTL::uninitialized_move_if_noexcept_a(middle, last, result2, alloc);
+		}
+		catch (...){
+			alloc.destroy(result1, end1);
+			throw;
+		}
+		alloc.destroy(first, last);
+		return end2;
+	}
+	template<class T, class Alloc>
+	inline T *uninitialized_relocate_split_a(T *first, T *middle, T *last,
+		T *result1, T *result2, Alloc& alloc){
+		return _uninitialized_relocate_split_aux(first, middle, last, result1, result2, alloc,
+			typename std::integral_constant<bool, is_trivially_relocatable<T>::value>::type());
+	}
 }
 
 #endif
@@ -55,19 +55,23 @@ namespace TinySTL{
 		typedef Allocator allocator_type;
 		typedef value_type& reference;
 		typedef const value_type& const_reference;
-		typedef typename TinySTL::list<key_type>::iterator local_iterator;
-		typedef Detail::ust_iterator<Key, typename TinySTL::list<key_type>::iterator, Hash, KeyEqual, Allocator> iterator;
+		typedef typename TinySTL::list<key_type, Allocator>::iterator local_iterator;
+		typedef Detail::ust_iterator<Key, typename TinySTL::list<key_type, Allocator>::iterator, Hash, KeyEqual, Allocator> iterator;
 	private:
-		TinySTL::vector<TinySTL::list<key_type>> buckets_;
+		//ͰͰеĽڵ㶼ʹAllocator
+		typedef TinySTL::list<key_type, Allocator> bucket_type;
+		typedef typename Allocator::template rebind<bucket_type>::other bucketAllocator;
+		TinySTL::vector<bucket_type, bucketAllocator> buckets_;
 		size_type size_;
 		float max_load_factor_;
 #define PRIME_LIST_SIZE 28
 		static size_t prime_list_[PRIME_LIST_SIZE];
 	public:
-		explicit Unordered_set(size_t bucket_count);
+		explicit Unordered_set(size_t bucket_count, const Allocator& alloc = Allocator());
 		template<class InputIterator>
-		Unordered_set(InputIterator first, InputIterator last);
+		Unordered_set(InputIterator first, InputIterator last, const Allocator& alloc = Allocator());
 		Unordered_set(const Unordered_set& ust);
+		Unordered_set(const Unordered_set& ust, const Allocator& alloc);
 		Unordered_set& operator = (const Unordered_set& ust);
 
 		size_type size()const;
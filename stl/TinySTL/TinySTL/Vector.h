@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <type_traits>
+#include <utility>
 
 #include "Allocator.h"
 #include "Algorithm.h"
@@ -18,8 +19,12 @@ namespace TinySTL{
 		T *start_;
 		T *finish_;
 		T *endOfStorage_;
+		Alloc alloc_;
 
 		typedef Alloc dataAllocator;
+		//Ԫؿ԰ֽڰᶯҷṩreallocateʱֱӵԭڴ
+		typedef std::integral_constant<bool,
+			is_trivially_relocatable<T>::value && can_reallocate<Alloc>::value> useReallocate;
 
 	public:
 		typedef T									value_type;
@@ -33,16 +38,21 @@ namespace TinySTL{
 		typedef const T&							const_reference;
 		typedef size_t								size_type;
 		typedef ptrdiff_t	difference_type;
+		typedef Alloc		allocator_type;
 	public:
 		//죬ƣغ
 		vector()
 			:start_(0), finish_(0), endOfStorage_(0){}
+		explicit vector(const Alloc& alloc)
+			:start_(0), finish_(0), endOfStorage_(0), alloc_(alloc){}
 		explicit vector(const size_type n);
-		vector(const size_type n, const value_type& value);
+		vector(const size_type n, const value_type& value, const Alloc& alloc = Alloc());
 		template<class InputIterator>
-		vector(InputIterator first, InputIterator last);
+		vector(InputIterator first, InputIterator last, const Alloc& alloc = Alloc());
 		vector(const vector& v);
+		vector(const vector& v, const Alloc& alloc);
 		vector(vector&& v);
+		vector(vector&& v, const Alloc& alloc);
 		vector& operator = (const vector& v);
 		vector& operator = (vector&& v);
 		~vector();
@@ -83,6 +93,9 @@ namespace TinySTL{
 		void clear();
 		void swap(vector& v);
 		void push_back(const value_type& value);
+		void push_back(value_type&& value);
+		template<class... Args>
+		void emplace_back(Args&&... args);
 		void pop_back();
 		iterator insert(iterator position, const value_type& val);
 		void insert(iterator position, const size_type& n, const value_type& val);
@@ -92,9 +105,10 @@ namespace TinySTL{
 		iterator erase(iterator first, iterator last);
 
 		//Ŀռ
-		Alloc get_allocator(){ return dataAllocator; }
+		Alloc get_allocator()const{ return alloc_; }
 	private:
 		void destroyAndDeallocateAll();
+		void stealFrom(vector& v);
 		void allocateAndFillN(const size_type n, const value_type& value);
 		template<class InputIterator>
 		void allocateAndCopy(InputIterator first, InputIterator last);
@@ -110,6 +124,14 @@ namespace TinySTL{
 		template<class InputIterator>
 		void reallocateAndCopy(iterator position, InputIterator first, InputIterator last);
 		void reallocateAndFillN(iterator position, const size_type& n, const value_type& val);
+		void reallocateStorage(size_type newCapacity);
+		void reallocateStorage_aux(size_type newCapacity, std::true_type);
+		void reallocateStorage_aux(size_type newCapacity, std::false_type);
+		template<class... Args>
+		void emplace_back_aux(std::true_type, Args&&... args);
+		template<class... Args>
+		void emplace_back_aux(std::false_type, Args&&... args);
+		void deallocateAll();
 		size_type getNewCapacity(size_type len)const;
 	public:
 		template<class T, class Alloc>
@@ -117,6 +139,10 @@ namespace TinySTL{
 		template<class T, class Alloc>
 		friend bool operator != (const vector<T, Alloc>& v1, const vector<T, Alloc>& v2);
 	};// end of class vector
+
+	//vectorָֻڴָ룬尴ֽڰᶯ
+	template<class T, class Alloc>
+	struct is_trivially_relocatable<vector<T, Alloc>> : is_trivially_relocatable<Alloc>{};
 }
 
 #include "Detail\Vector.impl.h"
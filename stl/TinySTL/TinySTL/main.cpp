@@ -3,19 +3,37 @@
 #include "Algorithm.h"
 #include "Profiler\Profiler.h"
 
+#include "Benchmark\BitmapBenchmark.h"
+#include "Benchmark\BTreeBenchmark.h"
+#include "Benchmark\ConcurrentCircularBufferBenchmark.h"
+#include "Benchmark\ContainerBenchmark.h"
+#include "Benchmark\GraphBenchmark.h"
+#include "Benchmark\PooledListBenchmark.h"
+#include "Benchmark\RopeBenchmark.h"
+#include "Benchmark\SharedPtrBenchmark.h"
+#include "Benchmark\StringBenchmark.h"
+#include "Benchmark\SuffixArrayBenchmark.h"
+#include "Benchmark\TrieTreeBenchmark.h"
+#include "Benchmark\UFSetBenchmark.h"
+
 #include "Test\AlgorithmTest.h"
 #include "Test\AVLTreeTest.h"
 #include "Test\BitmapTest.h"
 #include "Test\BinarySearchTreeTest.h"
+#include "Test\BTreeTest.h"
 #include "Test\CircularBufferTest.h"
+#include "Test\ConcurrentCircularBufferTest.h"
 #include "Test\COWPtrTest.h"
 #include "Test\DequeTest.h"
 #include "Test\GraphTest.h"
 #include "Test\ListTest.h"
+#include "Test\MemoryResourceTest.h"
 #include "Test\PairTest.h"
+#include "Test\PooledListTest.h"
 #include "Test\PriorityQueueTest.h"
 #include "Test\QueueTest.h"
 #include "Test\RefTest.h"
+#include "Test\RopeTest.h"
 #include "Test\SharedPtrTest.h"
 #include "Test\StackTest.h"
 #include "Test\StringTest.h"
@@ -34,15 +52,20 @@ int main(){
 	//TinySTL::AVLTreeTest::testAllCases();
 	//TinySTL::BitmapTest::testAllCases();
 	//TinySTL::BinarySearchTreeTest::testAllCases();
+	//TinySTL::BTreeTest::testAllCases();
 	//TinySTL::CircularBufferTest::testAllCases();
+	//TinySTL::ConcurrentCircularBufferTest::testAllCases();
 	//TinySTL::COWPtrTest::testAllCases();
 	//TinySTL::DequeTest::testAllCases();
 	//TinySTL::ListTest::testAllCases();
 	//TinySTL::GraphTest::testAllCases();
+	//TinySTL::MemoryResourceTest::testAllCases();
 	//TinySTL::PairTest::testAllCases();
+	//TinySTL::PooledListTest::testAllCases();
 	//TinySTL::PriorityQueueTest::testAllCases();
 	//TinySTL::QueueTest::testAllCases();
 	//TinySTL::RefTest::testAllCases();
+	//TinySTL::RopeTest::testAllCases();
 	//TinySTL::SharedPtrTest::testAllCases();
 	//TinySTL::StackTest::testAllCases();
 	//TinySTL::StringTest::testAllCases();
@@ -53,6 +76,19 @@ int main(){
 	//TinySTL::UniquePtrTest::testAllCases();
 	//TinySTL::Unordered_setTest::testAllCases();
 	TinySTL::VectorTest::testAllCases();
+
+	//TinySTL::BitmapBenchmark::benchAllCases();
+	//TinySTL::BTreeBenchmark::benchAllCases();
+	//TinySTL::ConcurrentCircularBufferBenchmark::benchAllCases();
+	//TinySTL::ContainerBenchmark::benchAllCases();
+	//TinySTL::GraphBenchmark::benchAllCases();
+	//TinySTL::PooledListBenchmark::benchAllCases();
+	//TinySTL::RopeBenchmark::benchAllCases();
+	//TinySTL::SharedPtrBenchmark::benchAllCases();
+	//TinySTL::StringBenchmark::benchAllCases();
+	//TinySTL::SuffixArrayBenchmark::benchAllCases();
+	//TinySTL::TrieTreeBenchmark::benchAllCases();
+	//TinySTL::UFSetBenchmark::benchAllCases();
 	 
 
 	std::cout << "test" << std::endl;